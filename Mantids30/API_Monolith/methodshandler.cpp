@@ -1,5 +1,6 @@
 #include "methodshandler.h"
 #include <Mantids30/Helpers/json.h>
+#include <Mantids30/Program_Tracing/tracing.h>
 #include <Mantids30/Threads/lock_shared.h>
 #include <memory>
 
@@ -41,6 +42,7 @@ int MethodsHandler::invoke(std::shared_ptr<Mantids30::Sessions::Session> session
     else
     {
         // Invokes the specified method and stores result in payloadOut
+        Program::Tracing::Span span("api.method", methodName);
         *payloadOut = m_methods[methodName].method(m_methods[methodName].context, session, payload);
 
         // If configured, updates the last activity time for the session associated with this invocation
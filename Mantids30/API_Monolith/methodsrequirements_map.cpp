@@ -3,71 +3,45 @@
 #include <string>
 
 using namespace Mantids30::API::Monolith;
+using namespace Mantids30::DataFormat;
 
 void MethodsRequirements_Map::addMethodRequiredPermissions(const std::string &methodName, const std::set<std::string> &applicationPermissions)
 {
+    Requirements & requirements = m_methodRequirements[methodName];
     for (const std::string & permission : applicationPermissions)
-        m_methodRequiredPermissions.insert(std::make_pair(methodName, permission));
-}
-
-std::set<std::string> MethodsRequirements_Map::getMethodRequiredPermissions(const std::string &methodName)
-{
-    std::set<std::string> r;
-    auto it = m_methodRequiredPermissions.equal_range(methodName);
-    for (auto itr = it.first; itr != it.second; ++itr)
-        r.insert(itr->second);
-    return r;
+        requirements.permissions.set(AccessRegistry::getPermissions().intern(permission));
 }
 
 void MethodsRequirements_Map::addMethodRequiredRoles(const std::string &methodName, const std::set<std::string> &applicationRoles)
 {
-    for (const std::string & permission : applicationRoles)
-        m_methodRequiredRoles.insert(std::make_pair(methodName, permission));
-}
-
-std::set<std::string> MethodsRequirements_Map::getMethodRequiredRoles(const std::string &methodName)
-{
-    std::set<std::string> r;
-    auto it = m_methodRequiredRoles.equal_range(methodName);
-    for (auto itr = it.first; itr != it.second; ++itr)
-        r.insert(itr->second);
-    return r;
+    Requirements & requirements = m_methodRequirements[methodName];
+    for (const std::string & role : applicationRoles)
+        requirements.roles.set(AccessRegistry::getRoles().intern(role));
 }
 
 bool MethodsRequirements_Map::validateMethod(std::shared_ptr<Sessions::Session> session, const std::string &methodName, std::set<std::string> &rolesLeft, std::set<std::string> &permissionsLeft)
 {
+    rolesLeft.clear();
+    permissionsLeft.clear();
+
     if (!session)
         return false;
 
-    bool isAdmin = session->getJWTAuthenticatedInfo().isAdmin();
-    std::set<std::string> authedRoles = session->getJWTAuthenticatedInfo().getAllRoles();
-
-    if (isAdmin)
-    {
-        rolesLeft.clear();
-        permissionsLeft.clear();
+    if (session->isAdmin())
         return true;
-    }
-
-    std::set<std::string> requiredRoles  = getMethodRequiredRoles(methodName);
-    std::set<std::string> requiredPermissions = getMethodRequiredPermissions(methodName);
 
-    // start with all required permissions/slotIds...
-    rolesLeft = rolesLeft;
-    permissionsLeft = requiredPermissions;
+    auto it = m_methodRequirements.find(methodName);
+    if (it == m_methodRequirements.end())
+        return true;
 
-    for ( const std::string & permission : requiredPermissions )
-    {
-        if (session && session->getJWTAuthenticatedInfo().hasPermission(permission))
-            permissionsLeft.erase(permission);
-    }
+    const Requirements & requirements = it->second;
+    AccessMask missingPermissions, missingRoles;
 
-    for ( const std::string & role : requiredRoles )
-    {
-        if (session && session->getJWTAuthenticatedInfo().hasRole(role))
-            permissionsLeft.erase(role);
-    }
+    if (session->validateAccess(requirements.permissions, requirements.roles, &missingPermissions, &missingRoles))
+        return true;
 
-    return rolesLeft.empty() && permissionsLeft.empty();
+    // Only translate back to names what is missing (to report it):
+    permissionsLeft = AccessRegistry::getPermissions().getNames(missingPermissions);
+    rolesLeft = AccessRegistry::getRoles().getNames(missingRoles);
+    return false;
 }
-
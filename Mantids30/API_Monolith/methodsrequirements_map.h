@@ -34,12 +34,18 @@ public:
 
 
 private:
-    std::set<std::string> getMethodRequiredPermissions(const std::string & methodName);
-    std::set<std::string> getMethodRequiredRoles(const std::string &methodName);
-
-    // Method -> App Permission
-    std::multimap<std::string,std::string> m_methodRequiredPermissions;
-    std::multimap<std::string,std::string> m_methodRequiredRoles;
+    /**
+     * @brief The Requirements struct keeps the method requirements precompiled as interned ids
+     *        (DataFormat::AccessRegistry), so validating is a couple of mask comparisons.
+     */
+    struct Requirements
+    {
+        DataFormat::AccessMask permissions;
+        DataFormat::AccessMask roles;
+    };
+
+    // Method -> Required permissions/roles
+    std::map<std::string,Requirements> m_methodRequirements;
 
 };
 
@@ -20,29 +20,33 @@ bool MethodsHandler::addResource(const MethodMode &mode, const std::string &reso
     return addResource(mode, resourceName, def);
 }
 
-bool MethodsHandler::addResource(const MethodMode &mode, const std::string &resourceName, const RESTfulAPIDefinition &method)
+bool MethodsHandler::addResource(const MethodMode &mode, const std::string &resourceName, const RESTfulAPIDefinition &definition)
 {
+    // Precompile the required permissions, so the check on each request is a mask comparison:
+    RESTfulAPIDefinition method = definition;
+    method.security.requiredPermissionsMask = DataFormat::AccessRegistry::getPermissions().compile(method.security.requiredPermissions);
+
+    if (mode < GET || mode > DELETE)
+    {
+        return false;
+    }
+
     Threads::Sync::Lock_RW lock(m_methodsMutex);
 
-    switch (mode)
-    {
-    case GET:
-        m_methodsGET[resourceName] = method;
-        break;
-    case POST:
-        m_methodsPOST[resourceName] = method;
-        break;
-    case PUT:
-        m_methodsPUT[resourceName] = method;
-        break;
-    case DELETE:
-        m_methodsDELETE[resourceName] = method;
-        break;
+    uint32_t previousId;
+    switch (m_routes[mode].addRoute(resourceName, static_cast<uint32_t>(m_definitions.size()), &previousId))
+    {
+    case 1:
+        m_definitions.push_back(method);
+        return true;
+    case 2:
+        // Replaced: reuse the previous slot.
+        m_routes[mode].addRoute(resourceName, previousId);
+        m_definitions[previousId] = method;
+        return true;
     default:
         return false;
     }
-
-    return true;
 }
 
 Sessions::ClientDetails MethodsHandler::extractClientDetails(const RequestParameters &inputParameters)
@@ -58,45 +62,12 @@ Sessions::ClientDetails MethodsHandler::extractClientDetails(const RequestParame
 MethodsHandler::ErrorCodes MethodsHandler::invokeResource(const MethodMode & mode,
                                                           const std::string & resourceName,
                                                           RESTful::RequestParameters &inputParameters,
-                                                          const std::set<std::string> &currentPermissions,
                                                           const SecurityParameters & securityParameters,
                                                           APIReturn *apiResponse)
 {    Threads::Sync::Lock_RD lock(m_methodsMutex);
 
-    RESTfulAPIDefinition method;
-    auto it = m_methodsGET.end();
-
-    switch (mode)
+    if (mode < GET || mode > DELETE)
     {
-    case GET:
-        it = m_methodsGET.find(resourceName);
-        if (it != m_methodsGET.end())
-        {
-            method = it->second;
-        }
-        break;
-    case POST:
-        it = m_methodsPOST.find(resourceName);
-        if (it != m_methodsPOST.end())
-        {
-            method = it->second;
-        }
-        break;
-    case PUT:
-        it = m_methodsPUT.find(resourceName);
-        if (it != m_methodsPUT.end())
-        {
-            method = it->second;
-        }
-        break;
-    case DELETE:
-        it = m_methodsDELETE.find(resourceName);
-        if (it != m_methodsDELETE.end())
-        {
-            method = it->second;
-        }
-        break;
-    default:
         if (apiResponse != nullptr)
         {
             apiResponse->setError( HTTP::Status::S_400_BAD_REQUEST, "invalid_invokation", "Invalid Method Mode");
@@ -104,15 +75,27 @@ MethodsHandler::ErrorCodes MethodsHandler::invokeResource(const MethodMode & mod
         return INVALID_METHOD_MODE;
     }
 
-    if (it == m_methodsGET.end())
+    uint32_t routeId;
+    inputParameters.pathParameters.clear();
+    if (!m_routes[mode].match(resourceName, inputParameters.pathParameters, routeId))
     {
-        if (apiResponse != nullptr)
+        // Legacy form: "resource/key1/value1/key2/value2..."
+        std::string_view path = resourceName;
+        size_t slash = path.find('/');
+        if (slash == std::string_view::npos || !m_routes[mode].match(path.substr(0, slash), inputParameters.pathParameters, routeId))
         {
-            apiResponse->setError( HTTP::Status::S_404_NOT_FOUND, "invalid_invokation","Resource not found");
+            if (apiResponse != nullptr)
+            {
+                apiResponse->setError( HTTP::Status::S_404_NOT_FOUND, "invalid_invokation","Resource not found");
+            }
+            return RESOURCE_NOT_FOUND;
         }
-        return RESOURCE_NOT_FOUND;
+        inputParameters.pathParameters.addKeyValuePairs(path.substr(slash + 1));
     }
 
+    // No copies: the definition is only read while holding the lock.
+    const RESTfulAPIDefinition & method = m_definitions[routeId];
+
     if (method.security.requireJWTHeaderAuthentication && !securityParameters.haveJWTAuthHeader)
     {
         if (apiResponse != nullptr)
@@ -149,16 +132,13 @@ MethodsHandler::ErrorCodes MethodsHandler::invokeResource(const MethodMode & mod
         }
     }*/
 
-    for (const auto &attr : method.security.requiredPermissions)
+    if (!inputParameters.jwtToken->hasAllPermissions(method.security.requiredPermissionsMask))
     {
-        if (currentPermissions.find(attr) == currentPermissions.end())
+        if (apiResponse != nullptr)
         {
-            if (apiResponse != nullptr)
-            {
-                apiResponse->setError( HTTP::Status::S_401_UNAUTHORIZED,"invalid_invokation","Insufficient permissions");
-            }
-            return INSUFFICIENT_PERMISSIONS;
+            apiResponse->setError( HTTP::Status::S_401_UNAUTHORIZED,"invalid_invokation","Insufficient permissions");
         }
+        return INSUFFICIENT_PERMISSIONS;
     }
 
     if (inputParameters.clientRequest->getJSONStreamerContent() != nullptr)
@@ -216,7 +196,7 @@ MethodsHandler::ErrorCodes MethodsHandler::invokeResource(const MethodMode & mod
     return INTERNAL_ERROR;
 }
 
-MethodsHandler::ErrorCodes MethodsHandler::invokeResource(const std::string &modeStr, const std::string &resourceName, RequestParameters &inputParameters, const std::set<std::string> &currentPermissions, const SecurityParameters & securityParameters, APIReturn *payloadOut)
+MethodsHandler::ErrorCodes MethodsHandler::invokeResource(const std::string &modeStr, const std::string &resourceName, RequestParameters &inputParameters, const SecurityParameters & securityParameters, APIReturn *payloadOut)
 {
     MethodMode mode;
 
@@ -245,7 +225,7 @@ MethodsHandler::ErrorCodes MethodsHandler::invokeResource(const std::string &mod
         return INVALID_METHOD_MODE;
     }
 
-    return invokeResource(mode, resourceName, inputParameters, currentPermissions, securityParameters, payloadOut);
+    return invokeResource(mode, resourceName, inputParameters, securityParameters, payloadOut);
 
 }
 
@@ -9,6 +9,7 @@
 #include <Mantids30/Protocol_HTTP/httpv1_server.h>
 #include <Mantids30/Protocol_HTTP/rsp_status.h>
 #include <Mantids30/Threads/mutex_shared.h>
+#include "router.h"
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -20,7 +21,7 @@ namespace Mantids30 { namespace API { namespace RESTful {
 struct RequestParameters
 {
     Mantids30::Network::Protocols::HTTP::HTTPv1_Base::Request * clientRequest = nullptr; ///< Holds all the information from the client request
-    Json::Value pathParameters;     ///< Holds parameters from the URL path
+    PathParameters pathParameters;  ///< Holds parameters from the URL path (route template captures or legacy key/value pairs)
     Json::Value emptyJSON;
     Json::Value * inputJSON = &emptyJSON;     ///< Holds the input JSON that came from the request body.
 
@@ -51,6 +52,7 @@ struct RESTfulAPIDefinition
         bool requireJWTHeaderAuthentication = true;
         bool requireJWTCookieAuthentication = true;
         std::set<std::string> requiredPermissions;
+        DataFormat::AccessMask requiredPermissionsMask; ///< requiredPermissions interned (filled by addResource)
         //bool requireGenericAntiCSRFToken = true;
         //bool requireJWTCookieHash = true;
     };
@@ -160,7 +162,7 @@ public:
      * @brief Add a new resource to the MethodsHandler.
      *
      * @param mode The RESTful method mode (GET, POST, PUT, DELETE).
-     * @param resourceName The name of the resource.
+     * @param resourceName The name of the resource, or a route template (see Router, eg. "users/{id:int}/devices/{mac}").
      * @param method The function pointer to the method.
      * @param context The object pointer for the method.
      * @param requireJWTHeaderAuthentication If true, user authentication is required.
@@ -178,9 +180,9 @@ public:
      * @brief Add a new resource to the MethodsHandler with RESTfulAPIDefinition struct.
      *
      * @param mode The RESTful method mode (GET, POST, PUT, DELETE).
-     * @param resourceName The name of the resource.
+     * @param resourceName The name of the resource, or a route template (see Router).
      * @param method The RESTfulAPIDefinition struct containing method, security, and object pointer.
-     * @return Returns true if the resource was added successfully, false otherwise.
+     * @return Returns true if the resource was added successfully, false otherwise (invalid mode or template).
      */
     bool addResource(const MethodMode & mode, const std::string & resourceName, const RESTfulAPIDefinition & method);
 
@@ -188,33 +190,33 @@ public:
      * @brief Invoke a resource and return the error code.
      *
      * @param mode The RESTful method mode (GET, POST, PUT, DELETE).
-     * @param resourceName The name of the resource.
+     * @param resourceName The requested resource path (eg. "users/10/devices/aa:bb"). If no route matches the whole path,
+     *                     the first segment is used as the resource name and the rest as legacy "key/value" pairs.
+     *                     Captured parameters refer to this string, it must remain valid during the invocation.
      * @param inputParameters The input parameters for the method.
-     * @param currentPermissions The set of current permissions for the user.
-     * @param authenticated If true, the user is authenticated.
+     * @param securityParameters The authentication methods provided by the client (permissions are checked against inputParameters.jwtToken).
      * @param[out] payloadOut The output payload after invoking the method.
      * @return The error code indicating the result of the method invocation.
      */
-    ErrorCodes invokeResource(const MethodMode & mode, const std::string & resourceName, RESTful::RequestParameters &inputParameters, const std::set<std::string> &currentPermissions, const SecurityParameters & securityParameters, APIReturn *payloadOut);
+    ErrorCodes invokeResource(const MethodMode & mode, const std::string & resourceName, RESTful::RequestParameters &inputParameters, const SecurityParameters & securityParameters, APIReturn *payloadOut);
 
     /**
      * @brief Invoke a resource with a string representation of the method mode and return the error code.
      *
      * @param modeStr The string representation of the RESTful method mode (e.g. "GET", "POST", "PUT", "DELETE").
-     * @param resourceName The name of the resource.
+     * @param resourceName The requested resource path (eg. "users/10/devices/aa:bb"). If no route matches the whole path,
+     *                     the first segment is used as the resource name and the rest as legacy "key/value" pairs.
+     *                     Captured parameters refer to this string, it must remain valid during the invocation.
      * @param inputParameters The input parameters for the method.
-     * @param currentPermissions The set of current permissions for the user.
-     * @param authenticated If true, the user is authenticated.
+     * @param securityParameters The authentication methods provided by the client (permissions are checked against inputParameters.jwtToken).
      * @param[out] payloadOut The output payload after invoking the method.
      * @return The error code indicating the result of the method invocation.
      */
-    ErrorCodes invokeResource(const std::string & modeStr, const std::string & resourceName, RESTful::RequestParameters &inputParameters, const std::set<std::string> &currentPermissions, const SecurityParameters & securityParameters, APIReturn *payloadOut);
+    ErrorCodes invokeResource(const std::string & modeStr, const std::string & resourceName, RESTful::RequestParameters &inputParameters, const SecurityParameters & securityParameters, APIReturn *payloadOut);
 
 private:
-    std::map<std::string, RESTfulAPIDefinition> m_methodsGET;    ///< Map of GET resources.
-    std::map<std::string, RESTfulAPIDefinition> m_methodsPOST;   ///< Map of POST resources.
-    std::map<std::string, RESTfulAPIDefinition> m_methodsPUT;    ///< Map of PUT resources.
-    std::map<std::string, RESTfulAPIDefinition> m_methodsDELETE; ///< Map of DELETE resources.
+    Router m_routes[4];                                ///< Resource routes by method mode (values are m_definitions indexes).
+    std::vector<RESTfulAPIDefinition> m_definitions;   ///< Resource definitions.
 
     Threads::Sync::Mutex_Shared m_methodsMutex; ///< Mutex for protecting access to the maps of resources.
 
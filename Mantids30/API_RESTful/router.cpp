@@ -0,0 +1,420 @@
+#include "router.h"
+
+#include <charconv>
+
+using namespace Mantids30::API::RESTful;
+
+struct Router::Node
+{
+    std::string prefix;                            ///< Static text (compressed), empty for parameter/wildcard nodes.
+    std::vector<std::unique_ptr<Node>> children;   ///< Static children (each one starts with a different char).
+    std::unique_ptr<Node> parameter;               ///< Parameter child (takes one path segment).
+    std::unique_ptr<Node> wildcard;                ///< Wildcard child (takes the rest of the path).
+
+    std::string parameterName;                     ///< Name for parameter/wildcard nodes.
+    eParameterType parameterType = PARAM_STRING;
+
+    bool hasRoute = false;
+    uint32_t routeId = 0;
+};
+
+bool PathParameters::has(const std::string_view &name) const
+{
+    for (size_t i = 0; i < m_count; i++)
+    {
+        if (m_names[i] == name)
+            return true;
+    }
+    return false;
+}
+
+std::string_view PathParameters::get(const std::string_view &name) const
+{
+    for (size_t i = 0; i < m_count; i++)
+    {
+        if (m_names[i] == name)
+            return m_values[i];
+    }
+    return {};
+}
+
+std::string PathParameters::getString(const std::string_view &name, const std::string &defaultValue) const
+{
+    for (size_t i = 0; i < m_count; i++)
+    {
+        if (m_names[i] == name)
+            return std::string(m_values[i]);
+    }
+    return defaultValue;
+}
+
+int64_t PathParameters::getInt64(const std::string_view &name, const int64_t &defaultValue) const
+{
+    std::string_view value = get(name);
+    int64_t r;
+    auto result = std::from_chars(value.data(), value.data() + value.size(), r);
+    if (value.empty() || result.ec != std::errc() || result.ptr != value.data() + value.size())
+        return defaultValue;
+    return r;
+}
+
+uint64_t PathParameters::getUInt64(const std::string_view &name, const uint64_t &defaultValue) const
+{
+    std::string_view value = get(name);
+    uint64_t r;
+    auto result = std::from_chars(value.data(), value.data() + value.size(), r);
+    if (value.empty() || result.ec != std::errc() || result.ptr != value.data() + value.size())
+        return defaultValue;
+    return r;
+}
+
+const Json::Value &PathParameters::toJSON() const
+{
+    if (!m_json)
+    {
+        m_json.reset(new Json::Value(Json::objectValue));
+        for (size_t i = 0; i < m_count; i++)
+        {
+            std::string name(m_names[i]);
+            if (m_nullValues & (1u << i))
+                (*m_json)[name] = Json::nullValue;
+            else
+                (*m_json)[name] = std::string(m_values[i]);
+        }
+    }
+    return *m_json;
+}
+
+bool PathParameters::add(const std::string_view &name, const std::string_view &value)
+{
+    if (m_count == MAX_PARAMETERS)
+        return false;
+    m_names[m_count] = name;
+    m_values[m_count] = value;
+    m_nullValues &= ~(1u << m_count);
+    m_count++;
+    m_json.reset();
+    return true;
+}
+
+void PathParameters::addKeyValuePairs(std::string_view path)
+{
+    while (!path.empty())
+    {
+        size_t slash = path.find('/');
+        std::string_view key = path.substr(0, slash);
+        path = slash == std::string_view::npos ? std::string_view() : path.substr(slash + 1);
+        if (key.empty())
+            continue;
+
+        if (path.empty() && slash == std::string_view::npos)
+        {
+            // Key without value.
+            if (!add(key, std::string_view()))
+                return;
+            m_nullValues |= (1u << (m_count - 1));
+            return;
+        }
+
+        slash = path.find('/');
+        std::string_view value = path.substr(0, slash);
+        path = slash == std::string_view::npos ? std::string_view() : path.substr(slash + 1);
+        if (!add(key, value))
+            return;
+    }
+}
+
+void PathParameters::truncate(const size_t &count)
+{
+    if (count < m_count)
+    {
+        m_count = count;
+        m_json.reset();
+    }
+}
+
+Router::Router() : m_root(new Node)
+{
+}
+
+Router::~Router() = default;
+Router::Router(Router &&) noexcept = default;
+Router &Router::operator=(Router &&) noexcept = default;
+
+int Router::addRoute(std::string_view pathTemplate, const uint32_t &routeId, uint32_t *previousRouteId)
+{
+    if (!pathTemplate.empty() && pathTemplate[0] == '/')
+        pathTemplate.remove_prefix(1);
+
+    // Validate the whole template before touching the tree:
+    struct Token
+    {
+        std::string_view staticText;
+        std::string_view name;
+        eParameterType type;
+        bool isWildcard;
+    };
+    std::vector<Token> tokens;
+
+    std::string_view rest = pathTemplate;
+    while (!rest.empty())
+    {
+        // Find the next segment starting with a parameter/wildcard:
+        size_t p = 0;
+        for (; p < rest.size(); p++)
+        {
+            if ((p == 0 || rest[p - 1] == '/') && (rest[p] == '{' || (rest[p] == '*' && p + 1 == rest.size())))
+                break;
+        }
+
+        Token token{rest.substr(0, p), {}, PARAM_STRING, false};
+        rest.remove_prefix(p);
+        if (rest.empty())
+        {
+            tokens.push_back(token);
+            break;
+        }
+
+        if (rest[0] == '*')
+        {
+            token.name = "*";
+            token.isWildcard = true;
+            rest = {};
+        }
+        else
+        {
+            size_t close = rest.find('}');
+            if (close == std::string_view::npos || (close + 1 < rest.size() && rest[close + 1] != '/'))
+                return 0;
+
+            std::string_view spec = rest.substr(1, close - 1);
+            rest.remove_prefix(close + 1);
+
+            if (!spec.empty() && spec.back() == '*')
+            {
+                token.name = spec.substr(0, spec.size() - 1);
+                token.isWildcard = true;
+                if (!rest.empty())
+                    return 0;
+            }
+            else
+            {
+                size_t colon = spec.find(':');
+                token.name = spec.substr(0, colon);
+                if (colon != std::string_view::npos)
+                {
+                    std::string_view type = spec.substr(colon + 1);
+                    if (type == "int")
+                        token.type = PARAM_INT;
+                    else if (type == "uint")
+                        token.type = PARAM_UINT;
+                    else if (type != "str")
+                        return 0;
+                }
+            }
+        }
+
+        if (token.name.empty() || tokens.size() >= PathParameters::MAX_PARAMETERS)
+            return 0;
+        tokens.push_back(token);
+    }
+
+    // Check parameter conflicts before creating anything:
+    // (a parameter at the same position should have the same name and type in every template)
+    {
+        const Node * node = m_root.get();
+        for (const Token & token : tokens)
+        {
+            std::string_view text = token.staticText;
+            while (node && !text.empty())
+            {
+                const Node * next = nullptr;
+                for (const auto & child : node->children)
+                {
+                    if (child->prefix[0] == text[0])
+                    {
+                        next = child.get();
+                        break;
+                    }
+                }
+                if (!next || text.substr(0, next->prefix.size()) != next->prefix)
+                {
+                    node = nullptr; // New branch from here, nothing else to check.
+                    break;
+                }
+                text.remove_prefix(next->prefix.size());
+                node = next;
+            }
+            if (!node || token.name.empty())
+                break;
+
+            const Node * param = token.isWildcard ? node->wildcard.get() : node->parameter.get();
+            if (param && (param->parameterName != token.name || param->parameterType != token.type))
+                return 0;
+            node = param;
+        }
+    }
+
+    Node * node = m_root.get();
+    for (const Token & token : tokens)
+    {
+        node = insertStatic(node, token.staticText);
+        if (token.name.empty())
+            continue;
+
+        std::unique_ptr<Node> & child = token.isWildcard ? node->wildcard : node->parameter;
+        if (!child)
+        {
+            child.reset(new Node);
+            child->parameterName = std::string(token.name);
+            child->parameterType = token.type;
+        }
+        node = child.get();
+    }
+
+    int r = 1;
+    if (node->hasRoute)
+    {
+        if (previousRouteId)
+            *previousRouteId = node->routeId;
+        r = 2;
+    }
+    node->hasRoute = true;
+    node->routeId = routeId;
+    return r;
+}
+
+bool Router::match(std::string_view path, PathParameters &parameters, uint32_t &routeId) const
+{
+    if (!path.empty() && path[0] == '/')
+        path.remove_prefix(1);
+
+    size_t mark = parameters.size();
+    if (matchNode(m_root.get(), path, parameters, routeId))
+        return true;
+    parameters.truncate(mark);
+    return false;
+}
+
+bool Router::matchNode(const Node *node, std::string_view path, PathParameters &parameters, uint32_t &routeId)
+{
+    if (path.empty())
+    {
+        if (node->hasRoute)
+        {
+            routeId = node->routeId;
+            return true;
+        }
+    }
+    else
+    {
+        // Static children first (at most one can start with this char):
+        for (const auto & child : node->children)
+        {
+            if (child->prefix[0] == path[0])
+            {
+                if (path.substr(0, child->prefix.size()) == child->prefix &&
+                    matchNode(child.get(), path.substr(child->prefix.size()), parameters, routeId))
+                    return true;
+                break;
+            }
+        }
+
+        // Then the parameter (one segment):
+        if (node->parameter)
+        {
+            std::string_view value = path.substr(0, path.find('/'));
+            if (!value.empty() && isValidParameter(node->parameter->parameterType, value))
+            {
+                size_t mark = parameters.size();
+                if (parameters.add(node->parameter->parameterName, value) &&
+                    matchNode(node->parameter.get(), path.substr(value.size()), parameters, routeId))
+                    return true;
+                parameters.truncate(mark);
+            }
+        }
+    }
+
+    // Finally the wildcard (the rest of the path, can be empty):
+    if (node->wildcard && parameters.add(node->wildcard->parameterName, path))
+    {
+        routeId = node->wildcard->routeId;
+        return true;
+    }
+
+    return false;
+}
+
+bool Router::isValidParameter(const eParameterType &type, const std::string_view &value)
+{
+    size_t i = 0;
+    switch (type)
+    {
+    case PARAM_INT:
+        if (value[0] == '-')
+            i = 1;
+        // fallthrough
+    case PARAM_UINT:
+        if (i == value.size())
+            return false;
+        for (; i < value.size(); i++)
+        {
+            if (value[i] < '0' || value[i] > '9')
+                return false;
+        }
+        return true;
+    case PARAM_STRING:
+    default:
+        return true;
+    }
+}
+
+Router::Node *Router::insertStatic(Node *node, std::string_view text)
+{
+    while (!text.empty())
+    {
+        Node * next = nullptr;
+        for (const auto & child : node->children)
+        {
+            if (child->prefix[0] == text[0])
+            {
+                next = child.get();
+                break;
+            }
+        }
+
+        if (!next)
+        {
+            node->children.emplace_back(new Node);
+            next = node->children.back().get();
+            next->prefix = std::string(text);
+            return next;
+        }
+
+        size_t common = 0;
+        while (common < next->prefix.size() && common < text.size() && next->prefix[common] == text[common])
+            common++;
+
+        if (common < next->prefix.size())
+        {
+            // Split: the current node keeps the common part, the rest goes to a new child.
+            std::unique_ptr<Node> tail(new Node);
+            tail->prefix = next->prefix.substr(common);
+            tail->children = std::move(next->children);
+            tail->parameter = std::move(next->parameter);
+            tail->wildcard = std::move(next->wildcard);
+            tail->hasRoute = next->hasRoute;
+            tail->routeId = next->routeId;
+
+            next->prefix.resize(common);
+            next->children.clear();
+            next->children.push_back(std::move(tail));
+            next->hasRoute = false;
+            next->routeId = 0;
+        }
+
+        text.remove_prefix(common);
+        node = next;
+    }
+    return node;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <json/json.h>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mantids30 { namespace API { namespace RESTful {
+
+/**
+ * @brief The PathParameters class holds the parameters captured from the request path.
+ *
+ * Names and values are views: names point into the router and values into the request path, so they are only valid
+ * during the method invocation. The JSON form is only built when requested (toJSON()).
+ */
+class PathParameters
+{
+public:
+    enum { MAX_PARAMETERS = 16 };
+
+    PathParameters() = default;
+
+    /**
+     * @brief has Returns true if the parameter was captured.
+     */
+    bool has(const std::string_view & name) const;
+    /**
+     * @brief get Get the raw parameter value (empty if not captured).
+     */
+    std::string_view get(const std::string_view & name) const;
+    /**
+     * @brief getString Get the parameter value as string.
+     */
+    std::string getString(const std::string_view & name, const std::string & defaultValue = "") const;
+    /**
+     * @brief getInt64 Get the parameter value as a signed integer (defaultValue if not captured or not a number).
+     */
+    int64_t getInt64(const std::string_view & name, const int64_t & defaultValue = 0) const;
+    /**
+     * @brief getUInt64 Get the parameter value as an unsigned integer (defaultValue if not captured or not a number).
+     */
+    uint64_t getUInt64(const std::string_view & name, const uint64_t & defaultValue = 0) const;
+
+    /**
+     * @brief size Number of captured parameters.
+     */
+    size_t size() const { return m_count; }
+    std::string_view getName(const size_t & pos) const { return pos < m_count ? m_names[pos] : std::string_view(); }
+    std::string_view getValue(const size_t & pos) const { return pos < m_count ? m_values[pos] : std::string_view(); }
+
+    /**
+     * @brief toJSON Get the parameters as a JSON object (built on the first call).
+     */
+    const Json::Value & toJSON() const;
+
+    /**
+     * @brief add Append a captured parameter.
+     * @return false if MAX_PARAMETERS was reached.
+     */
+    bool add(const std::string_view & name, const std::string_view & value);
+    /**
+     * @brief addKeyValuePairs Append parameters in the legacy form "key1/value1/key2/value2" (a key without value
+     *                         is captured with an empty value and serialized as null in toJSON()).
+     */
+    void addKeyValuePairs(std::string_view path);
+    /**
+     * @brief truncate Discard the parameters added after the given position (used for backtracking).
+     */
+    void truncate(const size_t & count);
+    void clear() { truncate(0); }
+
+private:
+    std::string_view m_names[MAX_PARAMETERS];
+    std::string_view m_values[MAX_PARAMETERS];
+    uint32_t m_nullValues = 0;  // legacy keys without value (serialized as null), one bit per position
+    size_t m_count = 0;
+
+    mutable std::unique_ptr<Json::Value> m_json;
+};
+
+/**
+ * @brief The Router class resolves request paths against route templates using a compressed radix tree.
+ *
+ * Template syntax (parameters and wildcards must take a whole path segment):
+ *  - static text:          "users/list"
+ *  - parameter:            "users/{id}/devices/{mac}"  (any non-empty segment)
+ *  - typed parameter:      "users/{id:int}", "{id:uint}"  (the segment must be a number of that type)
+ *  - wildcard (last only): "files/{path*}", or a bare "*" as the last segment (captures the rest of the path, named
+ *                          "*" in the latter)
+ *
+ * Static segments have priority over parameters, and parameters over wildcards. Matching is done in one pass over
+ * the path, without allocations (backtracking only happens when a more specific branch dead-ends).
+ *
+ * The router is not thread-safe: synchronize modifications with the lookups.
+ */
+class Router
+{
+public:
+    Router();
+    ~Router();
+    Router(Router &&) noexcept;
+    Router & operator=(Router &&) noexcept;
+
+    /**
+     * @brief addRoute Add a route template.
+     * @param pathTemplate route template (a leading '/' is ignored).
+     * @param routeId value returned when the template matches.
+     * @param previousRouteId if not null, receives the id being replaced (if the template already existed).
+     * @return 0 if the template is invalid or conflicts with an existing parameter (different name/type at the same
+     *         position), 1 if added, 2 if an existing template was replaced.
+     */
+    int addRoute(std::string_view pathTemplate, const uint32_t & routeId, uint32_t * previousRouteId = nullptr);
+
+    /**
+     * @brief match Resolve a path.
+     * @param path request path (a leading '/' is ignored).
+     * @param parameters receives the captured parameters (appended).
+     * @param routeId receives the matched route id.
+     * @return true if a route matched.
+     */
+    bool match(std::string_view path, PathParameters & parameters, uint32_t & routeId) const;
+
+private:
+    enum eParameterType
+    {
+        PARAM_STRING,
+        PARAM_INT,
+        PARAM_UINT
+    };
+
+    struct Node;
+
+    static bool matchNode(const Node * node, std::string_view path, PathParameters & parameters, uint32_t & routeId);
+    static bool isValidParameter(const eParameterType & type, const std::string_view & value);
+    static Node * insertStatic(Node * node, std::string_view text);
+
+    std::unique_ptr<Node> m_root;
+};
+
+}}}
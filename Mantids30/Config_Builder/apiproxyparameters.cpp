@@ -28,6 +28,16 @@ ExtraHeaders
 
 PrivateCAPath "/path/to/ca.pem"   ; Path to private CA (if UsePrivateCA were true)
 
+Pool
+{
+    Enabled true   ; Reuse upstream connections (keep-alive)
+    MaxConnectionsPerHost 64   ; Max simultaneous connections to the remote host
+    MaxIdleConnectionsPerHost 16   ; Max idle connections kept for reuse
+    IdleTimeout 30   ; Seconds before closing an idle connection
+    MaxRequestsPerConnection 1000   ; Requests before renewing the connection (0: unlimited)
+}
+MaxResponseBodySize 1073741824   ; Max upstream response body size in bytes
+
 */
 std::shared_ptr<ApiProxyParameters> ApiProxyConfig::createApiProxyParams(
     Mantids30::Program::Logs::AppLog *log, const boost::property_tree::ptree &config, const std::map<std::string, std::string> &vars)
@@ -59,6 +69,25 @@ std::shared_ptr<ApiProxyParameters> ApiProxyConfig::createApiProxyParams(
                   static_cast<unsigned int>(params->remotePort),
                   params->privateCAPath.c_str());
 
+        if (auto pool = config.get_child_optional("Pool"))
+        {
+            params->usePool = pool->get<bool>("Enabled", true);
+            params->maxConnectionsPerHost = pool->get<size_t>("MaxConnectionsPerHost", 64);
+            params->maxIdleConnectionsPerHost = pool->get<size_t>("MaxIdleConnectionsPerHost", 16);
+            params->idleTimeoutSeconds = pool->get<uint32_t>("IdleTimeout", 30);
+            params->maxRequestsPerConnection = pool->get<uint32_t>("MaxRequestsPerConnection", 1000);
+        }
+        params->maxResponseBodySize = config.get<uint64_t>("MaxResponseBodySize", 1024*1024*1024);
+
+        log->log0(__func__,
+                  Logs::LEVEL_DEBUG,
+                  "Upstream pool: Enabled=%s, MaxConnectionsPerHost=%zu, MaxIdleConnectionsPerHost=%zu, IdleTimeout=%u, MaxRequestsPerConnection=%u",
+                  params->usePool ? "true" : "false",
+                  params->maxConnectionsPerHost,
+                  params->maxIdleConnectionsPerHost,
+                  params->idleTimeoutSeconds,
+                  params->maxRequestsPerConnection);
+
         // Parse extra headers
         if (auto extraHeaders = config.get_child_optional("ExtraHeaders"))
         {
@@ -3,6 +3,11 @@
 #include "jwt.h"
 #include "apiproxyparameters.h"
 
+#include <Mantids30/Server_WebCore/prometheusmetrics.h>
+#include <Mantids30/Server_WebCore/tracedump.h>
+#include <Mantids30/Program_Tracing/tracing.h>
+
+#include <Mantids30/Net_Sockets/listener_handoff.h>
 #include <Mantids30/Net_Sockets/socket_tcp.h>
 #include <Mantids30/Net_Sockets/socket_tls.h>
 #include <memory>
@@ -37,7 +42,7 @@ Mantids30::Network::Servers::RESTful::Engine *Mantids30::Program::Config::RESTfu
 {
     bool usingTLS = config->get<bool>("UseTLS", true);
 
-    std::shared_ptr<Sockets::Socket_Stream> sockWebListen;
+    std::shared_ptr<Sockets::Socket_TCP> sockWebListen;
 
     // Retrieve listen port and address from configuration
     uint16_t listenPort = config->get<uint16_t>("ListenPort", 8443);
@@ -84,9 +89,11 @@ Mantids30::Network::Servers::RESTful::Engine *Mantids30::Program::Config::RESTfu
     }
 
     sockWebListen->setUseIPv6(config->get<bool>("UseIPv6", false));
+    // Many processes can share the port (the kernel balances the connections between them):
+    sockWebListen->setReusePort(config->get<bool>("ReusePort", false));
 
-    // Start listening on the specified address and port
-    if (sockWebListen->listenOn(listenPort, listenAddr.c_str()))
+    // Start listening on the specified address and port (or adopt the listening socket handed off by the previous process)
+    if (Sockets::ListenerHandoff::getDefault().listenOn(sockWebListen, listenPort, listenAddr.c_str()))
     {
         // Create and configure the web server instance
         Network::Servers::RESTful::Engine *webServer = new Network::Servers::RESTful::Engine();
@@ -167,6 +174,9 @@ Mantids30::Network::Servers::RESTful::Engine *Mantids30::Program::Config::RESTfu
         else
             webServer->setAcceptMultiThreaded(sockWebListen, threadsCount);
 
+        // Wait for the current connections when the listening socket is handed off to a new process:
+        Sockets::ListenerHandoff::getDefault().addDrainFunction([webServer](const uint32_t &gracePeriodMS) { return webServer->drain(gracePeriodMS); });
+
         // WebServer Extras:
         if (config->find("Proxies") != config->not_found())
         {
@@ -207,6 +217,54 @@ Mantids30::Network::Servers::RESTful::Engine *Mantids30::Program::Config::RESTfu
             }
         }
 
+        if (config->get<bool>("Metrics.Enabled", false))
+        {
+            // Prometheus scrape endpoint (eg. /metrics/) with the process-wide metrics:
+            std::string metricsPath = config->get<std::string>("Metrics.Path", "/metrics");
+            std::shared_ptr<Network::Servers::Web::PrometheusMetricsParameters> metricsParams = std::make_shared<Network::Servers::Web::PrometheusMetricsParameters>();
+            metricsParams->bearerToken = config->get<std::string>("Metrics.BearerToken", "");
+
+            if (metricsParams->bearerToken.empty())
+            {
+                log->log0(__func__, Logs::LEVEL_ERR, "[%p] Not exposing the metrics at %s Service: Metrics.BearerToken is required",
+                          (void*)webServer, serviceName.c_str());
+            }
+            else
+            {
+                log->log0(__func__, Logs::LEVEL_INFO, "[%p] Exposing the metrics at path '%s' at %s Service",
+                          (void*)webServer,
+                          metricsPath.c_str(), serviceName.c_str());
+
+                webServer->config.dynamicRequestHandlersByRoute[metricsPath] = {&Network::Servers::Web::PrometheusMetrics, metricsParams};
+            }
+        }
+
+        if (config->get<bool>("Tracing.Enabled", false))
+        {
+            // Request tracing (sampled, or asked by the client with the "X-Mantids-Trace: 1" header):
+            Program::Tracing::setEnabled(true);
+            Program::Tracing::setSamplingRate(config->get<uint32_t>("Tracing.SamplingRate", 0));
+            Program::Tracing::setRequestTriggerAllowed(config->get<bool>("Tracing.AllowRequestTrigger", false));
+
+            std::string tracesPath = config->get<std::string>("Tracing.Path", "/traces");
+            std::shared_ptr<Network::Servers::Web::TraceDumpParameters> tracesParams = std::make_shared<Network::Servers::Web::TraceDumpParameters>();
+            tracesParams->bearerToken = config->get<std::string>("Tracing.BearerToken", "");
+
+            if (tracesParams->bearerToken.empty())
+            {
+                log->log0(__func__, Logs::LEVEL_ERR, "[%p] Not exposing the request traces at %s Service: Tracing.BearerToken is required",
+                          (void*)webServer, serviceName.c_str());
+            }
+            else
+            {
+                log->log0(__func__, Logs::LEVEL_INFO, "[%p] Exposing the request traces at path '%s' at %s Service",
+                          (void*)webServer,
+                          tracesPath.c_str(), serviceName.c_str());
+
+                webServer->config.dynamicRequestHandlersByRoute[tracesPath] = {&Network::Servers::Web::TraceDump, tracesParams};
+            }
+        }
+
 
 
         return webServer;
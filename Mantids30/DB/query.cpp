@@ -1,5 +1,6 @@
 #include "query.h"
 #include "sqlconnector.h"
+#include <Mantids30/Program_Tracing/tracing.h>
 #include <memory>
 #include <stdexcept>
 
@@ -81,6 +82,7 @@ unsigned long long Query::getLastInsertRowID() const
 
 bool Query::exec(const ExecType &execType)
 {
+    Program::Tracing::Span span("db.query", m_query);
     return exec0(execType, false);
 }
 
@@ -91,6 +93,30 @@ bool Query::step()
     return step0();
 }
 
+size_t Query::fetchRows(Memory::Abstract::RowBuffer &buffer, const size_t &maxRows)
+{
+    size_t rows = 0;
+    clearDestroyableStringsForResults();
+    while (maxRows == 0 || rows < maxRows)
+    {
+        if (!fetchRow0(buffer))
+        {
+            // Discard any partially filled row.
+            buffer.rollbackRow();
+            break;
+        }
+        buffer.commitRow();
+        rows++;
+    }
+    return rows;
+}
+
+bool Query::fetchRow0(Memory::Abstract::RowBuffer &)
+{
+    m_lastSQLError = "Row buffers are not supported by this driver.";
+    return false;
+}
+
 bool Query::isNull(const size_t &column)
 {
     if ((column + 1) > m_fieldIsNull.size())
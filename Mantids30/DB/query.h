@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Mantids30/Memory/a_var.h>
+#include <Mantids30/Memory/a_rowbuffer.h>
 #include <map>
 #include <list>
 #include <memory>
@@ -93,6 +94,18 @@ public:
      */
     bool step();
 
+    /**
+     * @brief Fetches the SELECT results into a columnar row buffer.
+     *
+     * The buffer columns define the requested types (the variables bound with bindResultVars are not used),
+     * and cells are written without locks nor virtual calls per cell.
+     *
+     * @param buffer The destination buffer (rows are appended).
+     * @param maxRows Maximum number of rows to fetch (0 for every remaining row).
+     * @return The number of fetched rows.
+     */
+    size_t fetchRows(Memory::Abstract::RowBuffer & buffer, const size_t & maxRows = 0);
+
     /**
      * @brief Checks if the specified column value is NULL.
      * @param column The index of the column.
@@ -145,6 +158,11 @@ protected:
     * @return True if successful, false otherwise.
     */
     virtual bool step0() = 0;
+    /**
+    * @brief (Internal use) Appends the next row into the row buffer.
+    * @return True if a complete row was appended, false at the end of the results (or if the driver does not support it).
+    */
+    virtual bool fetchRow0(Memory::Abstract::RowBuffer & buffer);
 
     /**
     * @brief (Internal use) Handles post-binding of input variables.
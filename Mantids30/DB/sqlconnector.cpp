@@ -1,8 +1,11 @@
 #include "sqlconnector.h"
+#include <Mantids30/Program_Metrics/registry.h>
+#include <Mantids30/Program_Tracing/tracing.h>
 #include <memory>
 #include <unistd.h>
 
 using namespace Mantids30::Database;
+using namespace Mantids30::Program;
 
 
 SQLConnector::~SQLConnector()
@@ -67,8 +70,21 @@ std::shared_ptr<Query> SQLConnector::createQuery(eQueryPTRErrors *error)
 
     query->m_throwCPPErrorOnQueryFailure = m_throwCPPErrorOnQueryFailure;
 
-    if (!query->setSqlConnector(this, &m_databaseLockMutex, m_maxQueryLockMilliseconds))
+    // Time waiting for the database lock (lease), one query at time per connector:
+    static Metrics::Family<Metrics::Histogram> & leaseWait = Metrics::Registry::getDefault().histogramFamily(
+        "mantids30_db_lease_wait_seconds", "Time waiting to acquire the database connection lock.", {"driver"}, Metrics::Histogram::latencyLayout());
+    static Metrics::Family<Metrics::Counter> & leaseTimeouts = Metrics::Registry::getDefault().counterFamily(
+        "mantids30_db_lease_timeouts_total", "Queries not created because the database connection lock was not acquired in time.", {"driver"});
+
+    auto leaseStart = std::chrono::steady_clock::now();
+    bool leased = query->setSqlConnector(this, &m_databaseLockMutex, m_maxQueryLockMilliseconds);
+    leaseWait.withLabels({driverName()}).observeSince(leaseStart);
+    if (Tracing::isTracing())
+        Tracing::recordSpan("db.lock_wait", leaseStart, std::chrono::steady_clock::now());
+
+    if (!leased)
     {
+        leaseTimeouts.withLabels({driverName()}).add();
         // Query will be detached by itself...
         *error = QUERY_UNABLETOADQUIRELOCK;
         return nullptr;
@@ -0,0 +1,851 @@
+#include "pgsql_binarycodec.h"
+
+#include <Mantids30/Memory/a_allvars.h>
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <vector>
+
+using namespace Mantids30::Database;
+using namespace Mantids30;
+
+// PostgreSQL epoch (2000-01-01 00:00:00 UTC) expressed as unix time.
+#define PGSQL_EPOCH_OFFSET 946684800LL
+
+// Address families used by the inet/cidr binary format (not the OS AF_* values).
+#define PGSQL_AF_INET 2
+#define PGSQL_AF_INET6 3
+
+// numeric sign word values
+#define PGSQL_NUMERIC_NEG 0x4000
+#define PGSQL_NUMERIC_NAN 0xC000
+#define PGSQL_NUMERIC_PINF 0xD000
+#define PGSQL_NUMERIC_NINF 0xF000
+
+bool PostgreSQL_BinaryCodec::decodeInto(Memory::Abstract::Var *var, const Oid &oid, const char *data, const int &len)
+{
+    switch (var->getVarType())
+    {
+    case Memory::Abstract::Var::TYPE_BOOL:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(BOOL, var)->setValue(value != 0);
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_INT8:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(INT8, var)->setValue(static_cast<int8_t>(value));
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_INT16:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(INT16, var)->setValue(static_cast<int16_t>(value));
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_INT32:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(INT32, var)->setValue(static_cast<int32_t>(value));
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_INT64:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(INT64, var)->setValue(value);
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_UINT8:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(UINT8, var)->setValue(static_cast<uint8_t>(value));
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_UINT16:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(UINT16, var)->setValue(static_cast<uint16_t>(value));
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_UINT32:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(UINT32, var)->setValue(static_cast<uint32_t>(value));
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_UINT64:
+    {
+        // numeric(20) columns holding values above INT64_MAX go through the text conversion.
+        int64_t value;
+        if (oid != OID_NUMERIC && decodeInteger(oid, data, len, value))
+            return ABSTRACT_PTR_AS(UINT64, var)->setValue(static_cast<uint64_t>(value));
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_DOUBLE:
+    {
+        double value;
+        if (decodeDouble(oid, data, len, value))
+        {
+            ABSTRACT_PTR_AS(DOUBLE, var)->setValue(value);
+            return true;
+        }
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_DATETIME:
+    {
+        time_t value;
+        if (decodeTimestamp(oid, data, len, value))
+            return ABSTRACT_PTR_AS(DATETIME, var)->setValue(value);
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_IPV4:
+    {
+        if ((oid == OID_INET || oid == OID_CIDR) && len == 8 && data[0] == PGSQL_AF_INET)
+        {
+            in_addr addr;
+            memcpy(&addr, data + 4, 4);
+            return ABSTRACT_PTR_AS(IPV4, var)->setValue(addr, static_cast<uint8_t>(data[1]));
+        }
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_IPV6:
+    {
+        if ((oid == OID_INET || oid == OID_CIDR) && len == 20 && data[0] == PGSQL_AF_INET6)
+        {
+            in6_addr addr;
+            memcpy(&addr, data + 4, 16);
+            return ABSTRACT_PTR_AS(IPV6, var)->setValue(addr);
+        }
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_MACADDR:
+    {
+        if (oid == OID_MACADDR && len == 6)
+            return ABSTRACT_PTR_AS(MACADDR, var)->setValue(reinterpret_cast<const unsigned char *>(data));
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_BIN:
+    {
+        // Binary format gives the raw bytes (no \x hex escaping as in the text format)
+        Memory::Abstract::BINARY::sBinContainer binContainer;
+        binContainer.ptr = const_cast<char *>(data);
+        binContainer.dataSize = len;
+        bool r = ABSTRACT_PTR_AS(BINARY, var)->setValue(&binContainer);
+        binContainer.ptr = nullptr; // don't destroy the data.
+        return r;
+    }
+    case Memory::Abstract::Var::TYPE_STRING:
+        return ABSTRACT_PTR_AS(STRING, var)->setValue(toText(oid, data, len));
+    case Memory::Abstract::Var::TYPE_VARCHAR:
+    {
+        // This will copy the memory.
+        std::string value = toText(oid, data, len);
+        return ABSTRACT_PTR_AS(VARCHAR, var)->setValue(value.data());
+    }
+    case Memory::Abstract::Var::TYPE_STRINGLIST:
+    {
+        if (isArrayOID(oid))
+        {
+            std::list<std::string> values;
+            if (!decodeArray(data, len, values))
+                return false;
+            return ABSTRACT_PTR_AS(STRINGLIST, var)->setValue(values);
+        }
+    }
+    break;
+    case Memory::Abstract::Var::TYPE_PTR:
+        // This will reference the memory, but will disappear on the next step
+        return ABSTRACT_PTR_AS(PTR, var)->setValue(const_cast<char *>(data));
+    case Memory::Abstract::Var::TYPE_NULL:
+        // Don't copy the value (not needed).
+        return true;
+    }
+
+    // Type mismatch between the column and the variable: go through the text representation.
+    return var->fromString(toText(oid, data, len));
+}
+
+bool PostgreSQL_BinaryCodec::appendTo(Memory::Abstract::RowBuffer::Column &column, const Oid &oid, const char *data, const int &len)
+{
+    int64_t i;
+    switch (column.getType())
+    {
+    case Memory::Abstract::Var::TYPE_BOOL:
+        if (!decodeInteger(oid, data, len, i))
+            break;
+        column.append<bool>(i != 0);
+        return true;
+    case Memory::Abstract::Var::TYPE_INT8:
+        if (!decodeInteger(oid, data, len, i))
+            break;
+        column.append(static_cast<int8_t>(i));
+        return true;
+    case Memory::Abstract::Var::TYPE_INT16:
+        if (!decodeInteger(oid, data, len, i))
+            break;
+        column.append(static_cast<int16_t>(i));
+        return true;
+    case Memory::Abstract::Var::TYPE_INT32:
+        if (!decodeInteger(oid, data, len, i))
+            break;
+        column.append(static_cast<int32_t>(i));
+        return true;
+    case Memory::Abstract::Var::TYPE_INT64:
+        if (!decodeInteger(oid, data, len, i))
+            break;
+        column.append(i);
+        return true;
+    case Memory::Abstract::Var::TYPE_UINT8:
+        if (!decodeInteger(oid, data, len, i))
+            break;
+        column.append(static_cast<uint8_t>(i));
+        return true;
+    case Memory::Abstract::Var::TYPE_UINT16:
+        if (!decodeInteger(oid, data, len, i))
+            break;
+        column.append(static_cast<uint16_t>(i));
+        return true;
+    case Memory::Abstract::Var::TYPE_UINT32:
+        if (!decodeInteger(oid, data, len, i))
+            break;
+        column.append(static_cast<uint32_t>(i));
+        return true;
+    case Memory::Abstract::Var::TYPE_UINT64:
+        if (oid == OID_NUMERIC || !decodeInteger(oid, data, len, i))
+            break;
+        column.append(static_cast<uint64_t>(i));
+        return true;
+    case Memory::Abstract::Var::TYPE_DOUBLE:
+    {
+        double d;
+        if (!decodeDouble(oid, data, len, d))
+            break;
+        column.append(d);
+        return true;
+    }
+    case Memory::Abstract::Var::TYPE_DATETIME:
+    {
+        time_t t;
+        if (!decodeTimestamp(oid, data, len, t))
+            break;
+        column.append(t);
+        return true;
+    }
+    case Memory::Abstract::Var::TYPE_IPV4:
+        if ((oid == OID_INET || oid == OID_CIDR) && len == 8 && data[0] == PGSQL_AF_INET)
+        {
+            column.appendRaw(data + 4, 4);
+            return true;
+        }
+        break;
+    case Memory::Abstract::Var::TYPE_IPV6:
+        if ((oid == OID_INET || oid == OID_CIDR) && len == 20 && data[0] == PGSQL_AF_INET6)
+        {
+            column.appendRaw(data + 4, 16);
+            return true;
+        }
+        break;
+    case Memory::Abstract::Var::TYPE_MACADDR:
+        if (oid == OID_MACADDR && len == 6)
+        {
+            column.appendRaw(data, 6);
+            return true;
+        }
+        break;
+    case Memory::Abstract::Var::TYPE_BIN:
+        column.appendRaw(data, len);
+        return true;
+    case Memory::Abstract::Var::TYPE_STRING:
+    case Memory::Abstract::Var::TYPE_VARCHAR:
+    case Memory::Abstract::Var::TYPE_PTR:
+        if (oid == OID_TEXT || oid == OID_VARCHAR || oid == OID_BPCHAR || oid == OID_NAME)
+        {
+            // Same bytes in both formats, no intermediate string.
+            column.appendRaw(data, len);
+            return true;
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Type mismatch between the column and the buffer: go through the text representation.
+    return column.appendFromString(toText(oid, data, len));
+}
+
+bool PostgreSQL_BinaryCodec::encodeParam(const std::shared_ptr<Memory::Abstract::Var> &var, std::string &out, Oid &oid)
+{
+    switch (var->getVarType())
+    {
+    case Memory::Abstract::Var::TYPE_BOOL:
+        oid = OID_BOOL;
+        out.push_back(ABSTRACT_SPTR_AS(BOOL, var)->getValue() ? 1 : 0);
+        return true;
+    case Memory::Abstract::Var::TYPE_INT8:
+        // PostgreSQL has no 1-byte integer, int2 is the smallest one.
+        oid = OID_INT2;
+        appendU16(out, static_cast<uint16_t>(static_cast<int16_t>(ABSTRACT_SPTR_AS(INT8, var)->getValue())));
+        return true;
+    case Memory::Abstract::Var::TYPE_UINT8:
+        oid = OID_INT2;
+        appendU16(out, static_cast<uint16_t>(ABSTRACT_SPTR_AS(UINT8, var)->getValue()));
+        return true;
+    case Memory::Abstract::Var::TYPE_INT16:
+        oid = OID_INT2;
+        appendU16(out, static_cast<uint16_t>(ABSTRACT_SPTR_AS(INT16, var)->getValue()));
+        return true;
+    case Memory::Abstract::Var::TYPE_UINT16:
+        oid = OID_INT4;
+        appendU32(out, static_cast<uint32_t>(ABSTRACT_SPTR_AS(UINT16, var)->getValue()));
+        return true;
+    case Memory::Abstract::Var::TYPE_INT32:
+        oid = OID_INT4;
+        appendU32(out, static_cast<uint32_t>(ABSTRACT_SPTR_AS(INT32, var)->getValue()));
+        return true;
+    case Memory::Abstract::Var::TYPE_UINT32:
+        oid = OID_INT8;
+        appendU64(out, static_cast<uint64_t>(ABSTRACT_SPTR_AS(UINT32, var)->getValue()));
+        return true;
+    case Memory::Abstract::Var::TYPE_INT64:
+        oid = OID_INT8;
+        appendU64(out, static_cast<uint64_t>(ABSTRACT_SPTR_AS(INT64, var)->getValue()));
+        return true;
+    case Memory::Abstract::Var::TYPE_DOUBLE:
+    {
+        double value = ABSTRACT_SPTR_AS(DOUBLE, var)->getValue();
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        oid = OID_FLOAT8;
+        appendU64(out, bits);
+        return true;
+    }
+    default:
+        // UINT64 does not fit in int8, DATETIME/IP/MAC text inputs rely on the server-side
+        // implicit casts (eg. to timestamp without time zone or to text columns), and the
+        // string types are already sent verbatim.
+        return false;
+    }
+}
+
+bool PostgreSQL_BinaryCodec::canDecode(const Oid &oid)
+{
+    switch (oid)
+    {
+    case OID_BOOL:
+    case OID_BYTEA:
+    case OID_CHAR:
+    case OID_NAME:
+    case OID_INT8:
+    case OID_INT2:
+    case OID_INT4:
+    case OID_TEXT:
+    case OID_OID:
+    case OID_JSON:
+    case OID_XML:
+    case OID_CIDR:
+    case OID_FLOAT4:
+    case OID_FLOAT8:
+    case OID_UNKNOWN:
+    case OID_MACADDR:
+    case OID_INET:
+    case OID_BPCHAR:
+    case OID_VARCHAR:
+    case OID_DATE:
+    case OID_TIMESTAMP:
+    case OID_TIMESTAMPTZ:
+    case OID_NUMERIC:
+    case OID_UUID:
+    case OID_JSONB:
+        return true;
+    default:
+        return isArrayOID(oid);
+    }
+}
+
+std::string PostgreSQL_BinaryCodec::toText(const Oid &oid, const char *data, const int &len)
+{
+    if (isArrayOID(oid))
+        return arrayToText(data, len);
+
+    switch (oid)
+    {
+    case OID_BOOL:
+        return (len >= 1 && data[0]) ? "t" : "f";
+    case OID_INT2:
+    case OID_INT4:
+    case OID_INT8:
+    {
+        int64_t value;
+        if (decodeInteger(oid, data, len, value))
+            return std::to_string(value);
+        return "";
+    }
+    case OID_OID:
+        return len == 4 ? std::to_string(readU32(data)) : "";
+    case OID_FLOAT4:
+    case OID_FLOAT8:
+    {
+        double value;
+        if (!decodeDouble(oid, data, len, value))
+            return "";
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.*g", oid == OID_FLOAT4 ? 9 : 17, value);
+        return buf;
+    }
+    case OID_NUMERIC:
+        return numericToText(data, len);
+    case OID_DATE:
+    case OID_TIMESTAMP:
+    case OID_TIMESTAMPTZ:
+    {
+        time_t value;
+        if (!decodeTimestamp(oid, data, len, value))
+            return "";
+        return Memory::Abstract::DATETIME(value).toString();
+    }
+    case OID_INET:
+    case OID_CIDR:
+    {
+        if (len == 8 && data[0] == PGSQL_AF_INET)
+        {
+            in_addr addr;
+            memcpy(&addr, data + 4, 4);
+            return Memory::Abstract::IPV4::_toString(addr, static_cast<uint8_t>(data[1]));
+        }
+        if (len == 20 && data[0] == PGSQL_AF_INET6)
+        {
+            in6_addr addr;
+            memcpy(&addr, data + 4, 16);
+            std::string r = Memory::Abstract::IPV6::_toString(addr);
+            if (static_cast<uint8_t>(data[1]) != 128)
+                r += "/" + std::to_string(static_cast<uint8_t>(data[1]));
+            return r;
+        }
+        return "";
+    }
+    case OID_MACADDR:
+        return len == 6 ? Memory::Abstract::MACADDR::_toString(reinterpret_cast<const unsigned char *>(data)) : "";
+    case OID_UUID:
+    {
+        if (len != 16)
+            return "";
+        char buf[37];
+        const unsigned char *u = reinterpret_cast<const unsigned char *>(data);
+        snprintf(buf, sizeof(buf), "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+                 u[0], u[1], u[2], u[3], u[4], u[5], u[6], u[7], u[8], u[9], u[10], u[11], u[12], u[13], u[14], u[15]);
+        return buf;
+    }
+    case OID_JSONB:
+        // jsonb binary = version byte (1) + text.
+        return len >= 1 ? std::string(data + 1, len - 1) : "";
+    case OID_BYTEA:
+    {
+        // Same as the text format (bytea_output = hex).
+        static const char hex[] = "0123456789abcdef";
+        std::string r = "\\x";
+        r.reserve(2 + (static_cast<size_t>(len) * 2));
+        for (int i = 0; i < len; i++)
+        {
+            r += hex[static_cast<unsigned char>(data[i]) >> 4];
+            r += hex[static_cast<unsigned char>(data[i]) & 0xF];
+        }
+        return r;
+    }
+    default:
+        // text, varchar, bpchar, name, "char", json, xml and unknown are sent verbatim.
+        return std::string(data, len);
+    }
+}
+
+std::string PostgreSQL_BinaryCodec::arrayToText(const char *data, const int &len)
+{
+    // Header: ndim, has-null flag, element type, then (size, lower bound) per dimension.
+    if (len < 12)
+        return "";
+
+    int32_t ndim = static_cast<int32_t>(readU32(data));
+    Oid elementType = readU32(data + 8);
+    if (ndim == 0)
+        return "{}";
+    if (ndim < 0 || ndim > 6 || len < 12 + (ndim * 8))
+        return "";
+
+    std::vector<int32_t> sizes(ndim);
+    std::string r;
+    bool defaultBounds = true;
+    for (int32_t d = 0; d < ndim; d++)
+    {
+        sizes[d] = static_cast<int32_t>(readU32(data + 12 + (d * 8)));
+        int32_t lowerBound = static_cast<int32_t>(readU32(data + 16 + (d * 8)));
+        if (sizes[d] < 0)
+            return "";
+        if (sizes[d] == 0)
+            return "{}";
+        if (lowerBound != 1)
+            defaultBounds = false;
+        r += "[" + std::to_string(lowerBound) + ":" + std::to_string(static_cast<int64_t>(lowerBound) + sizes[d] - 1) + "]";
+    }
+    // The bounds are only written when they are not the default ones.
+    if (defaultBounds)
+        r.clear();
+    else
+        r += "=";
+
+    int pos = 12 + (ndim * 8);
+    std::vector<int32_t> counters(ndim, 0);
+    for (int32_t d = 0; d < ndim; d++)
+        r += "{";
+
+    for (;;)
+    {
+        if (pos + 4 > len)
+            return "";
+        int32_t elementLen = static_cast<int32_t>(readU32(data + pos));
+        pos += 4;
+        if (elementLen < 0)
+            r += "NULL";
+        else
+        {
+            if (pos + elementLen > len)
+                return "";
+            std::string element = toText(elementType, data + pos, elementLen);
+            pos += elementLen;
+
+            // Quoted as array_out does:
+            bool quote = element.empty() || strcasecmp(element.c_str(), "NULL") == 0;
+            for (char c : element)
+            {
+                if (c == '{' || c == '}' || c == ',' || c == '"' || c == '\\' || isspace(static_cast<unsigned char>(c)))
+                    quote = true;
+            }
+            if (!quote)
+                r += element;
+            else
+            {
+                r += '"';
+                for (char c : element)
+                {
+                    if (c == '"' || c == '\\')
+                        r += '\\';
+                    r += c;
+                }
+                r += '"';
+            }
+        }
+
+        // Next element: close the finished dimensions, and open them again if there are more elements.
+        int32_t d = ndim - 1;
+        while (d >= 0 && ++counters[d] == sizes[d])
+        {
+            counters[d] = 0;
+            r += "}";
+            d--;
+        }
+        if (d < 0)
+            return r;
+        r += ",";
+        for (int32_t i = d + 1; i < ndim; i++)
+            r += "{";
+    }
+}
+
+bool PostgreSQL_BinaryCodec::isArrayOID(const Oid &oid)
+{
+    switch (oid)
+    {
+    case 199:  // json[]
+    case 651:  // cidr[]
+    case 1000: // bool[]
+    case 1002: // char[]
+    case 1003: // name[]
+    case 1005: // int2[]
+    case 1007: // int4[]
+    case 1009: // text[]
+    case 1014: // bpchar[]
+    case 1015: // varchar[]
+    case 1016: // int8[]
+    case 1021: // float4[]
+    case 1022: // float8[]
+    case 1028: // oid[]
+    case 1040: // macaddr[]
+    case 1041: // inet[]
+    case 1115: // timestamp[]
+    case 1182: // date[]
+    case 1185: // timestamptz[]
+    case 1231: // numeric[]
+    case 2951: // uuid[]
+    case 3807: // jsonb[]
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool PostgreSQL_BinaryCodec::decodeArray(const char *data, const int &len, std::list<std::string> &values)
+{
+    // Header: ndim, has-null flag, element type, then (size, lower bound) per dimension.
+    if (len < 12)
+        return false;
+
+    int32_t ndim = static_cast<int32_t>(readU32(data));
+    Oid elementType = readU32(data + 8);
+
+    if (ndim == 0)
+        return true;
+    if (ndim < 0 || len < 12 + (ndim * 8))
+        return false;
+
+    int64_t elements = 1;
+    for (int32_t d = 0; d < ndim; d++)
+        elements *= static_cast<int32_t>(readU32(data + 12 + (d * 8)));
+
+    int pos = 12 + (ndim * 8);
+    for (int64_t i = 0; i < elements; i++)
+    {
+        if (pos + 4 > len)
+            return false;
+        int32_t elementLen = static_cast<int32_t>(readU32(data + pos));
+        pos += 4;
+        if (elementLen < 0)
+        {
+            values.push_back("");
+            continue;
+        }
+        if (pos + elementLen > len)
+            return false;
+        values.push_back(toText(elementType, data + pos, elementLen));
+        pos += elementLen;
+    }
+    return true;
+}
+
+bool PostgreSQL_BinaryCodec::decodeInteger(const Oid &oid, const char *data, const int &len, int64_t &value)
+{
+    switch (oid)
+    {
+    case OID_BOOL:
+    case OID_CHAR:
+        if (len != 1)
+            return false;
+        value = (oid == OID_BOOL) ? (data[0] ? 1 : 0) : static_cast<int8_t>(data[0]);
+        return true;
+    case OID_INT2:
+        if (len != 2)
+            return false;
+        value = static_cast<int16_t>(readU16(data));
+        return true;
+    case OID_INT4:
+        if (len != 4)
+            return false;
+        value = static_cast<int32_t>(readU32(data));
+        return true;
+    case OID_OID:
+        if (len != 4)
+            return false;
+        value = readU32(data);
+        return true;
+    case OID_INT8:
+        if (len != 8)
+            return false;
+        value = static_cast<int64_t>(readU64(data));
+        return true;
+    case OID_FLOAT4:
+    case OID_FLOAT8:
+    {
+        double d;
+        if (!decodeDouble(oid, data, len, d))
+            return false;
+        value = static_cast<int64_t>(d);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool PostgreSQL_BinaryCodec::decodeDouble(const Oid &oid, const char *data, const int &len, double &value)
+{
+    switch (oid)
+    {
+    case OID_FLOAT4:
+    {
+        if (len != 4)
+            return false;
+        uint32_t bits = readU32(data);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        value = f;
+        return true;
+    }
+    case OID_FLOAT8:
+    {
+        if (len != 8)
+            return false;
+        uint64_t bits = readU64(data);
+        memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+    case OID_BOOL:
+    case OID_CHAR:
+    case OID_INT2:
+    case OID_INT4:
+    case OID_INT8:
+    case OID_OID:
+    {
+        int64_t i;
+        if (!decodeInteger(oid, data, len, i))
+            return false;
+        value = static_cast<double>(i);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool PostgreSQL_BinaryCodec::decodeTimestamp(const Oid &oid, const char *data, const int &len, time_t &value)
+{
+    switch (oid)
+    {
+    case OID_TIMESTAMP:
+    case OID_TIMESTAMPTZ:
+    {
+        // Microseconds since 2000-01-01 (timestamp without time zone is taken as UTC, same as the text parser).
+        if (len != 8)
+            return false;
+        int64_t usecs = static_cast<int64_t>(readU64(data));
+        if (usecs == INT64_MAX || usecs == INT64_MIN)
+        {
+            // 'infinity' / '-infinity'
+            value = (usecs == INT64_MAX) ? static_cast<time_t>(INT64_MAX) : 0;
+            return true;
+        }
+        int64_t secs = usecs / 1000000;
+        if (usecs % 1000000 < 0)
+            secs--;
+        value = static_cast<time_t>(secs + PGSQL_EPOCH_OFFSET);
+        return true;
+    }
+    case OID_DATE:
+    {
+        if (len != 4)
+            return false;
+        int32_t days = static_cast<int32_t>(readU32(data));
+        value = static_cast<time_t>((static_cast<int64_t>(days) * 86400) + PGSQL_EPOCH_OFFSET);
+        return true;
+    }
+    case OID_INT4:
+    case OID_INT8:
+    {
+        int64_t i;
+        if (!decodeInteger(oid, data, len, i))
+            return false;
+        value = static_cast<time_t>(i);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+std::string PostgreSQL_BinaryCodec::numericToText(const char *data, const int &len)
+{
+    // Header: ndigits, weight, sign, dscale, followed by ndigits base-10000 digits.
+    if (len < 8)
+        return "";
+
+    int16_t ndigits = static_cast<int16_t>(readU16(data));
+    int16_t weight = static_cast<int16_t>(readU16(data + 2));
+    uint16_t sign = readU16(data + 4);
+    int16_t dscale = static_cast<int16_t>(readU16(data + 6));
+
+    if (sign == PGSQL_NUMERIC_NAN)
+        return "NaN";
+    if (sign == PGSQL_NUMERIC_PINF)
+        return "Infinity";
+    if (sign == PGSQL_NUMERIC_NINF)
+        return "-Infinity";
+    if (ndigits < 0 || len < 8 + (ndigits * 2))
+        return "";
+
+    auto digit = [&](int i) -> int { return (i >= 0 && i < ndigits) ? static_cast<int16_t>(readU16(data + 8 + (i * 2))) : 0; };
+
+    std::string r;
+    if (sign == PGSQL_NUMERIC_NEG)
+        r += '-';
+
+    char buf[8];
+    if (weight < 0)
+        r += '0';
+    else
+    {
+        for (int i = 0; i <= weight; i++)
+        {
+            snprintf(buf, sizeof(buf), i == 0 ? "%d" : "%04d", digit(i));
+            r += buf;
+        }
+    }
+
+    if (dscale > 0)
+    {
+        std::string frac;
+        for (int i = weight + 1; static_cast<int>(frac.size()) < dscale; i++)
+        {
+            snprintf(buf, sizeof(buf), "%04d", digit(i));
+            frac += buf;
+        }
+        frac.resize(dscale);
+        r += '.' + frac;
+    }
+
+    return r;
+}
+
+uint16_t PostgreSQL_BinaryCodec::readU16(const char *data)
+{
+    uint16_t v;
+    memcpy(&v, data, sizeof(v));
+    return ntohs(v);
+}
+
+uint32_t PostgreSQL_BinaryCodec::readU32(const char *data)
+{
+    uint32_t v;
+    memcpy(&v, data, sizeof(v));
+    return ntohl(v);
+}
+
+uint64_t PostgreSQL_BinaryCodec::readU64(const char *data)
+{
+    return (static_cast<uint64_t>(readU32(data)) << 32) | readU32(data + 4);
+}
+
+void PostgreSQL_BinaryCodec::appendU16(std::string &out, const uint16_t &value)
+{
+    uint16_t v = htons(value);
+    out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+void PostgreSQL_BinaryCodec::appendU32(std::string &out, const uint32_t &value)
+{
+    uint32_t v = htonl(value);
+    out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+void PostgreSQL_BinaryCodec::appendU64(std::string &out, const uint64_t &value)
+{
+    appendU32(out, static_cast<uint32_t>(value >> 32));
+    appendU32(out, static_cast<uint32_t>(value & 0xFFFFFFFF));
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <Mantids30/Memory/a_var.h>
+#include <Mantids30/Memory/a_rowbuffer.h>
+#include <list>
+#include <memory>
+#include <string>
+
+#include <libpq-fe.h>
+
+namespace Mantids30 { namespace Database {
+
+/**
+ * @brief The PostgreSQL_BinaryCodec class translates between the PostgreSQL binary wire format
+ *        (resultFormat/paramFormat=1) and the Memory::Abstract variables.
+ *
+ * Decoding works from the column type OID reported by PQftype: when the OID matches the native
+ * representation of the destination variable (eg. int4 into INT32, timestamptz into DATETIME) the
+ * value is read directly from the network-order payload. Any other combination is converted to the
+ * PostgreSQL text representation first and handed to Var::fromString, so mixed types still work.
+ *
+ * Only the types listed in canDecode have a binary decoder, results with any other column type must be
+ * requested in text format (the binary format of most types, eg. interval or money, is not their text).
+ */
+class PostgreSQL_BinaryCodec
+{
+public:
+    /**
+     * @brief Built-in PostgreSQL type OIDs (from pg_type.dat, stable across server versions).
+     */
+    enum TypeOID
+    {
+        OID_BOOL = 16,
+        OID_BYTEA = 17,
+        OID_CHAR = 18,
+        OID_NAME = 19,
+        OID_INT8 = 20,
+        OID_INT2 = 21,
+        OID_INT4 = 23,
+        OID_TEXT = 25,
+        OID_OID = 26,
+        OID_JSON = 114,
+        OID_XML = 142,
+        OID_CIDR = 650,
+        OID_FLOAT4 = 700,
+        OID_FLOAT8 = 701,
+        OID_UNKNOWN = 705,
+        OID_MACADDR = 829,
+        OID_INET = 869,
+        OID_BPCHAR = 1042,
+        OID_VARCHAR = 1043,
+        OID_DATE = 1082,
+        OID_TIMESTAMP = 1114,
+        OID_TIMESTAMPTZ = 1184,
+        OID_NUMERIC = 1700,
+        OID_UUID = 2950,
+        OID_JSONB = 3802
+    };
+
+    /**
+     * @brief decodeInto Sets a result variable from a binary formatted cell.
+     * @param var destination variable.
+     * @param oid column type (PQftype).
+     * @param data cell payload (PQgetvalue, always followed by a zero byte).
+     * @param len payload length (PQgetlength).
+     * @return true if the value was accepted by the variable.
+     */
+    static bool decodeInto(Memory::Abstract::Var *var, const Oid &oid, const char *data, const int &len);
+
+    /**
+     * @brief appendTo Appends a binary formatted cell to a row buffer column.
+     * @param column destination column.
+     * @param oid column type (PQftype).
+     * @param data cell payload.
+     * @param len payload length.
+     * @return true if the value was fully decoded.
+     */
+    static bool appendTo(Memory::Abstract::RowBuffer::Column &column, const Oid &oid, const char *data, const int &len);
+
+    /**
+     * @brief encodeParam Encodes an input variable into the binary wire format.
+     * @param var input variable.
+     * @param out destination buffer (the encoded bytes are appended).
+     * @param oid type OID that should be declared for the parameter.
+     * @return true if the variable type has a binary representation, false if it should be sent as text.
+     */
+    static bool encodeParam(const std::shared_ptr<Memory::Abstract::Var> &var, std::string &out, Oid &oid);
+
+    /**
+     * @brief canDecode Checks if values of this type can be decoded from the binary format.
+     * @param oid column type.
+     * @return true for the types listed in TypeOID and their arrays.
+     */
+    static bool canDecode(const Oid &oid);
+
+    /**
+     * @brief toText Converts a binary formatted value to its PostgreSQL text representation.
+     * @param oid value type (one accepted by canDecode).
+     * @param data value payload.
+     * @param len payload length.
+     * @return text representation (bytea as \x hex, as the text format does).
+     */
+    static std::string toText(const Oid &oid, const char *data, const int &len);
+
+    /**
+     * @brief isArrayOID Checks if the OID is one of the built-in one-dimensional array types.
+     */
+    static bool isArrayOID(const Oid &oid);
+
+    /**
+     * @brief decodeArray Decodes a binary array into a list of text elements (NULL elements are returned as empty strings).
+     * @return false if the payload is malformed.
+     */
+    static bool decodeArray(const char *data, const int &len, std::list<std::string> &values);
+
+private:
+    static bool decodeInteger(const Oid &oid, const char *data, const int &len, int64_t &value);
+    static bool decodeDouble(const Oid &oid, const char *data, const int &len, double &value);
+    static bool decodeTimestamp(const Oid &oid, const char *data, const int &len, time_t &value);
+    static std::string numericToText(const char *data, const int &len);
+    static std::string arrayToText(const char *data, const int &len);
+
+    static uint16_t readU16(const char *data);
+    static uint32_t readU32(const char *data);
+    static uint64_t readU64(const char *data);
+    static void appendU16(std::string &out, const uint16_t &value);
+    static void appendU32(std::string &out, const uint32_t &value);
+    static void appendU64(std::string &out, const uint64_t &value);
+};
+
+}} // Mantids30::Database
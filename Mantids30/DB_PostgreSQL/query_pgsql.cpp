@@ -2,6 +2,7 @@
 #include <memory>
 #include <stdexcept>
 #include "sqlconnector_pgsql.h"
+#include "pgsql_binarycodec.h"
 #include <string.h>
 #include <Mantids30/Memory/a_allvars.h>
 
@@ -18,6 +19,10 @@ Query_PostgreSQL::Query_PostgreSQL()
     m_paramValues=nullptr;
     m_paramLengths=nullptr;
     m_paramFormats=nullptr;
+    m_paramTypes=nullptr;
+
+    m_binaryResults = false;
+    m_textResultsOnly = false;
 
     m_databaseConnectionHandler = nullptr;
     m_results = nullptr;
@@ -31,6 +36,7 @@ Query_PostgreSQL::~Query_PostgreSQL()
     free(m_paramValues);
     free(m_paramLengths);
     free(m_paramFormats);
+    free(m_paramTypes);
 }
 
 // TODO: lastSQLError
@@ -49,9 +55,22 @@ bool Query_PostgreSQL::step0()
         return false;
 
     int columnpos = 0;
+    int columnCount = PQnfields(m_results);
     for ( const auto &outputVar : m_resultVars)
     {
-        m_fieldIsNull.push_back(PQgetisnull(m_results,i,columnpos));
+        if (columnpos >= columnCount)
+            break;
+
+        bool isNull = PQgetisnull(m_results,i,columnpos);
+        m_fieldIsNull.push_back(isNull);
+
+        if (m_binaryResults && !isNull)
+        {
+            // Binary cells are decoded directly from the network-order payload (NULL cells keep the text behaviour below).
+            PostgreSQL_BinaryCodec::decodeInto(outputVar, m_columnTypes[columnpos], PQgetvalue(m_results,i,columnpos), PQgetlength(m_results,i,columnpos));
+            columnpos++;
+            continue;
+        }
 
         switch (outputVar->getVarType())
         {
@@ -138,7 +157,34 @@ bool Query_PostgreSQL::step0()
 
     m_currentRow++;
 
-    return false;
+    return true;
+}
+
+bool Query_PostgreSQL::fetchRow0(Memory::Abstract::RowBuffer &buffer)
+{
+    if (!m_results)
+        return false;
+    if (m_execStatus != PGRES_TUPLES_OK)
+        return false;
+    if (m_currentRow >= PQntuples(m_results))
+        return false;
+
+    int columnCount = PQnfields(m_results);
+    for ( size_t columnpos = 0; columnpos < buffer.getColumnCount(); columnpos++ )
+    {
+        Memory::Abstract::RowBuffer::Column & column = buffer.getColumn(columnpos);
+
+        if ( static_cast<int>(columnpos) >= columnCount || PQgetisnull(m_results,m_currentRow,columnpos) )
+            column.appendNull();
+        else if (m_binaryResults)
+            PostgreSQL_BinaryCodec::appendTo(column, m_columnTypes[columnpos], PQgetvalue(m_results,m_currentRow,columnpos), PQgetlength(m_results,m_currentRow,columnpos));
+        else
+            column.appendFromString(std::string(PQgetvalue(m_results,m_currentRow,columnpos), PQgetlength(m_results,m_currentRow,columnpos)));
+    }
+
+    m_currentRow++;
+
+    return true;
 }
 
 void Query_PostgreSQL::psqlSetDatabaseConnector(PGconn *conn)
@@ -158,8 +204,8 @@ bool Query_PostgreSQL::postBindInputVars()
     std::list<std::string> keysIn;
     for (auto & i : m_inputVars) keysIn.push_back(i.first);
 
-    // Replace the named keys for $0, $1, etc...:
-    while (replaceFirstKey(m_query,keysIn,m_keysByPos, std::string("$") + std::to_string(m_paramCount)))
+    // Replace the named keys for $1, $2, etc...:
+    while (replaceFirstKey(m_query,keysIn,m_keysByPos, std::string("$") + std::to_string(m_paramCount+1)))
     {
         m_paramCount++;
     }
@@ -177,13 +223,32 @@ bool Query_PostgreSQL::postBindInputVars()
     m_paramValues = static_cast<char **>( malloc (m_paramCount * sizeof(char *)) );
     m_paramLengths = static_cast<int *>(malloc( m_paramCount * sizeof(int)) );
     m_paramFormats = static_cast<int *>(malloc( m_paramCount * sizeof(int)) );
+    m_paramTypes = static_cast<Oid *>(malloc( m_paramCount * sizeof(Oid)) );
+
+    // Typed parameters change the server type inference (eg. int4 = numeric comparisons), so only on request:
+    bool binaryParams = ((SQLConnector_PostgreSQL*)m_pSQLConnector)->psqlGetBinaryParameters();
 
     for (size_t pos=0; pos<m_keysByPos.size(); pos++)
     {
         std::shared_ptr<std::string> str = nullptr;
         m_paramFormats[pos] = 0;
+        m_paramTypes[pos] = 0;
         std::string key = m_keysByPos[pos];
 
+        if (binaryParams)
+        {
+            // Numeric types go as typed network-order values (no toString/server side parsing).
+            std::string encoded;
+            if (PostgreSQL_BinaryCodec::encodeParam(m_inputVars[key], encoded, m_paramTypes[pos]))
+            {
+                str = createDestroyableStringForInput(encoded);
+                m_paramValues[pos] = (char *)str->data();
+                m_paramLengths[pos] = str->size();
+                m_paramFormats[pos] = 1;
+                continue;
+            }
+        }
+
         /*
         Bind params here.
         */
@@ -297,14 +362,21 @@ bool Query_PostgreSQL::exec0(const ExecType &execType, bool recursion)
     if (!m_databaseConnectionHandler)
         return false;
 
-    // Prepare the query:
-    m_results = PQexecPrepared(m_databaseConnectionHandler,
+    // Binary results only when every result column is known to be decodable (otherwise, everything goes as text):
+    m_binaryResults = !m_textResultsOnly
+                      && ((SQLConnector_PostgreSQL*)m_pSQLConnector)->psqlGetBinaryTransfer()
+                      && execType==EXEC_TYPE_SELECT
+                      && canDecodeBinaryResults();
+
+    // Execute the parametrized query:
+    m_results = PQexecParams(m_databaseConnectionHandler,
                             m_query.c_str(),
                             m_paramCount,
+                            m_paramTypes,
                             m_paramValues,
                             m_paramLengths,
                             m_paramFormats,
-                            0);
+                            m_binaryResults?1:0);
 
 
     // Maybe is not connected or something failed very hard here.
@@ -357,6 +429,31 @@ bool Query_PostgreSQL::exec0(const ExecType &execType, bool recursion)
     if (execType==EXEC_TYPE_SELECT)
     {
         m_numRows = PQntuples(m_results);
+
+        m_columnTypes.clear();
+        bool decodable = true;
+        for (int col=0; col<PQnfields(m_results); col++)
+        {
+            m_columnTypes.push_back(PQftype(m_results,col));
+            if (!PostgreSQL_BinaryCodec::canDecode(m_columnTypes.back()))
+                decodable = false;
+        }
+
+        // The result column types are also reported in text results, the next executions can go in binary:
+        if (((SQLConnector_PostgreSQL*)m_pSQLConnector)->psqlGetBinaryTransfer())
+            ((SQLConnector_PostgreSQL*)m_pSQLConnector)->psqlSetCachedBinaryDecoding(getBinaryDecodingKey(), decodable);
+
+        if (m_binaryResults && !decodable)
+        {
+            // The column type changed since it was cached (eg. altered table), never hand out undecoded bytes:
+            PQclear(m_results);
+            m_results = nullptr;
+            m_numRows = 0;
+            m_binaryResults = false;
+            m_textResultsOnly = true;
+            return exec0(execType,recursion);
+        }
+
         return m_execStatus == PGRES_TUPLES_OK;
     }
     else
@@ -367,3 +464,24 @@ bool Query_PostgreSQL::exec0(const ExecType &execType, bool recursion)
         return m_execStatus == PGRES_COMMAND_OK;
     }
 }
+
+bool Query_PostgreSQL::canDecodeBinaryResults()
+{
+    // Unknown queries go as text (no describe round-trip), their result types are cached from that execution.
+    bool decodable;
+    if (((SQLConnector_PostgreSQL*)m_pSQLConnector)->psqlGetCachedBinaryDecoding(getBinaryDecodingKey(), decodable))
+        return decodable;
+    return false;
+}
+
+std::string Query_PostgreSQL::getBinaryDecodingKey() const
+{
+    // The result types may depend on the declared parameter types (eg. SELECT $1):
+    std::string queryKey = m_query;
+    for (size_t i=0; i<m_paramCount; i++)
+    {
+        queryKey += '\0';
+        queryKey += std::to_string(m_paramTypes ? m_paramTypes[i] : 0);
+    }
+    return queryKey;
+}
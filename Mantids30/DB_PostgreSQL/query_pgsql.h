@@ -59,6 +59,12 @@ protected:
      */
     bool step0();
 
+    /**
+     * @brief fetchRow0 Appends the next row of the query result into the row buffer.
+     * @return true if there was a next row, false otherwise.
+     */
+    bool fetchRow0(Memory::Abstract::RowBuffer & buffer);
+
     /**
      * @brief postBindInputVars Processes the input parameters after binding.
      * @return true if the input parameters are processed successfully, false otherwise.
@@ -66,12 +72,25 @@ protected:
     bool postBindInputVars();
 
 private:
+    /**
+     * @brief canDecodeBinaryResults Checks if every result column of this query is known to have a binary decoder
+     *                               (learned from a previous execution of the same query text).
+     * @return true if the results can be requested in binary format, false if unknown or not decodable.
+     */
+    bool canDecodeBinaryResults();
+    std::string getBinaryDecodingKey() const;
+
     std::vector<std::string> m_keysByPos; ///< Map of column names by position.
 
     size_t m_paramCount; ///< Number of query parameters.
     char ** m_paramValues; ///< Query parameter values.
     int * m_paramLengths; ///< Lengths of query parameter values.
     int * m_paramFormats; ///< Formats of query parameter values.
+    Oid * m_paramTypes; ///< Declared types of query parameter values (0 lets the server infer it).
+
+    bool m_binaryResults; ///< Results were requested in binary format (resultFormat=1).
+    bool m_textResultsOnly; ///< Results should be requested in text format (a binary result had an undecodable column).
+    std::vector<Oid> m_columnTypes; ///< Result column types (PQftype), used by the binary decoder.
 
     ExecStatusType m_execStatus; ///< Execution status of the last query executed.
 
@@ -9,6 +9,8 @@ SQLConnector_PostgreSQL::SQLConnector_PostgreSQL()
     m_databaseConnectionHandler = nullptr;
     m_port = 5432;
     m_connectionTimeout = 10;
+    m_binaryTransfer = true;
+    m_binaryParameters = false;
 }
 
 SQLConnector_PostgreSQL::~SQLConnector_PostgreSQL()
@@ -184,3 +186,56 @@ void SQLConnector_PostgreSQL::psqlSetConnectionSSLMode(const std::string &value)
 {
     m_connectionSSLMode = value;
 }
+
+void SQLConnector_PostgreSQL::psqlSetBinaryTransfer(const bool &value)
+{
+    m_binaryTransfer = value;
+}
+
+bool SQLConnector_PostgreSQL::psqlGetBinaryTransfer() const
+{
+    return m_binaryTransfer;
+}
+
+void SQLConnector_PostgreSQL::psqlSetBinaryParameters(const bool &value)
+{
+    m_binaryParameters = value;
+}
+
+bool SQLConnector_PostgreSQL::psqlGetBinaryParameters() const
+{
+    return m_binaryParameters;
+}
+
+bool SQLConnector_PostgreSQL::psqlGetCachedBinaryDecoding(const std::string &queryKey, bool &decodable)
+{
+    std::lock_guard<std::mutex> lock(m_binaryDecodingMutex);
+    auto i = m_binaryDecodingByQuery.find(queryKey);
+    if (i == m_binaryDecodingByQuery.end())
+        return false;
+    decodable = i->second.first;
+    // Most recently used first:
+    m_binaryDecodingOrder.splice(m_binaryDecodingOrder.begin(), m_binaryDecodingOrder, i->second.second);
+    return true;
+}
+
+void SQLConnector_PostgreSQL::psqlSetCachedBinaryDecoding(const std::string &queryKey, const bool &decodable)
+{
+    std::lock_guard<std::mutex> lock(m_binaryDecodingMutex);
+    auto i = m_binaryDecodingByQuery.find(queryKey);
+    if (i != m_binaryDecodingByQuery.end())
+    {
+        i->second.first = decodable;
+        m_binaryDecodingOrder.splice(m_binaryDecodingOrder.begin(), m_binaryDecodingOrder, i->second.second);
+        return;
+    }
+
+    // Evict the least recently used query:
+    if (m_binaryDecodingByQuery.size() >= 4096)
+    {
+        m_binaryDecodingByQuery.erase(m_binaryDecodingOrder.back());
+        m_binaryDecodingOrder.pop_back();
+    }
+    m_binaryDecodingOrder.push_front(queryKey);
+    m_binaryDecodingByQuery[queryKey] = std::make_pair(decodable, m_binaryDecodingOrder.begin());
+}
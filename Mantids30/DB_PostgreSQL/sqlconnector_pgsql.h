@@ -3,6 +3,10 @@
 #include <Mantids30/DB/sqlconnector.h>
 #include "query_pgsql.h"
 
+#include <list>
+#include <map>
+#include <mutex>
+
 //#if __has_include(<libpq-fe.h>)
 #include <libpq-fe.h>
 //#elif __has_include(<postgresql/libpq-fe.h>)
@@ -45,6 +49,33 @@ public:
     void psqlSetConnectionOptions(const std::string &value);
     void psqlSetConnectionSSLMode(const std::string &value);
 
+    /**
+     * @brief psqlSetBinaryTransfer Use the binary wire format for the results (default: true)
+     *                              The first execution of each query goes as text, and the next ones in binary format
+     *                              if every result column type can be decoded.
+     * @param value if false, every result will be transferred and parsed as text.
+     */
+    void psqlSetBinaryTransfer(const bool &value);
+    bool psqlGetBinaryTransfer() const;
+    /**
+     * @brief psqlSetBinaryParameters Send the numeric parameters in binary format with their declared type (default: false)
+     *                                Typed parameters (int2/int4/int8/float8/bool) change the server side type inference,
+     *                                eg. comparing a numeric column with an int8 parameter, so the caller has to opt in.
+     * @param value if false, the parameters are sent as text with an unspecified type (0).
+     */
+    void psqlSetBinaryParameters(const bool &value);
+    bool psqlGetBinaryParameters() const;
+
+    /**
+     * @brief psqlGetCachedBinaryDecoding Internal function used by the query to know if the result columns of a query
+     *                                    can be decoded from the binary format (learned from a previous execution).
+     * @param queryKey query text and parameter types.
+     * @param decodable true if every result column has a binary decoder.
+     * @return false if the query was not checked yet.
+     */
+    bool psqlGetCachedBinaryDecoding(const std::string &queryKey, bool &decodable);
+    void psqlSetCachedBinaryDecoding(const std::string &queryKey, const bool &decodable);
+
 protected:
     std::shared_ptr<Query> createQuery0() { return std::make_shared<Query_PostgreSQL>(); };
     bool connect0();
@@ -63,6 +94,12 @@ private:
 
     uint32_t m_connectionTimeout;
     std::string m_connectionOptions, m_connectionSSLMode;
+    bool m_binaryTransfer, m_binaryParameters;
+
+    std::mutex m_binaryDecodingMutex;
+    // LRU of the decodable queries (dynamically built queries would grow it forever):
+    std::list<std::string> m_binaryDecodingOrder;
+    std::map<std::string,std::pair<bool,std::list<std::string>::iterator>> m_binaryDecodingByQuery;
 };
 }}
 
@@ -295,6 +295,79 @@ bool Query_SQLite3::step0()
     return m_lastSQLReturnValue == SQLITE_ROW;
 }
 
+bool Query_SQLite3::fetchRow0(Memory::Abstract::RowBuffer &buffer)
+{
+    m_lastSQLReturnValue = sqlite3_step(m_stmt);
+
+    if ( m_lastSQLReturnValue != SQLITE_ROW )
+        return false;
+
+    int columnCount = sqlite3_column_count(m_stmt);
+    for ( size_t columnpos = 0; columnpos < buffer.getColumnCount(); columnpos++ )
+    {
+        Memory::Abstract::RowBuffer::Column & column = buffer.getColumn(columnpos);
+
+        if ( static_cast<int>(columnpos) >= columnCount || sqlite3_column_type(m_stmt,columnpos) == SQLITE_NULL )
+        {
+            column.appendNull();
+            continue;
+        }
+
+        switch (column.getType())
+        {
+        case Memory::Abstract::Var::TYPE_BOOL:
+            column.append<bool>( sqlite3_column_int(m_stmt, columnpos)?true:false );
+            break;
+        case Memory::Abstract::Var::TYPE_INT8:
+            column.append( static_cast<int8_t>(sqlite3_column_int(m_stmt, columnpos)) );
+            break;
+        case Memory::Abstract::Var::TYPE_INT16:
+            column.append( static_cast<int16_t>(sqlite3_column_int(m_stmt, columnpos)) );
+            break;
+        case Memory::Abstract::Var::TYPE_INT32:
+            column.append( static_cast<int32_t>(sqlite3_column_int(m_stmt, columnpos)) );
+            break;
+        case Memory::Abstract::Var::TYPE_INT64:
+            column.append( static_cast<int64_t>(sqlite3_column_int64(m_stmt, columnpos)) );
+            break;
+        case Memory::Abstract::Var::TYPE_UINT8:
+            column.append( static_cast<uint8_t>(sqlite3_column_int(m_stmt, columnpos)) );
+            break;
+        case Memory::Abstract::Var::TYPE_UINT16:
+            column.append( static_cast<uint16_t>(sqlite3_column_int(m_stmt, columnpos)) );
+            break;
+        case Memory::Abstract::Var::TYPE_UINT32:
+            column.append( static_cast<uint32_t>(sqlite3_column_int64(m_stmt, columnpos)) );
+            break;
+        case Memory::Abstract::Var::TYPE_UINT64:
+            // Not implemented.
+            throw std::runtime_error("UINT64 is not supported by SQLite3 and can lead to precision errors, check your implementation");
+            break;
+        case Memory::Abstract::Var::TYPE_DOUBLE:
+            column.append( sqlite3_column_double(m_stmt, columnpos) );
+            break;
+        case Memory::Abstract::Var::TYPE_BIN:
+            column.appendRaw( sqlite3_column_blob(m_stmt,columnpos), sqlite3_column_bytes(m_stmt,columnpos) );
+            break;
+        case Memory::Abstract::Var::TYPE_STRING:
+        case Memory::Abstract::Var::TYPE_VARCHAR:
+        case Memory::Abstract::Var::TYPE_PTR:
+        {
+            const unsigned char * text = sqlite3_column_text(m_stmt,columnpos);
+            column.appendRaw( text, sqlite3_column_bytes(m_stmt,columnpos) );
+        } break;
+        default:
+        {
+            // DATETIME, IPV4, IPV6, MACADDR and STRINGLIST are stored as text:
+            const unsigned char * text = sqlite3_column_text(m_stmt,columnpos);
+            column.appendFromString( std::string((const char *)text, sqlite3_column_bytes(m_stmt,columnpos)) );
+        } break;
+        }
+    }
+
+    return true;
+}
+
 void Query_SQLite3::setDatabaseConnectionHandler(sqlite3 *newPpDb)
 {
     m_databaseConnectionHandler = newPpDb;
@@ -44,6 +44,12 @@ protected:
      */
     bool step0();
 
+    /**
+     * @brief fetchRow0 Advances the query to the next row and appends it into the row buffer.
+     * @return true if there is a next row, false otherwise.
+     */
+    bool fetchRow0(Memory::Abstract::RowBuffer & buffer);
+
 private:
     sqlite3_stmt *m_stmt;  ///< Pointer to the SQLite3 statement object.
     sqlite3 *m_databaseConnectionHandler;  ///< Pointer to the SQLite3 database connection handler.
@@ -1,11 +1,38 @@
 #include "jwt.h"
 #include <Mantids30/Helpers/encoders.h>
 #include <Mantids30/Helpers/json.h>
+#include <Mantids30/Program_Tracing/tracing.h>
 #include <openssl/hmac.h>
 #include <openssl/pem.h>
 
 using namespace Mantids30::DataFormat;
 
+namespace {
+
+// Decodes a base64url token part into the output (reusing its capacity).
+bool decodeTokenPart(const std::string_view &encoded, std::string &output)
+{
+    size_t length = 0;
+    output.resize(Mantids30::Helpers::Encoders::getBase64DecodedMaxLength(encoded.size()));
+    if (!Mantids30::Helpers::Encoders::decodeFromBase64Buffer(encoded.data(), encoded.size(), reinterpret_cast<unsigned char *>(output.data()), length, true))
+    {
+        output.clear();
+        return false;
+    }
+    output.resize(length);
+    return true;
+}
+
+// Appends the base64url encoding of the data to the output.
+void appendTokenPart(std::string &output, const unsigned char *data, size_t count)
+{
+    size_t pos = output.size();
+    output.resize(pos + Mantids30::Helpers::Encoders::getBase64EncodedLength(count, true));
+    Mantids30::Helpers::Encoders::encodeToBase64Buffer(data, count, output.data() + pos, true);
+}
+
+}
+
 std::string JWT::createHeader() {
     Json::Value header;
     header["typ"] = "JWT";
@@ -57,7 +84,7 @@ bool JWT::isAlgorithmSupported(const std::string &algorithm)
     return false;
 }
 
-std::shared_ptr<JWT::RAWSignature> JWT::createSignature(const std::string& data) {
+std::shared_ptr<JWT::RAWSignature> JWT::createSignature(const std::string_view& data) {
 
     std::shared_ptr<JWT::RAWSignature> r;
 
@@ -75,7 +102,7 @@ std::shared_ptr<JWT::RAWSignature> JWT::createSignature(const std::string& data)
     return r;
 }
 
-std::shared_ptr<JWT::RAWSignature> JWT::createHMACSignature(int hashType, const std::string &data)
+std::shared_ptr<JWT::RAWSignature> JWT::createHMACSignature(int hashType, const std::string_view &data)
 {
     std::shared_ptr<JWT::RAWSignature> r;
     r.reset(new JWT::RAWSignature);
@@ -100,7 +127,7 @@ std::shared_ptr<JWT::RAWSignature> JWT::createHMACSignature(int hashType, const
     return r;
 }
 
-std::shared_ptr<JWT::RAWSignature> JWT::createRSASignature(int hashType, const std::string &data)
+std::shared_ptr<JWT::RAWSignature> JWT::createRSASignature(int hashType, const std::string_view &data)
 {
     std::shared_ptr<JWT::RAWSignature> r;
     r.reset(new JWT::RAWSignature);
@@ -126,7 +153,7 @@ std::shared_ptr<JWT::RAWSignature> JWT::createRSASignature(int hashType, const s
 
                 if (EVP_DigestSignInit(mdctx, NULL, EVP_get_digestbynid(hashType), NULL, pkey) == 1)
                 {
-                    EVP_DigestSignUpdate(mdctx, data.c_str(), data.length());
+                    EVP_DigestSignUpdate(mdctx, data.data(), data.size());
                     size_t signature_len = 0;
                     EVP_DigestSignFinal(mdctx, NULL, &signature_len);
                     r->m_digestSize = signature_len;
@@ -169,7 +196,7 @@ std::shared_ptr<JWT::RAWSignature> JWT::createRSASignature(int hashType, const s
     return r;
 }
 
-int JWT::validateRSASignature(int hashType, const std::string &data, const char *signature, unsigned int signatureLength)
+int JWT::validateRSASignature(int hashType, const std::string_view &data, const char *signature, unsigned int signatureLength)
 {
     int error = 0;
     EVP_PKEY* pkey = nullptr;
@@ -190,7 +217,7 @@ int JWT::validateRSASignature(int hashType, const std::string &data, const char
             {
 
                 EVP_DigestVerifyInit(mdctx, NULL, EVP_get_digestbynid(hashType), NULL, pkey);
-                EVP_DigestVerifyUpdate(mdctx, data.c_str(), data.length());
+                EVP_DigestVerifyUpdate(mdctx, data.data(), data.size());
 
                 // TODO: signatureLength can be greater and don't affect the validation?
                 error = EVP_DigestVerifyFinal(mdctx, reinterpret_cast<const unsigned char*>(signature), signatureLength) == 1 ? 0 : -1;
@@ -299,15 +326,21 @@ std::string JWT::sign(const Json::Value& payload)
 {
     Json::StreamWriterBuilder writer;
     std::string payload_str = Json::writeString(writer, payload);
-    std::string header_str = createHeader();
-    std::string signature;
 
-    std::shared_ptr<JWT::RAWSignature> eSignature = createSignature(header_str + '.' + Helpers::Encoders::encodeToBase64(payload_str, true));
+    // Build header.payload.signature in place (the signature is calculated over the first two parts):
+    std::string token;
+    token.reserve(m_encodedHeader.size() + Helpers::Encoders::getBase64EncodedLength(payload_str.size(), true) + 1024);
+    token = m_encodedHeader;
+    token += '.';
+    appendTokenPart(token, reinterpret_cast<const unsigned char *>(payload_str.data()), payload_str.size());
+
+    std::shared_ptr<JWT::RAWSignature> eSignature = createSignature(token);
 
+    token += '.';
     if (eSignature->m_result == RAWSignature::SIG_OK)
-        signature = Helpers::Encoders::encodeToBase64(eSignature->m_digest,eSignature->m_digestSize, true);
+        appendTokenPart(token, eSignature->m_digest, eSignature->m_digestSize);
 
-    return header_str + '.' + Helpers::Encoders::encodeToBase64(payload_str, true) + '.' + signature;
+    return token;
 }
 
 std::string JWT::signFromToken(Token &token, bool updateDefaultTimeValues)
@@ -325,6 +358,7 @@ std::string JWT::signFromToken(Token &token, bool updateDefaultTimeValues)
 
 bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOutput)
 {
+    Mantids30::Program::Tracing::Span span("jwt.verify");
     JWT::Token dummyToken;
     if (!tokenPayloadOutput)
         tokenPayloadOutput = &dummyToken;
@@ -339,22 +373,24 @@ bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOut
         return false;
     }
 
-    // Extract the base64-encoded header, payload, and signature substrings from the token
-    std::string header_b64 = fullSignedToken.substr(0, pos_header);
-    std::string payload_b64 = fullSignedToken.substr(pos_header + 1, pos_payload - pos_header - 1);
-    std::string signature_b64 = fullSignedToken.substr(pos_payload + 1);
-
-    // Decode the base64-encoded header, payload, and signature strings
-    std::string header_str = Helpers::Encoders::decodeFromBase64(header_b64, true);
-    std::string payload_str = Helpers::Encoders::decodeFromBase64(payload_b64, true);
-    std::string signature_str = Helpers::Encoders::decodeFromBase64(signature_b64, true);
+    // Split the base64-encoded header, payload, and signature (without copying them)
+    std::string_view token(fullSignedToken);
+    std::string_view header_b64 = token.substr(0, pos_header);
+    std::string_view payload_b64 = token.substr(pos_header + 1, pos_payload - pos_header - 1);
+    std::string_view signature_b64 = token.substr(pos_payload + 1);
+    // The signature is calculated over "header.payload"
+    std::string_view signedData = token.substr(0, pos_payload);
 
+    static thread_local std::string payload_str, signature_str;
 
     // If we have a backchannel to check the token itself, check trough backchannel.
     if (verificationCallback)
     {
         if (verificationCallback(fullSignedToken))
         {
+            // (decoded after the callback, which could verify other tokens in this thread)
+            if (!decodeTokenPart(payload_b64, payload_str))
+                return false;
             tokenPayloadOutput->decodePayload(payload_str);
             tokenPayloadOutput->setSignatureVerified(true);
 
@@ -367,6 +403,12 @@ bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOut
         }
     }
 
+    // Decode the payload and the signature into per-thread buffers
+    if (!decodeTokenPart(payload_b64, payload_str) || !decodeTokenPart(signature_b64, signature_str))
+    {
+        return false;
+    }
+
     // Check if the token is already in the cache
     if (m_cache.checkToken(payload_str))
     {
@@ -377,22 +419,17 @@ bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOut
         return tokenPayloadOutput->isValid();
     }
 
-    // Parse the JSON header using the JsonCpp library
-    Json::CharReaderBuilder reader;
-    std::unique_ptr<Json::CharReader> charReader(reader.newCharReader()); // create a unique_ptr to manage the JsonCpp char reader
-    Json::Value header_json;
-    std::string errs;
+    bool isSignatureVerified = false;
 
-    if (!charReader->parse(header_str.data(), header_str.data() + header_str.size(), &header_json, &errs))
+    // Get the header algorithm (headers are parsed once per thread)
+    static thread_local std::string incomingAlgorithm;
+    if (!getHeaderAlgorithm(header_b64, incomingAlgorithm))
     {
         // If the header cannot be parsed, return false
         return false;
     }
 
-    bool isSignatureVerified = false;
-
     // Check that the header algorithm is supported
-    auto incomingAlgorithm = JSON_ASSTRING(header_json, "alg", "");
     if (!isAlgorithmSupported(incomingAlgorithm))
     {
         return false;
@@ -401,7 +438,7 @@ bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOut
     if (isHMACAlgorithm(incomingAlgorithm))
     {
         // Create the signature using the header and payload, and compare with the decoded signature
-        auto computed_signature = createSignature(header_b64 + '.' + payload_b64);
+        auto computed_signature = createSignature(signedData);
         if (computed_signature->m_result != RAWSignature::SIG_OK)
             return false;
 
@@ -417,7 +454,7 @@ bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOut
         // Create the signature using the header and payload, and compare with the decoded signature
 
         // TODO: return specific problems...
-        isSignatureVerified = validateRSASignature(getHashTypeNumber(), header_b64 + '.' + payload_b64, signature_str.data(), signature_str.size()) == 0;
+        isSignatureVerified = validateRSASignature(getHashTypeNumber(), signedData, signature_str.data(), signature_str.size()) == 0;
     }
 
     if (isSignatureVerified)
@@ -444,19 +481,64 @@ bool JWT::decodeNoVerify(const std::string &fullSignedToken, Token *tokenPayload
         return false;
     }
 
-    // Extract the base64-encoded header, payload, and signature substrings from the token
-    std::string header_b64 = fullSignedToken.substr(0, pos_header);
-    std::string payload_b64 = fullSignedToken.substr(pos_header + 1, pos_payload - pos_header - 1);
-    //std::string signature_b64 = fullSignedToken.substr(pos_payload + 1);
-
-    // Decode the base64-encoded header, payload, and signature strings
-    std::string header_str = Helpers::Encoders::decodeFromBase64(header_b64, true);
-    std::string payload_str = Helpers::Encoders::decodeFromBase64(payload_b64, true);
-    //std::string signature_str = Helpers::Encoders::decodeFromBase64(signature_b64, true);
+    // Decode the base64-encoded payload
+    std::string payload_str;
+    if (!decodeTokenPart(std::string_view(fullSignedToken).substr(pos_header + 1, pos_payload - pos_header - 1), payload_str))
+    {
+        return false;
+    }
 
     return tokenPayloadOutput->decodePayload(payload_str);
 }
 
+bool JWT::parseJSON(const char *begin, const char *end, Json::Value *output)
+{
+    static thread_local std::unique_ptr<Json::CharReader> charReader(Json::CharReaderBuilder().newCharReader());
+    std::string errs;
+    return charReader->parse(begin, end, output, &errs);
+}
+
+bool JWT::getHeaderAlgorithm(const std::string_view &encodedHeader, std::string &algorithm)
+{
+    struct ParsedHeader
+    {
+        std::string encodedHeader;
+        std::string algorithm;
+    };
+    // Tokens are usually signed with a few header variants, keep the last ones (replaced in round-robin):
+    static thread_local std::vector<ParsedHeader> parsedHeaders;
+    static thread_local size_t nextReplacement = 0;
+    const size_t maxParsedHeaders = 16;
+
+    for (const ParsedHeader &i : parsedHeaders)
+    {
+        if (i.encodedHeader == encodedHeader)
+        {
+            algorithm = i.algorithm;
+            return true;
+        }
+    }
+
+    std::string header_str;
+    Json::Value header_json;
+    if (!decodeTokenPart(encodedHeader, header_str) || !parseJSON(header_str.data(), header_str.data() + header_str.size(), &header_json))
+    {
+        return false;
+    }
+
+    ParsedHeader parsed{std::string(encodedHeader), JSON_ASSTRING(header_json, "alg", "")};
+    algorithm = parsed.algorithm;
+
+    if (parsedHeaders.size() < maxParsedHeaders)
+        parsedHeaders.push_back(std::move(parsed));
+    else
+    {
+        parsedHeaders[nextReplacement] = std::move(parsed);
+        nextReplacement = (nextReplacement + 1) % maxParsedHeaders;
+    }
+    return true;
+}
+
 JWT::Token JWT::verifyAndDecodeTokenPayload(const std::string &fullSignedToken)
 {
     JWT::Token r,empty;
@@ -1,12 +1,15 @@
 #pragma once
 
 #include "json/value.h"
+#include "jwt_access.h"
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <set>
 #include <thread>
 #include <boost/thread/shared_mutex.hpp>
 #include <condition_variable>
+#include <atomic>
 #include <json/json.h>
 #include <queue>
 #include <unordered_map>
@@ -124,6 +127,31 @@ public:
 
         bool hasRole(const std::string &roleId) const;
 
+        /**
+         * @brief getPermissionsMask Get the token permissions as interned ids (see AccessRegistry::getPermissions).
+         *                           Permissions unknown to the registry when the claims were decoded are not included.
+         */
+        const AccessMask & getPermissionsMask() const { return m_permissionsMask; }
+
+        /**
+         * @brief getRolesMask Get the token roles as interned ids (see AccessRegistry::getRoles).
+         */
+        const AccessMask & getRolesMask() const { return m_rolesMask; }
+
+        /**
+         * @brief hasAllPermissions Check a precompiled set of permissions (AccessRegistry::compile) without copies.
+         * @param required required permissions.
+         * @param missing if not null, receives the required permissions not granted by this token.
+         */
+        bool hasAllPermissions(const AccessMask & required, AccessMask * missing = nullptr) const;
+
+        /**
+         * @brief hasAllRoles Check a precompiled set of roles (AccessRegistry::compile) without copies.
+         * @param required required roles.
+         * @param missing if not null, receives the required roles not granted by this token.
+         */
+        bool hasAllRoles(const AccessMask & required, AccessMask * missing = nullptr) const;
+
         std::map<std::string,Json::Value> getAllClaims();
 
         Json::Value getAllClaimsAsJSON();
@@ -142,8 +170,18 @@ public:
         // Internal function to set the verified status...
         void setSignatureVerified(bool newVerified);
 
+        /**
+         * @brief getClaimsPTR Get direct access to the claims.
+         *                     NOTE: permissions/roles modified through this pointer are not reflected in the access
+         *                     masks until refreshAccessMasks() is called.
+         */
         Json::Value *getClaimsPTR();
 
+        /**
+         * @brief refreshAccessMasks Rebuild the permission/role masks from the claims.
+         */
+        void refreshAccessMasks();
+
         /**
          * @brief isRevoked Return true if the signature was revoked, false otherwise
          * @return
@@ -157,9 +195,17 @@ public:
         void setRevoked(bool newRevoked);
 
     private:
+        static void buildAccessMask(const Json::Value & names, AccessRegistry & registry, AccessMask & mask, uint32_t & generation);
+        static bool hasAllIDs(const AccessMask & current, const uint32_t & generation, const Json::Value & names,
+                              AccessRegistry & registry, const AccessMask & required, AccessMask * missing);
+
         Json::Value m_claims;
         bool m_signatureVerified = false;
         bool m_revoked = false;
+
+        // Interned permissions/roles, and the registry size when they were built (newer ids are resolved by name):
+        AccessMask m_permissionsMask, m_rolesMask;
+        uint32_t m_permissionsGeneration = 0, m_rolesGeneration = 0;
     };
 
     class Cache {
@@ -261,7 +307,7 @@ public:
 
         // Revokation functions...
         void addToRevocationList(const std::string& signature, std::time_t expirationTime);
-        bool isSignatureRevoked(const std::string& signature);
+        bool isSignatureRevoked(const std::string_view& signature);
         void removeExpiredTokensFromRevocationList();
         void clear();
 
@@ -272,7 +318,7 @@ public:
         void garbageCollector();
 
         std::multimap<std::time_t, std::string> m_expirationSignatures;
-        std::set<std::string> m_revokedTokens;
+        std::set<std::string, std::less<>> m_revokedTokens;
         boost::shared_mutex m_revokedTokensMutex;
 
         std::thread m_garbageCollectorThread;
@@ -324,6 +370,7 @@ public:
      */
     JWT(const Algorithm& algorithm = Algorithm::HS256) : m_algorithm(algorithm)
     {
+        m_encodedHeader = createHeader();
     }
 
     /**
@@ -465,7 +512,7 @@ private:
      * @param data The input data to be signed.
      * @return RAWSignature A RAWSignature object containing the generated signature.
      */
-    std::shared_ptr<RAWSignature> createSignature(const std::string& data);
+    std::shared_ptr<RAWSignature> createSignature(const std::string_view& data);
 
     /**
      * @brief Generates an HMAC signature using the specified hash algorithm.
@@ -476,7 +523,7 @@ private:
      * @param digestOutLength A pointer to the length of the generated signature.
      * @return RAWSignature::Result The result of the signature generation operation.
      */
-    std::shared_ptr<RAWSignature> createHMACSignature(int hashType, const std::string& data);
+    std::shared_ptr<RAWSignature> createHMACSignature(int hashType, const std::string_view& data);
 
     /**
      * @brief Generates an RSA signature using the specified hash algorithm.
@@ -487,7 +534,7 @@ private:
      * @param digestOutLength A pointer to the length of the generated signature.
      * @return RAWSignature::Result The result of the signature generation operation.
      */
-    std::shared_ptr<RAWSignature> createRSASignature(int hashType, const std::string& data);
+    std::shared_ptr<RAWSignature> createRSASignature(int hashType, const std::string_view& data);
 
     /**
      * @brief Validates an RSA signature using the specified hash algorithm.
@@ -498,7 +545,7 @@ private:
      * @param signatureLength The length of the signature buffer.
      * @return int 0 if the signature is valid, -1 otherwise.
      */
-    int validateRSASignature(int hashType, const std::string& data, const char* signature, unsigned int signatureLength);
+    int validateRSASignature(int hashType, const std::string_view& data, const char* signature, unsigned int signatureLength);
 
     /**
      * @brief Returns the integer representation of the currently used hash algorithm.
@@ -507,12 +554,34 @@ private:
      */
     int getHashTypeNumber();
 
+    /**
+     * @brief Parses JSON text with a reader owned by the calling thread (reused between tokens).
+     *
+     * @return true if the text was parsed.
+     */
+    static bool parseJSON(const char* begin, const char* end, Json::Value* output);
+
+    /**
+     * @brief Gets the algorithm from a base64url-encoded header, parsing only headers not seen before by the calling thread.
+     *
+     * @param encodedHeader The base64url-encoded header.
+     * @param algorithm The "alg" header value.
+     * @return false if the header can't be decoded or parsed.
+     */
+    static bool getHeaderAlgorithm(const std::string_view& encodedHeader, std::string& algorithm);
+
     /**
      * @brief The cryptographic algorithm used for signature generation.
      *
      */
     Algorithm m_algorithm;
 
+    /**
+     * @brief The base64url-encoded header (it only depends on the algorithm).
+     *
+     */
+    std::string m_encodedHeader;
+
     /**
      * @brief The shared secret used for cryptographic operations.
      *
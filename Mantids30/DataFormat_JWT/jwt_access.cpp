@@ -0,0 +1,149 @@
+#include "jwt_access.h"
+
+#include <mutex>
+
+using namespace Mantids30::DataFormat;
+
+void AccessMask::set(const uint32_t &id)
+{
+    size_t word = id / 64;
+    if (word >= m_words.size())
+        m_words.resize(word + 1, 0);
+    m_words[word] |= (uint64_t(1) << (id % 64));
+}
+
+bool AccessMask::test(const uint32_t &id) const
+{
+    size_t word = id / 64;
+    return word < m_words.size() && (m_words[word] & (uint64_t(1) << (id % 64)));
+}
+
+void AccessMask::clear()
+{
+    m_words.clear();
+}
+
+bool AccessMask::empty() const
+{
+    for (const uint64_t & word : m_words)
+    {
+        if (word)
+            return false;
+    }
+    return true;
+}
+
+bool AccessMask::containsAll(const AccessMask &required) const
+{
+    for (size_t i = 0; i < required.m_words.size(); i++)
+    {
+        uint64_t have = i < m_words.size() ? m_words[i] : 0;
+        if ((required.m_words[i] & have) != required.m_words[i])
+            return false;
+    }
+    return true;
+}
+
+AccessMask AccessMask::missing(const AccessMask &required) const
+{
+    AccessMask r;
+    r.m_words.resize(required.m_words.size(), 0);
+    for (size_t i = 0; i < required.m_words.size(); i++)
+    {
+        uint64_t have = i < m_words.size() ? m_words[i] : 0;
+        r.m_words[i] = required.m_words[i] & ~have;
+    }
+    return r;
+}
+
+uint32_t AccessMask::getSpan() const
+{
+    for (size_t i = m_words.size(); i > 0; i--)
+    {
+        uint64_t word = m_words[i - 1];
+        if (word)
+            return static_cast<uint32_t>((i - 1) * 64 + (64 - __builtin_clzll(word)));
+    }
+    return 0;
+}
+
+std::vector<uint32_t> AccessMask::getIDs() const
+{
+    std::vector<uint32_t> r;
+    for (size_t i = 0; i < m_words.size(); i++)
+    {
+        uint64_t word = m_words[i];
+        while (word)
+        {
+            r.push_back(static_cast<uint32_t>(i * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    return r;
+}
+
+AccessRegistry &AccessRegistry::getPermissions()
+{
+    static AccessRegistry registry;
+    return registry;
+}
+
+AccessRegistry &AccessRegistry::getRoles()
+{
+    static AccessRegistry registry;
+    return registry;
+}
+
+uint32_t AccessRegistry::intern(const std::string &name)
+{
+    uint32_t id;
+    if (find(name, id))
+        return id;
+
+    std::unique_lock<boost::shared_mutex> lock(m_mutex);
+    auto it = m_ids.find(name);
+    if (it != m_ids.end())
+        return it->second;
+
+    id = static_cast<uint32_t>(m_names.size());
+    m_names.push_back(name);
+    m_ids[name] = id;
+    m_size = id + 1;
+    return id;
+}
+
+bool AccessRegistry::find(const std::string &name, uint32_t &id) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+    auto it = m_ids.find(name);
+    if (it == m_ids.end())
+        return false;
+    id = it->second;
+    return true;
+}
+
+std::string AccessRegistry::getName(const uint32_t &id) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+    return id < m_names.size() ? m_names[id] : "";
+}
+
+AccessMask AccessRegistry::compile(const std::set<std::string> &names)
+{
+    AccessMask r;
+    for (const auto & name : names)
+        r.set(intern(name));
+    return r;
+}
+
+std::set<std::string> AccessRegistry::getNames(const AccessMask &mask) const
+{
+    std::set<std::string> r;
+    boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+    for (const uint32_t & id : mask.getIDs())
+    {
+        if (id < m_names.size())
+            r.insert(m_names[id]);
+    }
+    return r;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <boost/thread/shared_mutex.hpp>
+#include <atomic>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Mantids30 { namespace DataFormat {
+
+/**
+ * @brief The AccessMask class is a compact set of interned permission/role ids (see AccessRegistry).
+ *
+ * Authorization checks between masks are word-wise AND/compare operations.
+ */
+class AccessMask
+{
+public:
+    AccessMask() = default;
+
+    /**
+     * @brief set Add an id to the mask.
+     */
+    void set(const uint32_t & id);
+    /**
+     * @brief test Check if the id is contained in the mask.
+     */
+    bool test(const uint32_t & id) const;
+    /**
+     * @brief clear Remove every id from the mask.
+     */
+    void clear();
+    /**
+     * @brief empty Returns true if no id is set.
+     */
+    bool empty() const;
+
+    /**
+     * @brief containsAll Check that every id of the required mask is also set in this mask.
+     */
+    bool containsAll(const AccessMask & required) const;
+    /**
+     * @brief missing Get the ids of the required mask not present in this mask.
+     */
+    AccessMask missing(const AccessMask & required) const;
+
+    /**
+     * @brief getSpan Get the highest id set + 1 (0 if empty).
+     */
+    uint32_t getSpan() const;
+    /**
+     * @brief getIDs Get every id set in the mask (ascending).
+     */
+    std::vector<uint32_t> getIDs() const;
+
+private:
+    std::vector<uint64_t> m_words;
+};
+
+/**
+ * @brief The AccessRegistry class interns permission/role names into small consecutive ids.
+ *
+ * Ids are never released, so the registry only grows with the names the application requires (method requirements
+ * and issued tokens). Names coming from untrusted tokens are only looked up (never interned) to keep the registry
+ * bounded.
+ */
+class AccessRegistry
+{
+public:
+    AccessRegistry() = default;
+
+    /**
+     * @brief getPermissions Process-wide registry for permission names.
+     */
+    static AccessRegistry & getPermissions();
+    /**
+     * @brief getRoles Process-wide registry for role names.
+     */
+    static AccessRegistry & getRoles();
+
+    /**
+     * @brief intern Get the id of a name, creating it if it does not exist.
+     */
+    uint32_t intern(const std::string & name);
+    /**
+     * @brief find Get the id of a name without creating it.
+     * @return false if the name was never interned.
+     */
+    bool find(const std::string & name, uint32_t & id) const;
+    /**
+     * @brief getName Get the name of an interned id (empty if not found).
+     */
+    std::string getName(const uint32_t & id) const;
+    /**
+     * @brief size Get the number of interned names (every id is lower than this value).
+     */
+    uint32_t size() const { return m_size; }
+
+    /**
+     * @brief compile Intern a set of names and return them as a mask.
+     */
+    AccessMask compile(const std::set<std::string> & names);
+    /**
+     * @brief getNames Translate a mask back into names.
+     */
+    std::set<std::string> getNames(const AccessMask & mask) const;
+
+private:
+    mutable boost::shared_mutex m_mutex;
+    std::unordered_map<std::string, uint32_t> m_ids;
+    std::vector<std::string> m_names;
+    std::atomic<uint32_t> m_size{0};
+};
+
+}}
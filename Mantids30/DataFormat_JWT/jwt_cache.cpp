@@ -1,7 +1,9 @@
 #include "jwt.h"
+#include <Mantids30/Program_Metrics/registry.h>
 #include <boost/thread/pthread/shared_mutex.hpp>
 
 using namespace Mantids30::DataFormat;
+using namespace Mantids30::Program;
 
 void JWT::Cache::setCacheMaxByteCount(std::size_t maxByteCount)
 {
@@ -56,8 +58,16 @@ bool JWT::Cache::checkToken(const std::string &payload)
     if (!m_enabled)
         return false;
 
-    auto it = m_tokenCache.find(payload);
-    return it != m_tokenCache.end();
+    static Metrics::Counter & hits = Metrics::Registry::getDefault().counterFamily("mantids30_jwt_cache_lookups_total", "Verified JWT cache lookups.", {"result"}).withLabels({"hit"});
+    static Metrics::Counter & misses = Metrics::Registry::getDefault().counterFamily("mantids30_jwt_cache_lookups_total", "Verified JWT cache lookups.", {"result"}).withLabels({"miss"});
+
+    if (m_tokenCache.find(payload) != m_tokenCache.end())
+    {
+        hits.add();
+        return true;
+    }
+    misses.add();
+    return false;
 }
 
 void JWT::Cache::add(const std::string &payload)
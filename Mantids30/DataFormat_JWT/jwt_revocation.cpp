@@ -25,7 +25,7 @@ void JWT::Revocation::addToRevocationList(const std::string &signature, time_t e
     m_revokedTokens.insert(signature);
 }
 
-bool JWT::Revocation::isSignatureRevoked(const std::string &signature)
+bool JWT::Revocation::isSignatureRevoked(const std::string_view &signature)
 {
     boost::shared_lock<boost::shared_mutex> readLock(m_revokedTokensMutex);
 
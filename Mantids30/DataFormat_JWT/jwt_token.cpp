@@ -42,6 +42,10 @@ void JWT::Token::setJwtId(const std::string &jti) {
 
 void JWT::Token::addClaim(const std::string &name, const Json::Value &value) {
     m_claims[name] = value;
+    if (name == "permissions" || name == "roles")
+    {
+        refreshAccessMasks();
+    }
 }
 
 std::string JWT::Token::exportPayload() const
@@ -52,16 +56,14 @@ std::string JWT::Token::exportPayload() const
 
 bool JWT::Token::decodePayload(const std::string &payload)
 {
-    Json::CharReaderBuilder reader;
-    std::unique_ptr<Json::CharReader> charReader(reader.newCharReader()); // create a unique_ptr to manage the JsonCpp char reader
-    std::string errs;
-
-    if (!charReader->parse(payload.data(), payload.data() + payload.size(), &m_claims, &errs))
+    if (!JWT::parseJSON(payload.data(), payload.data() + payload.size(), &m_claims))
     {
         // If the header cannot be parsed, return false
+        refreshAccessMasks();
         return false;
     }
 
+    refreshAccessMasks();
     return true;
 }
 
@@ -142,10 +144,22 @@ void JWT::Token::addRole(const std::string &roleId)
         m_claims["roles"] = Json::Value(Json::arrayValue);
     }
     m_claims["roles"].append(roleId);
+
+    uint32_t id;
+    if (AccessRegistry::getRoles().find(roleId, id))
+    {
+        m_rolesMask.set(id);
+    }
 }
 
 bool JWT::Token::hasRole(const std::string &roleId) const
 {
+    uint32_t id;
+    if (AccessRegistry::getRoles().find(roleId, id) && id < m_rolesGeneration)
+    {
+        return m_rolesMask.test(id);
+    }
+
     if (m_claims.isMember("roles"))
     {
         const Json::Value& rolesClaims = m_claims["roles"];
@@ -200,10 +214,22 @@ void JWT::Token::addPermission(const std::string &permissionId)
     }
 
     m_claims["permissions"].append(permissionId);
+
+    uint32_t id;
+    if (AccessRegistry::getPermissions().find(permissionId, id))
+    {
+        m_permissionsMask.set(id);
+    }
 }
 
 bool JWT::Token::hasPermission(const std::string &permissionId) const
 {
+    uint32_t id;
+    if (AccessRegistry::getPermissions().find(permissionId, id) && id < m_permissionsGeneration)
+    {
+        return m_permissionsMask.test(id);
+    }
+
     if (m_claims.isMember("permissions"))
     {
         const Json::Value& permissionsClaims = m_claims["permissions"];
@@ -222,6 +248,96 @@ bool JWT::Token::hasPermission(const std::string &permissionId) const
     return false;
 }
 
+bool JWT::Token::hasAllPermissions(const AccessMask &required, AccessMask *missing) const
+{
+    return hasAllIDs(m_permissionsMask, m_permissionsGeneration, m_claims["permissions"], AccessRegistry::getPermissions(), required, missing);
+}
+
+bool JWT::Token::hasAllRoles(const AccessMask &required, AccessMask *missing) const
+{
+    return hasAllIDs(m_rolesMask, m_rolesGeneration, m_claims["roles"], AccessRegistry::getRoles(), required, missing);
+}
+
+void JWT::Token::refreshAccessMasks()
+{
+    buildAccessMask(m_claims["permissions"], AccessRegistry::getPermissions(), m_permissionsMask, m_permissionsGeneration);
+    buildAccessMask(m_claims["roles"], AccessRegistry::getRoles(), m_rolesMask, m_rolesGeneration);
+}
+
+void JWT::Token::buildAccessMask(const Json::Value &names, AccessRegistry &registry, AccessMask &mask, uint32_t &generation)
+{
+    // Take the generation first: any name interned after this point is resolved by name when checked.
+    generation = registry.size();
+    mask.clear();
+
+    if (!names.isArray())
+    {
+        return;
+    }
+
+    for (const auto& name : names)
+    {
+        uint32_t id;
+        // Only lookup: the token may be unverified, so its names are not interned.
+        if (name.isString() && registry.find(name.asString(), id))
+        {
+            mask.set(id);
+        }
+    }
+}
+
+bool JWT::Token::hasAllIDs(const AccessMask &current, const uint32_t &generation, const Json::Value &names, AccessRegistry &registry, const AccessMask &required, AccessMask *missing)
+{
+    if (required.getSpan() <= generation)
+    {
+        // Fast path: every required id existed when the mask was built.
+        if (!missing)
+        {
+            return current.containsAll(required);
+        }
+        *missing = current.missing(required);
+        return missing->empty();
+    }
+
+    // Some required names were interned after the token was decoded, check them by name:
+    AccessMask r;
+    for (const uint32_t & id : required.getIDs())
+    {
+        bool found = false;
+        if (id < generation)
+        {
+            found = current.test(id);
+        }
+        else if (names.isArray())
+        {
+            std::string name = registry.getName(id);
+            for (const auto& i : names)
+            {
+                if (JSON_ASSTRING_D(i,"") == name)
+                {
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        if (!found)
+        {
+            if (!missing)
+            {
+                return false;
+            }
+            r.set(id);
+        }
+    }
+
+    if (missing)
+    {
+        *missing = r;
+    }
+    return r.empty();
+}
+
 std::map<std::string, Json::Value> JWT::Token::getAllClaims()
 {
     std::map<std::string, Json::Value> claimsMap;
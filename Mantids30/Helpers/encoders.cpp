@@ -287,54 +287,8 @@ string Encoders::encodeToBase64(const string &buf, bool url)
 string Encoders::encodeToBase64(const unsigned char *buf, size_t count, bool url)
 {
     std::string result;
-
-    // Create a BIO object for base64 encoding
-    BIO* bio = BIO_new(BIO_f_base64());
-    if (bio != nullptr)
-    {
-        // Create a BIO object for storing the output in memory
-        BIO* bio_mem = BIO_new(BIO_s_mem());
-
-        if (bio_mem)
-        {
-            // Link the BIO objects, so that the output of base64 encoding is written to the memory object
-            BIO_push(bio, bio_mem);
-
-            // Set the BIO_FLAGS_BASE64_NO_NL flag so that no newline characters are added to the output
-            BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-
-            // Write the data to the base64 encoding BIO object
-            int ret = BIO_write(bio, buf, count);
-            if (ret > 0)
-            {
-                // Flush any internal buffer used by the base64 encoding BIO object
-                ret = BIO_flush(bio);
-                if (ret == 1)
-                {
-                    // Get a pointer to the BUF_MEM object used by the memory BIO object
-                    BUF_MEM* buffer_ptr;
-                    ret = BIO_get_mem_ptr(bio_mem, &buffer_ptr);
-                    if (ret == 1 && buffer_ptr != nullptr && buffer_ptr->length > 0)
-                    {
-                        // Create a string from the content of the memory buffer
-                        result.assign(buffer_ptr->data, buffer_ptr->length);
-                    }
-                }
-            }
-            // Free the BIO objects
-            //BIO_free(bio_mem);
-        }
-        BIO_free_all(bio);
-    }
-
-    if (url)
-    {
-        boost::replace_all(result, "/", "_");
-        boost::replace_all(result, "+", "-");
-        result.erase(std::remove_if(result.begin(), result.end(), [](char c) { return c == '='; }), result.end());
-    }
-
-    // Return the base64-encoded string
+    result.resize(getBase64EncodedLength(count, url));
+    result.resize(encodeToBase64Buffer(buf, count, result.data(), url));
     return result;
 }
 
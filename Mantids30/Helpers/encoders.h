@@ -22,6 +22,17 @@ public:
         QUOTEPRINT_ENCODING
     };
 
+    /**
+     * @brief The base64 codec implementations (BASE64_AUTO: the best one supported by the CPU).
+     */
+    enum BASE64_IMPLEMENTATION
+    {
+        BASE64_AUTO,
+        BASE64_SCALAR,
+        BASE64_SSSE3,
+        BASE64_AVX2
+    };
+
     /**
      * @brief Performs an obfuscated base64 encoding on binary data.
      *
@@ -106,6 +117,61 @@ public:
      */
     static std::string encodeToBase64(unsigned char const *buf, size_t count, bool url = false);
 
+    /**
+     * @brief Calculates the base64 encoded length of binary data.
+     *
+     * @param count The length of the input binary data in bytes.
+     * @param url A boolean indicating whether the output is URL-safe base64 (without padding).
+     *
+     * @return The number of base64 characters.
+     */
+    static size_t getBase64EncodedLength(size_t count, bool url = false);
+    /**
+     * @brief Calculates the maximum decoded length of a base64-encoded text (with or without padding).
+     *
+     * @param count The length of the base64-encoded text.
+     *
+     * @return The maximum number of decoded bytes.
+     */
+    static size_t getBase64DecodedMaxLength(size_t count);
+    /**
+     * @brief Performs a base64 encoding on binary data into a caller buffer.
+     *
+     * Uses AVX2 or SSSE3 when the CPU supports it (with a scalar fallback), no memory is allocated.
+     *
+     * @param buf A pointer to the input binary data to encode.
+     * @param count The length of the input binary data in bytes.
+     * @param out The output buffer, with room for getBase64EncodedLength(count, url) characters (not null terminated).
+     * @param url A boolean indicating whether the output is URL-safe base64 (without padding).
+     *
+     * @return The number of characters written.
+     */
+    static size_t encodeToBase64Buffer(unsigned char const *buf, size_t count, char *out, bool url = false);
+    /**
+     * @brief Decodes a base64-encoded text into a caller buffer.
+     *
+     * Uses AVX2 or SSSE3 when the CPU supports it (with a scalar fallback), no memory is allocated. The padding is
+     * optional, and any character outside of the alphabet (including newlines) is an error.
+     *
+     * @param in A pointer to the base64-encoded text.
+     * @param count The length of the base64-encoded text.
+     * @param out The output buffer, with room for getBase64DecodedMaxLength(count) bytes.
+     * @param outLength The number of bytes written.
+     * @param url A boolean indicating whether the input is URL-safe base64 encoded (default: false).
+     *
+     * @return True if the text was decoded, false if it is not valid base64.
+     */
+    static bool decodeFromBase64Buffer(char const *in, size_t count, unsigned char *out, size_t &outLength, bool url = false);
+
+    /**
+     * @brief Selects the base64 codec implementation for the whole process (eg. to compare them in tests or benchmarks).
+     *
+     * @param implementation The implementation to be used.
+     *
+     * @return False if the implementation is not supported by this CPU/build (the current one is kept).
+     */
+    static bool setBase64Implementation(BASE64_IMPLEMENTATION implementation);
+
     /**
      * @brief Encodes a string for use in a URL.
      *
@@ -0,0 +1,400 @@
+#include "encoders.h"
+
+#include <atomic>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HELPERS_BASE64_X86
+#include <immintrin.h>
+#endif
+
+using namespace Mantids30::Helpers;
+
+namespace {
+
+const char b64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char b64UrlAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// Character value tables (0xFF: not in the alphabet)
+struct DecodingTables
+{
+    DecodingTables()
+    {
+        memset(standard, 0xFF, sizeof(standard));
+        memset(url, 0xFF, sizeof(url));
+        for (unsigned char i = 0; i < 64; i++)
+        {
+            standard[static_cast<unsigned char>(b64Alphabet[i])] = i;
+            url[static_cast<unsigned char>(b64UrlAlphabet[i])] = i;
+        }
+    }
+    unsigned char standard[256];
+    unsigned char url[256];
+};
+
+const DecodingTables decodingTables;
+
+std::atomic<Encoders::BASE64_IMPLEMENTATION> selectedImplementation{Encoders::BASE64_AUTO};
+
+size_t encodeScalar(const unsigned char *in, size_t count, char *out, bool url)
+{
+    const char *alphabet = url ? b64UrlAlphabet : b64Alphabet;
+    char *o = out;
+    size_t i = 0;
+
+    for (; i + 3 <= count; i += 3)
+    {
+        uint32_t v = (static_cast<uint32_t>(in[i]) << 16) | (static_cast<uint32_t>(in[i + 1]) << 8) | in[i + 2];
+        *o++ = alphabet[(v >> 18) & 0x3F];
+        *o++ = alphabet[(v >> 12) & 0x3F];
+        *o++ = alphabet[(v >> 6) & 0x3F];
+        *o++ = alphabet[v & 0x3F];
+    }
+
+    size_t rest = count - i;
+    if (rest)
+    {
+        uint32_t v = static_cast<uint32_t>(in[i]) << 16;
+        if (rest == 2)
+            v |= static_cast<uint32_t>(in[i + 1]) << 8;
+        *o++ = alphabet[(v >> 18) & 0x3F];
+        *o++ = alphabet[(v >> 12) & 0x3F];
+        if (rest == 2)
+            *o++ = alphabet[(v >> 6) & 0x3F];
+        if (!url)
+        {
+            if (rest == 1)
+                *o++ = '=';
+            *o++ = '=';
+        }
+    }
+    return o - out;
+}
+
+// Decodes complete and partial (2 or 3 chars) quantums, without padding.
+bool decodeScalar(const char *in, size_t count, unsigned char *out, size_t &outLength, bool url)
+{
+    const unsigned char *table = url ? decodingTables.url : decodingTables.standard;
+    unsigned char *o = out;
+    size_t i = 0;
+
+    if (count % 4 == 1)
+        return false;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        unsigned char a = table[static_cast<unsigned char>(in[i])], b = table[static_cast<unsigned char>(in[i + 1])],
+                      c = table[static_cast<unsigned char>(in[i + 2])], d = table[static_cast<unsigned char>(in[i + 3])];
+        if ((a | b | c | d) & 0x80)
+            return false;
+        uint32_t v = (static_cast<uint32_t>(a) << 18) | (static_cast<uint32_t>(b) << 12) | (static_cast<uint32_t>(c) << 6) | d;
+        *o++ = static_cast<unsigned char>(v >> 16);
+        *o++ = static_cast<unsigned char>(v >> 8);
+        *o++ = static_cast<unsigned char>(v);
+    }
+
+    size_t rest = count - i;
+    if (rest)
+    {
+        unsigned char a = table[static_cast<unsigned char>(in[i])], b = table[static_cast<unsigned char>(in[i + 1])];
+        unsigned char c = rest == 3 ? table[static_cast<unsigned char>(in[i + 2])] : 0;
+        if ((a | b | c) & 0x80)
+            return false;
+        uint32_t v = (static_cast<uint32_t>(a) << 18) | (static_cast<uint32_t>(b) << 12) | (static_cast<uint32_t>(c) << 6);
+        *o++ = static_cast<unsigned char>(v >> 16);
+        if (rest == 3)
+            *o++ = static_cast<unsigned char>(v >> 8);
+    }
+
+    outLength = o - out;
+    return true;
+}
+
+#ifdef HELPERS_BASE64_X86
+
+// SIMD codec (W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2 Instructions"), the same
+// operations are done over one 128-bit lane with SSSE3 and over two lanes with AVX2.
+
+__attribute__((target("ssse3"))) inline __m128i encodeLookup128(__m128i indices, bool url)
+{
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const __m128i shiftLUT = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, (url ? '-' : '+') - 62, (url ? '_' : '/') - 63, 'A', 0, 0);
+    result = _mm_shuffle_epi8(shiftLUT, result);
+    return _mm_add_epi8(result, indices);
+}
+
+__attribute__((target("ssse3"))) inline __m128i encodeUnpack128(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+__attribute__((target("ssse3"))) size_t encodeSSSE3(const unsigned char *in, size_t count, char *out, bool url)
+{
+    size_t i = 0;
+    char *o = out;
+    // Loads 16 bytes and uses 12:
+    for (; i + 16 <= count; i += 12, o += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), encodeLookup128(encodeUnpack128(v), url));
+    }
+    return (o - out) + encodeScalar(in + i, count - i, o, url);
+}
+
+__attribute__((target("avx2"))) size_t encodeAVX2(const unsigned char *in, size_t count, char *out, bool url)
+{
+    size_t i = 0;
+    char *o = out;
+
+    const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                            10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i shiftLUT = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, (url ? '-' : '+') - 62, (url ? '_' : '/') - 63, 'A', 0, 0,
+                                              'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, (url ? '-' : '+') - 62, (url ? '_' : '/') - 63, 'A', 0, 0);
+
+    // Loads 12 bytes per lane (16 bytes at i and i+12, uses 24):
+    for (; i + 28 <= count; i += 24, o += 32)
+    {
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i))),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 12)), 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        const __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_shuffle_epi8(shiftLUT, result);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), _mm256_add_epi8(result, indices));
+    }
+    return (o - out) + encodeSSSE3(in + i, count - i, o, url);
+}
+
+// 16 chars -> 16 sextets, returns false if any char is not in the alphabet.
+__attribute__((target("ssse3"))) inline bool decodeLookup128(__m128i in, __m128i &values, bool url)
+{
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('Z' + 1)));
+    const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('z' + 1)));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('9' + 1)));
+    const __m128i c62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(url ? '-' : '+'));
+    const __m128i c63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(url ? '_' : '/'));
+
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(c62, c63)));
+    if (_mm_movemask_epi8(valid) != 0xFFFF)
+        return false;
+
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_and_si128(c62, _mm_set1_epi8(62 - (url ? '-' : '+'))));
+    shift = _mm_or_si128(shift, _mm_and_si128(c63, _mm_set1_epi8(63 - (url ? '_' : '/'))));
+    values = _mm_add_epi8(in, shift);
+    return true;
+}
+
+// 16 sextets -> 12 bytes (at the beginning of the lane)
+__attribute__((target("ssse3"))) inline __m128i decodePack128(__m128i values)
+{
+    const __m128i mergedPairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i merged = _mm_madd_epi16(mergedPairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("ssse3"))) bool decodeSSSE3(const char *in, size_t count, unsigned char *out, size_t &outLength, bool url)
+{
+    size_t i = 0;
+    unsigned char *o = out;
+
+    // Stores 16 bytes and uses 12 (leave at least 6 chars to the scalar decoder, so the output is not overrun):
+    for (; i + 22 <= count; i += 16, o += 12)
+    {
+        __m128i values;
+        if (!decodeLookup128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), values, url))
+            return false;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), decodePack128(values));
+    }
+
+    size_t restLength = 0;
+    if (!decodeScalar(in + i, count - i, o, restLength, url))
+        return false;
+    outLength = (o - out) + restLength;
+    return true;
+}
+
+__attribute__((target("avx2"))) bool decodeAVX2(const char *in, size_t count, unsigned char *out, size_t &outLength, bool url)
+{
+    size_t i = 0;
+    unsigned char *o = out;
+
+    const __m256i upperFrom = _mm256_set1_epi8('A' - 1), upperTo = _mm256_set1_epi8('Z' + 1);
+    const __m256i lowerFrom = _mm256_set1_epi8('a' - 1), lowerTo = _mm256_set1_epi8('z' + 1);
+    const __m256i digitFrom = _mm256_set1_epi8('0' - 1), digitTo = _mm256_set1_epi8('9' + 1);
+    const __m256i char62 = _mm256_set1_epi8(url ? '-' : '+'), char63 = _mm256_set1_epi8(url ? '_' : '/');
+
+    // Writes 12 bytes per lane (the high lane is stored at +12 with 16 bytes, so leave at least 6 chars):
+    for (; i + 38 <= count; i += 32, o += 24)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, upperFrom), _mm256_cmpgt_epi8(upperTo, v));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(v, lowerFrom), _mm256_cmpgt_epi8(lowerTo, v));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, digitFrom), _mm256_cmpgt_epi8(digitTo, v));
+        const __m256i c62 = _mm256_cmpeq_epi8(v, char62);
+        const __m256i c63 = _mm256_cmpeq_epi8(v, char63);
+
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(c62, c63)));
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(valid)) != 0xFFFFFFFF)
+            return false;
+
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(c62, _mm256_set1_epi8(62 - (url ? '-' : '+'))));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(c63, _mm256_set1_epi8(63 - (url ? '_' : '/'))));
+        const __m256i values = _mm256_add_epi8(v, shift);
+
+        const __m256i mergedPairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i merged = _mm256_madd_epi16(mergedPairs, _mm256_set1_epi32(0x00011000));
+        const __m256i packed = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                                            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm256_castsi256_si128(packed));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o + 12), _mm256_extracti128_si256(packed, 1));
+    }
+
+    size_t restLength = 0;
+    if (!decodeSSSE3(in + i, count - i, o, restLength, url))
+        return false;
+    outLength = (o - out) + restLength;
+    return true;
+}
+
+enum eSIMDLevel
+{
+    SIMD_NONE,
+    SIMD_SSSE3,
+    SIMD_AVX2
+};
+
+eSIMDLevel getSupportedSIMDLevel()
+{
+    static const eSIMDLevel level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return SIMD_AVX2;
+        if (__builtin_cpu_supports("ssse3"))
+            return SIMD_SSSE3;
+        return SIMD_NONE;
+    }();
+    return level;
+}
+
+eSIMDLevel getSIMDLevel()
+{
+    switch (selectedImplementation.load(std::memory_order_relaxed))
+    {
+    case Encoders::BASE64_SCALAR:
+        return SIMD_NONE;
+    case Encoders::BASE64_SSSE3:
+        return SIMD_SSSE3;
+    case Encoders::BASE64_AVX2:
+        return SIMD_AVX2;
+    case Encoders::BASE64_AUTO:
+        break;
+    }
+    return getSupportedSIMDLevel();
+}
+
+#endif
+
+}
+
+bool Encoders::setBase64Implementation(BASE64_IMPLEMENTATION implementation)
+{
+    switch (implementation)
+    {
+    case BASE64_AUTO:
+    case BASE64_SCALAR:
+        break;
+#ifdef HELPERS_BASE64_X86
+    case BASE64_SSSE3:
+        if (getSupportedSIMDLevel() < SIMD_SSSE3)
+            return false;
+        break;
+    case BASE64_AVX2:
+        if (getSupportedSIMDLevel() < SIMD_AVX2)
+            return false;
+        break;
+#else
+    default:
+        return false;
+#endif
+    }
+    selectedImplementation = implementation;
+    return true;
+}
+
+size_t Encoders::getBase64EncodedLength(size_t count, bool url)
+{
+    if (url)
+        return (count / 3) * 4 + ((count % 3) ? (count % 3) + 1 : 0);
+    return ((count + 2) / 3) * 4;
+}
+
+size_t Encoders::getBase64DecodedMaxLength(size_t count)
+{
+    return (count / 4) * 3 + ((count % 4) ? (count % 4) - 1 : 0);
+}
+
+size_t Encoders::encodeToBase64Buffer(const unsigned char *buf, size_t count, char *out, bool url)
+{
+#ifdef HELPERS_BASE64_X86
+    switch (getSIMDLevel())
+    {
+    case SIMD_AVX2:
+        return encodeAVX2(buf, count, out, url);
+    case SIMD_SSSE3:
+        return encodeSSSE3(buf, count, out, url);
+    case SIMD_NONE:
+        break;
+    }
+#endif
+    return encodeScalar(buf, count, out, url);
+}
+
+bool Encoders::decodeFromBase64Buffer(const char *in, size_t count, unsigned char *out, size_t &outLength, bool url)
+{
+    outLength = 0;
+
+    // The padding is optional (up to 2 chars, completing the last quantum):
+    if (count % 4 == 0 && count >= 4)
+    {
+        if (in[count - 1] == '=')
+            count--;
+        if (in[count - 1] == '=')
+            count--;
+    }
+
+#ifdef HELPERS_BASE64_X86
+    switch (getSIMDLevel())
+    {
+    case SIMD_AVX2:
+        return decodeAVX2(in, count, out, outLength, url);
+    case SIMD_SSSE3:
+        return decodeSSSE3(in, count, out, outLength, url);
+    case SIMD_NONE:
+        break;
+    }
+#endif
+    return decodeScalar(in, count, out, outLength, url);
+}
@@ -1,102 +1,314 @@
 #include "random.h"
 
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
 #include <openssl/rand.h>
+#include <atomic>
 #include <stdexcept>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HELPERS_RANDOM_X86
+#include <immintrin.h>
+#endif
+#ifdef __linux__
+#include <errno.h>
+#include <sys/random.h>
+#endif
 
 using namespace std;
 using namespace Mantids30::Helpers;
 
+namespace {
 
-std::string Random::createRandomString(size_t length)
-{
-    // Define the character set containing all possible characters for the random string.
-    const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+// Keystream generated per batch (the first bytes become the next key/iv):
+constexpr size_t BATCH_SIZE = 4096;
+constexpr size_t KEY_SIZE = 32;
+constexpr size_t IV_SIZE = 16;
+// Reseed from the operating system after serving this amount of bytes:
+constexpr uint64_t RESEED_BYTES = 1024 * 1024;
 
-    // Calculate the maximum index of the character set.
-    const size_t maxIndex = (sizeof(charset) - 1);
+// Incremented in the child process after fork() (so the child does not repeat the parent values):
+std::atomic<uint64_t> g_forkGeneration{0};
 
-    // Initialize the result string with the required length, filled with null characters.
-    std::string randomString(length, '\0');
+void seedFromSystem(unsigned char *data, size_t length)
+{
+#ifdef __linux__
+    size_t offset = 0;
+    while (offset < length)
+    {
+        ssize_t r = getrandom(data + offset, length - offset, 0);
+        if (r < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        offset += static_cast<size_t>(r);
+    }
+    if (offset == length)
+        return;
+#endif
+    if (!RAND_bytes(data, static_cast<int>(length)))
+        throw std::runtime_error("RAND_bytes failed.");
+}
 
-    // Use a vector to store the randomly generated bytes.
-    std::vector<unsigned char> buffer(length);
+class ThreadGenerator
+{
+public:
+    ThreadGenerator()
+    {
+#ifndef _WIN32
+        static const int atForkRegistered = pthread_atfork(nullptr, nullptr, []() { g_forkGeneration++; });
+        (void) atForkRegistered;
+#endif
+        // The cipher is set once, the refills only change the key/iv:
+        m_ctx = EVP_CIPHER_CTX_new();
+        if (!m_ctx || EVP_EncryptInit_ex(m_ctx, EVP_chacha20(), nullptr, nullptr, nullptr) != 1)
+        {
+            EVP_CIPHER_CTX_free(m_ctx);
+            throw std::runtime_error("ChaCha20 initialization failed.");
+        }
+    }
+    ~ThreadGenerator()
+    {
+        OPENSSL_cleanse(m_batch, sizeof(m_batch));
+        OPENSSL_cleanse(m_keyIV, sizeof(m_keyIV));
+        EVP_CIPHER_CTX_free(m_ctx);
+    }
 
-    // Generate random bytes and store them in the buffer.
-    if (RAND_bytes(buffer.data(), length))
+    void fill(unsigned char *data, size_t length)
     {
-        // Convert each byte in the buffer to a character from the charset.
-        for (size_t i = 0; i < length; ++i)
+        // Forked: the buffered bytes are also in the parent process, discard them (and reseed).
+        if (g_forkGeneration.load(std::memory_order_relaxed) != m_generation)
         {
-            // Use the modulo operation to ensure the index is within bounds of the charset.
-            randomString[i] = charset[buffer[i] % maxIndex];
+            memset(m_batch, 0, sizeof(m_batch));
+            m_position = BATCH_SIZE;
+        }
+
+        while (length)
+        {
+            if (m_position == BATCH_SIZE)
+                refill();
+
+            size_t len = std::min(length, BATCH_SIZE - m_position);
+            memcpy(data, m_batch + m_position, len);
+            // Served bytes are erased from the generator:
+            memset(m_batch + m_position, 0, len);
+            m_position += len;
+            data += len;
+            length -= len;
         }
     }
-    else
+
+private:
+    void refill()
     {
-        // Throw an exception if RAND_bytes fails to generate random bytes.
-        throw std::runtime_error("RAND_bytes failed.");
+        uint64_t generation = g_forkGeneration.load(std::memory_order_relaxed);
+        if (!m_seeded || generation != m_generation || m_servedBytes >= RESEED_BYTES)
+        {
+            seedFromSystem(m_keyIV, sizeof(m_keyIV));
+            m_generation = generation;
+            m_servedBytes = 0;
+            m_seeded = true;
+        }
+
+        // ChaCha20 keystream (encrypting zeros, the served bytes and the previous key were erased):
+        int outlen = 0;
+        if (EVP_EncryptInit_ex(m_ctx, nullptr, nullptr, m_keyIV, m_keyIV + KEY_SIZE) != 1
+            || EVP_EncryptUpdate(m_ctx, m_batch, &outlen, m_batch, static_cast<int>(BATCH_SIZE)) != 1 || outlen != static_cast<int>(BATCH_SIZE))
+            throw std::runtime_error("ChaCha20 keystream generation failed.");
+
+        // Fast key erasure: the first bytes are the next key/iv and never served.
+        memcpy(m_keyIV, m_batch, sizeof(m_keyIV));
+        memset(m_batch, 0, sizeof(m_keyIV));
+        m_position = sizeof(m_keyIV);
+        m_servedBytes += BATCH_SIZE - sizeof(m_keyIV);
     }
 
-    // Return the generated random string.
-    return randomString;
+    EVP_CIPHER_CTX *m_ctx = nullptr;
+    unsigned char m_keyIV[KEY_SIZE + IV_SIZE];
+    unsigned char m_batch[BATCH_SIZE] = {};
+    size_t m_position = BATCH_SIZE;
+    uint64_t m_generation = 0;
+    uint64_t m_servedBytes = 0;
+    bool m_seeded = false;
+};
+
+ThreadGenerator &getThreadGenerator()
+{
+    static thread_local ThreadGenerator generator;
+    return generator;
 }
 
-std::string Random::createRandomHexString(size_t length)
+// a-z, A-Z, 0-9 without table lookups or branches (random indexes would mispredict, and this is vectorizable):
+inline char alphanumericChar(uint32_t index)
 {
-    // Each byte will be represented by 2 hexadecimal characters, so we double the length.
-    length = length * 2;
+    int32_t i = static_cast<int32_t>(index);
+    int32_t c = 'a' + i;
+    // (25 - i) >> 31 is all ones when i >= 26:
+    c -= ((25 - i) >> 31) & (('a' + 26) - 'A');
+    c -= ((51 - i) >> 31) & (('A' + 26) - '0');
+    return static_cast<char>(c);
+}
 
-    // Define the character set for hexadecimal digits.
-    const char charset[] = "ABCDEF0123456789";
+// 16 random bits per character, mapped by multiplication: index = (r * 62) >> 16. The mapping is unbiased when the
+// low parts under 65536 % 62 = 2 (1 in 32768) are rejected and drawn again. Returns true if something was rejected.
+constexpr uint32_t ALPHANUMERIC_SIZE = 62;
+constexpr uint32_t ALPHANUMERIC_THRESHOLD = 65536 % ALPHANUMERIC_SIZE;
 
-    // Calculate the maximum index of the character set.
-    const size_t maxIndex = (sizeof(charset) - 1);
+bool mapAlphanumericScalar(const uint16_t *random, size_t count, char *out)
+{
+    bool rejected = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t m = static_cast<uint32_t>(random[i]) * ALPHANUMERIC_SIZE;
+        out[i] = alphanumericChar(m >> 16);
+        rejected |= (m & 0xFFFF) < ALPHANUMERIC_THRESHOLD;
+    }
+    return rejected;
+}
 
-    // Initialize the result string with the required length, filled with null characters.
-    std::string randomString(length, '\0');
+#ifdef HELPERS_RANDOM_X86
 
-    // Use a vector to store the randomly generated bytes.
-    std::vector<unsigned char> buffer(length / 2);
+__attribute__((target("avx2"))) bool mapAlphanumericAVX2(const uint16_t *random, size_t count, char *out)
+{
+    const __m256i alphabetSize = _mm256_set1_epi16(ALPHANUMERIC_SIZE);
+    const __m256i maxRejected = _mm256_set1_epi16(ALPHANUMERIC_THRESHOLD - 1);
+    const __m256i lastLowercase = _mm256_set1_epi16(25);
+    const __m256i lastUppercase = _mm256_set1_epi16(51);
+    const __m256i first = _mm256_set1_epi16('a');
+    const __m256i toUppercase = _mm256_set1_epi16(('a' + 26) - 'A');
+    const __m256i toDigit = _mm256_set1_epi16(('A' + 26) - '0');
 
-    // Generate random bytes and store them in the buffer.
-    if (RAND_bytes(buffer.data(), buffer.size()))
+    __m256i rejected = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
     {
-        // Convert each byte in the buffer to two hexadecimal characters.
-        for (size_t i = 0; i < buffer.size(); ++i)
-        {
-            unsigned char byte = buffer[i];
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(random + i));
+        __m256i index = _mm256_mulhi_epu16(r, alphabetSize);
+        __m256i low = _mm256_mullo_epi16(r, alphabetSize);
+        rejected = _mm256_or_si256(rejected, _mm256_cmpeq_epi16(_mm256_min_epu16(low, maxRejected), low));
+
+        __m256i c = _mm256_add_epi16(index, first);
+        c = _mm256_sub_epi16(c, _mm256_and_si256(_mm256_cmpgt_epi16(index, lastLowercase), toUppercase));
+        c = _mm256_sub_epi16(c, _mm256_and_si256(_mm256_cmpgt_epi16(index, lastUppercase), toDigit));
 
-            // Get the first hexadecimal digit from the higher nibble of the byte.
-            randomString[i * 2]     = charset[(byte >> 4) % maxIndex];
+        // 16 words -> 16 bytes (the pack works per 128-bit lane):
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(c, c), 0xD8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm256_castsi256_si128(packed));
+    }
+
+    bool tailRejected = mapAlphanumericScalar(random + i, count - i, out + i);
+    return !_mm256_testz_si256(rejected, rejected) || tailRejected;
+}
+
+bool hasAVX2()
+{
+    static const bool avx2 = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return avx2;
+}
+
+#endif
+
+bool mapAlphanumeric(const uint16_t *random, size_t count, char *out)
+{
+#ifdef HELPERS_RANDOM_X86
+    if (hasAVX2())
+        return mapAlphanumericAVX2(random, count, out);
+#endif
+    return mapAlphanumericScalar(random, count, out);
+}
+
+// A-F, 0-9 (the digits order used by createRandomHexString):
+inline char hexChar(uint32_t nibble)
+{
+    int32_t i = static_cast<int32_t>(nibble);
+    int32_t c = 'A' + i;
+    c -= ((5 - i) >> 31) & (('A' + 6) - '0');
+    return static_cast<char>(c);
+}
+
+} // namespace
+
+void Random::fillRandomBytes(void *data, size_t length)
+{
+    getThreadGenerator().fill(static_cast<unsigned char *>(data), length);
+}
+
+std::string Random::createRandomString(size_t length)
+{
+    std::string randomString(length, '\0');
 
-            // Get the second hexadecimal digit from the lower nibble of the byte.
-            randomString[i * 2 + 1] = charset[byte % maxIndex];
+    uint16_t buffer[128];
+    size_t offset = 0;
+    while (offset < length)
+    {
+        size_t count = std::min(length - offset, sizeof(buffer) / sizeof(buffer[0]));
+        fillRandomBytes(buffer, count * sizeof(uint16_t));
+
+        char *out = &randomString[offset];
+        if (mapAlphanumeric(buffer, count, out))
+        {
+            // Rare: draw again the rejected characters.
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t m = static_cast<uint32_t>(buffer[i]) * ALPHANUMERIC_SIZE;
+                while ((m & 0xFFFF) < ALPHANUMERIC_THRESHOLD)
+                {
+                    uint16_t r;
+                    fillRandomBytes(&r, sizeof(r));
+                    m = static_cast<uint32_t>(r) * ALPHANUMERIC_SIZE;
+                }
+                out[i] = alphanumericChar(m >> 16);
+            }
         }
+
+        offset += count;
     }
-    else
+
+    OPENSSL_cleanse(buffer, sizeof(buffer));
+    return randomString;
+}
+
+std::string Random::createRandomHexString(size_t length)
+{
+    // Each byte will be represented by 2 hexadecimal characters ("ABCDEF0123456789" digits).
+    std::string randomString(length * 2, '\0');
+
+    unsigned char buffer[256];
+    size_t offset = 0;
+    while (offset < length)
     {
-        // Throw an exception if RAND_bytes fails to generate random bytes.
-        throw std::runtime_error("RAND_bytes failed.");
+        size_t count = std::min(length - offset, sizeof(buffer));
+        fillRandomBytes(buffer, count);
+        char *out = &randomString[offset * 2];
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i * 2] = hexChar(buffer[i] >> 4);
+            out[i * 2 + 1] = hexChar(buffer[i] & 0x0F);
+        }
+        offset += count;
     }
 
-    // Return the generated random hexadecimal string.
+    OPENSSL_cleanse(buffer, sizeof(buffer));
     return randomString;
 }
 
 void Random::createRandomSalt32(
     unsigned char *salt)
 {
-    if (!RAND_bytes(salt, sizeof(uint32_t)))
-    {
-        throw std::runtime_error("RAND_bytes failed.");
-    }
+    fillRandomBytes(salt, sizeof(uint32_t));
 }
 
 void Random::createRandomSalt128(
     unsigned char *salt)
 {
-    if (!RAND_bytes(salt, 16))
-    {
-        throw std::runtime_error("RAND_bytes failed.");
-    }
+    fillRandomBytes(salt, 16);
 }
@@ -5,13 +5,26 @@
 
 namespace Mantids30 { namespace Helpers {
 
+/**
+ * @brief Cryptographically secure random values for session IDs, salts and tokens.
+ *
+ * The values come from a per-thread buffered ChaCha20 generator (fast key erasure): it is seeded from the operating
+ * system (getrandom, or the OpenSSL generator), reseeded periodically and after fork(), and every block batch replaces
+ * the key, so the served bytes can't be recovered from the generator state.
+ */
 class Random
 {
 public:
+    /**
+     * @brief fillRandomBytes Fill a buffer with random bytes
+     * @param data output buffer
+     * @param length number of bytes
+     */
+    static void fillRandomBytes(void * data, size_t length);
     /**
      * @brief createRandomString Create a Random String (letters and numbers)
      * @param length output lenght
-     * @return random string with letters (mayus/minus) and numbers
+     * @return random string with letters (mayus/minus) and numbers (uniformly distributed)
      */
     static std::string createRandomString(std::string::size_type length);
     /**
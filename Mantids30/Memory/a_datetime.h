@@ -25,13 +25,14 @@ public:
     std::string toStringLcl();
     std::string toString() override;
     bool fromString(const std::string & value) override;
+
+    static std::string getISOTimeStr( const time_t & v );
+    static time_t fromISOTimeStr( const std::string & v );
 protected:
     std::shared_ptr<Var> protectedCopy() override;
 
 private:
     std::string getPlainLclTimeStr( time_t v );
-    std::string getISOTimeStr( const time_t & v );
-    time_t fromISOTimeStr( const std::string & v );
 
     time_t m_value = 0;
     Threads::Sync::Mutex_Shared m_mutex;
@@ -0,0 +1,303 @@
+#include "a_rowbuffer.h"
+#include "a_allvars.h"
+#include "a_unsync.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <in6addr.h>
+#else
+#include <netinet/in.h>
+#endif
+
+using namespace Mantids30::Memory::Abstract;
+
+RowBuffer::Column::Column(const Var::Type &type)
+{
+    m_type = type;
+    m_elementSize = RowBuffer::getElementSize(type);
+}
+
+void RowBuffer::Column::appendRaw(const void *data, const size_t &len)
+{
+    if (m_elementSize)
+    {
+        if (len != m_elementSize)
+            throw std::runtime_error("RowBuffer: cell size does not match the column type.");
+        size_t off = m_fixed.size();
+        m_fixed.resize(off + len);
+        memcpy(m_fixed.data() + off, data, len);
+    }
+    else
+    {
+        m_arena.insert(m_arena.end(), static_cast<const char *>(data), static_cast<const char *>(data) + len);
+        m_offsets.push_back(m_arena.size());
+    }
+    m_nulls.push_back(0);
+}
+
+void RowBuffer::Column::appendNull()
+{
+    if (m_elementSize)
+        m_fixed.resize(m_fixed.size() + m_elementSize, 0);
+    else
+        m_offsets.push_back(m_arena.size());
+    m_nulls.push_back(1);
+}
+
+template<typename U>
+static bool appendUnsync(RowBuffer::Column &column, const std::string &value)
+{
+    U parsed;
+    bool r = parsed.fromString(value);
+    column.append(parsed.getValue());
+    return r;
+}
+
+bool RowBuffer::Column::appendFromString(const std::string &value)
+{
+    switch (m_type)
+    {
+    case Var::TYPE_BOOL:
+        return appendUnsync<Unsync::BOOL>(*this, value);
+    case Var::TYPE_INT8:
+        return appendUnsync<Unsync::INT8>(*this, value);
+    case Var::TYPE_INT16:
+        return appendUnsync<Unsync::INT16>(*this, value);
+    case Var::TYPE_INT32:
+        return appendUnsync<Unsync::INT32>(*this, value);
+    case Var::TYPE_INT64:
+        return appendUnsync<Unsync::INT64>(*this, value);
+    case Var::TYPE_UINT8:
+        return appendUnsync<Unsync::UINT8>(*this, value);
+    case Var::TYPE_UINT16:
+        return appendUnsync<Unsync::UINT16>(*this, value);
+    case Var::TYPE_UINT32:
+        return appendUnsync<Unsync::UINT32>(*this, value);
+    case Var::TYPE_UINT64:
+        return appendUnsync<Unsync::UINT64>(*this, value);
+    case Var::TYPE_DOUBLE:
+        return appendUnsync<Unsync::DOUBLE>(*this, value);
+    case Var::TYPE_DATETIME:
+        return appendUnsync<Unsync::DATETIME>(*this, value);
+    case Var::TYPE_IPV4:
+    {
+        bool ok = false;
+        append(IPV4::_fromString(value, &ok));
+        return ok;
+    }
+    case Var::TYPE_IPV6:
+    {
+        bool ok = false;
+        append(IPV6::_fromString(value, &ok));
+        return ok;
+    }
+    case Var::TYPE_MACADDR:
+    {
+        unsigned char macaddr[ETH_ALEN];
+        bool ok = MACADDR::_fromString(value, macaddr);
+        appendRaw(macaddr, ETH_ALEN);
+        return ok;
+    }
+    default:
+        appendRaw(value.data(), value.size());
+        return true;
+    }
+}
+
+std::string_view RowBuffer::Column::getString(const size_t &row) const
+{
+    if (m_elementSize)
+        return std::string_view(reinterpret_cast<const char *>(m_fixed.data()) + (row * m_elementSize), m_elementSize);
+
+    size_t start = row == 0 ? 0 : m_offsets[row - 1];
+    return std::string_view(m_arena.data() + start, m_offsets[row] - start);
+}
+
+void RowBuffer::Column::reserve(const size_t &rows, const size_t &arenaBytes)
+{
+    m_nulls.reserve(rows);
+    if (m_elementSize)
+        m_fixed.reserve(rows * m_elementSize);
+    else
+    {
+        m_offsets.reserve(rows);
+        m_arena.reserve(arenaBytes);
+    }
+}
+
+void RowBuffer::Column::truncate(const size_t &rows)
+{
+    if (rows >= m_nulls.size())
+        return;
+
+    m_nulls.resize(rows);
+    if (m_elementSize)
+        m_fixed.resize(rows * m_elementSize);
+    else
+    {
+        m_offsets.resize(rows);
+        m_arena.resize(rows == 0 ? 0 : m_offsets[rows - 1]);
+    }
+}
+
+void RowBuffer::Column::clear()
+{
+    m_nulls.clear();
+    m_fixed.clear();
+    m_arena.clear();
+    m_offsets.clear();
+}
+
+RowBuffer::RowBuffer(const std::vector<Var::Type> &columnTypes)
+{
+    setColumnTypes(columnTypes);
+}
+
+void RowBuffer::setColumnTypes(const std::vector<Var::Type> &columnTypes)
+{
+    m_columns.clear();
+    m_rowCount = 0;
+    for (const auto &type : columnTypes)
+        m_columns.emplace_back(type);
+}
+
+void RowBuffer::rollbackRow()
+{
+    for (auto &column : m_columns)
+        column.truncate(m_rowCount);
+}
+
+void RowBuffer::reserve(const size_t &rows)
+{
+    for (auto &column : m_columns)
+        column.reserve(rows);
+}
+
+void RowBuffer::clear()
+{
+    for (auto &column : m_columns)
+        column.clear();
+    m_rowCount = 0;
+}
+
+bool RowBuffer::copyRowTo(const size_t &row, const std::vector<Var *> &vars) const
+{
+    if (row >= m_rowCount)
+        return false;
+
+    for (size_t col = 0; col < vars.size() && col < m_columns.size(); col++)
+    {
+        Var *var = vars[col];
+        const Column &column = m_columns[col];
+
+        if (!var)
+            continue;
+        if (var->getVarType() != column.getType())
+            return false;
+
+        switch (column.getType())
+        {
+        case Var::TYPE_BOOL:
+            ABSTRACT_PTR_AS(BOOL, var)->setValue(column.get<bool>(row));
+            break;
+        case Var::TYPE_INT8:
+            ABSTRACT_PTR_AS(INT8, var)->setValue(column.get<int8_t>(row));
+            break;
+        case Var::TYPE_INT16:
+            ABSTRACT_PTR_AS(INT16, var)->setValue(column.get<int16_t>(row));
+            break;
+        case Var::TYPE_INT32:
+            ABSTRACT_PTR_AS(INT32, var)->setValue(column.get<int32_t>(row));
+            break;
+        case Var::TYPE_INT64:
+            ABSTRACT_PTR_AS(INT64, var)->setValue(column.get<int64_t>(row));
+            break;
+        case Var::TYPE_UINT8:
+            ABSTRACT_PTR_AS(UINT8, var)->setValue(column.get<uint8_t>(row));
+            break;
+        case Var::TYPE_UINT16:
+            ABSTRACT_PTR_AS(UINT16, var)->setValue(column.get<uint16_t>(row));
+            break;
+        case Var::TYPE_UINT32:
+            ABSTRACT_PTR_AS(UINT32, var)->setValue(column.get<uint32_t>(row));
+            break;
+        case Var::TYPE_UINT64:
+            ABSTRACT_PTR_AS(UINT64, var)->setValue(column.get<uint64_t>(row));
+            break;
+        case Var::TYPE_DOUBLE:
+            ABSTRACT_PTR_AS(DOUBLE, var)->setValue(column.get<double>(row));
+            break;
+        case Var::TYPE_DATETIME:
+            ABSTRACT_PTR_AS(DATETIME, var)->setValue(column.get<time_t>(row));
+            break;
+        case Var::TYPE_IPV4:
+            ABSTRACT_PTR_AS(IPV4, var)->setValue(column.get<in_addr>(row), 32);
+            break;
+        case Var::TYPE_IPV6:
+            ABSTRACT_PTR_AS(IPV6, var)->setValue(column.get<in6_addr>(row));
+            break;
+        case Var::TYPE_MACADDR:
+            ABSTRACT_PTR_AS(MACADDR, var)->setValue(reinterpret_cast<const unsigned char *>(column.getString(row).data()));
+            break;
+        case Var::TYPE_BIN:
+        {
+            std::string_view value = column.getString(row);
+            BINARY::sBinContainer binContainer;
+            binContainer.ptr = const_cast<char *>(value.data());
+            binContainer.dataSize = value.size();
+            ABSTRACT_PTR_AS(BINARY, var)->setValue(&binContainer);
+            binContainer.ptr = nullptr; // don't destroy the data.
+        }
+        break;
+        case Var::TYPE_STRING:
+        case Var::TYPE_STRINGLIST:
+            var->fromString(std::string(column.getString(row)));
+            break;
+        case Var::TYPE_VARCHAR:
+        {
+            // This will copy the memory.
+            std::string value(column.getString(row));
+            ABSTRACT_PTR_AS(VARCHAR, var)->setValue(value.data());
+        }
+        break;
+        case Var::TYPE_PTR:
+        case Var::TYPE_NULL:
+            // PTR would point into the arena, copy it explicitly with getString instead.
+            break;
+        }
+    }
+    return true;
+}
+
+size_t RowBuffer::getElementSize(const Var::Type &type)
+{
+    switch (type)
+    {
+    case Var::TYPE_BOOL:
+        return sizeof(bool);
+    case Var::TYPE_INT8:
+    case Var::TYPE_UINT8:
+        return 1;
+    case Var::TYPE_INT16:
+    case Var::TYPE_UINT16:
+        return 2;
+    case Var::TYPE_INT32:
+    case Var::TYPE_UINT32:
+        return 4;
+    case Var::TYPE_INT64:
+    case Var::TYPE_UINT64:
+        return 8;
+    case Var::TYPE_DOUBLE:
+        return sizeof(double);
+    case Var::TYPE_DATETIME:
+        return sizeof(time_t);
+    case Var::TYPE_IPV4:
+        return sizeof(in_addr);
+    case Var::TYPE_IPV6:
+        return sizeof(in6_addr);
+    case Var::TYPE_MACADDR:
+        return ETH_ALEN;
+    default:
+        return 0;
+    }
+}
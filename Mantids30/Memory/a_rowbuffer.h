@@ -0,0 +1,153 @@
+#pragma once
+
+#include "a_var.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mantids30 { namespace Memory { namespace Abstract {
+
+/**
+ * @brief The RowBuffer class is a columnar, unsynchronized container for query results.
+ *
+ * Each column keeps its values contiguously: fixed size types (BOOL, INTx/UINTx, DOUBLE, DATETIME, IPV4, IPV6,
+ * MACADDR) in a packed array, and variable length types (STRING, VARCHAR, BIN, STRINGLIST, PTR) in a single
+ * byte arena plus offsets. Database drivers append cells through the inline typed methods (no virtual call and
+ * no lock per cell), and the buffer can be cleared and refilled keeping its capacity.
+ *
+ * Cell storage by type:
+ *  - BOOL: bool, INT8..UINT64: the matching <stdint.h> type, DOUBLE: double, DATETIME: time_t
+ *  - IPV4: in_addr, IPV6: in6_addr, MACADDR: 6 bytes
+ *  - STRING, VARCHAR, BIN, STRINGLIST (text form), PTR (copied text): arena bytes (getString)
+ */
+class RowBuffer
+{
+public:
+    class Column
+    {
+    public:
+        Column(const Var::Type & type);
+
+        Var::Type getType() const { return m_type; }
+        /**
+         * @brief isVariableLength true if the cells are stored in the arena (use getString).
+         */
+        bool isVariableLength() const { return m_elementSize == 0; }
+        size_t getElementSize() const { return m_elementSize; }
+        size_t size() const { return m_nulls.size(); }
+
+        /**
+         * @brief append Appends a fixed size cell (sizeof(T) must match the column element size).
+         */
+        template<typename T>
+        void append(const T & value)
+        {
+            if (sizeof(T) != m_elementSize)
+                throw std::runtime_error("RowBuffer: cell size does not match the column type.");
+            size_t off = m_fixed.size();
+            m_fixed.resize(off + sizeof(T));
+            memcpy(m_fixed.data() + off, &value, sizeof(T));
+            m_nulls.push_back(0);
+        }
+        /**
+         * @brief appendRaw Appends a cell from its raw memory (len must match the element size on fixed size columns).
+         */
+        void appendRaw(const void * data, const size_t & len);
+        /**
+         * @brief appendNull Appends a NULL cell (zeroed/empty value).
+         */
+        void appendNull();
+        /**
+         * @brief appendFromString Parses a text value into the column type (same rules as Var::fromString).
+         * @return true if the text was fully parsed (the cell is appended anyway).
+         */
+        bool appendFromString(const std::string & value);
+
+        /**
+         * @brief get Gets a fixed size cell value.
+         */
+        template<typename T>
+        T get(const size_t & row) const
+        {
+            T value;
+            memcpy(&value, m_fixed.data() + (row*sizeof(T)), sizeof(T));
+            return value;
+        }
+        /**
+         * @brief getString Gets a variable length cell (valid until the buffer is cleared or appended).
+         */
+        std::string_view getString(const size_t & row) const;
+        bool isNull(const size_t & row) const { return m_nulls[row]!=0; }
+
+        void reserve(const size_t & rows, const size_t & arenaBytes = 0);
+        /**
+         * @brief truncate Keeps only the first rows cells.
+         */
+        void truncate(const size_t & rows);
+        void clear();
+
+    private:
+        Var::Type m_type;
+        size_t m_elementSize;
+        std::vector<unsigned char> m_fixed;
+        std::vector<char> m_arena;
+        std::vector<size_t> m_offsets;
+        std::vector<uint8_t> m_nulls;
+    };
+
+    RowBuffer() = default;
+    /**
+     * @brief RowBuffer Creates the buffer with one column per type.
+     */
+    RowBuffer(const std::vector<Var::Type> & columnTypes);
+
+    /**
+     * @brief setColumnTypes Redefines the columns (removes any stored row).
+     */
+    void setColumnTypes(const std::vector<Var::Type> & columnTypes);
+
+    size_t getColumnCount() const { return m_columns.size(); }
+    size_t getRowCount() const { return m_rowCount; }
+
+    Column & getColumn(const size_t & column) { return m_columns[column]; }
+    const Column & getColumn(const size_t & column) const { return m_columns[column]; }
+
+    /**
+     * @brief commitRow Marks the current row as complete (every column should have received one cell).
+     */
+    void commitRow() { m_rowCount++; }
+
+    /**
+     * @brief rollbackRow Discards the cells appended to the current (uncommitted) row.
+     */
+    void rollbackRow();
+
+    void reserve(const size_t & rows);
+    /**
+     * @brief clear Removes every row keeping the columns and the allocated capacity.
+     */
+    void clear();
+
+    /**
+     * @brief copyRowTo Copies one row into (synchronized) abstract variables of the same types.
+     * @param row row index.
+     * @param vars destination variables (nullptr entries are skipped).
+     * @return false if the row does not exist or any variable does not match its column type.
+     */
+    bool copyRowTo(const size_t & row, const std::vector<Var *> & vars) const;
+
+    /**
+     * @brief getElementSize Gets the fixed cell size for a var type (0 for variable length types).
+     */
+    static size_t getElementSize(const Var::Type & type);
+
+private:
+    std::vector<Column> m_columns;
+    size_t m_rowCount = 0;
+};
+
+}}}
+
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "a_var.h"
+#include "a_datetime.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <type_traits>
+
+namespace Mantids30 { namespace Memory { namespace Abstract { namespace Unsync {
+
+/**
+ * @brief Scalar Unsynchronized, POD-backed counterpart of the scalar abstract variables (INT32, UINT64, DATETIME...).
+ *
+ * There is no mutex and no vtable (sizeof(Scalar<T,VT>) == sizeof(T)), so every access is a plain load/store.
+ * Use them only where a single thread owns the value, eg. query binding loops, parsers or RowBuffer consumers.
+ */
+template<typename T, Var::Type VT>
+class Scalar
+{
+public:
+    static constexpr Var::Type varType = VT;
+
+    Scalar() = default;
+    Scalar(const T & value) : m_value(value) {}
+    Scalar& operator=(const T & value)
+    {
+        m_value = value;
+        return *this;
+    }
+
+    const T & getValue() const { return m_value; }
+    bool setValue(const T & value) { m_value = value; return true; }
+
+    void * getDirectMemory() { return &m_value; }
+
+    std::string toString() const
+    {
+        if constexpr (VT == Var::TYPE_DATETIME)
+            return Abstract::DATETIME::getISOTimeStr(m_value);
+        else if constexpr (std::is_same<T,bool>::value)
+            return m_value?"true":"false";
+        else
+            return std::to_string(m_value);
+    }
+
+    bool fromString(const std::string & value)
+    {
+        if constexpr (VT == Var::TYPE_DATETIME)
+        {
+            m_value = value.empty()? 0 : Abstract::DATETIME::fromISOTimeStr(value);
+            return !value.empty();
+        }
+        else if constexpr (std::is_same<T,bool>::value)
+        {
+            m_value = (value == "true" || value == "TRUE" || value == "1" || value == "t" || value == "T");
+            return true;
+        }
+        else if constexpr (std::is_floating_point<T>::value)
+        {
+            char * end = nullptr;
+            m_value = static_cast<T>(strtod(value.c_str(),&end));
+            return value.empty() || *end == 0;
+        }
+        else
+        {
+            char * end = nullptr;
+            if constexpr (std::is_signed<T>::value)
+                m_value = static_cast<T>(strtoll(value.c_str(),&end,10));
+            else
+                m_value = static_cast<T>(strtoull(value.c_str(),&end,10));
+            return value.empty() || *end == 0;
+        }
+    }
+
+private:
+    T m_value = T();
+};
+
+typedef Scalar<bool,Var::TYPE_BOOL> BOOL;
+typedef Scalar<int8_t,Var::TYPE_INT8> INT8;
+typedef Scalar<int16_t,Var::TYPE_INT16> INT16;
+typedef Scalar<int32_t,Var::TYPE_INT32> INT32;
+typedef Scalar<int64_t,Var::TYPE_INT64> INT64;
+typedef Scalar<uint8_t,Var::TYPE_UINT8> UINT8;
+typedef Scalar<uint16_t,Var::TYPE_UINT16> UINT16;
+typedef Scalar<uint32_t,Var::TYPE_UINT32> UINT32;
+typedef Scalar<uint64_t,Var::TYPE_UINT64> UINT64;
+typedef Scalar<double,Var::TYPE_DOUBLE> DOUBLE;
+typedef Scalar<time_t,Var::TYPE_DATETIME> DATETIME;
+
+/**
+ * @brief STRING Unsynchronized counterpart of Abstract::STRING.
+ */
+class STRING
+{
+public:
+    static constexpr Var::Type varType = Var::TYPE_STRING;
+
+    STRING() = default;
+    STRING(const std::string & value) : m_value(value) {}
+    STRING& operator=(const std::string & value)
+    {
+        m_value = value;
+        return *this;
+    }
+
+    const std::string & getValue() const { return m_value; }
+    bool setValue(const std::string & value) { m_value = value; return true; }
+    bool setValue(const char * value, const size_t & len) { m_value.assign(value,len); return true; }
+
+    void * getDirectMemory() { return &m_value; }
+
+    std::string toString() const { return m_value; }
+    bool fromString(const std::string & value) { m_value = value; return true; }
+
+private:
+    std::string m_value;
+};
+
+}}}}
+
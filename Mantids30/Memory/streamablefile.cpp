@@ -2,6 +2,9 @@
 #include "Mantids30/Helpers/safeint.h"
 #include <fcntl.h>
 #include <optional>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
 
 using namespace Mantids30::Memory::Streams;
 
@@ -40,6 +43,58 @@ int StreamableFile::open(const char *path, int oflag, mode_t __mode)
     return fd;
 }
 
+int StreamableFile::openTemporary(const char *directory, mode_t __mode)
+{
+    closeAll();
+    int fd = -1;
+
+#ifdef O_TMPFILE
+    fd = ::open(directory, O_TMPFILE | O_RDWR, __mode);
+#endif
+
+#ifndef _WIN32
+    if (fd < 0)
+    {
+        std::string tmpl = std::string(directory) + "/.tmp_XXXXXX";
+        fd = mkstemp(&tmpl[0]);
+        if (fd >= 0)
+        {
+            fchmod(fd, __mode);
+            m_temporaryPath = tmpl;
+        }
+    }
+#endif
+
+    rd_fd = fd;
+    wr_fd = fd;
+    return fd;
+}
+
+bool StreamableFile::linkTo(const char *path)
+{
+    if (wr_fd < 0)
+        return false;
+
+    if (!m_temporaryPath.empty())
+    {
+        // Named temporary file, give it the final name:
+        if (link(m_temporaryPath.c_str(), path) != 0)
+            return false;
+        unlink(m_temporaryPath.c_str());
+        m_temporaryPath.clear();
+        return true;
+    }
+
+#ifdef __linux__
+    // Unnamed file: link it through /proc (AT_EMPTY_PATH would require CAP_DAC_READ_SEARCH).
+    char fdPath[64];
+    snprintf(fdPath, sizeof(fdPath), "/proc/self/fd/%d", wr_fd);
+    return linkat(AT_FDCWD, fdPath, AT_FDCWD, path, AT_SYMLINK_FOLLOW) == 0;
+#else
+    return false;
+#endif
+}
+
 bool StreamableFile::streamTo(Memory::Streams::StreamableObject * out)
 {
     // Restart the read from zero (for multiple streamTo)...
@@ -89,9 +144,15 @@ void StreamableFile::closeAll()
 {
     if (rd_fd!=STDIN_FILENO && rd_fd>0)
         close(rd_fd);
-    if (wr_fd!=STDOUT_FILENO  && wr_fd!=STDERR_FILENO  && wr_fd>0)
+    if (wr_fd!=STDOUT_FILENO  && wr_fd!=STDERR_FILENO  && wr_fd>0 && wr_fd!=rd_fd)
         close(wr_fd);
 
     rd_fd=-1;
     wr_fd=-1;
+
+    if (!m_temporaryPath.empty())
+    {
+        unlink(m_temporaryPath.c_str());
+        m_temporaryPath.clear();
+    }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "streamableobject.h"
+#include <string>
 #include <unistd.h>
 
 namespace Mantids30 { namespace Memory { namespace Streams {
@@ -22,6 +23,20 @@ public:
      * @return result from system open function
      */
     int open(const char *path, int oflag, mode_t __mode );
+    /**
+     * @brief openTemporary Open an unnamed file (O_TMPFILE) in a directory for read/write. If the filesystem does not
+     *                      support it, a uniquely named file is created instead (removed on close if not linked).
+     * @param directory directory where the file will be linked later (should be on the same filesystem).
+     * @param __mode File Mode, eg. 0600
+     * @return file descriptor, or -1 on error.
+     */
+    int openTemporary(const char *directory, mode_t __mode = 0600);
+    /**
+     * @brief linkTo Give a name to the file opened by openTemporary() (without copying the content).
+     * @param path destination path (should not exist).
+     * @return true if linked.
+     */
+    bool linkTo(const char *path);
     /**
      * @brief streamTo Stream all the content to another StreamableObject
      * @param out output
@@ -39,6 +54,8 @@ public:
 private:
     void closeAll();
     int rd_fd,wr_fd;
+    // Named temporary file (when O_TMPFILE is not available), removed on close if not linked:
+    std::string m_temporaryPath;
 };
 
 }}}
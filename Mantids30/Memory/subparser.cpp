@@ -69,6 +69,8 @@ std::optional<size_t> SubParser::writeIntoParser(const void *buf, size_t count)
         BIO_dump_fp(stdout, static_cast<char *>(buf), count);
 #endif
         return parseDirect(buf, count);
+    case PARSE_MODE_STREAM:
+        return parseStream(buf, count);
     default:
         break;
     }
@@ -80,6 +82,12 @@ size_t SubParser::ParseValidator(Mantids30::Memory::Containers::B_Base &)
     return std::numeric_limits<size_t>::max();
 }
 
+std::optional<size_t> SubParser::parseStream(const void *, size_t)
+{
+    // if not implemented...
+    return std::nullopt;
+}
+
 SubParser::ParseStatus SubParser::getParseStatus() const
 {
     return m_parseStatus;
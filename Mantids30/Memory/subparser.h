@@ -33,7 +33,8 @@ public:
         PARSE_MODE_CONNECTION_END,          // wait for connection end
         PARSE_MODE_DIRECT,                  // don't wait, just parse.
         PARSE_MODE_DIRECT_DELIMITER,   // parse direct until multi-delimiter (// TODO:)
-        PARSE_MODE_MULTIDELIMITER //,          // wait for any of those delimiters
+        PARSE_MODE_MULTIDELIMITER,          // wait for any of those delimiters
+        PARSE_MODE_STREAM                   // the incoming data is given to parseStream() without buffering
 //        PARSE_MODE_FREEPARSER               // TODO
     };
 
@@ -109,6 +110,14 @@ protected:
      * @return bytes matching the policy.
      */
     virtual size_t ParseValidator(Mantids30::Memory::Containers::B_Base &);
+    /**
+     * @brief parseStream On Parsing mode Stream, the incoming data is given here directly (without being copied into
+     *                    the unparsed buffer). The subparser should set the parse status (setParseStatus) when done.
+     * @param buf incoming data (only valid during the call).
+     * @param count incoming data size in bytes, 0 means stream ended.
+     * @return bytes taken from buf (the rest is given to the next subparser), or std::nullopt on error.
+     */
+    virtual std::optional<size_t> parseStream(const void * buf, size_t count);
     /**
      * @brief Set Parse Mode
      * @param value parse mode (delimiter, size, or validator)
@@ -3,9 +3,10 @@
 
 using namespace Mantids30::Network::Sockets;
 
-Socket_Chain::Socket_Chain(std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> _baseSocket, bool _deleteBaseSocketOnExit)
+Socket_Chain::Socket_Chain(std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> _baseSocket, bool _deleteBaseSocketOnExit, eChainMode chainMode)
 {
     m_endPointReached = false;
+    m_chainMode = chainMode;
     m_deleteBaseSocketOnExit = _deleteBaseSocketOnExit;
     m_baseSocket = _baseSocket;
 }
@@ -26,6 +27,11 @@ void Socket_Chain::waitUntilFinish()
     }
 }
 
+Socket_Chain::eChainMode Socket_Chain::getChainMode() const
+{
+    return m_chainMode;
+}
+
 void Socket_Chain::removeSocketsOnExit()
 {
     for (sChainVectorItem * sockItem : m_socketLayers)
@@ -99,6 +105,9 @@ std::pair<std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> , std::sha
 
 bool Socket_Chain::addToChain(ChainProtocols::Socket_Chain_ProtocolBase *chainElement, bool deleteAtExit)
 {
+    if (m_chainMode == CHAIN_MODE_PIPELINE)
+        return addToPipeline(chainElement, deleteAtExit);
+
     return addToChain( chainElement->makeSocketChainPair(),
                              deleteAtExit, // If it's not a  detached pointer, declare as false, if it's detached true (when Socket_Chain die, then, this chain element will die too)
                              true, // Second socket is generated by makeSocketChainPair, should be automatically deleted here.
@@ -166,11 +175,61 @@ bool Socket_Chain::addToChain(std::pair<std::shared_ptr<Mantids30::Network::Sock
 
     return r;
 }
+bool Socket_Chain::addToPipeline(ChainProtocols::Socket_Chain_ProtocolBase *chainElement, bool deleteAtExit)
+{
+    if (m_endPointReached)
+        return false;
+
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> lowerLayer = getTopSocket();
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> layerSocket = chainElement->getLayerStream();
+    if (!lowerLayer || !layerSocket)
+        return false;
+
+    if (chainElement->isEndPoint())
+        m_endPointReached = true;
+
+    sChainVectorItem * item = new sChainVectorItem;
+
+    // Register on chain (there are no threads to wait for)
+    item->deleteFirstSocketOnExit = deleteAtExit;
+    item->deleteSecondSocketOnExit = false;
+    item->sock[0] = layerSocket;
+    item->modeServer = chainElement->isServerMode();
+    item->protocol = chainElement;
+    item->detached = true;
+    item->finished = true;
+    m_socketLayers.push_back(item);
+
+    chainElement->setLowerLayer(lowerLayer);
+
+    ///////////////////////////////////
+    // Now we init this layer (over the lower layer)...
+    if (item->modeServer)
+        return layerSocket->postAcceptSubInitialization();
+    else
+        return layerSocket->postConnectSubInitialization();
+}
+
+std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> Socket_Chain::getTopSocket()
+{
+    return !m_socketLayers.size()? m_baseSocket : static_cast<sChainVectorItem *>(m_socketLayers[m_socketLayers.size()-1])->sock[0];
+}
+
+size_t Socket_Chain::getPipelineBottom()
+{
+    size_t i = m_socketLayers.size();
+    while (i > 0 && m_socketLayers[i-1]->protocol != nullptr)
+        i--;
+    return i;
+}
+
 bool Socket_Chain::isConnected()
 {
     if (m_socketLayers.size() == 0 && !m_baseSocket) 
         return false;
-    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream>  curSocket = !m_socketLayers.size()? m_baseSocket : static_cast<sChainVectorItem *>(m_socketLayers[m_socketLayers.size()-1])->sock[0];
+    // Pipelined layers does not have their own connection, check the socket below them:
+    size_t bottom = getPipelineBottom();
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream>  curSocket = !bottom? m_baseSocket : static_cast<sChainVectorItem *>(m_socketLayers[bottom-1])->sock[0];
     return curSocket->isConnected() && m_baseSocket->isConnected();
 }
 
@@ -178,7 +237,13 @@ int Socket_Chain::shutdownSocket(int mode)
 {
     if (m_socketLayers.size() == 0 && !m_baseSocket) 
         return -1;
-    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream>  curSocket = !m_socketLayers.size()? m_baseSocket : static_cast<sChainVectorItem *>(m_socketLayers[m_socketLayers.size()-1])->sock[0];
+
+    // Finish the pipelined layers protocols from the top to the bottom:
+    size_t bottom = getPipelineBottom();
+    for (size_t i = m_socketLayers.size(); i > bottom; i--)
+        m_socketLayers[i-1]->protocol->shutdownLayer(mode);
+
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream>  curSocket = !bottom? m_baseSocket : static_cast<sChainVectorItem *>(m_socketLayers[bottom-1])->sock[0];
     return curSocket->shutdownSocket(mode);
 }
 
@@ -186,7 +251,7 @@ ssize_t Socket_Chain::partialRead(void *data, const size_t & datalen)
 {
     if (m_socketLayers.size() == 0 && !m_baseSocket) 
         return -1;
-    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream>  curSocket = !m_socketLayers.size()? m_baseSocket : static_cast<sChainVectorItem *>(m_socketLayers[m_socketLayers.size()-1])->sock[0];
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream>  curSocket = getTopSocket();
     ssize_t x = curSocket->partialRead(data,datalen);
     if (x<=0)
         return x;
@@ -197,7 +262,7 @@ ssize_t Socket_Chain::partialWrite(const void *data, const size_t &datalen)
 {
     if (m_socketLayers.size() == 0 && !m_baseSocket) 
         return -1;
-    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream>  curSocket = !m_socketLayers.size()? m_baseSocket : static_cast<sChainVectorItem *>(m_socketLayers[m_socketLayers.size()-1])->sock[0];
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream>  curSocket = getTopSocket();
     ssize_t x = curSocket->partialWrite(data,datalen);
     if (x<=0)
         return x;
@@ -19,6 +19,11 @@
                    /
  write() -------->*
 
+
+  Pipeline mode (CHAIN_MODE_PIPELINE): each layer reads/writes directly on the lower layer (no sockets or threads):
+
+  read()/write() <----> layer N <----> ... <----> layer 1 <----> baseSocket (O/S Network)
+
 */
 
 namespace Mantids30 { namespace Network { namespace Sockets {
@@ -26,7 +31,19 @@ namespace Mantids30 { namespace Network { namespace Sockets {
 class Socket_Chain : public Socket_Stream
 {
 public:
-    Socket_Chain(std::shared_ptr<Socket_Stream>  _baseSocket, bool _deleteBaseSocketOnExit = true);
+    enum eChainMode {
+        /**
+         * @brief CHAIN_MODE_SOCKETPAIR every layer is connected through a socket pair and two bridging threads.
+         */
+        CHAIN_MODE_SOCKETPAIR,
+        /**
+         * @brief CHAIN_MODE_PIPELINE every layer transforms the data in the caller thread, reading/writing directly
+         *                            from/to the lower layer (TLS layers use memory BIOs).
+         */
+        CHAIN_MODE_PIPELINE
+    };
+
+    Socket_Chain(std::shared_ptr<Socket_Stream>  _baseSocket, bool _deleteBaseSocketOnExit = true, eChainMode chainMode = CHAIN_MODE_SOCKETPAIR);
     virtual ~Socket_Chain();
 
     /**
@@ -43,6 +60,8 @@ public:
                     bool endPMode = false);
     void waitUntilFinish();
 
+    eChainMode getChainMode() const;
+
     ////////////////////
     // errors:
     /**
@@ -65,7 +84,7 @@ public:
      */
     bool getLayerWriteResultValue(size_t layer, bool fwd);
     /**
-     * @brief getSocketPairLayer Get Sockets Pair from layer (don't use with )
+     * @brief getSocketPairLayer Get Sockets Pair from layer (in pipeline mode, the second socket is nullptr)
      * @param layer layer number [0..n-1]
      * @return pair of Socket_Stream ptr
      */
@@ -89,6 +108,7 @@ private:
             w1[1]=true;
             detached = false;
             finished = false;
+            protocol = nullptr;
         }
 
         /**
@@ -104,6 +124,11 @@ private:
         std::atomic<bool> detached, finished;
         bool deleteFirstSocketOnExit, deleteSecondSocketOnExit;
         bool modeServer;
+
+        /**
+         * @brief protocol pipelined layer protocol (nullptr for socket pair layers)
+         */
+        ChainProtocols::Socket_Chain_ProtocolBase * protocol;
     };
 
 
@@ -116,9 +141,21 @@ private:
 
     static void chainThread(sChainTElement * chain);
 
+    bool addToPipeline(ChainProtocols::Socket_Chain_ProtocolBase * chainElement, bool deleteAtExit);
+    /**
+     * @brief getTopSocket Get the socket where the application data is read/written.
+     */
+    std::shared_ptr<Socket_Stream> getTopSocket();
+    /**
+     * @brief getPipelineBottom Get the first layer of the top pipelined layers (m_socketLayers.size() if the top
+     *                          layer is not pipelined).
+     */
+    size_t getPipelineBottom();
+
     bool m_endPointReached;
     void removeSocketsOnExit();
 
+    eChainMode m_chainMode;
     bool m_deleteBaseSocketOnExit;
     std::shared_ptr<Socket_Stream> m_baseSocket;
     std::vector<sChainVectorItem *> m_socketLayers;
@@ -3,6 +3,11 @@
 #include <openssl/err.h>
 #include <openssl/sha.h>
 #include <random>
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #ifdef _WIN32
 //#pragma comment(lib, "crypt32.lib")
@@ -23,6 +28,25 @@ Socket_Chain_AES::Socket_Chain_AES()
     setAESRegenBlockSize();
 }
 
+Socket_Chain_AES::~Socket_Chain_AES()
+{
+    if (m_scratch)
+    {
+        OPENSSL_cleanse(m_scratch, m_scratchSize);
+        delete [] m_scratch;
+    }
+}
+
+void Socket_Chain_AES::setKeystreamMode(eKeystreamMode mode)
+{
+    m_keystreamMode = mode;
+}
+
+void Socket_Chain_AES::setCTRBatchSize(const size_t &value)
+{
+    m_ctrBatchSize = value;
+}
+
 
 void Socket_Chain_AES::setAESRegenBlockSize(const size_t &value)
 {
@@ -45,12 +69,20 @@ void Socket_Chain_AES::setPhase1Key(const char *pass)
 ssize_t Socket_Chain_AES::partialRead(void *data, const size_t &datalen)
 {
     if (!m_initialized)
-        return Socket_Stream::partialRead(data,datalen);
+        return lowerPartialRead(data,datalen);
 
-    ssize_t r = Socket_Stream::partialRead(data,datalen);
+    ssize_t r = lowerPartialRead(data,datalen);
     if (r<=0)
         return r;
 
+    if (m_remoteKeystreamMode == KEYSTREAM_CTR)
+    {
+        // Decrypt the data in place...
+        if (!m_readCTR.apply((char *)data,r))
+            return -1;
+        return r;
+    }
+
     // Enlarge the buffer to decrypt the requested string...
     while (m_readParams.aesBlock_curSize<(size_t)r)
     {
@@ -66,40 +98,64 @@ ssize_t Socket_Chain_AES::partialRead(void *data, const size_t &datalen)
 ssize_t Socket_Chain_AES::partialWrite(const void *data, const size_t &datalen)
 {
     if (!m_initialized)
-        return Socket_Stream::partialWrite(data,datalen);
+        return lowerPartialWrite(data,datalen);
 
-    // Copy the data...
-    char * edata = new char [datalen];
-    memcpy(edata,data,datalen);
+    // Encrypt up to the scratch buffer size (the caller will send the rest)
+    size_t count = std::min(datalen, m_scratchSize);
+    ssize_t r;
 
-    // Enlarge the buffer to decrypt the requested string...
-    while (m_writeParams.aesBlock_curSize<datalen)
+    if (m_keystreamMode == KEYSTREAM_CTR)
     {
-        regenIV(&m_writeParams);
-        if (!appendNewAESBlock( &m_writeParams, m_writeParams.handshake.phase2Key, m_writeParams.currentIV))
+        if (!m_writeCTR.reserve(count))
+            return -1;
+        m_writeCTR.xorTo(m_scratch, (const char *)data, count);
+
+        // Try to transmit the encrypted data...
+        r = lowerPartialWrite(m_scratch,count);
+        if (r>0)
         {
-            delete [] edata;
-            return false;
+            // Data transmited.. consume the keystream.
+            m_writeCTR.consume(r);
         }
     }
+    else
+    {
+        // Enlarge the buffer to encrypt the requested string...
+        while (m_writeParams.aesBlock_curSize<count)
+        {
+            regenIV(&m_writeParams);
+            if (!appendNewAESBlock( &m_writeParams, m_writeParams.handshake.phase2Key, m_writeParams.currentIV))
+                return -1;
+        }
 
-    // Encrypt the data...
-    m_writeParams.cryptoXOR(edata,datalen,true);
+        // Encrypt the data...
+        memcpy(m_scratch,data,count);
+        m_writeParams.cryptoXOR(m_scratch,count,true);
 
-    // Try to transmit the encrypted data...
-    ssize_t r=Socket_Stream::partialWrite(edata,datalen);
-    if (r>0)
-    {
-        // Data transmited.. reduce it.
-        m_writeParams.reduce(r);
+        // Try to transmit the encrypted data...
+        r=lowerPartialWrite(m_scratch,count);
+        if (r>0)
+        {
+            // Data transmited.. reduce it.
+            m_writeParams.reduce(r);
+        }
     }
 
     // destroy this data..
-    memset(edata,0,datalen);
-    delete [] edata;
+    OPENSSL_cleanse(m_scratch,count);
     return r;
 }
 
+ssize_t Socket_Chain_AES::lowerPartialRead(void *data, const size_t &datalen)
+{
+    return getLowerLayer() ? getLowerLayer()->partialRead(data,datalen) : Socket_Stream::partialRead(data,datalen);
+}
+
+ssize_t Socket_Chain_AES::lowerPartialWrite(const void *data, const size_t &datalen)
+{
+    return getLowerLayer() ? getLowerLayer()->partialWrite(data,datalen) : Socket_Stream::partialWrite(data,datalen);
+}
+
 bool Socket_Chain_AES::postAcceptSubInitialization()
 {
     char *p1,*p2;
@@ -118,6 +174,7 @@ bool Socket_Chain_AES::postAcceptSubInitialization()
     // Create the next local (write) keys...
     genRandomBytes(m_writeParams.handshake.phase2Key,sizeof(m_writeParams.handshake.phase2Key));
     genRandomBytes(m_writeParams.handshake.IVSeed,sizeof(m_writeParams.handshake.IVSeed));
+    m_writeParams.handshake.reserved[0] = static_cast<char>(m_keystreamMode);
     // Create the memory to transmit this...
     char vFirstLoad[sizeof(sHandShakeHeader)];
     memcpy(vFirstLoad,&(m_writeParams.handshake),sizeof(sHandShakeHeader));
@@ -167,6 +224,27 @@ bool Socket_Chain_AES::postAcceptSubInitialization()
     // clean the mem...
     ZeroBStruct(vFirstLoad);
 
+    // Keystream of each direction (the mode is choosen by the sender):
+    switch (m_readParams.handshake.reserved[0])
+    {
+    case KEYSTREAM_LEGACY:
+        m_remoteKeystreamMode = KEYSTREAM_LEGACY;
+        break;
+    case KEYSTREAM_CTR:
+        m_remoteKeystreamMode = KEYSTREAM_CTR;
+        if (!m_readCTR.init(m_readParams.handshake.phase2Key, m_readParams.handshake.IVSeed, 0))
+            return false;
+        break;
+    default:
+        // Unknown keystream.
+        return false;
+    }
+    if (m_keystreamMode == KEYSTREAM_CTR && !m_writeCTR.init(m_writeParams.handshake.phase2Key, m_writeParams.handshake.IVSeed, m_ctrBatchSize))
+        return false;
+
+    m_scratchSize = m_keystreamMode == KEYSTREAM_CTR ? m_ctrBatchSize : std::max<size_t>(m_aesRegenBlockSize, 16*1024);
+    m_scratch = new char[m_scratchSize];
+
     m_initialized = true;
     return true;
 }
@@ -343,3 +421,98 @@ char *Socket_Chain_AES::genPlainText()
     }
     return vGen;
 }
+
+Socket_Chain_AES::sCTRKeystream::~sCTRKeystream()
+{
+    if (ctx)
+        EVP_CIPHER_CTX_free(ctx);
+    if (ring)
+    {
+        OPENSSL_cleanse(ring, ringSize);
+        delete [] ring;
+    }
+}
+
+bool Socket_Chain_AES::sCTRKeystream::init(const char *key, const char *iv, const size_t &_ringSize)
+{
+    if (!(ctx = EVP_CIPHER_CTX_new()))
+        return false;
+
+    if (1 != EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, (const unsigned char *)key, (const unsigned char *)iv))
+        return false;
+
+    if (_ringSize)
+    {
+        ringSize = _ringSize;
+        ring = new unsigned char[ringSize];
+    }
+    return true;
+}
+
+bool Socket_Chain_AES::sCTRKeystream::reserve(const size_t &count)
+{
+    if (count > ringSize)
+        return false;
+
+    // Refill all the free space at once (large batches keep the AES pipeline full)
+    while (available < count)
+    {
+        size_t tail = (head + available) % ringSize;
+        size_t len = std::min(ringSize - available, ringSize - tail);
+
+        // Keystream = E(counter) = E(counter) ^ 0
+        int outLen;
+        memset(ring + tail, 0, len);
+        if (1 != EVP_EncryptUpdate(ctx, ring + tail, &outLen, ring + tail, static_cast<int>(len)) || (size_t)outLen != len)
+            return false;
+        available += len;
+    }
+    return true;
+}
+
+void Socket_Chain_AES::sCTRKeystream::xorTo(char *dst, const char *src, const size_t &count) const
+{
+    // The available keystream can wrap around the ring end:
+    size_t first = std::min(count, ringSize - head);
+    xorBlock(dst, src, ring + head, first);
+    if (first < count)
+        xorBlock(dst + first, src + first, ring, count - first);
+}
+
+void Socket_Chain_AES::sCTRKeystream::consume(const size_t &count)
+{
+    head = (head + count) % ringSize;
+    available -= count;
+}
+
+bool Socket_Chain_AES::sCTRKeystream::apply(char *data, const size_t &count)
+{
+    int outLen;
+    return 1 == EVP_EncryptUpdate(ctx, (unsigned char *)data, &outLen, (const unsigned char *)data, static_cast<int>(count)) && (size_t)outLen == count;
+}
+
+void Socket_Chain_AES::xorBlock(char *dst, const char *src, const unsigned char *key, size_t count)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 64 <= count; i += 64)
+    {
+        for (size_t j = 0; j < 64; j += 16)
+        {
+            __m128i d = _mm_loadu_si128((const __m128i *)(src + i + j));
+            __m128i k = _mm_loadu_si128((const __m128i *)(key + i + j));
+            _mm_storeu_si128((__m128i *)(dst + i + j), _mm_xor_si128(d, k));
+        }
+    }
+#endif
+    for (; i + 8 <= count; i += 8)
+    {
+        uint64_t d, k;
+        memcpy(&d, src + i, 8);
+        memcpy(&k, key + i, 8);
+        d ^= k;
+        memcpy(dst + i, &d, 8);
+    }
+    for (; i < count; i++)
+        dst[i] = src[i] ^ key[i];
+}
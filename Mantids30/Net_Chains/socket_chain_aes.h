@@ -18,8 +18,32 @@ namespace Mantids30 { namespace Network { namespace Sockets { namespace ChainPro
 class Socket_Chain_AES  : public Mantids30::Network::Sockets::Socket_Stream, public Socket_Chain_ProtocolBase
 {
 public:
+    enum eKeystreamMode {
+        /**
+         * @brief KEYSTREAM_LEGACY AES-256-GCM blocks of setAESRegenBlockSize() bytes with PRNG IVs (any peer)
+         */
+        KEYSTREAM_LEGACY = 0,
+        /**
+         * @brief KEYSTREAM_CTR AES-256-CTR keystream generated in batches (the peer should support it)
+         */
+        KEYSTREAM_CTR = 1
+    };
+
     Socket_Chain_AES();
-    ~Socket_Chain_AES() = default;
+    ~Socket_Chain_AES();
+
+    /**
+     * @brief setKeystreamMode Set the keystream used to encrypt the data we send (announced in the handshake, the
+     *                         peer decrypts with the same mode). Should only be used before the communication starts.
+     * @param mode keystream mode (default: KEYSTREAM_LEGACY)
+     */
+    void setKeystreamMode(eKeystreamMode mode);
+    /**
+     * @brief setCTRBatchSize Set the keystream generated per batch in CTR mode (also the max size per write).
+     *                        Should only be used before the communication starts.
+     * @param value batch size in bytes (default 256KB).
+     */
+    void setCTRBatchSize(const size_t &value = 256*1024);
 
     /**
      * @brief setCipherBlockSize Set the value of block generated by the cipher algorithm
@@ -71,6 +95,7 @@ private:
         char magicBytes[4];
         char IVSeed[16];
         char phase2Key[32];
+        // reserved[0]: keystream mode of the sender (eKeystreamMode, zero on older implementations)
         char reserved[60];
     } __attribute__((packed));
 
@@ -138,6 +163,41 @@ private:
         size_t aesBlock_curSize = 0;
     };
 
+    /**
+     * @brief lowerPartialRead/lowerPartialWrite raw I/O (lower layer in pipeline mode, or the socket)
+     */
+    ssize_t lowerPartialRead(void * data, const size_t & datalen);
+    ssize_t lowerPartialWrite(const void * data, const size_t & datalen);
+
+    /**
+     * @brief The sCTRKeystream struct AES-256-CTR keystream for one direction. Write keystream is pre-generated in
+     *        batches into a ring buffer (only the bytes accepted by the lower layer are consumed).
+     */
+    struct sCTRKeystream {
+        sCTRKeystream() = default;
+        ~sCTRKeystream();
+        bool init(const char * key, const char * iv, const size_t & ringSize);
+        /**
+         * @brief reserve Generate keystream up to have count bytes available (count <= ring size).
+         */
+        bool reserve(const size_t & count);
+        /**
+         * @brief xorTo dst = src ^ keystream (from the available keystream, without consuming it).
+         */
+        void xorTo(char * dst, const char * src, const size_t & count) const;
+        void consume(const size_t & count);
+        /**
+         * @brief apply Encrypt/Decrypt in place without the ring (the keystream position advances count bytes).
+         */
+        bool apply(char * data, const size_t & count);
+
+        EVP_CIPHER_CTX * ctx = nullptr;
+        unsigned char * ring = nullptr;
+        size_t ringSize = 0, head = 0, available = 0;
+    };
+
+    static void xorBlock(char * dst, const char * src, const unsigned char * key, size_t count);
+
     void genRandomBytes(char * bytes, size_t size);
     void genRandomWeakBytes(char * bytes, size_t size);
     bool appendNewAESBlock(sSideParams * params, const char * key, const char * iv);
@@ -162,6 +222,17 @@ private:
 
     size_t m_aesRegenBlockSize;
     bool m_initialized = false;
+
+    eKeystreamMode m_keystreamMode = KEYSTREAM_LEGACY;
+    eKeystreamMode m_remoteKeystreamMode = KEYSTREAM_LEGACY;
+    size_t m_ctrBatchSize = 256*1024;
+    sCTRKeystream m_readCTR, m_writeCTR;
+
+    /**
+     * @brief m_scratch per connection buffer where the outgoing data is encrypted.
+     */
+    char * m_scratch = nullptr;
+    size_t m_scratchSize = 0;
     const static EVP_CIPHER *m_cipher;
 };
 
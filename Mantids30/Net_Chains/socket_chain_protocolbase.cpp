@@ -41,3 +41,19 @@ void Socket_Chain_ProtocolBase::setServerMode(bool value)
     m_serverMode = value;
 }
 
+std::shared_ptr<Sockets::Socket_Stream> Socket_Chain_ProtocolBase::getLayerStream()
+{
+    Sockets::Socket_Stream * realSock = (Sockets::Socket_Stream *)getThis();
+    return std::dynamic_pointer_cast<Sockets::Socket_Stream>(realSock->shared_from_this());
+}
+
+void Socket_Chain_ProtocolBase::setLowerLayer(std::shared_ptr<Sockets::Socket_Stream> lowerLayer)
+{
+    m_lowerLayer = lowerLayer;
+}
+
+int Socket_Chain_ProtocolBase::shutdownLayer(int)
+{
+    // Stateless transformation, nothing to finish.
+    return 0;
+}
@@ -18,11 +18,36 @@ public:
     bool isServerMode() const;
     void setServerMode(bool value);
 
+    /////////////////////////
+    // Pipeline mode:
+    /**
+     * @brief getLayerStream Get this chain element as a stream (the element should be owned by a shared_ptr).
+     */
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> getLayerStream();
+    /**
+     * @brief setLowerLayer Pipeline mode: read/write the transformed data directly from/to the lower layer stream
+     *                      (the previous element of the chain or the base socket), instead of a socket pair.
+     * @param lowerLayer lower layer stream.
+     */
+    virtual void setLowerLayer(std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> lowerLayer);
+    /**
+     * @brief getLowerLayer Get the lower layer stream (nullptr if not running in pipeline mode).
+     */
+    Mantids30::Network::Sockets::Socket_Stream * getLowerLayer() const { return m_lowerLayer.get(); }
+    /**
+     * @brief shutdownLayer Pipeline mode: finish the protocol of this layer (eg. TLS close notify) before the lower
+     *                      layers are shutted down.
+     * @param mode shutdown mode (SHUT_RD, SHUT_WR, SHUT_RDWR)
+     * @return 0 if succeed.
+     */
+    virtual int shutdownLayer(int mode);
+
 protected:
     virtual void * getThis() = 0;
 
 private:
     bool m_serverMode = false;
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> m_lowerLayer;
 };
 
 }}}}
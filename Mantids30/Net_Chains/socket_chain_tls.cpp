@@ -2,3 +2,13 @@
 
 using namespace Mantids30::Network::Sockets::ChainProtocols;
 
+void Socket_Chain_TLS::setLowerLayer(std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> lowerLayer)
+{
+    Socket_Chain_ProtocolBase::setLowerLayer(lowerLayer);
+    setTransport(lowerLayer);
+}
+
+int Socket_Chain_TLS::shutdownLayer(int mode)
+{
+    return iShutdown(mode);
+}
@@ -10,10 +10,18 @@ class Socket_Chain_TLS : public Sockets::Socket_TLS, public Socket_Chain_Protoco
 public:
     Socket_Chain_TLS() = default;
 
+    /**
+     * @brief setLowerLayer Pipeline mode: the TLS records are carried by the lower layer (memory BIOs).
+     */
+    void setLowerLayer(std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> lowerLayer) override;
+    /**
+     * @brief shutdownLayer Pipeline mode: send the TLS close notify.
+     */
+    int shutdownLayer(int mode) override;
+
 protected:
     void * getThis() override { return this; }
 
 };
 
 }}}}
-
@@ -15,7 +15,7 @@ ssize_t Socket_Chain_XOR::partialRead(void *data, const size_t &datalen)
     if (!datalen) 
         return 0;
 
-    ssize_t r = Mantids30::Network::Sockets::Socket::partialRead(data,datalen);
+    ssize_t r = getLowerLayer() ? getLowerLayer()->partialRead(data,datalen) : Mantids30::Network::Sockets::Socket::partialRead(data,datalen);
     if (r<=0) 
         return r;
 
@@ -37,7 +37,7 @@ ssize_t Socket_Chain_XOR::partialWrite(const void *data, const size_t &datalen)
     if (!datacp) 
         return 0;
 
-    ssize_t r = Mantids30::Network::Sockets::Socket::partialWrite(datacp,datalen);
+    ssize_t r = getLowerLayer() ? getLowerLayer()->partialWrite(datacp,datalen) : Mantids30::Network::Sockets::Socket::partialWrite(datacp,datalen);
     delete [] datacp;
     return r;
 }
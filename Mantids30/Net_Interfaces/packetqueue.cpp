@@ -0,0 +1,325 @@
+#include "packetqueue.h"
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Mantids30::Network::Interfaces;
+
+static_assert(sizeof(VNetHeader) == 10, "VNetHeader should match struct virtio_net_hdr");
+
+PacketBatch::PacketBatch(const size_t &count, const size_t &bufferSize)
+{
+    m_bufferSize = bufferSize;
+    m_slab = new unsigned char[count * bufferSize];
+    m_ownSlab = true;
+    init(count);
+}
+
+PacketBatch::PacketBatch(void *slab, const size_t &count, const size_t &bufferSize)
+{
+    m_bufferSize = bufferSize;
+    m_slab = static_cast<unsigned char *>(slab);
+    m_ownSlab = false;
+    init(count);
+}
+
+PacketBatch::~PacketBatch()
+{
+    if (m_ownSlab)
+        delete [] m_slab;
+}
+
+void PacketBatch::setSize(const size_t &count)
+{
+    m_count = count > m_packets.size() ? m_packets.size() : count;
+}
+
+void PacketBatch::init(const size_t &count)
+{
+    m_packets.resize(count);
+    m_headers.resize(count);
+    m_iovecs.resize(count * 2);
+    for (size_t i = 0; i < count; i++)
+    {
+        m_packets[i].data = m_slab + i * m_bufferSize;
+        m_packets[i].length = 0;
+        memset(&m_packets[i].vnetHeader, 0, sizeof(VNetHeader));
+
+        m_iovecs[i * 2].iov_base = &m_packets[i].vnetHeader;
+        m_iovecs[i * 2].iov_len = sizeof(VNetHeader);
+        m_iovecs[i * 2 + 1].iov_base = m_packets[i].data;
+        m_iovecs[i * 2 + 1].iov_len = m_bufferSize;
+        memset(&m_headers[i], 0, sizeof(struct mmsghdr));
+    }
+}
+
+PacketQueue::PacketQueue(int fd, bool ownFd, bool vnetHeader)
+{
+    m_fd = fd;
+    m_ownFd = ownFd;
+    m_vnetHeader = vnetHeader;
+
+    struct stat st;
+    m_isSocket = fstat(fd, &st) == 0 && S_ISSOCK(st.st_mode);
+
+    // The flags belong to the open file description (shared with the owner of the descriptor), they are only read:
+    int flags = fcntl(fd, F_GETFL, 0);
+    m_nonBlocking = flags >= 0 && (flags & O_NONBLOCK);
+
+    m_stopFD = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+PacketQueue::~PacketQueue()
+{
+    if (m_ownFd && m_fd >= 0)
+        close(m_fd);
+    if (m_stopFD >= 0)
+        close(m_stopFD);
+}
+
+void PacketQueue::stop()
+{
+    m_stopped = true;
+    // Never read back, so it keeps every poll() awake:
+    uint64_t one = 1;
+    if (m_stopFD >= 0 && write(m_stopFD, &one, sizeof(one))) {}
+}
+
+ssize_t PacketQueue::readPacket(void *packet, const size_t &len, VNetHeader *vnetHeader)
+{
+    VNetHeader hdr;
+    struct iovec iov[2];
+    iov[0].iov_base = &hdr;
+    iov[0].iov_len = sizeof(hdr);
+    iov[1].iov_base = packet;
+    iov[1].iov_len = len;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = m_vnetHeader ? iov : iov + 1;
+    msg.msg_iovlen = m_vnetHeader ? 2 : 1;
+
+    for (;;)
+    {
+        if (m_stopped)
+            return -1;
+        if (!m_isSocket && !m_nonBlocking && waitFor(POLLIN, -1) <= 0)
+            return -1;
+
+        ssize_t r = m_isSocket ? recvmsg(m_fd, &msg, MSG_DONTWAIT) : readv(m_fd, msg.msg_iov, msg.msg_iovlen);
+        if (r >= 0)
+        {
+            if (!m_vnetHeader)
+                return r;
+            if (r < static_cast<ssize_t>(sizeof(hdr)))
+                return -1;
+            if (vnetHeader)
+                *vnetHeader = hdr;
+            return r - sizeof(hdr);
+        }
+        if (errno == EINTR)
+            continue;
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || waitFor(POLLIN, -1) <= 0)
+            return -1;
+    }
+}
+
+ssize_t PacketQueue::writePacket(const void *packet, const size_t &len, const VNetHeader *vnetHeader)
+{
+    VNetHeader hdr;
+    if (vnetHeader)
+        hdr = *vnetHeader;
+    else
+        memset(&hdr, 0, sizeof(hdr));
+
+    struct iovec iov[2];
+    iov[0].iov_base = &hdr;
+    iov[0].iov_len = sizeof(hdr);
+    iov[1].iov_base = const_cast<void *>(packet);
+    iov[1].iov_len = len;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = m_vnetHeader ? iov : iov + 1;
+    msg.msg_iovlen = m_vnetHeader ? 2 : 1;
+
+    std::unique_lock<std::mutex> lock(m_mutexWrite);
+    for (;;)
+    {
+        if (m_stopped)
+            return -1;
+
+        ssize_t r = m_isSocket ? sendmsg(m_fd, &msg, MSG_DONTWAIT) : writev(m_fd, msg.msg_iov, msg.msg_iovlen);
+        if (r >= 0)
+            return m_vnetHeader ? (r < static_cast<ssize_t>(sizeof(hdr)) ? -1 : r - static_cast<ssize_t>(sizeof(hdr))) : r;
+        if (errno == EINTR)
+            continue;
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || waitFor(POLLOUT, -1) <= 0)
+            return -1;
+    }
+}
+
+int PacketQueue::readBatch(PacketBatch &batch, int timeoutMS)
+{
+    batch.setSize(0);
+    if (m_fd < 0 || m_stopped)
+        return -1;
+
+    const size_t hdrSize = m_vnetHeader ? sizeof(VNetHeader) : 0;
+    size_t count = 0;
+
+    while (count < batch.capacity())
+    {
+        if (m_isSocket)
+        {
+            for (size_t i = count; i < batch.capacity(); i++)
+                setupIOVecs(batch, i, false);
+
+            int r = recvmmsg(m_fd, batch.m_headers.data() + count, batch.capacity() - count, MSG_DONTWAIT, nullptr);
+            if (r > 0)
+            {
+                for (int i = 0; i < r; i++)
+                {
+                    size_t msgLen = batch.m_headers[count + i].msg_len;
+                    if (msgLen == 0 || msgLen < hdrSize)
+                    {
+                        // Closed by the peer (or truncated header).
+                        batch.setSize(count);
+                        return count ? static_cast<int>(count) : -1;
+                    }
+                    batch.m_packets[count + i].length = msgLen - hdrSize;
+                }
+                count += r;
+                // Less than requested: nothing else queued.
+                break;
+            }
+        }
+        else
+        {
+            if (!m_nonBlocking)
+            {
+                // Blocking descriptor: only read what is already queued.
+                int w = waitFor(POLLIN, count ? 0 : timeoutMS);
+                if (w <= 0)
+                {
+                    if (count)
+                        break;
+                    return w;
+                }
+            }
+
+            setupIOVecs(batch, count, false);
+            ssize_t r = readv(m_fd, batch.m_headers[count].msg_hdr.msg_iov, batch.m_headers[count].msg_hdr.msg_iovlen);
+            if (r > 0)
+            {
+                if (static_cast<size_t>(r) < hdrSize)
+                    break;
+                batch.m_packets[count].length = r - hdrSize;
+                count++;
+                continue;
+            }
+            if (r == 0)
+                break;
+        }
+
+        if (errno == EINTR)
+            continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            break;
+        if (count > 0)
+            break;
+
+        // Empty queue, wait for the first packet:
+        int w = waitFor(POLLIN, timeoutMS);
+        if (w <= 0)
+            return w;
+    }
+
+    batch.setSize(count);
+    return count ? static_cast<int>(count) : -1;
+}
+
+int PacketQueue::writeBatch(PacketBatch &batch)
+{
+    if (m_fd < 0 || m_stopped)
+        return -1;
+
+    std::unique_lock<std::mutex> lock(m_mutexWrite);
+
+    for (size_t i = 0; i < batch.size(); i++)
+        setupIOVecs(batch, i, true);
+
+    size_t sent = 0;
+    while (sent < batch.size())
+    {
+        if (m_isSocket)
+        {
+            int r = sendmmsg(m_fd, batch.m_headers.data() + sent, batch.size() - sent, MSG_DONTWAIT);
+            if (r > 0)
+            {
+                sent += r;
+                continue;
+            }
+        }
+        else
+        {
+            ssize_t r = writev(m_fd, batch.m_headers[sent].msg_hdr.msg_iov, batch.m_headers[sent].msg_hdr.msg_iovlen);
+            if (r >= 0)
+            {
+                sent++;
+                continue;
+            }
+        }
+
+        if (errno == EINTR)
+            continue;
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || waitFor(POLLOUT, -1) <= 0)
+            break;
+    }
+
+    return sent == 0 && batch.size() > 0 ? -1 : static_cast<int>(sent);
+}
+
+int PacketQueue::waitFor(short events, int timeoutMS)
+{
+    struct pollfd pfd[2];
+    pfd[0].fd = m_fd;
+    pfd[0].events = events;
+    pfd[1].fd = m_stopFD;
+    pfd[1].events = POLLIN;
+
+    for (;;)
+    {
+        pfd[0].revents = pfd[1].revents = 0;
+        int r = poll(pfd, m_stopFD >= 0 ? 2 : 1, timeoutMS);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (m_stopped)
+            return -1;
+        if (r > 0 && (pfd[0].revents & (POLLERR | POLLNVAL)))
+            return -1;
+        return r;
+    }
+}
+
+void PacketQueue::setupIOVecs(PacketBatch &batch, const size_t &pos, bool forWrite)
+{
+    struct msghdr & hdr = batch.m_headers[pos].msg_hdr;
+    batch.m_iovecs[pos * 2 + 1].iov_len = forWrite ? batch.m_packets[pos].length : batch.m_bufferSize;
+    hdr.msg_iov = &batch.m_iovecs[pos * 2 + (m_vnetHeader ? 0 : 1)];
+    hdr.msg_iovlen = m_vnetHeader ? 2 : 1;
+    hdr.msg_name = nullptr;
+    hdr.msg_namelen = 0;
+    hdr.msg_control = nullptr;
+    hdr.msg_controllen = 0;
+    hdr.msg_flags = 0;
+}
+
+#endif
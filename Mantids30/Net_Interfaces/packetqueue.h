@@ -0,0 +1,198 @@
+#pragma once
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <vector>
+
+namespace Mantids30 { namespace Network { namespace Interfaces {
+
+/**
+ * @brief The VNetHeader struct is the virtio-net header (struct virtio_net_hdr, in host byte order) that precedes
+ *        every packet on TAP queues opened with IFF_VNET_HDR (<linux/virtio_net.h> can't be included from C++).
+ */
+struct VNetHeader
+{
+    enum eFlags
+    {
+        F_NEEDS_CSUM = 1,   ///< checksum should be computed from csumStart and stored at csumStart+csumOffset
+        F_DATA_VALID = 2
+    };
+    enum eGSOType
+    {
+        GSO_NONE = 0,
+        GSO_TCPV4 = 1,
+        GSO_UDP = 3,
+        GSO_TCPV6 = 4,
+        GSO_ECN = 0x80
+    };
+
+    uint8_t flags;
+    uint8_t gsoType;
+    uint16_t hdrLen;        ///< ethernet + ip + tcp/udp header length
+    uint16_t gsoSize;       ///< segment payload size
+    uint16_t csumStart;
+    uint16_t csumOffset;
+};
+
+/**
+ * @brief The PacketBatch class holds a set of fixed-size packet buffers in one slab, to read or write many packets
+ *        per call without allocations per packet.
+ *
+ * The slab is allocated once (or provided by the caller), so the same batch should be reused for every call.
+ */
+class PacketBatch
+{
+public:
+    struct Packet
+    {
+        /**
+         * @brief data buffer of getBufferSize() bytes (inside the slab).
+         */
+        unsigned char * data;
+        /**
+         * @brief length packet length (read), or length to be written.
+         */
+        size_t length;
+        /**
+         * @brief vnetHeader offload information (only used on queues with the virtio-net header enabled): GSO type/size
+         *                   for packets bigger than the MTU, and partial checksum position.
+         */
+        VNetHeader vnetHeader;
+    };
+
+    /**
+     * @brief PacketBatch Create a batch with its own slab.
+     * @param count max number of packets per call.
+     * @param bufferSize size of each packet buffer (use 65550 to receive GSO packets with the virtio-net header).
+     */
+    PacketBatch(const size_t & count, const size_t & bufferSize = 2048);
+    /**
+     * @brief PacketBatch Create a batch over a caller-provided slab (of at least count*bufferSize bytes), that should
+     *                    remain valid during the batch life.
+     */
+    PacketBatch(void * slab, const size_t & count, const size_t & bufferSize);
+    ~PacketBatch();
+
+    PacketBatch(const PacketBatch &) = delete;
+    PacketBatch & operator=(const PacketBatch &) = delete;
+
+    size_t capacity() const { return m_packets.size(); }
+    size_t getBufferSize() const { return m_bufferSize; }
+
+    /**
+     * @brief size Number of packets in use (read by the last call, or to be written)
+     */
+    size_t size() const { return m_count; }
+    /**
+     * @brief setSize Set the number of packets to be written (up to the capacity).
+     */
+    void setSize(const size_t & count);
+
+    Packet & operator[](const size_t & pos) { return m_packets[pos]; }
+    const Packet & operator[](const size_t & pos) const { return m_packets[pos]; }
+
+private:
+    friend class PacketQueue;
+    void init(const size_t & count);
+
+    std::vector<Packet> m_packets;
+    unsigned char * m_slab = nullptr;
+    bool m_ownSlab = false;
+    size_t m_bufferSize;
+    size_t m_count = 0;
+
+    // System call structures (two iovecs per packet: virtio-net header + data):
+    std::vector<struct mmsghdr> m_headers;
+    std::vector<struct iovec> m_iovecs;
+};
+
+/**
+ * @brief The PacketQueue class moves packets over a file descriptor: a TAP queue (one per worker on multi-queue
+ *        interfaces), or any packet-oriented descriptor (eg. a SOCK_SEQPACKET/SOCK_DGRAM socketpair for tests).
+ *
+ * The descriptor flags are not changed (they are shared with every duplicate of the descriptor). Sockets are always
+ * used in non-blocking calls (MSG_DONTWAIT) and batches are moved with recvmmsg/sendmmsg. On other descriptors opened
+ * with O_NONBLOCK, batch calls take every packet already queued without an extra system call per packet, while on
+ * blocking descriptors each read is preceded by a poll().
+ *
+ * When the virtio-net header is enabled (IFF_VNET_HDR), each packet is preceded by the virtio-net header (VNetHeader), that is
+ * handled separately from the packet data.
+ */
+class PacketQueue
+{
+public:
+    /**
+     * @brief PacketQueue
+     * @param fd file descriptor.
+     * @param ownFd close the descriptor on destruction.
+     * @param vnetHeader packets are preceded by the virtio-net header.
+     */
+    PacketQueue(int fd, bool ownFd = false, bool vnetHeader = false);
+    ~PacketQueue();
+
+    PacketQueue(const PacketQueue &) = delete;
+    PacketQueue & operator=(const PacketQueue &) = delete;
+
+    /**
+     * @brief stop Wake up every call waiting on this queue and make the current and next calls fail (eg. to stop the
+     *             workers before closing the interface).
+     */
+    void stop();
+
+    int getFD() const { return m_fd; }
+    bool hasVnetHeader() const { return m_vnetHeader; }
+
+    /**
+     * @brief readPacket Read one packet (waits until available).
+     * @param packet packet buffer.
+     * @param len buffer size.
+     * @param vnetHeader if not null, receives the virtio-net header (if enabled).
+     * @return packet bytes read, or -1 on error.
+     */
+    ssize_t readPacket(void * packet, const size_t & len, VNetHeader * vnetHeader = nullptr);
+    /**
+     * @brief writePacket Write one packet.
+     * @param packet packet bytes.
+     * @param len packet len.
+     * @param vnetHeader virtio-net header (if enabled), nullptr for a packet without offloads.
+     * @return packet bytes written (must be packet len), or -1 on error.
+     */
+    ssize_t writePacket(const void * packet, const size_t & len, const VNetHeader * vnetHeader = nullptr);
+
+    /**
+     * @brief readBatch Read up to batch.capacity() packets: waits for the first one, then takes the already queued ones.
+     * @param batch reusable packet batch, batch.size() is set to the number of packets read.
+     * @param timeoutMS max time to wait for the first packet (-1: infinite).
+     * @return number of packets read, 0 on timeout, or -1 on error.
+     */
+    int readBatch(PacketBatch & batch, int timeoutMS = -1);
+    /**
+     * @brief writeBatch Write the first batch.size() packets.
+     * @param batch packet batch with the data, length (and virtio-net header, if enabled) of each packet.
+     * @return number of packets written (less than batch.size() if an error occurred in the middle), or -1 on error.
+     */
+    int writeBatch(PacketBatch & batch);
+
+private:
+    int waitFor(short events, int timeoutMS);
+    void setupIOVecs(PacketBatch & batch, const size_t & pos, bool forWrite);
+
+    std::mutex m_mutexWrite;
+    std::atomic<bool> m_stopped{false};
+    int m_fd;
+    int m_stopFD;
+    bool m_ownFd;
+    bool m_vnetHeader;
+    bool m_isSocket;
+    bool m_nonBlocking;
+};
+
+}}}
+
+#endif
@@ -78,8 +78,25 @@ bool VirtualNetworkInterface::start(NetworkInterfaceConfiguration * netcfg, cons
     struct ifreq ifr;
     ZeroBStruct(ifr);
 
+    // Negotiate the features with the kernel:
+    unsigned int features = 0;
+    if (ioctl(m_fd, TUNGETFEATURES, &features) < 0)
+        features = IFF_TAP | IFF_NO_PI;
+
+    if (m_queueCount > 1 && !(features & IFF_MULTI_QUEUE))
+    {
+        m_lastError = "TUN/TAP multi-queue not supported";
+        stop();
+        return false;
+    }
+    m_vnetHeader = m_vnetHeaderRequested && (features & IFF_VNET_HDR);
+
     // Create the tun/tap interface.
     ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    if (m_queueCount > 1)
+        ifr.ifr_flags |= IFF_MULTI_QUEUE;
+    if (m_vnetHeader)
+        ifr.ifr_flags |= IFF_VNET_HDR;
 
     if (m_interfaceName.c_str()[m_interfaceName.size()-1]>='0' && m_interfaceName.c_str()[m_interfaceName.size()-1]<='9')
     {
@@ -107,6 +124,36 @@ bool VirtualNetworkInterface::start(NetworkInterfaceConfiguration * netcfg, cons
     }
 
     m_interfaceRealName = ifr.ifr_name;
+
+    // The first queue is served over its own descriptor (released by the last worker using it, after stop):
+    int firstQueueFD = dup(m_fd);
+    if (firstQueueFD < 0)
+    {
+        m_lastError = "Failed to duplicate the TUN/TAP descriptor";
+        stop();
+        return false;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queues.push_back(std::make_shared<PacketQueue>(firstQueueFD, true, m_vnetHeader));
+    }
+
+    // Open the other queues of the same interface (not shared, so they can be used in non-blocking mode):
+    for (uint32_t i = 1; i < m_queueCount; i++)
+    {
+        int queueFD = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+        if (queueFD < 0 || ioctl(queueFD, TUNSETIFF, (void*) &ifr) < 0)
+        {
+            m_lastError = "Failed to open the TUN/TAP queue #" + std::to_string(i);
+            if (queueFD >= 0)
+                close(queueFD);
+            stop();
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queues.push_back(std::make_shared<PacketQueue>(queueFD, true, m_vnetHeader));
+    }
+
     if (netcfg)
     {
         if (netcfg->openInterface(m_interfaceRealName))
@@ -141,6 +188,13 @@ void VirtualNetworkInterface::stop()
         lastError = "Error closing the device.";
     m_fd = INVALID_HANDLE_VALUE;
 #else
+    // Wake up and fail the workers still using a queue (each queue descriptor is closed when its last worker releases it):
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (auto & queue : m_queues)
+            queue->stop();
+        m_queues.clear();
+    }
     if (m_fd>=0)
         close(m_fd);
     m_fd = -1;
@@ -151,13 +205,68 @@ void VirtualNetworkInterface::stop()
 #ifndef _WIN32
 ssize_t VirtualNetworkInterface::writePacket(const void *packet, unsigned int len)
 {
-    std::unique_lock<std::mutex> lock(m_mutexWrite);
-    return write(m_fd,packet,len);
+    std::shared_ptr<PacketQueue> queue = getQueue(0);
+    if (!queue)
+        return -1;
+    return queue->writePacket(packet,len);
 }
 
 ssize_t VirtualNetworkInterface::readPacket(void *packet, unsigned int len)
 {
-    return read(m_fd,packet,len);
+    std::shared_ptr<PacketQueue> queue = getQueue(0);
+    if (!queue)
+        return -1;
+    return queue->readPacket(packet,len);
+}
+
+void VirtualNetworkInterface::setQueueCount(const uint32_t &queues)
+{
+    m_queueCount = queues ? queues : 1;
+}
+
+void VirtualNetworkInterface::setVnetHeader(bool enabled)
+{
+    m_vnetHeaderRequested = enabled;
+}
+
+bool VirtualNetworkInterface::hasVnetHeader() const
+{
+    return m_vnetHeader;
+}
+
+unsigned int VirtualNetworkInterface::setOffloads(bool checksum, bool tso)
+{
+    if (m_fd<0 || !m_vnetHeader)
+        return 0;
+
+    unsigned int offloads = 0;
+    if (checksum)
+    {
+        offloads = TUN_F_CSUM;
+        if (tso && ioctl(m_fd, TUNSETOFFLOAD, TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6 | TUN_F_TSO_ECN) == 0)
+            return TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6 | TUN_F_TSO_ECN;
+    }
+    if (ioctl(m_fd, TUNSETOFFLOAD, offloads) < 0)
+    {
+        m_lastError = "ioctl(TUNSETOFFLOAD) failed";
+        return 0;
+    }
+    return offloads;
+}
+
+size_t VirtualNetworkInterface::getQueueCount() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_queues.size();
+}
+
+std::shared_ptr<PacketQueue> VirtualNetworkInterface::getQueue(const size_t &pos) const
+{
+    // Copied under the lock: the list is cleared by stop() while the workers still hold their queues.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (pos >= m_queues.size())
+        return nullptr;
+    return m_queues[pos];
 }
 
 int VirtualNetworkInterface::getInterfaceHandler()
@@ -248,7 +357,7 @@ std::string VirtualNetworkInterface::getWinTapLogLine()
 
 DWORD VirtualNetworkInterface::writePacket(const void *packet, DWORD len)
 {
-    std::unique_lock<std::mutex> lock(mutexWrite);
+    std::unique_lock<std::mutex> lock(m_mutex);
 
     OVERLAPPED overlapped;
     memset(&overlapped, 0, sizeof(overlapped));
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "netifconfig.h"
+#include "packetqueue.h"
 #include <string>
 #include <mutex>
+#include <memory>
+#include <vector>
 #include <stdint.h>
 
 #ifdef _WIN32
@@ -41,7 +44,7 @@ public:
      */
     bool start(NetworkInterfaceConfiguration * netcfg = nullptr, const std::string & netIfaceName = "");
     /**
-     * @brief stop Stop the TAP Interface.
+     * @brief stop Stop the TAP Interface (the calls of the workers still using a queue fail from now on).
      */
     void stop();
 
@@ -59,6 +62,43 @@ public:
 
 #ifndef _WIN32
     // Linux specific functions:
+    /**
+     * @brief setQueueCount Set the number of queues to open (use before start). With more than one queue, the
+     *                      interface is created with IFF_MULTI_QUEUE and the kernel spreads the flows between them, so
+     *                      each queue can be served by a different worker thread.
+     * @param queues number of queues (default 1).
+     */
+    void setQueueCount(const uint32_t & queues);
+    /**
+     * @brief setVnetHeader Request the virtio-net header on every packet (IFF_VNET_HDR, use before start), needed for
+     *                      the checksum/segmentation offloads. If the kernel does not support it, the interface is
+     *                      started without it (check hasVnetHeader()).
+     */
+    void setVnetHeader(bool enabled);
+    /**
+     * @brief hasVnetHeader Returns true if the interface was started with the virtio-net header.
+     */
+    bool hasVnetHeader() const;
+    /**
+     * @brief setOffloads Negotiate the offloads with the kernel (use after start, requires the virtio-net header): the
+     *                    interface can hand us partially checksummed packets (checksum) and TCP packets bigger than
+     *                    the MTU (TSO). If TSO is refused, only the checksum offload is tried.
+     * @param checksum accept packets without the checksum computed (TUN_F_CSUM).
+     * @param tso accept TCP segmentation offload packets (TUN_F_TSO4/TUN_F_TSO6/TUN_F_TSO_ECN, requires checksum).
+     * @return applied offload flags (TUN_F_*), 0 if none.
+     */
+    unsigned int setOffloads(bool checksum, bool tso);
+    /**
+     * @brief getQueueCount Get the number of opened queues.
+     */
+    size_t getQueueCount() const;
+    /**
+     * @brief getQueue Get a queue (to be served by one worker).
+     * @param pos queue number (0 to getQueueCount()-1).
+     * @return packet queue, or nullptr if not available.
+     */
+    std::shared_ptr<PacketQueue> getQueue(const size_t & pos) const;
+
     /**
      * @brief setPersistentMode Set the Interface as persistent (use after start)
      * @param mode true for persistent tun/tap device (persist to application close)
@@ -78,21 +118,21 @@ public:
      */
     bool setGroup(const char * groupName);
     /**
-     * @brief getInterfaceHandler Get Interface Handler (file descriptor)
+     * @brief getInterfaceHandler Get Interface Handler (the file descriptor that created the interface, its flags are not changed)
      * @return file descriptor
      */
     int getInterfaceHandler();
 
     //////////////////////////////////////////////
     /**
-     * @brief writePacket Write Packet to interface (sync)
+     * @brief writePacket Write Packet to interface (sync, over the first queue)
      * @param packet packet bytes.
      * @param len packet len.
      * @return packet bytes written (must be packet len).
      */
     ssize_t writePacket(const void *packet, unsigned int len);
     /**
-     * @brief readPacket Read Packet from interface (sync)
+     * @brief readPacket Read Packet from interface (sync, over the first queue)
      * @param packet packet bytes.
      * @param len packet len.
      * @return packet bytes read.
@@ -149,9 +189,9 @@ public:
 
 private:
     /**
-     * @brief mutexWrite Mutex used for write operations
+     * @brief mutex Mutex used for the queue list (linux) and for write operations (win32)
      */
-    std::mutex m_mutexWrite;
+    mutable std::mutex m_mutex;
     /**
      * @brief lastError Last error string
      */
@@ -160,6 +200,10 @@ private:
 
 #ifndef _WIN32
     int m_fd;
+    uint32_t m_queueCount = 1;
+    bool m_vnetHeaderRequested = false;
+    bool m_vnetHeader = false;
+    std::vector<std::shared_ptr<PacketQueue>> m_queues;
 #else
     HANDLE m_fd;
     std::string m_devicePath;
@@ -1,11 +1,39 @@
 #include "acceptor_multithreaded.h"
+#include <Mantids30/Program_Metrics/registry.h>
 #include <algorithm>
 #include <memory>
 #include <stdexcept>
 
 using namespace Mantids30::Network::Sockets::Acceptors;
+using namespace Mantids30::Program;
 using Ms = std::chrono::milliseconds;
 
+namespace {
+
+struct AcceptorMetrics
+{
+    AcceptorMetrics()
+        : accepted(Metrics::Registry::getDefault().counterFamily("mantids30_acceptor_accepted_connections_total", "Connections accepted from the listening sockets.", {"acceptor"}).withLabels({"multithreaded"}))
+        , rejectedByTimeout(Metrics::Registry::getDefault().counterFamily("mantids30_acceptor_rejected_connections_total", "Accepted connections dropped before being handled.", {"acceptor", "reason"}).withLabels({"multithreaded", "timeout"}))
+        , rejectedByIPLimit(Metrics::Registry::getDefault().counterFamily("mantids30_acceptor_rejected_connections_total", "Accepted connections dropped before being handled.", {"acceptor", "reason"}).withLabels({"multithreaded", "limit_per_ip"}))
+        , active(Metrics::Registry::getDefault().gaugeFamily("mantids30_acceptor_active_connections", "Connections being handled.", {"acceptor"}).withLabels({"multithreaded"}))
+    {
+    }
+
+    Metrics::Counter & accepted;
+    Metrics::Counter & rejectedByTimeout;
+    Metrics::Counter & rejectedByIPLimit;
+    Metrics::Gauge & active;
+};
+
+AcceptorMetrics & getMetrics()
+{
+    static AcceptorMetrics metrics;
+    return metrics;
+}
+
+}
+
 
 uint32_t MultiThreaded::Config::getMaxConnectionsPerIP()
 {
@@ -72,6 +100,7 @@ bool MultiThreaded::processClient(std::shared_ptr<Sockets::Socket_Stream>clientS
     {
         if (m_condClientsNotFull.wait_for(lock,Ms(parameters.maxWaitMSTime)) == std::cv_status::timeout )
         {
+            getMetrics().rejectedByTimeout.add();
             if (callbacks.onClientAcceptTimeoutOccurred)
             {
                 callbacks.onClientAcceptTimeoutOccurred(callbacks.contextOnTimedOut, clientSocket);
@@ -89,6 +118,7 @@ bool MultiThreaded::processClient(std::shared_ptr<Sockets::Socket_Stream>clientS
     // update the counter
     if (incrementIPUsage(clientThread->getRemotePair())>parameters.maxConnectionsPerIP)
     {
+        getMetrics().rejectedByIPLimit.add();
         if (callbacks.onClientConnectionLimitPerIPReached)
         {
             callbacks.onClientConnectionLimitPerIPReached(callbacks.contextonClientConnectionLimitPerIPReached, clientSocket);
@@ -99,6 +129,7 @@ bool MultiThreaded::processClient(std::shared_ptr<Sockets::Socket_Stream>clientS
     }
 
     m_threadList.push_back(clientThread);
+    getMetrics().active.increment();
 
     std::thread(StreamAcceptorThread::thread_streamclient,clientThread,this).detach();
 
@@ -188,6 +219,8 @@ bool MultiThreaded::acceptClient()
     std::shared_ptr<Sockets::Socket_Stream> clientSocket = m_acceptorSocket->acceptConnection();
     if (clientSocket)
     {
+        getMetrics().accepted.add();
+
         std::shared_ptr<StreamAcceptorThread> clientThread = std::make_shared<StreamAcceptorThread>();
         clientThread->setClientSocket(clientSocket);
 
@@ -213,10 +246,11 @@ bool MultiThreaded::finalizeThreadElement(std::shared_ptr<StreamAcceptorThread>
     {
         m_threadList.remove(x);
         decrementIPUsage(x->getRemotePair());
+        getMetrics().active.decrement();
         //delete x;
         m_condClientsNotFull.notify_one();
         if (m_threadList.empty())
-            m_condClientsEmpty.notify_one();
+            m_condClientsEmpty.notify_all();
         return true;
     }
     return false;
@@ -246,6 +280,15 @@ void MultiThreaded::stop()
         m_acceptorSocket->shutdownSocket(SHUT_RDWR);
 }
 
+bool MultiThreaded::drain(const uint32_t &gracePeriodMS)
+{
+    if (m_acceptorSocket)
+        m_acceptorSocket->stopAccepting();
+
+    std::unique_lock<std::mutex> lock(m_mutexClients);
+    return m_condClientsEmpty.wait_for(lock, std::chrono::milliseconds(gracePeriodMS), [this]() { return m_threadList.empty(); });
+}
+
 
 bool MultiThreaded::startBlocking()
 {
@@ -60,6 +60,13 @@ public:
      * @brief stop Stop Acceptor
      */
     void stop();
+    /**
+     * @brief drain Stop accepting new connections (without shutting down the listening socket, that may be shared with
+     *        other processes) and wait for the current connections to finish.
+     * @param gracePeriodMS maximum time to wait in milliseconds
+     * @return true if all the connections finished within the grace period.
+     */
+    bool drain(const uint32_t & gracePeriodMS);
 
     /**
      * Set the socket that will be used to accept new clients.
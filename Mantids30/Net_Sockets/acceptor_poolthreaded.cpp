@@ -1,8 +1,34 @@
 #include "acceptor_poolthreaded.h"
+#include <Mantids30/Program_Metrics/registry.h>
 #include <memory>
 
 using namespace Mantids30::Network;
 using namespace Mantids30::Network::Sockets::Acceptors;
+using namespace Mantids30::Program;
+
+namespace {
+
+struct AcceptorMetrics
+{
+    AcceptorMetrics()
+        : accepted(Metrics::Registry::getDefault().counterFamily("mantids30_acceptor_accepted_connections_total", "Connections accepted from the listening sockets.", {"acceptor"}).withLabels({"poolthreaded"}))
+        , rejectedByTimeout(Metrics::Registry::getDefault().counterFamily("mantids30_acceptor_rejected_connections_total", "Accepted connections dropped before being handled.", {"acceptor", "reason"}).withLabels({"poolthreaded", "timeout"}))
+        , active(Metrics::Registry::getDefault().gaugeFamily("mantids30_acceptor_active_connections", "Connections being handled.", {"acceptor"}).withLabels({"poolthreaded"}))
+    {
+    }
+
+    Metrics::Counter & accepted;
+    Metrics::Counter & rejectedByTimeout;
+    Metrics::Gauge & active;
+};
+
+AcceptorMetrics & getMetrics()
+{
+    static AcceptorMetrics metrics;
+    return metrics;
+}
+
+}
 
 void PoolThreaded::init()
 {
@@ -49,6 +75,8 @@ void PoolThreaded::run()
         std::shared_ptr<Sockets::Socket_Stream> clientSocket = m_acceptorSocket->acceptConnection();
         if (clientSocket)
         {
+            getMetrics().accepted.add();
+
             // TODO: shared_ptr
             std::shared_ptr<sAcceptorTaskData> taskData = std::make_shared<sAcceptorTaskData>();
 
@@ -57,11 +85,19 @@ void PoolThreaded::run()
             taskData->contextOnConnect = callbacks.contextOnConnect;
             taskData->contextOnInitFail = callbacks.contextOnInitFail;
             taskData->clientSocket = clientSocket;
+            taskData->acceptor = this;
 
             taskData->key = clientSocket->getRemotePairStr();
 
+            {
+                std::lock_guard<std::mutex> pendingLock(m_mutexPending);
+                m_pendingConnections++;
+            }
+
             if (!m_pool->pushTask( &acceptorTask, taskData, parameters.timeoutMS, parameters.queuesKeyRatio, taskData->key))
             {
+                finalizeTask();
+                getMetrics().rejectedByTimeout.add();
                 if (callbacks.onClientAcceptTimeoutOccurred!=nullptr)
                     callbacks.onClientAcceptTimeoutOccurred(callbacks.contextOnTimedOut,clientSocket);
             }
@@ -79,6 +115,23 @@ void PoolThreaded::stop()
     m_acceptorSocket->shutdownSocket();
 }
 
+bool PoolThreaded::drain(const uint32_t &gracePeriodMS)
+{
+    std::shared_ptr<Sockets::Socket_Stream> acceptorSocket = m_acceptorSocket;
+    if (acceptorSocket)
+        acceptorSocket->stopAccepting();
+
+    std::unique_lock<std::mutex> lock(m_mutexPending);
+    return m_condPendingEmpty.wait_for(lock, std::chrono::milliseconds(gracePeriodMS), [this]() { return m_pendingConnections == 0; });
+}
+
+void PoolThreaded::finalizeTask()
+{
+    std::lock_guard<std::mutex> lock(m_mutexPending);
+    if (--m_pendingConnections == 0)
+        m_condPendingEmpty.notify_all();
+}
+
 void PoolThreaded::setAcceptorSocket(const std::shared_ptr<Sockets::Socket_Stream> & value)
 {
     m_acceptorSocket = value;
@@ -100,7 +153,11 @@ void PoolThreaded::acceptorTask(std::shared_ptr<void> data)
      pthread_setname_np(pthread_self(), "poolthr:sckacpt");
 #endif
 
-     sAcceptorTaskData * taskData = (sAcceptorTaskData *)data.get();
+    sAcceptorTaskData * taskData = (sAcceptorTaskData *)data.get();
+
+    // Active while the connection is being handled by this task:
+    getMetrics().active.increment();
+
     if (taskData->clientSocket->postAcceptSubInitialization())
     {
         // Start
@@ -122,4 +179,12 @@ void PoolThreaded::acceptorTask(std::shared_ptr<void> data)
             }
         }
     }
+
+    getMetrics().active.decrement();
+
+    // Release our reference before notifying the drain (the callbacks may still hold the connection):
+    PoolThreaded * acceptor = taskData->acceptor;
+    taskData->clientSocket = nullptr;
+    if (acceptor)
+        acceptor->finalizeTask();
 }
@@ -6,11 +6,10 @@
 #include <Mantids30/Helpers/mem.h>
 #include <Mantids30/Threads/threaded.h>
 #include <Mantids30/Threads/threadpool.h>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 
-// TODO: statistics
-
 namespace Mantids30 {
 namespace Network {
 namespace Sockets {
@@ -60,6 +59,14 @@ public:
    * class (don't call anything after this).
    */
   void stop();
+  /**
+   * @brief drain Stop accepting new connections (without shutting down the
+   * listening socket, that may be shared with other processes) and wait for
+   * the queued and running connections to finish.
+   * @param gracePeriodMS maximum time to wait in milliseconds
+   * @return true if all the connections finished within the grace period.
+   */
+  bool drain(const uint32_t &gracePeriodMS);
 
   /////////////////////////////////////////////////////////////////////////
   // TUNNING:
@@ -119,6 +126,8 @@ private:
     void *contextOnConnect = nullptr;
     void *contextOnInitFail = nullptr;
 
+    PoolThreaded *acceptor = nullptr;
+
     std::string key;
 
     std::shared_ptr<Sockets::Socket_Stream> clientSocket;
@@ -130,10 +139,16 @@ private:
   static void acceptorTask(std::shared_ptr<void> data);
 
   void init();
+  void finalizeTask();
 
   Mantids30::Threads::Pool::ThreadPool *m_pool = nullptr;
   std::shared_ptr<Sockets::Socket_Stream> m_acceptorSocket;
   std::mutex m_runMutex;
+
+  // Queued or running connections:
+  uint32_t m_pendingConnections = 0;
+  std::mutex m_mutexPending;
+  std::condition_variable m_condPendingEmpty;
 };
 
 } // namespace Acceptors
@@ -1,4 +1,5 @@
 #include "listener.h"
+#include "listener_handoff.h"
 #include "socket_stream.h"
 
 #include <Mantids30/Helpers/callbacks.h>
@@ -31,7 +32,7 @@ bool Listener::startListeningInBackground( const Config &parameters )
     // TODO: this is repeated code... we should pass this to socket_tls? and personalize the socket options...
     shared_ptr<Acceptors::MultiThreaded> multiThreadedAcceptor = make_shared<Acceptors::MultiThreaded>();
 
-    shared_ptr<Socket_Stream> listenerSocket = parameters.useTLS ? std::make_shared<Socket_TLS>() : std::make_shared<Socket_TCP>();
+    shared_ptr<Socket_TCP> listenerSocket = parameters.useTLS ? std::make_shared<Socket_TLS>() : std::make_shared<Socket_TCP>();
 
     bool cont = true;
 
@@ -63,8 +64,10 @@ bool Listener::startListeningInBackground( const Config &parameters )
     }
 
     listenerSocket->setUseIPv6( parameters.useIPv6 );
+    listenerSocket->setReusePort( parameters.reusePort );
 
-    if (!cont || !listenerSocket->listenOn(parameters.listenPort, parameters.listenAddr.c_str()))
+    // Adopt the listening socket handed off by the previous process (if any):
+    if (!cont || !ListenerHandoff::getDefault().listenOn(listenerSocket, parameters.listenPort, parameters.listenAddr.c_str()))
     {
         CALLBACK(tcpCallbacks.onListeningFailed)(listenerContext, listenerSocket);
         return false;
@@ -98,5 +101,21 @@ bool Listener::startListeningInBackground( const Config &parameters )
 
     multiThreadedAcceptor->startInBackground();
 
+    m_acceptor = multiThreadedAcceptor;
+
+    // Wait for these connections when the listener is handed off:
+    std::weak_ptr<Acceptors::MultiThreaded> weakAcceptor = multiThreadedAcceptor;
+    ListenerHandoff::getDefault().addDrainFunction([weakAcceptor](const uint32_t &gracePeriodMS) {
+        auto acceptor = weakAcceptor.lock();
+        return acceptor ? acceptor->drain(gracePeriodMS) : true;
+    });
+
     return true;
 }
+
+bool Listener::drain(const uint32_t &gracePeriodMS)
+{
+    if (!m_acceptor)
+        return true;
+    return m_acceptor->drain(gracePeriodMS);
+}
@@ -2,6 +2,7 @@
 
 #include "callbacks_socket_tcp_server.h"
 #include "callbacks_socket_tls_server.h"
+#include "acceptor_multithreaded.h"
 #include <memory>
 
 namespace Mantids30 {
@@ -50,6 +51,12 @@ public:
 
     bool useIPv6 = false;
 
+    /**
+     * @brief Set SO_REUSEPORT, so many processes can listen on the same
+     * address/port (the kernel balances the connections between them).
+     */
+    bool reusePort = false;
+
     uint32_t maxConcurrentClients = 16;
     uint32_t maxConnectionsPerIP = 4096;
     // TODO: maxWaitMSTime,
@@ -64,6 +71,14 @@ public:
    */
   bool startListeningInBackground(const Config &parameters);
 
+  /**
+   * @brief drain Stop accepting new connections and wait for the current ones
+   * to finish (eg. after handing off the listening socket to a new process).
+   * @param gracePeriodMS maximum time to wait in milliseconds
+   * @return true if all the connections finished within the grace period.
+   */
+  bool drain(const uint32_t &gracePeriodMS);
+
   // Callbacks from thread:
   virtual int handleClientConnection(
       std::shared_ptr<Sockets::Socket_Stream> stream) = 0;
@@ -93,6 +108,8 @@ public:
   void *listenerContext;
 
 private:
+  std::shared_ptr<Acceptors::MultiThreaded> m_acceptor;
+
   static bool
   incomingConnection(void *,
                      std::shared_ptr<Sockets::Socket_Stream> bsocket);
@@ -0,0 +1,258 @@
+#include "listener_handoff.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include "socket_unix.h"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+using namespace Mantids30::Network::Sockets;
+
+ListenerHandoff::~ListenerHandoff()
+{
+    closeInheritedSockets();
+}
+
+ListenerHandoff &ListenerHandoff::getDefault()
+{
+    static ListenerHandoff handoff;
+    return handoff;
+}
+
+void ListenerHandoff::setEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enabled = enabled;
+}
+
+bool ListenerHandoff::isEnabled()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_enabled;
+}
+
+bool ListenerHandoff::receiveFromPreviousProcess(const std::string &handoffPath, const uint32_t &timeout)
+{
+#ifndef _WIN32
+    auto previousProcess = std::make_shared<Socket_UNIX>();
+    if (!previousProcess->connectFrom(nullptr, handoffPath.c_str(), 0, timeout))
+        return false;
+
+    std::string names;
+    std::vector<int> fds;
+    if (!previousProcess->receiveFileDescriptors(&names, &fds))
+        return false;
+
+    // One name per line, in the same order as the descriptors:
+    std::vector<std::string> listenerNames;
+    size_t start = 0, end;
+    while ((end = names.find('\n', start)) != std::string::npos)
+    {
+        listenerNames.push_back(names.substr(start, end - start));
+        start = end + 1;
+    }
+
+    if (listenerNames.size() != fds.size())
+    {
+        for (int fd : fds)
+            close(fd);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeInheritedSockets();
+    for (size_t i = 0; i < fds.size(); i++)
+    {
+        if (m_inheritedSockets.find(listenerNames[i]) != m_inheritedSockets.end())
+            close(fds[i]);
+        else
+            m_inheritedSockets[listenerNames[i]] = fds[i];
+    }
+    m_previousProcess = previousProcess;
+    m_enabled = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ListenerHandoff::isHandoffInProgress()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_previousProcess != nullptr;
+}
+
+bool ListenerHandoff::completeHandoff()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    closeInheritedSockets();
+
+    if (!m_previousProcess)
+        return false;
+
+    uint8_t confirmation = 1;
+    bool r = m_previousProcess->writeFull(&confirmation, sizeof(confirmation));
+    m_previousProcess->closeSocket();
+    m_previousProcess = nullptr;
+    return r;
+}
+
+bool ListenerHandoff::listenOn(const std::shared_ptr<Socket_TCP> &socket, const uint16_t &port, const char *listenOnAddr,
+                               const int32_t &recvbuffer, const int32_t &backlog)
+{
+    std::string name = getListenerName(socket, port, listenOnAddr);
+
+    int inheritedFD = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto i = m_inheritedSockets.find(name);
+        if (i != m_inheritedSockets.end())
+        {
+            inheritedFD = i->second;
+            m_inheritedSockets.erase(i);
+        }
+    }
+
+    if (inheritedFD != -1 && !socket->adoptListeningSocket(inheritedFD))
+    {
+        close(inheritedFD);
+        inheritedFD = -1;
+    }
+
+    if (inheritedFD == -1 && !socket->listenOn(port, listenOnAddr, recvbuffer, backlog))
+        return false;
+
+    registerListener(name, socket);
+    return true;
+}
+
+void ListenerHandoff::registerListener(const std::string &name, const std::shared_ptr<Socket_TCP> &socket)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Otherwise, the listeners are not shared and stopAccepting can shut them down:
+    if (m_enabled)
+        socket->enableInterruptibleAccept();
+    m_listeners[name] = socket;
+}
+
+void ListenerHandoff::addDrainFunction(const DrainFunction &drainFunction)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_drainFunctions.push_back(drainFunction);
+}
+
+bool ListenerHandoff::startHandoffServer(const std::string &handoffPath, const std::function<void()> &onHandedOff)
+{
+#ifndef _WIN32
+    auto server = std::make_shared<Socket_UNIX>();
+
+    // The listening sockets are only handed off to the same user (not accessible by others, even while binding):
+    mode_t previousMask = umask(S_IRWXG | S_IRWXO);
+    bool listening = server->listenOn(handoffPath.c_str());
+    umask(previousMask);
+    if (!listening)
+        return false;
+
+    std::thread(&ListenerHandoff::serveHandoff, this, server, onHandedOff).detach();
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ListenerHandoff::drain(const uint32_t &gracePeriodMS)
+{
+    std::list<std::shared_ptr<Socket_TCP>> listeners;
+    std::list<DrainFunction> drainFunctions;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &i : m_listeners)
+            listeners.push_back(i.second);
+        drainFunctions = m_drainFunctions;
+    }
+
+    for (auto &listener : listeners)
+        listener->stopAccepting();
+
+    // The grace period is shared by all the drain functions:
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(gracePeriodMS);
+    bool r = true;
+    for (auto &drainFunction : drainFunctions)
+    {
+        auto now = std::chrono::steady_clock::now();
+        uint32_t remainingMS = now < deadline ? static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()) : 0;
+        if (!drainFunction(remainingMS))
+            r = false;
+    }
+    return r;
+}
+
+std::string ListenerHandoff::getListenerName(const std::shared_ptr<Socket_TCP> &socket, const uint16_t &port, const char *listenOnAddr)
+{
+    return std::string(socket->getUseIPv6() ? "tcp6:" : "tcp:") + (listenOnAddr ? listenOnAddr : "*") + ":" + std::to_string(port);
+}
+
+void ListenerHandoff::serveHandoff(std::shared_ptr<Socket_UNIX> server, std::function<void()> onHandedOff)
+{
+#ifndef _WIN32
+    pthread_setname_np(pthread_self(), "sck:handoff");
+
+    for (;;)
+    {
+        auto nextProcess = std::dynamic_pointer_cast<Socket_UNIX>(server->acceptConnection());
+        if (!nextProcess)
+            return;
+
+#ifdef SO_PEERCRED
+        struct ucred credentials;
+        socklen_t credentialsLen = sizeof(credentials);
+        if (getsockopt(nextProcess->getSocketFD(), SOL_SOCKET, SO_PEERCRED, &credentials, &credentialsLen) != 0
+            || (credentials.uid != geteuid() && credentials.uid != 0))
+            continue;
+#endif
+
+        std::string names;
+        std::vector<int> fds;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto &i : m_listeners)
+            {
+                names += i.first + "\n";
+                fds.push_back(i.second->getSocketFD());
+            }
+        }
+
+        if (!nextProcess->sendFileDescriptors(names, fds))
+            continue;
+
+        // Keep accepting until the next process confirms that it's running (if it fails, wait for the next attempt):
+        uint8_t confirmation = 0;
+        if (!nextProcess->readFull(&confirmation, sizeof(confirmation)) || confirmation != 1)
+            continue;
+
+        // The handoff path now belongs to the next process (don't unlink it).
+        server->closeSocket();
+
+        if (onHandedOff)
+            onHandedOff();
+        return;
+    }
+#endif
+}
+
+void ListenerHandoff::closeInheritedSockets()
+{
+#ifndef _WIN32
+    for (auto &i : m_inheritedSockets)
+        close(i.second);
+#endif
+    m_inheritedSockets.clear();
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "socket_tcp.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Mantids30 { namespace Network { namespace Sockets {
+
+class Socket_UNIX;
+
+/**
+ * @brief The ListenerHandoff class passes the listening sockets of a running process to its replacement (eg. an upgraded
+ *        binary) over a UNIX socket (SCM_RIGHTS), so the ports are never closed during the upgrade.
+ *
+ * Handoff sequence:
+ *  1. The running process serves its registered listeners on a UNIX socket (startHandoffServer).
+ *  2. The new process connects and receives the listening sockets (receiveFromPreviousProcess), then the engines adopt
+ *     them instead of binding new ones (listenOn). Both processes accept connections meanwhile.
+ *  3. When started, the new process confirms the handoff (completeHandoff). The previous process stops accepting,
+ *     drains its current connections (drain) and exits.
+ *
+ * If the new process fails before confirming, the previous process keeps accepting as before.
+ *
+ * The listeners are identified by their protocol, address and port (eg. "tcp:0.0.0.0:8443"), inherited listeners
+ * that are not used by the new process are closed when the handoff completes.
+ */
+class ListenerHandoff
+{
+public:
+    /**
+     * @brief DrainFunction Stop accepting and wait for the current connections (returns false if the grace period expired)
+     */
+    typedef std::function<bool(const uint32_t & gracePeriodMS)> DrainFunction;
+
+    ListenerHandoff() = default;
+    ~ListenerHandoff();
+
+    /**
+     * @brief getDefault Get the process-wide handoff (used by Program_Service applications)
+     */
+    static ListenerHandoff & getDefault();
+
+    /**
+     * @brief setEnabled Enable the handoff (before creating the listeners): the registered listeners use an interruptible
+     *        accept, so they can stop accepting without shutting down the socket shared with the next process.
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    /**
+     * @brief receiveFromPreviousProcess Connect to the previous process and receive its listening sockets.
+     * @param handoffPath UNIX socket path served by the previous process
+     * @param timeout connection timeout in seconds
+     * @return true if the listening sockets were received (false if there is no previous process serving this path)
+     */
+    bool receiveFromPreviousProcess(const std::string & handoffPath, const uint32_t & timeout = 30);
+    /**
+     * @brief isHandoffInProgress Check if the listening sockets were received and the handoff is not completed yet
+     */
+    bool isHandoffInProgress();
+    /**
+     * @brief completeHandoff Confirm to the previous process that this process is running (the previous process will drain
+     *        its connections and exit), and close the inherited listeners that were not used.
+     * @return true if the previous process received the confirmation.
+     */
+    bool completeHandoff();
+
+    /**
+     * @brief listenOn Adopt the inherited listening socket for this address/port, or listen on a new one, and register it
+     *        for the next handoff.
+     * @return true if the socket is listening.
+     */
+    bool listenOn(const std::shared_ptr<Socket_TCP> & socket, const uint16_t & port, const char * listenOnAddr = "*",
+                  const int32_t & recvbuffer = 0, const int32_t & backlog = 10);
+    /**
+     * @brief registerListener Register a listening socket to be handed off to the next process (and stopped on drain),
+     *        called before accepting on it.
+     */
+    void registerListener(const std::string & name, const std::shared_ptr<Socket_TCP> & socket);
+    /**
+     * @brief addDrainFunction Add a function called on drain to wait for the connections of an acceptor/engine
+     */
+    void addDrainFunction(const DrainFunction & drainFunction);
+
+    /**
+     * @brief startHandoffServer Serve the registered listeners to the next process (in a background thread).
+     * @param handoffPath UNIX socket path (only accessible by the same user)
+     * @param onHandedOff called (from the background thread) when the next process confirmed the handoff, it should
+     *        drain the connections and finish the program.
+     * @return true if the handoff path is listening.
+     */
+    bool startHandoffServer(const std::string & handoffPath, const std::function<void()> & onHandedOff);
+
+    /**
+     * @brief drain Stop accepting on every registered listener (without shutting them down, they are being used by the
+     *        next process) and wait for the current connections.
+     * @param gracePeriodMS maximum time to wait for the connections in milliseconds
+     * @return true if all the connections finished within the grace period.
+     */
+    bool drain(const uint32_t & gracePeriodMS);
+
+    /**
+     * @brief getListenerName Get the name that identifies a listener between processes
+     */
+    static std::string getListenerName(const std::shared_ptr<Socket_TCP> & socket, const uint16_t & port, const char * listenOnAddr);
+
+private:
+    void serveHandoff(std::shared_ptr<Socket_UNIX> server, std::function<void()> onHandedOff);
+    void closeInheritedSockets();
+
+    std::mutex m_mutex;
+    std::map<std::string, std::shared_ptr<Socket_TCP>> m_listeners;
+    std::list<DrainFunction> m_drainFunctions;
+    bool m_enabled = false;
+
+    // Received from the previous process, and not adopted yet:
+    std::map<std::string, int> m_inheritedSockets;
+    std::shared_ptr<Socket_UNIX> m_previousProcess;
+};
+
+}}}
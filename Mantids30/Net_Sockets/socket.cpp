@@ -518,6 +518,11 @@ int Socket::setSocketOptionBool(int level, int optname, bool value)
     return setSocketOption(level,optname,(char *) &flag, sizeof(int));
 }
 
+unsigned int Socket::getReadTimeout() const
+{
+    return m_readTimeout;
+}
+
 bool Socket::setReadTimeout(unsigned int _timeout)
 {
     if (!isActive()) 
@@ -586,6 +591,11 @@ int Socket::adquireSocketFD()
     return sockret;
 }
 
+int Socket::getSocketFD() const
+{
+    return m_sockFD;
+}
+
 void Socket::getRemotePair(char * address) const
 {
     memset(address,0,INET6_ADDRSTRLEN);
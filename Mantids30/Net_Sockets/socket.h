@@ -59,6 +59,11 @@ public:
      * @param _timeout timeout in seconds
      */
     bool setReadTimeout(unsigned int _timeout);
+    /**
+     * Get Read timeout.
+     * @return timeout in seconds (0: no timeout)
+     */
+    unsigned int getReadTimeout() const;
     /**
      * Set Write timeout.
      * @param _timeout timeout in seconds
@@ -90,6 +95,11 @@ public:
      * @return socket file descriptor
      */
     int adquireSocketFD();
+    /**
+     * Get Current Socket file descriptor (this object keeps the ownership)
+     * @return socket file descriptor (-1 if not active)
+     */
+    int getSocketFD() const;
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Socket Status:
@@ -249,6 +259,12 @@ public:
     virtual int iShutdown(int mode = SHUT_RDWR);
 
     virtual bool isSecure() { return false; }
+    /**
+     * @brief isRawStream Tell if the bytes transmitted by this socket are the same bytes carried by its file descriptor
+     *                    (no TLS or other transformation in between), so the descriptor can be used directly (eg. splice).
+     * @return true for plain stream sockets.
+     */
+    virtual bool isRawStream() { return false; }
 
     /**
      * @brief getUseIPv6 Get if using IPv6 Functions
@@ -2,4 +2,56 @@
 
 using namespace Mantids30::Network::Sockets;
 
+DatagramBatch::DatagramBatch(const size_t &count, const size_t &bufferSize)
+{
+    m_bufferSize = bufferSize;
+    m_slab = new unsigned char[count * bufferSize];
+    m_ownSlab = true;
+    init(count);
+}
 
+DatagramBatch::DatagramBatch(void *slab, const size_t &count, const size_t &bufferSize)
+{
+    m_bufferSize = bufferSize;
+    m_slab = static_cast<unsigned char *>(slab);
+    m_ownSlab = false;
+    init(count);
+}
+
+DatagramBatch::~DatagramBatch()
+{
+    if (m_ownSlab)
+        delete [] m_slab;
+}
+
+void DatagramBatch::setSize(const size_t &count)
+{
+    m_count = count > m_datagrams.size() ? m_datagrams.size() : count;
+}
+
+void DatagramBatch::init(const size_t &count)
+{
+    m_datagrams.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        m_datagrams[i].data = m_slab + i * m_bufferSize;
+        m_datagrams[i].length = 0;
+        m_datagrams[i].segmentSize = 0;
+        m_datagrams[i].truncated = false;
+        m_datagrams[i].addressLength = 0;
+    }
+
+#ifdef __linux__
+    m_headers.resize(count);
+    m_iovecs.resize(count);
+    m_control.resize(count * CMSG_SPACE(sizeof(int))); // UDP_GRO segment size
+    for (size_t i = 0; i < count; i++)
+    {
+        m_iovecs[i].iov_base = m_datagrams[i].data;
+        m_iovecs[i].iov_len = m_bufferSize;
+        memset(&m_headers[i], 0, sizeof(struct mmsghdr));
+        m_headers[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_headers[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+}
@@ -3,15 +3,106 @@
 #include "socket.h"
 #include <memory>
 #include <string.h>
+#include <vector>
 
 #ifdef _WIN32
 #include <winsock2.h>
+#include <ws2tcpip.h>
 #else
 #include <netinet/in.h>
+#include <sys/socket.h>
 #endif
 
 namespace Mantids30 { namespace Network { namespace Sockets {
 
+/**
+ * @brief The DatagramBatch class holds a set of fixed-size datagram buffers in one slab, to receive or send many
+ *        datagrams per system call (recvmmsg/sendmmsg) without allocations per datagram.
+ *
+ * The slab is allocated once (or provided by the caller), so the same batch should be reused for every call.
+ */
+class DatagramBatch
+{
+public:
+    struct Datagram
+    {
+        /**
+         * @brief data buffer of getBufferSize() bytes (inside the slab).
+         */
+        unsigned char * data;
+        /**
+         * @brief length received length, or length to be sent.
+         */
+        size_t length;
+        /**
+         * @brief segmentSize with receive offload (GRO), the coalesced datagrams size (the last one can be shorter),
+         *                    0 if the buffer contains a single datagram.
+         */
+        uint16_t segmentSize;
+        /**
+         * @brief truncated the received datagram was larger than the buffer (only the first getBufferSize() bytes
+         *                  are in data, and length is the buffer size).
+         */
+        bool truncated;
+        /**
+         * @brief address source address (received), or destination address (to send, if addressLength is not 0).
+         */
+        struct sockaddr_storage address;
+        socklen_t addressLength;
+    };
+
+    /**
+     * @brief DatagramBatch Create a batch with its own slab.
+     * @param count max number of datagrams per call.
+     * @param bufferSize size of each datagram buffer (use 65535 to receive with GRO).
+     */
+    DatagramBatch(const size_t & count, const size_t & bufferSize = 2048);
+    /**
+     * @brief DatagramBatch Create a batch over a caller-provided slab (of at least count*bufferSize bytes), that
+     *                      should remain valid during the batch life.
+     */
+    DatagramBatch(void * slab, const size_t & count, const size_t & bufferSize);
+    ~DatagramBatch();
+
+    DatagramBatch(const DatagramBatch &) = delete;
+    DatagramBatch & operator=(const DatagramBatch &) = delete;
+
+    /**
+     * @brief capacity Max number of datagrams.
+     */
+    size_t capacity() const { return m_datagrams.size(); }
+    size_t getBufferSize() const { return m_bufferSize; }
+
+    /**
+     * @brief size Number of datagrams in use (received by the last read, or to be sent)
+     */
+    size_t size() const { return m_count; }
+    /**
+     * @brief setSize Set the number of datagrams to be sent (up to the capacity).
+     */
+    void setSize(const size_t & count);
+
+    Datagram & operator[](const size_t & pos) { return m_datagrams[pos]; }
+    const Datagram & operator[](const size_t & pos) const { return m_datagrams[pos]; }
+
+private:
+    friend class Socket_UDP;
+    void init(const size_t & count);
+
+    std::vector<Datagram> m_datagrams;
+    unsigned char * m_slab = nullptr;
+    bool m_ownSlab = false;
+    size_t m_bufferSize;
+    size_t m_count = 0;
+
+#ifdef __linux__
+    // System call structures (built once, pointing to the slab):
+    std::vector<struct mmsghdr> m_headers;
+    std::vector<struct iovec> m_iovecs;
+    std::vector<char> m_control;
+#endif
+};
+
 class Socket_DatagramBase : public Socket
 {
 public:
@@ -159,6 +159,11 @@ std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> Socket_Stream::accep
     return nullptr;
 }
 
+void Socket_Stream::stopAccepting()
+{
+    shutdownSocket(SHUT_RDWR);
+}
+
 bool Socket_Stream::postAcceptSubInitialization()
 {
     return true;
@@ -36,6 +36,11 @@ public:
     virtual bool listenOn(const uint16_t & port, const char * listenOnAddr = "*", const int32_t & recvbuffer = 0, const int32_t &backlog = 10) override;
     virtual bool connectFrom(const char * bindAddress, const char * remoteHost, const uint16_t &port, const uint32_t &timeout = 30) override;
     virtual std::shared_ptr<Socket_Stream> acceptConnection();
+    /**
+     * @brief stopAccepting Stop accepting connections on this listening socket (pending/blocked acceptConnection calls return nullptr).
+     *        By default, the socket is shut down.
+     */
+    virtual void stopAccepting();
 
     /**
      * Virtual function for protocol initialization after the connection starts...
@@ -14,6 +14,9 @@
 
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #endif
 
 #include <string.h>
@@ -35,10 +38,19 @@ Socket_TCP::Socket_TCP()
     
     m_overwriteReadTimeout = -1;
     m_overwriteWriteTimeout = -1;
+
+    m_useReusePort = false;
+
+    m_acceptWakeupFD = -1;
+    m_acceptStopped = false;
 }
 
 Socket_TCP::~Socket_TCP()
 {
+#ifndef _WIN32
+    if (m_acceptWakeupFD != -1)
+        close(m_acceptWakeupFD);
+#endif
 }
 
 bool Socket_TCP::connectFrom(const char *bindAddress, const char *remoteHost, const uint16_t &port, const uint32_t &timeout)
@@ -160,7 +172,7 @@ std::shared_ptr<Sockets::Socket_Stream> Socket_TCP::acceptConnection()
     struct sockaddr_in cli_addr;
     clilen = sizeof(cli_addr);
     
-    if ((sdconn = accept(m_sockFD, (struct sockaddr *) &cli_addr, (socklen_t *)&clilen)) >= 0)
+    if ((sdconn = acceptClient((struct sockaddr *) &cli_addr, (socklen_t *)&clilen)) >= 0)
     {
         if (m_useTCPForceKeepAlive)
         {
@@ -203,6 +215,151 @@ std::shared_ptr<Sockets::Socket_Stream> Socket_TCP::acceptConnection()
     return cursocket;
 }
 
+int Socket_TCP::acceptClient(sockaddr *addr, socklen_t *addrlen)
+{
+#ifndef _WIN32
+    if (m_acceptWakeupFD != -1)
+    {
+        // The listening socket is non-blocking: wait for a connection or for the stopAccepting signal.
+        for (;;)
+        {
+            if (m_acceptStopped)
+                return -1;
+
+            struct pollfd fds[2];
+            fds[0].fd = m_sockFD;
+            fds[0].events = POLLIN;
+            fds[0].revents = 0;
+            fds[1].fd = m_acceptWakeupFD;
+            fds[1].events = POLLIN;
+            fds[1].revents = 0;
+
+            if (poll(fds, 2, -1) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return -1;
+            }
+
+            if (m_acceptStopped)
+                return -1;
+
+            socklen_t len = *addrlen;
+            int sdconn = accept(m_sockFD, addr, &len);
+            if (sdconn >= 0)
+            {
+                *addrlen = len;
+                return sdconn;
+            }
+
+            // Taken by another process sharing the listening socket, or aborted by the client before the accept:
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            return -1;
+        }
+    }
+#endif
+    return accept(m_sockFD, addr, addrlen);
+}
+
+bool Socket_TCP::enableInterruptibleAccept()
+{
+#ifndef _WIN32
+    if (m_acceptWakeupFD == -1)
+    {
+        m_acceptWakeupFD = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (m_acceptWakeupFD == -1)
+        {
+            // Fallback to the blocking accept.
+            return false;
+        }
+    }
+
+    int flags = fcntl(m_sockFD, F_GETFL, 0);
+    if (flags == -1 || fcntl(m_sockFD, F_SETFL, flags | O_NONBLOCK) == -1)
+    {
+        close(m_acceptWakeupFD);
+        m_acceptWakeupFD = -1;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Socket_TCP::stopAccepting()
+{
+    m_acceptStopped = true;
+#ifndef _WIN32
+    if (m_acceptWakeupFD != -1)
+    {
+        uint64_t one = 1;
+        if (::write(m_acceptWakeupFD, &one, sizeof(one)) != sizeof(one))
+        {
+            // Already signaled.
+        }
+        return;
+    }
+#endif
+    // Without the wakeup descriptor, the blocked accept can only be interrupted by shutting down the socket:
+    Socket_Stream::shutdownSocket(SHUT_RDWR);
+}
+
+int Socket_TCP::shutdownSocket(int mode)
+{
+    if (m_isInListenMode && m_acceptStopped && m_acceptWakeupFD != -1)
+    {
+        stopAccepting();
+        return 0;
+    }
+    return Socket_Stream::shutdownSocket(mode);
+}
+
+bool Socket_TCP::adoptListeningSocket(int fd)
+{
+    if (isActive())
+    {
+        m_lastError = "socket already initialized";
+        return false;
+    }
+
+#ifndef _WIN32
+    int acceptConn = 0, sockType = 0;
+    socklen_t optlen = sizeof(acceptConn);
+    if (getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &acceptConn, &optlen) != 0 || !acceptConn)
+    {
+        m_lastError = "the inherited socket is not listening";
+        return false;
+    }
+    optlen = sizeof(sockType);
+    if (getsockopt(fd, SOL_SOCKET, SO_TYPE, &sockType, &optlen) != 0 || sockType != SOCK_STREAM)
+    {
+        m_lastError = "the inherited socket is not a stream socket";
+        return false;
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t addrlen = sizeof(addr);
+    if (getsockname(fd, (struct sockaddr *) &addr, &addrlen) != 0 || (addr.ss_family != AF_INET && addr.ss_family != AF_INET6))
+    {
+        m_lastError = "the inherited socket is not a TCP/IP socket";
+        return false;
+    }
+
+    m_useIPv6 = addr.ss_family == AF_INET6;
+    m_sockFD = fd;
+    m_isInListenMode = true;
+    // Shared with the process that handed it off:
+    enableInterruptibleAccept();
+    return true;
+#else
+    m_lastError = "adopting sockets is not supported on this platform";
+    return false;
+#endif
+}
+
 bool Socket_TCP::tcpConnect(const unsigned short & addrFamily, const sockaddr *addr, socklen_t addrlen, uint32_t timeout)
 {
     int res2,valopt;
@@ -503,6 +660,15 @@ bool Socket_TCP::listenOn(const uint16_t & port, const char * listenOnAddr, cons
         closeSocket();
         return false;
     }
+
+#ifdef SO_REUSEPORT
+    if (m_useReusePort && setSocketOptionBool(SOL_SOCKET, SO_REUSEPORT, true))
+    {
+        m_lastError = "setsockopt(SO_REUSEPORT) failed";
+        closeSocket();
+        return false;
+    }
+#endif
     
     if (m_useTCPForceKeepAlive)
     {
@@ -547,6 +713,16 @@ bool Socket_TCP::listenOn(const uint16_t & port, const char * listenOnAddr, cons
     return true;
 }
 
+bool Socket_TCP::getReusePort() const
+{
+    return m_useReusePort;
+}
+
+void Socket_TCP::setReusePort(bool newReusePort)
+{
+    m_useReusePort = newReusePort;
+}
+
 
 bool Socket_TCP::postAcceptSubInitialization()
 {
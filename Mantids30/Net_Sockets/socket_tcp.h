@@ -1,6 +1,7 @@
 #pragma once
 
 #include "socket_stream.h"
+#include <atomic>
 #include <unistd.h>
 
 #ifdef _WIN32
@@ -39,6 +40,33 @@ public:
      * @return returns a socket with the new established tcp connection.
      */
     virtual std::shared_ptr<Socket_Stream> acceptConnection() override;
+    /**
+     * @brief adoptListeningSocket Use an already bound and listening TCP socket (eg. inherited from a previous process)
+     * @param fd listening socket file descriptor (owned by this class after the call)
+     * @return true if the descriptor is a listening TCP socket.
+     */
+    bool adoptListeningSocket(int fd);
+    /**
+     * @brief enableInterruptibleAccept Make the listening socket non-blocking and wait for the connections with poll, so
+     *        stopAccepting() can wake up the acceptor without shutting down the socket (call it after listenOn, before
+     *        accepting). Only needed when the socket is shared with other processes (eg. handed off during an upgrade),
+     *        adopted sockets are always interruptible.
+     * @return true if enabled (otherwise the accept blocks as usual).
+     */
+    bool enableInterruptibleAccept();
+    /**
+     * @brief stopAccepting Stop accepting connections.
+     *
+     * The listening socket may be shared with other processes (eg. handed off to the new process during an upgrade,
+     * or inherited), and a shutdown would stop the accept there too. With enableInterruptibleAccept, blocked
+     * acceptConnection calls return nullptr and from now on shutdownSocket only stops accepting. Otherwise, the
+     * socket is shut down.
+     */
+    void stopAccepting() override;
+    /**
+     * @brief shutdownSocket Shutdown the connection (a listening socket stopped by stopAccepting is not shut down)
+     */
+    int shutdownSocket(int mode = SHUT_RDWR) override;
 
     /**
      * Virtual function for protocol initialization after the connection starts...
@@ -55,6 +83,7 @@ public:
     void overrideWriteTimeout(int32_t tout = -1);
 
     virtual bool isSecure() override;
+    virtual bool isRawStream() override { return true; }
 
     int getTcpKeepIdle() const;
     void setTcpKeepIdle(int newTcpKeepIdle);
@@ -71,15 +100,28 @@ public:
     bool getTcpNoDelayOption() const;
     void setTcpNoDelayOption(bool newTcpNoDelayOption);
 
+    bool getReusePort() const;
+    /**
+     * @brief setReusePort Set SO_REUSEPORT before binding (listenOn), so many processes can bind their own listening socket
+     *        on the same address/port and the kernel balances the incoming connections between them.
+     */
+    void setReusePort(bool newReusePort);
+
 protected:
 
 private:
     bool tcpConnect(const unsigned short &addrType, const struct sockaddr *addr, socklen_t addrlen, uint32_t timeout);
+    int acceptClient(struct sockaddr *addr, socklen_t *addrlen);
 
     bool m_useTcpNoDelayOption;
     bool m_useTCPForceKeepAlive;
     int m_tcpKeepIdle,m_tcpKeepCnt,m_tcpKeepInterval;
     int32_t m_overwriteReadTimeout,m_overwriteWriteTimeout;
+    bool m_useReusePort;
+
+    // The accept waits on the listening socket and this eventfd (signaled by stopAccepting):
+    int m_acceptWakeupFD;
+    std::atomic<bool> m_acceptStopped;
 };
 
 typedef std::shared_ptr<Socket_TCP> Socket_TCP_SP;
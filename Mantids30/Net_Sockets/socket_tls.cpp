@@ -50,6 +50,8 @@ Socket_TLS::~Socket_TLS()
         SSL_free (m_sslHandler);
     if (m_sslContext)
         SSL_CTX_free(m_sslContext);
+    if (m_resumeSession)
+        SSL_SESSION_free(m_resumeSession);
 }
 
 void Socket_TLS::prepareTLS()
@@ -120,17 +122,17 @@ bool Socket_TLS::postConnectSubInitialization()
         }
     }
 
-    if (SSL_set_fd (m_sslHandler, m_sockFD) != 1)
-    {
-        m_sslErrorList.push_back("SSL_set_fd failed.");
+    if (!attachSSLHandler())
         return false;
-    }
 
-    if ( SSL_get_error(m_sslHandler, SSL_connect (m_sslHandler)) != SSL_ERROR_NONE )
+    // Try to resume the previous session (if the server does not accept it, a full handshake is done)
+    if (m_resumeSession && SSL_set_session(m_sslHandler, m_resumeSession) != 1)
     {
-        parseErrors();
-        return false;
+        m_sslErrorList.push_back("SSL_set_session failed, doing a full handshake.");
     }
+
+    if (!doHandshake())
+        return false;
     
     if ( m_certValidationOptions!=CERT_X509_NOVALIDATE )
     {
@@ -188,18 +190,11 @@ bool Socket_TLS::postAcceptSubInitialization()
         //SSL_set_verify(sslh, CERT_X509_NOVALIDATE, nullptr);
     }
 
-    if (SSL_set_fd (m_sslHandler, m_sockFD) != 1)
-    {
-        m_sslErrorList.push_back("SSL_set_fd failed.");
+    if (!attachSSLHandler())
         return false;
-    }
 
-    int err;
-    if ((err=SSL_accept(m_sslHandler)) != 1)
-    {
-        parseErrors();
+    if (!doHandshake())
         return false;
-    }
     
     if ( m_certValidationOptions!=CERT_X509_NOVALIDATE )
     {
@@ -256,6 +251,251 @@ bool Socket_TLS::isUsingPSK() const
 }
 
 
+bool Socket_TLS::attachSSLHandler()
+{
+    if (!m_transport)
+    {
+        if (SSL_set_fd (m_sslHandler, m_sockFD) != 1)
+        {
+            m_sslErrorList.push_back("SSL_set_fd failed.");
+            return false;
+        }
+        return true;
+    }
+
+    // The records are exchanged with the transport through memory BIOs (owned by the SSL handler):
+    m_transportInBIO = BIO_new(BIO_s_mem());
+    m_transportOutBIO = BIO_new(BIO_s_mem());
+    if (!m_transportInBIO || !m_transportOutBIO)
+    {
+        if (m_transportInBIO)
+            BIO_free(m_transportInBIO);
+        if (m_transportOutBIO)
+            BIO_free(m_transportOutBIO);
+        m_transportInBIO = m_transportOutBIO = nullptr;
+        m_sslErrorList.push_back("BIO_new failed.");
+        return false;
+    }
+    // Reading from an empty BIO means "want read" (not EOF):
+    BIO_set_mem_eof_return(m_transportInBIO, -1);
+    SSL_set_bio(m_sslHandler, m_transportInBIO, m_transportOutBIO);
+    return true;
+}
+
+bool Socket_TLS::doHandshake()
+{
+    m_handshakeStartTime = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        int r = m_isServer ? SSL_accept(m_sslHandler) : SSL_connect(m_sslHandler);
+
+        if (m_transport && !flushToTransport())
+            return false;
+
+        if (r == 1)
+        {
+            m_handshakeEndTime = std::chrono::steady_clock::now();
+            return true;
+        }
+
+        if (m_transport && SSL_get_error(m_sslHandler, r) == SSL_ERROR_WANT_READ)
+        {
+            if (feedFromTransport() <= 0)
+                return false;
+            continue;
+        }
+
+        parseErrors();
+        return false;
+    }
+}
+
+std::chrono::steady_clock::time_point Socket_TLS::getHandshakeStartTime() const
+{
+    return m_handshakeStartTime;
+}
+
+std::chrono::steady_clock::time_point Socket_TLS::getHandshakeEndTime() const
+{
+    return m_handshakeEndTime;
+}
+
+void Socket_TLS::setTransport(std::shared_ptr<Socket_Stream> transport)
+{
+    m_transport = transport;
+}
+
+void Socket_TLS::drainOutputBIO()
+{
+    // Should be called with both m_transportWriteMutex and m_sslMutex locked.
+    size_t pending;
+    while ((pending = BIO_ctrl_pending(m_transportOutBIO)) > 0)
+    {
+        size_t offset = m_transportOutBuffer.size();
+        m_transportOutBuffer.resize(offset + pending);
+        int r = BIO_read(m_transportOutBIO, m_transportOutBuffer.data() + offset, static_cast<int>(pending));
+        m_transportOutBuffer.resize(offset + (r > 0 ? r : 0));
+        if (r <= 0)
+            break;
+    }
+}
+
+bool Socket_TLS::flushToTransport()
+{
+    std::unique_lock<std::mutex> lockTransport(m_transportWriteMutex);
+    {
+        std::unique_lock<std::mutex> lockSSL(m_sslMutex);
+        drainOutputBIO();
+    }
+
+    if (m_transportOutBuffer.empty())
+        return true;
+
+    bool r = m_transport->writeFull(m_transportOutBuffer.data(), m_transportOutBuffer.size());
+    m_transportOutBuffer.clear();
+    return r;
+}
+
+ssize_t Socket_TLS::feedFromTransport()
+{
+    // Max TLS record size:
+    char buffer[16 * 1024 + 512];
+    ssize_t r = m_transport->partialRead(buffer, sizeof(buffer));
+
+    std::unique_lock<std::mutex> lockSSL(m_sslMutex);
+    if (r <= 0)
+    {
+        m_lastError = r == 0 ? "Connection closed by peer" : "Transport read error";
+        m_transportReadEnded = true;
+        m_transportFedCondition.notify_all();
+        return r;
+    }
+
+    if (BIO_write(m_transportInBIO, buffer, static_cast<int>(r)) != r)
+    {
+        m_lastError = "BIO_write failed";
+        m_transportReadEnded = true;
+        m_transportFedCondition.notify_all();
+        return -1;
+    }
+    m_transportFedCount++;
+    m_transportFedCondition.notify_all();
+    return r;
+}
+
+ssize_t Socket_TLS::transportPartialRead(void *data, const size_t &datalen)
+{
+    for (;;)
+    {
+        int readBytes, sslError = SSL_ERROR_NONE;
+        size_t pendingOutput;
+        {
+            std::unique_lock<std::mutex> lockSSL(m_sslMutex);
+            readBytes = SSL_read(m_sslHandler, data, static_cast<int>(std::min<size_t>(datalen, std::numeric_limits<int>::max())));
+            if (readBytes <= 0)
+                sslError = SSL_get_error(m_sslHandler, readBytes);
+            pendingOutput = BIO_ctrl_pending(m_transportOutBIO);
+        }
+
+        // Protocol messages generated while reading (eg. key updates, alerts)
+        if (pendingOutput && !flushToTransport())
+            return -1;
+
+        if (readBytes > 0)
+        {
+            m_lastError = "";
+            return readBytes;
+        }
+
+        switch (sslError)
+        {
+        case SSL_ERROR_WANT_READ:
+        {
+            ssize_t r = feedFromTransport();
+            if (r <= 0)
+                return r;
+        }
+            break;
+        case SSL_ERROR_ZERO_RETURN:
+            m_lastError = "Connection closed by peer";
+            return 0;
+        default:
+            parseErrors();
+            m_lastError = std::string("SSL Layer Error");
+            return -1;
+        }
+    }
+}
+
+ssize_t Socket_TLS::transportPartialWrite(const void *data, const size_t &datalen)
+{
+    if ( datalen>static_cast<uint64_t>(std::numeric_limits<int>::max()) )
+    {
+        throw std::runtime_error("Data size exceeds the maximum allowed for partial write.");
+    }
+
+    for (;;)
+    {
+        int sentBytes, sslError = SSL_ERROR_NONE;
+        uint64_t fedCount;
+
+        std::unique_lock<std::mutex> lockTransport(m_transportWriteMutex);
+        {
+            std::unique_lock<std::mutex> lockSSL(m_sslMutex);
+            sentBytes = SSL_write(m_sslHandler, data, static_cast<int>(datalen));
+            if (sentBytes <= 0)
+                sslError = SSL_get_error(m_sslHandler, sentBytes);
+            fedCount = m_transportFedCount;
+            drainOutputBIO();
+        }
+
+        if (!m_transportOutBuffer.empty())
+        {
+            bool r = m_transport->writeFull(m_transportOutBuffer.data(), m_transportOutBuffer.size());
+            m_transportOutBuffer.clear();
+            if (!r)
+            {
+                m_lastError = "Transport write error";
+                return -1;
+            }
+        }
+
+        if (sentBytes > 0)
+        {
+            m_lastError = "";
+            return sentBytes;
+        }
+
+        if (sslError != SSL_ERROR_WANT_READ)
+        {
+            m_lastError = std::string("SSL Layer Error");
+            parseErrors();
+            return -1;
+        }
+
+        // The peer data (eg. renegotiation) should be received by the reader, wait until it feeds the input BIO:
+        lockTransport.unlock();
+
+        std::unique_lock<std::mutex> lockSSL(m_sslMutex);
+        auto isFed = [this, fedCount] { return m_transportFedCount != fedCount || m_transportReadEnded; };
+        unsigned int timeout = m_transport->getReadTimeout();
+        if (timeout == 0)
+            m_transportFedCondition.wait(lockSSL, isFed);
+        else if (!m_transportFedCondition.wait_for(lockSSL, std::chrono::seconds(timeout), isFed))
+        {
+            m_lastError = "Timeout waiting for the peer TLS records";
+            return -1;
+        }
+
+        if (m_transportFedCount == fedCount)
+        {
+            // The reader ended without new records.
+            m_lastError = "Connection closed by peer";
+            return -1;
+        }
+    }
+}
+
 bool Socket_TLS::createTLSContext()
 {
     // create new SSL Context.
@@ -413,8 +653,21 @@ int Socket_TLS::iShutdown(int mode)
     else
     {
 
+        int r;
+        if (m_transport)
+        {
+            {
+                std::unique_lock<std::mutex> lockSSL(m_sslMutex);
+                r = SSL_shutdown (m_sslHandler);
+            }
+            // Send the close_notify alert.
+            flushToTransport();
+        }
+        else
+            r = SSL_shutdown (m_sslHandler);
+
         // Messages from https://www.openssl.org/docs/manmaster/man3/SSL_shutdown.html
-        switch (SSL_shutdown (m_sslHandler))
+        switch (r)
         {
         case 0:
             // The shutdown is not yet finished: the close_notify was sent but the peer did not send it back yet. Call SSL_read() to do a bidirectional shutdown.
@@ -495,6 +748,9 @@ ssize_t Socket_TLS::partialRead(void *data, const size_t &datalen)
 {
     std::unique_lock<std::mutex> lock(mutexRead);
 
+    if (m_transport)
+        return transportPartialRead(data,datalen);
+
     return iPartialRead(data,datalen);
 }
 
@@ -502,6 +758,9 @@ ssize_t Socket_TLS::partialWrite(const void * data, const size_t & datalen)
 {
     std::unique_lock<std::mutex> lock(mutexWrite);
 
+    if (m_transport)
+        return transportPartialWrite(data,datalen);
+
     return iPartialWrite(data,datalen);
 }
 
@@ -634,3 +893,26 @@ ssize_t Socket_TLS::iPartialWrite(
     }
 
 }
+
+void Socket_TLS::setResumeSession(SSL_SESSION *session)
+{
+    if (session)
+        SSL_SESSION_up_ref(session);
+    if (m_resumeSession)
+        SSL_SESSION_free(m_resumeSession);
+    m_resumeSession = session;
+}
+
+SSL_SESSION *Socket_TLS::getSession()
+{
+    if (!m_sslHandler)
+        return nullptr;
+    return SSL_get1_session(m_sslHandler);
+}
+
+bool Socket_TLS::isSessionReused()
+{
+    if (!m_sslHandler)
+        return false;
+    return SSL_session_reused(m_sslHandler) == 1;
+}
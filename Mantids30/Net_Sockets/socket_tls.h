@@ -1,12 +1,15 @@
 #pragma once
 
 #include "socket_tcp.h"
+#include <chrono>
+#include <condition_variable>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unistd.h>
+#include <vector>
 
 #include <openssl/err.h>
 #include <openssl/ssl.h>
@@ -571,6 +574,16 @@ public:
      * @return string with the CN or identity
      */
     std::string getTLSPeerCN() const;
+    /**
+     * @brief getHandshakeStartTime Get when the TLS handshake started (eg. to trace the connection setup)
+     * @return time point (default constructed if the handshake was not done)
+     */
+    std::chrono::steady_clock::time_point getHandshakeStartTime() const;
+    /**
+     * @brief getHandshakeEndTime Get when the TLS handshake was completed
+     * @return time point (default constructed if the handshake was not completed)
+     */
+    std::chrono::steady_clock::time_point getHandshakeEndTime() const;
     /**
      * @brief getCertValidation Get if we are accepting Invalid Server Certificates
      * @return Validation Option (validate, not validate or validate but ignore)
@@ -586,10 +599,40 @@ public:
 
     bool isUsingPSK() const;
 
+    /////////////////////////
+    // TLS over another stream:
+    /**
+     * @brief setTransport Run the TLS protocol over another stream instead of this socket file descriptor (eg. an
+     *                     in-process chain layer). Records are exchanged with the transport using memory BIOs.
+     *                     Should be called before the connection is initialized.
+     * @param transport stream that carries the TLS records.
+     */
+    void setTransport(std::shared_ptr<Socket_Stream> transport);
+
+    /////////////////////////
+    // TLS Session Resumption (client-mode):
+    /**
+     * @brief setResumeSession Set a session from a previous connection to the same server to be resumed on connect
+     *                         (abbreviated handshake). A reference is taken, so the caller keeps its own.
+     * @param session session obtained from getSession() (nullptr to clear)
+     */
+    void setResumeSession(SSL_SESSION * session);
+    /**
+     * @brief getSession Get the current connection session (to be resumed later in another connection).
+     * @return session with a new reference (release it with SSL_SESSION_free), or nullptr if not connected.
+     */
+    SSL_SESSION * getSession();
+    /**
+     * @brief isSessionReused Tell if the handshake resumed the session provided by setResumeSession
+     * @return true if the session was reused.
+     */
+    bool isSessionReused();
+
     ////////////////////////////////////////////////////////////////////
     // Socket Overrides:
     int iShutdown(int mode) override;
     bool isSecure() override;
+    bool isRawStream() override { return false; }
 
 protected:
     /**
@@ -605,7 +648,16 @@ private:
     ssize_t iPartialWrite(const void * data, const size_t & datalen, int ttl = 100);
 
     bool createTLSContext();
+    bool attachSSLHandler();
+    bool doHandshake();
     void parseErrors();
+
+    // Transport mode (memory BIOs):
+    ssize_t transportPartialRead(void * data, const size_t & datalen);
+    ssize_t transportPartialWrite(const void * data, const size_t & datalen);
+    ssize_t feedFromTransport();
+    bool flushToTransport();
+    void drainOutputBIO();
     bool validateTLSConnection(const bool &usingPSK);
 
     Socket_TLS *m_tlsParentConnection;
@@ -613,13 +665,29 @@ private:
     eCertValidationOptions m_certValidationOptions = CERT_X509_VALIDATE;
     SSL *m_sslHandler = nullptr;
     SSL_CTX *m_sslContext = nullptr;
+    SSL_SESSION *m_resumeSession = nullptr;
     SSL_CTX *createServerSSLContext();
     SSL_CTX *createClientSSLContext();
 
     std::list<std::string> m_sslErrorList;
 
     std::mutex mutexRead, mutexWrite;
+
+    std::shared_ptr<Socket_Stream> m_transport;
+    BIO * m_transportInBIO = nullptr;
+    BIO * m_transportOutBIO = nullptr;
+    // The SSL handler is shared by the reader and the writer when using memory BIOs:
+    std::mutex m_sslMutex;
+    // Signaled (with m_sslMutex) when the reader feeds the input BIO or the transport read ends, the writer waits on it for
+    // the peer records it needs (SSL_ERROR_WANT_READ):
+    std::condition_variable m_transportFedCondition;
+    uint64_t m_transportFedCount = 0;
+    bool m_transportReadEnded = false;
+    // Keeps the order of the records sent to the transport (lock before m_sslMutex):
+    std::mutex m_transportWriteMutex;
+    std::vector<char> m_transportOutBuffer;
     bool m_isServer = false;
+    std::chrono::steady_clock::time_point m_handshakeStartTime, m_handshakeEndTime;
 };
 } // namespace Sockets
 } // namespace Network
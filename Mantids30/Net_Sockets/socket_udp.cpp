@@ -16,6 +16,10 @@
 #include <arpa/inet.h>
 #endif
 
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
+
 using namespace Mantids30::Network::Sockets;
 
 
@@ -168,3 +172,216 @@ std::shared_ptr<Socket_UDP::Block> Socket_UDP::readBlock()
     return datagramBlock;
 }
 
+int Socket_UDP::readBatch(DatagramBatch &batch)
+{
+    batch.setSize(0);
+    if (!isActive())
+        return -1;
+
+#ifdef __linux__
+    const size_t controlSize = CMSG_SPACE(sizeof(int));
+    for (size_t i = 0; i < batch.capacity(); i++)
+    {
+        // The kernel updates these ones on every call:
+        struct msghdr & hdr = batch.m_headers[i].msg_hdr;
+        hdr.msg_name = &batch.m_datagrams[i].address;
+        hdr.msg_namelen = sizeof(struct sockaddr_storage);
+        hdr.msg_control = batch.m_control.data() + i * controlSize;
+        hdr.msg_controllen = controlSize;
+        hdr.msg_flags = 0;
+    }
+
+    int r = recvmmsg(m_sockFD, batch.m_headers.data(), batch.capacity(), MSG_WAITFORONE, nullptr);
+    if (r < 0)
+        return -1;
+
+    for (int i = 0; i < r; i++)
+    {
+        struct msghdr & hdr = batch.m_headers[i].msg_hdr;
+        DatagramBatch::Datagram & datagram = batch.m_datagrams[i];
+        datagram.length = batch.m_headers[i].msg_len;
+        datagram.addressLength = hdr.msg_namelen;
+        datagram.segmentSize = 0;
+        datagram.truncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+
+#ifdef UDP_GRO
+        for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+            {
+                int segmentSize = 0;
+                memcpy(&segmentSize, CMSG_DATA(cmsg), sizeof(int));
+                if (segmentSize > 0 && static_cast<size_t>(segmentSize) < datagram.length)
+                    datagram.segmentSize = segmentSize;
+            }
+        }
+#endif
+    }
+    batch.setSize(r);
+    return r;
+#else
+    // One datagram per call (blocking for the first one only).
+    int r = 0;
+    for (size_t i = 0; i < batch.capacity(); i++)
+    {
+        DatagramBatch::Datagram & datagram = batch.m_datagrams[i];
+        datagram.addressLength = sizeof(struct sockaddr_storage);
+        datagram.truncated = false;
+#ifdef _WIN32
+        if (i > 0)
+            break;
+        int len = recvfrom(m_sockFD, (char *) datagram.data, batch.getBufferSize(), 0, (struct sockaddr *) &datagram.address, &datagram.addressLength);
+        if (len < 0 && WSAGetLastError() == WSAEMSGSIZE)
+        {
+            // The buffer is filled with the first part of the datagram:
+            len = batch.getBufferSize();
+            datagram.truncated = true;
+        }
+#else
+        struct iovec iov;
+        iov.iov_base = datagram.data;
+        iov.iov_len = batch.getBufferSize();
+        struct msghdr hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_name = &datagram.address;
+        hdr.msg_namelen = datagram.addressLength;
+        hdr.msg_iov = &iov;
+        hdr.msg_iovlen = 1;
+        ssize_t len = recvmsg(m_sockFD, &hdr, i == 0 ? 0 : MSG_DONTWAIT);
+        datagram.addressLength = hdr.msg_namelen;
+        datagram.truncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+#endif
+        if (len < 0)
+            break;
+        datagram.length = len;
+        datagram.segmentSize = 0;
+        r++;
+    }
+    batch.setSize(r);
+    return r == 0 ? -1 : r;
+#endif
+}
+
+int Socket_UDP::writeBatch(DatagramBatch &batch)
+{
+    if (!isActive())
+        return -1;
+
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        if (batch.m_datagrams[i].addressLength == 0 && !m_addressInfoResolution)
+            return -1;
+    }
+
+#ifdef __linux__
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        DatagramBatch::Datagram & datagram = batch.m_datagrams[i];
+        struct msghdr & hdr = batch.m_headers[i].msg_hdr;
+        batch.m_iovecs[i].iov_len = datagram.length;
+        if (datagram.addressLength)
+        {
+            hdr.msg_name = &datagram.address;
+            hdr.msg_namelen = datagram.addressLength;
+        }
+        else
+        {
+            hdr.msg_name = m_addressInfoResolution->ai_addr;
+            hdr.msg_namelen = m_addressInfoResolution->ai_addrlen;
+        }
+        hdr.msg_control = nullptr;
+        hdr.msg_controllen = 0;
+        hdr.msg_flags = 0;
+    }
+
+    // sendmmsg may send less than requested, continue from there:
+    size_t sent = 0;
+    while (sent < batch.size())
+    {
+        int r = sendmmsg(m_sockFD, batch.m_headers.data() + sent, batch.size() - sent, 0);
+        if (r <= 0)
+            break;
+        sent += r;
+    }
+
+    // Restore the receive buffers length:
+    for (size_t i = 0; i < batch.size(); i++)
+        batch.m_iovecs[i].iov_len = batch.getBufferSize();
+
+    return sent == 0 && batch.size() > 0 ? -1 : static_cast<int>(sent);
+#else
+    int sent = 0;
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        const DatagramBatch::Datagram & datagram = batch.m_datagrams[i];
+        const struct sockaddr * address = datagram.addressLength ? (const struct sockaddr *) &datagram.address : m_addressInfoResolution->ai_addr;
+        socklen_t addressLength = datagram.addressLength ? datagram.addressLength : m_addressInfoResolution->ai_addrlen;
+        if (sendto(m_sockFD, (const char *) datagram.data, datagram.length, 0, address, addressLength) == -1)
+            break;
+        sent++;
+    }
+    return sent == 0 && batch.size() > 0 ? -1 : sent;
+#endif
+}
+
+bool Socket_UDP::setReceiveOffload(bool enabled)
+{
+    if (!isActive())
+        return false;
+#if defined(__linux__) && defined(UDP_GRO)
+    int on = enabled ? 1 : 0;
+    if (setsockopt(m_sockFD, SOL_UDP, UDP_GRO, &on, sizeof(on)) < 0)
+    {
+        m_lastError = "setsockopt(UDP_GRO) failed";
+        return false;
+    }
+    return true;
+#else
+    return !enabled;
+#endif
+}
+
+bool Socket_UDP::writeSegmented(const void *data, const size_t &datalen, const uint16_t &segmentSize)
+{
+    if (!isActive() || !m_addressInfoResolution || segmentSize == 0)
+        return false;
+
+#if defined(__linux__) && defined(UDP_SEGMENT)
+    if (datalen > segmentSize && datalen <= 65507 && (datalen + segmentSize - 1) / segmentSize <= 64)
+    {
+        struct iovec iov;
+        iov.iov_base = const_cast<void *>(data);
+        iov.iov_len = datalen;
+
+        char control[CMSG_SPACE(sizeof(uint16_t))];
+        memset(control, 0, sizeof(control));
+
+        struct msghdr hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_name = m_addressInfoResolution->ai_addr;
+        hdr.msg_namelen = m_addressInfoResolution->ai_addrlen;
+        hdr.msg_iov = &iov;
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = control;
+        hdr.msg_controllen = sizeof(control);
+
+        struct cmsghdr * cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(uint16_t));
+
+        if (sendmsg(m_sockFD, &hdr, 0) == static_cast<ssize_t>(datalen))
+            return true;
+        // Not supported (eg. old kernel or device without checksum offload), send them one by one.
+    }
+#endif
+
+    for (size_t offset = 0; offset < datalen; offset += segmentSize)
+    {
+        size_t len = datalen - offset < segmentSize ? datalen - offset : segmentSize;
+        if (!writeBlock(static_cast<const char *>(data) + offset, len))
+            return false;
+    }
+    return true;
+}
@@ -65,6 +65,40 @@ public:
      */
     std::shared_ptr<Block> readBlock() override;
 
+    /**
+     * Read up to batch.capacity() datagrams with a single system call (recvmmsg).
+     * Blocks until at least one datagram is received, then takes the already queued ones without waiting.
+     * Datagrams are received into the batch slab (no allocations), with the source address on each entry.
+     * Datagrams larger than the batch buffers are cut to the buffer size and flagged as truncated.
+     * @param batch reusable datagram batch, batch.size() is set to the number of datagrams received.
+     * @return number of datagrams received, or -1 on error.
+     */
+    int readBatch(DatagramBatch & batch);
+    /**
+     * Write the first batch.size() datagrams with a single system call (sendmmsg).
+     * Each datagram is sent to its own address if addressLength is not 0, or to the connectFrom() destination.
+     * @param batch datagram batch with the data, length (and optionally address) of each datagram.
+     * @return number of datagrams sent (less than batch.size() if an error occurred in the middle), or -1 on error.
+     */
+    int writeBatch(DatagramBatch & batch);
+    /**
+     * Enable/Disable the UDP receive offload (GRO) when supported by the kernel.
+     * When enabled, consecutive datagrams from the same source can be delivered by readBatch() as one entry with
+     * segmentSize set (use a batch with 65535 bytes buffers).
+     * @return true if the option was applied.
+     */
+    bool setReceiveOffload(bool enabled);
+    /**
+     * Write a buffer as consecutive datagrams of segmentSize bytes (the last one can be shorter) to the connectFrom()
+     * destination, using the UDP segmentation offload (GSO) with a single system call when supported by the kernel,
+     * or one sendto() per datagram otherwise.
+     * @param data buffer with the datagrams content (up to 64 segments/65507 bytes with GSO).
+     * @param datalen buffer length in bytes.
+     * @param segmentSize datagram size.
+     * @return true if every datagram was sent.
+     */
+    bool writeSegmented(const void * data, const size_t & datalen, const uint16_t & segmentSize);
+
     /**
      * Minimum read size allowed on read funcion.
      */
@@ -9,6 +9,10 @@
 
 #include <sys/un.h>
 #include <sys/socket.h>
+#include <arpa/inet.h>
+#include <errno.h>
+
+#include <algorithm>
 
 #include <Mantids30/Helpers/mem.h>
 
@@ -124,7 +128,7 @@ std::shared_ptr<Sockets::Socket_Stream> Socket_UNIX::acceptConnection()
     
     if ((sdconn = accept(m_sockFD, nullptr, nullptr)) >= 0)
     {
-        cursocket = std::make_shared<Socket_Stream>();
+        cursocket = std::make_shared<Socket_UNIX>();
         // Set the proper socket-
         cursocket->setSocketFD(sdconn);
     }
@@ -138,4 +142,128 @@ std::shared_ptr<Sockets::Socket_Stream> Socket_UNIX::acceptConnection()
     return cursocket;
 }
 
+bool Socket_UNIX::sendFileDescriptors(const std::string &payload, const std::vector<int> &fds)
+{
+    // SCM_MAX_FD
+    if (fds.size() > 253)
+    {
+        m_lastError = "too many file descriptors";
+        return false;
+    }
+
+    // The descriptors travel with the payload size (the first bytes), then the payload follows:
+    uint32_t payloadSize = htonl(static_cast<uint32_t>(payload.size()));
+
+    struct iovec iov;
+    iov.iov_base = &payloadSize;
+    iov.iov_len = sizeof(payloadSize);
+
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * std::max<size_t>(fds.size(), 1)), 0);
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    if (!fds.empty())
+    {
+        msg.msg_control = control.data();
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+    }
+
+    ssize_t sent;
+    while ((sent = sendmsg(m_sockFD, &msg, MSG_NOSIGNAL)) == -1 && errno == EINTR)
+    {
+    }
+
+    if (sent == -1)
+    {
+        m_lastError = "sendmsg() failed";
+        return false;
+    }
+
+    // Remaining bytes of the size (unlikely) and the payload:
+    if (static_cast<size_t>(sent) < sizeof(payloadSize) && !writeFull(reinterpret_cast<char *>(&payloadSize) + sent, sizeof(payloadSize) - sent))
+        return false;
+
+    return payload.empty() || writeFull(payload.data(), payload.size());
+}
+
+bool Socket_UNIX::receiveFileDescriptors(std::string *payload, std::vector<int> *fds, const uint32_t &maxPayloadSize)
+{
+    uint32_t payloadSize = 0;
+
+    struct iovec iov;
+    iov.iov_base = &payloadSize;
+    iov.iov_len = sizeof(payloadSize);
+
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * 253), 0);
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    ssize_t received;
+    while ((received = recvmsg(m_sockFD, &msg, MSG_CMSG_CLOEXEC)) == -1 && errno == EINTR)
+    {
+    }
+
+    if (received <= 0)
+    {
+        m_lastError = "recvmsg() failed";
+        return false;
+    }
+
+    // Take the received descriptors first (so they are not leaked on errors):
+    std::vector<int> receivedFDs;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+        {
+            size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            size_t offset = receivedFDs.size();
+            receivedFDs.resize(offset + count);
+            memcpy(receivedFDs.data() + offset, CMSG_DATA(cmsg), count * sizeof(int));
+        }
+    }
+
+    auto fail = [&receivedFDs](){
+        for (int fd : receivedFDs)
+            close(fd);
+        return false;
+    };
+
+    if (msg.msg_flags & MSG_CTRUNC)
+    {
+        m_lastError = "file descriptors truncated";
+        return fail();
+    }
+
+    if (static_cast<size_t>(received) < sizeof(payloadSize) && !readFull(reinterpret_cast<char *>(&payloadSize) + received, sizeof(payloadSize) - received))
+        return fail();
+
+    payloadSize = ntohl(payloadSize);
+    if (payloadSize > maxPayloadSize)
+    {
+        m_lastError = "payload too large";
+        return fail();
+    }
+
+    payload->resize(payloadSize);
+    if (payloadSize && !readFull(payload->data(), payloadSize))
+        return fail();
+
+    fds->insert(fds->end(), receivedFDs.begin(), receivedFDs.end());
+    return true;
+}
+
 #endif
@@ -2,6 +2,8 @@
 
 #ifndef _WIN32
 #include "socket_stream.h"
+#include <string>
+#include <vector>
 
 namespace Mantids30 { namespace Network { namespace Sockets {
 
@@ -65,6 +67,29 @@ public:
      * @return A shared pointer to a new Socket_UNIX object if a connection is successfully accepted, or nullptr if an error occurs.
      */
     std::shared_ptr<Socket_Stream> acceptConnection() override;
+
+    /**
+     * @brief Send file descriptors (SCM_RIGHTS) to the connected peer together with a payload.
+     *
+     * The receiving process gets duplicates of the descriptors (referring to the same open files/sockets).
+     *
+     * @param payload Data sent with the descriptors (eg. the descriptors description).
+     * @param fds File descriptors to be sent (up to 253).
+     * @return True if the payload and the descriptors were sent.
+     */
+    bool sendFileDescriptors(const std::string& payload, const std::vector<int>& fds);
+
+    /**
+     * @brief Receive file descriptors sent by the peer with sendFileDescriptors.
+     *
+     * @param payload Output payload.
+     * @param fds Output file descriptors (owned by the caller, created with close-on-exec).
+     * @param maxPayloadSize Maximum accepted payload size in bytes.
+     * @return True if the payload and the descriptors were received.
+     */
+    bool receiveFileDescriptors(std::string* payload, std::vector<int>* fds, const uint32_t& maxPayloadSize = 65536);
+
+    bool isRawStream() override { return true; }
 };
 
 /**
@@ -48,6 +48,18 @@ bool Bridge::start(bool _autoDeleteStreamPipeOnExit, bool detach)
 
     m_autoDeleteStreamPipeOnExit = _autoDeleteStreamPipeOnExit;
 
+    if (canUseSplice())
+    {
+        // No threads for this bridge: the reactor serves it.
+        m_spliceDetached = true;
+        m_spliceFinished = false;
+        m_isUsingSplice = true;
+        // Warning: the bridge may be already finished (and deleted) when addBridge returns.
+        if (getSpliceReactor()->addBridge(this))
+            return true;
+        m_isUsingSplice = false;
+    }
+
     m_pipeThreadP = std::thread(pipeThread, this);
 
     if (m_autoDeleteStreamPipeOnExit || detach)
@@ -77,7 +89,10 @@ void Bridge::sendPing()
 
 int Bridge::wait()
 {
-    m_pipeThreadP.join();
+    if (m_isUsingSplice)
+        waitSplice();
+    else
+        m_pipeThreadP.join();
     return m_finishingPeer;
 }
 
@@ -86,10 +101,27 @@ int Bridge::process()
     if (!m_peers[SIDE_FORWARD] || !m_peers[SIDE_BACKWARD])
         return -1;
 
+    if (canUseSplice())
+    {
+        m_spliceDetached = false;
+        m_spliceFinished = false;
+        m_isUsingSplice = true;
+        if (getSpliceReactor()->addBridge(this))
+        {
+            waitSplice();
+            return m_finishingPeer;
+        }
+        m_isUsingSplice = false;
+    }
+
     if (!m_bridgeThreadPrc)
     {
         m_bridgeThreadPrc = new Bridge_Thread();
         m_autoDeleteCustomPipeOnClose = true;
+
+        // TLS peers: bigger blocks (fewer records/syscalls per byte).
+        if (m_transmitionMode == TRANSMITION_MODE_STREAM && (m_peers[SIDE_FORWARD]->isSecure() || m_peers[SIDE_BACKWARD]->isSecure()))
+            m_bridgeThreadPrc->setBlockSize(m_secureBlockSize);
     }
 
     m_bridgeThreadPrc->setSocketEndpoints(m_peers[SIDE_BACKWARD],m_peers[SIDE_FORWARD], m_transmitionMode == TRANSMITION_MODE_CHUNKSANDPING);
@@ -146,7 +178,6 @@ bool Bridge::processPeer(Side currentSide)
 
     Side oppositeSide = currentSide==SIDE_FORWARD?SIDE_BACKWARD:SIDE_FORWARD;
 
-    std::atomic<size_t> * bytesCounter = currentSide==SIDE_FORWARD?&m_sentBytes:&m_recvBytes;
 
     int dataRecv=1;
     while ( dataRecv > 0 )
@@ -159,7 +190,7 @@ bool Bridge::processPeer(Side currentSide)
         // -3: ping
         if (dataRecv>0)
         {
-            *bytesCounter+=dataRecv;
+            m_stats[currentSide].addTransfer(dataRecv, m_bridgeThreadPrc->getLastWriteLatencyUS(currentSide));
         }
         else if ( (dataRecv==-1 || dataRecv==0 ) && m_shutdownRemotePeerOnFinish )
         {
@@ -210,14 +241,19 @@ void Bridge::setToCloseRemotePeer(bool value)
     m_closeRemotePeerOnFinish = value;
 }
 
+const Bridge_Stats &Bridge::getStats(Side direction) const
+{
+    return m_stats[direction==SIDE_FORWARD?SIDE_FORWARD:SIDE_BACKWARD];
+}
+
 size_t Bridge::getSentBytes() const
 {
-    return m_sentBytes;
+    return m_stats[SIDE_FORWARD].getBytes();
 }
 
 size_t Bridge::getRecvBytes() const
 {
-    return m_recvBytes;
+    return m_stats[SIDE_BACKWARD].getBytes();
 }
 
 bool Bridge::isAutoDeleteStreamPipeOnThreadExit() const
@@ -263,3 +299,85 @@ int Bridge::getLastError(Side side)
         return -1;
     return m_lastError[side];
 }
+
+void Bridge::setUseSplice(bool value)
+{
+    m_useSplice = value;
+}
+
+void Bridge::setSpliceReactor(std::shared_ptr<Bridge_SpliceReactor> reactor)
+{
+    m_spliceReactor = reactor;
+}
+
+bool Bridge::isUsingSplice() const
+{
+    return m_isUsingSplice;
+}
+
+void Bridge::setSecureBlockSize(uint32_t value)
+{
+    m_secureBlockSize = value;
+}
+
+bool Bridge::canUseSplice()
+{
+    // Custom pipe processors and chunked mode transform the data, so they need the threaded mode.
+    return m_useSplice
+           && Bridge_SpliceReactor::isAvailable()
+           && m_transmitionMode == TRANSMITION_MODE_STREAM
+           && !m_bridgeThreadPrc
+           && m_peers[SIDE_FORWARD] && m_peers[SIDE_BACKWARD]
+           && m_peers[SIDE_FORWARD]->isRawStream() && m_peers[SIDE_BACKWARD]->isRawStream();
+}
+
+std::shared_ptr<Bridge_SpliceReactor> Bridge::getSpliceReactor()
+{
+    if (!m_spliceReactor)
+        m_spliceReactor = Bridge_SpliceReactor::getDefaultReactor();
+    return m_spliceReactor;
+}
+
+void Bridge::spliceFinished(int finishingPeer, const int lastError[2])
+{
+    if (finishingPeer == SIDE_FORWARD || finishingPeer == SIDE_BACKWARD)
+    {
+        m_lastError[SIDE_FORWARD] = lastError[SIDE_FORWARD];
+        m_lastError[SIDE_BACKWARD] = lastError[SIDE_BACKWARD];
+    }
+    m_finishingPeer = finishingPeer;
+
+    if (m_shutdownRemotePeerOnFinish)
+    {
+        m_peers[SIDE_FORWARD]->shutdownSocket();
+        m_peers[SIDE_BACKWARD]->shutdownSocket();
+    }
+
+    if (m_closeRemotePeerOnFinish)
+    {
+        m_peers[SIDE_FORWARD]->closeSocket();
+        m_peers[SIDE_BACKWARD]->closeSocket();
+    }
+    else
+    {
+        // Give them back as they were received.
+        m_peers[SIDE_FORWARD]->setBlockingMode(true);
+        m_peers[SIDE_BACKWARD]->setBlockingMode(true);
+    }
+
+    if (m_spliceDetached && m_autoDeleteStreamPipeOnExit)
+    {
+        delete this;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_spliceMutex);
+    m_spliceFinished = true;
+    m_spliceCond.notify_all();
+}
+
+void Bridge::waitSplice()
+{
+    std::unique_lock<std::mutex> lock(m_spliceMutex);
+    m_spliceCond.wait(lock, [this]() { return m_spliceFinished; });
+}
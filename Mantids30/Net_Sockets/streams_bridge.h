@@ -2,6 +2,8 @@
 
 #include "socket_stream.h"
 #include "streams_bridge_thread.h"
+#include "streams_bridge_stats.h"
+#include "streams_bridge_splice.h"
 
 #include <cstdint>
 #include <stdint.h>
@@ -16,9 +18,15 @@ namespace Mantids30 { namespace Network { namespace Sockets { namespace NetStrea
 
 /**
  * @brief The Bridge class connect two pipe stream sockets.
+ *
+ * Each direction is served by its own thread. With setUseSplice(), in TRANSMITION_MODE_STREAM and when both peers are
+ * plain stream sockets (TCP/UNIX), the data is forwarded with splice() by a Bridge_SpliceReactor instead (no user
+ * space copies, and no dedicated threads per bridge). Otherwise (eg. TLS peers, chunked mode or a custom pipe
+ * processor) it falls back to the threaded mode.
  */
 class Bridge
 {
+    friend class Bridge_SpliceReactor;
 public:
     enum TransmitionMode {
         TRANSMITION_MODE_STREAM=0,
@@ -79,6 +87,12 @@ public:
      * @param value true for close the remote peer (default), false for not.
      */
     void setToCloseRemotePeer(bool value = true);
+    /**
+     * @brief getStats Get the transfer counters (bytes, bytes per second and the latency of the destination peer).
+     * @param direction SIDE_FORWARD: from peer 0 to peer 1, SIDE_BACKWARD: from peer 1 to peer 0.
+     * @return counters.
+     */
+    const Bridge_Stats & getStats(Side direction) const;
     /**
      * @brief getSentBytes Get bytes transmitted from peer 0 to peer 1.
      * @return bytes transmitted.
@@ -137,7 +151,42 @@ public:
     uint32_t getPingEveryMS() const;
     void setPingEveryMS(uint32_t newPingEveryMS);
 
+    /**
+     * @brief setUseSplice Enable/disable the splice() forwarding for plain stream peers (default: disabled).
+     *                     In splice mode, the bridge ends after the smallest read timeout of its peers without traffic
+     *                     in any direction (instead of a read timeout in one direction), and if the peers are not
+     *                     closed on finish, they are given back in blocking mode.
+     * @param value true to use splice when possible.
+     */
+    void setUseSplice(bool value = true);
+    /**
+     * @brief setSpliceReactor Set the reactor that will forward this bridge in splice mode.
+     * @param reactor reactor (nullptr: use Bridge_SpliceReactor::getDefaultReactor()).
+     */
+    void setSpliceReactor(std::shared_ptr<Bridge_SpliceReactor> reactor);
+    /**
+     * @brief isUsingSplice Tell if this bridge was started in splice mode.
+     * @return true if forwarded by the splice reactor.
+     */
+    bool isUsingSplice() const;
+    /**
+     * @brief setSecureBlockSize Set the block size used in stream mode when any peer is TLS (default: 128KB).
+     *                           Bigger blocks mean fewer (and bigger) TLS writes per transferred byte.
+     * @param value block size in bytes.
+     */
+    void setSecureBlockSize(uint32_t value);
+
 private:
+    bool canUseSplice();
+    std::shared_ptr<Bridge_SpliceReactor> getSpliceReactor();
+    /**
+     * @brief spliceFinished (called by the splice reactor) the forwarding ended.
+     * @param finishingPeer peer that closed/failed (-1: aborted, or both directions closed by themselves).
+     * @param lastError last error of each peer (0: closed, -1: failed).
+     */
+    void spliceFinished(int finishingPeer, const int lastError[2]);
+    void waitSplice();
+
     static void remotePeerThread(Bridge * stp);
     static void pingThread(Bridge * stp);
     static void pipeThread(Bridge * stp);
@@ -147,7 +196,8 @@ private:
     std::shared_ptr<Sockets::Socket_Stream>  m_peers[2] = {nullptr, nullptr};
     TransmitionMode m_transmitionMode = TRANSMITION_MODE_STREAM;
 
-    std::atomic<size_t> m_sentBytes{0}, m_recvBytes{0};
+    // Indexed by Side (direction):
+    Bridge_Stats m_stats[2];
     std::atomic<int> m_finishingPeer{-1};
     std::atomic<bool> m_shutdownRemotePeerOnFinish{false};
     std::atomic<bool> m_closeRemotePeerOnFinish{false};
@@ -168,6 +218,17 @@ private:
     bool m_autoDeleteCustomPipeOnClose = false;
 
     std::thread m_pipeThreadP;
+
+    // Splice mode:
+    bool m_useSplice = false;
+    std::atomic<bool> m_isUsingSplice{false};
+    bool m_spliceDetached = false;
+    bool m_spliceFinished = false;
+    std::shared_ptr<Bridge_SpliceReactor> m_spliceReactor;
+    std::mutex m_spliceMutex;
+    std::condition_variable m_spliceCond;
+
+    uint32_t m_secureBlockSize = 128*1024;
 };
 
 }}}}
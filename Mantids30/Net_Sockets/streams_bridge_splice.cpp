@@ -0,0 +1,410 @@
+#include "streams_bridge_splice.h"
+#include "streams_bridge.h"
+
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace Mantids30::Network::Sockets;
+using namespace NetStreams;
+
+#define SPLICE_REACTOR_MAX_EVENTS 128
+#define SPLICE_REACTOR_TICK_MS 1000
+
+struct Bridge_SpliceReactor::Entry
+{
+    struct Direction
+    {
+        int srcFD = -1;
+        int dstFD = -1;
+        int pipeFD[2] = {-1, -1};
+        size_t pipeCapacity = 0;
+        size_t inPipe = 0;
+        bool eof = false;
+        // Finished (half closed) while the other direction is still being forwarded:
+        bool done = false;
+        uint64_t pendingSinceUS = 0;
+        Bridge_Stats * stats = nullptr;
+    };
+
+    ~Entry()
+    {
+#ifdef __linux__
+        for (auto & d : directions)
+        {
+            if (d.pipeFD[0] >= 0)
+                ::close(d.pipeFD[0]);
+            if (d.pipeFD[1] >= 0)
+                ::close(d.pipeFD[1]);
+        }
+#endif
+    }
+
+    Bridge * bridge = nullptr;
+    // Indexed by Side: SIDE_FORWARD moves peer 0 -> peer 1, SIDE_BACKWARD moves peer 1 -> peer 0.
+    Direction directions[2];
+    uint64_t lastActivityUS = 0;
+    uint64_t idleTimeoutUS = 0;
+
+    bool finished = false;
+    int finishingPeer = -1;
+    // Indexed by peer:
+    int lastError[2] = {0, 0};
+};
+
+struct Bridge_SpliceReactor::Loop
+{
+    int epollFD = -1;
+    int wakeFD = -1;
+    std::thread thread;
+    std::atomic<bool> running{true};
+
+    // Owned by the loop thread:
+    std::unordered_set<Entry *> entries;
+
+    // New entries, registered by the loop thread:
+    std::mutex pendingMutex;
+    std::list<Entry *> pendingEntries;
+};
+
+Bridge_SpliceReactor::Bridge_SpliceReactor(const size_t &threads)
+{
+#ifdef __linux__
+    for (size_t i = 0; i < (threads ? threads : 1); i++)
+    {
+        Loop * loop = new Loop;
+        loop->epollFD = epoll_create1(EPOLL_CLOEXEC);
+        loop->wakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (loop->epollFD < 0 || loop->wakeFD < 0)
+        {
+            if (loop->epollFD >= 0)
+                ::close(loop->epollFD);
+            if (loop->wakeFD >= 0)
+                ::close(loop->wakeFD);
+            delete loop;
+            break;
+        }
+
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr; // the wake-up descriptor.
+        epoll_ctl(loop->epollFD, EPOLL_CTL_ADD, loop->wakeFD, &ev);
+
+        loop->thread = std::thread(loopThread, this, loop);
+        m_loops.push_back(loop);
+    }
+#endif
+}
+
+Bridge_SpliceReactor::~Bridge_SpliceReactor()
+{
+#ifdef __linux__
+    for (Loop * loop : m_loops)
+    {
+        loop->running = false;
+        uint64_t one = 1;
+        if (write(loop->wakeFD, &one, sizeof(one))) {}
+    }
+    for (Loop * loop : m_loops)
+    {
+        loop->thread.join();
+        ::close(loop->epollFD);
+        ::close(loop->wakeFD);
+        delete loop;
+    }
+#endif
+}
+
+std::shared_ptr<Bridge_SpliceReactor> Bridge_SpliceReactor::getDefaultReactor()
+{
+    static std::shared_ptr<Bridge_SpliceReactor> defaultReactor = std::make_shared<Bridge_SpliceReactor>(1);
+    return defaultReactor;
+}
+
+bool Bridge_SpliceReactor::isAvailable()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Bridge_SpliceReactor::setPipeSize(const size_t &value)
+{
+    m_pipeSize = value;
+}
+
+bool Bridge_SpliceReactor::addBridge(Bridge *bridge)
+{
+#ifdef __linux__
+    if (m_loops.empty() || !bridge->m_peers[0] || !bridge->m_peers[1])
+        return false;
+
+    int fds[2] = { bridge->m_peers[0]->getSocketFD(), bridge->m_peers[1]->getSocketFD() };
+    if (fds[0] < 0 || fds[1] < 0)
+        return false;
+
+    Entry * entry = new Entry;
+    entry->bridge = bridge;
+
+    for (int side : {SIDE_FORWARD, SIDE_BACKWARD})
+    {
+        Entry::Direction & d = entry->directions[side];
+        d.srcFD = side == SIDE_FORWARD ? fds[0] : fds[1];
+        d.dstFD = side == SIDE_FORWARD ? fds[1] : fds[0];
+        d.stats = &bridge->m_stats[side];
+
+        if (pipe2(d.pipeFD, O_NONBLOCK | O_CLOEXEC) != 0)
+        {
+            delete entry;
+            return false;
+        }
+        // Best effort: the default pipe (64KB) is used if the requested size is not allowed.
+        fcntl(d.pipeFD[1], F_SETPIPE_SZ, static_cast<int>(m_pipeSize.load()));
+        int capacity = fcntl(d.pipeFD[1], F_GETPIPE_SZ);
+        d.pipeCapacity = capacity > 0 ? static_cast<size_t>(capacity) : 65536;
+    }
+
+    // Idle connections are dropped after the (smallest) read timeout, as the threaded mode does.
+    unsigned int timeouts[2] = { bridge->m_peers[0]->getReadTimeout(), bridge->m_peers[1]->getReadTimeout() };
+    unsigned int idleTimeout = (timeouts[0] && (!timeouts[1] || timeouts[0] < timeouts[1])) ? timeouts[0] : timeouts[1];
+    entry->idleTimeoutUS = static_cast<uint64_t>(idleTimeout) * 1000000;
+    entry->lastActivityUS = Bridge_Stats::getMonotonicUS();
+
+    bridge->m_peers[0]->setBlockingMode(false);
+    bridge->m_peers[1]->setBlockingMode(false);
+
+    m_activeBridges++;
+
+    Loop * loop = m_loops[m_nextLoop++ % m_loops.size()];
+    {
+        std::unique_lock<std::mutex> lock(loop->pendingMutex);
+        loop->pendingEntries.push_back(entry);
+    }
+    uint64_t one = 1;
+    if (write(loop->wakeFD, &one, sizeof(one))) {}
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+int Bridge_SpliceReactor::pumpDirection(Entry *entry, const int &side)
+{
+#ifdef __linux__
+    Entry::Direction & d = entry->directions[side];
+    uint64_t & lastActivityUS = entry->lastActivityUS;
+    for (;;)
+    {
+        // Deliver the pending data first, so a read is only attempted with an empty pipe.
+        while (d.inPipe)
+        {
+            ssize_t n = splice(d.pipeFD[0], nullptr, d.dstFD, nullptr, d.inPipe, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n > 0)
+            {
+                uint64_t now = Bridge_Stats::getMonotonicUS();
+                d.stats->addTransfer(static_cast<size_t>(n), now - d.pendingSinceUS);
+                d.inPipe -= static_cast<size_t>(n);
+                d.pendingSinceUS = d.inPipe ? now : 0;
+                lastActivityUS = now;
+            }
+            else if (n < 0 && errno == EINTR)
+                continue;
+            else if (n < 0 && errno == EAGAIN)
+                return 1;
+            else
+                return -2;
+        }
+
+        if (d.eof)
+            return 0;
+
+        ssize_t n = splice(d.srcFD, nullptr, d.pipeFD[1], nullptr, d.pipeCapacity, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0)
+        {
+            d.inPipe = static_cast<size_t>(n);
+            d.pendingSinceUS = lastActivityUS = Bridge_Stats::getMonotonicUS();
+        }
+        else if (n == 0)
+            d.eof = true;
+        else if (errno == EINTR)
+            continue;
+        else if (errno == EAGAIN)
+            return 1;
+        else
+            return -1;
+    }
+#else
+    return -1;
+#endif
+}
+
+bool Bridge_SpliceReactor::pumpEntry(Entry *entry)
+{
+#ifdef __linux__
+    for (int side : {SIDE_FORWARD, SIDE_BACKWARD})
+    {
+        Entry::Direction & d = entry->directions[side];
+        if (d.done)
+            continue;
+
+        int srcPeer = side == SIDE_FORWARD ? 0 : 1;
+        int dstPeer = 1 - srcPeer;
+        int r = pumpDirection(entry, side);
+        if (r == 1)
+            continue;
+
+        if (!entry->bridge->m_shutdownRemotePeerOnFinish)
+        {
+            // As the threaded mode: only this direction ends (the end of the stream is passed to the destination),
+            // the other one is forwarded until its own end.
+            d.done = true;
+            if (r != -2)
+                shutdown(d.dstFD, SHUT_WR);
+            continue;
+        }
+
+        // As the threaded mode: the source end shuts down the destination, and then the destination reader ends
+        // too (being the finishing peer). A write error is reported by the destination reader.
+        if (r != -2)
+            entry->lastError[srcPeer] = r;
+        entry->lastError[dstPeer] = r == -2 ? -1 : 0;
+        entry->finishingPeer = dstPeer;
+        return false;
+    }
+
+    // Both directions ended by themselves (the finishing peer is not set, as in the threaded mode).
+    if (entry->directions[SIDE_FORWARD].done && entry->directions[SIDE_BACKWARD].done)
+        return false;
+#endif
+    return true;
+}
+
+void Bridge_SpliceReactor::finishEntry(Loop *loop, Entry *entry)
+{
+#ifdef __linux__
+    epoll_ctl(loop->epollFD, EPOLL_CTL_DEL, entry->directions[SIDE_FORWARD].srcFD, nullptr);
+    epoll_ctl(loop->epollFD, EPOLL_CTL_DEL, entry->directions[SIDE_BACKWARD].srcFD, nullptr);
+#endif
+    loop->entries.erase(entry);
+    m_activeBridges--;
+
+    Bridge * bridge = entry->bridge;
+    int finishingPeer = entry->finishingPeer;
+    int lastError[2] = { entry->lastError[0], entry->lastError[1] };
+    delete entry;
+
+    // May delete the bridge.
+    bridge->spliceFinished(finishingPeer, lastError);
+}
+
+void Bridge_SpliceReactor::checkIdleEntries(Loop *loop)
+{
+    uint64_t now = Bridge_Stats::getMonotonicUS();
+    std::list<Entry *> expired;
+    for (Entry * entry : loop->entries)
+    {
+        if (entry->idleTimeoutUS && now - entry->lastActivityUS > entry->idleTimeoutUS)
+        {
+            // Reported as a read failure of peer 0 (the first reader of the threaded mode).
+            entry->finishingPeer = 0;
+            entry->lastError[0] = -1;
+            expired.push_back(entry);
+        }
+    }
+    for (Entry * entry : expired)
+        finishEntry(loop, entry);
+}
+
+void Bridge_SpliceReactor::loopThread(Bridge_SpliceReactor *reactor, Loop *loop)
+{
+#ifdef __linux__
+    epoll_event events[SPLICE_REACTOR_MAX_EVENTS];
+    uint64_t lastIdleCheck = Bridge_Stats::getMonotonicUS();
+
+    while (loop->running)
+    {
+        int n = epoll_wait(loop->epollFD, events, SPLICE_REACTOR_MAX_EVENTS, SPLICE_REACTOR_TICK_MS);
+
+        // Entries are released after the whole batch (both peers of an entry may be in it).
+        std::list<Entry *> finished;
+
+        for (int i = 0; i < n; i++)
+        {
+            Entry * entry = static_cast<Entry *>(events[i].data.ptr);
+            if (!entry)
+            {
+                uint64_t counter;
+                if (read(loop->wakeFD, &counter, sizeof(counter))) {}
+
+                std::list<Entry *> newEntries;
+                {
+                    std::unique_lock<std::mutex> lock(loop->pendingMutex);
+                    newEntries.swap(loop->pendingEntries);
+                }
+                for (Entry * newEntry : newEntries)
+                {
+                    loop->entries.insert(newEntry);
+
+                    // Edge triggered: adding a ready descriptor reports it immediately.
+                    epoll_event ev = {};
+                    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+                    ev.data.ptr = newEntry;
+                    if ( epoll_ctl(loop->epollFD, EPOLL_CTL_ADD, newEntry->directions[SIDE_FORWARD].srcFD, &ev) != 0
+                         || epoll_ctl(loop->epollFD, EPOLL_CTL_ADD, newEntry->directions[SIDE_BACKWARD].srcFD, &ev) != 0 )
+                    {
+                        newEntry->finished = true;
+                        newEntry->finishingPeer = 0;
+                        newEntry->lastError[0] = -1;
+                        finished.push_back(newEntry);
+                    }
+                }
+                continue;
+            }
+
+            if (!entry->finished && !reactor->pumpEntry(entry))
+            {
+                entry->finished = true;
+                finished.push_back(entry);
+            }
+        }
+
+        for (Entry * entry : finished)
+            reactor->finishEntry(loop, entry);
+
+        uint64_t now = Bridge_Stats::getMonotonicUS();
+        if (now - lastIdleCheck >= SPLICE_REACTOR_TICK_MS * 1000)
+        {
+            reactor->checkIdleEntries(loop);
+            lastIdleCheck = now;
+        }
+    }
+
+    // Reactor destroyed: finish everything as failed.
+    {
+        std::unique_lock<std::mutex> lock(loop->pendingMutex);
+        for (Entry * entry : loop->pendingEntries)
+            loop->entries.insert(entry);
+        loop->pendingEntries.clear();
+    }
+    std::list<Entry *> remaining(loop->entries.begin(), loop->entries.end());
+    for (Entry * entry : remaining)
+    {
+        entry->finishingPeer = -1;
+        reactor->finishEntry(loop, entry);
+    }
+#endif
+}
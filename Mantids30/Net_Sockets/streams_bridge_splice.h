@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace Mantids30 { namespace Network { namespace Sockets { namespace NetStreams {
+
+class Bridge;
+
+/**
+ * @brief The Bridge_SpliceReactor class forwards plain (TCP/UNIX) bridges inside the kernel.
+ *
+ * Each bridge direction owns a pipe: data is moved socket -> pipe -> socket with splice(2), so it never reaches user
+ * space. The sockets are switched to non-blocking mode and registered (edge triggered) in an epoll set, so every
+ * reactor thread serves any number of bridges instead of the two threads per bridge of the threaded mode.
+ *
+ * Bridges are distributed round-robin between the reactor threads. A bridge finishes when one peer closes (after
+ * delivering its pending data), on any socket error, or after being idle for the read timeout of its peers.
+ *
+ * Only available on Linux (isAvailable()).
+ */
+class Bridge_SpliceReactor
+{
+public:
+    /**
+     * @brief Bridge_SpliceReactor Creates the reactor.
+     * @param threads number of epoll threads.
+     */
+    Bridge_SpliceReactor(const size_t & threads = 1);
+    /**
+     * @brief ~Bridge_SpliceReactor stops the threads, the bridges still running are finished as failed.
+     */
+    ~Bridge_SpliceReactor();
+
+    /**
+     * @brief getDefaultReactor Get the process-wide reactor (one thread, created on the first use).
+     */
+    static std::shared_ptr<Bridge_SpliceReactor> getDefaultReactor();
+    /**
+     * @brief isAvailable Tell if splice/epoll forwarding is supported on this platform.
+     */
+    static bool isAvailable();
+
+    /**
+     * @brief addBridge Starts forwarding a bridge (both peers should be connected raw stream sockets).
+     *                  Bridge::spliceFinished is called from the reactor thread when it ends.
+     * @param bridge bridge to be forwarded.
+     * @return false if the bridge could not be registered (eg. out of file descriptors), the bridge remains untouched.
+     */
+    bool addBridge(Bridge * bridge);
+
+    /**
+     * @brief getActiveBridges Get the number of bridges being forwarded.
+     */
+    size_t getActiveBridges() const { return m_activeBridges; }
+
+    /**
+     * @brief setPipeSize Set the kernel buffer size used per direction (for new bridges).
+     * @param value size in bytes (default 1MB, capped by /proc/sys/fs/pipe-max-size for unprivileged processes).
+     */
+    void setPipeSize(const size_t & value);
+    size_t getPipeSize() const { return m_pipeSize; }
+
+private:
+    struct Entry;
+    struct Loop;
+
+    static void loopThread(Bridge_SpliceReactor * reactor, Loop * loop);
+
+    /**
+     * @brief pumpDirection Moves everything available from the source to the destination of one direction.
+     * @return 1: waiting for the sockets, 0: source closed (and everything was delivered), -1: read error, -2: write error.
+     */
+    static int pumpDirection(Entry * entry, const int & side);
+    bool pumpEntry(Entry * entry);
+    void finishEntry(Loop * loop, Entry * entry);
+    void checkIdleEntries(Loop * loop);
+
+    std::vector<Loop *> m_loops;
+    std::atomic<size_t> m_nextLoop{0};
+    std::atomic<size_t> m_activeBridges{0};
+    std::atomic<size_t> m_pipeSize{1024*1024};
+};
+
+}}}}
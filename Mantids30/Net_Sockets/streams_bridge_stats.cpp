@@ -0,0 +1,48 @@
+#include "streams_bridge_stats.h"
+
+#include <chrono>
+
+using namespace Mantids30::Network::Sockets::NetStreams;
+
+void Bridge_Stats::addTransfer(const size_t &bytes, const uint64_t &latencyUS)
+{
+    uint64_t now = getMonotonicUS();
+
+    m_bytes += bytes;
+    m_transfers++;
+    m_totalLatencyUS += latencyUS;
+    if (latencyUS > m_maxLatencyUS)
+        m_maxLatencyUS = latencyUS;
+
+    if (!m_windowStartUS)
+        m_windowStartUS = now;
+
+    m_windowBytes += bytes;
+    if (now - m_windowStartUS >= 1000000)
+    {
+        m_bytesPerSecond = (m_windowBytes * 1000000) / (now - m_windowStartUS);
+        m_windowStartUS = now;
+        m_windowBytes = 0;
+    }
+    m_lastTransferUS = now;
+}
+
+uint64_t Bridge_Stats::getBytesPerSecond() const
+{
+    // No transfers in the last couple of windows: the stream is idle.
+    uint64_t last = m_lastTransferUS;
+    if (!last || getMonotonicUS() - last > 2000000)
+        return 0;
+    return m_bytesPerSecond;
+}
+
+uint64_t Bridge_Stats::getAverageLatencyUS() const
+{
+    uint64_t transfers = m_transfers;
+    return transfers ? m_totalLatencyUS / transfers : 0;
+}
+
+uint64_t Bridge_Stats::getMonotonicUS()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
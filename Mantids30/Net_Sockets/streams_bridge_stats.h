@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Mantids30 { namespace Network { namespace Sockets { namespace NetStreams {
+
+/**
+ * @brief The Bridge_Stats class keeps the transfer counters of one bridge direction.
+ *
+ * Only one thread adds transfers for a given direction (the thread/reactor pumping it), while any thread can
+ * read the counters.
+ */
+class Bridge_Stats
+{
+public:
+    Bridge_Stats() = default;
+
+    /**
+     * @brief addTransfer Accounts bytes delivered to the destination peer.
+     * @param bytes bytes written.
+     * @param latencyUS microseconds the destination peer took to accept them.
+     */
+    void addTransfer(const size_t & bytes, const uint64_t & latencyUS);
+
+    /**
+     * @brief getBytes Total bytes transferred.
+     */
+    uint64_t getBytes() const { return m_bytes; }
+    /**
+     * @brief getBytesPerSecond Transfer rate measured over the last (at least) one second window.
+     */
+    uint64_t getBytesPerSecond() const;
+    /**
+     * @brief getAverageLatencyUS Average time (in microseconds) the destination peer took to accept the data.
+     */
+    uint64_t getAverageLatencyUS() const;
+    /**
+     * @brief getMaxLatencyUS Maximum time (in microseconds) the destination peer took to accept the data.
+     */
+    uint64_t getMaxLatencyUS() const { return m_maxLatencyUS; }
+
+    /**
+     * @brief getMonotonicUS Monotonic clock in microseconds (used to measure latencies).
+     */
+    static uint64_t getMonotonicUS();
+
+private:
+    std::atomic<uint64_t> m_bytes{0};
+    std::atomic<uint64_t> m_transfers{0};
+    std::atomic<uint64_t> m_totalLatencyUS{0};
+    std::atomic<uint64_t> m_maxLatencyUS{0};
+
+    std::atomic<uint64_t> m_bytesPerSecond{0};
+    std::atomic<uint64_t> m_lastTransferUS{0};
+
+    // Rate window (only touched by the writer):
+    uint64_t m_windowStartUS = 0;
+    uint64_t m_windowBytes = 0;
+};
+
+}}}}
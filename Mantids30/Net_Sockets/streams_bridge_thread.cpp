@@ -43,7 +43,7 @@ bool Bridge_Thread::startPipeSync()
     return true;
 }
 
-void Bridge_Thread::setBlockSize(uint16_t value)
+void Bridge_Thread::setBlockSize(uint32_t value)
 {
     if (block_fwd)
         delete [] block_fwd;
@@ -56,6 +56,11 @@ void Bridge_Thread::setBlockSize(uint16_t value)
     m_blockBwd = new char[value];
 }
 
+uint64_t Bridge_Thread::getLastWriteLatencyUS(Side fwd) const
+{
+    return m_lastWriteLatencyUS[fwd==SIDE_FORWARD?1:0];
+}
+
 void Bridge_Thread::terminate()
 {
     m_terminated = true;
@@ -79,8 +84,10 @@ int Bridge_Thread::processPipe(Side fwd)
             {
                 std::lock_guard<std::mutex> lock(fwd==SIDE_FORWARD?mt_fwd:mt_rev);
 
+                uint64_t writeStart = Bridge_Stats::getMonotonicUS();
                 if (!(fwd==SIDE_FORWARD?m_dstSocket:src)->writeFull(curBlock,bytesReceived))
                     return -2;
+                m_lastWriteLatencyUS[fwd==SIDE_FORWARD?1:0] = Bridge_Stats::getMonotonicUS() - writeStart;
             }
 
             // Return for Update Counters:
@@ -93,12 +100,13 @@ int Bridge_Thread::processPipe(Side fwd)
         {
             // 0->1 (encapsulate)
 
-            // Read the raw stream:
-            bytesReceived = src->partialRead(curBlock,blockSize);
+            // Read the raw stream (the chunk size is transmitted as 16-bit):
+            bytesReceived = src->partialRead(curBlock,blockSize>UINT16_MAX?UINT16_MAX:blockSize);
 
             if ( bytesReceived > 0 )
             {
                 std::lock_guard<std::mutex> lock(mt_fwd);
+                uint64_t writeStart = Bridge_Stats::getMonotonicUS();
 
                 // Write the size to be written (chunk)
                 if (!m_dstSocket->writeU<uint16_t>((uint16_t)bytesReceived))
@@ -108,6 +116,7 @@ int Bridge_Thread::processPipe(Side fwd)
                 if (!m_dstSocket->writeFull(curBlock,bytesReceived))
                     return -2;
 
+                m_lastWriteLatencyUS[1] = Bridge_Stats::getMonotonicUS() - writeStart;
                 return bytesReceived;
             }
 
@@ -134,8 +143,10 @@ int Bridge_Thread::processPipe(Side fwd)
                 return -1;
 
             // Attempt to write to the src
+            uint64_t writeStart = Bridge_Stats::getMonotonicUS();
             if (!src->writeFull(curBlock,(uint16_t)bytesReceived))
                 return -2;
+            m_lastWriteLatencyUS[0] = Bridge_Stats::getMonotonicUS() - writeStart;
 
             return bytesReceived;
         }
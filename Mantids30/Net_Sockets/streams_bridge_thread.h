@@ -1,6 +1,7 @@
 #pragma once
 
 #include "socket_stream.h"
+#include "streams_bridge_stats.h"
 #include <atomic>
 #include <mutex>
 
@@ -31,9 +32,15 @@ public:
     virtual bool startPipeSync();
     /**
      * @brief setBlockSize Set Transfer Block Chunk Size
-     * @param value Chunk size, default 8192
+     * @param value Chunk size, default 8192 (in chunked mode, each chunk is limited to 65535 bytes)
      */
-    void setBlockSize(uint16_t value = 8192);
+    void setBlockSize(uint32_t value = 8192);
+    /**
+     * @brief getLastWriteLatencyUS Get the time (in microseconds) the destination peer took to accept the last block
+     * @param fwd direction
+     * @return microseconds
+     */
+    uint64_t getLastWriteLatencyUS(Side fwd) const;
     /**
      * @brief writeBlock write a whole data into next socket
      * @param data data to be written
@@ -47,7 +54,7 @@ public:
 protected:
     std::shared_ptr<Sockets::Socket_Stream>  src;
     char * block_fwd;
-    uint16_t blockSize;
+    uint32_t blockSize;
    // ssize_t partialReadL(void *data, const size_t &datalen, bool fwd = true);
 
 private:
@@ -59,6 +66,8 @@ private:
     char * m_blockBwd;
 
     std::mutex mt_fwd, mt_rev;
+
+    std::atomic<uint64_t> m_lastWriteLatencyUS[2] = {{0},{0}};
 };
 
 }}}}
@@ -1,15 +1,82 @@
 #include "streams_bufferedreader.h"
 #include <string.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NETSTREAMS_LINESCAN_X86
+#include <immintrin.h>
+#endif
+
 using namespace Mantids30::Network::Sockets;
 using namespace NetStreams;
 
+namespace {
+
+const char * findLineDelimiterScalar(const char *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (data[i] == '\r' || data[i] == '\n')
+            return data + i;
+    }
+    return nullptr;
+}
+
+#ifdef NETSTREAMS_LINESCAN_X86
+
+__attribute__((target("sse2"))) const char * findLineDelimiterSSE2(const char *data, size_t len)
+{
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf))));
+        if (mask)
+            return data + i + __builtin_ctz(mask);
+    }
+    return findLineDelimiterScalar(data + i, len - i);
+}
+
+__attribute__((target("avx2"))) const char * findLineDelimiterAVX2(const char *data, size_t len)
+{
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, lf))));
+        if (mask)
+            return data + i + __builtin_ctz(mask);
+    }
+    return findLineDelimiterSSE2(data + i, len - i);
+}
+
+bool hasAVX2()
+{
+    static const bool avx2 = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return avx2;
+}
+
+#endif
+
+}
+
 BufferedReader::BufferedReader( std::shared_ptr<Sockets::Socket_Stream> stream, const size_t &bufferSize)
 {
     this->m_stream = stream;
-    m_buffer = malloc(bufferSize);
+    m_buffer = (char *)malloc(bufferSize);
     m_bufferOK = m_buffer!=nullptr;
-    m_currentBufferSize=0;
+    m_maxBufferSize = m_bufferOK ? bufferSize : 0;
+    m_readPos = 0;
+    m_writePos = 0;
+    m_scanPos = 0;
+    m_scanDelimiter = LINE_DELIMITERS;
+    m_skipLF = false;
 }
 
 BufferedReader::~BufferedReader()
@@ -19,103 +86,208 @@ BufferedReader::~BufferedReader()
 
 BufferedReader::eStreamBufferReadErrors BufferedReader::bufferedReadUntil(void *data, size_t *len, int delimiter)
 {
-    while (true)
-    {
-        // Check in the buffer.
-        void *needle = memchr(m_buffer, delimiter, m_currentBufferSize);
-        if (needle)
-            return displaceAndCopy(data,len,(size_t)((char *)needle-(char *)m_buffer)+1);
+    size_t delimiterPos;
+    eStreamBufferReadErrors r = fillUntilDelimiter(delimiter, &delimiterPos);
+    if (r != E_STREAMBUFFER_READ_OK)
+        return r;
+    return displaceAndCopy(data,len,delimiterPos-m_readPos+1);
+}
 
-        // Check if full, we can't add anymore
-        if (m_maxBufferSize == m_currentBufferSize) 
-            return E_STREAMBUFFER_READ_FULL;
+BufferedReader::eStreamBufferReadErrors BufferedReader::bufferedReadUntil(std::string *str, int delimiter)
+{
+    size_t delimiterPos;
+    eStreamBufferReadErrors r = fillUntilDelimiter(delimiter, &delimiterPos);
+    if (r != E_STREAMBUFFER_READ_OK)
+        return r;
+    return displaceAndCopy(str,delimiterPos-m_readPos+1);
+}
 
-        // Refill from socket...
-        ssize_t readSize = m_stream->partialRead((char *)m_buffer+m_currentBufferSize,m_maxBufferSize-m_currentBufferSize);
+BufferedReader::eStreamBufferReadErrors BufferedReader::readLineCR(std::string *str, int delimiter)
+{
+    return bufferedReadUntil(str,delimiter);
+}
 
-        // If disconneted, report, if not, add to the buffer...
-        if (readSize < 0 )
-            return E_STREAMBUFFER_READ_DISCONNECTED;
-        else
-            m_currentBufferSize+=readSize;
+BufferedReader::eStreamBufferReadErrors BufferedReader::readLineLF(std::string *str, int delimiter)
+{
+    return bufferedReadUntil(str,delimiter);
+}
+
+BufferedReader::eStreamBufferReadErrors BufferedReader::readLine(std::string_view *line)
+{
+    size_t delimiterPos;
+    eStreamBufferReadErrors r = fillUntilDelimiter(LINE_DELIMITERS, &delimiterPos);
+    if (r != E_STREAMBUFFER_READ_OK)
+        return r;
+    takeBufferedLine(line);
+    return E_STREAMBUFFER_READ_OK;
+}
+
+BufferedReader::eStreamBufferReadErrors BufferedReader::readLines(std::vector<std::string_view> *lines, const size_t &maxLines)
+{
+    size_t delimiterPos;
+    eStreamBufferReadErrors r = fillUntilDelimiter(LINE_DELIMITERS, &delimiterPos);
+    if (r != E_STREAMBUFFER_READ_OK)
+        return r;
+
+    // Every complete line already in the buffer (the views remain valid until the next read):
+    std::string_view line;
+    size_t count = 0;
+    while ((maxLines == 0 || count < maxLines) && takeBufferedLine(&line))
+    {
+        lines->push_back(line);
+        count++;
     }
+    return E_STREAMBUFFER_READ_OK;
 }
 
-BufferedReader::eStreamBufferReadErrors BufferedReader::bufferedReadUntil(std::string *str, int delimiter)
+bool BufferedReader::getBufferOK() const
+{
+    return m_bufferOK;
+}
+
+size_t BufferedReader::getBufferSize() const
+{
+    return m_maxBufferSize;
+}
+
+const char *BufferedReader::findLineDelimiter(const char *data, size_t len)
+{
+#ifdef NETSTREAMS_LINESCAN_X86
+    if (hasAVX2())
+        return findLineDelimiterAVX2(data, len);
+    return findLineDelimiterSSE2(data, len);
+#else
+    return findLineDelimiterScalar(data, len);
+#endif
+}
+
+BufferedReader::eStreamBufferReadErrors BufferedReader::fillUntilDelimiter(int delimiter, size_t *delimiterPos)
 {
+    // Previous results were consumed (and the returned views are no longer valid), start again at the buffer beginning:
+    if (m_readPos == m_writePos)
+    {
+        m_readPos = 0;
+        m_writePos = 0;
+        m_scanPos = 0;
+    }
+
     while (true)
     {
-        // Check in the buffer.
-        void *needle = memchr(m_buffer, delimiter, m_currentBufferSize);
-        if (needle)
-            return displaceAndCopy(str,(size_t)((char *)needle-(char *)m_buffer)+1);
+        // Check in the buffer (only the bytes not scanned before).
+        if (findInBuffer(delimiter, delimiterPos))
+            return E_STREAMBUFFER_READ_OK;
+
+        if (m_writePos == m_maxBufferSize)
+        {
+            // Check if full, we can't add anymore
+            if (m_readPos == 0)
+                return E_STREAMBUFFER_READ_FULL;
 
-        // Check if full, we can't add anymore
-        if (m_maxBufferSize == m_currentBufferSize) 
-            return E_STREAMBUFFER_READ_FULL;
+            // Move the incomplete data to the front (only when the buffer end is reached):
+            size_t pending = m_writePos - m_readPos;
+            if (pending)
+                memmove(m_buffer, m_buffer + m_readPos, pending);
+            m_scanPos -= m_readPos;
+            m_writePos = pending;
+            m_readPos = 0;
+        }
 
         // Refill from socket...
-        ssize_t readSize = m_stream->partialRead((char *)m_buffer+m_currentBufferSize,m_maxBufferSize-m_currentBufferSize);
+        ssize_t readSize = m_stream->partialRead(m_buffer + m_writePos, m_maxBufferSize - m_writePos);
 
         // If disconneted, report, if not, add to the buffer...
-        if (readSize < 0 )
+        if (readSize <= 0)
             return E_STREAMBUFFER_READ_DISCONNECTED;
         else
-            m_currentBufferSize+=readSize;
+            m_writePos += readSize;
     }
 }
 
-BufferedReader::eStreamBufferReadErrors BufferedReader::readLineCR(std::string *str, int delimiter)
+bool BufferedReader::findInBuffer(int delimiter, size_t *delimiterPos)
 {
-    return bufferedReadUntil(str,delimiter);
-}
+    if (delimiter == LINE_DELIMITERS)
+    {
+        // Second half of a CRLF pair:
+        if (m_skipLF && m_readPos < m_writePos)
+        {
+            if (m_buffer[m_readPos] == '\n')
+                m_readPos++;
+            m_skipLF = false;
+        }
+    }
+    else
+        m_skipLF = false;
 
-BufferedReader::eStreamBufferReadErrors BufferedReader::readLineLF(std::string *str, int delimiter)
-{
-    return bufferedReadUntil(str,delimiter);
-}
+    if (delimiter != m_scanDelimiter || m_scanPos < m_readPos)
+    {
+        m_scanDelimiter = delimiter;
+        m_scanPos = m_readPos;
+    }
 
-bool BufferedReader::getBufferOK() const
-{
-    return m_bufferOK;
+    const char *start = m_buffer + m_scanPos;
+    size_t len = m_writePos - m_scanPos;
+    const char *needle = delimiter == LINE_DELIMITERS ? findLineDelimiter(start, len) : (const char *) memchr(start, delimiter, len);
+    if (!needle)
+    {
+        m_scanPos = m_writePos;
+        return false;
+    }
+
+    *delimiterPos = (size_t)(needle - m_buffer);
+    m_scanPos = *delimiterPos;
+    return true;
 }
 
-size_t BufferedReader::getBufferSize() const
+bool BufferedReader::takeBufferedLine(std::string_view *line)
 {
-    return m_maxBufferSize;
+    size_t delimiterPos;
+    if (!findInBuffer(LINE_DELIMITERS, &delimiterPos))
+        return false;
+
+    *line = std::string_view(m_buffer + m_readPos, delimiterPos - m_readPos);
+
+    if (m_buffer[delimiterPos] == '\r')
+    {
+        if (delimiterPos + 1 < m_writePos)
+        {
+            if (m_buffer[delimiterPos + 1] == '\n')
+                delimiterPos++;
+        }
+        else
+        {
+            // The LF may come in the next read.
+            m_skipLF = true;
+        }
+    }
+
+    m_readPos = delimiterPos + 1;
+    return true;
 }
 
 BufferedReader::eStreamBufferReadErrors BufferedReader::displaceAndCopy(void *data, size_t *len, size_t dlen)
 {
     // check output buffer availability...
-    if (dlen>*len) 
+    if (dlen>*len)
         return E_STREAMBUFFER_READ_MAXSIZEEXCEED;
+    char *line = m_buffer + m_readPos;
     // Null terminate it.
-    ((char *)m_buffer)[dlen-1]=0;
+    line[dlen-1]=0;
     // Copy to output
-    memcpy(data,m_buffer,dlen);
+    memcpy(data,line,dlen);
     // Copy bytes
     *len = dlen;
-    // Reduce byte count
-    m_currentBufferSize-=dlen;
-    // Displace data.
-    if (m_currentBufferSize)
-        memmove(m_buffer,(char *)m_buffer+dlen,m_currentBufferSize);
+    // Consume the bytes (no displacement, the read cursor is moved).
+    m_readPos+=dlen;
     // Get out.
     return E_STREAMBUFFER_READ_OK;
 }
 
 BufferedReader::eStreamBufferReadErrors BufferedReader::displaceAndCopy(std::string *str, size_t dlen)
 {
-    // Null terminate it.
-    ((char *)m_buffer)[dlen-1]=0;
-    // Copy to output
-    *str = std::string((char *)m_buffer,dlen);
-    // Reduce byte count
-    m_currentBufferSize-=dlen;
-    // Displace data.
-    if (m_currentBufferSize)
-        memmove(m_buffer,(char *)m_buffer+dlen,m_currentBufferSize);
+    // Copy to output (without the delimiter)
+    str->assign(m_buffer + m_readPos, dlen-1);
+    // Consume the bytes (no displacement, the read cursor is moved).
+    m_readPos+=dlen;
     // Get out.
     return E_STREAMBUFFER_READ_OK;
 }
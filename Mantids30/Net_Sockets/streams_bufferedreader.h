@@ -1,10 +1,18 @@
 #pragma once
 
 #include "socket_stream.h"
+#include <string_view>
+#include <vector>
 
 namespace Mantids30 { namespace Network { namespace Sockets { namespace NetStreams {
 
-
+/**
+ * @brief Buffered delimiter-based reader over a stream socket.
+ *
+ * The buffer is consumed through read/write cursors: returning a line only advances the read cursor, and the
+ * remaining (incomplete) data is moved to the front only when the buffer end is reached. The delimiter scan is
+ * resumed where the previous one stopped, so long lines received in several reads are scanned only once.
+ */
 class BufferedReader
 {
 public:
@@ -20,27 +28,66 @@ public:
     BufferedReader( std::shared_ptr<Sockets::Socket_Stream> stream, const size_t & maxBufferSize );
     ~BufferedReader();
 
+    /**
+     * @brief bufferedReadUntil Read until the delimiter, copying the data with the delimiter replaced by a NUL
+     * @param len in: output buffer size, out: copied bytes (including the NUL)
+     */
     eStreamBufferReadErrors bufferedReadUntil(void *data, size_t * len, int delimiter );
+    /**
+     * @brief bufferedReadUntil Read until the delimiter
+     * @param str output data without the delimiter. NOTE: previous versions appended a trailing NUL (str->size() was
+     *            one byte longer), callers that removed it or relied on it must be updated.
+     */
     eStreamBufferReadErrors bufferedReadUntil( std::string * str, int delimiter );
 
     eStreamBufferReadErrors readLineCR( std::string * str, int delimiter = '\r' );
     eStreamBufferReadErrors readLineLF( std::string * str, int delimiter = '\n' );
 
+    /**
+     * @brief readLine Read the next line terminated by CR, LF or CRLF (without copying it)
+     * @param line output line without the terminator, valid until the next read call.
+     * @return E_STREAMBUFFER_READ_OK, E_STREAMBUFFER_READ_FULL (line longer than the buffer) or E_STREAMBUFFER_READ_DISCONNECTED
+     */
+    eStreamBufferReadErrors readLine( std::string_view * line );
+    /**
+     * @brief readLines Read every complete line available (waiting for at least one), terminated by CR, LF or CRLF.
+     * @param lines output lines (appended) without the terminators, valid until the next read call.
+     * @param maxLines maximum number of lines to return (0: no limit)
+     * @return E_STREAMBUFFER_READ_OK, E_STREAMBUFFER_READ_FULL (line longer than the buffer) or E_STREAMBUFFER_READ_DISCONNECTED
+     */
+    eStreamBufferReadErrors readLines( std::vector<std::string_view> * lines, const size_t & maxLines = 0 );
+
     bool getBufferOK() const;
 
     size_t getBufferSize() const;
 
+    /**
+     * @brief findLineDelimiter Find the first CR or LF (SIMD accelerated when available)
+     * @return pointer to the delimiter or nullptr if not found
+     */
+    static const char * findLineDelimiter(const char * data, size_t len);
+
 private:
+    static constexpr int LINE_DELIMITERS = -1;
+
     eStreamBufferReadErrors displaceAndCopy(void *data, size_t *len, size_t dlen);
     eStreamBufferReadErrors displaceAndCopy(std::string * str, size_t dlen);
 
+    eStreamBufferReadErrors fillUntilDelimiter(int delimiter, size_t * delimiterPos);
+    bool findInBuffer(int delimiter, size_t * delimiterPos);
+    bool takeBufferedLine(std::string_view * line);
+
     bool m_bufferOK;
-    void * m_buffer;
+    char * m_buffer;
     std::shared_ptr<Sockets::Socket_Stream> m_stream;
-    size_t m_maxBufferSize, m_currentBufferSize;
+    size_t m_maxBufferSize;
+    // Unconsumed data is [m_readPos, m_writePos), the delimiter was not found in [m_readPos, m_scanPos):
+    size_t m_readPos, m_writePos, m_scanPos;
+    int m_scanDelimiter;
+    // The last line ended with CR, skip the LF of a CRLF pair:
+    bool m_skipLF;
 };
 
 typedef std::shared_ptr<BufferedReader> Stream_Buffer_SP;
 
 }}}}
-
@@ -0,0 +1,17 @@
+#include "counter.h"
+#include "exposition.h"
+
+using namespace Mantids30::Program::Metrics;
+
+uint64_t Counter::get() const
+{
+    uint64_t r = 0;
+    for (const Shard & shard : m_shards)
+        r += shard.value.load(std::memory_order_relaxed);
+    return r;
+}
+
+void Counter::renderPrometheus(std::string &out, const std::string &name, const std::string &labels) const
+{
+    Exposition::appendSample(out, name, labels, "", std::to_string(get()));
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "shards.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Mantids30 { namespace Program { namespace Metrics {
+
+/**
+ * @brief Monotonic counter (eg. accepted connections, cache hits).
+ *
+ * The increment is a relaxed atomic add on the shard of the calling thread, the shards are only summed when the
+ * value is read (eg. on scrape).
+ */
+class Counter
+{
+public:
+    Counter() = default;
+    Counter(const Counter &) = delete;
+    Counter &operator=(const Counter &) = delete;
+
+    /**
+     * @brief add Increment the counter
+     * @param value value to be added
+     */
+    void add(const uint64_t & value = 1)
+    {
+        m_shards[getCurrentShard()].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief get Get the current value (sum of all the shards)
+     */
+    uint64_t get() const;
+
+    /**
+     * @brief renderPrometheus Append the metric in the Prometheus text format.
+     * @param out output text
+     * @param name metric name
+     * @param labels rendered labels (without braces, may be empty)
+     */
+    void renderPrometheus(std::string & out, const std::string & name, const std::string & labels) const;
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard
+    {
+        std::atomic<uint64_t> value{0};
+    };
+
+    Shard m_shards[SHARD_COUNT];
+};
+
+}}}
@@ -0,0 +1,75 @@
+#include "exposition.h"
+
+#include <cmath>
+#include <stdio.h>
+
+using namespace Mantids30::Program::Metrics;
+
+std::string Exposition::formatValue(const double &value)
+{
+    if (std::isnan(value))
+        return "NaN";
+    if (std::isinf(value))
+        return value > 0 ? "+Inf" : "-Inf";
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.10g", value);
+    return buffer;
+}
+
+std::string Exposition::escapeLabelValue(const std::string &value)
+{
+    std::string r;
+    r.reserve(value.size());
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '\\':
+            r += "\\\\";
+            break;
+        case '"':
+            r += "\\\"";
+            break;
+        case '\n':
+            r += "\\n";
+            break;
+        default:
+            r += c;
+        }
+    }
+    return r;
+}
+
+std::string Exposition::escapeHelp(const std::string &help)
+{
+    std::string r;
+    r.reserve(help.size());
+    for (char c : help)
+    {
+        if (c == '\\')
+            r += "\\\\";
+        else if (c == '\n')
+            r += "\\n";
+        else
+            r += c;
+    }
+    return r;
+}
+
+void Exposition::appendSample(std::string &out, const std::string &name, const std::string &labels, const std::string &extraLabel, const std::string &value)
+{
+    out += name;
+    if (!labels.empty() || !extraLabel.empty())
+    {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extraLabel.empty())
+            out += ',';
+        out += extraLabel;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
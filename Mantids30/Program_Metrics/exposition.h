@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Mantids30 { namespace Program { namespace Metrics { namespace Exposition {
+
+/**
+ * @brief formatValue Format a floating point sample value (Prometheus text format)
+ */
+std::string formatValue(const double & value);
+/**
+ * @brief escapeLabelValue Escape a label value (backslash, double quote and new line)
+ */
+std::string escapeLabelValue(const std::string & value);
+/**
+ * @brief escapeHelp Escape a HELP text (backslash and new line)
+ */
+std::string escapeHelp(const std::string & help);
+/**
+ * @brief appendSample Append a sample line: name{labels,extraLabel} value
+ * @param out output text
+ * @param name sample name
+ * @param labels rendered labels (may be empty)
+ * @param extraLabel additional rendered label (eg. le="0.5") (may be empty)
+ * @param value formatted value
+ */
+void appendSample(std::string & out, const std::string & name, const std::string & labels, const std::string & extraLabel, const std::string & value);
+
+}}}}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "exposition.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Mantids30 { namespace Program { namespace Metrics {
+
+/**
+ * @brief Base of the metric families (metrics sharing the name, the help and the label names)
+ */
+class FamilyBase
+{
+public:
+    FamilyBase(const std::string & name, const std::string & help, const std::string & type, const std::vector<std::string> & labelNames)
+        : m_name(name), m_help(help), m_type(type), m_labelNames(labelNames)
+    {
+    }
+    virtual ~FamilyBase() = default;
+
+    /**
+     * @brief renderPrometheus Append the HELP/TYPE lines and every metric of the family in the Prometheus text format.
+     */
+    virtual void renderPrometheus(std::string & out) = 0;
+
+    const std::string & getName() const { return m_name; }
+    const std::string & getType() const { return m_type; }
+    const std::vector<std::string> & getLabelNames() const { return m_labelNames; }
+
+protected:
+    std::string renderLabels(const std::vector<std::string> & labelValues) const
+    {
+        if (labelValues.size() != m_labelNames.size())
+            throw std::runtime_error("Metric '" + m_name + "': invalid number of label values.");
+
+        std::string r;
+        for (size_t i = 0; i < labelValues.size(); i++)
+        {
+            if (i)
+                r += ',';
+            r += m_labelNames[i] + "=\"" + Exposition::escapeLabelValue(labelValues[i]) + "\"";
+        }
+        return r;
+    }
+
+    void renderHeader(std::string & out) const
+    {
+        out += "# HELP " + m_name + " " + Exposition::escapeHelp(m_help) + "\n";
+        out += "# TYPE " + m_name + " " + m_type + "\n";
+    }
+
+    std::string m_name, m_help, m_type;
+    std::vector<std::string> m_labelNames;
+};
+
+/**
+ * @brief Metric family: one metric (Counter, Gauge or Histogram) per combination of label values.
+ *
+ * The metrics are created on the first use and never destroyed, so the returned references can be kept (eg. in
+ * a static variable) to avoid the lookup on hot paths.
+ */
+template <class T>
+class Family : public FamilyBase
+{
+public:
+    Family(const std::string & name, const std::string & help, const std::string & type, const std::vector<std::string> & labelNames,
+           std::function<std::unique_ptr<T>()> factory = []() { return std::make_unique<T>(); })
+        : FamilyBase(name, help, type, labelNames), m_factory(factory)
+    {
+    }
+
+    /**
+     * @brief withLabels Get (or create) the metric for the label values
+     * @param labelValues one value per label name (in the same order)
+     * @return metric reference (valid for the whole program execution)
+     */
+    T & withLabels(const std::vector<std::string> & labelValues = {})
+    {
+        std::string labels = renderLabels(labelValues);
+        {
+            std::shared_lock<std::shared_mutex> readLock(m_mutex);
+            auto it = m_metrics.find(labels);
+            if (it != m_metrics.end())
+                return *it->second;
+        }
+
+        std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+        auto & metric = m_metrics[labels];
+        if (!metric)
+            metric = m_factory();
+        return *metric;
+    }
+
+    void renderPrometheus(std::string & out) override
+    {
+        std::shared_lock<std::shared_mutex> readLock(m_mutex);
+        renderHeader(out);
+        for (const auto & metric : m_metrics)
+            metric.second->renderPrometheus(out, m_name, metric.first);
+    }
+
+private:
+    std::function<std::unique_ptr<T>()> m_factory;
+    std::map<std::string, std::unique_ptr<T>> m_metrics;
+    std::shared_mutex m_mutex;
+};
+
+}}}
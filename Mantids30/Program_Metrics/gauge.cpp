@@ -0,0 +1,9 @@
+#include "gauge.h"
+#include "exposition.h"
+
+using namespace Mantids30::Program::Metrics;
+
+void Gauge::renderPrometheus(std::string &out, const std::string &name, const std::string &labels) const
+{
+    Exposition::appendSample(out, name, labels, "", std::to_string(get()));
+}
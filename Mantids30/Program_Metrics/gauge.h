@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Mantids30 { namespace Program { namespace Metrics {
+
+/**
+ * @brief Value that goes up and down (eg. active connections, queued tasks).
+ *
+ * Gauges are not sharded: they are usually updated in pairs (increment/decrement) far from the hottest loops, and
+ * reading them must be exact.
+ */
+class Gauge
+{
+public:
+    Gauge() = default;
+    Gauge(const Gauge &) = delete;
+    Gauge &operator=(const Gauge &) = delete;
+
+    void set(const int64_t & value)
+    {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+    void increment(const int64_t & value = 1)
+    {
+        m_value.fetch_add(value, std::memory_order_relaxed);
+    }
+    void decrement(const int64_t & value = 1)
+    {
+        m_value.fetch_sub(value, std::memory_order_relaxed);
+    }
+    int64_t get() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief renderPrometheus Append the metric in the Prometheus text format.
+     * @param out output text
+     * @param name metric name
+     * @param labels rendered labels (without braces, may be empty)
+     */
+    void renderPrometheus(std::string & out, const std::string & name, const std::string & labels) const;
+
+private:
+    std::atomic<int64_t> m_value{0};
+};
+
+}}}
@@ -0,0 +1,126 @@
+#include "histogram.h"
+#include "exposition.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Mantids30::Program::Metrics;
+
+HistogramLayout Histogram::latencyLayout()
+{
+    HistogramLayout layout;
+    layout.scale = 1e-9;
+    layout.firstBoundExponent = 10;
+    layout.lastBoundExponent = 36;
+    return layout;
+}
+
+Histogram::Histogram(const HistogramLayout &layout)
+{
+    m_layout = layout;
+    for (Shard & shard : m_shards)
+    {
+        for (auto & bucket : shard.buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Histogram::getCount() const
+{
+    uint64_t buckets[BUCKET_COUNT];
+    collect(buckets);
+
+    uint64_t r = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+        r += buckets[i];
+    return r;
+}
+
+uint64_t Histogram::getSum() const
+{
+    uint64_t r = 0;
+    for (const Shard & shard : m_shards)
+        r += shard.sum.load(std::memory_order_relaxed);
+    return r;
+}
+
+uint64_t Histogram::getPercentile(const double &percentile) const
+{
+    uint64_t buckets[BUCKET_COUNT];
+    collect(buckets);
+
+    uint64_t count = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+        count += buckets[i];
+    if (count == 0)
+        return 0;
+
+    // Rank of the requested value (1..count):
+    uint64_t rank = static_cast<uint64_t>(std::ceil(count * std::min(std::max(percentile, 0.0), 100.0) / 100.0));
+    if (rank == 0)
+        rank = 1;
+
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        accumulated += buckets[i];
+        if (accumulated >= rank)
+            return getBucketUpperBound(i);
+    }
+    return getBucketUpperBound(BUCKET_COUNT - 1);
+}
+
+void Histogram::renderPrometheus(std::string &out, const std::string &name, const std::string &labels) const
+{
+    uint64_t buckets[BUCKET_COUNT];
+    collect(buckets);
+
+    // Cumulative counts at every exported power of two (Prometheus buckets are cumulative):
+    size_t index = 0;
+    uint64_t accumulated = 0;
+    for (unsigned exponent = m_layout.firstBoundExponent; exponent <= m_layout.lastBoundExponent; exponent++)
+    {
+        size_t limit = getBucketsBelow(exponent);
+        for (; index < limit; index++)
+            accumulated += buckets[index];
+
+        double bound = std::ldexp(1.0, static_cast<int>(exponent)) * m_layout.scale;
+        Exposition::appendSample(out, name + "_bucket", labels, "le=\"" + Exposition::formatValue(bound) + "\"", std::to_string(accumulated));
+    }
+    for (; index < BUCKET_COUNT; index++)
+        accumulated += buckets[index];
+
+    Exposition::appendSample(out, name + "_bucket", labels, "le=\"+Inf\"", std::to_string(accumulated));
+    Exposition::appendSample(out, name + "_sum", labels, "", Exposition::formatValue(static_cast<double>(getSum()) * m_layout.scale));
+    Exposition::appendSample(out, name + "_count", labels, "", std::to_string(accumulated));
+}
+
+uint64_t Histogram::getBucketUpperBound(const size_t &index)
+{
+    if (index < SUB_BUCKETS)
+        return index + 1;
+    unsigned exponent = static_cast<unsigned>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+    uint64_t subBucket = index % SUB_BUCKETS;
+    return (SUB_BUCKETS + subBucket + 1) << (exponent - SUB_BUCKET_BITS);
+}
+
+size_t Histogram::getBucketsBelow(const unsigned &exponent)
+{
+    // Number of buckets holding values lower than 2^exponent:
+    if (exponent <= SUB_BUCKET_BITS)
+        return static_cast<size_t>(1) << exponent;
+    if (exponent >= MAX_EXPONENT)
+        return BUCKET_COUNT;
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+}
+
+void Histogram::collect(uint64_t *buckets) const
+{
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+        buckets[i] = 0;
+    for (const Shard & shard : m_shards)
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; i++)
+            buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    }
+}
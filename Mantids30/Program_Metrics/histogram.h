@@ -0,0 +1,127 @@
+#pragma once
+
+#include "shards.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Mantids30 { namespace Program { namespace Metrics {
+
+/**
+ * @brief The HistogramLayout struct defines how the recorded values of a histogram are exported.
+ */
+struct HistogramLayout
+{
+    /**
+     * @brief scale multiplier from the recorded unit to the exported unit (eg. 1e-9 for nanoseconds to seconds)
+     */
+    double scale = 1.0;
+    /**
+     * @brief firstBoundExponent first exported bucket boundary (2^firstBoundExponent)
+     */
+    uint8_t firstBoundExponent = 0;
+    /**
+     * @brief lastBoundExponent last exported bucket boundary (2^lastBoundExponent), the +Inf bucket comes after.
+     */
+    uint8_t lastBoundExponent = 32;
+};
+
+/**
+ * @brief HDR-style (log-linear) histogram of integer values (eg. latencies in nanoseconds).
+ *
+ * Every power of two is divided in 8 linear sub-buckets (12.5% of relative error), from 0 to 2^40 (values above are
+ * kept in the last bucket). Recording a value is two relaxed atomic adds on the shard of the calling thread.
+ *
+ * The Prometheus output only reports the power of two boundaries of the layout (the full resolution is available
+ * through getPercentile).
+ */
+class Histogram
+{
+public:
+    /**
+     * @brief latencyLayout Values recorded in nanoseconds, exported in seconds from ~1us to ~68s.
+     */
+    static HistogramLayout latencyLayout();
+
+    Histogram(const HistogramLayout & layout = HistogramLayout());
+    Histogram(const Histogram &) = delete;
+    Histogram &operator=(const Histogram &) = delete;
+
+    /**
+     * @brief observe Record a value
+     * @param value value in the recorded unit
+     */
+    void observe(const uint64_t & value)
+    {
+        Shard & shard = m_shards[getCurrentShard() & (HISTOGRAM_SHARD_COUNT - 1)];
+        shard.buckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief observeSince Record the nanoseconds elapsed since start
+     * @param start time point taken with std::chrono::steady_clock
+     */
+    void observeSince(const std::chrono::steady_clock::time_point & start)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        observe(elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0);
+    }
+
+    /**
+     * @brief getCount Get the number of recorded values
+     */
+    uint64_t getCount() const;
+    /**
+     * @brief getSum Get the sum of the recorded values (in the recorded unit)
+     */
+    uint64_t getSum() const;
+    /**
+     * @brief getPercentile Get the approximated value at a percentile
+     * @param percentile value between 0 and 100
+     * @return upper bound of the bucket containing the percentile (0 if there are no values)
+     */
+    uint64_t getPercentile(const double & percentile) const;
+
+    /**
+     * @brief renderPrometheus Append the metric in the Prometheus text format (_bucket, _sum and _count series).
+     * @param out output text
+     * @param name metric name
+     * @param labels rendered labels (without braces, may be empty)
+     */
+    void renderPrometheus(std::string & out, const std::string & name, const std::string & labels) const;
+
+private:
+    static constexpr size_t HISTOGRAM_SHARD_COUNT = 8;
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr unsigned SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_EXPONENT = 40;
+    static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static size_t getBucketIndex(uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+            return static_cast<size_t>(value);
+        if (value >= (1ULL << MAX_EXPONENT))
+            return BUCKET_COUNT - 1;
+        unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(value));
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + ((value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+    }
+    static uint64_t getBucketUpperBound(const size_t & index);
+    static size_t getBucketsBelow(const unsigned & exponent);
+
+    void collect(uint64_t * buckets) const;
+
+    struct alignas(CACHE_LINE_SIZE) Shard
+    {
+        std::atomic<uint64_t> buckets[BUCKET_COUNT];
+        std::atomic<uint64_t> sum{0};
+    };
+
+    HistogramLayout m_layout;
+    Shard m_shards[HISTOGRAM_SHARD_COUNT];
+};
+
+}}}
@@ -0,0 +1,70 @@
+#include "registry.h"
+
+#include <stdexcept>
+
+using namespace Mantids30::Program::Metrics;
+
+Registry &Registry::getDefault()
+{
+    static Registry * defaultRegistry = new Registry;
+    return *defaultRegistry;
+}
+
+template <class T>
+Family<T> &Registry::getFamily(const std::string &name, const std::string &help, const std::string &type, const std::vector<std::string> &labelNames,
+                               std::function<std::unique_ptr<T>()> factory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_families.find(name);
+    if (it != m_families.end())
+    {
+        if (it->second->getType() != type || it->second->getLabelNames() != labelNames)
+            throw std::runtime_error("Metric '" + name + "' already registered with another type or labels.");
+        return *static_cast<Family<T> *>(it->second.get());
+    }
+
+    auto family = std::make_unique<Family<T>>(name, help, type, labelNames, factory);
+    Family<T> & r = *family;
+    m_families[name] = std::move(family);
+    return r;
+}
+
+Family<Counter> &Registry::counterFamily(const std::string &name, const std::string &help, const std::vector<std::string> &labelNames)
+{
+    return getFamily<Counter>(name, help, "counter", labelNames, []() { return std::make_unique<Counter>(); });
+}
+
+Family<Gauge> &Registry::gaugeFamily(const std::string &name, const std::string &help, const std::vector<std::string> &labelNames)
+{
+    return getFamily<Gauge>(name, help, "gauge", labelNames, []() { return std::make_unique<Gauge>(); });
+}
+
+Family<Histogram> &Registry::histogramFamily(const std::string &name, const std::string &help, const std::vector<std::string> &labelNames, const HistogramLayout &layout)
+{
+    return getFamily<Histogram>(name, help, "histogram", labelNames, [layout]() { return std::make_unique<Histogram>(layout); });
+}
+
+Counter &Registry::counter(const std::string &name, const std::string &help)
+{
+    return counterFamily(name, help, {}).withLabels();
+}
+
+Gauge &Registry::gauge(const std::string &name, const std::string &help)
+{
+    return gaugeFamily(name, help, {}).withLabels();
+}
+
+Histogram &Registry::histogram(const std::string &name, const std::string &help, const HistogramLayout &layout)
+{
+    return histogramFamily(name, help, {}, layout).withLabels();
+}
+
+std::string Registry::toPrometheusText()
+{
+    std::string r;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto & family : m_families)
+        family.second->renderPrometheus(r);
+    return r;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "counter.h"
+#include "family.h"
+#include "gauge.h"
+#include "histogram.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Mantids30 { namespace Program { namespace Metrics {
+
+/**
+ * @brief Metrics registry: holds the metric families and renders them in the Prometheus text format.
+ *
+ * Usage on hot paths (the lookup is done once):
+ *
+ *     static Metrics::Counter & accepted = Metrics::Registry::getDefault().counter("myapp_accepted_total", "Accepted connections.");
+ *     accepted.add();
+ */
+class Registry
+{
+public:
+    Registry() = default;
+    Registry(const Registry &) = delete;
+    Registry &operator=(const Registry &) = delete;
+
+    /**
+     * @brief getDefault Get the process-wide registry (used by the library components).
+     *        It is never destroyed, so the metrics remain valid while the threads are finishing at exit.
+     */
+    static Registry & getDefault();
+
+    /**
+     * @brief counterFamily Get (or create) a counter family
+     * @param name metric name (should end with _total)
+     * @param help metric description
+     * @param labelNames label names
+     * @return family reference (throws std::runtime_error if the name is registered with another type or labels)
+     */
+    Family<Counter> & counterFamily(const std::string & name, const std::string & help, const std::vector<std::string> & labelNames);
+    /**
+     * @brief gaugeFamily Get (or create) a gauge family
+     */
+    Family<Gauge> & gaugeFamily(const std::string & name, const std::string & help, const std::vector<std::string> & labelNames);
+    /**
+     * @brief histogramFamily Get (or create) a histogram family
+     * @param layout export layout used by the histograms of the family (eg. Histogram::latencyLayout())
+     */
+    Family<Histogram> & histogramFamily(const std::string & name, const std::string & help, const std::vector<std::string> & labelNames,
+                                        const HistogramLayout & layout = HistogramLayout());
+
+    /**
+     * @brief counter Get (or create) a counter without labels
+     */
+    Counter & counter(const std::string & name, const std::string & help);
+    /**
+     * @brief gauge Get (or create) a gauge without labels
+     */
+    Gauge & gauge(const std::string & name, const std::string & help);
+    /**
+     * @brief histogram Get (or create) a histogram without labels
+     */
+    Histogram & histogram(const std::string & name, const std::string & help, const HistogramLayout & layout = HistogramLayout());
+
+    /**
+     * @brief toPrometheusText Render every metric in the Prometheus text exposition format (version 0.0.4)
+     */
+    std::string toPrometheusText();
+
+private:
+    template <class T>
+    Family<T> & getFamily(const std::string & name, const std::string & help, const std::string & type, const std::vector<std::string> & labelNames,
+                          std::function<std::unique_ptr<T>()> factory);
+
+    std::map<std::string, std::unique_ptr<FamilyBase>> m_families;
+    std::mutex m_mutex;
+};
+
+}}}
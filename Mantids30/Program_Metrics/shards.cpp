@@ -0,0 +1,9 @@
+#include "shards.h"
+
+#include <atomic>
+
+size_t Mantids30::Program::Metrics::assignShard()
+{
+    static std::atomic<size_t> nextShard{0};
+    return nextShard.fetch_add(1, std::memory_order_relaxed) & (SHARD_COUNT - 1);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Mantids30 { namespace Program { namespace Metrics {
+
+/**
+ * @brief SHARD_COUNT Number of shards of every counter. Each thread always updates the same shard, so threads
+ *        running on different cores rarely write the same cache line (power of two).
+ */
+static constexpr size_t SHARD_COUNT = 16;
+
+/**
+ * @brief CACHE_LINE_SIZE Alignment used to keep every shard on its own cache line.
+ */
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief assignShard Assign a shard to a new thread (round-robin).
+ * @return shard index between 0 and SHARD_COUNT-1
+ */
+size_t assignShard();
+
+/**
+ * @brief getCurrentShard Get the shard assigned to the calling thread (assigned on the first use).
+ * @return shard index between 0 and SHARD_COUNT-1
+ */
+inline size_t getCurrentShard()
+{
+    static thread_local size_t shard = assignShard();
+    return shard;
+}
+
+}}}
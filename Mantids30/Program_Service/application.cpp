@@ -26,7 +26,9 @@
 #include <unistd.h>
 
 #include <Mantids30/Memory/a_var.h>
+#include <Mantids30/Memory/a_uint32.h>
 #include <Mantids30/Helpers/mem.h>
+#include <Mantids30/Net_Sockets/listener_handoff.h>
 
 using namespace std;
 
@@ -38,9 +40,17 @@ static int lockfd = -1;
 static string pidFile;
 
 static void daemonize();
+static int get_lock(bool wait = false);
 void pidCheck();
 void exitRoutine(int, siginfo_t *, void *);
 
+// Listening sockets handoff:
+static string handoffPath;
+static uint32_t drainGracePeriodMS = 30000;
+
+static void startListenerHandoff();
+static void handedOffRoutine();
+
 #else
 
 #define	LOG_PID		0x01
@@ -66,6 +76,11 @@ using namespace Mantids30::Program;
 
 static Application *appPTR = nullptr;
 
+void Application::_drain(const uint32_t &gracePeriodMS)
+{
+    Mantids30::Network::Sockets::ListenerHandoff::getDefault().drain(gracePeriodMS);
+}
+
 int StartApplication(int argc, char *argv[], Application *_app)
 {
 #ifndef _WIN32
@@ -82,6 +97,8 @@ int StartApplication(int argc, char *argv[], Application *_app)
     // Local default cmd options...
 #ifndef _WIN32
     globalArgs.addCommandLineOption("Service Options",   0, "daemon" , "Run as daemon."         , "0", Mantids30::Memory::Abstract::Var::TYPE_BOOL );
+    globalArgs.addCommandLineOption("Service Options",   0, "handoff" , "UNIX socket path to receive/hand off the listening sockets between program versions (empty: disabled)", "", Mantids30::Memory::Abstract::Var::TYPE_STRING );
+    globalArgs.addCommandLineOption("Service Options",   0, "drain-timeout" , "Seconds to wait for the current connections after handing off the listening sockets", "30", Mantids30::Memory::Abstract::Var::TYPE_UINT32 );
 #endif
 
     // be careful to sanitize install parameters, because it can affect the security.
@@ -225,6 +242,22 @@ int StartApplication(int argc, char *argv[], Application *_app)
         return 0;
     }
 
+#ifndef _WIN32
+    handoffPath = globalArgs.getCommandLineOptionValue("handoff")->toString();
+    auto drainTimeout = std::dynamic_pointer_cast<Mantids30::Memory::Abstract::UINT32>(globalArgs.getCommandLineOptionValue("drain-timeout"));
+    if (drainTimeout)
+        drainGracePeriodMS = drainTimeout->getValue() * 1000;
+
+    // The listeners created in _config/_start will be handed off:
+    Mantids30::Network::Sockets::ListenerHandoff::getDefault().setEnabled(!handoffPath.empty());
+
+    // If the previous version is running, receive its listening sockets (adopted by the listeners created in _config/_start)
+    if (!handoffPath.empty() && Mantids30::Network::Sockets::ListenerHandoff::getDefault().receiveFromPreviousProcess(handoffPath))
+    {
+        cout << "# Listening sockets received from the running process, upgrading..." << endl << flush;
+    }
+#endif
+
     // Load/Prepare the configuration based in command line arguments.
     if (!appPTR->_config(argc,argv,&globalArgs))
     {
@@ -277,6 +310,9 @@ int StartApplication(int argc, char *argv[], Application *_app)
         catch_sigterm();
 
         r = appPTR->_start(argc,argv,&globalArgs);
+#ifndef _WIN32
+        startListenerHandoff();
+#endif
         if (!globalArgs.isInifiniteWaitAtEnd())
             return r;
         else
@@ -304,8 +340,16 @@ int StartApplication(int argc, char *argv[], Application *_app)
         // Allow this application to be killed and setup an exit routine.
         catch_sigterm();
 
+        bool upgrading = Mantids30::Network::Sockets::ListenerHandoff::getDefault().isHandoffInProgress();
+
         r = appPTR->_start(argc,argv,&globalArgs);
 
+        startListenerHandoff();
+
+        // Upgrading: the previous process holds the lock until it finishes draining.
+        if (upgrading && get_lock(true) == 0)
+            syslog( LOG_ERR, "unable to create lock file.");
+
         if (!globalArgs.isInifiniteWaitAtEnd())
         {
             // Finish up.
@@ -339,7 +383,7 @@ static void child_handler(int signum)
     }
 }
 
-static int get_lock()
+static int get_lock(bool wait)
 {
     struct flock lplock;
 
@@ -354,8 +398,12 @@ static int get_lock()
     lplock.l_pid = getpid();
 
     // Lock this file to my PID.
-    if (fcntl(lockfd, F_SETLK, &lplock) < 0) 
+    if (fcntl(lockfd, wait ? F_SETLKW : F_SETLK, &lplock) < 0)
+    {
+        close(lockfd);
+        lockfd = -1;
         return 0;
+    }
 
     return 1;
 }
@@ -425,7 +473,8 @@ static void daemonize()
     kill(parent, SIGUSR1);
 
     // Create the lock file as the current proccess, and if it does not work get out of here.
-    if (get_lock() == 0)
+    // (when upgrading, the lock is taken after the handoff)
+    if (!Mantids30::Network::Sockets::ListenerHandoff::getDefault().isHandoffInProgress() && get_lock() == 0)
     {
         cerr << "ERR: " << globalArgs.getDaemonName() << " unable to create lock file..." << endl << flush;
         fflush(stdout);
@@ -453,6 +502,43 @@ void pidCheck()
     runFile.close();
 }
 
+static void startListenerHandoff()
+{
+    if (handoffPath.empty())
+        return;
+
+    Mantids30::Network::Sockets::ListenerHandoff & handoff = Mantids30::Network::Sockets::ListenerHandoff::getDefault();
+
+    // Running: the previous process can stop accepting and drain its connections.
+    if (handoff.isHandoffInProgress() && !handoff.completeHandoff())
+        fprintf(stderr, "Failed to confirm the listening sockets handoff to the previous process of (%s).\n", globalArgs.getDaemonName().c_str());
+
+    // Wait for the next version:
+    if (!handoff.startHandoffServer(handoffPath, handedOffRoutine))
+        fprintf(stderr, "Failed to listen for the listening sockets handoff at %s.\n", handoffPath.c_str());
+}
+
+static void handedOffRoutine()
+{
+    fprintf(stderr, "Listening sockets handed off, draining (%s) - pid %" PRIi32 ".\n", globalArgs.getDaemonName().c_str(), static_cast<int32_t>(getpid()));
+    fflush(stderr);
+
+    if (appPTR)
+    {
+        appPTR->_drain(drainGracePeriodMS);
+        appPTR->_shutdown();
+    }
+
+    fprintf(stderr, "Finalizing (%s) - pid %" PRIi32 ".\n", globalArgs.getDaemonName().c_str(), static_cast<int32_t>(getpid()));
+    fflush(stderr);
+    fflush(stdout);
+
+    // The pid file now belongs to the new process.
+    free_lock();
+
+    _exit(0);
+}
+
 void exitRoutine(int , siginfo_t *, void *)
 {
     fprintf(stderr, "Receiving termination signal for (%s) - pid %" PRIi32 ".\n", globalArgs.getDaemonName().c_str(), static_cast<int32_t>(getpid()));
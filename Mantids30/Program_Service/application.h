@@ -14,6 +14,9 @@ static Mantids30::Program::Arguments::GlobalArguments globalArgs;
 //               /var/log/<program_name>/
 //               /var/lock/<program_name>/
 //               /var/run/<program_name>/
+//
+// NOTE: for zero-downtime upgrades, run both versions with the same --handoff=<path>: the new process receives the
+//       listening sockets from the running one, and when started, the previous process drains its connections and exits.
 
 namespace Mantids30 { namespace Program {
 
@@ -47,6 +50,13 @@ virtual bool _config(int argc, char *argv[], Mantids30::Program::Arguments::Glob
  * @return
  */
 virtual int _start(int argc, char *argv[], Mantids30::Program::Arguments::GlobalArguments * globalArguments)=0;
+/**
+ * @brief _drain function called when the listening sockets were handed off to a new process (--handoff): stop accepting
+ *               and wait for the current connections before the program shutdown.
+ *               By default, drains the listeners and engines registered in Network::Sockets::ListenerHandoff.
+ * @param gracePeriodMS maximum time to wait for the current connections in milliseconds
+ */
+virtual void _drain(const uint32_t & gracePeriodMS);
 
 };
 }}
@@ -0,0 +1,372 @@
+#include "tracing.h"
+
+#include <Mantids30/Helpers/json.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Mantids30::Program::Tracing;
+
+namespace {
+
+struct SpanRecord
+{
+    uint64_t traceId;
+    uint64_t spanId;
+    uint64_t parentSpanId;
+    const char * name;
+    char detail[48];
+    int64_t startNS;
+    int64_t durationNS;
+    uint32_t threadId;
+};
+
+// Span records of one thread (the mutex is only contended while dumping):
+struct ThreadRing
+{
+    std::mutex mutex;
+    std::vector<SpanRecord> records;
+    uint64_t written = 0;
+};
+
+// Rings are never destroyed: when a thread finishes, its ring (and the records) are kept for the next thread.
+struct Rings
+{
+    std::mutex mutex;
+    std::list<ThreadRing *> all;
+    std::vector<ThreadRing *> unused;
+    size_t capacity = 1024;
+};
+
+Rings & getRings()
+{
+    static Rings * rings = new Rings;
+    return *rings;
+}
+
+std::atomic<bool> g_enabled{false};
+std::atomic<bool> g_requestTriggerAllowed{false};
+std::atomic<uint32_t> g_samplingRate{0};
+std::atomic<uint64_t> g_sampleCounter{0};
+std::atomic<uint64_t> g_nextSpanId{1};
+
+uint32_t getCurrentThreadId()
+{
+#ifdef _WIN32
+    return static_cast<uint32_t>(GetCurrentThreadId());
+#else
+    return static_cast<uint32_t>(syscall(SYS_gettid));
+#endif
+}
+
+class ThreadRingHolder
+{
+public:
+    ThreadRingHolder()
+    {
+        Rings & rings = getRings();
+        std::lock_guard<std::mutex> lock(rings.mutex);
+        if (!rings.unused.empty())
+        {
+            m_ring = rings.unused.back();
+            rings.unused.pop_back();
+        }
+        else
+        {
+            m_ring = new ThreadRing;
+            m_ring->records.resize(std::max<size_t>(rings.capacity, 1));
+            rings.all.push_back(m_ring);
+        }
+        m_threadId = getCurrentThreadId();
+    }
+    ~ThreadRingHolder()
+    {
+        Rings & rings = getRings();
+        std::lock_guard<std::mutex> lock(rings.mutex);
+        rings.unused.push_back(m_ring);
+    }
+
+    void push(const SpanRecord & record)
+    {
+        std::lock_guard<std::mutex> lock(m_ring->mutex);
+        SpanRecord & slot = m_ring->records[m_ring->written % m_ring->records.size()];
+        slot = record;
+        slot.threadId = m_threadId;
+        m_ring->written++;
+    }
+
+private:
+    ThreadRing * m_ring;
+    uint32_t m_threadId;
+};
+
+void pushRecord(const SpanRecord & record)
+{
+    static thread_local ThreadRingHolder holder;
+    holder.push(record);
+}
+
+void copyDetail(char * dst, size_t dstSize, const char * detail)
+{
+    if (!detail)
+    {
+        dst[0] = 0;
+        return;
+    }
+    strncpy(dst, detail, dstSize - 1);
+    dst[dstSize - 1] = 0;
+}
+
+int64_t toNS(const std::chrono::steady_clock::time_point & t)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+uint64_t createTraceId()
+{
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    uint64_t r;
+    while ((r = generator()) == 0)
+    {
+    }
+    return r;
+}
+
+std::string getCategory(const char * name)
+{
+    const char * dot = strchr(name, '.');
+    return dot ? std::string(name, dot - name) : std::string(name);
+}
+
+} // namespace
+
+void Mantids30::Program::Tracing::setEnabled(bool enabled)
+{
+    g_enabled = enabled;
+}
+
+bool Mantids30::Program::Tracing::isEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void Mantids30::Program::Tracing::setSamplingRate(uint32_t oneInN)
+{
+    g_samplingRate = oneInN;
+}
+
+bool Mantids30::Program::Tracing::shouldSample()
+{
+    if (!g_enabled.load(std::memory_order_relaxed))
+        return false;
+    uint32_t rate = g_samplingRate.load(std::memory_order_relaxed);
+    if (rate == 0)
+        return false;
+    return g_sampleCounter.fetch_add(1, std::memory_order_relaxed) % rate == 0;
+}
+
+void Mantids30::Program::Tracing::setRequestTriggerAllowed(bool allowed)
+{
+    g_requestTriggerAllowed = allowed;
+}
+
+bool Mantids30::Program::Tracing::isRequestTriggerAllowed()
+{
+    return g_enabled.load(std::memory_order_relaxed) && g_requestTriggerAllowed.load(std::memory_order_relaxed);
+}
+
+void Mantids30::Program::Tracing::setRingCapacity(size_t records)
+{
+    Rings & rings = getRings();
+    std::lock_guard<std::mutex> lock(rings.mutex);
+    rings.capacity = records;
+}
+
+void Mantids30::Program::Tracing::recordSpan(const char *name, const std::chrono::steady_clock::time_point &start,
+                                             const std::chrono::steady_clock::time_point &end, const char *detail)
+{
+    ThreadContext & context = getThreadContext();
+    if (context.traceId == 0)
+        return;
+
+    SpanRecord record;
+    record.traceId = context.traceId;
+    record.spanId = g_nextSpanId.fetch_add(1, std::memory_order_relaxed);
+    record.parentSpanId = context.spanId;
+    record.name = name;
+    copyDetail(record.detail, sizeof(record.detail), detail);
+    record.startNS = toNS(start);
+    record.durationNS = std::max<int64_t>(toNS(end) - record.startNS, 0);
+    pushRecord(record);
+}
+
+std::string Mantids30::Program::Tracing::dumpChromeTrace(uint64_t traceId)
+{
+    std::vector<SpanRecord> records;
+
+    {
+        Rings & rings = getRings();
+        std::lock_guard<std::mutex> lock(rings.mutex);
+        for (ThreadRing * ring : rings.all)
+        {
+            std::lock_guard<std::mutex> ringLock(ring->mutex);
+            size_t count = std::min<uint64_t>(ring->written, ring->records.size());
+            for (size_t i = 0; i < count; i++)
+            {
+                const SpanRecord & record = ring->records[i];
+                if (traceId == 0 || record.traceId == traceId)
+                    records.push_back(record);
+            }
+        }
+    }
+
+    std::sort(records.begin(), records.end(), [](const SpanRecord & a, const SpanRecord & b) { return a.startNS < b.startNS; });
+
+#ifdef _WIN32
+    Json::UInt64 pid = GetCurrentProcessId();
+#else
+    Json::UInt64 pid = getpid();
+#endif
+
+    json events = Json::arrayValue;
+    for (const SpanRecord & record : records)
+    {
+        json event;
+        event["name"] = record.name;
+        event["cat"] = getCategory(record.name);
+        event["ph"] = "X";
+        event["ts"] = static_cast<double>(record.startNS) / 1000.0;
+        event["dur"] = static_cast<double>(record.durationNS) / 1000.0;
+        event["pid"] = pid;
+        event["tid"] = record.threadId;
+        event["args"]["traceId"] = traceIdToString(record.traceId);
+        event["args"]["spanId"] = static_cast<Json::UInt64>(record.spanId);
+        event["args"]["parentId"] = static_cast<Json::UInt64>(record.parentSpanId);
+        if (record.detail[0])
+            event["args"]["detail"] = record.detail;
+        events.append(event);
+    }
+
+    json r;
+    r["traceEvents"] = events;
+    r["displayTimeUnit"] = "ns";
+
+    // Microseconds with nanosecond resolution:
+    Json::StreamWriterBuilder builder;
+    builder.settings_["indentation"] = "";
+    builder.settings_["precision"] = 3;
+    builder.settings_["precisionType"] = "decimal";
+    return Json::writeString(builder, r);
+}
+
+bool Mantids30::Program::Tracing::writeChromeTrace(const std::string &filePath, uint64_t traceId)
+{
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open())
+        return false;
+    file << dumpChromeTrace(traceId);
+    return file.good();
+}
+
+std::string Mantids30::Program::Tracing::traceIdToString(uint64_t traceId)
+{
+    char r[17];
+    snprintf(r, sizeof(r), "%016llx", static_cast<unsigned long long>(traceId));
+    return r;
+}
+
+uint64_t Mantids30::Program::Tracing::traceIdFromString(const std::string &traceId)
+{
+    if (traceId.empty() || traceId.size() > 16)
+        return 0;
+    uint64_t r = 0;
+    for (char c : traceId)
+    {
+        r <<= 4;
+        if (c >= '0' && c <= '9')
+            r |= static_cast<uint64_t>(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            r |= static_cast<uint64_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            r |= static_cast<uint64_t>(c - 'A' + 10);
+        else
+            return 0;
+    }
+    return r;
+}
+
+void Span::begin(const char *name, const char *detail)
+{
+    ThreadContext & context = getThreadContext();
+    m_name = name;
+    copyDetail(m_detail, sizeof(m_detail), detail);
+    m_parentSpanId = context.spanId;
+    m_spanId = g_nextSpanId.fetch_add(1, std::memory_order_relaxed);
+    context.spanId = m_spanId;
+    m_start = std::chrono::steady_clock::now();
+}
+
+void Span::end()
+{
+    auto end = std::chrono::steady_clock::now();
+    ThreadContext & context = getThreadContext();
+    context.spanId = m_parentSpanId;
+    if (context.traceId == 0)
+        return;
+
+    SpanRecord record;
+    record.traceId = context.traceId;
+    record.spanId = m_spanId;
+    record.parentSpanId = m_parentSpanId;
+    record.name = m_name;
+    memcpy(record.detail, m_detail, sizeof(record.detail));
+    record.startNS = toNS(m_start);
+    record.durationNS = std::max<int64_t>(toNS(end) - record.startNS, 0);
+    pushRecord(record);
+}
+
+Trace::Trace(const char *name, bool traced, const std::chrono::steady_clock::time_point &start, const char *detail)
+{
+    ThreadContext & context = getThreadContext();
+    if (context.traceId == 0)
+    {
+        if (!traced)
+            return;
+        context.traceId = createTraceId();
+        context.spanId = 0;
+        m_isRoot = true;
+    }
+    m_traceId = context.traceId;
+    m_span.begin(name, detail);
+    m_span.m_start = start;
+}
+
+Trace::~Trace()
+{
+    if (m_span.m_name)
+    {
+        m_span.end();
+        m_span.m_name = nullptr;
+    }
+    if (m_isRoot)
+    {
+        ThreadContext & context = getThreadContext();
+        context.traceId = 0;
+        context.spanId = 0;
+    }
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Mantids30 { namespace Program { namespace Tracing {
+
+/**
+ * @brief Request tracing based on per-thread ring buffers of timestamped span records.
+ *
+ * A request is traced when a Trace object is created with traced=true (eg. by sampling, or because the client asked
+ * for it). While the trace is active, every Span created in the same thread is recorded as a child of the current span,
+ * and the records can be dumped in the Chrome Trace Event format (chrome://tracing, https://ui.perfetto.dev).
+ *
+ * When the thread is not tracing a request, creating a Span costs only a thread-local read and a predictable branch.
+ *
+ * Span names are not copied: they must be string literals (or any other string with static storage).
+ * By convention, the name prefix before the first dot is the category (eg. "http.parse" -> "http").
+ */
+
+/**
+ * @brief The ThreadContext struct holds the trace being processed by the current thread.
+ */
+struct ThreadContext
+{
+    /**
+     * @brief traceId current trace (0: the thread is not tracing)
+     */
+    uint64_t traceId = 0;
+    /**
+     * @brief spanId current (innermost) span, parent of the new spans.
+     */
+    uint64_t spanId = 0;
+};
+
+/**
+ * @brief getThreadContext Get the trace context of the calling thread
+ */
+inline ThreadContext & getThreadContext()
+{
+    static thread_local ThreadContext context;
+    return context;
+}
+
+/**
+ * @brief isTracing Check if the calling thread is tracing a request
+ */
+inline bool isTracing()
+{
+    return getThreadContext().traceId != 0;
+}
+
+/**
+ * @brief setEnabled Enable or disable the creation of new traces (disabled by default)
+ */
+void setEnabled(bool enabled);
+/**
+ * @brief isEnabled Check if the creation of new traces is enabled
+ */
+bool isEnabled();
+/**
+ * @brief setSamplingRate Trace one of every N requests
+ * @param oneInN sampling rate (0: only the requests that ask for it are traced)
+ */
+void setSamplingRate(uint32_t oneInN);
+/**
+ * @brief shouldSample Decide if the next request should be traced (always false when tracing is disabled)
+ */
+bool shouldSample();
+/**
+ * @brief setRequestTriggerAllowed Allow (or not) the clients to ask for the tracing of their requests (eg. by a request header)
+ */
+void setRequestTriggerAllowed(bool allowed);
+/**
+ * @brief isRequestTriggerAllowed Check if the tracing can be triggered by the request (always false when tracing is disabled)
+ */
+bool isRequestTriggerAllowed();
+/**
+ * @brief setRingCapacity Set the number of span records kept by each thread (applies to the threads that record their first span after the call)
+ */
+void setRingCapacity(size_t records);
+
+/**
+ * @brief recordSpan Record an already finished span as a child of the current span (eg. phases measured before the trace started).
+ *        Does nothing if the thread is not tracing.
+ * @param name span name (static storage)
+ * @param start span start
+ * @param end span end
+ * @param detail optional detail (truncated)
+ */
+void recordSpan(const char * name, const std::chrono::steady_clock::time_point & start, const std::chrono::steady_clock::time_point & end,
+                const char * detail = nullptr);
+
+/**
+ * @brief dumpChromeTrace Dump the recorded spans in the Chrome Trace Event (JSON) format
+ * @param traceId only dump this trace (0: all the recorded spans)
+ */
+std::string dumpChromeTrace(uint64_t traceId = 0);
+/**
+ * @brief writeChromeTrace Write the recorded spans into a file in the Chrome Trace Event format
+ * @return true if the file was written
+ */
+bool writeChromeTrace(const std::string & filePath, uint64_t traceId = 0);
+
+/**
+ * @brief traceIdToString Get the hexadecimal representation (16 characters) of a trace id
+ */
+std::string traceIdToString(uint64_t traceId);
+/**
+ * @brief traceIdFromString Parse the hexadecimal representation of a trace id
+ * @return trace id (0 if invalid)
+ */
+uint64_t traceIdFromString(const std::string & traceId);
+
+/**
+ * @brief RAII span: measures the scope where it lives and records it as a child of the current span.
+ */
+class Span
+{
+public:
+    Span(const char * name, const char * detail = nullptr)
+    {
+        if (getThreadContext().traceId == 0)
+        {
+            m_name = nullptr;
+            return;
+        }
+        begin(name, detail);
+    }
+    Span(const char * name, const std::string & detail)
+    {
+        if (getThreadContext().traceId == 0)
+        {
+            m_name = nullptr;
+            return;
+        }
+        begin(name, detail.c_str());
+    }
+    ~Span()
+    {
+        if (m_name)
+            end();
+    }
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+private:
+    Span()
+        : m_name(nullptr)
+    {
+    }
+    void begin(const char * name, const char * detail);
+    void end();
+
+    friend class Trace;
+
+    const char * m_name;
+    char m_detail[48];
+    uint64_t m_spanId;
+    uint64_t m_parentSpanId;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief RAII trace root: starts a new trace in the calling thread (when traced is true) and finishes it at the end of the scope.
+ *
+ * If the thread is already tracing, it behaves as a child span of the current trace.
+ */
+class Trace
+{
+public:
+    /**
+     * @param name root span name (static storage)
+     * @param traced true to trace this request (eg. shouldSample())
+     * @param detail optional detail (truncated)
+     */
+    Trace(const char * name, bool traced, const char * detail = nullptr)
+        : Trace(name, traced, std::chrono::steady_clock::now(), detail)
+    {
+    }
+    Trace(const char * name, bool traced, const std::string & detail)
+        : Trace(name, traced, std::chrono::steady_clock::now(), detail.c_str())
+    {
+    }
+    /**
+     * @param start root span start (eg. when the connection was accepted)
+     */
+    Trace(const char * name, bool traced, const std::chrono::steady_clock::time_point & start, const char * detail = nullptr);
+    ~Trace();
+    Trace(const Trace &) = delete;
+    Trace &operator=(const Trace &) = delete;
+
+    /**
+     * @brief isActive Check if the request is being traced
+     */
+    bool isActive() const { return m_span.m_name != nullptr; }
+    /**
+     * @brief getTraceId Get the trace id (0 if not traced)
+     */
+    uint64_t getTraceId() const { return m_traceId; }
+
+private:
+    Span m_span;
+    uint64_t m_traceId = 0;
+    bool m_isRoot = false;
+};
+
+}}}
@@ -1,5 +1,7 @@
 #include "fastrpc.h"
 #include <Mantids30/Threads/lock_shared.h>
+#include <algorithm>
+#include <limits>
 #include <memory>
 
 using namespace Mantids30::Network::Protocols::FastRPC;
@@ -34,6 +36,9 @@ FastRPC1::FastRPC1(uint32_t threadsCount, uint32_t taskQueues)
     setMaxMessageSize();
     setQueuePushTimeoutInMS();
     setRemoteExecutionDisconnectedTries();
+    setMaxInFlightRequests();
+    setUseMultiCallFrames();
+    setMaxQueuedBytes();
 
     m_threadPool->start();
     m_pinger = std::thread(fastRPCPingerThread,this);
@@ -159,40 +164,54 @@ int FastRPC1::processAnswer(FastRPC1::Connection * connection)
     }
 
     ////////////////////////////////////////////////////////////
-    if (true)
+    std::shared_ptr<FastRPC1::PendingRequest> pending;
     {
         std::unique_lock<std::mutex> lk(connection->mtAnswers);
-        if ( connection->pendingRequests.find(requestId) != connection->pendingRequests.end())
-        {
-            connection->executionStatus[requestId] = executionStatus;
+        auto i = connection->pendingRequests.find(requestId);
+        if (i != connection->pendingRequests.end() && !i->second->answered)
+            pending = i->second;
+    }
 
-            Mantids30::Helpers::JSONReader2 reader;
-            bool parsingSuccessful = reader.parse( payloadBytes, connection->answers[requestId] );
+    if (pending)
+    {
+        // Parse outside the lock (other answers can be delivered meanwhile):
+        json answer;
+        Mantids30::Helpers::JSONReader2 reader;
+        bool parsingSuccessful = reader.parse( payloadBytes, answer );
+
+        std::unique_lock<std::mutex> lk(connection->mtAnswers);
+        // The caller may have given up in the meantime...
+        auto i = connection->pendingRequests.find(requestId);
+        if (i != connection->pendingRequests.end() && i->second == pending && !pending->answered)
+        {
             if (parsingSuccessful)
             {
-                // Notify that there is a new answer... everyone have to check if it's for him.
-                connection->cvAnswers.notify_all();
+                pending->answer = std::move(answer);
+                pending->executionStatus = executionStatus;
             }
             else
             {
-                // if not able to answer, please remove from answers...
-                // TODO: notify this malformed data...
-                connection->answers.erase(requestId);
-                connection->executionStatus.erase(requestId);
-                connection->pendingRequests.erase(requestId);
+                // Malformed answer, report it as a generic error.
+                pending->executionStatus = EXEC_STATUS_ERR_GENERIC;
             }
-        }
-        else
-        {
-            eventUnexpectedAnswerReceived(connection, payloadBytes );
+            pending->answered = true;
+
+            // Wake only the caller of this request, and return the credit:
+            pending->cond.notify_one();
+            connection->inFlight--;
+            connection->cvCredits.notify_one();
         }
     }
+    else
+    {
+        eventUnexpectedAnswerReceived(connection, payloadBytes );
+    }
 
     delete [] payloadBytes;
     return 1;
 }
 
-int FastRPC1::processQuery(std::shared_ptr<Sockets::Socket_Stream> stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared * mtDone, Threads::Sync::Mutex * mtSocket, std::shared_ptr<void> context, const std::string &data)
+int FastRPC1::processQuery(std::shared_ptr<Sockets::Socket_Stream> stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared * mtDone, FrameSender * sender, std::shared_ptr<void> context, const std::string &data)
 {
     uint32_t maxAlloc = m_maxMessageSize;
     uint64_t requestId;
@@ -226,7 +245,7 @@ int FastRPC1::processQuery(std::shared_ptr<Sockets::Socket_Stream> stream, const
     params->requestId = requestId;
     params->methodName = methodName;
     params->done = mtDone;
-    params->mtSocket = mtSocket;
+    params->sender = sender;
     params->streamBack = stream;
     params->caller = this;
     params->key = key;
@@ -258,6 +277,24 @@ int FastRPC1::processQuery(std::shared_ptr<Sockets::Socket_Stream> stream, const
     return 1;
 }
 
+int FastRPC1::processMultiQuery(std::shared_ptr<Sockets::Socket_Stream> stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared *mtDone, FrameSender *sender, std::shared_ptr<void> context, const std::string &data)
+{
+    ////////////////////////////////////////////////////////////
+    // READ THE NUMBER OF QUERIES (each one is a query frame without the type)
+    uint32_t count = stream->readU<uint32_t>();
+    if (!count || count > 65536)
+    {
+        return -4;
+    }
+
+    int ret = 1;
+    for (uint32_t i = 0; i < count && ret > 0; i++)
+    {
+        ret = processQuery(stream,key,priority,mtDone,sender,context,data);
+    }
+    return ret;
+}
+
 std::shared_ptr<void> FastRPC1::getOverwriteObject() const
 {
     return m_overwriteContext;
@@ -288,6 +325,21 @@ void FastRPC1::setRemoteExecutionTimeoutInMS(const uint32_t &value)
     m_remoteExecutionTimeoutInMS = value;
 }
 
+void FastRPC1::setMaxInFlightRequests(const uint32_t &value)
+{
+    m_maxInFlightRequests = value;
+}
+
+void FastRPC1::setUseMultiCallFrames(const bool &value)
+{
+    m_useMultiCallFrames = value;
+}
+
+void FastRPC1::setMaxQueuedBytes(const uint32_t &value)
+{
+    m_maxQueuedBytes = value;
+}
+
 int FastRPC1::processConnection(std::shared_ptr<Sockets::Socket_Stream> stream, const std::string &key, const FastRPC1::CallBackOnConnected &_cb_OnConnected, const float &keyDistFactor, std::shared_ptr<void> context, const std::string &data)
 {
 #ifndef _WIN32
@@ -297,12 +349,12 @@ int FastRPC1::processConnection(std::shared_ptr<Sockets::Socket_Stream> stream,
     int ret = 1;
 
     Threads::Sync::Mutex_Shared mtDone;
-    Threads::Sync::Mutex mtSocket;
+    FrameSender sender(stream, m_maxQueuedBytes);
 
     FastRPC1::Connection * connection = new FastRPC1::Connection;
     connection->context = context;
     connection->data = data;
-    connection->mtSocket = &mtSocket;
+    connection->sender = &sender;
     connection->key = key;
     connection->stream = stream;
 
@@ -335,7 +387,11 @@ int FastRPC1::processConnection(std::shared_ptr<Sockets::Socket_Stream> stream,
             break;
         case 'Q':
             // Process Query
-            ret = processQuery(stream,key,keyDistFactor,&mtDone,&mtSocket,context,data);
+            ret = processQuery(stream,key,keyDistFactor,&mtDone,&sender,context,data);
+            break;
+        case 'M':
+            // Process Multiple Queries
+            ret = processMultiQuery(stream,key,keyDistFactor,&mtDone,&sender,context,data);
             break;
         case 0:
             // Remote shutdown
@@ -359,14 +415,65 @@ int FastRPC1::processConnection(std::shared_ptr<Sockets::Socket_Stream> stream,
 
     stream->shutdownSocket();
 
-    connection->terminated = true;
-    connection->cvAnswers.notify_all();
+    {
+        // Wake every caller waiting for an answer or for a credit:
+        std::unique_lock<std::mutex> lk(connection->mtAnswers);
+        connection->terminated = true;
+        for (auto & i : connection->pendingRequests)
+            i.second->cond.notify_all();
+        connection->cvCredits.notify_all();
+    }
 
     m_connectionsByKeyId.destroyElement(key);
 
     return ret;
 }
 
+FastRPC1::FrameSender::FrameSender(std::shared_ptr<Sockets::Socket_Stream> stream, const size_t &maxQueuedBytes)
+{
+    m_stream = stream;
+    m_maxQueuedBytes = maxQueuedBytes;
+}
+
+bool FastRPC1::FrameSender::send(const std::string &frame)
+{
+    std::unique_lock<std::mutex> lk(m_mutex);
+
+    // Backpressure: don't queue more while the peer is not reading.
+    while (!m_failed && m_writing && !m_queue.empty() && m_queue.size() + frame.size() > m_maxQueuedBytes)
+        m_drained.wait(lk);
+
+    if (m_failed)
+        return false;
+
+    m_queue.append(frame);
+    if (m_writing)
+    {
+        // The current writer will send it.
+        return true;
+    }
+
+    // Become the writer until the queue is empty:
+    m_writing = true;
+    while (!m_queue.empty() && !m_failed)
+    {
+        m_writeBuffer.swap(m_queue);
+        m_drained.notify_all();
+
+        lk.unlock();
+        bool ok = m_stream->writeFull(m_writeBuffer.data(), m_writeBuffer.size());
+        m_writeBuffer.clear();
+        lk.lock();
+
+        if (!ok)
+            m_failed = true;
+    }
+    m_writing = false;
+    m_drained.notify_all();
+
+    return !m_failed;
+}
+
 void FastRPC1::executeRPCTask(std::shared_ptr<void> taskData)
 {
     FastRPC1::ThreadParameters * params = (FastRPC1::ThreadParameters *)(taskData.get());
@@ -383,15 +490,15 @@ void FastRPC1::executeRPCTask(std::shared_ptr<void> taskData)
 
 void FastRPC1::sendRPCAnswer(FastRPC1::ThreadParameters *params, const std::string &answer, uint8_t executionStatus)
 {
-    // Send a block.
-    params->mtSocket->lock();
-    if (    params->streamBack->writeU<uint8_t>('A') && // ANSWER
-            params->streamBack->writeU<uint64_t>(params->requestId) &&
-            params->streamBack->writeU<uint8_t>(executionStatus) &&
-            params->streamBack->writeStringEx<uint32_t>(answer.size()<=params->maxMessageSize?answer:"",params->maxMessageSize ) )
+    // Queue the answer block (answers are sent as the tasks finish, in any order).
+    FrameBuffer frame;
+    if (    frame.writeU<uint8_t>('A') && // ANSWER
+            frame.writeU<uint64_t>(params->requestId) &&
+            frame.writeU<uint8_t>(executionStatus) &&
+            frame.writeStringEx<uint32_t>(answer.size()<=params->maxMessageSize?answer:"",params->maxMessageSize ) )
     {
+        params->sender->send(frame.getData());
     }
-    params->mtSocket->unlock();
 }
 
 void FastRPC1::setMaxMessageSize(const uint32_t &value)
@@ -399,25 +506,8 @@ void FastRPC1::setMaxMessageSize(const uint32_t &value)
     m_maxMessageSize = value;
 }
 
-json FastRPC1::runRemoteRPCMethod(const std::string &connectionKey, const std::string &methodName, const json &payload, json *error, bool retryIfDisconnected)
+FastRPC1::Connection *FastRPC1::openConnection(const std::string &connectionKey, const std::string &methodName, const json &payload, json *error, bool retryIfDisconnected)
 {
-    json r;
-
-    Json::StreamWriterBuilder builder;
-    builder.settings_["indentation"] = "";
-    std::string output = Json::writeString(builder, payload);
-
-    if (output.size()>m_maxMessageSize)
-    {
-        if (error)
-        {
-            (*error)["succeed"] = false;
-            (*error)["errorId"] = 1;
-            (*error)["errorMessage"] = "Payload exceed the Maximum Message Size.";
-        }
-        return r;
-    }
-
     FastRPC1::Connection * connection;
 
     uint32_t _tries=0;
@@ -433,73 +523,74 @@ json FastRPC1::runRemoteRPCMethod(const std::string &connectionKey, const std::s
                 (*error)["errorId"] = 2;
                 (*error)["errorMessage"] = "Abort after remote peer not found/connected.";
             }
-            return r;
+            return nullptr;
         }
         sleep(1);
     }
+    return connection;
+}
 
-    uint64_t requestId;
-    // Create a request ID.
-    connection->mtReqIdCt.lock();
-    requestId = connection->requestIdCounter++;
-    connection->mtReqIdCt.unlock();
-
-    if (1)
+bool FastRPC1::acquireCredits(FastRPC1::Connection *connection, const std::chrono::steady_clock::time_point &deadline, uint32_t *credits)
+{
+    std::unique_lock<std::mutex> lk(connection->mtAnswers);
+    for (;;)
     {
-        std::unique_lock<std::mutex> lk(connection->mtAnswers);
-        // Create authorization to be inserted:
-        connection->pendingRequests.insert(requestId);
-    }
+        if (connection->terminated)
+            return false;
 
-    connection->mtSocket->lock();
-    if (    connection->stream->writeU<uint8_t>('Q') && // QUERY FOR ANSWER
-            connection->stream->writeU<uint64_t>(requestId) &&
-            connection->stream->writeStringEx<uint8_t>(methodName) &&
-            connection->stream->writeStringEx<uint32_t>( output,m_maxMessageSize ) )
-    {
+        uint32_t maxInFlight = m_maxInFlightRequests;
+        if (maxInFlight == 0)
+        {
+            connection->inFlight += *credits;
+            return true;
+        }
+        if (connection->inFlight < maxInFlight)
+        {
+            // Take what is available (at least one):
+            *credits = std::min(*credits, maxInFlight - connection->inFlight);
+            connection->inFlight += *credits;
+            return true;
+        }
+        if (connection->cvCredits.wait_until(lk, deadline) == std::cv_status::timeout && connection->inFlight >= maxInFlight)
+            return false;
     }
-    connection->mtSocket->unlock();
+}
 
-    // Time to wait for answers...
-    for (;;)
+void FastRPC1::completeCall(FastRPC1::Connection *connection, const uint64_t &requestId, const std::chrono::steady_clock::time_point &deadline, const std::string &methodName, const json &payload, json *answer, json *error)
+{
+    bool timedOut = false;
     {
         std::unique_lock<std::mutex> lk(connection->mtAnswers);
+        std::shared_ptr<FastRPC1::PendingRequest> pending = connection->pendingRequests[requestId];
 
-        // Process multiple signals until our answer comes...
-
-        if (connection->cvAnswers.wait_for(lk,Ms(m_remoteExecutionTimeoutInMS)) == std::cv_status::timeout )
+        // Wait for our answer only (the other answers are delivered to their own waiters):
+        while (!pending->answered && !connection->terminated)
         {
-            // break by timeout. (no answer)
-            eventRemoteExecutionTimedOut(connectionKey,methodName,payload);
-            if (error)
+            if (pending->cond.wait_until(lk, deadline) == std::cv_status::timeout && !pending->answered)
             {
-                (*error)["succeed"] = false;
-                (*error)["errorId"] = 3;
-                (*error)["errorMessage"] = "Remote Execution Timed Out: No Answer Received.";
+                timedOut = true;
+                break;
             }
-            break;
         }
 
-        if ( lk.owns_lock() && connection->answers.find(requestId) != connection->answers.end())
+        if (pending->answered)
         {
-            // break by element found. (answer)
-            uint8_t executionStatus = connection->executionStatus[requestId];
-            r = connection->answers[requestId];
+            *answer = std::move(pending->answer);
             if (error)
             {
-                switch (executionStatus)
+                switch (pending->executionStatus)
                 {
-                case 2:
+                case EXEC_STATUS_SUCCESS:
                     (*error)["succeed"] = true;
                     (*error)["errorId"] = 0;
                     (*error)["errorMessage"] = "Execution OK.";
                     break;
-                case 3:
+                case EXEC_STATUS_ERR_REMOTE_QUEUE_OVERFLOW:
                     (*error)["succeed"] = false;
                     (*error)["errorId"] = 4;
                     (*error)["errorMessage"] = "Remote Execution Failed: Full Queue.";
                     break;
-                case 4:
+                case EXEC_STATUS_ERR_METHOD_NOT_FOUND:
                     (*error)["succeed"] = false;
                     (*error)["errorId"] = 5;
                     (*error)["errorMessage"] = "Remote Execution Failed: Method Not Found.";
@@ -509,31 +600,36 @@ json FastRPC1::runRemoteRPCMethod(const std::string &connectionKey, const std::s
 
                 }
             }
-            break;
         }
-
-        if ( lk.owns_lock() && connection->terminated )
+        else
         {
-            if (error)
+            // Not answered, return the credit.
+            connection->inFlight--;
+            connection->cvCredits.notify_one();
+
+            if (!timedOut && error)
             {
                 (*error)["succeed"] = false;
                 (*error)["errorId"] = 6;
                 (*error)["errorMessage"] = "Connection is terminated: No Answer Received.";
             }
-            break;
         }
-    }
 
-    if (1)
-    {
-        std::unique_lock<std::mutex> lk(connection->mtAnswers);
         // Revoke authorization to be inserted, clean results...
-        connection->answers.erase(requestId);
-        connection->executionStatus.erase(requestId);
         connection->pendingRequests.erase(requestId);
     }
 
-    m_connectionsByKeyId.releaseElement(connectionKey);
+    if (timedOut)
+    {
+        // break by timeout. (no answer)
+        eventRemoteExecutionTimedOut(connection->key,methodName,payload);
+        if (error)
+        {
+            (*error)["succeed"] = false;
+            (*error)["errorId"] = 3;
+            (*error)["errorMessage"] = "Remote Execution Timed Out: No Answer Received.";
+        }
+    }
 
     if (error)
     {
@@ -544,7 +640,140 @@ json FastRPC1::runRemoteRPCMethod(const std::string &connectionKey, const std::s
             (*error)["errorMessage"] = "Unknown Error.";
         }
     }
+}
+
+json FastRPC1::runRemoteRPCMethod(const std::string &connectionKey, const std::string &methodName, const json &payload, json *error, bool retryIfDisconnected)
+{
+    std::vector<RemoteCall> calls(1);
+    calls[0].methodName = methodName;
+    calls[0].payload = payload;
+
+    runRemoteRPCMethods(connectionKey, calls, retryIfDisconnected);
+
+    if (error)
+        *error = calls[0].error;
+    return calls[0].answer;
+}
+
+bool FastRPC1::runRemoteRPCMethods(const std::string &connectionKey, std::vector<RemoteCall> &calls, bool retryIfDisconnected)
+{
+    Json::StreamWriterBuilder builder;
+    builder.settings_["indentation"] = "";
+
+    // Serialize the payloads first (invalid calls are not sent):
+    std::vector<std::string> outputs(calls.size());
+    std::vector<bool> valid(calls.size(), false);
+    size_t validCount = 0;
+    for (size_t i = 0; i < calls.size(); i++)
+    {
+        calls[i].answer = Json::nullValue;
+        calls[i].error = Json::nullValue;
+        outputs[i] = Json::writeString(builder, calls[i].payload);
+
+        if (outputs[i].size()>m_maxMessageSize)
+        {
+            calls[i].error["succeed"] = false;
+            calls[i].error["errorId"] = 1;
+            calls[i].error["errorMessage"] = "Payload exceed the Maximum Message Size.";
+        }
+        else if (calls[i].methodName.size() >= std::numeric_limits<uint8_t>::max())
+        {
+            calls[i].error["succeed"] = false;
+            calls[i].error["errorId"] = 8;
+            calls[i].error["errorMessage"] = "Invalid Method Name.";
+        }
+        else
+        {
+            valid[i] = true;
+            validCount++;
+        }
+    }
+
+    if (!validCount)
+        return false;
+
+    json connectionError;
+    FastRPC1::Connection * connection = openConnection(connectionKey, calls.size() == 1 ? calls[0].methodName : "", calls.size() == 1 ? calls[0].payload : json(), &connectionError, retryIfDisconnected);
+    if (!connection)
+    {
+        for (size_t i = 0; i < calls.size(); i++)
+        {
+            if (valid[i])
+                calls[i].error = connectionError;
+        }
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + Ms(m_remoteExecutionTimeoutInMS);
+    std::vector<uint64_t> requestIds(calls.size(), 0);
+
+    size_t next = 0;
+    while (validCount)
+    {
+        // Take as many in-flight slots as possible (waits while the window is full):
+        uint32_t credits = static_cast<uint32_t>(std::min<size_t>(validCount, std::numeric_limits<uint32_t>::max()));
+        if (!acquireCredits(connection, deadline, &credits))
+            break;
+
+        FrameBuffer frame;
+        std::vector<size_t> group;
+        {
+            std::unique_lock<std::mutex> lk(connection->mtAnswers);
+            for (; next < calls.size() && group.size() < credits; next++)
+            {
+                if (!valid[next])
+                    continue;
+                requestIds[next] = connection->requestIdCounter++;
+                // Create authorization to be inserted:
+                connection->pendingRequests[requestIds[next]] = std::make_shared<FastRPC1::PendingRequest>();
+                group.push_back(next);
+            }
+        }
+        validCount -= group.size();
+
+        bool useMultiCallFrame = m_useMultiCallFrames && group.size() > 1;
+        if (useMultiCallFrame)
+        {
+            frame.writeU<uint8_t>('M'); // MULTIPLE QUERIES FOR ANSWER
+            frame.writeU<uint32_t>(static_cast<uint32_t>(group.size()));
+        }
+        for (size_t i : group)
+        {
+            if (!useMultiCallFrame)
+                frame.writeU<uint8_t>('Q'); // QUERY FOR ANSWER
+            frame.writeU<uint64_t>(requestIds[i]);
+            frame.writeStringEx<uint8_t>(calls[i].methodName);
+            frame.writeStringEx<uint32_t>(outputs[i], m_maxMessageSize);
+        }
+
+        // Queue the whole group in one piece (if the connection fails, the waiters are released on termination):
+        connection->sender->send(frame.getData());
+    }
+
+    // Time to wait for answers...
+    bool r = true;
+    for (size_t i = 0; i < calls.size(); i++)
+    {
+        if (requestIds[i])
+        {
+            completeCall(connection, requestIds[i], deadline, calls[i].methodName, calls[i].payload, &calls[i].answer, &calls[i].error);
+        }
+        else if (valid[i])
+        {
+            // Not sent: no credits available before the deadline.
+            bool terminated = connection->terminated;
+            calls[i].error["succeed"] = false;
+            calls[i].error["errorId"] = terminated ? 6 : 7;
+            calls[i].error["errorMessage"] = terminated ? "Connection is terminated: No Answer Received." : "Remote Execution Failed: Too Many Requests In Flight.";
+            if (!terminated)
+                eventRemoteExecutionTimedOut(connectionKey,calls[i].methodName,calls[i].payload);
+        }
+
+        if (!JSON_ASBOOL(calls[i].error, "succeed", false))
+            r = false;
+    }
 
+    m_connectionsByKeyId.releaseElement(connectionKey);
     return r;
 }
 
@@ -555,12 +784,11 @@ bool FastRPC1::runRemoteClose(const std::string &connectionKey)
     FastRPC1::Connection * connection;
     if ((connection=(FastRPC1::Connection *)m_connectionsByKeyId.openElement(connectionKey))!=nullptr)
     {
-
-        connection->mtSocket->lock();
-        if (    connection->stream->writeU<uint8_t>(0) )
+        FrameBuffer frame;
+        if (    frame.writeU<uint8_t>(0) )
         {
+            connection->sender->send(frame.getData());
         }
-        connection->mtSocket->unlock();
 
         m_connectionsByKeyId.releaseElement(connectionKey);
     }
@@ -6,8 +6,10 @@
 #include <Mantids30/Threads/mutex_shared.h>
 #include <Mantids30/Threads/mutex.h>
 #include <Mantids30/Net_Sockets/socket_stream.h>
+#include <Mantids30/Net_Sockets/socket_stream_writer.h>
 #include <Mantids30/Threads/map.h>
 #include <memory>
+#include <vector>
 
 namespace Mantids30 { namespace Network { namespace Protocols { namespace FastRPC { 
 
@@ -35,13 +37,64 @@ public:
         std::shared_ptr<void> context = nullptr;
     };
 
+    /**
+     * @brief The FrameBuffer class serializes protocol frames in memory (same encoding as the socket writes).
+     */
+    class FrameBuffer : public Sockets::Socket_Stream_Writer
+    {
+    public:
+        FrameBuffer() = default;
+        const std::string & getData() const { return m_data; }
+        void clear() { m_data.clear(); m_failed = false; }
+        bool failed() const { return m_failed; }
+
+    protected:
+        bool writeFull(const void * data, const size_t & datalen) override
+        {
+            m_data.append(static_cast<const char *>(data), datalen);
+            return true;
+        }
+        void writeDeSync() override { m_failed = true; }
+
+    private:
+        std::string m_data;
+        bool m_failed = false;
+    };
+
+    /**
+     * @brief The FrameSender class is the connection sender queue (in place of a socket mutex).
+     *
+     * Senders append their frames to the queue and return. If no one is writing, the sender becomes the writer and
+     * writes everything queued (including the frames queued by others in the meantime) with one socket write, until the
+     * queue is empty. When the queue is full (the peer is not reading), senders wait until it is written.
+     */
+    class FrameSender
+    {
+    public:
+        FrameSender(std::shared_ptr<Sockets::Socket_Stream> stream, const size_t & maxQueuedBytes);
+        /**
+         * @brief send Queue the frame (and write the queue if no one is writing it)
+         * @return false if the connection failed.
+         */
+        bool send(const std::string & frame);
+
+    private:
+        std::shared_ptr<Sockets::Socket_Stream> m_stream;
+        std::string m_queue, m_writeBuffer;
+        size_t m_maxQueuedBytes;
+        bool m_writing = false;
+        bool m_failed = false;
+        std::mutex m_mutex;
+        std::condition_variable m_drained;
+    };
+
     struct ThreadParameters
     {
         std::shared_ptr<Sockets::Socket_Stream> streamBack;
         uint32_t maxMessageSize;
         void * caller;
         Threads::Sync::Mutex_Shared * done;
-        Threads::Sync::Mutex * mtSocket;
+        FrameSender * sender;
         std::string methodName;
         json payload;
         uint64_t requestId;
@@ -52,18 +105,31 @@ public:
         std::string data;
     };
 
+    /**
+     * @brief The PendingRequest struct is the waiter of a request sent to the peer (each one is signaled only by its own answer).
+     */
+    struct PendingRequest
+    {
+        std::condition_variable cond;
+        bool answered = false;
+        uint8_t executionStatus = 0;
+        json answer;
+    };
+
     class Connection : public Mantids30::Threads::Safe::MapItem
     {
     public:
         Connection()
         {
             stream = nullptr;
+            sender = nullptr;
             requestIdCounter = 1;
+            inFlight = 0;
             terminated = false;
         }
         // Socket
         std::shared_ptr<Sockets::Socket_Stream> stream;
-        Threads::Sync::Mutex * mtSocket;
+        FrameSender * sender;
         std::string key;
 
         // Accesible objects:
@@ -71,20 +137,37 @@ public:
         std::string data;
 
         // Request ID counter.
-        uint64_t requestIdCounter;
-        Threads::Sync::Mutex mtReqIdCt;
+        std::atomic<uint64_t> requestIdCounter;
 
-        // Answers:
-        std::map<uint64_t,json> answers;
-        std::map<uint64_t,uint8_t> executionStatus;
+        // Answers (protected by mtAnswers):
+        std::map<uint64_t,std::shared_ptr<PendingRequest>> pendingRequests;
         std::mutex mtAnswers;
-        std::condition_variable cvAnswers;
-        std::set<uint64_t> pendingRequests;
+
+        // In-flight window (requests sent and not answered yet), waiting senders are signaled by cvCredits:
+        uint32_t inFlight;
+        std::condition_variable cvCredits;
 
         // Finalization:
         std::atomic<bool> terminated;
     };
 
+    /**
+     * @brief The RemoteCall struct is a call inside a batch (runRemoteRPCMethods)
+     */
+    struct RemoteCall
+    {
+        std::string methodName;
+        json payload;
+        /**
+         * @brief answer Answer, or Json::nullValue if answer is not received or if timed out.
+         */
+        json answer;
+        /**
+         * @brief error same as the runRemoteRPCMethod error.
+         */
+        json error;
+    };
+
     enum eTaskExecutionStatus {
         EXEC_STATUS_ERR_GENERIC = 1,
         EXEC_STATUS_SUCCESS = 2,
@@ -202,6 +285,15 @@ public:
      * @return Answer, or Json::nullValue if answer is not received or if timed out.
      */
     json runRemoteRPCMethod( const std::string &connectionKey, const std::string &methodName, const json &payload , json * error, bool retryIfDisconnected = true );
+    /**
+     * @brief runRemoteRPCMethods Run many Remote RPC Methods at once (pipelined in the same connection, the answers may
+     *                            come in any order).
+     * @param connectionKey Connection ID
+     * @param calls methods and payloads, the answer and error of each call is filled in.
+     * @param retryIfDisconnected wait for the connection (see setRemoteExecutionDisconnectedTries)
+     * @return true if every call succeed.
+     */
+    bool runRemoteRPCMethods( const std::string &connectionKey, std::vector<RemoteCall> & calls, bool retryIfDisconnected = true );
     /**
      * @brief runRemoteClose Run Remote Close Method
      * @param connectionKey Connection ID (this class can thread-safe handle multiple connections at time)
@@ -228,6 +320,24 @@ public:
 
     void setRemoteExecutionDisconnectedTries(const uint32_t &value = 10);
 
+    /**
+     * @brief setMaxInFlightRequests Set the max number of requests waiting for the peer answer per connection. Further
+     *                               calls wait for a free slot (up to the remote execution timeout).
+     * @param value max requests (0: unlimited), default is 256.
+     */
+    void setMaxInFlightRequests(const uint32_t &value = 256);
+    /**
+     * @brief setUseMultiCallFrames Send runRemoteRPCMethods batches in a single multi-call frame (instead of one query
+     *                              frame per call). Enable it only when every peer runs a version that accepts them.
+     * @param value true to use multi-call frames, default is false.
+     */
+    void setUseMultiCallFrames(const bool &value = false);
+    /**
+     * @brief setMaxQueuedBytes Set the max bytes queued per connection before the senders wait for the socket.
+     * @param value bytes, default is 4M.
+     */
+    void setMaxQueuedBytes(const uint32_t &value = 4*1024*1024);
+
 
     /**
      * @brief getReadTimeout Get R/W Timeout
@@ -272,7 +382,12 @@ private:
     static void sendRPCAnswer(FastRPC1::ThreadParameters * parameters, const std::string & answer, uint8_t executionStatus);
 
     int processAnswer(FastRPC1::Connection *connection);
-    int processQuery(std::shared_ptr<Sockets::Socket_Stream> stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared *mtDone, Threads::Sync::Mutex *mtSocket, std::shared_ptr<void> context, const std::string &data);
+    int processQuery(std::shared_ptr<Sockets::Socket_Stream> stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared *mtDone, FrameSender *sender, std::shared_ptr<void> context, const std::string &data);
+    int processMultiQuery(std::shared_ptr<Sockets::Socket_Stream> stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared *mtDone, FrameSender *sender, std::shared_ptr<void> context, const std::string &data);
+
+    FastRPC1::Connection * openConnection(const std::string &connectionKey, const std::string &methodName, const json &payload, json * error, bool retryIfDisconnected);
+    bool acquireCredits(FastRPC1::Connection *connection, const std::chrono::steady_clock::time_point &deadline, uint32_t * credits);
+    void completeCall(FastRPC1::Connection *connection, const uint64_t &requestId, const std::chrono::steady_clock::time_point &deadline, const std::string &methodName, const json &payload, json * answer, json * error);
 
     // Stores active connections indexed by a unique key identifier.
     Mantids30::Threads::Safe::Map<std::string> m_connectionsByKeyId;
@@ -286,6 +401,9 @@ private:
     std::atomic<uint32_t> m_maxMessageSize;
     std::atomic<uint32_t> m_remoteExecutionTimeoutInMS;
     std::atomic<uint32_t> m_remoteExecutionDisconnectedTries;
+    std::atomic<uint32_t> m_maxInFlightRequests;
+    std::atomic<uint32_t> m_maxQueuedBytes;
+    std::atomic<bool> m_useMultiCallFrames;
 
     // Map storing available RPC methods.
     // Key: Method name (string).
@@ -0,0 +1,111 @@
+#include "fastrpc3.h"
+
+#include <functional>
+
+using namespace Mantids30::Network::Protocols::FastRPC;
+
+void FastRPC3::ConnectionIndex::add(const std::string &connectionId, const std::string &user, const std::string &domain, const std::set<std::string> &roles)
+{
+    EntryShard &entryShard = getEntryShard(connectionId);
+    std::lock_guard<std::mutex> lock(entryShard.mutex);
+
+    // A new login replaces the previous one:
+    removeLocked(entryShard, connectionId);
+
+    entryShard.entries[connectionId] = {user, domain, roles};
+    insert(userKey(user, domain), connectionId);
+    insert(domainKey(domain), connectionId);
+    for (const auto &role : roles)
+        insert(roleKey(role, domain), connectionId);
+}
+
+void FastRPC3::ConnectionIndex::remove(const std::string &connectionId)
+{
+    EntryShard &entryShard = getEntryShard(connectionId);
+    std::lock_guard<std::mutex> lock(entryShard.mutex);
+    removeLocked(entryShard, connectionId);
+}
+
+std::set<std::string> FastRPC3::ConnectionIndex::getByUser(const std::string &user, const std::string &domain)
+{
+    return get(userKey(user, domain));
+}
+
+std::set<std::string> FastRPC3::ConnectionIndex::getByDomain(const std::string &domain)
+{
+    return get(domainKey(domain));
+}
+
+std::set<std::string> FastRPC3::ConnectionIndex::getByRole(const std::string &role, const std::string &domain)
+{
+    return get(roleKey(role, domain));
+}
+
+// The index keys are prefixed by its type, and the NUL separator can't be part of the user/domain/role names:
+std::string FastRPC3::ConnectionIndex::userKey(const std::string &user, const std::string &domain)
+{
+    return std::string("u") + domain + '\0' + user;
+}
+
+std::string FastRPC3::ConnectionIndex::domainKey(const std::string &domain)
+{
+    return std::string("d") + domain;
+}
+
+std::string FastRPC3::ConnectionIndex::roleKey(const std::string &role, const std::string &domain)
+{
+    return std::string("r") + domain + '\0' + role;
+}
+
+FastRPC3::ConnectionIndex::Shard &FastRPC3::ConnectionIndex::getShard(const std::string &key)
+{
+    return m_shards[std::hash<std::string>()(key) % SHARD_COUNT];
+}
+
+FastRPC3::ConnectionIndex::EntryShard &FastRPC3::ConnectionIndex::getEntryShard(const std::string &connectionId)
+{
+    return m_entryShards[std::hash<std::string>()(connectionId) % SHARD_COUNT];
+}
+
+void FastRPC3::ConnectionIndex::removeLocked(EntryShard &entryShard, const std::string &connectionId)
+{
+    auto i = entryShard.entries.find(connectionId);
+    if (i == entryShard.entries.end())
+        return;
+
+    erase(userKey(i->second.user, i->second.domain), connectionId);
+    erase(domainKey(i->second.domain), connectionId);
+    for (const auto &role : i->second.roles)
+        erase(roleKey(role, i->second.domain), connectionId);
+
+    entryShard.entries.erase(i);
+}
+
+void FastRPC3::ConnectionIndex::insert(const std::string &key, const std::string &connectionId)
+{
+    Shard &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.connectionIds[key].insert(connectionId);
+}
+
+void FastRPC3::ConnectionIndex::erase(const std::string &key, const std::string &connectionId)
+{
+    Shard &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto i = shard.connectionIds.find(key);
+    if (i == shard.connectionIds.end())
+        return;
+    i->second.erase(connectionId);
+    if (i->second.empty())
+        shard.connectionIds.erase(i);
+}
+
+std::set<std::string> FastRPC3::ConnectionIndex::get(const std::string &key)
+{
+    Shard &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto i = shard.connectionIds.find(key);
+    if (i == shard.connectionIds.end())
+        return {};
+    return i->second;
+}
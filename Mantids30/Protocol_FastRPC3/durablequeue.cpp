@@ -0,0 +1,576 @@
+#include "durablequeue.h"
+
+#include <Mantids30/Helpers/encoders.h>
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <vector>
+
+#include <errno.h>
+#include <string.h>
+#include <zlib.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+using namespace Mantids30;
+using namespace Network::Protocols::FastRPC;
+
+namespace {
+
+const uint32_t RECORD_MAGIC = 0x51525046; // "FPRQ"
+
+struct RecordHeader
+{
+    uint32_t magic;
+    uint32_t length;
+    uint64_t expiration;
+    uint32_t crc;
+    // Not covered by the CRC (changes after the record is written):
+    uint8_t consumed;
+    uint8_t reserved[3];
+};
+static_assert(sizeof(RecordHeader) == 24, "unexpected durable queue record header size");
+
+size_t getRecordSize(const size_t &length)
+{
+    // Keep every header 8-byte aligned:
+    return (sizeof(RecordHeader) + length + 7) & ~static_cast<size_t>(7);
+}
+
+uint32_t getRecordCRC(const RecordHeader *header, const char *data)
+{
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef *>(&header->length), sizeof(header->length) + sizeof(header->expiration));
+    return static_cast<uint32_t>(crc32(crc, reinterpret_cast<const Bytef *>(data), header->length));
+}
+
+uint64_t getCurrentTimeMS()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+std::string getSegmentFileName(const uint64_t &id)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.seg", static_cast<unsigned long long>(id));
+    return name;
+}
+
+}
+
+class DurableQueue::Segment
+{
+public:
+    ~Segment()
+    {
+#ifndef _WIN32
+        if (map)
+            munmap(map, size);
+        if (fd != -1)
+            close(fd);
+#endif
+    }
+
+    static std::shared_ptr<Segment> create(const std::string &path, const uint64_t &id, const size_t &size)
+    {
+#ifndef _WIN32
+        auto segment = std::make_shared<Segment>();
+        segment->id = id;
+        segment->path = path;
+        segment->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (segment->fd == -1)
+            return nullptr;
+
+        // Reserve the disk space now (a full disk would fail the writes to the mapped memory with SIGBUS):
+        if (posix_fallocate(segment->fd, 0, static_cast<off_t>(size)) != 0 || !segment->mapFile(size))
+        {
+            unlink(path.c_str());
+            return nullptr;
+        }
+        return segment;
+#else
+        return nullptr;
+#endif
+    }
+
+    static std::shared_ptr<Segment> open(const std::string &path, const uint64_t &id)
+    {
+#ifndef _WIN32
+        auto segment = std::make_shared<Segment>();
+        segment->id = id;
+        segment->path = path;
+        segment->fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (segment->fd == -1)
+            return nullptr;
+
+        struct stat st;
+        if (fstat(segment->fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(RecordHeader)) || !segment->mapFile(static_cast<size_t>(st.st_size)))
+            return nullptr;
+
+        segment->recover();
+        return segment;
+#else
+        return nullptr;
+#endif
+    }
+
+    bool sync()
+    {
+#ifndef _WIN32
+        if (!dirty.exchange(false))
+            return true;
+        return fdatasync(fd) == 0;
+#else
+        return false;
+#endif
+    }
+
+    void remove()
+    {
+#ifndef _WIN32
+        unlink(path.c_str());
+#endif
+    }
+
+    RecordHeader *getHeader(const size_t &offset) { return reinterpret_cast<RecordHeader *>(map + offset); }
+
+    bool write(const std::string &data, const uint64_t &expiration)
+    {
+        size_t recordSize = getRecordSize(data.size());
+        if (size - writePos < recordSize)
+            return false;
+
+        RecordHeader *header = getHeader(writePos);
+        header->length = static_cast<uint32_t>(data.size());
+        header->expiration = expiration;
+        header->consumed = 0;
+        memcpy(map + writePos + sizeof(RecordHeader), data.data(), data.size());
+        header->crc = getRecordCRC(header, map + writePos + sizeof(RecordHeader));
+        // The magic number is written at last:
+        header->magic = RECORD_MAGIC;
+
+        writePos += recordSize;
+        pending++;
+        dirty = true;
+        return true;
+    }
+
+    void markConsumed(const size_t &offset)
+    {
+        RecordHeader *header = getHeader(offset);
+        if (header->consumed)
+            return;
+        header->consumed = 1;
+        pending--;
+        dirty = true;
+        if (offset == readPos)
+            readPos += getRecordSize(header->length);
+    }
+
+    uint64_t id = 0;
+    std::string path;
+    int fd = -1;
+    char *map = nullptr;
+    size_t size = 0;
+
+    // Next record, first record that may be pending, and pending records:
+    size_t writePos = 0, readPos = 0, pending = 0;
+    std::atomic<bool> dirty{false};
+
+private:
+    bool mapFile(const size_t &len)
+    {
+#ifndef _WIN32
+        void *addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+            return false;
+        map = static_cast<char *>(addr);
+        size = len;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void recover()
+    {
+        bool readPosFound = false;
+        size_t pos = 0;
+        while (pos + sizeof(RecordHeader) <= size)
+        {
+            RecordHeader *header = getHeader(pos);
+            if (header->magic != RECORD_MAGIC || header->length > size - pos - sizeof(RecordHeader)
+                || header->crc != getRecordCRC(header, map + pos + sizeof(RecordHeader)))
+                break;
+
+            if (!header->consumed)
+            {
+                pending++;
+                if (!readPosFound)
+                {
+                    readPos = pos;
+                    readPosFound = true;
+                }
+            }
+            pos += getRecordSize(header->length);
+        }
+
+        writePos = std::min(pos, size);
+        if (!readPosFound)
+            readPos = writePos;
+
+        // Wipe the torn tail, the records written after it (if any) could be taken as valid after the next appends:
+        char *tail = map + writePos;
+        size_t tailSize = size - writePos;
+        if (std::find_if(tail, tail + tailSize, [](char c) { return c != 0; }) != tail + tailSize)
+        {
+            memset(tail, 0, tailSize);
+            dirty = true;
+        }
+    }
+};
+
+class DurableQueue::PeerLog
+{
+public:
+    bool hasPending()
+    {
+        for (auto &segment : segments)
+        {
+            if (segment->pending)
+                return true;
+        }
+        return false;
+    }
+
+    // Remove the consumed segments (the last one is kept for the next appends):
+    void collect()
+    {
+        while (segments.size() > 1 && segments.front()->pending == 0)
+        {
+            segments.front()->remove();
+            totalBytes -= segments.front()->size;
+            segments.pop_front();
+        }
+    }
+
+    std::mutex mutex;
+    std::string directory;
+    std::deque<std::shared_ptr<Segment>> segments;
+    uint64_t nextSegmentId = 1;
+    size_t totalBytes = 0;
+};
+
+DurableQueue::DurableQueue(const Config &config)
+    : m_config(config)
+{
+}
+
+DurableQueue::~DurableQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_commitMutex);
+        m_finished = true;
+        m_commitCondition.notify_all();
+        m_committedCondition.notify_all();
+    }
+    if (m_committerThread.joinable())
+        m_committerThread.join();
+}
+
+bool DurableQueue::open(const std::string &directory)
+{
+#ifndef _WIN32
+    if (!m_directory.empty())
+        return false;
+
+    if (mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST)
+        return false;
+
+    DIR *dir = opendir(directory.c_str());
+    if (!dir)
+        return false;
+
+    // Every peer directory is named by its hex encoded key:
+    std::list<std::string> peerDirectories;
+    while (struct dirent *entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (!name.empty() && name.size() % 2 == 0 && name.find_first_not_of("0123456789ABCDEFabcdef") == std::string::npos)
+            peerDirectories.push_back(name);
+    }
+    closedir(dir);
+
+    for (const auto &peerDirectory : peerDirectories)
+    {
+        auto log = std::make_shared<PeerLog>();
+        log->directory = directory + "/" + peerDirectory;
+
+        std::vector<uint64_t> segmentIds;
+        if (DIR *segmentsDir = opendir(log->directory.c_str()))
+        {
+            while (struct dirent *entry = readdir(segmentsDir))
+            {
+                unsigned long long id;
+                char suffix[8];
+                if (sscanf(entry->d_name, "%16llx.%7s", &id, suffix) == 2 && strcmp(suffix, "seg") == 0)
+                    segmentIds.push_back(id);
+            }
+            closedir(segmentsDir);
+        }
+        std::sort(segmentIds.begin(), segmentIds.end());
+
+        for (uint64_t id : segmentIds)
+        {
+            // Never reuse an existing name (create() would fail forever), even if the segment is not usable:
+            log->nextSegmentId = std::max(log->nextSegmentId, id + 1);
+
+            std::string segmentPath = log->directory + "/" + getSegmentFileName(id);
+            auto segment = Segment::open(segmentPath, id);
+            if (!segment)
+            {
+                // Interrupted creation (before the space was reserved), nothing to recover:
+                struct stat st;
+                if (stat(segmentPath.c_str(), &st) == 0 && st.st_size < static_cast<off_t>(sizeof(RecordHeader)))
+                    unlink(segmentPath.c_str());
+                continue;
+            }
+            log->segments.push_back(segment);
+            log->totalBytes += segment->size;
+        }
+        log->collect();
+
+        std::string peerKey(peerDirectory.size() / 2, '\0');
+        Helpers::Encoders::fromHex(peerDirectory, reinterpret_cast<unsigned char *>(&peerKey[0]), peerKey.size());
+        m_peers[peerKey] = log;
+    }
+
+    m_directory = directory;
+    m_committerThread = std::thread(&DurableQueue::committer, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DurableQueue::append(const std::string &peerKey, const std::string &data, const uint64_t &expiration, bool waitForCommit)
+{
+    if (data.size() > UINT32_MAX)
+        return false;
+
+    auto log = getPeerLog(peerKey, true);
+    if (!log)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(log->mutex);
+
+        size_t recordSize = getRecordSize(data.size());
+        if (log->segments.empty() || log->segments.back()->size - log->segments.back()->writePos < recordSize)
+        {
+            log->collect();
+
+            size_t segmentSize = std::max(m_config.segmentSize, recordSize);
+            if (log->totalBytes + segmentSize > m_config.maxBytesPerPeer)
+                return false;
+
+            uint64_t id = log->nextSegmentId;
+            auto segment = Segment::create(log->directory + "/" + getSegmentFileName(id), id, segmentSize);
+            if (!segment)
+            {
+                // Taken by a stray file: the next append uses the next name.
+                if (errno == EEXIST)
+                    log->nextSegmentId++;
+                return false;
+            }
+
+#ifndef _WIN32
+            // Commit the new directory entry:
+            int dirFD = ::open(log->directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dirFD != -1)
+            {
+                fsync(dirFD);
+                close(dirFD);
+            }
+#endif
+            log->segments.push_back(segment);
+            log->totalBytes += segmentSize;
+            log->nextSegmentId++;
+        }
+
+        if (!log->segments.back()->write(data, expiration))
+            return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_commitMutex);
+    uint64_t generation = ++m_appendGeneration;
+    if (waitForCommit)
+    {
+        m_commitRequested = true;
+        m_commitCondition.notify_one();
+        m_committedCondition.wait(lock, [&] { return m_committedGeneration >= generation || m_finished; });
+    }
+    return true;
+}
+
+bool DurableQueue::front(const std::string &peerKey, Message *message)
+{
+    auto log = getPeerLog(peerKey, false);
+    if (!log)
+        return false;
+
+    uint64_t now = getCurrentTimeMS();
+
+    std::lock_guard<std::mutex> lock(log->mutex);
+    for (auto &segment : log->segments)
+    {
+        while (segment->pending && segment->readPos < segment->writePos)
+        {
+            RecordHeader *header = segment->getHeader(segment->readPos);
+            if (header->consumed)
+            {
+                segment->readPos += getRecordSize(header->length);
+                continue;
+            }
+            if (header->expiration && header->expiration < now)
+            {
+                segment->markConsumed(segment->readPos);
+                continue;
+            }
+
+            message->segmentId = segment->id;
+            message->offset = segment->readPos;
+            message->data.assign(segment->map + segment->readPos + sizeof(RecordHeader), header->length);
+            return true;
+        }
+    }
+    log->collect();
+    return false;
+}
+
+void DurableQueue::consume(const std::string &peerKey, const Message &message)
+{
+    auto log = getPeerLog(peerKey, false);
+    if (!log)
+        return;
+
+    std::lock_guard<std::mutex> lock(log->mutex);
+    for (auto &segment : log->segments)
+    {
+        if (segment->id == message.segmentId)
+        {
+            if (message.offset < segment->writePos)
+                segment->markConsumed(message.offset);
+            break;
+        }
+    }
+    log->collect();
+}
+
+bool DurableQueue::hasPending(const std::string &peerKey)
+{
+    auto log = getPeerLog(peerKey, false);
+    if (!log)
+        return false;
+
+    std::lock_guard<std::mutex> lock(log->mutex);
+    return log->hasPending();
+}
+
+std::set<std::string> DurableQueue::listPendingPeers()
+{
+    std::map<std::string, std::shared_ptr<PeerLog>> peers;
+    {
+        std::lock_guard<std::mutex> lock(m_peersMutex);
+        peers = m_peers;
+    }
+
+    std::set<std::string> r;
+    for (auto &i : peers)
+    {
+        std::lock_guard<std::mutex> lock(i.second->mutex);
+        if (i.second->hasPending())
+            r.insert(i.first);
+    }
+    return r;
+}
+
+void DurableQueue::commit()
+{
+    std::unique_lock<std::mutex> lock(m_commitMutex);
+    if (!m_committerThread.joinable())
+        return;
+    uint64_t generation = m_appendGeneration;
+    m_commitRequested = true;
+    m_commitCondition.notify_one();
+    m_committedCondition.wait(lock, [&] { return m_committedGeneration >= generation || m_finished; });
+}
+
+std::shared_ptr<DurableQueue::PeerLog> DurableQueue::getPeerLog(const std::string &peerKey, bool create)
+{
+    std::lock_guard<std::mutex> lock(m_peersMutex);
+    auto i = m_peers.find(peerKey);
+    if (i != m_peers.end())
+        return i->second;
+
+    // The peer directory name must fit in NAME_MAX:
+    if (!create || m_directory.empty() || peerKey.empty() || peerKey.size() > 127)
+        return nullptr;
+
+    auto log = std::make_shared<PeerLog>();
+    log->directory = m_directory + "/" + Helpers::Encoders::toHex(reinterpret_cast<const unsigned char *>(peerKey.data()), peerKey.size());
+#ifndef _WIN32
+    if (mkdir(log->directory.c_str(), 0700) != 0 && errno != EEXIST)
+        return nullptr;
+#endif
+    m_peers[peerKey] = log;
+    return log;
+}
+
+void DurableQueue::committer()
+{
+#ifndef _WIN32
+    pthread_setname_np(pthread_self(), "fRPC3:Commit");
+#endif
+
+    for (bool finished = false; !finished;)
+    {
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(m_commitMutex);
+            m_commitCondition.wait_for(lock, std::chrono::milliseconds(m_config.commitIntervalMS), [this] { return m_commitRequested || m_finished; });
+            m_commitRequested = false;
+            generation = m_appendGeneration;
+            // One last commit after finishing:
+            finished = m_finished;
+        }
+
+        // Every dirty segment is committed by one fdatasync, outside the locks (the appends can continue meanwhile):
+        std::list<std::shared_ptr<Segment>> segments;
+        {
+            std::lock_guard<std::mutex> lock(m_peersMutex);
+            for (auto &i : m_peers)
+            {
+                std::lock_guard<std::mutex> peerLock(i.second->mutex);
+                for (auto &segment : i.second->segments)
+                {
+                    if (segment->dirty)
+                        segments.push_back(segment);
+                }
+            }
+        }
+        for (auto &segment : segments)
+            segment->sync();
+
+        std::lock_guard<std::mutex> lock(m_commitMutex);
+        m_committedGeneration = std::max(m_committedGeneration, generation);
+        m_committedCondition.notify_all();
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace Mantids30 { namespace Network { namespace Protocols { namespace FastRPC {
+
+/**
+ * @brief The DurableQueue class keeps the outbound messages of the disconnected peers on disk, so they can be delivered
+ *        (in order) when the peer comes back.
+ *
+ * Every peer has its own append-only log in a directory, split in memory mapped segment files. Each record has a CRC, an
+ * expiration time and a consumed mark (set when delivered). Appends only copy into the mapped segment, a background
+ * thread commits every dirty segment with fdatasync (one commit for all the appends done meanwhile).
+ *
+ * On open, the records are recovered from the segments until the first torn/corrupted record of each segment.
+ * Fully consumed segments are removed.
+ */
+class DurableQueue
+{
+public:
+    struct Config
+    {
+        /**
+         * @brief segmentSize Size of each segment file (records larger than this get their own segment)
+         */
+        size_t segmentSize = 4 * 1024 * 1024;
+        /**
+         * @brief maxBytesPerPeer Max disk space of the segments of a single peer (new messages are refused)
+         */
+        size_t maxBytesPerPeer = 64 * 1024 * 1024;
+        /**
+         * @brief commitIntervalMS Max time between commits (fdatasync)
+         */
+        uint32_t commitIntervalMS = 10;
+    };
+
+    struct Message
+    {
+        uint64_t segmentId = 0;
+        size_t offset = 0;
+        std::string data;
+    };
+
+    DurableQueue() = default;
+    DurableQueue(const Config & config);
+    ~DurableQueue();
+
+    /**
+     * @brief open Open (or create) the queue directory and recover the stored messages.
+     * @param directory queue directory (one subdirectory per peer)
+     * @return true if the directory is usable.
+     */
+    bool open(const std::string & directory);
+
+    /**
+     * @brief append Append a message at the end of the peer log.
+     * @param peerKey peer identifier
+     * @param data message
+     * @param expiration unix time in milliseconds after which the message is discarded (0: never)
+     * @param waitForCommit wait until the message is committed to disk (otherwise it's committed in the next commit interval)
+     * @return false if the queue is not open, the peer reached its size cap, or on I/O error.
+     */
+    bool append(const std::string & peerKey, const std::string & data, const uint64_t & expiration, bool waitForCommit = false);
+    /**
+     * @brief front Get the oldest pending message of the peer (expired messages are consumed meanwhile)
+     * @return false if there is no pending message.
+     */
+    bool front(const std::string & peerKey, Message * message);
+    /**
+     * @brief consume Mark the message as delivered.
+     */
+    void consume(const std::string & peerKey, const Message & message);
+
+    /**
+     * @brief hasPending Check if the peer has pending messages (including expired ones not consumed yet)
+     */
+    bool hasPending(const std::string & peerKey);
+    /**
+     * @brief listPendingPeers Get the peers with pending messages
+     */
+    std::set<std::string> listPendingPeers();
+
+    /**
+     * @brief commit Commit every dirty segment now.
+     */
+    void commit();
+
+private:
+    class Segment;
+    class PeerLog;
+
+    std::shared_ptr<PeerLog> getPeerLog(const std::string & peerKey, bool create);
+    void committer();
+
+    Config m_config;
+    std::string m_directory;
+
+    std::mutex m_peersMutex;
+    std::map<std::string, std::shared_ptr<PeerLog>> m_peers;
+
+    // Group commit:
+    std::mutex m_commitMutex;
+    std::condition_variable m_commitCondition, m_committedCondition;
+    uint64_t m_appendGeneration = 0, m_committedGeneration = 0;
+    bool m_commitRequested = false;
+    std::atomic<bool> m_finished{false};
+    std::thread m_committerThread;
+};
+
+}}}}
@@ -32,6 +32,7 @@ void vrsyncRPCPingerThread(FastRPC3 *obj)
     while (obj->waitPingInterval())
     {
         obj->pingAllActiveConnections(); // send pings to every registered client...
+        obj->retryDurableQueues(); // deliver the pending messages of the connected peers...
     }
 }
 
@@ -77,6 +78,22 @@ FastRPC3::~FastRPC3()
     // Wait until the loop ends...
     m_pingerThread.join();
 
+    // Stop the push writers (queued pushes are discarded)...
+    {
+        unique_lock<mutex> lk(m_pushMutex);
+        m_pushCondition.notify_all();
+    }
+    for (auto &pushWriterThread : m_pushWriterThreads)
+        pushWriterThread.join();
+
+    // Stop the durable queue delivery (undelivered messages remain in the queue)...
+    {
+        unique_lock<mutex> lk(m_durableDrainMutex);
+        m_durableDrainCondition.notify_all();
+    }
+    for (auto &durableDrainerThread : m_durableDrainerThreads)
+        durableDrainerThread.join();
+
     delete m_threadPool;
 }
 
@@ -140,7 +157,11 @@ int FastRPC3::processIncomingAnswer(FastRPC3::Connection *connection)
     if (true)
     {
         unique_lock<mutex> lk(connection->answersMutex);
-        if (connection->pendingRequests.find(requestId) != connection->pendingRequests.end())
+        if ((requestId & PUSH_REQUESTID) != 0)
+        {
+            // Answer to a push from a peer without push support (nobody waits for it).
+        }
+        else if (connection->pendingRequests.find(requestId) != connection->pendingRequests.end())
         {
             connection->executionStatus[requestId] = executionStatus;
 
@@ -237,6 +258,8 @@ int FastRPC3::processIncomingExecutionRequest(std::shared_ptr<Socket_Stream> str
     params->callbacks = &rpcCallbacks;
     params->userId = session ? session->getUser() : "";
     params->domain = session ? session->getDomain() : "";
+    params->connectionId = key;
+    params->isPush = (flags&EXEC_FLAG_PUSH) != 0;
 
     bool parsingSuccessful = reader.parse(payloadBytes, params->payload);
     delete[] payloadBytes;
@@ -334,6 +357,9 @@ int FastRPC3::handleConnection(std::shared_ptr<Sockets::Socket_Stream> stream, b
     stream->setReadTimeout(config.rwTimeoutInSeconds);
     stream->setWriteTimeout(config.rwTimeoutInSeconds);
 
+    // Deliver the messages queued while this peer was disconnected:
+    scheduleDurableDrain(connection->key);
+
     FastRPC3::SessionPTR session;
 
     while (ret == CONNECTION_CONTINUE)
@@ -375,6 +401,7 @@ int FastRPC3::handleConnection(std::shared_ptr<Sockets::Socket_Stream> stream, b
 
     connection->terminated = true;
     connection->answersCondition.notify_all();
+    m_connectionIndex.remove(connection->key);
     m_connectionMapById.destroyElement(connection->key);
 
     return ret;
@@ -409,6 +436,10 @@ Sessions::Reason temporaryAuthentication(FastRPC3::TaskParameters *params, const
 
 void FastRPC3::sendRPCAnswer(FastRPC3::TaskParameters *params, const string &answer, uint8_t executionStatus)
 {
+    // Pushes are not answered:
+    if (params->isPush)
+        return;
+
     // Send a block.
     params->socketMutex->lock();
     if (params->streamBack->writeU<uint8_t>('A') && // ANSWER
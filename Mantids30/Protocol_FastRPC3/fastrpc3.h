@@ -3,6 +3,8 @@
 #include <Mantids30/Helpers/json.h>
 #include <Mantids30/Sessions/session.h>
 
+#include "durablequeue.h"
+
 #include <Mantids30/API_Monolith/methodshandler.h>
 #include <Mantids30/Threads/threadpool.h>
 #include <Mantids30/Threads/mutex_shared.h>
@@ -15,8 +17,12 @@
 
 #include <Mantids30/DataFormat_JWT/jwt.h>
 #include <Mantids30/Threads/map.h>
+#include <array>
 #include <cstdint>
+#include <deque>
+#include <list>
 #include <memory>
+#include <mutex>
 
 namespace Mantids30 { namespace Network { namespace Protocols { namespace FastRPC {
 
@@ -47,7 +53,8 @@ public:
     enum eExecutionFlags {
         EXEC_FLAG_EMPTY = 0,
         EXEC_FLAG_NORMAL = 1,
-        EXEC_FLAG_EXTRAAUTH = 2
+        EXEC_FLAG_EXTRAAUTH = 2,
+        EXEC_FLAG_PUSH = 4
     };
 
     enum eTaskExecutionErrors {
@@ -59,6 +66,7 @@ public:
         EXEC_ERR_REMOTE_QUEUE_OVERFLOW = 5,
         EXEC_ERR_METHOD_NOT_FOUND = 6,
         EXEC_ERR_CONNECTION_LOST = 7,
+        EXEC_ERR_DURABLE_QUEUE_REFUSED = 8,
         EXEC_ERR_UNKNOWN = 99,
     };
 
@@ -105,10 +113,12 @@ public:
         std::shared_ptr<DataFormat::JWT> jwtValidator = nullptr;
         Threads::Sync::Mutex_Shared * doneSharedMutex = nullptr;
         Threads::Sync::Mutex * socketMutex = nullptr;
-        std::string methodName, remotePeerIPAddress, remotePeerTLSCommonName, userId, domain;
+        std::string methodName, remotePeerIPAddress, remotePeerTLSCommonName, userId, domain, connectionId;
         char * extraTokenAuth = nullptr;
         json payload;
         uint64_t requestId = 0;
+        // Pushed by the remote peer (EXEC_FLAG_PUSH), executed without answer:
+        bool isPush = false;
         void * callbacks = nullptr;
     };
 
@@ -145,6 +155,62 @@ public:
         // Finalization:
         std::atomic<bool> terminated;
 
+        // Pushed frames waiting for a writer (shared between every target connection):
+        std::deque<std::shared_ptr<const std::string>> pushQueue;
+        std::mutex pushQueueMutex;
+        bool pushScheduled = false;
+    };
+
+    /**
+     * @brief The ConnectionIndex class indexes the authenticated connections by user, domain and role (updated on
+     *        login/logout/disconnection). Sharded by index key, so logins on different users rarely share a lock.
+     */
+    class ConnectionIndex {
+    public:
+        void add(const std::string & connectionId, const std::string & user, const std::string & domain, const std::set<std::string> & roles);
+        void remove(const std::string & connectionId);
+
+        std::set<std::string> getByUser(const std::string & user, const std::string & domain);
+        std::set<std::string> getByDomain(const std::string & domain);
+        std::set<std::string> getByRole(const std::string & role, const std::string & domain);
+
+    private:
+        static constexpr size_t SHARD_COUNT = 16;
+
+        struct Entry
+        {
+            std::string user, domain;
+            std::set<std::string> roles;
+        };
+
+        struct Shard
+        {
+            std::mutex mutex;
+            // index key -> connection ids
+            std::map<std::string, std::set<std::string>> connectionIds;
+        };
+
+        struct EntryShard
+        {
+            std::mutex mutex;
+            // connection id -> indexed session (to remove it)
+            std::map<std::string, Entry> entries;
+        };
+
+        static std::string userKey(const std::string & user, const std::string & domain);
+        static std::string domainKey(const std::string & domain);
+        static std::string roleKey(const std::string & role, const std::string & domain);
+
+        Shard & getShard(const std::string & key);
+        EntryShard & getEntryShard(const std::string & connectionId);
+        void removeLocked(EntryShard & entryShard, const std::string & connectionId);
+        void insert(const std::string & key, const std::string & connectionId);
+        void erase(const std::string & key, const std::string & connectionId);
+        std::set<std::string> get(const std::string & key);
+
+        // The entry shard lock is held while the index keys are updated (always in this order):
+        std::array<EntryShard, SHARD_COUNT> m_entryShards;
+        std::array<Shard, SHARD_COUNT> m_shards;
     };
 
     struct RPC3CallbackDefinitions {
@@ -172,6 +238,7 @@ public:
         void (*onOutgoingTaskFailureDisconnectedPeer)(const std::string &connectionId, const std::string &methodName, const json &payload) = nullptr;
         void (*onIncomingTaskDroppedQueueFull)(FastRPC3::TaskParameters * params) = nullptr;
         void (*onOutgoingTaskFailureTimeout)(const std::string &connectionId, const std::string &methodName, const json &payload) = nullptr;
+        void (*onOutgoingPushDroppedQueueFull)(const std::string &connectionId, const std::string &methodName) = nullptr;
 
         void * context = nullptr;
         // Mantids30::Sessions::getReasonText(authReason) < - to obtain the auth reason.
@@ -208,6 +275,29 @@ public:
          * @brief remoteExecutionDisconnectedTries
          */
         std::atomic<uint32_t> remoteExecutionDisconnectedTries{10};
+        /**
+         * @brief maxPushQueueSize Max pushed messages waiting to be written on a single connection (newer pushes are dropped)
+         */
+        std::atomic<uint32_t> maxPushQueueSize{1024};
+        /**
+         * @brief pushWriterThreads Threads writing the pushed messages (shared by all the connections, a slow peer only
+         *                          blocks one of them up to pushWriteTimeoutInSeconds) - Set before the first push / not thread safe.
+         */
+        uint32_t pushWriterThreads = 4;
+        /**
+         * @brief pushWriteTimeoutInSeconds Write timeout of the pushed messages, a peer that does not accept a pushed message
+         *                                  in this time is disconnected (it would hold a shared push writer thread otherwise)
+         */
+        std::atomic<uint32_t> pushWriteTimeoutInSeconds{2};
+        /**
+         * @brief durableQueueTTLInSeconds Default time to live of the messages queued for disconnected peers (see queueTask)
+         */
+        std::atomic<uint32_t> durableQueueTTLInSeconds{86400};
+        /**
+         * @brief durableQueueDrainThreads Threads delivering the queued messages to the reconnected peers - Set before
+         *                                 enableDurableQueue / not thread safe.
+         */
+        uint32_t durableQueueDrainThreads = 2;
         /**
          * @brief rwTimeout This timeout will be setted on processConnection, call this function before that.
          *                  Read timeout defines how long are we going to wait if no-data comes from a RPC connection socket,
@@ -332,6 +422,25 @@ public:
                          bool passSessionCommands = false,
                          const std::string &extraJWTTokenAuth = ""
                          );
+        /**
+         * @brief queueTask Queue a remote method execution in the durable queue of this connection id and return immediately.
+         *
+         * The messages are delivered in order (one at a time, through executeTask) when the connection id is connected,
+         * and survive restarts. The answers are discarded. Delivery is at least once: a message whose answer timed
+         * out is delivered again.
+         *
+         * @param methodName The name of the remote method to execute (SESSION.* methods can't be queued).
+         * @param payload A JSON object containing data or arguments needed by the remote method.
+         * @param error A pointer to a JSON object where any error details will be stored if an error occurs.
+         * @param ttlInSeconds Discard the message if not delivered within this time (0: config.durableQueueTTLInSeconds).
+         * @param waitForCommit Wait until the message is committed to disk.
+         * @return true if queued, false if the durable queue is not enabled, the message is too large or the peer queue is full.
+         */
+        bool queueTask(const std::string &methodName,
+                       const json &payload,
+                       json * error = nullptr,
+                       const uint32_t & ttlInSeconds = 0,
+                       bool waitForCommit = false);
         /**
          * @brief runRemoteClose Run Remote Close Method
          * @param connectionId Connection ID (this class can thread-safe handle multiple connections at time)
@@ -399,12 +508,65 @@ public:
     int handleConnection(std::shared_ptr<Sockets::Socket_Stream> stream, bool remotePeerIsServer);
 
 
-    // TODO: runRemoteRPCMethod for sending message to an specific connected user...
-    // TODO: runRemoteRPCMethod for sending message to all connected users...
-    // TODO: runRemoteRPCMethod for sending message to all connected users from specific role...
-    // TODO: message persistence for non-connected users
     // TODO: list current sessions
 
+    /**
+     * @brief enableDurableQueue Enable the durable queue for disconnected peers (see RemoteMethods::queueTask), the messages
+     *        stored from previous runs are delivered when their peers connect - Call once, before connect / not thread safe.
+     * @param directory queue directory
+     * @param queueConfig segment size, per peer size cap and commit interval
+     * @return true if the directory was opened.
+     */
+    bool enableDurableQueue(const std::string & directory, const DurableQueue::Config & queueConfig = DurableQueue::Config());
+    /**
+     * @brief queueTaskForUser Queue a remote method execution for a user (see RemoteMethods::queueTask), delivered to one
+     *        of its connections when the user is logged in.
+     */
+    bool queueTaskForUser(const std::string & user, const std::string & domain, const std::string & methodName, const json & payload,
+                          json * error = nullptr, const uint32_t & ttlInSeconds = 0, bool waitForCommit = false);
+
+    /**
+     * @brief pushToConnections Push a method execution to many connections without waiting for answers.
+     *
+     * The frame is encoded once and shared by every connection, then queued to each connection and written by the push
+     * writer threads (no thread per connection, and the caller is never blocked by the remote peers).
+     *
+     * @param connectionIds target connections (the disconnected ones are ignored)
+     * @param methodName remote method name (SESSION.* methods can't be pushed)
+     * @param payload method parameters
+     * @return number of connections where the message was queued.
+     */
+    size_t pushToConnections(const std::set<std::string> & connectionIds, const std::string & methodName, const json & payload);
+    /**
+     * @brief pushToAll Push a method execution to every connection (see pushToConnections)
+     */
+    size_t pushToAll(const std::string & methodName, const json & payload);
+    /**
+     * @brief pushToUser Push a method execution to every connection logged in as this user (see pushToConnections)
+     */
+    size_t pushToUser(const std::string & user, const std::string & domain, const std::string & methodName, const json & payload);
+    /**
+     * @brief pushToDomain Push a method execution to every connection logged in this domain (see pushToConnections)
+     */
+    size_t pushToDomain(const std::string & domain, const std::string & methodName, const json & payload);
+    /**
+     * @brief pushToRole Push a method execution to every connection logged in with this role (see pushToConnections)
+     */
+    size_t pushToRole(const std::string & role, const std::string & domain, const std::string & methodName, const json & payload);
+
+    /**
+     * @brief listConnectionIdsByUser Get the connections logged in as this user.
+     */
+    std::set<std::string> listConnectionIdsByUser(const std::string & user, const std::string & domain);
+    /**
+     * @brief listConnectionIdsByDomain Get the connections logged in this domain.
+     */
+    std::set<std::string> listConnectionIdsByDomain(const std::string & domain);
+    /**
+     * @brief listConnectionIdsByRole Get the connections logged in with this role.
+     */
+    std::set<std::string> listConnectionIdsByRole(const std::string & role, const std::string & domain);
+
 
     /**
      * @brief listActiveConnectionIds Get keys from the current connections.
@@ -424,6 +586,18 @@ public:
      * @brief pingAllActiveConnections Internal function to send pings to every connected peer
      */
     void pingAllActiveConnections();
+    /**
+     * @brief pushWriter Internal function to write the queued pushes until the FastRPC3 is destroyed
+     */
+    void pushWriter();
+    /**
+     * @brief durableQueueDrainer Internal function to deliver the durable queues until the FastRPC3 is destroyed
+     */
+    void durableQueueDrainer();
+    /**
+     * @brief retryDurableQueues Internal function to schedule the delivery of the durable queues of the connected peers
+     */
+    void retryDurableQueues();
     /**
      * @brief waitPingInterval Wait interval for pings
      * @return true if ping interval completed, false if a signal closed the wait interval (eg. FastRPC3 destroyed)
@@ -516,11 +690,22 @@ private:
     int processIncomingExecutionRequest(std::shared_ptr<Sockets::Socket_Stream> stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared *mtDone, Threads::Sync::Mutex *mtSocket, FastRPC3::SessionPTR *session);
 
 
-    // TODO:
-    /*    std::map<std::string,std::string> connectionIdToLogin;
-    std::mutex connectionIdToLoginMutex;
-    std::multimap<std::string,std::string> loginToConnectionKey;
-    std::mutex loginToConnectionKeyMutex;*/
+    std::shared_ptr<const std::string> encodePushFrame(const std::string & methodName, const json & payload);
+    bool queuePushFrame(const std::string & connectionId, const std::shared_ptr<const std::string> & frame, const std::string & methodName);
+    void flushPushQueue(const std::string & connectionId);
+    void startPushWriters();
+
+    bool queueDurableTask(const std::string & peerKey, const std::string & methodName, const json & payload, json * error,
+                          const uint32_t & ttlInSeconds, bool waitForCommit);
+    void scheduleDurableDrain(const std::string & peerKey);
+    bool drainDurablePeer(const std::string & peerKey);
+    std::string getDurableTarget(const std::string & peerKey);
+    static std::string getDurableUserKey(const std::string & user, const std::string & domain);
+
+    /**
+     * @brief PUSH_REQUESTID Request ID bit reserved for pushes (answers to pushes from older peers are discarded)
+     */
+    static constexpr uint64_t PUSH_REQUESTID = 0x8000000000000000ULL;
 
 
     // Methods:
@@ -536,6 +721,11 @@ private:
      */
     Mantids30::Threads::Safe::Map<std::string> m_connectionMapById;
 
+    /**
+     * @brief Authenticated connections by user, domain and role.
+     */
+    ConnectionIndex m_connectionIndex;
+
     /**
      * @brief Thread pool for handling RPC method execution.
      */
@@ -561,6 +751,27 @@ private:
      */
     std::condition_variable m_pingCondition;
 
+    /**
+     * @brief Push writer threads (started on the first push) and the connections with queued pushes.
+     */
+    std::list<std::thread> m_pushWriterThreads;
+    std::once_flag m_pushWritersStarted;
+    std::deque<std::string> m_pushPendingConnections;
+    std::mutex m_pushMutex;
+    std::condition_variable m_pushCondition;
+    std::atomic<uint64_t> m_pushRequestIdCounter{0};
+
+    /**
+     * @brief Durable queue (if enabled), its drainer threads and the peers scheduled to be delivered.
+     */
+    std::unique_ptr<DurableQueue> m_durableQueue;
+    std::list<std::thread> m_durableDrainerThreads;
+    std::deque<std::string> m_durableDrainPending;
+    std::set<std::string> m_durableDrainScheduled;
+    std::set<std::string> m_durableDrainRequested;
+    std::mutex m_durableDrainMutex;
+    std::condition_variable m_durableDrainCondition;
+
     /**
      * @brief Handler for default RPC methods.
      */
@@ -0,0 +1,213 @@
+#include "fastrpc3.h"
+#include <Mantids30/Helpers/json.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+using namespace Mantids30;
+using namespace Network::Protocols::FastRPC;
+using namespace std;
+
+void vrsyncRPCDurableQueueThread(FastRPC3 *obj)
+{
+#ifndef WIN32
+    pthread_setname_np(pthread_self(), "fRPC3:Durable");
+#endif
+
+    obj->durableQueueDrainer();
+}
+
+bool FastRPC3::enableDurableQueue(const string &directory, const DurableQueue::Config &queueConfig)
+{
+    if (m_durableQueue)
+        return false;
+
+    auto durableQueue = std::make_unique<DurableQueue>(queueConfig);
+    if (!durableQueue->open(directory))
+        return false;
+    m_durableQueue = std::move(durableQueue);
+
+    for (uint32_t i = 0; i < std::max(1U, config.durableQueueDrainThreads); i++)
+        m_durableDrainerThreads.emplace_back(vrsyncRPCDurableQueueThread, this);
+    return true;
+}
+
+bool FastRPC3::queueTaskForUser(const string &user, const string &domain, const string &methodName, const json &payload, json *error,
+                                const uint32_t &ttlInSeconds, bool waitForCommit)
+{
+    return queueDurableTask(getDurableUserKey(user, domain), methodName, payload, error, ttlInSeconds, waitForCommit);
+}
+
+void FastRPC3::durableQueueDrainer()
+{
+    for (;;)
+    {
+        string peerKey;
+        {
+            unique_lock<mutex> lk(m_durableDrainMutex);
+            m_durableDrainCondition.wait(lk, [this] { return m_isFinished || !m_durableDrainPending.empty(); });
+            if (m_isFinished)
+                return;
+            peerKey = std::move(m_durableDrainPending.front());
+            m_durableDrainPending.pop_front();
+        }
+
+        bool drained = drainDurablePeer(peerKey);
+
+        bool requested;
+        {
+            unique_lock<mutex> lk(m_durableDrainMutex);
+            m_durableDrainScheduled.erase(peerKey);
+            requested = m_durableDrainRequested.erase(peerKey) != 0;
+        }
+
+        // Queued, or peer logged in, while delivering (otherwise, it's retried by the pinger):
+        if (drained || requested)
+            scheduleDurableDrain(peerKey);
+    }
+}
+
+void FastRPC3::retryDurableQueues()
+{
+    if (!m_durableQueue)
+        return;
+
+    for (const auto &peerKey : m_durableQueue->listPendingPeers())
+        scheduleDurableDrain(peerKey);
+}
+
+bool FastRPC3::queueDurableTask(const string &peerKey, const string &methodName, const json &payload, json *error,
+                                const uint32_t &ttlInSeconds, bool waitForCommit)
+{
+    auto refuse = [error](const string &errorMessage) {
+        if (error)
+        {
+            (*error)["succeed"] = false;
+            (*error)["errorId"] = EXEC_ERR_DURABLE_QUEUE_REFUSED;
+            (*error)["errorMessage"] = errorMessage;
+        }
+        return false;
+    };
+
+    if (!m_durableQueue)
+        return refuse("Durable Queue Not Enabled.");
+    if (boost::starts_with(methodName, "SESSION.") || methodName.empty() || methodName.size() > 254)
+        return refuse("Invalid Method Name.");
+
+    Json::StreamWriterBuilder builder;
+    builder.settings_["indentation"] = "";
+    string output = Json::writeString(builder, payload);
+
+    if (output.size() > config.maxMessageSize)
+    {
+        if (error)
+        {
+            (*error)["succeed"] = false;
+            (*error)["errorId"] = EXEC_ERR_PAYLOAD_TOO_LARGE;
+            (*error)["errorMessage"] = "Payload exceed the Maximum Message Size.";
+        }
+        return false;
+    }
+
+    uint64_t ttlInMS = static_cast<uint64_t>(ttlInSeconds ? ttlInSeconds : config.durableQueueTTLInSeconds.load()) * 1000;
+    uint64_t expiration = static_cast<uint64_t>(chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count()) + ttlInMS;
+
+    // Record: method name, NUL, JSON payload.
+    if (!m_durableQueue->append(peerKey, methodName + '\0' + output, expiration, waitForCommit))
+        return refuse("Peer Queue Full or Not Writable.");
+
+    scheduleDurableDrain(peerKey);
+
+    if (error)
+    {
+        (*error)["succeed"] = true;
+        (*error)["errorId"] = EXEC_SUCCESS;
+        (*error)["errorMessage"] = "Queued.";
+    }
+    return true;
+}
+
+void FastRPC3::scheduleDurableDrain(const string &peerKey)
+{
+    // Only for reachable peers with pending messages:
+    if (!m_durableQueue || !m_durableQueue->hasPending(peerKey) || getDurableTarget(peerKey).empty())
+        return;
+
+    unique_lock<mutex> lk(m_durableDrainMutex);
+    // Only one drainer per peer (keeps the order), run again when finished:
+    if (!m_durableDrainScheduled.insert(peerKey).second)
+    {
+        m_durableDrainRequested.insert(peerKey);
+        return;
+    }
+    m_durableDrainPending.push_back(peerKey);
+    m_durableDrainCondition.notify_one();
+}
+
+bool FastRPC3::drainDurablePeer(const string &peerKey)
+{
+    DurableQueue::Message message;
+    while (!m_isFinished && m_durableQueue->front(peerKey, &message))
+    {
+        string connectionId = getDurableTarget(peerKey);
+        if (connectionId.empty())
+            return false;
+
+        size_t separator = message.data.find('\0');
+        json payload;
+        Helpers::JSONReader2 reader;
+        if (separator == string::npos || !reader.parse(message.data.substr(separator + 1), payload))
+        {
+            // Malformed record, discard it.
+            m_durableQueue->consume(peerKey, message);
+            continue;
+        }
+
+        json error;
+        json answer = remote(connectionId).executeTask(message.data.substr(0, separator), payload, &error, false);
+        switch (JSON_ASUINT(error, "errorId", static_cast<uint32_t>(EXEC_ERR_UNKNOWN)))
+        {
+        case EXEC_ERR_PEER_NOT_FOUND:
+        case EXEC_ERR_DATA_TRANSMISSION_FAILURE:
+        case EXEC_ERR_TIMEOUT:
+        case EXEC_ERR_CONNECTION_LOST:
+        case EXEC_ERR_REMOTE_QUEUE_OVERFLOW:
+            // Not delivered, try again later.
+            return false;
+        default:
+            break;
+        }
+
+        switch (JSON_ASUINT(answer, "statusCode", 0))
+        {
+        case LocalRPCTasks::ELT_RET_TOKENFAILED:
+        case LocalRPCTasks::ELT_RET_REQSESSION:
+        case LocalRPCTasks::ELT_RET_NOTAUTHORIZED:
+            // The peer is not logged in yet (delivered again after the login, or when retried).
+            return false;
+        default:
+            // Answered by the peer (the answer is discarded).
+            m_durableQueue->consume(peerKey, message);
+            break;
+        }
+    }
+    return !m_isFinished;
+}
+
+string FastRPC3::getDurableTarget(const string &peerKey)
+{
+    if (peerKey.empty() || peerKey[0] != '\0')
+        return doesConnectionExist(peerKey) ? peerKey : "";
+
+    // User key, deliver to any of its connections:
+    size_t separator = peerKey.find('\0', 1);
+    if (separator == string::npos)
+        return "";
+    auto connectionIds = m_connectionIndex.getByUser(peerKey.substr(separator + 1), peerKey.substr(1, separator - 1));
+    return connectionIds.empty() ? "" : *connectionIds.begin();
+}
+
+string FastRPC3::getDurableUserKey(const string &user, const string &domain)
+{
+    // Connection ids never start with NUL:
+    return string(1, '\0') + domain + '\0' + user;
+}
@@ -6,6 +6,8 @@
 #include <Mantids30/Helpers/random.h>
 #include <Mantids30/Net_Sockets/acceptor_multithreaded.h>
 #include <Mantids30/Net_Sockets/socket_tls.h>
+#include <Mantids30/Program_Metrics/registry.h>
+#include <Mantids30/Program_Tracing/tracing.h>
 #include <Mantids30/Threads/lock_shared.h>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -20,6 +22,32 @@ using namespace std;
 using Ms = chrono::milliseconds;
 using S = chrono::seconds;
 
+namespace {
+
+struct RPCMetrics
+{
+    RPCMetrics()
+        : methodDuration(Program::Metrics::Registry::getDefault().histogramFamily("mantids30_fastrpc3_method_duration_seconds", "Execution time of the local RPC methods.",
+                                                                                    {"method"}, Program::Metrics::Histogram::latencyLayout()))
+        , methodFailures(Program::Metrics::Registry::getDefault().counterFamily("mantids30_fastrpc3_method_failures_total", "Local RPC methods that failed during the execution.", {"method"}))
+        , rejectedCalls(Program::Metrics::Registry::getDefault().counterFamily("mantids30_fastrpc3_rejected_calls_total", "Local RPC calls rejected before the execution.", {"reason"}))
+    {
+    }
+
+    // Labeled by method name only once the method is known to exist (the remote peer can't create new series):
+    Program::Metrics::Family<Program::Metrics::Histogram> & methodDuration;
+    Program::Metrics::Family<Program::Metrics::Counter> & methodFailures;
+    Program::Metrics::Family<Program::Metrics::Counter> & rejectedCalls;
+};
+
+RPCMetrics & getMetrics()
+{
+    static RPCMetrics metrics;
+    return metrics;
+}
+
+}
+
 void FastRPC3::LocalRPCTasks::executeLocalTask(std::shared_ptr<void> vTaskParams)
 {
     bool functionFound = false;
@@ -28,6 +56,9 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(std::shared_ptr<void> vTaskParams
     RPC3CallbackDefinitions *callbacks = ((RPC3CallbackDefinitions *) taskParams->callbacks);
     std::shared_ptr<Sessions::Session> session = taskParams->sessionHolder->getSharedPointer();
 
+    // Sampled requests are traced from here (the JWT verification, method invocation and database queries run in this thread):
+    Program::Tracing::Trace trace("rpc.request", Program::Tracing::shouldSample(), taskParams->methodName);
+
     json fullResponse;
     json responsePayload;
     fullResponse["statusCode"] = ELT_RET_SUCCESS;
@@ -121,16 +152,20 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(std::shared_ptr<void> vTaskParams
                 // Report:
                 CALLBACK(callbacks->onMethodExecutionStart)(callbacks->context, taskParams, taskParams->payload);
 
-                auto start = chrono::high_resolution_clock::now();
-                auto finish = chrono::high_resolution_clock::now();
-                chrono::duration<double, milli> elapsed = finish - start;
+                auto start = chrono::steady_clock::now();
+                auto invokeRetCode = taskParams->methodsHandler->invoke(session, taskParams->methodName, taskParams->payload, &responsePayload);
+                chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
 
-                switch (taskParams->methodsHandler->invoke(session, taskParams->methodName, taskParams->payload, &responsePayload))
+                if (invokeRetCode != API::Monolith::MethodsHandler::METHOD_RET_CODE_METHODNOTFOUND)
                 {
-                case API::Monolith::MethodsHandler::METHOD_RET_CODE_SUCCESS:
+                    getMetrics().methodDuration.withLabels({taskParams->methodName}).observe(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(elapsed).count()));
+                    if (invokeRetCode != API::Monolith::MethodsHandler::METHOD_RET_CODE_SUCCESS)
+                        getMetrics().methodFailures.withLabels({taskParams->methodName}).add();
+                }
 
-                    finish = chrono::high_resolution_clock::now();
-                    elapsed = finish - start;
+                switch (invokeRetCode)
+                {
+                case API::Monolith::MethodsHandler::METHOD_RET_CODE_SUCCESS:
 
                     CALLBACK(callbacks->onMethodExecutionSuccess)(callbacks->context, taskParams, elapsed.count(), responsePayload);
 
@@ -139,6 +174,7 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(std::shared_ptr<void> vTaskParams
                     break;
                 case API::Monolith::MethodsHandler::METHOD_RET_CODE_METHODNOTFOUND:
 
+                    getMetrics().rejectedCalls.withLabels({"method_not_found"}).add();
                     CALLBACK(callbacks->onMethodExecutionNotFound)(callbacks->context, taskParams);
                     fullResponse["statusCode"] = ELT_RET_METHODNOTIMPLEMENTED;
                     break;
@@ -152,6 +188,7 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(std::shared_ptr<void> vTaskParams
             case API::Monolith::MethodsHandler::VALIDATION_NOTAUTHORIZED:
             {
                 // not enough permissions.
+                getMetrics().rejectedCalls.withLabels({"not_authorized"}).add();
                 CALLBACK(callbacks->onMethodExecutionNotAuthorized)(callbacks->context, taskParams, reasons);
                 fullResponse["auth"]["reasons"] = reasons;
                 fullResponse["statusCode"] = ELT_RET_NOTAUTHORIZED;
@@ -160,6 +197,7 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(std::shared_ptr<void> vTaskParams
             case API::Monolith::MethodsHandler::VALIDATION_METHODNOTFOUND:
             default:
             {
+                getMetrics().rejectedCalls.withLabels({"method_not_found"}).add();
                 CALLBACK(callbacks->onMethodExecutionNotFound)(callbacks->context, taskParams);
                 fullResponse["statusCode"] = ELT_RET_METHODNOTIMPLEMENTED;
             }
@@ -169,6 +207,7 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(std::shared_ptr<void> vTaskParams
     }
     else
     {
+        getMetrics().rejectedCalls.withLabels({"session_missing"}).add();
         CALLBACK(callbacks->onMethodExecutionSessionMissing)(callbacks->context, taskParams);
         fullResponse["statusCode"] = ELT_RET_REQSESSION;
     }
@@ -227,6 +266,11 @@ void FastRPC3::LocalRPCTasks::login(std::shared_ptr<void> taskData)
                 //session->setUser(token.getSubject());
                 session->updateLastActivity();
 
+                FastRPC3 *caller = static_cast<FastRPC3 *>(taskParams->caller);
+                caller->m_connectionIndex.add(taskParams->connectionId, session->getUser(), session->getDomain(), token.getAllRoles());
+                // Deliver the messages queued for this user:
+                caller->scheduleDurableDrain(getDurableUserKey(session->getUser(), session->getDomain()));
+
                 loginReason.reason = LoginReason::TOKEN_VALIDATED;
                 CALLBACK(callbacks->onTokenValidationSuccess)(callbacks->context, taskParams, sJWTToken);
             }
@@ -253,6 +297,8 @@ void FastRPC3::LocalRPCTasks::logout(std::shared_ptr<void> taskData)
     FastRPC3::TaskParameters *params = static_cast<FastRPC3::TaskParameters *>(taskData.get());
     json response;
     response = params->sessionHolder->destroy();
+    if (response.asBool())
+        static_cast<FastRPC3 *>(params->caller)->m_connectionIndex.remove(params->connectionId);
     sendRPCAnswer(params, response.toStyledString(), EXEC_STATUS_SUCCESS);
     params->doneSharedMutex->unlockShared();
 }
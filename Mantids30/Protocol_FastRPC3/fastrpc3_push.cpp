@@ -0,0 +1,220 @@
+#include "fastrpc3.h"
+#include <Mantids30/Helpers/callbacks.h>
+#include <Mantids30/Helpers/json.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+using namespace Mantids30;
+using namespace Network::Sockets;
+using namespace Network::Protocols::FastRPC;
+using namespace std;
+
+namespace {
+
+void appendU32(string &frame, uint32_t value)
+{
+    uint32_t nbo = htonl(value);
+    frame.append(reinterpret_cast<const char *>(&nbo), sizeof(nbo));
+}
+
+void appendU64(string &frame, uint64_t value)
+{
+    appendU32(frame, static_cast<uint32_t>(value >> 32));
+    appendU32(frame, static_cast<uint32_t>(value & 0xFFFFFFFF));
+}
+
+}
+
+void vrsyncRPCPushWriterThread(FastRPC3 *obj)
+{
+#ifndef WIN32
+    pthread_setname_np(pthread_self(), "fRPC3:Push");
+#endif
+
+    obj->pushWriter();
+}
+
+size_t FastRPC3::pushToConnections(const std::set<string> &connectionIds, const string &methodName, const json &payload)
+{
+    auto frame = encodePushFrame(methodName, payload);
+    if (!frame)
+        return 0;
+
+    size_t r = 0;
+    for (const auto &connectionId : connectionIds)
+    {
+        if (queuePushFrame(connectionId, frame, methodName))
+            r++;
+    }
+    return r;
+}
+
+size_t FastRPC3::pushToAll(const string &methodName, const json &payload)
+{
+    return pushToConnections(m_connectionMapById.getKeys(), methodName, payload);
+}
+
+size_t FastRPC3::pushToUser(const string &user, const string &domain, const string &methodName, const json &payload)
+{
+    return pushToConnections(m_connectionIndex.getByUser(user, domain), methodName, payload);
+}
+
+size_t FastRPC3::pushToDomain(const string &domain, const string &methodName, const json &payload)
+{
+    return pushToConnections(m_connectionIndex.getByDomain(domain), methodName, payload);
+}
+
+size_t FastRPC3::pushToRole(const string &role, const string &domain, const string &methodName, const json &payload)
+{
+    return pushToConnections(m_connectionIndex.getByRole(role, domain), methodName, payload);
+}
+
+std::set<string> FastRPC3::listConnectionIdsByUser(const string &user, const string &domain)
+{
+    return m_connectionIndex.getByUser(user, domain);
+}
+
+std::set<string> FastRPC3::listConnectionIdsByDomain(const string &domain)
+{
+    return m_connectionIndex.getByDomain(domain);
+}
+
+std::set<string> FastRPC3::listConnectionIdsByRole(const string &role, const string &domain)
+{
+    return m_connectionIndex.getByRole(role, domain);
+}
+
+void FastRPC3::pushWriter()
+{
+    for (;;)
+    {
+        string connectionId;
+        {
+            unique_lock<mutex> lk(m_pushMutex);
+            m_pushCondition.wait(lk, [this] { return m_isFinished || !m_pushPendingConnections.empty(); });
+            if (m_isFinished)
+                return;
+            connectionId = std::move(m_pushPendingConnections.front());
+            m_pushPendingConnections.pop_front();
+        }
+        flushPushQueue(connectionId);
+    }
+}
+
+std::shared_ptr<const string> FastRPC3::encodePushFrame(const string &methodName, const json &payload)
+{
+    if (boost::starts_with(methodName, "SESSION.") || methodName.size() > 254)
+        return nullptr;
+
+    Json::StreamWriterBuilder builder;
+    builder.settings_["indentation"] = "";
+    string output = Json::writeString(builder, payload);
+
+    if (output.size() > config.maxMessageSize)
+        return nullptr;
+
+    // Same frame as RemoteMethods::executeTask, the request ID is shared by every connection:
+    auto frame = std::make_shared<string>();
+    frame->reserve(1 + 8 + 1 + 1 + methodName.size() + 4 + output.size());
+    frame->push_back('Q');
+    appendU64(*frame, PUSH_REQUESTID | (++m_pushRequestIdCounter & ~PUSH_REQUESTID));
+    frame->push_back(static_cast<char>(EXEC_FLAG_NORMAL | EXEC_FLAG_PUSH));
+    frame->push_back(static_cast<char>(methodName.size()));
+    frame->append(methodName);
+    appendU32(*frame, static_cast<uint32_t>(output.size()));
+    frame->append(output);
+    return frame;
+}
+
+bool FastRPC3::queuePushFrame(const string &connectionId, const std::shared_ptr<const string> &frame, const string &methodName)
+{
+    FastRPC3::Connection *connection = (FastRPC3::Connection *) m_connectionMapById.openElement(connectionId);
+    if (!connection)
+        return false;
+
+    bool queued = false, schedule = false;
+    {
+        lock_guard<mutex> lk(connection->pushQueueMutex);
+        if (!connection->terminated && connection->pushQueue.size() < config.maxPushQueueSize)
+        {
+            connection->pushQueue.push_back(frame);
+            queued = true;
+            // Only one writer at a time per connection:
+            schedule = !connection->pushScheduled;
+            connection->pushScheduled = true;
+        }
+    }
+
+    m_connectionMapById.releaseElement(connectionId);
+
+    if (!queued)
+    {
+        CALLBACK(rpcCallbacks.onOutgoingPushDroppedQueueFull)(connectionId, methodName);
+        return false;
+    }
+
+    if (schedule)
+    {
+        std::call_once(m_pushWritersStarted, &FastRPC3::startPushWriters, this);
+
+        lock_guard<mutex> lk(m_pushMutex);
+        m_pushPendingConnections.push_back(connectionId);
+        m_pushCondition.notify_one();
+    }
+    return true;
+}
+
+void FastRPC3::flushPushQueue(const string &connectionId)
+{
+    FastRPC3::Connection *connection = (FastRPC3::Connection *) m_connectionMapById.openElement(connectionId);
+    if (!connection)
+        return;
+
+    std::deque<std::shared_ptr<const string>> frames;
+    for (;;)
+    {
+        {
+            lock_guard<mutex> lk(connection->pushQueueMutex);
+            if (connection->pushQueue.empty())
+            {
+                connection->pushScheduled = false;
+                break;
+            }
+            frames.swap(connection->pushQueue);
+        }
+
+        // Every queued frame is written in the same socket lock, with the (shorter) push write timeout:
+        connection->socketMutex->lock();
+        connection->stream->setWriteTimeout(config.pushWriteTimeoutInSeconds);
+        for (const auto &frame : frames)
+        {
+            // A failed stream can't be written again (pushes queued after the disconnection are discarded):
+            if (connection->terminated || !connection->stream->writeStatus.succeed)
+                break;
+            if (!connection->stream->writeFull(frame->data(), frame->size()))
+            {
+                // Slow or dead peer (the frame may be partially written): disconnect it, the connection loop cleans it up.
+                connection->stream->shutdownSocket();
+                break;
+            }
+        }
+        connection->stream->setWriteTimeout(config.rwTimeoutInSeconds);
+        connection->socketMutex->unlock();
+        frames.clear();
+    }
+
+    m_connectionMapById.releaseElement(connectionId);
+}
+
+void FastRPC3::startPushWriters()
+{
+    lock_guard<mutex> lk(m_pushMutex);
+    for (uint32_t i = 0; i < std::max(1U, config.pushWriterThreads); i++)
+        m_pushWriterThreads.emplace_back(vrsyncRPCPushWriterThread, this);
+}
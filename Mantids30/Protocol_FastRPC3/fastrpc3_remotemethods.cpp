@@ -22,7 +22,12 @@ json FastRPC3::RemoteMethods::loginViaJWTToken( const std::string & jwtToken, js
 {
     json jAuthData;
     jAuthData["jwtToken"] = jwtToken;
-    return executeTask( "SESSION.LOGIN", jAuthData, error, true, true);
+    json r = executeTask( "SESSION.LOGIN", jAuthData, error, true, true);
+
+    // The messages queued for this peer may require the session:
+    if (JSON_ASUINT(r, "val", static_cast<uint32_t>(LoginReason::INTERNAL_ERROR)) == LoginReason::TOKEN_VALIDATED)
+        parent->scheduleDurableDrain(connectionId);
+    return r;
 }
 
 json FastRPC3::RemoteMethods::executeTask(const string &methodName,
@@ -118,8 +123,17 @@ json FastRPC3::RemoteMethods::executeTask(const string &methodName,
         }
     }
 
+    connection->socketMutex->unlock();
+
     if (!dataTransmitOK)
     {
+        if (1)
+        {
+            unique_lock<mutex> lk(connection->answersMutex);
+            connection->pendingRequests.erase(requestId);
+        }
+        parent->m_connectionMapById.releaseElement(connectionId);
+
         if (error)
         {
             (*error)["succeed"] = false;
@@ -129,16 +143,15 @@ json FastRPC3::RemoteMethods::executeTask(const string &methodName,
         return r;
     }
 
-    connection->socketMutex->unlock();
-
     // Time to wait for answers...
     for (;;)
     {
         unique_lock<mutex> lk(connection->answersMutex);
 
         // Process multiple signals until our answer comes...
-
-        if (connection->answersCondition.wait_for(lk, Ms(parent->config.remoteExecutionTimeoutInMS)) == cv_status::timeout)
+        // (the answer may arrive before waiting, and it's notified only once)
+        if (connection->answers.find(requestId) == connection->answers.end() && !connection->terminated
+            && connection->answersCondition.wait_for(lk, Ms(parent->config.remoteExecutionTimeoutInMS)) == cv_status::timeout)
         {
             // break by timeout. (no answer)
             CALLBACK(parent->rpcCallbacks.onOutgoingTaskFailureTimeout)(connectionId, methodName, payload);
@@ -232,6 +245,11 @@ json FastRPC3::RemoteMethods::getSSOData(json *error)
     return parent->remote(connectionId).executeTask( "SESSION.GETSSODATA", {}, error, true, true );
 }
 
+bool FastRPC3::RemoteMethods::queueTask(const string &methodName, const json &payload, json *error, const uint32_t &ttlInSeconds, bool waitForCommit)
+{
+    return parent->queueDurableTask(connectionId, methodName, payload, error, ttlInSeconds, waitForCommit);
+}
+
 bool FastRPC3::RemoteMethods::close()
 {
     bool r = false;
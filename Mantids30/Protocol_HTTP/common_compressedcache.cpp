@@ -0,0 +1,165 @@
+#include "common_compressedcache.h"
+
+#include <Mantids30/Memory/streamablestring.h>
+
+using namespace Mantids30::Network::Protocols;
+using namespace Mantids30::Memory::Streams::Encoders;
+using namespace Mantids30;
+
+namespace {
+
+// Read-only view over a cached variant (keeps the variant alive while it is being streamed, even if evicted).
+class CompressedVariantView : public Memory::Containers::B_MEM
+{
+public:
+    CompressedVariantView(const std::shared_ptr<const std::string> & data)
+        : B_MEM(data->data(), static_cast<uint32_t>(data->size()))
+    {
+        m_data = data;
+    }
+
+private:
+    std::shared_ptr<const std::string> m_data;
+};
+
+std::string variantKey(const std::string & key, const Compression::eAlgorithm & algorithm)
+{
+    return Compression::getEncodingName(algorithm) + ":" + key;
+}
+
+}
+
+std::shared_ptr<HTTP::CompressedContentCache> HTTP::CompressedContentCache::getDefault()
+{
+    static std::shared_ptr<CompressedContentCache> defaultCache = std::make_shared<CompressedContentCache>();
+    return defaultCache;
+}
+
+std::shared_ptr<Memory::Streams::StreamableObject> HTTP::CompressedContentCache::get(const std::string &key, const Compression::eAlgorithm &algorithm,
+                                                                                     Memory::Containers::B_Base *content)
+{
+    if (!Compression::isAvailable(algorithm) || !content)
+        return nullptr;
+
+    std::string vKey = variantKey(key, algorithm);
+    size_t contentSize = content->size();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_variants.find(vKey);
+        if (it != m_variants.end())
+        {
+            if (!it->second.data)
+                return nullptr;
+            return std::make_shared<CompressedVariantView>(it->second.data);
+        }
+        if (contentSize > m_maxEntrySize || contentSize > UINT32_MAX)
+            return nullptr;
+    }
+
+    // First hit: compress outside the lock (concurrent first hits may compress it twice, the last one is kept).
+    Memory::Streams::StreamableString compressed;
+    Compression encoder(algorithm, Compression::getMaxLevel(algorithm));
+    if (!encoder.encode(content, &compressed))
+        return nullptr;
+
+    Variant variant;
+    if (compressed.getValue().size() < contentSize)
+        variant.data = std::make_shared<const std::string>(compressed.getValue());
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_variants.find(vKey);
+        if (it != m_variants.end())
+        {
+            m_totalSize -= getEntryCost(vKey, it->second);
+            it->second = variant;
+        }
+        else
+        {
+            m_variants[vKey] = variant;
+            m_insertionOrder.push_back(vKey);
+        }
+        m_totalSize += getEntryCost(vKey, variant);
+
+        // Keep the budget (discard the oldest variants):
+        while ((m_totalSize > m_maxTotalSize || m_variants.size() > m_maxEntries) && !m_insertionOrder.empty())
+        {
+            auto old = m_variants.find(m_insertionOrder.front());
+            m_insertionOrder.pop_front();
+            if (old == m_variants.end())
+                continue;
+            m_totalSize -= getEntryCost(old->first, old->second);
+            m_variants.erase(old);
+        }
+    }
+
+    if (!variant.data)
+        return nullptr;
+    return std::make_shared<CompressedVariantView>(variant.data);
+}
+
+bool HTTP::CompressedContentCache::isCompressible(const std::string &key, const Compression::eAlgorithm &algorithm)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_variants.find(variantKey(key, algorithm));
+    return it == m_variants.end() || it->second.data != nullptr;
+}
+
+void HTTP::CompressedContentCache::precompress(const std::string &key, Memory::Containers::B_Base *content)
+{
+    for (auto algorithm : {Compression::ALGORITHM_ZSTD, Compression::ALGORITHM_GZIP, Compression::ALGORITHM_DEFLATE})
+    {
+        if (Compression::isAvailable(algorithm))
+            get(key, algorithm, content);
+    }
+}
+
+void HTTP::CompressedContentCache::clear()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_variants.clear();
+    m_insertionOrder.clear();
+    m_totalSize = 0;
+}
+
+void HTTP::CompressedContentCache::setMaxEntrySize(const size_t &value)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_maxEntrySize = value;
+}
+
+size_t HTTP::CompressedContentCache::getMaxEntrySize()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_maxEntrySize;
+}
+
+void HTTP::CompressedContentCache::setMaxTotalSize(const size_t &value)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_maxTotalSize = value;
+}
+
+size_t HTTP::CompressedContentCache::getTotalSize()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_totalSize;
+}
+
+void HTTP::CompressedContentCache::setMaxEntries(const size_t &value)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_maxEntries = value;
+}
+
+size_t HTTP::CompressedContentCache::getEntryCount()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_variants.size();
+}
+
+size_t HTTP::CompressedContentCache::getEntryCost(const std::string &vKey, const Variant &variant)
+{
+    return ENTRY_OVERHEAD + (vKey.size() * 2) + (variant.data ? variant.data->size() : 0);
+}
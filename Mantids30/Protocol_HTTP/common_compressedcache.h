@@ -0,0 +1,85 @@
+#pragma once
+
+#include "streamencoder_compression.h"
+#include <Mantids30/Memory/b_mem.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Mantids30 { namespace Network { namespace Protocols { namespace HTTP {
+
+/**
+ * @brief The CompressedContentCache class keeps precompressed variants of immutable content (static content elements
+ *        and document root files), so repeated responses are sent with Content-Length and no compression work.
+ *
+ * Variants are compressed once at the highest level. The key should change when the content changes (eg. path + size +
+ * modification time), stale entries are discarded in insertion order when the cache budget (bytes or entries) is exceeded.
+ * Every entry is charged a fixed overhead plus its key, so the variants that do not compress (kept without data to avoid
+ * compressing them again) are also bounded.
+ */
+class CompressedContentCache
+{
+public:
+    CompressedContentCache() = default;
+
+    /**
+     * @brief getDefault Get the process-wide cache (shared by every HTTP server).
+     */
+    static std::shared_ptr<CompressedContentCache> getDefault();
+
+    /**
+     * @brief get Get the compressed variant of the content, compressing it on the first hit.
+     * @param key content key (should change when the content changes).
+     * @param algorithm compression algorithm.
+     * @param content uncompressed content (used on the first hit only).
+     * @return streamable variant (with a known size), or nullptr if the content can't be cached or does not compress
+     *         (then it should be sent uncompressed).
+     */
+    std::shared_ptr<Memory::Streams::StreamableObject> get(const std::string & key, const Memory::Streams::Encoders::Compression::eAlgorithm & algorithm,
+                                                           Memory::Containers::B_Base * content);
+    /**
+     * @brief isCompressible Get if a previous compression of this content produced a smaller output (unknown: true).
+     */
+    bool isCompressible(const std::string & key, const Memory::Streams::Encoders::Compression::eAlgorithm & algorithm);
+    /**
+     * @brief precompress Compress the content with every available algorithm (eg. during the server startup).
+     */
+    void precompress(const std::string & key, Memory::Containers::B_Base * content);
+
+    /**
+     * @brief clear Remove every variant.
+     */
+    void clear();
+
+    void setMaxEntrySize(const size_t &value);
+    size_t getMaxEntrySize();
+    void setMaxTotalSize(const size_t &value);
+    size_t getTotalSize();
+    void setMaxEntries(const size_t &value);
+    size_t getEntryCount();
+
+private:
+    struct Variant
+    {
+        // Compressed data (nullptr when the content does not compress).
+        std::shared_ptr<const std::string> data;
+    };
+
+    // Accounted memory of an entry besides its data (map/list nodes, key copies and the variant itself):
+    static constexpr size_t ENTRY_OVERHEAD = 128;
+    static size_t getEntryCost(const std::string & vKey, const Variant & variant);
+
+    std::map<std::string, Variant> m_variants;
+    std::list<std::string> m_insertionOrder;
+    std::mutex m_mutex;
+
+    size_t m_totalSize = 0;
+    size_t m_maxEntrySize = 8*1024*1024;
+    size_t m_maxTotalSize = 64*1024*1024;
+    size_t m_maxEntries = 65536;
+};
+
+}}}}
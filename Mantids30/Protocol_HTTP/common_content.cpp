@@ -2,6 +2,7 @@
 #include <Mantids30/Memory/streamablejson.h>
 #include "common_content_chunked_subparser.h"
 
+#include <limits>
 #include <optional>
 #include <stdexcept>
 
@@ -43,10 +44,13 @@ Memory::Streams::SubParser::ParseStatus HTTP::Content::parse()
                 }
                 else
                 {
-                    // Done... last chunk.
-                    // report that is last chunk.
-                    m_outStream->writeEOF();
-                    return Memory::Streams::SubParser::PARSE_GOTO_NEXT_SUBPARSER;
+                    // Last chunk, consume the trailer section (up to the empty line), so nothing of this message is
+                    // left on persistent connections.
+                    setParseMode(Memory::Streams::SubParser::PARSE_MODE_DELIMITER);
+                    setParseDelimiter("\r\n");
+                    setParseDataTargetSize(8*KB_MULT);
+                    m_currentMode = PROCMODE_CHUNK_TRAILER;
+                    return Memory::Streams::SubParser::PARSE_GET_MORE_DATA;
                 }
             }
             return Memory::Streams::SubParser::PARSE_ERROR;
@@ -70,6 +74,17 @@ Memory::Streams::SubParser::ParseStatus HTTP::Content::parse()
             m_currentMode = PROCMODE_CHUNK_SIZE;
             return Memory::Streams::SubParser::PARSE_GET_MORE_DATA;
         }
+        case PROCMODE_CHUNK_TRAILER:
+        {
+            if (getParsedBuffer()->size())
+            {
+                // Trailer field (ignored), continue...
+                return Memory::Streams::SubParser::PARSE_GET_MORE_DATA;
+            }
+            // Done... report that is last chunk.
+            m_outStream->writeEOF();
+            return Memory::Streams::SubParser::PARSE_GOTO_NEXT_SUBPARSER;
+        }
         case PROCMODE_CONTENT_LENGTH:
         {
             // TODO: validate when outstream is filled up.
@@ -214,12 +229,22 @@ bool HTTP::Content::streamToUpstream()
     case TRANSMIT_MODE_CHUNKS:
     {
         ContentChunkedTransformer chunkedLiveTransformer(m_upStream);
+        if (m_contentEncoding != Memory::Streams::Encoders::Compression::ALGORITHM_NONE)
+        {
+            Memory::Streams::Encoders::Compression encoder(m_contentEncoding, m_contentEncodingLevel);
+            return encoder.encode(m_outStream.get(), &chunkedLiveTransformer);
+        }
         m_outStream->streamTo(&chunkedLiveTransformer);
         return m_outStream->writeStatus.succeed;
     }
     case TRANSMIT_MODE_CONTENT_LENGTH:
     case TRANSMIT_MODE_CONNECTION_CLOSE:
     {
+        if (m_contentEncoding != Memory::Streams::Encoders::Compression::ALGORITHM_NONE)
+        {
+            Memory::Streams::Encoders::Compression encoder(m_contentEncoding, m_contentEncodingLevel);
+            return encoder.encode(m_outStream.get(), m_upStream);
+        }
         m_outStream->streamTo(m_upStream);
         return m_outStream->writeStatus.succeed;
     }
@@ -227,6 +252,17 @@ bool HTTP::Content::streamToUpstream()
     return true;
 }
 
+void HTTP::Content::setContentEncoding(const Memory::Streams::Encoders::Compression::eAlgorithm &algorithm, const int &level)
+{
+    m_contentEncoding = algorithm;
+    m_contentEncodingLevel = level;
+}
+
+Memory::Streams::Encoders::Compression::eAlgorithm HTTP::Content::getContentEncoding() const
+{
+    return m_contentEncoding;
+}
+
 void HTTP::Content::setTransmitionMode(const eTransmitionMode &value)
 {
     m_transmitionMode = value;
@@ -316,6 +352,9 @@ void HTTP::Content::setStreamableObj(std::shared_ptr<Memory::Streams::Streamable
 
 size_t HTTP::Content::getStreamSize()
 {
+    // The compressed size is known only after streaming it.
+    if (m_contentEncoding != Memory::Streams::Encoders::Compression::ALGORITHM_NONE)
+        return std::numeric_limits<size_t>::max();
     return m_outStream->size();
 }
 
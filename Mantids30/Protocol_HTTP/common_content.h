@@ -2,6 +2,7 @@
 
 #include <Mantids30/Memory/streamablejson.h>
 #include "common_urlvars.h"
+#include "streamencoder_compression.h"
 
 #include <Mantids30/Memory/subparser.h>
 #include <Mantids30/Memory/b_base.h>
@@ -24,6 +25,7 @@ public:
         PROCMODE_CHUNK_SIZE,
         PROCMODE_CHUNK_DATA,
         PROCMODE_CHUNK_CRLF,
+        PROCMODE_CHUNK_TRAILER,
         PROCMODE_CONTENT_LENGTH,
         PROCMODE_CONNECTION_CLOSE
     };
@@ -127,6 +129,17 @@ public:
      * @return type
      */
     eDataType getContainerType() const;
+    /**
+     * @brief setContentEncoding Compress the output while it is streamed (the compressed size is unknown, so it should
+     *                           be transmitted in chunks or until the connection close).
+     * @param algorithm compression algorithm (ALGORITHM_NONE to stream the content as is)
+     * @param level compression level (-1: algorithm default)
+     */
+    void setContentEncoding(const Memory::Streams::Encoders::Compression::eAlgorithm &algorithm, const int & level = -1);
+    /**
+     * @brief getContentEncoding Get the compression algorithm applied while streaming the output.
+     */
+    Memory::Streams::Encoders::Compression::eAlgorithm getContentEncoding() const;
 
 
     //////////////////////////////////////////////////
@@ -153,6 +166,10 @@ private:
     eProcessingMode m_currentMode = PROCMODE_CONTENT_LENGTH;
     eDataType m_containerType = CONTENT_TYPE_BIN;
 
+    // Output compression:
+    Memory::Streams::Encoders::Compression::eAlgorithm m_contentEncoding = Memory::Streams::Encoders::Compression::ALGORITHM_NONE;
+    int m_contentEncodingLevel = -1;
+
     // Security Parameters (for parsing):
     size_t m_securityMaxPostDataSize = 17*MB_MULT; // 17Mb intermediate buffer (suitable for 16mb max chunk...).
     size_t m_currentContentLengthSize = 0;
@@ -85,9 +85,25 @@ bool HTTP::HTTPv1_Client::changeToNextParser()
         parseHeaders2ServerCookies();
         // Parse the transmition mode requested and act according it.
         m_currentParser = parseHeaders2TransmitionMode();
+
+        if (m_responseTooLarge)
+            return false;
+
+        m_responseHeaderComplete = true;
+
+        if (!m_currentParser)
+            m_responseComplete = true;
+        else if (m_pauseAfterHeaders)
+        {
+            // Stop reading from the stream after the current data block (the body is received by receiveResponseBody)
+            writeStatus.finish = true;
+        }
     }
     else // END.
+    {
         m_currentParser = nullptr;
+        m_responseComplete = true;
+    }
     return true;
 }
 
@@ -100,23 +116,48 @@ void HTTP::HTTPv1_Client::parseHeaders2ServerCookies()
 
 Memory::Streams::SubParser * HTTP::HTTPv1_Client::parseHeaders2TransmitionMode()
 {
+    m_bodyUntilClose = false;
     serverResponse.content.setTransmitionMode(HTTP::Content::TRANSMIT_MODE_CONNECTION_CLOSE);
+
+    // Responses without body (don't wait for the connection to be closed):
+    if (!hasResponseBody())
+    {
+        serverResponse.content.setTransmitionMode(HTTP::Content::TRANSMIT_MODE_CONTENT_LENGTH);
+        return nullptr;
+    }
+
     // Set Content Data Reception Mode.
     if (serverResponse.headers.exist("Content-Length"))
     {
         uint64_t len = serverResponse.headers.getOptionAsUINT64("Content-Length");
         serverResponse.content.setTransmitionMode(HTTP::Content::TRANSMIT_MODE_CONTENT_LENGTH);
 
-        // Error setting up that size or no data... (don't continue)
-        if (!len || !serverResponse.content.setContentLenSize(len))
+        // No data... (don't continue)
+        if (!len)
+            return nullptr;
+        // Error setting up that size...
+        if (!serverResponse.content.setContentLenSize(len))
+        {
+            m_responseTooLarge = true;
             return nullptr;
+        }
     }
     else if (icontains(serverResponse.headers.getOptionValueStringByName("Transfer-Encoding"),"CHUNKED"))
         serverResponse.content.setTransmitionMode(HTTP::Content::TRANSMIT_MODE_CHUNKS);
+    else
+        m_bodyUntilClose = true;
 
     return &serverResponse.content;
 }
 
+bool HTTP::HTTPv1_Client::hasResponseBody()
+{
+    unsigned short code = serverResponse.status.getCode();
+    if ((code >= 100 && code < 200) || code == 204 || code == 304)
+        return false;
+    return clientRequest.requestLine.getRequestMethod() != "HEAD";
+}
+
 bool HTTP::HTTPv1_Client::streamClientHeaders()
 {
     // Act as a server. Send data from here.
@@ -127,10 +168,19 @@ bool HTTP::HTTPv1_Client::streamClientHeaders()
         return false;
     else
     {
-        clientRequest.headers.remove("Connetion");
         clientRequest.headers.replace("Content-Length", std::to_string(strsize));
     }
 
+    // Hop-by-hop headers (eg. copied from another request) are defined here:
+    clientRequest.headers.remove("Keep-Alive");
+    if (m_keepAlive)
+    {
+        clientRequest.requestLine.getHTTPVersion()->upgradeMinor(1);
+        clientRequest.headers.replace("Connection", "keep-alive");
+    }
+    else
+        clientRequest.headers.remove("Connection");
+
     // Put client cookies:
     m_clientCookies.putOnHeaders(&clientRequest.headers);
 
@@ -156,6 +206,60 @@ std::string HTTP::HTTPv1_Client::getServerContentType() const
     return m_serverContentType;
 }
 
+void HTTP::HTTPv1_Client::setKeepAlive(bool value)
+{
+    m_keepAlive = value;
+}
+
+void HTTP::HTTPv1_Client::setPauseAfterHeaders(bool value)
+{
+    m_pauseAfterHeaders = value;
+}
+
+bool HTTP::HTTPv1_Client::receiveResponseBody()
+{
+    if (m_responseComplete)
+        return true;
+    if (!m_currentParser || !m_streamableObject)
+        return false;
+
+    writeStatus.finish = false;
+    if (!m_streamableObject->streamTo(this))
+        return false;
+
+    if (!m_responseComplete && m_bodyUntilClose)
+    {
+        // The connection was closed by the server: that is the end of the body.
+        m_currentParser = nullptr;
+        m_responseComplete = true;
+    }
+    return m_responseComplete;
+}
+
+bool HTTP::HTTPv1_Client::isResponseHeaderComplete() const
+{
+    return m_responseHeaderComplete;
+}
+
+bool HTTP::HTTPv1_Client::isResponseComplete() const
+{
+    return m_responseComplete;
+}
+
+bool HTTP::HTTPv1_Client::isConnectionReusable()
+{
+    if (!m_keepAlive || !m_responseComplete || m_bodyUntilClose)
+        return false;
+
+    std::string connection = serverResponse.headers.getOptionValueStringByName("Connection");
+    if (iequals(connection, "close"))
+        return false;
+
+    // HTTP/1.1 is persistent by default, HTTP/1.0 only if the server says so.
+    HTTP::Version * version = serverResponse.status.getHTTPVersion();
+    return (version->getMajor() == 1 && version->getMinor() >= 1) || iequals(connection, "keep-alive");
+}
+
 void HTTP::HTTPv1_Client::setClientRequest(const std::string &hostName, const std::string &uriPath)
 {
     if (!hostName.empty()) clientRequest.requestLine.getHTTPVersion()->upgradeMinor(1);
@@ -6,7 +6,6 @@
 // TODO: https://en.wikipedia.org/wiki/Media_type
 // TODO: cuando el request para doh5 este listo, pre-procesar primero el request y luego recibir los datos.
 // TODO: post data? <<< IMPORTANT.
-// TODO: reuse the connection?...
 // TODO: header: :scheme:https (begins with :)
 
 namespace Mantids30 { namespace Network { namespace Protocols { namespace HTTP {
@@ -79,6 +78,39 @@ public:
      */
     std::string getServerContentType() const;
 
+    /**
+     * @brief setKeepAlive Request the server to keep the connection open after the response (HTTP/1.1 persistent
+     *                     connection), so it can be used by another HTTPv1_Client (see isConnectionReusable()).
+     * @param value true to request keep-alive (default false: one request per connection).
+     */
+    void setKeepAlive(bool value);
+    /**
+     * @brief setPauseAfterHeaders Make parseObject return as soon as the response headers are received, so the
+     *                             response body can be consumed as it arrives with receiveResponseBody().
+     *                             Body bytes received along with the headers are already written to the content.
+     * @param value true to pause after the headers.
+     */
+    void setPauseAfterHeaders(bool value);
+    /**
+     * @brief receiveResponseBody Continue receiving the response body after a paused parseObject.
+     * @return true if the body was completely received.
+     */
+    bool receiveResponseBody();
+    /**
+     * @brief isResponseHeaderComplete Check if the response status and headers were received.
+     */
+    bool isResponseHeaderComplete() const;
+    /**
+     * @brief isResponseComplete Check if the whole response (including the body) was received.
+     */
+    bool isResponseComplete() const;
+    /**
+     * @brief isConnectionReusable Check if the connection can be used for another request: keep-alive was requested
+     *                             and accepted by the server, and the response was completely received with a known
+     *                             length.
+     */
+    bool isConnectionReusable();
+
 protected:
     bool initProtocol() override;
 
@@ -107,9 +139,18 @@ private:
 
     bool streamClientHeaders();
 
+    bool hasResponseBody();
+
     HTTP::Request::Cookies_ClientSide m_clientCookies;
 
     std::string m_serverContentType;
+
+    bool m_keepAlive = false;
+    bool m_pauseAfterHeaders = false;
+    bool m_responseHeaderComplete = false;
+    bool m_responseComplete = false;
+    bool m_bodyUntilClose = false;
+    bool m_responseTooLarge = false;
 };
 
 }}}}
@@ -2,7 +2,9 @@
 
 #include "hdr_cookie.h"
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <stdexcept>
 
@@ -10,6 +12,7 @@
 #include <boost/algorithm/string.hpp>
 #include <Mantids30/Helpers/encoders.h>
 #include <Mantids30/Memory/b_mmap.h>
+#include <Mantids30/Program_Tracing/tracing.h>
 
 #include <sys/stat.h>
 
@@ -34,6 +37,7 @@ using namespace Mantids30;
 HTTP::HTTPv1_Server::HTTPv1_Server(std::shared_ptr<StreamableObject> sobject) : HTTPv1_Base(false, sobject)
 {
     m_badAnswer = false;
+    m_connectionStartTime = std::chrono::steady_clock::now();
 
     // All request will have no-cache activated.... (unless it's a real file and it's not overwritten)
     serverResponse.cacheControl.optionNoCache = true;
@@ -121,6 +125,7 @@ HTTP::HTTPv1_Server::HTTPv1_Server(std::shared_ptr<StreamableObject> sobject) :
     m_mimeTypes[".7z"]     = "application/x-7z-compressed";
 
     m_includeServerDate = true;
+    m_responseCompression.enabled = false;
 }
 
 void HTTP::HTTPv1_Server::setResponseServerName(const string &sServerName)
@@ -134,6 +139,8 @@ bool HTTP::HTTPv1_Server::getLocalFilePathFromURI2(string sServerDir, sLocalRequ
         throw std::runtime_error( std::string(__func__) + std::string(" Should be called with info object... Aborting...") );
 
     info->reset();
+    m_responseCacheKey.clear();
+    m_responseCacheContent = nullptr;
 
     {
         char *cServerDir;
@@ -175,7 +182,10 @@ bool HTTP::HTTPv1_Server::getLocalFilePathFromURI2(string sServerDir, sLocalRequ
 
             info->sRealFullPath = "MEM:" + info->sRealRelativePath;
 
-            serverResponse.setDataStreamer(m_staticContentElements[info->sRealRelativePath]);
+            m_responseCacheContent = m_staticContentElements[info->sRealRelativePath];
+            m_responseCacheKey = getStaticContentCacheKey(info->sRealRelativePath, m_staticContentElements[info->sRealRelativePath]);
+
+            serverResponse.setDataStreamer(m_responseCacheContent);
             return true;
         }
         else if ((cFullPath=realpath(sFullRequestedPath.c_str(), nullptr))!=nullptr)
@@ -266,6 +276,15 @@ bool HTTP::HTTPv1_Server::getLocalFilePathFromURI2(string sServerDir, sLocalRequ
                 serverResponse.setDataStreamer(bFile);
                 setResponseContentTypeByFileExtension(info->sRealRelativePath);
 
+                // The file variants are valid while the file is not modified:
+                m_responseCacheContent = bFile;
+#ifdef _WIN32
+                m_responseCacheKey = info->sRealFullPath + ":" + std::to_string(stats.st_size) + ":" + std::to_string(stats.st_mtime);
+#else
+                m_responseCacheKey = info->sRealFullPath + ":" + std::to_string(stats.st_size) + ":" + std::to_string(stats.st_mtim.tv_sec) + "."
+                                     + std::to_string(stats.st_mtim.tv_nsec);
+#endif
+
                 struct stat attrib;
                 if (!stat(sFullRequestedPath.c_str(), &attrib))
                 {
@@ -703,20 +722,50 @@ bool HTTP::HTTPv1_Server::answer()
     pthread_setname_np(pthread_self(), "HTTP:Response");
 #endif
 
+    // Trace the request (sampled, or asked by the client with "X-Mantids-Trace: 1"):
+    bool traced = Program::Tracing::shouldSample()
+                  || (Program::Tracing::isRequestTriggerAllowed() && clientRequest.headers.getOptionValueStringByName("X-Mantids-Trace") == "1");
+    auto requestStart = m_connectionStartTime;
+    for (const auto &transportSpan : m_transportSpans)
+        requestStart = std::min(requestStart, transportSpan.start);
+
+    // Only the path is recorded (a query string, even URL-encoded in the path, may carry credentials):
+    std::string traceDetail;
+    if (traced)
+    {
+        traceDetail = clientRequest.requestLine.getURI();
+        traceDetail = traceDetail.substr(0, traceDetail.find('?'));
+    }
+    Program::Tracing::Trace trace("http.request", traced, requestStart, traced ? traceDetail.c_str() : nullptr);
+    if (trace.isActive())
+    {
+        for (const auto &transportSpan : m_transportSpans)
+            Program::Tracing::recordSpan(transportSpan.name, transportSpan.start, transportSpan.end);
+        Program::Tracing::recordSpan("http.parse", m_connectionStartTime, std::chrono::steady_clock::now());
+    }
+
     // Process client petition here.
     if (!m_badAnswer)
     {
+        Program::Tracing::Span span("http.handler");
         serverResponse.status.setCode(procHTTPClientContent());
     }
 
     // Answer is the last... close the connection after it.
     m_currentParser = nullptr;
 
+    Program::Tracing::Span responseSpan("http.response");
+
     if (!serverResponse.status.streamToUpstream())
     {
         return false;
     }
 
+    prepareResponseCompression();
+
+    if (trace.isActive() && !serverResponse.immutableHeaders)
+        serverResponse.headers.replace("X-Trace-Id", Program::Tracing::traceIdToString(trace.getTraceId()));
+
     if (!streamServerHeaders())
     {
         return false;
@@ -726,10 +775,89 @@ bool HTTP::HTTPv1_Server::answer()
 
     // Destroy the binary content container here:
     serverResponse.content.setStreamableObj(nullptr);
+    serverResponse.content.setContentEncoding(Memory::Streams::Encoders::Compression::ALGORITHM_NONE);
+    m_responseCacheKey.clear();
+    m_responseCacheContent = nullptr;
 
     return streamedOK;
 }
 
+void HTTP::HTTPv1_Server::addTransportSpan(const char *name, const std::chrono::steady_clock::time_point &start, const std::chrono::steady_clock::time_point &end)
+{
+    if (!Program::Tracing::isEnabled())
+        return;
+    m_transportSpans.push_back({name, start, end});
+}
+
+void HTTP::HTTPv1_Server::prepareResponseCompression()
+{
+    using Memory::Streams::Encoders::Compression;
+
+    if (!m_responseCompression.enabled || serverResponse.immutableHeaders)
+        return;
+
+    // Only complete (2xx) responses with a body, and not already encoded:
+    unsigned short code = serverResponse.status.getCode();
+    if (code < 200 || code >= 300 || code == 204 || code == 206 || clientRequest.requestLine.getRequestMethod() == "HEAD")
+        return;
+    if (!serverResponse.headers.getOptionRawStringByName("Content-Encoding").empty() || !isCompressibleContentType())
+        return;
+
+    // From here, the response depends on the client Accept-Encoding:
+    serverResponse.headers.replace("Vary", "Accept-Encoding");
+
+    size_t contentSize = serverResponse.content.getStreamSize();
+    if (contentSize != std::numeric_limits<size_t>::max() && contentSize < m_responseCompression.minSize)
+        return;
+
+    Compression::eAlgorithm algorithm = Compression::negotiate(clientRequest.headers.getOptionRawStringByName("Accept-Encoding"), m_responseCompression.algorithms);
+    if (algorithm == Compression::ALGORITHM_NONE)
+        return;
+
+    // Immutable content: send the precompressed variant (compressed on the first hit)
+    if (m_responseCompression.useCache && !m_responseCacheKey.empty() && m_responseCacheContent
+            && serverResponse.content.getStreamableObj() == m_responseCacheContent)
+    {
+        std::shared_ptr<CompressedContentCache> cache = CompressedContentCache::getDefault();
+        std::shared_ptr<Memory::Streams::StreamableObject> variant = cache->get(m_responseCacheKey, algorithm, m_responseCacheContent.get());
+        if (variant)
+        {
+            serverResponse.content.setStreamableObj(variant);
+            serverResponse.headers.replace("Content-Encoding", Compression::getEncodingName(algorithm));
+            return;
+        }
+        if (!cache->isCompressible(m_responseCacheKey, algorithm))
+            return;
+        // Not cacheable (too big), compress it while streaming...
+    }
+
+    // Dynamic content: compress it while streaming (with unknown size):
+    serverResponse.content.setContentEncoding(algorithm, m_responseCompression.level);
+    serverResponse.headers.replace("Content-Encoding", Compression::getEncodingName(algorithm));
+    if (clientRequest.requestLine.getHTTPVersion()->getMinor() >= 1)
+        serverResponse.content.setTransmitionMode(HTTP::Content::TRANSMIT_MODE_CHUNKS);
+}
+
+bool HTTP::HTTPv1_Server::isCompressibleContentType()
+{
+    std::string contentType = serverResponse.contentType;
+    size_t semicolon = contentType.find(';');
+    if (semicolon != std::string::npos)
+        contentType.resize(semicolon);
+    boost::trim(contentType);
+    boost::to_lower(contentType);
+
+    if (contentType.empty())
+        return false;
+
+    for (const std::string & allowed : m_responseCompression.contentTypes)
+    {
+        if (allowed.back() == '/' ? boost::starts_with(contentType, allowed) : contentType == allowed)
+            return true;
+    }
+    return false;
+}
+
 void HTTP::HTTPv1_Server::setStaticContentElements(const std::map<std::string, std::shared_ptr<Mantids30::Memory::Containers::B_MEM>> &value)
 {
     m_staticContentElements = value;
@@ -782,6 +910,37 @@ void HTTP::HTTPv1_Server::setResponseIncludeServerDate(bool value)
     m_includeServerDate = value;
 }
 
+void HTTP::HTTPv1_Server::setResponseCompression(const CompressionParameters &value)
+{
+    m_responseCompression = value;
+}
+
+std::string HTTP::HTTPv1_Server::getStaticContentCacheKey(const std::string &path, const std::shared_ptr<Memory::Containers::B_MEM> &contentElement)
+{
+    // Each element gets its own generation number (a replaced element gets new variants, even if it is allocated at the
+    // same address). The weak references keep the control blocks, so a live element can't be taken for an old one.
+    static std::mutex generationsMutex;
+    static std::map<std::weak_ptr<Memory::Containers::B_MEM>, uint64_t, std::owner_less<>> generations;
+    static uint64_t lastGeneration = 0;
+
+    uint64_t generation;
+    {
+        std::unique_lock<std::mutex> lock(generationsMutex);
+        auto it = generations.find(contentElement);
+        if (it != generations.end())
+            generation = it->second;
+        else
+        {
+            // Forget the released elements:
+            for (auto i = generations.begin(); i != generations.end();)
+                i = i->first.expired() ? generations.erase(i) : std::next(i);
+            generation = ++lastGeneration;
+            generations[contentElement] = generation;
+        }
+    }
+    return "MEM:" + path + "#" + std::to_string(generation);
+}
+
 void HTTP::HTTPv1_Server::addStaticContent(const string &path, std::shared_ptr<Memory::Containers::B_MEM> contentElement)
 {
     m_staticContentElements[path] = contentElement;
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "httpv1_base.h"
+#include "common_compressedcache.h"
+#include <chrono>
 #include <memory>
+#include <set>
+#include <vector>
 
 // TODO: https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/Access-Control-Allow-Credentials
 
@@ -35,6 +39,39 @@ public:
         bool isDir, isExecutable, isTransversal, pathExist;
     };
 
+    struct CompressionParameters
+    {
+        /**
+         * @brief enabled Compress the responses when the client accepts it (Accept-Encoding).
+         */
+        bool enabled = true;
+        /**
+         * @brief minSize Responses smaller than this are sent uncompressed (unknown sizes are compressed).
+         */
+        size_t minSize = 1024;
+        /**
+         * @brief contentTypes Compressible content types (entries ending with '/' match the whole type, eg. "text/")
+         */
+        std::set<std::string> contentTypes = {"text/", "application/javascript", "application/json", "application/ld+json",
+                                              "application/xml", "application/xhtml+xml", "application/wasm",
+                                              "image/svg+xml", "image/vnd.microsoft.icon", "image/bmp", "font/ttf", "font/otf"};
+        /**
+         * @brief algorithms Server algorithms in preference order (used on equal client q-values).
+         */
+        std::vector<Memory::Streams::Encoders::Compression::eAlgorithm> algorithms = {Memory::Streams::Encoders::Compression::ALGORITHM_ZSTD,
+                                                                                      Memory::Streams::Encoders::Compression::ALGORITHM_GZIP,
+                                                                                      Memory::Streams::Encoders::Compression::ALGORITHM_DEFLATE};
+        /**
+         * @brief level Compression level for dynamic responses (-1: algorithm default).
+         */
+        int level = -1;
+        /**
+         * @brief useCache Serve static content and document root files from the precompressed variants cache
+         *                 (CompressedContentCache::getDefault())
+         */
+        bool useCache = true;
+    };
+
     HTTPv1_Server(std::shared_ptr<Memory::Streams::StreamableObject> sobject);
 
 
@@ -101,6 +138,17 @@ public:
 
     void setResponseIncludeServerDate(bool value);
 
+    /**
+     * @brief setResponseCompression Set the response compression (disabled by default)
+     * @param value compression parameters
+     */
+    void setResponseCompression(const CompressionParameters & value);
+    /**
+     * @brief getStaticContentCacheKey Get the precompressed variants cache key of a static content element
+     *                                 (to precompress it at startup). The key changes when the element is replaced.
+     */
+    static std::string getStaticContentCacheKey(const std::string & path, const std::shared_ptr<Memory::Containers::B_MEM> & contentElement);
+
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // OTHER FUNCTIONS:
     /**
@@ -114,6 +162,15 @@ public:
 
     void setClientInfoVars( const char * ipAddr, const bool & secure, const std::string & tlsCommonName);
 
+    /**
+     * @brief addTransportSpan Add a phase measured before the request parsing (eg. the TLS handshake) to the request trace.
+     *                         Only kept when tracing is enabled (see Program::Tracing).
+     * @param name span name (static storage)
+     * @param start phase start
+     * @param end phase end
+     */
+    void addTransportSpan(const char * name, const std::chrono::steady_clock::time_point & start, const std::chrono::steady_clock::time_point & end);
+
 protected:
 
     bool verifyStaticContentExistence(const std::string & path);
@@ -156,6 +213,8 @@ private:
     bool changeToNextParserFromClientContentData();
 
     bool streamServerHeaders();
+    void prepareResponseCompression();
+    bool isCompressibleContentType();
     void prepareServerVersionOnURI();
 
     void prepareServerVersionOnOptions();
@@ -171,6 +230,19 @@ private:
     std::string m_currentFileExtension;
     bool m_includeServerDate;
     std::map<std::string,std::string> m_mimeTypes;
+
+    CompressionParameters m_responseCompression;
+    // Precompressed variants key of the content being served (static content or document root file):
+    std::string m_responseCacheKey;
+    std::shared_ptr<Memory::Containers::B_Base> m_responseCacheContent;
+
+    struct TransportSpan
+    {
+        const char * name;
+        std::chrono::steady_clock::time_point start, end;
+    };
+    std::vector<TransportSpan> m_transportSpans;
+    std::chrono::steady_clock::time_point m_connectionStartTime;
 };
 
 }}}}
@@ -0,0 +1,266 @@
+#include "streamencoder_compression.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <zlib.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <boost/algorithm/string.hpp>
+
+using namespace Mantids30::Memory::Streams;
+using namespace Mantids30::Memory::Streams::Encoders;
+
+struct Compression::State
+{
+    bool zInitialized = false;
+    z_stream zStream;
+#ifdef HAVE_ZSTD
+    ZSTD_CStream * zstdStream = nullptr;
+#endif
+    unsigned char outBuffer[16384];
+};
+
+Compression::Compression(const eAlgorithm &algorithm, const int &level)
+{
+    m_state = std::make_unique<State>();
+    m_algorithm = algorithm;
+
+    switch (m_algorithm)
+    {
+    case ALGORITHM_DEFLATE:
+    case ALGORITHM_GZIP:
+    {
+        memset(&m_state->zStream, 0, sizeof(z_stream));
+        // windowBits: 15 for the zlib format (HTTP deflate), +16 for the gzip wrapper.
+        m_state->zInitialized = deflateInit2(&m_state->zStream, level < 0 ? Z_DEFAULT_COMPRESSION : level, Z_DEFLATED,
+                                             m_algorithm == ALGORITHM_GZIP ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        if (!m_state->zInitialized)
+            m_algorithm = ALGORITHM_NONE;
+    }break;
+    case ALGORITHM_ZSTD:
+    {
+#ifdef HAVE_ZSTD
+        m_state->zstdStream = ZSTD_createCStream();
+        if (!m_state->zstdStream || ZSTD_isError(ZSTD_initCStream(m_state->zstdStream, level < 0 ? 3 : level)))
+            m_algorithm = ALGORITHM_NONE;
+#else
+        m_algorithm = ALGORITHM_NONE;
+#endif
+    }break;
+    case ALGORITHM_NONE:
+        break;
+    }
+}
+
+Compression::~Compression()
+{
+    if (m_state->zInitialized)
+        deflateEnd(&m_state->zStream);
+#ifdef HAVE_ZSTD
+    if (m_state->zstdStream)
+        ZSTD_freeCStream(m_state->zstdStream);
+#endif
+}
+
+bool Compression::encode(Memory::Streams::StreamableObject *in, Memory::Streams::StreamableObject *out)
+{
+    m_finished = false;
+    transform(in, out);
+    // Containers don't stream the EOF, so close the compressed stream here:
+    if (!m_finished && out->writeStatus.succeed)
+        writeTransformerEOF(out);
+    return m_finished && out->writeStatus.succeed;
+}
+
+bool Compression::isAvailable(const eAlgorithm &algorithm)
+{
+    switch (algorithm)
+    {
+    case ALGORITHM_DEFLATE:
+    case ALGORITHM_GZIP:
+        return true;
+    case ALGORITHM_ZSTD:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    case ALGORITHM_NONE:
+        break;
+    }
+    return false;
+}
+
+std::string Compression::getEncodingName(const eAlgorithm &algorithm)
+{
+    switch (algorithm)
+    {
+    case ALGORITHM_DEFLATE:
+        return "deflate";
+    case ALGORITHM_GZIP:
+        return "gzip";
+    case ALGORITHM_ZSTD:
+        return "zstd";
+    case ALGORITHM_NONE:
+        break;
+    }
+    return "identity";
+}
+
+int Compression::getMaxLevel(const eAlgorithm &algorithm)
+{
+    switch (algorithm)
+    {
+    case ALGORITHM_DEFLATE:
+    case ALGORITHM_GZIP:
+        return Z_BEST_COMPRESSION;
+    case ALGORITHM_ZSTD:
+        // Higher levels use a lot of memory for a small gain.
+        return 19;
+    case ALGORITHM_NONE:
+        break;
+    }
+    return -1;
+}
+
+Compression::eAlgorithm Compression::negotiate(const std::string &acceptEncoding, const std::vector<eAlgorithm> &preferences)
+{
+    // q-values in thousandths, -1: not listed.
+    int qAlgorithm[4] = {-1, -1, -1, -1};
+    int qAny = -1;
+
+    std::vector<std::string> codings;
+    boost::split(codings, acceptEncoding, boost::is_any_of(","), boost::token_compress_on);
+
+    for (std::string coding : codings)
+    {
+        int q = 1000;
+        size_t semicolon = coding.find(';');
+        if (semicolon != std::string::npos)
+        {
+            std::string params = coding.substr(semicolon + 1);
+            coding = coding.substr(0, semicolon);
+            boost::trim(params);
+            if (params.size() > 2 && (params[0] == 'q' || params[0] == 'Q') && params[1] == '=')
+                q = static_cast<int>(strtod(params.c_str() + 2, nullptr) * 1000);
+        }
+        boost::trim(coding);
+        boost::to_lower(coding);
+
+        if (coding == "gzip" || coding == "x-gzip")
+            qAlgorithm[ALGORITHM_GZIP] = q;
+        else if (coding == "deflate")
+            qAlgorithm[ALGORITHM_DEFLATE] = q;
+        else if (coding == "zstd")
+            qAlgorithm[ALGORITHM_ZSTD] = q;
+        else if (coding == "*")
+            qAny = q;
+    }
+
+    eAlgorithm r = ALGORITHM_NONE;
+    int rQ = 0;
+    for (const eAlgorithm & algorithm : preferences)
+    {
+        if (algorithm == ALGORITHM_NONE || !isAvailable(algorithm))
+            continue;
+        int q = qAlgorithm[algorithm] >= 0 ? qAlgorithm[algorithm] : qAny;
+        if (q > rQ)
+        {
+            r = algorithm;
+            rQ = q;
+        }
+    }
+    return r;
+}
+
+size_t Compression::writeTo(Memory::Streams::StreamableObject *dst, const void *buf, const size_t &count)
+{
+    if (m_finished || !compress(dst, buf, count, false))
+    {
+        dst->writeStatus += -1;
+        return 0;
+    }
+    return count;
+}
+
+size_t Compression::writeTransformerEOF(Memory::Streams::StreamableObject *dst)
+{
+    if (m_finished)
+        return 0;
+    if (!compress(dst, nullptr, 0, true))
+    {
+        dst->writeStatus += -1;
+        return 0;
+    }
+    m_finished = true;
+    return 0;
+}
+
+bool Compression::compress(Memory::Streams::StreamableObject *dst, const void *buf, const size_t &count, bool finish)
+{
+    unsigned char * outBuffer = m_state->outBuffer;
+    const size_t outBufferSize = sizeof(m_state->outBuffer);
+
+    switch (m_algorithm)
+    {
+    case ALGORITHM_DEFLATE:
+    case ALGORITHM_GZIP:
+    {
+        z_stream & zs = m_state->zStream;
+        const unsigned char * in = static_cast<const unsigned char *>(buf);
+        size_t left = count;
+
+        // avail_in is 32-bit, feed big buffers in pieces:
+        do
+        {
+            uInt piece = left > 0x40000000 ? 0x40000000 : static_cast<uInt>(left);
+            zs.next_in = const_cast<Bytef *>(in);
+            zs.avail_in = piece;
+            in += piece;
+            left -= piece;
+            int flush = (finish && left == 0) ? Z_FINISH : Z_NO_FLUSH;
+
+            int ret;
+            do
+            {
+                zs.next_out = outBuffer;
+                zs.avail_out = static_cast<uInt>(outBufferSize);
+                ret = deflate(&zs, flush);
+                if (ret == Z_STREAM_ERROR)
+                    return false;
+                size_t produced = outBufferSize - zs.avail_out;
+                if (produced && !dst->writeFullStream(outBuffer, produced))
+                    return false;
+            } while (zs.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+        } while (left > 0);
+        return true;
+    }
+    case ALGORITHM_ZSTD:
+    {
+#ifdef HAVE_ZSTD
+        ZSTD_inBuffer in = {buf, count, 0};
+        for (;;)
+        {
+            ZSTD_outBuffer out = {outBuffer, outBufferSize, 0};
+            size_t remaining = ZSTD_compressStream2(m_state->zstdStream, &out, &in, finish ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(remaining))
+                return false;
+            if (out.pos && !dst->writeFullStream(outBuffer, out.pos))
+                return false;
+            if (finish ? remaining == 0 : (in.pos == in.size && out.pos < out.size))
+                return true;
+        }
+#else
+        return false;
+#endif
+    }
+    case ALGORITHM_NONE:
+        break;
+    }
+
+    // No compression:
+    return count == 0 || dst->writeFullStream(buf, count);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Mantids30/Memory/streamabletransformer.h"
+#include <Mantids30/Memory/streamableobject.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Mantids30 { namespace Memory { namespace Streams { namespace Encoders {
+
+/**
+ * @brief The Compression class compresses the stream (HTTP Content-Encoding: gzip, deflate, and zstd when built with
+ *        libzstd).
+ *
+ * The output is produced in blocks of 16KB, so it can be chained directly to the chunked/connection-close transmission.
+ */
+class Compression : public Memory::Streams::StreamableTransformer
+{
+public:
+    enum eAlgorithm {
+        ALGORITHM_NONE,
+        ALGORITHM_DEFLATE,
+        ALGORITHM_GZIP,
+        ALGORITHM_ZSTD
+    };
+
+    /**
+     * @brief Compression
+     * @param algorithm compression algorithm.
+     * @param level compression level (-1: algorithm default).
+     */
+    Compression(const eAlgorithm & algorithm, const int & level = -1);
+    ~Compression() override;
+
+    /**
+     * @brief encode Compress the whole input stream into the output (including the compressed stream end).
+     * @return true if the stream was compressed and written.
+     */
+    bool encode(Memory::Streams::StreamableObject * in, Memory::Streams::StreamableObject * out);
+
+    /**
+     * @brief isAvailable Get if the algorithm is supported by this build.
+     */
+    static bool isAvailable(const eAlgorithm & algorithm);
+    /**
+     * @brief getEncodingName Get the Content-Encoding token for the algorithm (eg. gzip)
+     */
+    static std::string getEncodingName(const eAlgorithm & algorithm);
+    /**
+     * @brief getMaxLevel Get the highest compression level (for content compressed only once).
+     */
+    static int getMaxLevel(const eAlgorithm & algorithm);
+    /**
+     * @brief negotiate Select the algorithm from the client Accept-Encoding header.
+     * @param acceptEncoding Accept-Encoding header value (eg. "gzip, deflate;q=0.5, *;q=0")
+     * @param preferences server algorithms in preference order (used on equal q-values).
+     * @return the accepted algorithm with the highest q-value, or ALGORITHM_NONE.
+     */
+    static eAlgorithm negotiate(const std::string & acceptEncoding, const std::vector<eAlgorithm> & preferences = {ALGORITHM_ZSTD, ALGORITHM_GZIP, ALGORITHM_DEFLATE});
+
+protected:
+    size_t writeTo(Memory::Streams::StreamableObject *dst, const void *buf, const size_t &count) override;
+    size_t writeTransformerEOF(Memory::Streams::StreamableObject *dst) override;
+
+private:
+    bool compress(Memory::Streams::StreamableObject *dst, const void *buf, const size_t &count, bool finish);
+
+    // Compressor state (zlib/zstd stream and output buffer, kept out of this header):
+    struct State;
+    std::unique_ptr<State> m_state;
+
+    eAlgorithm m_algorithm;
+    bool m_finished = false;
+};
+
+}}}}
@@ -0,0 +1,118 @@
+#include "mime_boundarymatcher.h"
+
+#include <string.h>
+
+using namespace Mantids30::Network::Protocols::MIME;
+
+MIME_BoundaryMatcher::MIME_BoundaryMatcher(const std::string &delimiter)
+{
+    m_delimiter = delimiter;
+    size_t n = m_delimiter.size();
+
+    // Horspool bad character table (the last char is not included):
+    for (size_t c = 0; c < 256; c++)
+        m_skip[c] = n;
+    for (size_t i = 0; i + 1 < n; i++)
+        m_skip[static_cast<unsigned char>(m_delimiter[i])] = n - 1 - i;
+
+    // KMP failure function:
+    m_failure.assign(n, 0);
+    for (size_t i = 1, k = 0; i < n; i++)
+    {
+        while (k > 0 && m_delimiter[i] != m_delimiter[k])
+            k = m_failure[k - 1];
+        if (m_delimiter[i] == m_delimiter[k])
+            k++;
+        m_failure[i] = k;
+    }
+}
+
+const std::string &MIME_BoundaryMatcher::getDelimiter() const
+{
+    return m_delimiter;
+}
+
+MIME_BoundaryMatcher::Result MIME_BoundaryMatcher::scan(size_t &state, const char *data, size_t len) const
+{
+    Result r;
+    const size_t n = m_delimiter.size();
+    const size_t heldState = state;
+    size_t i = 0;
+
+    if (n == 0)
+        return r;
+
+    // Continue the partial delimiter from the previous piece:
+    while (state > 0 && i < len)
+    {
+        while (state > 0 && data[i] != m_delimiter[state])
+            state = m_failure[state - 1];
+        if (data[i] == m_delimiter[state])
+            state++;
+        i++;
+
+        if (state == n)
+        {
+            size_t released = heldState + i - n;
+            r.heldReleased = released < heldState ? released : heldState;
+            r.dataReleased = released - r.heldReleased;
+            r.consumed = i;
+            r.found = true;
+            state = 0;
+            return r;
+        }
+    }
+
+    if (state > 0)
+    {
+        // Still a partial delimiter (the whole piece was taken by it).
+        size_t released = heldState + i - state;
+        r.heldReleased = released < heldState ? released : heldState;
+        r.dataReleased = released - r.heldReleased;
+        r.consumed = len;
+        return r;
+    }
+
+    // Every held byte was content, search the rest of the piece:
+    r.heldReleased = heldState;
+
+    size_t pos = search(data, i, len);
+    if (pos != len)
+    {
+        r.dataReleased = pos;
+        r.consumed = pos + n;
+        r.found = true;
+        return r;
+    }
+
+    // Not found, keep the longest piece suffix that is a delimiter prefix:
+    size_t maxHeld = len - i < n - 1 ? len - i : n - 1;
+    for (size_t k = maxHeld; k > 0; k--)
+    {
+        if (data[len - k] == m_delimiter[0] && !memcmp(data + len - k, m_delimiter.data(), k))
+        {
+            state = k;
+            break;
+        }
+    }
+
+    r.dataReleased = len - state;
+    r.consumed = len;
+    return r;
+}
+
+size_t MIME_BoundaryMatcher::search(const char *data, size_t from, size_t len) const
+{
+    const size_t n = m_delimiter.size();
+    const size_t last = n - 1;
+    const char lastChar = m_delimiter[last];
+
+    for (size_t pos = from; pos + n <= len;)
+    {
+        char c = data[pos + last];
+        if (c == lastChar && !memcmp(data + pos, m_delimiter.data(), last))
+            return pos;
+        pos += m_skip[static_cast<unsigned char>(c)];
+    }
+    return len;
+}
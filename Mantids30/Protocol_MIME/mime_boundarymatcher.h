@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace Mantids30 { namespace Network { namespace Protocols { namespace MIME {
+
+/**
+ * @brief The MIME_BoundaryMatcher class finds a part delimiter ("\r\n--boundary") in a stream received in pieces.
+ *
+ * The tables are computed once per boundary (the matcher is immutable and can be shared by every part of the
+ * message). Each stream keeps its own state: the length of the delimiter prefix found at the end of the previous
+ * piece. Those bytes are not kept anywhere: if they turn out to be content, they are the delimiter prefix itself.
+ *
+ * Whole pieces are scanned with Boyer-Moore-Horspool, and delimiters split between pieces are resolved with the KMP
+ * failure function.
+ */
+class MIME_BoundaryMatcher
+{
+public:
+    struct Result
+    {
+        /**
+         * @brief heldReleased bytes of the previous partial delimiter that are content (take them from getDelimiter()).
+         */
+        size_t heldReleased = 0;
+        /**
+         * @brief dataReleased bytes from the beginning of the piece that are content (after the held ones).
+         */
+        size_t dataReleased = 0;
+        /**
+         * @brief consumed bytes of the piece taken by this stream (content, possible delimiter and the delimiter).
+         */
+        size_t consumed = 0;
+        /**
+         * @brief found the delimiter ends at consumed.
+         */
+        bool found = false;
+    };
+
+    MIME_BoundaryMatcher(const std::string & delimiter);
+
+    const std::string & getDelimiter() const;
+
+    /**
+     * @brief scan Scan the next piece of the stream.
+     * @param state stream state (0 at the stream start, and after a delimiter is found).
+     * @param data piece data.
+     * @param len piece size.
+     * @return released content and consumed bytes.
+     */
+    Result scan(size_t & state, const char * data, size_t len) const;
+
+private:
+    size_t search(const char * data, size_t from, size_t len) const;
+
+    std::string m_delimiter;
+    size_t m_skip[256];
+    std::vector<size_t> m_failure;
+};
+
+}}}}
@@ -142,7 +142,10 @@ void MIME_Message::renewCurrentPart()
     initSubParser(m_currentPart->getContent());
     initSubParser(m_currentPart->getHeader());
 
-    m_currentPart->getContent()->setBoundary( m_multiPartBoundary );
+    if (m_boundaryMatcher)
+        m_currentPart->getContent()->setBoundaryMatcher( m_boundaryMatcher, m_multiPartBoundary );
+    else
+        m_currentPart->getContent()->setBoundary( m_multiPartBoundary );
     m_currentPart->getContent()->setMaxContentSize(m_maxVarContentSize);
 
     // Header:
@@ -386,11 +389,13 @@ std::string MIME_Message::getMultiPartBoundary() const
 void MIME_Message::setMultiPartBoundary(const std::string &value)
 {
     m_multiPartBoundary = value;
+    // Computed once, shared by every part:
+    m_boundaryMatcher = std::make_shared<MIME_BoundaryMatcher>("\r\n--" + m_multiPartBoundary);
 
     m_subFirstBoundary.setBoundary(m_multiPartBoundary);
 
     if (m_currentPart)
-        m_currentPart->getContent()->setBoundary(m_multiPartBoundary);
+        m_currentPart->getContent()->setBoundaryMatcher(m_boundaryMatcher, m_multiPartBoundary);
 }
 
 bool MIME_Message::initProtocol()
@@ -131,6 +131,11 @@ public:
     void setCallbackOnContentReady(const sMIMECallback &newCallbackOnContentReady);
     /**
      * @brief setCallbackOnHeaderReady Set callback when header is ready (this is useful to redirect special content)
+     *
+     * To receive big parts (eg. file uploads) with constant memory, set a sink on the part content from this callback
+     * (partMessage->getContent()->setContentSink(...)), eg. a StreamableFile opened with openTemporary() that is
+     * linked into place (linkTo()) from the content ready callback. The body is written to the sink as it arrives.
+     *
      * @param newCallbackOnHeaderReady object with proper callback
      */
     void setCallbackOnHeaderReady(const sMIMECallback &newCallbackOnHeaderReady);
@@ -260,6 +265,7 @@ private:
     std::multimap<std::string,std::shared_ptr<MIME_PartMessage>> m_partsByName;
 
     std::shared_ptr<MIME_PartMessage> m_currentPart = nullptr;
+    std::shared_ptr<const MIME_BoundaryMatcher> m_boundaryMatcher;
     MIME_Sub_FirstBoundary m_subFirstBoundary;
     MIME_Sub_EndPBoundary m_subEndPBoundary;
 
@@ -21,7 +21,7 @@ MIME_Sub_Content::MIME_Sub_Content()
 
     m_contentContainer = nullptr;
     replaceContentContainer(std::make_shared<Memory::Containers::B_Chunks>());
-    setParseMode(Memory::Streams::SubParser::PARSE_MODE_DIRECT_DELIMITER);
+    setParseMode(Memory::Streams::SubParser::PARSE_MODE_STREAM);
     setBoundary("XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX");
 
     m_subParserName = "MIME_Sub_Content";
@@ -47,7 +47,6 @@ size_t MIME_Sub_Content::getMaxContentSize() const
 void MIME_Sub_Content::setMaxContentSize(const size_t &value)
 {
     m_maxContentSize = value;
-    setParseDataTargetSize(m_maxContentSize+m_boundary.size()+4);
 }
 
 size_t MIME_Sub_Content::getMaxContentSizeUntilGoingToFS() const
@@ -72,20 +71,56 @@ void MIME_Sub_Content::setFsTmpFolder(const std::string &value)
 
 Memory::Streams::SubParser::ParseStatus MIME_Sub_Content::parse()
 {
+    // Buffered modes (if the parse mode was changed from stream mode): the buffered data goes through parseStream.
+    std::optional<std::string> data = getParsedBuffer()->toString();
+    if (data == std::nullopt)
+        return Memory::Streams::SubParser::PARSE_ERROR;
+
+    setParseStatus(Memory::Streams::SubParser::PARSE_GET_MORE_DATA);
+    for (size_t offset = 0; offset < data->size() && getParseStatus() == Memory::Streams::SubParser::PARSE_GET_MORE_DATA;)
+    {
+        std::optional<size_t> consumed = parseStream(data->data() + offset, data->size() - offset);
+        if (consumed == std::nullopt)
+            return Memory::Streams::SubParser::PARSE_ERROR;
+        if (!consumed.value())
+            break;
+        offset += consumed.value();
+    }
+    return getParseStatus();
+}
+
+std::optional<size_t> MIME_Sub_Content::parseStream(const void *buf, size_t count)
+{
+    // Stream ended before the boundary... wait for more data (the parser will end here).
+    if (!count)
+        return 0;
+
     // TODO: interpret content encoding...
-    getParsedBuffer()->appendTo(*m_contentContainer);
-    if (getFoundDelimiter().size())
+    MIME_BoundaryMatcher::Result r = m_boundaryMatcher->scan(m_matchState, static_cast<const char *>(buf), count);
+
+    // Content, written straight from the incoming buffer:
+    if (r.heldReleased && !writeContent(m_boundaryMatcher->getDelimiter().data(), r.heldReleased))
+        return std::nullopt;
+    if (r.dataReleased && !writeContent(buf, r.dataReleased))
+        return std::nullopt;
+
+    if (r.found)
     {
         // finished (delimiter found).
 #ifdef DEBUG
-        printf("%p MIME_Sub_Content: Delimiter %s received.\n", this, boundary.c_str());fflush(stdout);
+        printf("%p MIME_Sub_Content: Delimiter %s received.\n", this, m_boundary.c_str());fflush(stdout);
 #endif
-        return Memory::Streams::SubParser::PARSE_GOTO_NEXT_SUBPARSER;
+        setParseStatus(Memory::Streams::SubParser::PARSE_GOTO_NEXT_SUBPARSER);
     }
-#ifdef DEBUG
-    printf("%p MIME_Sub_Content: requesting more data.\n", this);fflush(stdout);
-#endif
-    return Memory::Streams::SubParser::PARSE_GET_MORE_DATA;
+    return r.consumed;
+}
+
+bool MIME_Sub_Content::writeContent(const void *buf, const size_t &count)
+{
+    if (count > m_maxContentSize || m_contentSize > m_maxContentSize - count)
+        return false;
+    m_contentSize += count;
+    return m_contentContainer->writeFullStream(buf, count);
 }
 
 std::string MIME_Sub_Content::getBoundary() const
@@ -95,9 +130,14 @@ std::string MIME_Sub_Content::getBoundary() const
 
 void MIME_Sub_Content::setBoundary(const std::string &value)
 {
-    m_boundary = value;
-    setParseDelimiter("\r\n--" + m_boundary);
-    setParseDataTargetSize(m_maxContentSize+m_boundary.size()+4);
+    setBoundaryMatcher(std::make_shared<MIME_BoundaryMatcher>("\r\n--" + value), value);
+}
+
+void MIME_Sub_Content::setBoundaryMatcher(std::shared_ptr<const MIME_BoundaryMatcher> matcher, const std::string &boundary)
+{
+    m_boundary = boundary;
+    m_boundaryMatcher = matcher;
+    m_matchState = 0;
 }
 
 std::shared_ptr<Memory::Streams::StreamableObject> MIME_Sub_Content::getContentContainer() const
@@ -111,3 +151,14 @@ void MIME_Sub_Content::replaceContentContainer(std::shared_ptr<Memory::Streams::
 //  delete contentContainer;
     m_contentContainer = value;
 }
+
+void MIME_Sub_Content::setContentSink(std::shared_ptr<Memory::Streams::StreamableObject> sink, const size_t &maxContentSize)
+{
+    replaceContentContainer(sink);
+    setMaxContentSize(maxContentSize);
+}
+
+size_t MIME_Sub_Content::getContentSize() const
+{
+    return m_contentSize;
+}
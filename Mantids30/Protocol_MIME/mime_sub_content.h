@@ -2,6 +2,8 @@
 
 //#include <Mantids30/Memory/streamableobject.h>
 #include <Mantids30/Memory/subparser.h>
+#include "mime_boundarymatcher.h"
+#include <memory>
 
 namespace Mantids30 { namespace Network { namespace Protocols { namespace MIME {
 
@@ -22,9 +24,24 @@ public:
 
     std::shared_ptr<Memory::Streams::StreamableObject> getContentContainer() const;
     void replaceContentContainer(std::shared_ptr<Memory::Streams::StreamableObject> value);
+    /**
+     * @brief setContentSink Stream the part body being received to this object (eg. a temporary file, a hasher or a
+     *                       database blob) instead of keeping it in memory. Use it from the header ready callback.
+     * @param sink object receiving the body as it arrives (it also becomes the content container).
+     * @param maxContentSize max body size accepted for this part.
+     */
+    void setContentSink(std::shared_ptr<Memory::Streams::StreamableObject> sink, const size_t & maxContentSize);
+    /**
+     * @brief getContentSize Get the body bytes received.
+     */
+    size_t getContentSize() const;
 
     std::string getBoundary() const;
     void setBoundary(const std::string &value);
+    /**
+     * @brief setBoundaryMatcher Set the boundary using a matcher already computed (shared between the parts).
+     */
+    void setBoundaryMatcher(std::shared_ptr<const MIME_BoundaryMatcher> matcher, const std::string & boundary);
 
     // TODO: implement using filesystem.
     size_t getMaxContentSizeUntilGoingToFS() const;
@@ -32,12 +49,18 @@ public:
 
 protected:
     Memory::Streams::SubParser::ParseStatus parse() override;
+    std::optional<size_t> parseStream(const void * buf, size_t count) override;
 private:
+    bool writeContent(const void * buf, const size_t & count);
+
     std::shared_ptr<Memory::Streams::StreamableObject>  m_contentContainer;
+    std::shared_ptr<const MIME_BoundaryMatcher> m_boundaryMatcher;
+    size_t m_matchState = 0;
+    size_t m_contentSize = 0;
 
     std::string m_fsTmpFolder, m_boundary;
-    size_t m_maxContentSize;
-    size_t m_maxContentSizeUntilGoingToFS;
+    size_t m_maxContentSize = 32 * 1024;
+    size_t m_maxContentSizeUntilGoingToFS = 0;
 };
 
 }}}}
@@ -185,3 +185,28 @@ void AtomicExpression::setStaticTexts(std::shared_ptr<std::vector<std::string>>
 {
     m_staticTexts = value;
 }
+
+AtomicExpression::eEvalOperator AtomicExpression::getOperator() const
+{
+    return m_evalOperator;
+}
+
+bool AtomicExpression::isNegative() const
+{
+    return m_negativeExpression;
+}
+
+bool AtomicExpression::isIgnoreCase() const
+{
+    return m_ignoreCase;
+}
+
+const AtomicExpressionSide &AtomicExpression::getLeft() const
+{
+    return m_left;
+}
+
+const AtomicExpressionSide &AtomicExpression::getRight() const
+{
+    return m_right;
+}
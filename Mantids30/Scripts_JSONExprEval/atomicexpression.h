@@ -32,6 +32,12 @@ public:
 
     void setStaticTexts(std::shared_ptr<std::vector<std::string>> value);
 
+    eEvalOperator getOperator() const;
+    bool isNegative() const;
+    bool isIgnoreCase() const;
+    const AtomicExpressionSide & getLeft() const;
+    const AtomicExpressionSide & getRight() const;
+
 private:
     bool calcNegative(bool r);
     bool substractExpressions(const std::string &regex, const eEvalOperator & op);
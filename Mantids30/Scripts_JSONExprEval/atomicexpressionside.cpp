@@ -101,6 +101,19 @@ Mantids30::Scripts::Expressions::AtomicExpressionSide::eExpressionSideMode Atomi
     return m_mode;
 }
 
+string AtomicExpressionSide::getConstant() const
+{
+    switch (m_mode)
+    {
+    case EXPR_MODE_STATIC_STRING:
+        return (*m_staticTexts)[m_staticIndex];
+    case EXPR_MODE_NUMERIC:
+        return m_expr;
+    default:
+        return "";
+    }
+}
+
 set<string> AtomicExpressionSide::recompileRegex(const string &r, bool ignoreCase)
 {
     if (!m_regexp)
@@ -36,6 +36,10 @@ public:
     void setRegexp(std::shared_ptr<boost::regex> value);
 
     eExpressionSideMode getMode() const;
+    /**
+     * @brief getConstant Get the static string or number text (static/numeric modes).
+     */
+    std::string getConstant() const;
 
 private:
     std::set<std::string> recompileRegex(const std::string & r, bool ignoreCase);
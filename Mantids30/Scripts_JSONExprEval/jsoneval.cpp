@@ -21,10 +21,26 @@ JSONEval::JSONEval(const string &expr, std::shared_ptr<std::vector<std::string>>
 {
     this->m_negativeExpression = negativeExpression;
     this->m_staticTexts = staticTexts;
-    m_isCompiled = compile(expr);
+    // Sub expressions are lowered within the top expression bytecode.
+    m_isCompiled = parse(expr);
 }
 
 bool JSONEval::compile(std::string expr)
+{
+    bool r = parse(expr);
+
+    // Lowered even if it failed, so it gives the same result as the expression tree.
+    m_bytecode = std::make_shared<JSONEvalBytecode>();
+    if (!m_bytecode->build(*this) && r)
+    {
+        m_lastError = "Invalid Regular Expression";
+        r = false;
+    }
+
+    return r;
+}
+
+bool JSONEval::parse(std::string expr)
 {
     if (!m_staticTexts)
     {
@@ -153,6 +169,21 @@ bool JSONEval::compile(std::string expr)
 }
 
 bool JSONEval::evaluate(const json &values)
+{
+    if (m_bytecode)
+        return m_bytecode->evaluate(values);
+    return evaluateTree(values);
+}
+
+std::vector<bool> JSONEval::evaluate(const std::vector<json> &values)
+{
+    std::vector<bool> r(values.size(), false);
+    for (size_t i = 0; i < values.size(); i++)
+        r[i] = evaluate(values[i]);
+    return r;
+}
+
+bool JSONEval::evaluateTree(const json &values)
 {
     switch (m_evaluationMode)
     {
@@ -167,7 +198,7 @@ bool JSONEval::evaluate(const json &values)
             }
             else
             {
-                if ( !m_subExpressions[i.second]->evaluate(values) )
+                if ( !m_subExpressions[i.second]->evaluateTree(values) )
                     return calcNegative(false); // Short circuit.
             }
         }
@@ -184,7 +215,7 @@ bool JSONEval::evaluate(const json &values)
             }
             else
             {
-                if ( m_subExpressions[i.second]->evaluate(values) )
+                if ( m_subExpressions[i.second]->evaluateTree(values) )
                     return calcNegative(true); // Short circuit.
             }
         }
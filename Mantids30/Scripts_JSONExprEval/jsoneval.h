@@ -1,6 +1,7 @@
 #pragma once
 
 #include "atomicexpression.h"
+#include "jsonevalbytecode.h"
 #include <Mantids30/Helpers/json.h>
 #include <memory>
 
@@ -21,15 +22,34 @@ public:
     JSONEval(const std::string & expr, std::shared_ptr<std::vector<std::string>> staticTexts, bool negativeExpression);
 
 
+    /**
+     * @brief compile Parse the expression and lower it into bytecode.
+     * @param expr expression string
+     * @return true if the expression was compiled.
+     */
     bool compile( std::string expr );
+    /**
+     * @brief evaluate Evaluate the expression over the values (using the bytecode when compiled with compile()).
+     */
     bool evaluate( const json & values );
+    /**
+     * @brief evaluate Evaluate the expression over every value in the batch.
+     * @return one result per value (in the same order).
+     */
+    std::vector<bool> evaluate( const std::vector<json> & values );
+    /**
+     * @brief evaluateTree Evaluate the expression walking the expression tree (without the bytecode).
+     */
+    bool evaluateTree( const json & values );
 
     std::string getLastCompilerError() const;
 
     bool isCompiled() const;
 
 private:
+    friend class JSONEvalBytecode;
 
+    bool parse( std::string expr );
     bool calcNegative(bool r);
 
     /**
@@ -43,6 +63,7 @@ private:
     std::shared_ptr<std::vector<std::string>> m_staticTexts = nullptr;
     std::vector<std::shared_ptr<JSONEval>> m_subExpressions;
     std::vector<std::pair<std::shared_ptr<AtomicExpression>,size_t>> m_atomExpressions;
+    std::shared_ptr<JSONEvalBytecode> m_bytecode;
 
     bool m_negativeExpression = false;
     bool m_isCompiled = false;
@@ -0,0 +1,408 @@
+#include "jsonevalbytecode.h"
+#include "jsoneval.h"
+
+#include <charconv>
+#include <string.h>
+
+using namespace std;
+using namespace Mantids30::Scripts::Expressions;
+
+namespace {
+
+inline char asciiLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+inline bool equalChars(const char *a, const char *b, size_t len, bool ignoreCase)
+{
+    if (!ignoreCase)
+        return !memcmp(a, b, len);
+    for (size_t i = 0; i < len; i++)
+    {
+        if (asciiLower(a[i]) != asciiLower(b[i]))
+            return false;
+    }
+    return true;
+}
+
+}
+
+bool JSONEvalBytecode::build(const JSONEval &expression)
+{
+    m_code.clear();
+    m_tests.clear();
+    m_constants.clear();
+    m_constantIndex.clear();
+    m_pathSteps.clear();
+    m_paths.clear();
+    m_pathIndex.clear();
+    m_regexes.clear();
+
+    return lower(expression);
+}
+
+bool JSONEvalBytecode::evaluate(const json &values) const
+{
+    bool r = false;
+    const size_t count = m_code.size();
+
+    for (size_t pc = 0; pc < count;)
+    {
+        const Instruction & i = m_code[pc++];
+        switch (i.op)
+        {
+        case OP_TEST:
+            r = runTest(m_tests[i.operand], values);
+            break;
+        case OP_LOAD:
+            r = i.operand != 0;
+            break;
+        case OP_NOT:
+            r = !r;
+            break;
+        case OP_JUMP_IF_TRUE:
+            if (r)
+                pc = i.operand;
+            break;
+        case OP_JUMP_IF_FALSE:
+            if (!r)
+                pc = i.operand;
+            break;
+        }
+    }
+    return r;
+}
+
+size_t JSONEvalBytecode::getInstructionCount() const
+{
+    return m_code.size();
+}
+
+bool JSONEvalBytecode::lower(const JSONEval &expression)
+{
+    if (expression.m_evaluationMode != JSONEval::EVAL_MODE_AND && expression.m_evaluationMode != JSONEval::EVAL_MODE_OR)
+    {
+        // Undefined expressions are false (even when negated).
+        appendInstruction(OP_LOAD, 0);
+        return true;
+    }
+
+    bool r = true;
+    bool andMode = expression.m_evaluationMode == JSONEval::EVAL_MODE_AND;
+
+    if (expression.m_atomExpressions.empty())
+    {
+        appendInstruction(OP_LOAD, andMode ? 1 : 0);
+    }
+    else
+    {
+        // Every short circuit jumps to the end of this group (with the current result).
+        std::vector<size_t> shortCircuits;
+        for (size_t i = 0; i < expression.m_atomExpressions.size(); i++)
+        {
+            const auto & atom = expression.m_atomExpressions[i];
+            // Keeps lowering after a failure, so the jumps stay consistent:
+            if (!(atom.first ? appendTest(*atom.first) : lower(*expression.m_subExpressions[atom.second])))
+                r = false;
+
+            if (i + 1 < expression.m_atomExpressions.size())
+                shortCircuits.push_back(appendInstruction(andMode ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE));
+        }
+        for (size_t jump : shortCircuits)
+            m_code[jump].operand = static_cast<uint32_t>(m_code.size());
+    }
+
+    if (expression.m_negativeExpression)
+        appendInstruction(OP_NOT);
+    return r;
+}
+
+bool JSONEvalBytecode::appendTest(const AtomicExpression &atom)
+{
+    bool r = true;
+    Test test;
+    test.op = atom.getOperator();
+    test.negative = atom.isNegative();
+    test.ignoreCase = atom.isIgnoreCase();
+    test.left = appendOperand(atom.getLeft());
+
+    if (test.op == AtomicExpression::EVAL_OPERATOR_REGEXMATCH)
+    {
+        // Only JSON values are matched, and only against a constant regex:
+        if (test.left.kind != OPERAND_JSONPATH)
+            test.left.kind = OPERAND_NONE;
+
+        const AtomicExpressionSide & right = atom.getRight();
+        if (right.getMode() == AtomicExpressionSide::EXPR_MODE_STATIC_STRING || right.getMode() == AtomicExpressionSide::EXPR_MODE_NUMERIC)
+        {
+            try
+            {
+                m_regexes.emplace_back(right.getConstant().c_str(),
+                                       test.ignoreCase ? (boost::regex::extended | boost::regex::icase) : (boost::regex::extended));
+                test.regex = static_cast<int32_t>(m_regexes.size() - 1);
+            }
+            catch (const boost::regex_error &)
+            {
+                // Invalid regex (the test never matches).
+                r = false;
+            }
+        }
+    }
+    else if (test.op != AtomicExpression::EVAL_OPERATOR_ISNULL)
+    {
+        test.right = appendOperand(atom.getRight());
+    }
+
+    appendInstruction(OP_TEST, static_cast<uint32_t>(m_tests.size()));
+    m_tests.push_back(test);
+    return r;
+}
+
+size_t JSONEvalBytecode::appendInstruction(const eOpcode &op, const uint32_t &operand)
+{
+    m_code.push_back({op, operand});
+    return m_code.size() - 1;
+}
+
+JSONEvalBytecode::Operand JSONEvalBytecode::appendOperand(const AtomicExpressionSide &side)
+{
+    Operand operand;
+    switch (side.getMode())
+    {
+    case AtomicExpressionSide::EXPR_MODE_JSONPATH:
+        operand.kind = OPERAND_JSONPATH;
+        operand.index = internPath(side.getExpr().substr(1));
+        break;
+    case AtomicExpressionSide::EXPR_MODE_STATIC_STRING:
+    case AtomicExpressionSide::EXPR_MODE_NUMERIC:
+        operand.kind = OPERAND_CONSTANT;
+        operand.index = internConstant(side.getConstant());
+        break;
+    case AtomicExpressionSide::EXPR_MODE_NULL:
+    case AtomicExpressionSide::EXPR_MODE_UNDEFINED:
+        break;
+    }
+    return operand;
+}
+
+uint32_t JSONEvalBytecode::internConstant(const std::string &value)
+{
+    auto it = m_constantIndex.find(value);
+    if (it != m_constantIndex.end())
+        return it->second;
+
+    uint32_t index = static_cast<uint32_t>(m_constants.size());
+    m_constants.push_back(value);
+    m_constantIndex[value] = index;
+    return index;
+}
+
+uint32_t JSONEvalBytecode::internPath(const std::string &path)
+{
+    auto it = m_pathIndex.find(path);
+    if (it != m_pathIndex.end())
+        return it->second;
+
+    // Split the path the same way Json::Path does (.key, [index]):
+    Path p;
+    p.firstStep = m_pathSteps.size();
+
+    const char * current = path.c_str();
+    const char * end = current + path.size();
+    while (current != end)
+    {
+        if (*current == '[')
+        {
+            ++current;
+            if (*current != '%')
+            {
+                PathStep step;
+                step.isIndex = true;
+                for (; current != end && *current >= '0' && *current <= '9'; ++current)
+                    step.index = step.index * 10 + static_cast<Json::ArrayIndex>(*current - '0');
+                m_pathSteps.push_back(step);
+            }
+            if (current != end)
+                ++current;
+        }
+        else if (*current == '%' || *current == '.' || *current == ']')
+        {
+            // (path arguments are not used by the expressions)
+            ++current;
+        }
+        else
+        {
+            const char * beginName = current;
+            while (current != end && !strchr("[.", *current))
+                ++current;
+            PathStep step;
+            step.key = std::string(beginName, current);
+            m_pathSteps.push_back(step);
+        }
+    }
+    p.stepCount = m_pathSteps.size() - p.firstStep;
+
+    uint32_t index = static_cast<uint32_t>(m_paths.size());
+    m_paths.push_back(p);
+    m_pathIndex[path] = index;
+    return index;
+}
+
+bool JSONEvalBytecode::runTest(const Test &test, const json &values) const
+{
+    bool r = false;
+
+    switch (test.op)
+    {
+    case AtomicExpression::EVAL_OPERATOR_ISNULL:
+        r = !anyValue(test.left, values, [](const std::string_view &) { return true; });
+        break;
+    case AtomicExpression::EVAL_OPERATOR_REGEXMATCH:
+        if (test.regex >= 0)
+        {
+            const boost::regex & regex = m_regexes[test.regex];
+            r = anyValue(test.left, values, [&regex](const std::string_view & lvalue) {
+                return boost::regex_match(lvalue.data(), lvalue.data() + lvalue.size(), regex);
+            });
+        }
+        break;
+    case AtomicExpression::EVAL_OPERATOR_CONTAINS:
+    case AtomicExpression::EVAL_OPERATOR_ISEQUAL:
+    case AtomicExpression::EVAL_OPERATOR_STARTSWITH:
+    case AtomicExpression::EVAL_OPERATOR_ENDSWITH:
+        r = anyValue(test.left, values, [&](const std::string_view & lvalue) {
+            return anyValue(test.right, values, [&](const std::string_view & rvalue) {
+                return compare(test.op, test.ignoreCase, lvalue, rvalue);
+            });
+        });
+        break;
+    case AtomicExpression::EVAL_OPERATOR_UNDEFINED:
+        break;
+    }
+
+    return test.negative ? !r : r;
+}
+
+const json *JSONEvalBytecode::resolvePath(const uint32_t &pathIndex, const json &values) const
+{
+    const Path & path = m_paths[pathIndex];
+    const json * node = &values;
+
+    for (size_t i = path.firstStep; i < path.firstStep + path.stepCount; i++)
+    {
+        const PathStep & step = m_pathSteps[i];
+        if (step.isIndex)
+        {
+            if (!node->isArray() || !node->isValidIndex(step.index))
+                return nullptr;
+            node = &((*node)[step.index]);
+        }
+        else
+        {
+            if (!node->isObject())
+                return nullptr;
+            node = node->find(step.key.data(), step.key.data() + step.key.size());
+            if (!node)
+                return nullptr;
+        }
+    }
+    return node;
+}
+
+template<typename F>
+bool JSONEvalBytecode::anyValue(const Operand &operand, const json &values, F &&f) const
+{
+    switch (operand.kind)
+    {
+    case OPERAND_CONSTANT:
+        return f(std::string_view(m_constants[operand.index]));
+    case OPERAND_JSONPATH:
+    {
+        const json * node = resolvePath(operand.index, values);
+        if (!node || node->isNull())
+            return false;
+        if (node->isArray())
+        {
+            // Arrays match if any of their items match:
+            for (const json & item : *node)
+            {
+                if (scalarValue(item, f))
+                    return true;
+            }
+            return false;
+        }
+        return scalarValue(*node, f);
+    }
+    case OPERAND_NONE:
+        break;
+    }
+    return false;
+}
+
+template<typename F>
+bool JSONEvalBytecode::scalarValue(const json &value, F &&f)
+{
+    // Same text as json::asString():
+    char number[32];
+    switch (value.type())
+    {
+    case Json::stringValue:
+    {
+        const char *begin, *end;
+        if (!value.getString(&begin, &end))
+            return f(std::string_view());
+        return f(std::string_view(begin, end - begin));
+    }
+    case Json::intValue:
+    {
+        auto r = std::to_chars(number, number + sizeof(number), value.asLargestInt());
+        return f(std::string_view(number, r.ptr - number));
+    }
+    case Json::uintValue:
+    {
+        auto r = std::to_chars(number, number + sizeof(number), value.asLargestUInt());
+        return f(std::string_view(number, r.ptr - number));
+    }
+    case Json::booleanValue:
+        return f(std::string_view(value.asBool() ? "true" : "false"));
+    case Json::realValue:
+    {
+        std::string text = value.asString();
+        return f(std::string_view(text));
+    }
+    case Json::nullValue:
+        return f(std::string_view());
+    case Json::arrayValue:
+    case Json::objectValue:
+        // Not comparable.
+        break;
+    }
+    return false;
+}
+
+bool JSONEvalBytecode::compare(const AtomicExpression::eEvalOperator &op, bool ignoreCase, const std::string_view &left, const std::string_view &right)
+{
+    switch (op)
+    {
+    case AtomicExpression::EVAL_OPERATOR_ISEQUAL:
+        return left.size() == right.size() && equalChars(left.data(), right.data(), right.size(), ignoreCase);
+    case AtomicExpression::EVAL_OPERATOR_STARTSWITH:
+        return left.size() >= right.size() && equalChars(left.data(), right.data(), right.size(), ignoreCase);
+    case AtomicExpression::EVAL_OPERATOR_ENDSWITH:
+        return left.size() >= right.size() && equalChars(left.data() + left.size() - right.size(), right.data(), right.size(), ignoreCase);
+    case AtomicExpression::EVAL_OPERATOR_CONTAINS:
+        if (!ignoreCase)
+            return left.find(right) != std::string_view::npos;
+        if (right.size() > left.size())
+            return false;
+        for (size_t pos = 0; pos + right.size() <= left.size(); pos++)
+        {
+            if (equalChars(left.data() + pos, right.data(), right.size(), true))
+                return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <boost/regex.hpp>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Mantids30/Helpers/json.h>
+
+#include "atomicexpression.h"
+
+namespace Mantids30 { namespace Scripts { namespace Expressions {
+
+class JSONEval;
+
+/**
+ * @brief The JSONEvalBytecode class is the flat form of a compiled JSONEval expression tree.
+ *
+ * Every JSON path is split into its steps once, constants are interned, regular expressions are built once and the
+ * AND/OR groups become short-circuit jumps, so evaluating does not allocate (strings are compared in place as
+ * string_views, only real numbers are formatted into a temporary) and can be done concurrently from many threads.
+ */
+class JSONEvalBytecode
+{
+public:
+    enum eOpcode : uint8_t {
+        OP_TEST,            // result = test[operand]
+        OP_LOAD,            // result = operand
+        OP_NOT,             // result = !result
+        OP_JUMP_IF_TRUE,    // if (result) goto operand
+        OP_JUMP_IF_FALSE    // if (!result) goto operand
+    };
+
+    JSONEvalBytecode() = default;
+
+    /**
+     * @brief build Lower the expression tree into bytecode.
+     * @param expression parsed expression (with its sub expressions).
+     * @return false if a regular expression is invalid (its tests never match).
+     */
+    bool build(const JSONEval & expression);
+
+    /**
+     * @brief evaluate Run the bytecode over the values (same result as JSONEval::evaluateTree).
+     */
+    bool evaluate(const json & values) const;
+
+    /**
+     * @brief getInstructionCount Get the number of instructions.
+     */
+    size_t getInstructionCount() const;
+
+private:
+    enum eOperandKind : uint8_t {
+        OPERAND_NONE,
+        OPERAND_CONSTANT,
+        OPERAND_JSONPATH
+    };
+
+    struct Operand
+    {
+        eOperandKind kind = OPERAND_NONE;
+        // constant or path index:
+        uint32_t index = 0;
+    };
+
+    struct PathStep
+    {
+        std::string key;
+        Json::ArrayIndex index = 0;
+        bool isIndex = false;
+    };
+
+    struct Path
+    {
+        size_t firstStep = 0, stepCount = 0;
+    };
+
+    struct Test
+    {
+        AtomicExpression::eEvalOperator op = AtomicExpression::EVAL_OPERATOR_UNDEFINED;
+        Operand left, right;
+        // regex index (-1: no regex, never matches)
+        int32_t regex = -1;
+        bool negative = false, ignoreCase = false;
+    };
+
+    struct Instruction
+    {
+        eOpcode op;
+        uint32_t operand;
+    };
+
+    bool lower(const JSONEval & expression);
+    bool appendTest(const AtomicExpression & atom);
+    size_t appendInstruction(const eOpcode & op, const uint32_t & operand = 0);
+    Operand appendOperand(const AtomicExpressionSide & side);
+    uint32_t internConstant(const std::string & value);
+    uint32_t internPath(const std::string & path);
+
+    bool runTest(const Test & test, const json & values) const;
+    const json * resolvePath(const uint32_t & pathIndex, const json & values) const;
+
+    template<typename F>
+    bool anyValue(const Operand & operand, const json & values, F && f) const;
+    template<typename F>
+    static bool scalarValue(const json & value, F && f);
+    static bool compare(const AtomicExpression::eEvalOperator & op, bool ignoreCase, const std::string_view & left, const std::string_view & right);
+
+    std::vector<Instruction> m_code;
+    std::vector<Test> m_tests;
+    std::vector<std::string> m_constants;
+    std::map<std::string, uint32_t> m_constantIndex;
+    std::vector<PathStep> m_pathSteps;
+    std::vector<Path> m_paths;
+    std::map<std::string, uint32_t> m_pathIndex;
+    std::vector<boost::regex> m_regexes;
+};
+
+}}}
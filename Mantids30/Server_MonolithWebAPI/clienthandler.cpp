@@ -133,7 +133,7 @@ void ClientHandler::handleAPIRequest(API::APIReturn * apiReturn,
                                      const uint32_t & apiVersion,
                                       const std::string &methodMode,
                                      const string & methodName,
-                                     const Json::Value & pathParameters,
+                                     const string & resourcePath,
                                      const Json::Value & postParameters)
 {
     //json jPayloadIn;
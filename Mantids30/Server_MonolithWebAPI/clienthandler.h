@@ -42,12 +42,12 @@ protected:
      * @param apiVersion The version of the API being requested.
      * @param methodMode The mode of the API method, such as GET, POST, PUT, DELETE, etc.
      * @param methodName The name of the API method to execute.
-     * @param pathParameters A JSON object containing parameters parsed from the URL path.
+     * @param resourcePath The resource path after the API version, including the method name.
      * @param postParameters A JSON object containing parameters sent in the POST body.
      *
      * @return Returns an appropriate API return code indicating success or the type of error encountered.
      */
-    void handleAPIRequest(API::APIReturn *apiReturn, const std::string &baseApiUrl, const uint32_t &apiVersion, const std::string &methodMode, const std::string &methodName, const Json::Value &pathParameters, const Json::Value &postParameters) override;
+    void handleAPIRequest(API::APIReturn *apiReturn, const std::string &baseApiUrl, const uint32_t &apiVersion, const std::string &methodMode, const std::string &methodName, const std::string &resourcePath, const Json::Value &postParameters) override;
 
     /**
      * @brief handleAuthFunctions Handle API Authentication Functions (login, logout, etc) and write the response to the client...
@@ -1,6 +1,7 @@
 #include "sessionsmanager.h"
 #include <Mantids30/Helpers/random.h>
 #include <Mantids30/Program_Logs/rpclog.h>
+#include <Mantids30/Program_Metrics/registry.h>
 
 #include <memory>
 #include <stdexcept>
@@ -9,6 +10,22 @@
 using namespace Mantids30::Network::Servers::WebMonolith;
 using namespace Mantids30;
 
+namespace {
+
+Program::Metrics::Gauge & getActiveSessionsGauge()
+{
+    static Program::Metrics::Gauge & activeSessions = Program::Metrics::Registry::getDefault().gauge("mantids30_web_sessions", "Web sessions kept by the web sessions managers.");
+    return activeSessions;
+}
+
+Program::Metrics::Counter & getCreatedSessionsCounter()
+{
+    static Program::Metrics::Counter & createdSessions = Program::Metrics::Registry::getDefault().counter("mantids30_web_sessions_created_total", "Web sessions created (restored sessions not included).");
+    return createdSessions;
+}
+
+}
+
 WebSessionsManager::WebSessionsManager()
 {
     setGcWaitTime(1); // 1 sec.
@@ -19,21 +36,56 @@ WebSessionsManager::WebSessionsManager()
 
 void WebSessionsManager::gc()
 {
-    std::set<std::string> i = m_sessions.getKeys();
-    for (const std::string & key : i)
+    time_t now = time(nullptr);
+
+    // Only the sessions that reached their deadline are checked:
+    for (const std::string & key : m_expirationWheel.advance(now))
     {
         WebSession * s = (WebSession *)m_sessions.openElement(key);
-        if (s && s->getAuthSession()->isLastActivityExpired(m_MaxInactiveSeconds))
+        if (!s)
         {
+            // Already destroyed (eg. logout).
+            continue;
+        }
+
+        if (m_sessionStore && s->isStored() && s->getAuthSession()->isLastActivityExpired(m_MaxInactiveSeconds))
+        {
+            // Another process may have kept the session alive.
+            time_t storedLastActivity;
+            if (m_sessionStore->getLastActivity(key, storedLastActivity) && storedLastActivity > s->getAuthSession()->getLastActivity())
+            {
+                s->getAuthSession()->setLastActivity(storedLastActivity);
+                s->setStoredLastActivity(storedLastActivity);
+            }
+        }
+
+        if (s->getAuthSession()->isLastActivityExpired(m_MaxInactiveSeconds))
+        {
+            std::string effectiveUser = s->getAuthSession()->getUser();
             m_sessions.releaseElement( key );
-            m_sessions.destroyElement( key );
+            if (m_sessions.destroyElement( key ))
+            {
+                getActiveSessionsGauge().decrement();
+                unregisterUserSession(effectiveUser, key);
+                if (m_sessionStore)
+                    m_sessionStore->remove(key);
+            }
             // TODO: log?
         }
-        else if (s)
+        else
         {
+            // The session had activity in the meantime, schedule it for its new deadline.
+            m_expirationWheel.schedule(key, s->getAuthSession()->getLastActivity() + m_MaxInactiveSeconds + 1);
             m_sessions.releaseElement( key );
         }
     }
+
+    // Purge the stored sessions that no process is tracking anymore (eg. the process was restarted):
+    if (m_sessionStore && now >= m_nextStorePurge)
+    {
+        m_sessionStore->removeInactive(now - m_MaxInactiveSeconds);
+        m_nextStorePurge = now + (m_MaxInactiveSeconds?m_MaxInactiveSeconds:60);
+    }
 }
 
 void WebSessionsManager::threadGC(void *sessManager)
@@ -61,22 +113,13 @@ std::string WebSessionsManager::createSession(std::shared_ptr<Mantids30::Session
     {
         std::unique_lock<std::mutex> lock(m_mutex);
 
-        if (m_sessionClientInfo.find(effectiveUser) == m_sessionClientInfo.end())
-        {
-            m_sessionClientInfo[effectiveUser][sessionId] = networkClientInfo;
-        }
-        else
+        auto & userSessionIDs = m_sessionIDsByUser[effectiveUser];
+        if (!userSessionIDs.empty() && userSessionIDs.size() >= m_maxSessionsPerUser)
         {
-            if (m_sessionClientInfo[effectiveUser].size() >= m_maxSessionsPerUser)
-            {
-                // Max sessions per user reached.
-                return "";
-            }
-            else
-            {
-                m_sessionClientInfo[effectiveUser][sessionId] = networkClientInfo;
-            }
+            // Max sessions per user reached.
+            return "";
         }
+        userSessionIDs.insert(sessionId);
     }
 
     WebSession * webSession = new WebSession(session,networkClientInfo);
@@ -87,13 +130,32 @@ std::string WebSessionsManager::createSession(std::shared_ptr<Mantids30::Session
     {
         // Session ID Already exist... (far too rare condition)
         delete webSession;
+        unregisterUserSession(effectiveUser, sessionId);
         return "";
     }
 
+    getActiveSessionsGauge().increment();
+    getCreatedSessionsCounter().add();
+
+    m_expirationWheel.schedule(sessionId, session->getLastActivity() + m_MaxInactiveSeconds + 1);
+
+    // If the store does not accept the session (eg. full), it will remain local to this process.
+    if (m_sessionStore && m_sessionStore->put(Sessions::SessionStore::capture(sessionId, session, networkClientInfo)))
+    {
+        webSession->setStoredLastActivity(session->getLastActivity());
+    }
+
     return sessionId;
 }
 
 bool WebSessionsManager::destroySession(const std::string &sessionID)
+{
+    // Removed from the store first, so the other processes stop accepting it as soon as possible.
+    bool removedFromStore = m_sessionStore && m_sessionStore->remove(sessionID);
+    return destroyLocalSession(sessionID) || removedFromStore;
+}
+
+bool WebSessionsManager::destroyLocalSession(const std::string &sessionID)
 {
     std::string effectiveUser;
     WebSession * sess;
@@ -107,22 +169,9 @@ bool WebSessionsManager::destroySession(const std::string &sessionID)
 
     if (m_sessions.destroyElement(sessionID))
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        if (
-            m_sessionClientInfo.find(effectiveUser) == m_sessionClientInfo.end()
-            || m_sessionClientInfo[effectiveUser].find(sessionID) == m_sessionClientInfo[effectiveUser].end()
-            )
-        {
-            throw std::runtime_error("Unregistered Session??");
-        }
-        else
-        {
-            m_sessionClientInfo[effectiveUser].erase(sessionID);
-            if (m_sessionClientInfo[effectiveUser].empty())
-            {
-                m_sessionClientInfo.erase(effectiveUser);
-            }
-        }
+        getActiveSessionsGauge().decrement();
+        // The expiration wheel entry is left behind and discarded by the GC.
+        unregisterUserSession(effectiveUser, sessionID);
         return true;
     }
     return false;
@@ -130,8 +179,31 @@ bool WebSessionsManager::destroySession(const std::string &sessionID)
 
 WebSession *WebSessionsManager::openSession(const std::string &sessionID, uint64_t *maxAge)
 {
-    WebSession *xs;
-    if ((xs=(WebSession *)m_sessions.openElement(sessionID))!=nullptr)
+    WebSession *xs = (WebSession *)m_sessions.openElement(sessionID);
+
+    if (!xs)
+    {
+        // Unknown to this process, maybe created by another process (or before a restart).
+        xs = restoreSession(sessionID);
+    }
+    else if (m_sessionStore && xs->isStored())
+    {
+        time_t storedLastActivity;
+        if (!m_sessionStore->getLastActivity(sessionID, storedLastActivity))
+        {
+            // Removed by another process (eg. logout).
+            m_sessions.releaseElement(sessionID);
+            destroyLocalSession(sessionID);
+            return nullptr;
+        }
+        if (storedLastActivity > xs->getAuthSession()->getLastActivity())
+        {
+            xs->getAuthSession()->setLastActivity(storedLastActivity);
+            xs->setStoredLastActivity(storedLastActivity);
+        }
+    }
+
+    if (xs)
     {
         uint64_t lastActivity = xs->getAuthSession()->getLastActivity();
 
@@ -154,9 +226,67 @@ WebSession *WebSessionsManager::openSession(const std::string &sessionID, uint64
 
 bool WebSessionsManager::releaseSession(const std::string &sessionID)
 {
+    if (m_sessionStore)
+    {
+        // Propagate the activity registered during this request:
+        WebSession * s = (WebSession *)m_sessions.openElement(sessionID);
+        if (s)
+        {
+            time_t lastActivity = s->getAuthSession()->getLastActivity();
+            if (s->isStored() && lastActivity > s->getStoredLastActivity() && m_sessionStore->touch(sessionID, lastActivity))
+            {
+                s->setStoredLastActivity(lastActivity);
+            }
+            m_sessions.releaseElement(sessionID);
+        }
+    }
     return m_sessions.releaseElement(sessionID);
 }
 
+WebSession *WebSessionsManager::restoreSession(const std::string &sessionID)
+{
+    Sessions::StoredSession storedSession;
+    if (!m_sessionStore || !m_sessionStore->get(sessionID, storedSession))
+        return nullptr;
+
+    std::shared_ptr<Sessions::Session> session = Sessions::SessionStore::restore(storedSession);
+    if (!session || session->isLastActivityExpired(m_MaxInactiveSeconds))
+        return nullptr;
+
+    std::string effectiveUser = session->getUser();
+    WebSession * webSession = new WebSession(session,storedSession.clientInfo);
+    webSession->setStoredLastActivity(storedSession.lastActivity);
+
+    {
+        // Checked and inserted under the same lock, so the other threads restoring it find the element.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto & userSessionIDs = m_sessionIDsByUser[effectiveUser];
+        if (userSessionIDs.count(sessionID))
+        {
+            // Already restored by another thread.
+            delete webSession;
+            lock.unlock();
+            return (WebSession *)m_sessions.openElement(sessionID);
+        }
+
+        if ((!userSessionIDs.empty() && userSessionIDs.size() >= m_maxSessionsPerUser) || !m_sessions.addElement(sessionID,webSession))
+        {
+            // Max sessions per user reached (or the element already exists).
+            delete webSession;
+            if (userSessionIDs.empty())
+                m_sessionIDsByUser.erase(effectiveUser);
+            return nullptr;
+        }
+        userSessionIDs.insert(sessionID);
+    }
+
+    getActiveSessionsGauge().increment();
+
+    m_expirationWheel.schedule(sessionID, session->getLastActivity() + m_MaxInactiveSeconds + 1);
+
+    return (WebSession *)m_sessions.openElement(sessionID);
+}
+
 bool WebSessionsManager::validateSessionIDFormat(const std::string &sessionID)
 {
     if (sessionID.empty())
@@ -169,19 +299,60 @@ bool WebSessionsManager::validateSessionIDFormat(const std::string &sessionID)
 
 json WebSessionsManager::getUserSessionsInfo(const std::string &effectiveUserName)
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    json r;
-    auto sessionsMap = m_sessionClientInfo[effectiveUserName];
+    std::unordered_set<std::string> sessionIDs;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_sessionIDsByUser.find(effectiveUserName);
+        if (it != m_sessionIDsByUser.end())
+            sessionIDs = it->second;
+    }
 
-    for ( const auto & sessions : sessionsMap )
+    json r;
+    for ( const auto & sessionID : sessionIDs )
     {
-        // provide truncated session information.
-        r[Program::Logs::RPCLog::truncateSessionId(sessions.first)] =  sessions.second;
+        WebSession * s = (WebSession *)m_sessions.openElement(sessionID);
+        if (s)
+        {
+            // provide truncated session information.
+            r[Program::Logs::RPCLog::truncateSessionId(sessionID)] = s->toJSON();
+            m_sessions.releaseElement(sessionID);
+        }
     }
 
     return r;
 }
 
+uint32_t WebSessionsManager::getUserSessionsCount(const std::string &effectiveUserName)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_sessionIDsByUser.find(effectiveUserName);
+    return it == m_sessionIDsByUser.end() ? 0 : static_cast<uint32_t>(it->second.size());
+}
+
+void WebSessionsManager::unregisterUserSession(const std::string &effectiveUser, const std::string &sessionID)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_sessionIDsByUser.find(effectiveUser);
+    if (it == m_sessionIDsByUser.end() || it->second.erase(sessionID) == 0)
+    {
+        throw std::runtime_error("Unregistered Session??");
+    }
+    if (it->second.empty())
+    {
+        m_sessionIDsByUser.erase(it);
+    }
+}
+
+void WebSessionsManager::setSessionStore(std::shared_ptr<Sessions::SessionStore> store)
+{
+    m_sessionStore = store;
+}
+
+std::shared_ptr<Mantids30::Sessions::SessionStore> WebSessionsManager::getSessionStore()
+{
+    return m_sessionStore;
+}
+
 uint32_t WebSessionsManager::getMaxSessionsPerUser() const
 {
     return m_maxSessionsPerUser;
@@ -2,11 +2,16 @@
 
 #include <Mantids30/Helpers/json.h>
 #include <Mantids30/Sessions/session.h>
+#include <Mantids30/Sessions/sessionstore.h>
 #include <Mantids30/Threads/map.h>
 #include <Mantids30/Threads/garbagecollector.h>
+#include <Mantids30/Threads/timingwheel.h>
 #include <Mantids30/Helpers/random.h>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace Mantids30 { namespace Network { namespace Servers { namespace WebMonolith {
 
@@ -41,10 +46,29 @@ public:
         return networkClientInfo;
     }
 
+    /**
+     * @brief isStored true if the session was accepted by the session store.
+     */
+    bool isStored()
+    {
+        return storedLastActivity != 0;
+    }
+    /**
+     * @brief getStoredLastActivity Last activity time already written to the session store (0 if not stored).
+     */
+    time_t getStoredLastActivity()
+    {
+        return storedLastActivity;
+    }
+    void setStoredLastActivity(const time_t & value)
+    {
+        storedLastActivity = value;
+    }
 
 private:
     std::shared_ptr<Mantids30::Sessions::Session> authSession;
     json networkClientInfo;
+    std::atomic<time_t> storedLastActivity{0};
     //std::string sessionId;
 };
 
@@ -129,15 +153,44 @@ public:
      * @return A JSON object containing the user sessions, with session details as key-value pairs.
      */
     json getUserSessionsInfo(const std::string & effectiveUserName);
+    /**
+     * @brief getUserSessionsCount Get the number of active sessions for a given user (O(1))
+     * @param effectiveUserName The username
+     * @return number of active sessions.
+     */
+    uint32_t getUserSessionsCount(const std::string & effectiveUserName);
+
+    /**
+     * @brief setSessionStore Sets the backend where the sessions are also kept (eg. shared memory for multiple worker
+     *                        processes, or a journal for warm restarts). Should be called before serving requests.
+     *
+     * The in-process map remains the primary lookup structure: the store receives the new sessions, the activity
+     * updates (when the session is released) and the removals, and it is queried when a session ID is unknown
+     * to this process or when a session is about to expire (another process may have refreshed it).
+     *
+     * @param store the session store (nullptr to keep the sessions only in this process).
+     */
+    void setSessionStore(std::shared_ptr<Sessions::SessionStore> store);
+    std::shared_ptr<Sessions::SessionStore> getSessionStore();
 
 private:
+    void unregisterUserSession(const std::string & effectiveUser, const std::string & sessionID);
+    WebSession * restoreSession(const std::string & sessionID);
+    bool destroyLocalSession(const std::string & sessionID);
 
     Threads::Safe::Map<std::string> m_sessions;
 
+    // Sessions are revisited only when their inactivity deadline is reached (activity updates don't touch the wheel).
+    Threads::Safe::TimingWheel<std::string> m_expirationWheel;
+
     std::mutex m_mutex;
 
-    std::map<std::string, std::map<std::string, json> > m_sessionClientInfo;
+    // Per-user session index (the client info is kept once, in the WebSession).
+    std::unordered_map<std::string, std::unordered_set<std::string> > m_sessionIDsByUser;
+
 
+    std::shared_ptr<Sessions::SessionStore> m_sessionStore;
+    time_t m_nextStorePurge = 0;
 
     uint32_t m_gcWaitTime = 10;
     uint32_t m_MaxInactiveSeconds = 0;
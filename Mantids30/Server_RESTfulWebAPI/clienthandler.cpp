@@ -149,11 +149,10 @@ void ClientHandler::handleAPIRequest(API::APIReturn * apiReturn,
                                      const uint32_t & apiVersion,
                                      const string &methodMode,
                                      const string &methodName,
-                                     const Json::Value & pathParameters,
+                                     const string & resourcePath,
                                      const Json::Value & postParameters
                                                )
 {
-    set<string> currentPermissions;
     bool authenticated =false;
     API::RESTful::RequestParameters inputParameters;
 
@@ -163,7 +162,6 @@ void ClientHandler::handleAPIRequest(API::APIReturn * apiReturn,
 
     if ( isSessionActive() )
     {
-        currentPermissions = m_JWTToken.getAllPermissions();
         inputParameters.jwtToken = &m_JWTToken;
     }
 
@@ -184,9 +182,8 @@ void ClientHandler::handleAPIRequest(API::APIReturn * apiReturn,
     //securityParameters.genCSRFToken = m_clientRequest.headers.getOptionValueStringByName("GenCSRFToken");
 
     API::RESTful::MethodsHandler::ErrorCodes result = m_methodsHandler[apiVersion]->invokeResource( methodMode,
-                                                                                                    methodName,
+                                                                                                    resourcePath,
                                                                                                     inputParameters,
-                                                                                                    currentPermissions,
                                                                                                     securityParameters,
                                                                                                     apiReturn
                                                                                                    );
@@ -37,8 +37,8 @@ void Engine::revokeJWT(
     )
 {
     // TODO: pasar a parametros POST...
-    std::string jwtSignature = Helpers::Encoders::decodeFromBase64(JSON_ASSTRING(request.pathParameters, "signature",""),true);
-    time_t expirationTime = JSON_ASUINT64(request.pathParameters, "expiration",0);
+    std::string jwtSignature = Helpers::Encoders::decodeFromBase64(request.pathParameters.getString("signature"),true);
+    time_t expirationTime = request.pathParameters.getUInt64("expiration",0);
     ((Engine *)context)->config.jwtValidator->m_revocation.addToRevocationList( jwtSignature, expirationTime );
 }
 
@@ -12,7 +12,6 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/lexical_cast.hpp>
-#include <boost/tokenizer.hpp>
 #include <inttypes.h>
 #include <json/value.h>
 #include <memory>
@@ -39,43 +38,6 @@ APIClientHandler::APIClientHandler(void *parent, std::shared_ptr<StreamableObjec
     : HTTPv1_Server(sock)
 {}
 
-void APIClientHandler::processPathParameters(const std::string &request, std::string &methodName, Json::Value &pathParameters)
-{
-    using Tokenizer = boost::tokenizer<boost::char_separator<char>>;
-    boost::char_separator<char> sep("/");
-
-    Tokenizer tokens(request, sep);
-    Tokenizer::iterator tokenIterator = tokens.begin();
-
-    // Extract the resource name (first token)
-    if (tokenIterator != tokens.end())
-    {
-        methodName = *tokenIterator;
-        ++tokenIterator;
-    }
-
-    // Extract key-value pairs and populate pathParameters
-    while (tokenIterator != tokens.end())
-    {
-        std::string key = *tokenIterator;
-        ++tokenIterator;
-
-        if (tokenIterator != tokens.end())
-        {
-            std::string value = *tokenIterator;
-
-            pathParameters[key] = value;
-
-            ++tokenIterator;
-        }
-        else
-        {
-            // If a key is not followed by a value, assign it null.
-            pathParameters[key] = Json::nullValue;
-        }
-    }
-}
-
 HTTP::Status::Codes APIClientHandler::procHTTPClientContent()
 {
     HTTP::Status::Codes ret = HTTP::Status::S_404_NOT_FOUND;
@@ -126,7 +88,6 @@ HTTP::Status::Codes APIClientHandler::procHTTPClientContent()
                 // It's an API request (with resource).
                 API::APIReturn apiReturn;
                 std::string methodName;
-                json pathParameters;
                 size_t apiVersion = std::stoul(pathMatch[1].str());
                 string methodMode = clientRequest.requestLine.getRequestMethod().c_str();
                 string requestOrigin = clientRequest.getOrigin();
@@ -137,7 +98,8 @@ HTTP::Status::Codes APIClientHandler::procHTTPClientContent()
                 serverResponse.setDataStreamer(apiReturn.getBodyDataStreamer());
                 serverResponse.setContentType("application/json", true);
 
-                processPathParameters(resourceAndPathParameters, methodName, pathParameters);
+                // The parameters are resolved by the handler (only when needed):
+                methodName = resourceAndPathParameters.substr(0, resourceAndPathParameters.find('/'));
 
                 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
                 /// API ORIGIN VALIDATIONS:
@@ -193,7 +155,7 @@ HTTP::Status::Codes APIClientHandler::procHTTPClientContent()
 
                 std::shared_ptr<Mantids30::Memory::Streams::StreamableJSON> jsonStreamable = clientRequest.getJSONStreamerContent();
                 json postParameters = !jsonStreamable ? Json::nullValue : *(jsonStreamable->getValue());
-                handleAPIRequest(&apiReturn, baseApiUrl, apiVersion, methodMode, methodName, pathParameters, postParameters);
+                handleAPIRequest(&apiReturn, baseApiUrl, apiVersion, methodMode, methodName, resourceAndPathParameters, postParameters);
 
                 ret = apiReturn.getHTTPResponseCode();
 
@@ -69,6 +69,20 @@ void APIEngineCore::startInBackground()
     }
 }
 
+bool APIEngineCore::drain(const uint32_t &gracePeriodMS)
+{
+    switch (m_acceptorType)
+    {
+    case AcceptorType::MULTI_THREADED:
+        return m_multiThreadedAcceptor->drain(gracePeriodMS);
+    case AcceptorType::POOL_THREADED:
+        return m_poolThreadedAcceptor->drain(gracePeriodMS);
+    case AcceptorType::NONE:
+    default:
+        return true;
+    }
+}
+
 std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> APIEngineCore::getListenerSocket() const
 {
     return listenerSocket;
@@ -84,19 +98,26 @@ bool APIEngineCore::handleConnect(void *context, std::shared_ptr<Sockets::Socket
     APIEngineCore * webserver = static_cast<APIEngineCore *>(context);
 
     std::string tlsCN;
+    std::shared_ptr<Network::Sockets::Socket_TLS> tlsSock;
     if (sock->isSecure())
     {
-        std::shared_ptr<Network::Sockets::Socket_TLS> tlsSock = std::dynamic_pointer_cast<Network::Sockets::Socket_TLS>( sock );
+        tlsSock = std::dynamic_pointer_cast<Network::Sockets::Socket_TLS>( sock );
         tlsCN = tlsSock->getTLSPeerCN();
     }
 
     // Prepare the web services handler.
     std::shared_ptr<APIClientHandler> apiWebServerClientHandler = webserver->createNewAPIClientHandler(webserver,sock);
 
+    // The TLS handshake was done by the acceptor, add it to the request trace:
+    if (tlsSock && tlsSock->getHandshakeEndTime() != std::chrono::steady_clock::time_point())
+        apiWebServerClientHandler->addTransportSpan("tls.handshake", tlsSock->getHandshakeStartTime(), tlsSock->getHandshakeEndTime());
+
     apiWebServerClientHandler->setClientInfoVars( sock->getRemotePairStr().c_str(), sock->isSecure(), tlsCN );
 
     // Set the configuration:
     apiWebServerClientHandler->config = &(webserver->config);
+    apiWebServerClientHandler->setStaticContentElements(webserver->config.getStaticContentElements());
+    apiWebServerClientHandler->setResponseCompression(webserver->config.responseCompression);
 
     if (webserver->callbacks.onClientConnected.call(webserver,sock))
     {
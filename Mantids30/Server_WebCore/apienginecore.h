@@ -106,6 +106,16 @@ public:
      */
     void startInBackground();
 
+    /**
+     * @brief drain Stops accepting new connections (without shutting down the listening socket) and waits for the current ones.
+     *
+     * Used when the listening socket was handed off to a new process (zero-downtime upgrades).
+     *
+     * @param gracePeriodMS maximum time to wait in milliseconds.
+     * @return true if all the connections finished within the grace period.
+     */
+    bool drain(const uint32_t &gracePeriodMS);
+
 
 
     // Seteables (before starting the acceptor, non-thread safe):
@@ -1,11 +1,10 @@
 #include "apiproxy.h"
 #include "Mantids30/Net_Sockets/socket_stream.h"
 
-#include <Mantids30/Net_Sockets/socket_tls.h>
-#include <Mantids30/Net_Sockets/socket_tcp.h>
-
 #include <Mantids30/Protocol_HTTP/httpv1_client.h>
 
+#include <limits>
+
 using namespace Mantids30::Network::Sockets;
 using namespace Mantids30::Network::Protocols;
 using namespace Mantids30::Memory::Streams;
@@ -16,78 +15,212 @@ using namespace Mantids30;
 // TODO: logs via callback?
 // TODO: how to prvent ../ (escapes)...
 
-HTTP::Status::Codes Mantids30::Network::Servers::Web::ApiProxy(
-    const std::string &internalPath, HTTP::HTTPv1_Base::Request *request, HTTP::HTTPv1_Base::Response *response, std::shared_ptr<void> obj)
+namespace {
+
+/**
+ * @brief The ProxyResponseStream class is the response content given to the web server: it streams the upstream
+ *        response body to the client as it is received, and gives the connection back to the pool when finished.
+ */
+class ProxyResponseStream : public StreamableObject
 {
-    if (obj == nullptr)
+public:
+    ProxyResponseStream(std::shared_ptr<UpstreamPool> pool, std::shared_ptr<UpstreamPool::Connection> connection)
+        : m_pool(pool), m_connection(connection)
     {
-        throw std::runtime_error("Undefined API Proxy Object.");
-        return HTTP::Status::S_500_INTERNAL_SERVER_ERROR;
+    }
+    ~ProxyResponseStream() override
+    {
+        // Not streamed (or not completed), the connection state is unknown.
+        releaseConnection(false);
     }
 
-    ApiProxyParameters *proxyParameters = static_cast<ApiProxyParameters *>(obj.get());
+    void setClient(std::shared_ptr<HTTP::HTTPv1_Client> client) { m_client = client; }
+
+    /**
+     * @brief setup Prepare the stream after the upstream headers were received.
+     */
+    void setup()
+    {
+        if (m_client->isResponseComplete())
+        {
+            // Everything (if any) was received along with the headers.
+            m_size = m_pending.size();
+            releaseConnection(m_client->isConnectionReusable());
+        }
+        else if (m_client->serverResponse.content.getTransmitionMode() == HTTP::Content::TRANSMIT_MODE_CONTENT_LENGTH)
+            m_size = m_client->serverResponse.headers.getOptionAsUINT64("Content-Length");
+    }
 
-    std::shared_ptr<Socket_Stream> connection;
+    size_t size() override { return m_size; }
 
-    if (proxyParameters->useTLS)
+    bool streamTo(StreamableObject *out) override
     {
-        auto socket = std::make_shared<Socket_TLS>();
+        m_target = out;
 
-        if (proxyParameters->checkTLSPeer)
+        bool ok = true;
+        if (!m_pending.empty())
         {
-            socket->setCertValidation(Socket_TLS::CERT_X509_VALIDATE);
-            socket->tlsKeys.setUseSystemCertificates(!proxyParameters->usePrivateCA);
-            if (proxyParameters->usePrivateCA)
-            {
-                socket->tlsKeys.loadCAFromPEMFile(proxyParameters->privateCAPath);
-            }
+            ok = out->writeFullStream(m_pending.data(), m_pending.size());
+            m_pending.clear();
         }
-        else
+
+        if (ok && m_connection)
         {
-            socket->setCertValidation(Socket_TLS::CERT_X509_NOVALIDATE);
+            ok = m_client->receiveResponseBody() && !m_failed;
+            releaseConnection(ok && m_client->isConnectionReusable());
         }
 
-        connection = socket;
+        m_target = nullptr;
+        if (!ok)
+            writeStatus.succeed = false;
+        return ok;
+    }
+
+    std::optional<size_t> write(const void *buf, const size_t &count) override
+    {
+        // EOF from the upstream content (the end is given by the client connection)
+        if (count == 0)
+            return 0;
+
+        if (!m_target)
+        {
+            // Received with the headers, before the response is being streamed.
+            m_pending.append(static_cast<const char *>(buf), count);
+            return count;
+        }
 
+        if (!m_target->writeFullStream(buf, count))
+        {
+            m_failed = true;
+            return std::nullopt;
+        }
+        return count;
     }
-    else
+
+private:
+    void releaseConnection(bool reusable)
     {
-        auto socket = std::make_shared<Socket_TCP>();
-        connection = socket;
+        if (m_connection)
+        {
+            m_pool->release(m_connection, reusable);
+            m_connection = nullptr;
+        }
     }
 
-    // Make the connection
-    if (connection->connectTo( proxyParameters->remoteHost.c_str(), proxyParameters->remotePort ))
+    std::shared_ptr<UpstreamPool> m_pool;
+    std::shared_ptr<UpstreamPool::Connection> m_connection;
+    std::shared_ptr<HTTP::HTTPv1_Client> m_client;
+
+    std::string m_pending;
+    StreamableObject * m_target = nullptr;
+    size_t m_size = std::numeric_limits<size_t>::max();
+    bool m_failed = false;
+};
+
+/**
+ * @brief The ProxyResponseSink class receives the upstream content from the HTTP client and passes it to the
+ *        response stream (a plain pointer: the stream owns the client, and the client owns this sink).
+ */
+class ProxyResponseSink : public StreamableObject
+{
+public:
+    ProxyResponseSink(ProxyResponseStream * stream) : m_stream(stream) {}
+    std::optional<size_t> write(const void *buf, const size_t &count) override { return m_stream->write(buf, count); }
+
+private:
+    ProxyResponseStream * m_stream;
+};
+
+bool isIdempotent(const std::string & method)
+{
+    // Safe to send twice (RFC 9110 9.2.2), any other method (including extensions) may have been processed already:
+    return method == "GET" || method == "HEAD" || method == "PUT" || method == "DELETE" || method == "OPTIONS" || method == "TRACE";
+}
+
+}
+
+HTTP::Status::Codes Mantids30::Network::Servers::Web::ApiProxy(
+    const std::string &internalPath, HTTP::HTTPv1_Base::Request *request, HTTP::HTTPv1_Base::Response *response, std::shared_ptr<void> obj)
+{
+    if (obj == nullptr)
+    {
+        throw std::runtime_error("Undefined API Proxy Object.");
+        return HTTP::Status::S_500_INTERNAL_SERVER_ERROR;
+    }
+
+    ApiProxyParameters *proxyParameters = static_cast<ApiProxyParameters *>(obj.get());
+    std::shared_ptr<UpstreamPool> pool = proxyParameters->upstreamPool ? proxyParameters->upstreamPool : UpstreamPool::getDefault();
+
+    bool forceNew = !proxyParameters->usePool;
+
+    // One retry is allowed when a reused connection fails (it may have been closed by the server meanwhile).
+    for (int attempt = 0; attempt < 2; attempt++)
     {
-        HTTP::HTTPv1_Client client(connection);
+        std::shared_ptr<UpstreamPool::Connection> connection = pool->acquire(*proxyParameters, forceNew);
+        if (!connection)
+            return HTTP::Status::S_502_BAD_GATEWAY;
+
+        auto stream = std::make_shared<ProxyResponseStream>(pool, connection);
+        auto client = std::make_shared<HTTP::HTTPv1_Client>(connection->socket);
+        stream->setClient(client);
 
         // Set the same request.
-        client.clientRequest = *request;
+        client->clientRequest = *request;
 
         // Use the new internal path (removing the proxy original URL)...
-        client.clientRequest.requestLine.setRequestURI( internalPath );
+        client->clientRequest.requestLine.setRequestURI( internalPath );
 
         // Replace current headers with extra headers (eg. x-api-key... X-Originating-IP )
         for (const auto& header : proxyParameters->extraHeaders)
         {
-            client.clientRequest.headers.replace(header.first, header.second);
+            client->clientRequest.headers.replace(header.first, header.second);
         }
 
-        // Make the petition...
+        client->setKeepAlive(proxyParameters->usePool);
+        client->setPauseAfterHeaders(true);
+        client->serverResponse.content.setSecurityMaxPostDataSize(proxyParameters->maxResponseBodySize);
+        client->serverResponse.content.setStreamableObj(std::make_shared<ProxyResponseSink>(stream.get()));
+
+        // Make the petition (up to the response headers)...
         Parser::ErrorMSG msg;
-        client.parseObject(&msg);
+        client->parseObject(&msg);
 
-        if (msg == Parser::PARSING_SUCCEED)
+        if (msg != Parser::PARSING_SUCCEED || !client->isResponseHeaderComplete())
         {
-            client.serverResponse.immutableHeaders = true;
-            *response = client.serverResponse;
-            return (HTTP::Status::Codes)client.serverResponse.status.getCode();
+            bool retry = connection->reused && isIdempotent(request->requestLine.getRequestMethod());
+            // stream destruction gives back the connection (as not reusable).
+            if (retry)
+            {
+                forceNew = true;
+                continue;
+            }
+            return HTTP::Status::S_502_BAD_GATEWAY;
         }
 
-        return HTTP::Status::S_502_BAD_GATEWAY;
-    }
-    else
-    {
-        return HTTP::Status::S_502_BAD_GATEWAY;
+        stream->setup();
+
+        *response = client->serverResponse;
+
+        // Hop-by-hop headers are defined by our server:
+        response->headers.remove("Connection");
+        response->headers.remove("Keep-Alive");
+        response->headers.remove("Transfer-Encoding");
+        response->headers.remove("Content-Length");
+
+        response->immutableHeaders = true;
+        response->content.setStreamableObj(stream);
+        if (stream->size() != std::numeric_limits<size_t>::max())
+            response->content.setTransmitionMode(HTTP::Content::TRANSMIT_MODE_CONTENT_LENGTH);
+        else if (request->requestLine.getHTTPVersion()->getMinor() >= 1)
+        {
+            // Unknown size (eg. a chunked upstream response): chunked to HTTP/1.1 clients, so they keep the connection.
+            response->content.setTransmitionMode(HTTP::Content::TRANSMIT_MODE_CHUNKS);
+        }
+        else
+            response->content.setTransmitionMode(HTTP::Content::TRANSMIT_MODE_CONNECTION_CLOSE);
+
+        return (HTTP::Status::Codes)client->serverResponse.status.getCode();
     }
+
+    return HTTP::Status::S_502_BAD_GATEWAY;
 }
@@ -3,6 +3,7 @@
 #include <memory>
 #include <Mantids30/Protocol_HTTP/httpv1_base.h>
 #include <string>
+#include "upstreampool.h"
 
 namespace Mantids30 { namespace Network { namespace Servers { namespace Web {
 
@@ -19,6 +20,28 @@ struct ApiProxyParameters
 
     std::map<std::string,std::string> extraHeaders;
 
+    // Upstream connection pool:
+    /**
+     * @brief usePool reuse the upstream connections (keep-alive), otherwise every request uses a new connection.
+     */
+    bool usePool = true;
+    /**
+     * @brief upstreamPool pool used for this proxy (nullptr: the process-wide pool).
+     */
+    std::shared_ptr<UpstreamPool> upstreamPool;
+    size_t maxConnectionsPerHost = 64;
+    size_t maxIdleConnectionsPerHost = 16;
+    uint32_t idleTimeoutSeconds = 30;
+    /**
+     * @brief maxRequestsPerConnection close the connection after this number of requests (0: unlimited).
+     */
+    uint32_t maxRequestsPerConnection = 1000;
+
+    /**
+     * @brief maxResponseBodySize max upstream response body size (for responses with Content-Length), the body
+     *                            is streamed to the client and never fully stored in memory.
+     */
+    uint64_t maxResponseBodySize = 1024*1024*1024;
 };
 
 Mantids30::Network::Protocols::HTTP::Status::Codes ApiProxy(const std::string &internalPath, Mantids30::Network::Protocols::HTTP::HTTPv1_Base::Request *request, Mantids30::Network::Protocols::HTTP::HTTPv1_Base::Response *response, std::shared_ptr<void> obj);
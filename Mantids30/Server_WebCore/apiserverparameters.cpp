@@ -86,6 +86,13 @@ void APIServerParameters::addStaticContentElement(const std::string &path, const
         memcpy(xmem, content.c_str(), content.size());
         m_staticContentElements[path] = std::make_shared<Mantids30::Memory::Containers::B_MEM>(xmem, content.size());
         m_memToBeFreed.push_back(xmem);
+
+        // Build the compressed variants now, so the responses don't compress anything:
+        if (responseCompression.enabled && responseCompression.useCache)
+        {
+            Mantids30::Network::Protocols::HTTP::CompressedContentCache::getDefault()->precompress(
+                Mantids30::Network::Protocols::HTTP::HTTPv1_Server::getStaticContentCacheKey(path, m_staticContentElements[path]), m_staticContentElements[path].get());
+        }
     }
 }
 
@@ -4,6 +4,7 @@
 #include <Mantids30/DataFormat_JWT/jwt.h>
 #include <Mantids30/Program_Logs/rpclog.h>
 #include <Mantids30/Protocol_HTTP/httpv1_base.h>
+#include <Mantids30/Protocol_HTTP/httpv1_server.h>
 #include <Mantids30/Protocol_HTTP/rsp_status.h>
 #include <Mantids30/Sessions/session.h>
 #include <Mantids30/API_RESTful/methodshandler.h>
@@ -198,6 +199,14 @@ public:
      */
     std::string webServerName;
 
+    /**
+     * @brief Response compression (Accept-Encoding negotiation).
+     *
+     * Enabled by default for the configured content types. Static content elements are precompressed when added (if
+     * compression and its cache are enabled at that time), and document root files are compressed on their first hit.
+     */
+    Protocols::HTTP::HTTPv1_Server::CompressionParameters responseCompression;
+
     /**
      * @brief softwareVersion Set Software Version (to display in the API)
      */
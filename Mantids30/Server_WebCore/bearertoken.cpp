@@ -0,0 +1,20 @@
+#include "bearertoken.h"
+
+#include <openssl/crypto.h>
+
+using namespace Mantids30::Network::Protocols;
+
+HTTP::Status::Codes Mantids30::Network::Servers::Web::checkBearerToken(HTTP::HTTPv1_Base::Request *request, const std::string &bearerToken)
+{
+    if (bearerToken.empty())
+        return HTTP::Status::S_403_FORBIDDEN;
+
+    std::string authorization = request->headers.getOptionValueStringByName("Authorization");
+    std::string expected = "Bearer " + bearerToken;
+
+    // Constant time comparison (only the length is revealed):
+    if (authorization.size() != expected.size() || CRYPTO_memcmp(authorization.data(), expected.data(), expected.size()) != 0)
+        return HTTP::Status::S_401_UNAUTHORIZED;
+
+    return HTTP::Status::S_200_OK;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Mantids30/Protocol_HTTP/httpv1_base.h>
+#include <string>
+
+namespace Mantids30 { namespace Network { namespace Servers { namespace Web {
+
+/**
+ * @brief checkBearerToken Checks the "Authorization: Bearer <token>" header of a request against a secret token
+ *                         (compared in constant time).
+ * @param request request to be checked.
+ * @param bearerToken expected token (empty: the resource is never served).
+ * @return S_200_OK if the token matches, S_403_FORBIDDEN if there is no expected token, S_401_UNAUTHORIZED otherwise.
+ */
+Mantids30::Network::Protocols::HTTP::Status::Codes checkBearerToken(Mantids30::Network::Protocols::HTTP::HTTPv1_Base::Request *request, const std::string &bearerToken);
+
+}}}}
@@ -0,0 +1,36 @@
+#include "prometheusmetrics.h"
+#include "bearertoken.h"
+
+#include <Mantids30/Memory/streamablestring.h>
+
+using namespace Mantids30::Network::Protocols;
+using namespace Mantids30::Network::Servers::Web;
+using namespace Mantids30;
+
+HTTP::Status::Codes Mantids30::Network::Servers::Web::PrometheusMetrics(
+    const std::string &, HTTP::HTTPv1_Base::Request *request, HTTP::HTTPv1_Base::Response *response, std::shared_ptr<void> obj)
+{
+    PrometheusMetricsParameters *parameters = static_cast<PrometheusMetricsParameters *>(obj.get());
+
+    std::string method = request->requestLine.getRequestMethod();
+    if (method != "GET" && method != "HEAD")
+        return HTTP::Status::S_405_METHOD_NOT_ALLOWED;
+
+    // The metrics reveal the server internals and load:
+    if (!parameters)
+        return HTTP::Status::S_403_FORBIDDEN;
+
+    HTTP::Status::Codes authorized = checkBearerToken(request, parameters->bearerToken);
+    if (authorized != HTTP::Status::S_200_OK)
+        return authorized;
+
+    Program::Metrics::Registry & registry = parameters->registry ? *parameters->registry : Program::Metrics::Registry::getDefault();
+
+    std::shared_ptr<Memory::Streams::StreamableString> output = std::make_shared<Memory::Streams::StreamableString>();
+    output->writeString(registry.toPrometheusText());
+    response->setDataStreamer(output);
+    response->setContentType("text/plain; version=0.0.4; charset=utf-8", true);
+    response->cacheControl.optionNoStore = true;
+
+    return HTTP::Status::S_200_OK;
+}
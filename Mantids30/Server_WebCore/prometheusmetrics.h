@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Mantids30/Program_Metrics/registry.h>
+#include <Mantids30/Protocol_HTTP/httpv1_base.h>
+#include <memory>
+#include <string>
+
+namespace Mantids30 { namespace Network { namespace Servers { namespace Web {
+
+struct PrometheusMetricsParameters
+{
+    /**
+     * @brief registry registry to be exposed (nullptr: the process-wide registry).
+     */
+    Program::Metrics::Registry * registry = nullptr;
+    /**
+     * @brief bearerToken the scraper must send "Authorization: Bearer <token>" (required, the metrics are never served without it).
+     */
+    std::string bearerToken;
+};
+
+/**
+ * @brief PrometheusMetrics Dynamic request handler that exposes the metrics registry in the Prometheus text format.
+ *
+ * Mount it on any web engine, eg:
+ *     auto metricsParams = std::make_shared<Web::PrometheusMetricsParameters>();
+ *     metricsParams->bearerToken = "<secret>";
+ *     engine->config.dynamicRequestHandlersByRoute["/metrics"] = {&Web::PrometheusMetrics, metricsParams};
+ * (the handler answers the requests under the route, eg. /metrics/).
+ *
+ * @param obj PrometheusMetricsParameters (without it, or without a bearer token, the requests are refused with 403)
+ */
+Mantids30::Network::Protocols::HTTP::Status::Codes PrometheusMetrics(const std::string &internalPath, Mantids30::Network::Protocols::HTTP::HTTPv1_Base::Request *request, Mantids30::Network::Protocols::HTTP::HTTPv1_Base::Response *response, std::shared_ptr<void> obj);
+
+}}}}
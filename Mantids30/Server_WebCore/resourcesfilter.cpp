@@ -1,4 +1,5 @@
 #include "resourcesfilter.h"
+#include <Mantids30/Program_Tracing/tracing.h>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
@@ -108,6 +109,7 @@ void ResourcesFilter::addFilter(const Filter &filter)
 
 ResourcesFilter::FilterEvaluationResult ResourcesFilter::evaluateURI(const std::string &uri, const std::set<std::string> & permissions,const std::set<std::string> & roles, bool isSessionActive)
 {
+    Mantids30::Program::Tracing::Span span("web.resources_filter");
     FilterEvaluationResult evaluationResult;
 
     for (const Filter & filter : m_filters)
@@ -0,0 +1,44 @@
+#include "tracedump.h"
+#include "bearertoken.h"
+
+#include <Mantids30/Memory/streamablestring.h>
+#include <Mantids30/Program_Tracing/tracing.h>
+
+using namespace Mantids30::Network::Protocols;
+using namespace Mantids30::Network::Servers::Web;
+using namespace Mantids30;
+
+HTTP::Status::Codes Mantids30::Network::Servers::Web::TraceDump(
+    const std::string &internalPath, HTTP::HTTPv1_Base::Request *request, HTTP::HTTPv1_Base::Response *response, std::shared_ptr<void> obj)
+{
+    TraceDumpParameters *parameters = static_cast<TraceDumpParameters *>(obj.get());
+
+    std::string method = request->requestLine.getRequestMethod();
+    if (method != "GET" && method != "HEAD")
+        return HTTP::Status::S_405_METHOD_NOT_ALLOWED;
+
+    // The spans reveal the requested paths and timings of every client:
+    if (!parameters)
+        return HTTP::Status::S_403_FORBIDDEN;
+
+    HTTP::Status::Codes authorized = checkBearerToken(request, parameters->bearerToken);
+    if (authorized != HTTP::Status::S_200_OK)
+        return authorized;
+
+    // The internal path may contain the trace id:
+    std::string traceIdStr = internalPath;
+    while (!traceIdStr.empty() && traceIdStr.front() == '/')
+        traceIdStr.erase(0, 1);
+
+    uint64_t traceId = 0;
+    if (!traceIdStr.empty() && (traceId = Program::Tracing::traceIdFromString(traceIdStr)) == 0)
+        return HTTP::Status::S_404_NOT_FOUND;
+
+    std::shared_ptr<Memory::Streams::StreamableString> output = std::make_shared<Memory::Streams::StreamableString>();
+    output->writeString(Program::Tracing::dumpChromeTrace(traceId));
+    response->setDataStreamer(output);
+    response->setContentType("application/json", true);
+    response->cacheControl.optionNoStore = true;
+
+    return HTTP::Status::S_200_OK;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Mantids30/Protocol_HTTP/httpv1_base.h>
+#include <memory>
+#include <string>
+
+namespace Mantids30 { namespace Network { namespace Servers { namespace Web {
+
+struct TraceDumpParameters
+{
+    /**
+     * @brief bearerToken the client must send "Authorization: Bearer <token>" (required, the dump is never served without it).
+     */
+    std::string bearerToken;
+};
+
+/**
+ * @brief TraceDump Dynamic request handler that dumps the recorded request traces (see Program::Tracing) in the
+ *        Chrome Trace Event format (load it in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Mount it on any web engine, eg:
+ *     auto tracesParams = std::make_shared<Web::TraceDumpParameters>();
+ *     tracesParams->bearerToken = "<secret>";
+ *     engine->config.dynamicRequestHandlersByRoute["/traces"] = {&Web::TraceDump, tracesParams};
+ * /traces/ dumps every recorded span, and /traces/<traceId> (as returned in the X-Trace-Id response header) only one trace.
+ *
+ * @param obj TraceDumpParameters (without it, or without a bearer token, the requests are refused with 403)
+ */
+Mantids30::Network::Protocols::HTTP::Status::Codes TraceDump(const std::string &internalPath, Mantids30::Network::Protocols::HTTP::HTTPv1_Base::Request *request, Mantids30::Network::Protocols::HTTP::HTTPv1_Base::Response *response, std::shared_ptr<void> obj);
+
+}}}}
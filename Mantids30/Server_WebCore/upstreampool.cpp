@@ -0,0 +1,337 @@
+#include "upstreampool.h"
+#include "apiproxy.h"
+
+#include <Mantids30/Net_Sockets/socket_tcp.h>
+#include <Mantids30/Net_Sockets/socket_tls.h>
+
+#include <chrono>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+using namespace Mantids30::Network::Sockets;
+using namespace Mantids30::Network::Servers::Web;
+
+UpstreamPool::~UpstreamPool()
+{
+    for (auto & host : m_hosts)
+    {
+        for (auto & connection : host.second.idle)
+            closeConnection(connection);
+        if (host.second.tlsSession)
+            SSL_SESSION_free(host.second.tlsSession);
+    }
+}
+
+std::shared_ptr<UpstreamPool> UpstreamPool::getDefault()
+{
+    static std::shared_ptr<UpstreamPool> defaultPool = std::make_shared<UpstreamPool>();
+    return defaultPool;
+}
+
+std::shared_ptr<UpstreamPool::Connection> UpstreamPool::acquire(const ApiProxyParameters &params, bool forceNew)
+{
+    std::string key = makeKey(params);
+    SSL_SESSION * tlsSession = nullptr;
+    // Closed outside the lock:
+    std::list<std::shared_ptr<Connection>> discarded;
+    std::shared_ptr<Connection> reusedConnection;
+    bool timedOut = false;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Host & host = getHost(key, time(nullptr));
+        host.maxIdle = params.maxIdleConnectionsPerHost;
+        host.idleTimeout = params.idleTimeoutSeconds;
+        host.maxRequests = params.maxRequestsPerConnection;
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(m_acquireTimeout);
+        while (!reusedConnection)
+        {
+            // Take the most recently used idle connection (the least likely to be closed by the server):
+            time_t now = time(nullptr);
+            while (!forceNew && !host.idle.empty())
+            {
+                std::shared_ptr<Connection> connection = host.idle.back();
+                host.idle.pop_back();
+
+                if (isHealthy(connection, host, now))
+                {
+                    connection->lastUsed = now;
+                    connection->requests++;
+                    connection->reused = true;
+                    reusedConnection = connection;
+                    break;
+                }
+
+                // Discard this one...
+                host.total--;
+                discarded.push_back(connection);
+            }
+            if (reusedConnection)
+                break;
+
+            if (params.maxConnectionsPerHost == 0 || host.total < params.maxConnectionsPerHost)
+                break;
+
+            if (forceNew && !host.idle.empty())
+            {
+                // Make room for the new connection.
+                host.total--;
+                discarded.push_back(host.idle.front());
+                host.idle.pop_front();
+                break;
+            }
+
+            if (m_released.wait_until(lock, deadline) == std::cv_status::timeout)
+            {
+                timedOut = true;
+                break;
+            }
+        }
+
+        if (!reusedConnection && !timedOut)
+        {
+            host.total++;
+            host.lastUsed = time(nullptr);
+            if (host.tlsSession)
+            {
+                SSL_SESSION_up_ref(host.tlsSession);
+                tlsSession = host.tlsSession;
+            }
+        }
+    }
+
+    for (auto & connection : discarded)
+        closeConnection(connection);
+
+    if (reusedConnection || timedOut)
+        return reusedConnection;
+
+    // Connect outside the lock:
+    std::shared_ptr<Socket_Stream> socket = connect(params, tlsSession);
+    if (tlsSession)
+        SSL_SESSION_free(tlsSession);
+
+    if (!socket)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_hosts[key].total--;
+        m_released.notify_one();
+        return nullptr;
+    }
+
+    std::shared_ptr<Connection> connection = std::make_shared<Connection>();
+    connection->socket = socket;
+    connection->key = key;
+    connection->createdAt = connection->lastUsed = time(nullptr);
+    connection->requests = 1;
+    return connection;
+}
+
+void UpstreamPool::release(std::shared_ptr<Connection> connection, bool reusable)
+{
+    if (!connection)
+        return;
+
+    // Keep the TLS session to resume it on the next connections to this host (even if this connection is closed).
+    SSL_SESSION * tlsSession = nullptr;
+    if (auto tlsSocket = std::dynamic_pointer_cast<Socket_TLS>(connection->socket))
+    {
+        tlsSession = tlsSocket->getSession();
+        if (tlsSession && !SSL_SESSION_is_resumable(tlsSession))
+        {
+            SSL_SESSION_free(tlsSession);
+            tlsSession = nullptr;
+        }
+    }
+
+    std::shared_ptr<Connection> discarded;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Host & host = m_hosts[connection->key];
+        host.lastUsed = time(nullptr);
+
+        if (tlsSession)
+        {
+            if (host.tlsSession)
+                SSL_SESSION_free(host.tlsSession);
+            host.tlsSession = tlsSession;
+        }
+
+        if (reusable && (host.maxRequests == 0 || connection->requests < host.maxRequests) && host.idle.size() < host.maxIdle)
+        {
+            connection->lastUsed = time(nullptr);
+            host.idle.push_back(connection);
+        }
+        else
+        {
+            host.total--;
+            discarded = connection;
+        }
+    }
+    m_released.notify_one();
+
+    if (discarded)
+        closeConnection(discarded);
+}
+
+void UpstreamPool::closeIdle()
+{
+    std::list<std::shared_ptr<Connection>> discarded;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (auto & host : m_hosts)
+        {
+            host.second.total -= host.second.idle.size();
+            discarded.splice(discarded.end(), host.second.idle);
+        }
+    }
+    m_released.notify_all();
+
+    for (auto & connection : discarded)
+        closeConnection(connection);
+}
+
+size_t UpstreamPool::getIdleCount()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    size_t r = 0;
+    for (auto & host : m_hosts)
+        r += host.second.idle.size();
+    return r;
+}
+
+size_t UpstreamPool::getActiveCount()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    size_t r = 0;
+    for (auto & host : m_hosts)
+        r += host.second.total - host.second.idle.size();
+    return r;
+}
+
+size_t UpstreamPool::getHostCount()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_hosts.size();
+}
+
+void UpstreamPool::setAcquireTimeout(const uint32_t &seconds)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_acquireTimeout = seconds;
+}
+
+UpstreamPool::Host &UpstreamPool::getHost(const std::string &key, const time_t &now)
+{
+    auto it = m_hosts.find(key);
+    if (it != m_hosts.end())
+        return it->second;
+
+    // Only grows here, a good time to forget the unused destinations:
+    pruneHosts(now);
+    return m_hosts[key];
+}
+
+void UpstreamPool::pruneHosts(const time_t &now)
+{
+    for (auto it = m_hosts.begin(); it != m_hosts.end();)
+    {
+        Host & host = it->second;
+        // The TLS session is kept (for the resumption) while the idle connections would be:
+        if (host.total == 0 && now - host.lastUsed >= static_cast<time_t>(host.idleTimeout))
+        {
+            if (host.tlsSession)
+                SSL_SESSION_free(host.tlsSession);
+            it = m_hosts.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+std::string UpstreamPool::makeKey(const ApiProxyParameters &params)
+{
+    std::string key = (params.useTLS ? "tls://" : "tcp://") + params.remoteHost + ":" + std::to_string(params.remotePort);
+    if (params.useTLS)
+    {
+        key += params.checkTLSPeer ? "/verify" : "/noverify";
+        if (params.usePrivateCA)
+            key += "/ca=" + params.privateCAPath;
+    }
+    return key;
+}
+
+bool UpstreamPool::isHealthy(const std::shared_ptr<Connection> &connection, const Host &host, const time_t &now)
+{
+    if (host.idleTimeout && now - connection->lastUsed >= static_cast<time_t>(host.idleTimeout))
+        return false;
+    if (host.maxRequests && connection->requests >= host.maxRequests)
+        return false;
+
+    int fd = connection->socket->getSocketFD();
+    if (fd < 0)
+        return false;
+
+    // An idle connection should have nothing to read: readable means closed by the server (EOF) or an unexpected
+    // response, in both cases it can't be used.
+#ifdef _WIN32
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(fd, &readSet);
+    struct timeval timeout = {0, 0};
+    return select(fd + 1, &readSet, nullptr, nullptr, &timeout) == 0;
+#else
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) == 0;
+#endif
+}
+
+void UpstreamPool::closeConnection(const std::shared_ptr<Connection> &connection)
+{
+    connection->socket->shutdownSocket();
+    connection->socket->closeSocket();
+}
+
+std::shared_ptr<Socket_Stream> UpstreamPool::connect(const ApiProxyParameters &params, SSL_SESSION *tlsSession)
+{
+    std::shared_ptr<Socket_Stream> socket;
+
+    if (params.useTLS)
+    {
+        auto tlsSocket = std::make_shared<Socket_TLS>();
+
+        if (params.checkTLSPeer)
+        {
+            tlsSocket->setCertValidation(Socket_TLS::CERT_X509_VALIDATE);
+            tlsSocket->tlsKeys.setUseSystemCertificates(!params.usePrivateCA);
+            if (params.usePrivateCA)
+            {
+                tlsSocket->tlsKeys.loadCAFromPEMFile(params.privateCAPath);
+            }
+        }
+        else
+        {
+            tlsSocket->setCertValidation(Socket_TLS::CERT_X509_NOVALIDATE);
+        }
+
+        tlsSocket->setResumeSession(tlsSession);
+        socket = tlsSocket;
+    }
+    else
+    {
+        socket = std::make_shared<Socket_TCP>();
+    }
+
+    if (!socket->connectTo(params.remoteHost.c_str(), params.remotePort))
+        return nullptr;
+
+    return socket;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <Mantids30/Net_Sockets/socket_stream.h>
+
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <openssl/ssl.h>
+#include <stdint.h>
+#include <string>
+#include <time.h>
+
+namespace Mantids30 { namespace Network { namespace Servers { namespace Web {
+
+struct ApiProxyParameters;
+
+/**
+ * @brief The UpstreamPool class keeps persistent (keep-alive) connections to the API proxy upstream servers.
+ *
+ * Connections are grouped by destination (host, port and TLS parameters). Each destination has a limit of
+ * simultaneous connections (acquire waits for a released one when reached) and of idle connections kept for reuse.
+ * Destinations without connections are forgotten after their idle timeout (checked when a new destination is added,
+ * without idle timeout they are forgotten at that time).
+ * Idle connections are checked before being handed out: they are discarded when expired, when they served too many
+ * requests, or when the server closed them (the socket became readable while idle).
+ *
+ * For TLS destinations, the last resumable session is kept and offered on new connections, so reconnections do
+ * an abbreviated handshake.
+ */
+class UpstreamPool
+{
+public:
+    struct Connection
+    {
+        std::shared_ptr<Sockets::Socket_Stream> socket;
+        std::string key;
+        time_t createdAt = 0;
+        time_t lastUsed = 0;
+        /**
+         * @brief requests number of requests done over this connection (including the current one).
+         */
+        uint32_t requests = 0;
+        /**
+         * @brief reused true if the connection was taken from the idle list.
+         */
+        bool reused = false;
+    };
+
+    UpstreamPool() = default;
+    ~UpstreamPool();
+
+    /**
+     * @brief getDefault Get the process-wide pool (used when the proxy parameters does not define one).
+     */
+    static std::shared_ptr<UpstreamPool> getDefault();
+
+    /**
+     * @brief acquire Get a connection to the upstream server: an idle one if available, or a new one.
+     * @param params proxy parameters (destination, TLS options and limits).
+     * @param forceNew don't take idle connections (eg. retrying after a failed reused connection).
+     * @return connection, or nullptr if the connection failed or the limit was reached for more than the wait timeout.
+     */
+    std::shared_ptr<Connection> acquire(const ApiProxyParameters & params, bool forceNew = false);
+    /**
+     * @brief release Give back the connection to the pool.
+     * @param connection connection acquired from this pool.
+     * @param reusable true if the connection is in a clean state (full response received, keep-alive accepted),
+     *                 otherwise it will be closed.
+     */
+    void release(std::shared_ptr<Connection> connection, bool reusable);
+
+    /**
+     * @brief closeIdle Close every idle connection.
+     */
+    void closeIdle();
+    /**
+     * @brief getIdleCount Get the number of idle connections (all the destinations).
+     */
+    size_t getIdleCount();
+    /**
+     * @brief getActiveCount Get the number of connections in use (all the destinations).
+     */
+    size_t getActiveCount();
+    /**
+     * @brief getHostCount Get the number of destinations being tracked.
+     */
+    size_t getHostCount();
+
+    /**
+     * @brief setAcquireTimeout Set the time to wait for a free connection when the per-host limit is reached.
+     * @param seconds timeout in seconds (default 30).
+     */
+    void setAcquireTimeout(const uint32_t & seconds);
+
+private:
+    struct Host
+    {
+        std::list<std::shared_ptr<Connection>> idle;
+        size_t total = 0;
+        size_t maxIdle = 0;
+        uint32_t idleTimeout = 0;
+        uint32_t maxRequests = 0;
+        SSL_SESSION * tlsSession = nullptr;
+        time_t lastUsed = 0;
+    };
+
+    static std::string makeKey(const ApiProxyParameters & params);
+    static bool isHealthy(const std::shared_ptr<Connection> & connection, const Host & host, const time_t & now);
+    static void closeConnection(const std::shared_ptr<Connection> & connection);
+
+    Host & getHost(const std::string & key, const time_t & now);
+    void pruneHosts(const time_t & now);
+
+    std::shared_ptr<Sockets::Socket_Stream> connect(const ApiProxyParameters & params, SSL_SESSION * tlsSession);
+
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    std::map<std::string, Host> m_hosts;
+    uint32_t m_acquireTimeout = 30;
+};
+
+}}}}
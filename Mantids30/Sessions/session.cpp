@@ -84,6 +84,22 @@ JWT::Token Session::getJWTAuthenticatedInfo()
     return m_jwtAuthenticatedInfo;
 }
 
+bool Session::validateAccess(const AccessMask &requiredPermissions, const AccessMask &requiredRoles, AccessMask *permissionsLeft, AccessMask *rolesLeft)
+{
+    std::unique_lock<std::mutex> lock(m_authenticationMutex);
+    // Evaluate both when the caller wants the full list of what is missing:
+    bool r = m_jwtAuthenticatedInfo.hasAllPermissions(requiredPermissions, permissionsLeft);
+    if (!r && !rolesLeft)
+        return false;
+    return m_jwtAuthenticatedInfo.hasAllRoles(requiredRoles, rolesLeft) && r;
+}
+
+bool Session::isAdmin()
+{
+    std::unique_lock<std::mutex> lock(m_authenticationMutex);
+    return m_jwtAuthenticatedInfo.isAdmin();
+}
+
 
 void Session::setLastActivity(const time_t &value)
 {
@@ -102,3 +118,9 @@ time_t Session::getFirstActivity()
     std::unique_lock<std::mutex> lock(m_authenticationMutex);
     return m_firstActivityTimestamp;
 }
+
+void Session::setFirstActivity(const time_t &value)
+{
+    std::unique_lock<std::mutex> lock(m_authenticationMutex);
+    m_firstActivityTimestamp = value;
+}
@@ -121,12 +121,32 @@ public:
      * @return unix time
      */
     time_t getFirstActivity();
+    /**
+     * @brief setFirstActivity Set the session creation time (for assign operations, eg. restoring a stored session)
+     * @param value unix time
+     */
+    void setFirstActivity(const time_t &value);
 
     // TODO: Validate that the session has not been revoked.
     bool isSessionRevoked() { return false; }
 
     DataFormat::JWT::Token getJWTAuthenticatedInfo();
 
+    /**
+     * @brief validateAccess Check precompiled permission/role requirements against the session token (without copying it)
+     * @param requiredPermissions permissions required (see DataFormat::AccessRegistry::compile)
+     * @param requiredRoles roles required
+     * @param permissionsLeft if not null, receives the required permissions not granted
+     * @param rolesLeft if not null, receives the required roles not granted
+     * @return true if every permission and role is granted
+     */
+    bool validateAccess(const DataFormat::AccessMask &requiredPermissions, const DataFormat::AccessMask &requiredRoles,
+                        DataFormat::AccessMask *permissionsLeft = nullptr, DataFormat::AccessMask *rolesLeft = nullptr);
+    /**
+     * @brief isAdmin Check the isAdmin claim of the session token (without copying it)
+     */
+    bool isAdmin();
+
 //    void setJWTAuthenticatedInfo(const JWT::Token &newJwtAuthenticatedInfo);
 
     std::string getDomain();
@@ -0,0 +1,31 @@
+#include "sessionstore.h"
+
+using namespace Mantids30::Sessions;
+using namespace Mantids30::DataFormat;
+using namespace Mantids30;
+
+StoredSession SessionStore::capture(const std::string &sessionID, const std::shared_ptr<Session> &session, const json &clientInfo)
+{
+    StoredSession r;
+    r.sessionID = sessionID;
+    r.tokenPayload = session->getJWTAuthenticatedInfo().exportPayload();
+    r.clientInfo = clientInfo;
+    r.firstActivity = session->getFirstActivity();
+    r.lastActivity = session->getLastActivity();
+    return r;
+}
+
+std::shared_ptr<Session> SessionStore::restore(const StoredSession &storedSession)
+{
+    JWT::Token token;
+    if (!token.decodePayload(storedSession.tokenPayload))
+        return nullptr;
+
+    // The token was verified before being stored.
+    token.setSignatureVerified(true);
+
+    auto session = std::make_shared<Session>(token);
+    session->setFirstActivity(storedSession.firstActivity);
+    session->setLastActivity(storedSession.lastActivity);
+    return session;
+}
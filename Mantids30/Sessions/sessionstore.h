@@ -0,0 +1,97 @@
+#pragma once
+
+#include "session.h"
+#include <Mantids30/Helpers/json.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <time.h>
+
+namespace Mantids30 { namespace Sessions {
+
+/**
+ * @brief The StoredSession struct is the serializable form of a session kept by a SessionStore.
+ */
+struct StoredSession
+{
+    /**
+     * @brief The session ID (the key in the store).
+     */
+    std::string sessionID;
+    /**
+     * @brief JWT claims of the authenticated session (Token::exportPayload).
+     *        The signature was already validated when the session was created, so it is not stored.
+     */
+    std::string tokenPayload;
+    /**
+     * @brief Network client information associated with the session (eg. remoteAddress, userAgent).
+     */
+    json clientInfo;
+
+    time_t firstActivity = 0;
+    time_t lastActivity = 0;
+};
+
+/**
+ * @brief The SessionStore class is the pluggable backend interface for keeping sessions outside the process memory.
+ *
+ * Session managers keep their in-process map as the primary lookup structure and use the store to:
+ *  - share the sessions between worker processes (eg. SessionStore_SharedMemory),
+ *  - survive restarts (eg. SessionStore_Journal).
+ *
+ * Implementations must be thread-safe.
+ */
+class SessionStore
+{
+public:
+    virtual ~SessionStore() = default;
+
+    /**
+     * @brief put Inserts or replaces a session.
+     * @return false if the session could not be stored (eg. the store is full or the session is too big).
+     */
+    virtual bool put(const StoredSession & session) = 0;
+    /**
+     * @brief get Retrieves a session.
+     * @return false if there is no session with this ID.
+     */
+    virtual bool get(const std::string & sessionID, StoredSession & session) = 0;
+    /**
+     * @brief getLastActivity Retrieves only the last activity of a session (cheaper than get).
+     * @return false if there is no session with this ID.
+     */
+    virtual bool getLastActivity(const std::string & sessionID, time_t & lastActivity) = 0;
+    /**
+     * @brief touch Updates the last activity of a session (older values are ignored).
+     * @return false if there is no session with this ID.
+     */
+    virtual bool touch(const std::string & sessionID, const time_t & lastActivity) = 0;
+    /**
+     * @brief remove Removes a session.
+     * @return false if there is no session with this ID.
+     */
+    virtual bool remove(const std::string & sessionID) = 0;
+    /**
+     * @brief removeInactive Removes every session whose last activity is older than the given time
+     *                       (sessions left behind by processes that are gone).
+     * @return number of removed sessions.
+     */
+    virtual size_t removeInactive(const time_t & lastActivityBefore) = 0;
+    /**
+     * @brief forEach Iterates over a copy of every stored session.
+     */
+    virtual void forEach(const std::function<void(const StoredSession &)> & fn) = 0;
+
+    /**
+     * @brief capture Creates the stored form of a session.
+     */
+    static StoredSession capture(const std::string & sessionID, const std::shared_ptr<Session> & session, const json & clientInfo);
+    /**
+     * @brief restore Creates a session from its stored form.
+     * @return the session, or nullptr if the token payload is corrupt.
+     */
+    static std::shared_ptr<Session> restore(const StoredSession & storedSession);
+};
+
+}}
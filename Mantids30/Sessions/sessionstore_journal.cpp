@@ -0,0 +1,456 @@
+#include "sessionstore_journal.h"
+#include <Mantids30/Threads/lock_shared.h>
+
+#include <chrono>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+using namespace Mantids30::Sessions;
+using namespace Mantids30;
+
+SessionStore_Journal::~SessionStore_Journal()
+{
+    close();
+}
+
+bool SessionStore_Journal::open(const std::string &pathPrefix)
+{
+    if (m_running)
+        return false;
+
+    m_pathPrefix = pathPrefix;
+
+    uint64_t firstGeneration = 0;
+    if (!replayFile(getSnapshotFileName(), true, &firstGeneration))
+        return false;
+
+    // Replay every journal from the snapshot generation onwards.
+    uint64_t generation = firstGeneration;
+    for (;; generation++)
+    {
+        std::string journalFile = getJournalFileName(generation);
+        if (FILE * fp = fopen(journalFile.c_str(), "rb"))
+            fclose(fp);
+        else
+            break;
+        replayFile(journalFile, false, nullptr);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_fileMutex);
+        // Start clean: new snapshot with everything loaded, and a new (empty) journal.
+        m_generation = generation;
+        if (!compact())
+            return false;
+    }
+    for (uint64_t g = firstGeneration; g < generation; g++)
+        ::remove(getJournalFileName(g).c_str());
+
+    m_running = true;
+    m_writer = std::thread(writerThread, this);
+    return true;
+}
+
+void SessionStore_Journal::close()
+{
+    if (m_running.exchange(false))
+    {
+        m_pendingCond.notify_all();
+        m_writer.join();
+    }
+
+    writePending();
+
+    std::unique_lock<std::mutex> lock(m_fileMutex);
+    if (m_journal)
+    {
+        fclose(m_journal);
+        m_journal = nullptr;
+    }
+}
+
+bool SessionStore_Journal::flush()
+{
+    return writePending();
+}
+
+void SessionStore_Journal::setFlushInterval(const uint32_t &milliseconds)
+{
+    m_flushInterval = milliseconds;
+}
+
+void SessionStore_Journal::setCompactionThreshold(const size_t &journalEntries)
+{
+    m_compactionThreshold = journalEntries;
+}
+
+bool SessionStore_Journal::put(const StoredSession &session)
+{
+    {
+        Threads::Sync::Lock_RW lock(m_sessionsMutex);
+        m_sessions[session.sessionID] = session;
+    }
+    queueOperation(OP_PUT, session);
+    return true;
+}
+
+bool SessionStore_Journal::get(const std::string &sessionID, StoredSession &session)
+{
+    Threads::Sync::Lock_RD lock(m_sessionsMutex);
+    auto it = m_sessions.find(sessionID);
+    if (it == m_sessions.end())
+        return false;
+    session = it->second;
+    return true;
+}
+
+bool SessionStore_Journal::getLastActivity(const std::string &sessionID, time_t &lastActivity)
+{
+    Threads::Sync::Lock_RD lock(m_sessionsMutex);
+    auto it = m_sessions.find(sessionID);
+    if (it == m_sessions.end())
+        return false;
+    lastActivity = it->second.lastActivity;
+    return true;
+}
+
+bool SessionStore_Journal::touch(const std::string &sessionID, const time_t &lastActivity)
+{
+    {
+        Threads::Sync::Lock_RW lock(m_sessionsMutex);
+        auto it = m_sessions.find(sessionID);
+        if (it == m_sessions.end())
+            return false;
+        if (it->second.lastActivity >= lastActivity)
+            return true;
+        it->second.lastActivity = lastActivity;
+    }
+
+    std::unique_lock<std::mutex> lock(m_pendingMutex);
+    time_t & pending = m_pendingTouches[sessionID];
+    if (pending < lastActivity)
+        pending = lastActivity;
+    return true;
+}
+
+bool SessionStore_Journal::remove(const std::string &sessionID)
+{
+    {
+        Threads::Sync::Lock_RW lock(m_sessionsMutex);
+        if (m_sessions.erase(sessionID) == 0)
+            return false;
+    }
+    StoredSession removed;
+    removed.sessionID = sessionID;
+    queueOperation(OP_REMOVE, removed);
+    return true;
+}
+
+size_t SessionStore_Journal::removeInactive(const time_t &lastActivityBefore)
+{
+    std::list<std::string> removedIDs;
+    {
+        Threads::Sync::Lock_RW lock(m_sessionsMutex);
+        for (auto it = m_sessions.begin(); it != m_sessions.end();)
+        {
+            if (it->second.lastActivity < lastActivityBefore)
+            {
+                removedIDs.push_back(it->first);
+                it = m_sessions.erase(it);
+            }
+            else
+                it++;
+        }
+    }
+
+    for (const auto & sessionID : removedIDs)
+    {
+        StoredSession removed;
+        removed.sessionID = sessionID;
+        queueOperation(OP_REMOVE, removed);
+    }
+    return removedIDs.size();
+}
+
+void SessionStore_Journal::forEach(const std::function<void (const StoredSession &)> &fn)
+{
+    Threads::Sync::Lock_RD lock(m_sessionsMutex);
+    for (const auto & i : m_sessions)
+        fn(i.second);
+}
+
+void SessionStore_Journal::writerThread(SessionStore_Journal *store)
+{
+    while (store->m_running)
+    {
+        {
+            std::unique_lock<std::mutex> lock(store->m_pendingMutex);
+            store->m_pendingCond.wait_for(lock, std::chrono::milliseconds(store->m_flushInterval.load()), [store]() { return !store->m_running; });
+        }
+        store->writePending();
+    }
+}
+
+void SessionStore_Journal::queueOperation(const eOperation &operation, const StoredSession &session)
+{
+    std::unique_lock<std::mutex> lock(m_pendingMutex);
+    m_pendingOperations.push_back({operation, session});
+}
+
+bool SessionStore_Journal::writePending()
+{
+    std::unique_lock<std::mutex> fileLock(m_fileMutex);
+
+    if (!m_journal)
+    {
+        // Kept queued while there is no journal:
+        std::unique_lock<std::mutex> lock(m_pendingMutex);
+        return m_pendingOperations.empty() && m_pendingTouches.empty();
+    }
+
+    std::list<PendingOperation> operations;
+    std::unordered_map<std::string, time_t> touches;
+    {
+        std::unique_lock<std::mutex> lock(m_pendingMutex);
+        operations.swap(m_pendingOperations);
+        touches.swap(m_pendingTouches);
+    }
+
+    if (operations.empty() && touches.empty())
+        return true;
+
+    // One write for the whole batch. Touches go last: a touch after a removal is ignored when replaying.
+    std::string batch;
+    for (const auto & op : operations)
+    {
+        json entry;
+        if (op.operation == OP_PUT)
+        {
+            entry = toJSON(op.session);
+            entry["op"] = "put";
+        }
+        else
+        {
+            entry["op"] = "del";
+            entry["id"] = op.session.sessionID;
+        }
+        batch += Helpers::jsonToString(entry) + "\n";
+    }
+    for (const auto & touch : touches)
+    {
+        json entry;
+        entry["op"] = "touch";
+        entry["id"] = touch.first;
+        entry["la"] = (Json::Int64) touch.second;
+        batch += Helpers::jsonToString(entry) + "\n";
+    }
+
+#ifndef _WIN32
+    // Everything before was synced, so this is where the batch starts:
+    struct stat journalStat;
+    off_t journalSize = fstat(fileno(m_journal), &journalStat) == 0 ? journalStat.st_size : -1;
+#endif
+
+    bool r = fwrite(batch.data(), 1, batch.size(), m_journal) == batch.size() && syncFile(m_journal);
+    if (!r)
+    {
+#ifndef _WIN32
+        // Drop the part of the batch already written: the replay stops at a torn line, and the entries after it
+        // (this batch, written again later) would be lost.
+        fclose(m_journal);
+        m_journal = nullptr;
+        if (journalSize >= 0 && truncate(getJournalFileName(m_generation).c_str(), journalSize) == 0)
+            m_journal = openPrivateFile(getJournalFileName(m_generation), true);
+        if (!m_journal)
+        {
+            // Continue in a new generation (its snapshot includes everything applied so far):
+            compact();
+        }
+#endif
+        // Queued again (before anything queued meanwhile) for the next write:
+        std::unique_lock<std::mutex> lock(m_pendingMutex);
+        m_pendingOperations.splice(m_pendingOperations.begin(), operations);
+        for (const auto & touch : touches)
+        {
+            auto it = m_pendingTouches.find(touch.first);
+            if (it == m_pendingTouches.end())
+                m_pendingTouches[touch.first] = touch.second;
+            else if (it->second < touch.second)
+                it->second = touch.second;
+        }
+        return false;
+    }
+    m_journalEntries += operations.size() + touches.size();
+
+    if (m_journalEntries >= m_compactionThreshold)
+    {
+        uint64_t oldGeneration = m_generation;
+        if (compact())
+            ::remove(getJournalFileName(oldGeneration).c_str());
+    }
+    return true;
+}
+
+bool SessionStore_Journal::compact()
+{
+    // Switch to the next journal generation first: from now on, everything not included in the snapshot copy is
+    // written to the new journal (replaying an operation already contained in the snapshot is harmless).
+    uint64_t newGeneration = m_generation + 1;
+    FILE * newJournal = openPrivateFile(getJournalFileName(newGeneration), true);
+    if (!newJournal)
+        return false;
+
+    if (m_journal)
+        fclose(m_journal);
+    m_journal = newJournal;
+    m_generation = newGeneration;
+    m_journalEntries = 0;
+
+    std::string snapshot;
+    {
+        json header;
+        header["gen"] = (Json::UInt64) newGeneration;
+        snapshot = Helpers::jsonToString(header) + "\n";
+
+        Threads::Sync::Lock_RD lock(m_sessionsMutex);
+        for (const auto & i : m_sessions)
+            snapshot += Helpers::jsonToString(toJSON(i.second)) + "\n";
+    }
+
+    std::string tmpFileName = getSnapshotFileName() + ".tmp";
+    FILE * fp = openPrivateFile(tmpFileName, false);
+    if (!fp)
+        return false;
+    bool r = fwrite(snapshot.data(), 1, snapshot.size(), fp) == snapshot.size() && syncFile(fp);
+    fclose(fp);
+    if (!r)
+        return false;
+
+#ifdef _WIN32
+    ::remove(getSnapshotFileName().c_str());
+#endif
+    return rename(tmpFileName.c_str(), getSnapshotFileName().c_str()) == 0;
+}
+
+bool SessionStore_Journal::replayFile(const std::string &fileName, bool isSnapshot, uint64_t *generation)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open())
+        return isSnapshot; // No snapshot yet.
+
+    Helpers::JSONReader2 reader;
+    std::string line;
+    bool first = true;
+    while (std::getline(file, line))
+    {
+        json entry;
+        if (!reader.parse(line, entry) || !entry.isObject())
+        {
+            // Torn tail (interrupted write): everything after it is discarded.
+            break;
+        }
+
+        if (isSnapshot && first)
+        {
+            if (generation)
+                *generation = JSON_ASUINT64(entry, "gen", 0);
+        }
+        else
+        {
+            applyEntry(entry);
+        }
+        first = false;
+    }
+    return true;
+}
+
+void SessionStore_Journal::applyEntry(const json &entry)
+{
+    std::string op = JSON_ASSTRING(entry, "op", "put");
+    std::string sessionID = JSON_ASSTRING(entry, "id", "");
+    if (sessionID.empty())
+        return;
+
+    Threads::Sync::Lock_RW lock(m_sessionsMutex);
+    if (op == "put")
+    {
+        StoredSession & session = m_sessions[sessionID];
+        session.sessionID = sessionID;
+        session.tokenPayload = JSON_ASSTRING(entry, "tok", "");
+        session.clientInfo = entry["ci"];
+        session.firstActivity = static_cast<time_t>(JSON_ASINT64(entry, "fa", 0));
+        session.lastActivity = static_cast<time_t>(JSON_ASINT64(entry, "la", 0));
+    }
+    else if (op == "touch")
+    {
+        auto it = m_sessions.find(sessionID);
+        time_t lastActivity = static_cast<time_t>(JSON_ASINT64(entry, "la", 0));
+        if (it != m_sessions.end() && it->second.lastActivity < lastActivity)
+            it->second.lastActivity = lastActivity;
+    }
+    else if (op == "del")
+    {
+        m_sessions.erase(sessionID);
+    }
+}
+
+std::string SessionStore_Journal::getJournalFileName(const uint64_t &generation) const
+{
+    return m_pathPrefix + ".journal." + std::to_string(generation);
+}
+
+std::string SessionStore_Journal::getSnapshotFileName() const
+{
+    return m_pathPrefix + ".snapshot";
+}
+
+json SessionStore_Journal::toJSON(const StoredSession &session)
+{
+    json r;
+    r["id"] = session.sessionID;
+    r["tok"] = session.tokenPayload;
+    r["ci"] = session.clientInfo;
+    r["fa"] = (Json::Int64) session.firstActivity;
+    r["la"] = (Json::Int64) session.lastActivity;
+    return r;
+}
+
+FILE *SessionStore_Journal::openPrivateFile(const std::string &fileName, bool append)
+{
+#ifndef _WIN32
+    // Session ID's are bearer credentials: owner only, whatever the process umask is (0 when daemonized).
+    int fd = ::open(fileName.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0600);
+    if (fd < 0)
+        return nullptr;
+    // The file may have been created before with other permissions:
+    if (fchmod(fd, 0600) != 0)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    FILE * fp = fdopen(fd, append ? "ab" : "wb");
+    if (!fp)
+        ::close(fd);
+    return fp;
+#else
+    return fopen(fileName.c_str(), append ? "ab" : "wb");
+#endif
+}
+
+bool SessionStore_Journal::syncFile(FILE *fp)
+{
+    if (fflush(fp) != 0)
+        return false;
+#ifndef _WIN32
+    return fdatasync(fileno(fp)) == 0;
+#else
+    return _commit(_fileno(fp)) == 0;
+#endif
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "sessionstore.h"
+#include <Mantids30/Threads/mutex_shared.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace Mantids30 { namespace Sessions {
+
+/**
+ * @brief The SessionStore_Journal class keeps the sessions in process memory and persists them write-behind,
+ *        so a restarted server gets its sessions back (warm restart).
+ *
+ * Lookups are served from an in-memory hash map under a shared lock, so they cost about the same as the manager's
+ * own map. Modifications are applied to the map immediately and queued; a background thread appends the queued
+ * operations to a JSON-lines journal in a single write + fdatasync per interval (group commit). Consecutive
+ * activity updates of a session are coalesced into one journal entry.
+ *
+ * When the journal grows past the compaction threshold, the writer switches to a new journal generation and writes
+ * a snapshot of the map (tmp file + fsync + rename). Loading reads the snapshot and replays the journals of its
+ * generation onwards, stopping at the first torn line (the tail of an interrupted write).
+ *
+ * Files: <pathPrefix>.snapshot and <pathPrefix>.journal.<generation> (created with 0600 permissions)
+ */
+class SessionStore_Journal : public SessionStore
+{
+public:
+    SessionStore_Journal() = default;
+    ~SessionStore_Journal() override;
+
+    /**
+     * @brief open Loads the stored sessions and starts the background writer.
+     * @param pathPrefix path prefix for the snapshot and journal files (the directory must exist).
+     * @return true if the files are ready for writing.
+     */
+    bool open(const std::string & pathPrefix);
+    /**
+     * @brief close Writes the pending operations and stops the background writer.
+     */
+    void close();
+    /**
+     * @brief flush Writes and syncs the pending operations now.
+     * @return false on I/O error.
+     */
+    bool flush();
+
+    /**
+     * @brief setFlushInterval Sets the maximum time the operations remain only in memory (default: 200ms).
+     */
+    void setFlushInterval(const uint32_t & milliseconds);
+    /**
+     * @brief setCompactionThreshold Sets the number of journal entries that triggers a new snapshot (default: 10000).
+     */
+    void setCompactionThreshold(const size_t & journalEntries);
+
+    bool put(const StoredSession & session) override;
+    bool get(const std::string & sessionID, StoredSession & session) override;
+    bool getLastActivity(const std::string & sessionID, time_t & lastActivity) override;
+    bool touch(const std::string & sessionID, const time_t & lastActivity) override;
+    bool remove(const std::string & sessionID) override;
+    size_t removeInactive(const time_t & lastActivityBefore) override;
+    void forEach(const std::function<void(const StoredSession &)> & fn) override;
+
+private:
+    enum eOperation
+    {
+        OP_PUT,
+        OP_REMOVE
+    };
+    struct PendingOperation
+    {
+        eOperation operation;
+        StoredSession session;
+    };
+
+    static void writerThread(SessionStore_Journal * store);
+
+    void queueOperation(const eOperation & operation, const StoredSession & session);
+    bool writePending();
+    bool compact();
+    bool load();
+    bool replayFile(const std::string & fileName, bool isSnapshot, uint64_t * generation);
+    void applyEntry(const json & entry);
+
+    std::string getJournalFileName(const uint64_t & generation) const;
+    std::string getSnapshotFileName() const;
+
+    static json toJSON(const StoredSession & session);
+    static FILE * openPrivateFile(const std::string & fileName, bool append);
+    static bool syncFile(FILE * fp);
+
+    // In-memory sessions (primary lookup structure):
+    std::unordered_map<std::string, StoredSession> m_sessions;
+    Threads::Sync::Mutex_Shared m_sessionsMutex;
+
+    // Operations waiting to be written (touches are coalesced per session):
+    std::list<PendingOperation> m_pendingOperations;
+    std::unordered_map<std::string, time_t> m_pendingTouches;
+    std::mutex m_pendingMutex;
+    std::condition_variable m_pendingCond;
+
+    // Journal file (only used with m_fileMutex held):
+    std::mutex m_fileMutex;
+    FILE * m_journal = nullptr;
+    uint64_t m_generation = 0;
+    size_t m_journalEntries = 0;
+
+    std::string m_pathPrefix;
+    std::thread m_writer;
+    std::atomic<bool> m_running{false};
+
+    std::atomic<uint32_t> m_flushInterval{200};
+    std::atomic<size_t> m_compactionThreshold{10000};
+};
+
+}}
@@ -0,0 +1,526 @@
+#include "sessionstore_sharedmemory.h"
+
+#include <Mantids30/Helpers/json.h>
+
+#include <atomic>
+#include <errno.h>
+#include <string.h>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Mantids30::Sessions;
+using namespace Mantids30;
+
+#define SHMSTORE_MAGIC 0x4D53455353484D31ULL // "MSESSHM1"
+#define SHMSTORE_VERSION 1
+// Bounded spinning (a process that died while writing a slot leaves it odd forever).
+#define SHMSTORE_MAX_SPINS (1u<<20)
+// Bounded probing (a lookup miss costs at most this many slots, whatever the table load is).
+#define SHMSTORE_MAX_PROBES 256u
+
+enum eSlotState : uint32_t
+{
+    SLOT_EMPTY = 0,
+    SLOT_USED = 1,
+    SLOT_TOMBSTONE = 2
+};
+
+struct SessionStore_SharedMemory::TableHeader
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotDataSize;
+    std::atomic<uint32_t> ready;
+};
+
+struct SessionStore_SharedMemory::Slot
+{
+    // Odd while a writer owns the slot.
+    std::atomic<uint32_t> sequence;
+    uint32_t state;
+    char sessionID[MAX_SESSIONID_LEN+1];
+    int64_t firstActivity;
+    int64_t lastActivity;
+    uint32_t payloadLen;
+    uint32_t clientInfoLen;
+    // followed by slotDataSize bytes: token payload + client info.
+};
+
+struct SessionStore_SharedMemory::SlotView
+{
+    uint32_t state = SLOT_EMPTY;
+    char sessionID[MAX_SESSIONID_LEN+1];
+    int64_t firstActivity = 0;
+    int64_t lastActivity = 0;
+    std::string payload;
+    std::string clientInfo;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory sessions require lock-free 32-bit atomics");
+
+static size_t alignTo8(const size_t & v)
+{
+    return (v + 7) & ~static_cast<size_t>(7);
+}
+
+SessionStore_SharedMemory::~SessionStore_SharedMemory()
+{
+    close();
+}
+
+bool SessionStore_SharedMemory::open(const std::string &name, const uint32_t &slotCount, const uint32_t &slotDataSize)
+{
+#ifndef _WIN32
+    if (isOpen() || !slotCount)
+        return false;
+
+    bool creator = true;
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST)
+    {
+        creator = false;
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+    }
+    if (fd < 0)
+        return false;
+
+    size_t headerSize = alignTo8(sizeof(TableHeader));
+    size_t tableSize = 0;
+
+    if (creator)
+    {
+        size_t stride = alignTo8(sizeof(Slot) + slotDataSize);
+        tableSize = headerSize + stride * slotCount;
+        // ftruncate zero-fills: every slot starts EMPTY with an even sequence.
+        if (ftruncate(fd, static_cast<off_t>(tableSize)) != 0)
+        {
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+    }
+    else
+    {
+        // Wait for the creator to size the object.
+        struct stat st;
+        for (uint32_t i = 0; ; i++)
+        {
+            if (fstat(fd, &st) != 0 || i == SHMSTORE_MAX_SPINS)
+            {
+                ::close(fd);
+                return false;
+            }
+            if (static_cast<size_t>(st.st_size) >= headerSize)
+                break;
+            std::this_thread::yield();
+        }
+        tableSize = static_cast<size_t>(st.st_size);
+    }
+
+    void * addr = mmap(nullptr, tableSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+        return false;
+
+    TableHeader * header = static_cast<TableHeader *>(addr);
+    if (creator)
+    {
+        header->magic = SHMSTORE_MAGIC;
+        header->version = SHMSTORE_VERSION;
+        header->slotCount = slotCount;
+        header->slotDataSize = slotDataSize;
+        header->ready.store(1, std::memory_order_release);
+    }
+    else
+    {
+        uint32_t i = 0;
+        while (header->ready.load(std::memory_order_acquire) != 1 && i++ < SHMSTORE_MAX_SPINS)
+            std::this_thread::yield();
+
+        if ( header->ready.load(std::memory_order_acquire) != 1
+             || header->magic != SHMSTORE_MAGIC
+             || header->version != SHMSTORE_VERSION
+             || headerSize + alignTo8(sizeof(Slot) + header->slotDataSize) * header->slotCount > tableSize )
+        {
+            munmap(addr, tableSize);
+            return false;
+        }
+    }
+
+    m_table = addr;
+    m_tableSize = tableSize;
+    m_slotCount = header->slotCount;
+    m_slotDataSize = header->slotDataSize;
+    m_slotStride = alignTo8(sizeof(Slot) + m_slotDataSize);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SessionStore_SharedMemory::close()
+{
+#ifndef _WIN32
+    if (m_table)
+        munmap(m_table, m_tableSize);
+#endif
+    m_table = nullptr;
+    m_tableSize = 0;
+    m_slotCount = 0;
+}
+
+bool SessionStore_SharedMemory::unlink(const std::string &name)
+{
+#ifndef _WIN32
+    return shm_unlink(name.c_str()) == 0;
+#else
+    return false;
+#endif
+}
+
+bool SessionStore_SharedMemory::put(const StoredSession &session)
+{
+    if (!isOpen() || session.sessionID.empty() || session.sessionID.size() > MAX_SESSIONID_LEN)
+        return false;
+
+    std::string clientInfo = Helpers::jsonToString(session.clientInfo);
+    if (session.tokenPayload.size() + clientInfo.size() > m_slotDataSize)
+        return false;
+
+    uint64_t hash = hashSessionID(session.sessionID);
+
+    // The chosen slot may be taken by another process before we lock it, in that case probe again.
+    for (int attempt = 0; attempt < 8; attempt++)
+    {
+        int64_t target = -1;
+        bool replace = false;
+        SlotView view;
+
+        for (uint32_t i = 0; i < getMaxProbes(); i++)
+        {
+            uint32_t idx = static_cast<uint32_t>((hash + i) % m_slotCount);
+            if (!readSlot(getSlot(idx), view, false))
+                continue;
+
+            if (view.state == SLOT_USED && session.sessionID == view.sessionID)
+            {
+                target = idx;
+                replace = true;
+                break;
+            }
+            if (view.state == SLOT_TOMBSTONE && target < 0)
+                target = idx;
+            if (view.state == SLOT_EMPTY)
+            {
+                if (target < 0)
+                    target = idx;
+                break;
+            }
+        }
+
+        if (target < 0)
+            return false; // Full (in the probing range).
+
+        Slot * slot = getSlot(static_cast<uint32_t>(target));
+        if (!lockSlot(slot))
+            continue;
+
+        bool stillValid = replace ? (slot->state == SLOT_USED && session.sessionID == slot->sessionID) : (slot->state != SLOT_USED);
+        if (!stillValid)
+        {
+            unlockSlot(slot);
+            continue;
+        }
+
+        char * data = reinterpret_cast<char *>(slot) + sizeof(Slot);
+        memset(slot->sessionID, 0, sizeof(slot->sessionID));
+        memcpy(slot->sessionID, session.sessionID.data(), session.sessionID.size());
+        slot->firstActivity = session.firstActivity;
+        slot->lastActivity = session.lastActivity;
+        slot->payloadLen = static_cast<uint32_t>(session.tokenPayload.size());
+        slot->clientInfoLen = static_cast<uint32_t>(clientInfo.size());
+        memcpy(data, session.tokenPayload.data(), session.tokenPayload.size());
+        memcpy(data + session.tokenPayload.size(), clientInfo.data(), clientInfo.size());
+        slot->state = SLOT_USED;
+
+        unlockSlot(slot);
+
+        // A tombstone in our probing chain may have been emptied meanwhile, leaving the new session unreachable:
+        if (!replace && findSlot(session.sessionID) != target)
+        {
+            if (lockSlot(slot))
+            {
+                if (slotMatches(slot, session.sessionID))
+                    slot->state = SLOT_TOMBSTONE;
+                unlockSlot(slot);
+            }
+            clearTombstones(static_cast<uint32_t>(target));
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool SessionStore_SharedMemory::get(const std::string &sessionID, StoredSession &session)
+{
+    int64_t idx = findSlot(sessionID);
+    if (idx < 0)
+        return false;
+
+    SlotView view;
+    if (!readSlot(getSlot(static_cast<uint32_t>(idx)), view, true) || view.state != SLOT_USED || sessionID != view.sessionID)
+        return false;
+
+    Helpers::JSONReader2 reader;
+    session.sessionID = sessionID;
+    session.tokenPayload = std::move(view.payload);
+    session.clientInfo = Json::nullValue;
+    if (!view.clientInfo.empty() && !reader.parse(view.clientInfo, session.clientInfo))
+        return false;
+    session.firstActivity = static_cast<time_t>(view.firstActivity);
+    session.lastActivity = static_cast<time_t>(view.lastActivity);
+    return true;
+}
+
+bool SessionStore_SharedMemory::getLastActivity(const std::string &sessionID, time_t &lastActivity)
+{
+    int64_t idx = findSlot(sessionID);
+    if (idx < 0)
+        return false;
+
+    SlotView view;
+    if (!readSlot(getSlot(static_cast<uint32_t>(idx)), view, false) || view.state != SLOT_USED || sessionID != view.sessionID)
+        return false;
+
+    lastActivity = static_cast<time_t>(view.lastActivity);
+    return true;
+}
+
+bool SessionStore_SharedMemory::touch(const std::string &sessionID, const time_t &lastActivity)
+{
+    int64_t idx = findSlot(sessionID);
+    if (idx < 0)
+        return false;
+
+    Slot * slot = getSlot(static_cast<uint32_t>(idx));
+    if (!lockSlot(slot))
+        return false;
+
+    bool r = slotMatches(slot, sessionID);
+    if (r && slot->lastActivity < lastActivity)
+        slot->lastActivity = lastActivity;
+
+    unlockSlot(slot);
+    return r;
+}
+
+bool SessionStore_SharedMemory::remove(const std::string &sessionID)
+{
+    int64_t idx = findSlot(sessionID);
+    if (idx < 0)
+        return false;
+
+    Slot * slot = getSlot(static_cast<uint32_t>(idx));
+    if (!lockSlot(slot))
+        return false;
+
+    bool r = slotMatches(slot, sessionID);
+    if (r)
+        slot->state = SLOT_TOMBSTONE;
+
+    unlockSlot(slot);
+
+    if (r)
+        clearTombstones(static_cast<uint32_t>(idx));
+    return r;
+}
+
+size_t SessionStore_SharedMemory::removeInactive(const time_t &lastActivityBefore)
+{
+    size_t removed = 0;
+    SlotView view;
+    for (uint32_t idx = 0; idx < m_slotCount; idx++)
+    {
+        Slot * slot = getSlot(idx);
+        if (!readSlot(slot, view, false) || view.state != SLOT_USED || view.lastActivity >= lastActivityBefore)
+            continue;
+
+        if (!lockSlot(slot))
+            continue;
+        bool r = slot->state == SLOT_USED && slot->lastActivity < lastActivityBefore;
+        if (r)
+        {
+            slot->state = SLOT_TOMBSTONE;
+            removed++;
+        }
+        unlockSlot(slot);
+
+        if (r)
+            clearTombstones(idx);
+    }
+    return removed;
+}
+
+void SessionStore_SharedMemory::forEach(const std::function<void (const StoredSession &)> &fn)
+{
+    SlotView view;
+    Helpers::JSONReader2 reader;
+    for (uint32_t idx = 0; idx < m_slotCount; idx++)
+    {
+        if (!readSlot(getSlot(idx), view, true) || view.state != SLOT_USED)
+            continue;
+
+        StoredSession session;
+        session.sessionID = view.sessionID;
+        session.tokenPayload = view.payload;
+        if (!view.clientInfo.empty() && !reader.parse(view.clientInfo, session.clientInfo))
+            continue;
+        session.firstActivity = static_cast<time_t>(view.firstActivity);
+        session.lastActivity = static_cast<time_t>(view.lastActivity);
+        fn(session);
+    }
+}
+
+SessionStore_SharedMemory::Slot *SessionStore_SharedMemory::getSlot(const uint32_t &idx) const
+{
+    return reinterpret_cast<Slot *>(static_cast<char *>(m_table) + alignTo8(sizeof(TableHeader)) + m_slotStride * idx);
+}
+
+int64_t SessionStore_SharedMemory::findSlot(const std::string &sessionID) const
+{
+    if (!isOpen() || sessionID.empty() || sessionID.size() > MAX_SESSIONID_LEN)
+        return -1;
+
+    uint64_t hash = hashSessionID(sessionID);
+    SlotView view;
+    for (uint32_t i = 0; i < getMaxProbes(); i++)
+    {
+        uint32_t idx = static_cast<uint32_t>((hash + i) % m_slotCount);
+        if (!readSlot(getSlot(idx), view, false))
+            continue;
+        if (view.state == SLOT_EMPTY)
+            return -1;
+        if (view.state == SLOT_USED && sessionID == view.sessionID)
+            return idx;
+    }
+    return -1;
+}
+
+uint32_t SessionStore_SharedMemory::getMaxProbes() const
+{
+    return m_slotCount < SHMSTORE_MAX_PROBES ? m_slotCount : SHMSTORE_MAX_PROBES;
+}
+
+void SessionStore_SharedMemory::clearTombstones(uint32_t idx)
+{
+    // A tombstone followed by an empty slot is the end of every probing chain that goes through it, so it can be
+    // emptied, and then the tombstones before it (otherwise, the lookup misses would end up probing every slot):
+    for (uint32_t i = 0; i < getMaxProbes(); i++)
+    {
+        Slot * slot = getSlot(idx);
+        Slot * next = getSlot((idx + 1) % m_slotCount);
+        if (slot == next || !lockSlot(slot))
+            return;
+
+        bool cleared = false;
+        // Both slots are locked, so no writer can take the next slot meanwhile:
+        if (slot->state == SLOT_TOMBSTONE && lockSlot(next))
+        {
+            if (next->state == SLOT_EMPTY)
+            {
+                slot->state = SLOT_EMPTY;
+                cleared = true;
+            }
+            unlockSlot(next);
+        }
+        unlockSlot(slot);
+
+        if (!cleared)
+            return;
+        idx = (idx + m_slotCount - 1) % m_slotCount;
+    }
+}
+
+bool SessionStore_SharedMemory::readSlot(Slot *slot, SlotView &view, bool withData) const
+{
+    const char * data = reinterpret_cast<const char *>(slot) + sizeof(Slot);
+
+    for (uint32_t i = 0; i < SHMSTORE_MAX_SPINS; i++)
+    {
+        uint32_t seq1 = slot->sequence.load(std::memory_order_acquire);
+        if (seq1 & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        view.state = slot->state;
+        memcpy(view.sessionID, slot->sessionID, sizeof(view.sessionID));
+        view.sessionID[MAX_SESSIONID_LEN] = 0;
+        view.firstActivity = slot->firstActivity;
+        view.lastActivity = slot->lastActivity;
+
+        if (withData && view.state == SLOT_USED)
+        {
+            // Lengths may be torn while a writer is active, clamp them (the sequence check discards the copy anyway).
+            size_t payloadLen = slot->payloadLen, clientInfoLen = slot->clientInfoLen;
+            if (payloadLen > m_slotDataSize)
+                payloadLen = m_slotDataSize;
+            if (clientInfoLen > m_slotDataSize - payloadLen)
+                clientInfoLen = m_slotDataSize - payloadLen;
+            view.payload.assign(data, payloadLen);
+            view.clientInfo.assign(data + payloadLen, clientInfoLen);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == seq1)
+            return true;
+    }
+    return false;
+}
+
+bool SessionStore_SharedMemory::lockSlot(Slot *slot) const
+{
+    for (uint32_t i = 0; i < SHMSTORE_MAX_SPINS; i++)
+    {
+        uint32_t seq = slot->sequence.load(std::memory_order_relaxed);
+        if (!(seq & 1) && slot->sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire))
+        {
+            // Readers must observe the odd sequence before any modification.
+            std::atomic_thread_fence(std::memory_order_release);
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    return false;
+}
+
+void SessionStore_SharedMemory::unlockSlot(Slot *slot) const
+{
+    slot->sequence.fetch_add(1, std::memory_order_release);
+}
+
+bool SessionStore_SharedMemory::slotMatches(Slot *slot, const std::string &sessionID) const
+{
+    return slot->state == SLOT_USED && sessionID.size() <= MAX_SESSIONID_LEN && strncmp(slot->sessionID, sessionID.c_str(), MAX_SESSIONID_LEN+1) == 0;
+}
+
+uint64_t SessionStore_SharedMemory::hashSessionID(const std::string &sessionID)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : sessionID)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "sessionstore.h"
+
+#include <stdint.h>
+#include <string>
+
+namespace Mantids30 { namespace Sessions {
+
+/**
+ * @brief The SessionStore_SharedMemory class keeps the sessions in a POSIX shared memory table (shm_open + mmap)
+ *        so every worker process on the host can resolve them.
+ *
+ * The table is an open addressing hash (FNV-1a, linear probing) of fixed size slots. Probing is bounded (256 slots),
+ * and the tombstones left by removed sessions are emptied again as soon as the slot after them is empty, so a lookup
+ * miss stays short whatever the table history is (size the table well above the expected number of sessions).
+ *
+ * Each slot is protected by a sequence lock: readers never lock, they copy the slot and retry if its sequence changed
+ * (or was odd) meanwhile, and writers take the slot by atomically moving its sequence from even to odd. Lookups don't contend
+ * with each other, and a writer only blocks the slot it is writing.
+ *
+ * The first process that opens the table creates and sizes it, the others attach to it using the stored geometry.
+ * A session is written by a single process at a time (the one that created it or refreshes its activity), and
+ * spinning on a slot is bounded, so a process that died in the middle of a write can't hang the others.
+ *
+ * The table is not available on Windows (open() fails).
+ */
+class SessionStore_SharedMemory : public SessionStore
+{
+public:
+    SessionStore_SharedMemory() = default;
+    ~SessionStore_SharedMemory() override;
+
+    /**
+     * @brief open Creates or attaches to the shared memory table.
+     * @param name shared memory object name (eg. "/myapp-sessions").
+     * @param slotCount number of slots (maximum number of sessions), only used when the table is created.
+     * @param slotDataSize bytes available for the token payload and the client info of each session,
+     *                     only used when the table is created.
+     * @return true if the table is ready.
+     */
+    bool open(const std::string & name, const uint32_t & slotCount = 65536, const uint32_t & slotDataSize = 4096);
+    /**
+     * @brief close Detaches from the table (the table is kept for the other processes).
+     */
+    void close();
+    /**
+     * @brief unlink Removes the shared memory object (the processes already attached keep their mapping).
+     */
+    static bool unlink(const std::string & name);
+
+    bool isOpen() const { return m_table != nullptr; }
+    uint32_t getSlotCount() const { return m_slotCount; }
+
+    bool put(const StoredSession & session) override;
+    bool get(const std::string & sessionID, StoredSession & session) override;
+    bool getLastActivity(const std::string & sessionID, time_t & lastActivity) override;
+    bool touch(const std::string & sessionID, const time_t & lastActivity) override;
+    bool remove(const std::string & sessionID) override;
+    size_t removeInactive(const time_t & lastActivityBefore) override;
+    void forEach(const std::function<void(const StoredSession &)> & fn) override;
+
+    /**
+     * @brief Maximum session ID length accepted by the table.
+     */
+    static constexpr size_t MAX_SESSIONID_LEN = 63;
+
+private:
+    struct TableHeader;
+    struct Slot;
+    struct SlotView;
+
+    Slot * getSlot(const uint32_t & idx) const;
+    int64_t findSlot(const std::string & sessionID) const;
+    uint32_t getMaxProbes() const;
+    void clearTombstones(uint32_t idx);
+
+    bool readSlot(Slot * slot, SlotView & view, bool withData) const;
+    bool lockSlot(Slot * slot) const;
+    void unlockSlot(Slot * slot) const;
+    bool slotMatches(Slot * slot, const std::string & sessionID) const;
+
+    static uint64_t hashSessionID(const std::string & sessionID);
+
+    void * m_table = nullptr;
+    size_t m_tableSize = 0;
+    uint32_t m_slotCount = 0;
+    uint32_t m_slotDataSize = 0;
+    size_t m_slotStride = 0;
+};
+
+}}
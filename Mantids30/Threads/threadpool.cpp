@@ -1,8 +1,35 @@
 #include "threadpool.h"
 
 #include <Mantids30/Helpers/random.h>
+#include <Mantids30/Program_Metrics/registry.h>
 
 using namespace Mantids30::Threads::Pool;
+using namespace Mantids30::Program;
+
+namespace {
+
+struct PoolMetrics
+{
+    PoolMetrics()
+        : queuedTasks(Metrics::Registry::getDefault().gauge("mantids30_threadpool_queued_tasks", "Tasks waiting in the thread pool queues."))
+        , queueWait(Metrics::Registry::getDefault().histogram("mantids30_threadpool_queue_wait_seconds", "Time spent by the tasks in the thread pool queues.",
+                                                               Metrics::Histogram::latencyLayout()))
+        , rejectedTasks(Metrics::Registry::getDefault().counter("mantids30_threadpool_rejected_tasks_total", "Tasks not inserted (full queue timeout or pool stopping)."))
+    {
+    }
+
+    Metrics::Gauge & queuedTasks;
+    Metrics::Histogram & queueWait;
+    Metrics::Counter & rejectedTasks;
+};
+
+PoolMetrics & getMetrics()
+{
+    static PoolMetrics metrics;
+    return metrics;
+}
+
+}
 
 ThreadPool::ThreadPool(uint32_t threadsCount, uint32_t taskQueues)
 {
@@ -52,7 +79,10 @@ bool ThreadPool::pushTask(void (*task)(std::shared_ptr<void>), std::shared_ptr<v
 
     // Don't insert on termination...
     if (m_terminate)
+    {
+        getMetrics().rejectedTasks.add();
         return false;
+    }
 
     // Check if the queue is up the limit
     while ( m_queues[currentQueue].tasks.size() > m_maxTasksPerQueue  )
@@ -65,6 +95,7 @@ bool ThreadPool::pushTask(void (*task)(std::shared_ptr<void>), std::shared_ptr<v
         {
             if (m_queues[currentQueue].cond_removedElement.wait_for(lk, std::chrono::milliseconds(timeoutMS)) == std::cv_status::timeout)
             {
+                getMetrics().rejectedTasks.add();
                 return false;
             }
         }
@@ -74,7 +105,9 @@ bool ThreadPool::pushTask(void (*task)(std::shared_ptr<void>), std::shared_ptr<v
     Task toInsert;
     toInsert.data = taskData;
     toInsert.task = task;
+    toInsert.queuedTime = std::chrono::steady_clock::now();
     m_queues[currentQueue].tasks.push( toInsert );
+    getMetrics().queuedTasks.increment();
 
     // Notify that there is one element in one of the lists...
     lk.unlock();
@@ -94,17 +127,16 @@ ThreadPool::Task ThreadPool::popTask()
     TasksQueue * tq = getRandomTaskQueueWithElements();
     while ( tq == nullptr )
     {
-        // No available elements...
-        m_insertedElementCond.wait(lk);
-
-        // On termination, empty queue means exit
-        if ( m_terminate && (tq=getRandomTaskQueueWithElements()) == nullptr)
+        // On termination, empty queue means exit (checked before waiting, the termination is notified only once)
+        if ( m_terminate )
         {
             Task r;
             return r;
         }
-        else if (!m_terminate)
-            tq = getRandomTaskQueueWithElements();
+
+        // No available elements...
+        m_insertedElementCond.wait(lk);
+        tq = getRandomTaskQueueWithElements();
     }
 
     Task r= tq->tasks.front();
@@ -113,6 +145,9 @@ ThreadPool::Task ThreadPool::popTask()
     // Notify!
     lk.unlock();
     tq->cond_removedElement.notify_one();
+
+    getMetrics().queuedTasks.decrement();
+    getMetrics().queueWait.observeSince(r.queuedTime);
     return r;
 }
 
@@ -179,10 +214,12 @@ void ThreadPool::setMaxTasksPerQueue(const uint32_t &value)
 
 void ThreadPool::taskProcessor(ThreadPool *tp)
 {
-    for (Task task = tp->popTask();
-         !task.isNull();
-         task = tp->popTask())
+    for (;;)
     {
+        // The task (and its data) is released right after being executed, not when the next one arrives:
+        Task task = tp->popTask();
+        if (task.isNull())
+            break;
         //std::cout << "ejecutando " << task.data << std::endl << std::flush;
         task.task(task.data);
     }
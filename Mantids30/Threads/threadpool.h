@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <random>
@@ -14,9 +15,11 @@ namespace Mantids30 { namespace Threads {
 namespace Pool {
 
 
-// TODO: statistics
 /**
  * @brief Advanced Thread Pool.
+ *
+ * Reports the queued tasks, the time spent by the tasks in the queues and the rejected insertions to the default
+ * metrics registry (Program::Metrics).
  */
 class ThreadPool
 {
@@ -37,6 +40,7 @@ public:
 
         void (*task) (std::shared_ptr<void>);
         std::shared_ptr<void> data;
+        std::chrono::steady_clock::time_point queuedTime;
     };
 
     struct TasksQueue
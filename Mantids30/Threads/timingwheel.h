@@ -0,0 +1,105 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <vector>
+#include <time.h>
+
+namespace Mantids30 { namespace Threads { namespace Safe {
+
+/**
+ * @brief The TimingWheel class provides a thread-safe timer wheel for expiring keys.
+ *
+ * Keys are hashed into one slot per second of their deadline (modulo the number of slots), so scheduling
+ * is O(1) and advancing the wheel only visits the slots that became due since the last advance, instead of
+ * scanning every key. Deadlines beyond one full rotation simply stay in their slot until their round comes.
+ *
+ * The wheel does not support removals: owners are expected to treat the returned keys as "candidates",
+ * verify them (eg. the element was already destroyed or its activity was refreshed) and schedule them
+ * again if needed. This keeps the hot path (activity updates) free of any wheel operation.
+ *
+ * @tparam T The type of the keys.
+ */
+template <class T>
+class TimingWheel
+{
+public:
+    /**
+     * @brief Constructs a new TimingWheel.
+     * @param slots Number of one second slots (one rotation), should be near the usual expiration time.
+     */
+    TimingWheel(const size_t & slots = 1024)
+    {
+        m_slots.resize(slots?slots:1);
+        m_lastAdvance = time(nullptr);
+    }
+
+    /**
+     * @brief schedule Schedules the key to be returned by advance() once the deadline is reached.
+     * @param key The key.
+     * @param deadline Unix time where the key becomes due.
+     */
+    void schedule(const T & key, const time_t & deadline)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Never schedule into an already processed slot.
+        time_t slotTime = deadline>m_lastAdvance ? deadline : m_lastAdvance+1;
+        m_slots[static_cast<size_t>(slotTime) % m_slots.size()].push_back( {key, deadline} );
+        m_count++;
+    }
+
+    /**
+     * @brief advance Moves the wheel up to the given time.
+     * @param now Current unix time.
+     * @return The keys whose deadline is lower or equal than now.
+     */
+    std::list<T> advance(const time_t & now)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::list<T> due;
+
+        if (now <= m_lastAdvance)
+            return due;
+
+        // Visit each elapsed slot once (at most one full rotation).
+        size_t steps = static_cast<size_t>(now - m_lastAdvance);
+        if (steps > m_slots.size())
+            steps = m_slots.size();
+
+        for (size_t i=1; i<=steps; i++)
+        {
+            auto & slot = m_slots[static_cast<size_t>(now - steps + i) % m_slots.size()];
+            for (auto it = slot.begin(); it != slot.end();)
+            {
+                if (it->second <= now)
+                {
+                    due.push_back(it->first);
+                    it = slot.erase(it);
+                    m_count--;
+                }
+                else
+                    it++;
+            }
+        }
+
+        m_lastAdvance = now;
+        return due;
+    }
+
+    /**
+     * @brief size Number of scheduled entries (including the ones that the owner may consider stale).
+     */
+    size_t size()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+
+private:
+    std::vector<std::list<std::pair<T,time_t>>> m_slots;
+    time_t m_lastAdvance;
+    size_t m_count = 0;
+    std::mutex m_mutex;
+};
+
+}}}
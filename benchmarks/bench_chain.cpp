@@ -0,0 +1,201 @@
+#include "benchmark.h"
+
+#include <Mantids30/Net_Chains/socket_chain.h>
+#include <Mantids30/Net_Chains/socket_chain_aes.h>
+#include <Mantids30/Net_Chains/socket_chain_tls.h>
+
+#include <memory>
+#include <thread>
+
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Network::Sockets;
+
+namespace {
+
+enum eLayers
+{
+    LAYERS_AES,
+    LAYERS_TLS_OVER_AES
+};
+
+const size_t blockSize = 64 * 1024;
+
+std::string bioToString(BIO * bio)
+{
+    char * data = nullptr;
+    long len = BIO_get_mem_data(bio, &data);
+    return std::string(data, static_cast<size_t>(len));
+}
+
+// Self-signed RSA-2048 certificate for the TLS server end (the client does not validate it):
+bool createCertificate(std::string & privateKey, std::string & certificate)
+{
+    EVP_PKEY * key = EVP_RSA_gen(2048);
+    X509 * x509 = X509_new();
+    bool r = key && x509;
+    if (r)
+    {
+        X509_set_version(x509, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+        X509_gmtime_adj(X509_getm_notBefore(x509), 0);
+        X509_gmtime_adj(X509_getm_notAfter(x509), 86400);
+        X509_set_pubkey(x509, key);
+        X509_NAME * name = X509_get_subject_name(x509);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("benchmark"), -1, -1, 0);
+        X509_set_issuer_name(x509, name);
+        r = X509_sign(x509, key, EVP_sha256()) > 0;
+    }
+    if (r)
+    {
+        BIO * privateBio = BIO_new(BIO_s_mem());
+        BIO * certificateBio = BIO_new(BIO_s_mem());
+        r = PEM_write_bio_PrivateKey(privateBio, key, nullptr, nullptr, 0, nullptr, nullptr) == 1 && PEM_write_bio_X509(certificateBio, x509) == 1;
+        if (r)
+        {
+            privateKey = bioToString(privateBio);
+            certificate = bioToString(certificateBio);
+        }
+        BIO_free(privateBio);
+        BIO_free(certificateBio);
+    }
+    X509_free(x509);
+    EVP_PKEY_free(key);
+    return r;
+}
+
+// One end of the chain (the chain is declared last, so it goes down before its elements):
+struct ChainEnd
+{
+    // Holds the server keys (as the listening socket does for the accepted TLS connections):
+    std::shared_ptr<Socket_TLS> tlsKeysHolder;
+    std::shared_ptr<ChainProtocols::Socket_Chain_AES> aes;
+    std::shared_ptr<ChainProtocols::Socket_Chain_TLS> tls;
+    std::shared_ptr<Socket_Chain> chain;
+};
+
+bool startChainEnd(ChainEnd & end, std::shared_ptr<Socket_Stream> baseSocket, Socket_Chain::eChainMode chainMode, eLayers layers,
+                   ChainProtocols::Socket_Chain_AES::eKeystreamMode keystreamMode, bool serverMode, const std::string & privateKey,
+                   const std::string & certificate)
+{
+    end.chain = std::make_shared<Socket_Chain>(baseSocket, true, chainMode);
+
+    end.aes = std::make_shared<ChainProtocols::Socket_Chain_AES>();
+    end.aes->setPhase1Key("benchmark");
+    end.aes->setKeystreamMode(keystreamMode);
+    end.aes->setServerMode(serverMode);
+    if (!end.chain->addToChain(end.aes.get()))
+        return false;
+
+    if (layers == LAYERS_TLS_OVER_AES)
+    {
+        end.tls = std::make_shared<ChainProtocols::Socket_Chain_TLS>();
+        end.tls->ChainProtocols::Socket_Chain_ProtocolBase::setServerMode(serverMode);
+        if (serverMode)
+        {
+            end.tlsKeysHolder = std::make_shared<Socket_TLS>();
+            if (!end.tlsKeysHolder->tlsKeys.loadPrivateKeyFromPEMMemory(privateKey.c_str())
+                || !end.tlsKeysHolder->tlsKeys.loadPublicKeyFromPEMMemory(certificate.c_str()))
+                return false;
+            end.tls->setTLSParent(end.tlsKeysHolder.get());
+        }
+        if (!end.chain->addToChain(end.tls.get()))
+            return false;
+    }
+    return true;
+}
+
+// Socket pair layers are only finished when both sockets of each pair are down (TLS does not shut its socket down):
+void stopChainEnd(ChainEnd & end)
+{
+    end.chain->shutdownSocket(SHUT_RDWR);
+    for (size_t i = 0; i < end.chain->getLayers(); i++)
+    {
+        auto layer = end.chain->getSocketPairLayer(i);
+        if (layer.second)
+            layer.second->shutdownSocket(SHUT_RDWR);
+    }
+}
+
+// Streams 64KB blocks from one end of the chain to the other over a local socket pair:
+void chainThroughput(Recorder & recorder, Socket_Chain::eChainMode chainMode, eLayers layers,
+                     ChainProtocols::Socket_Chain_AES::eKeystreamMode keystreamMode)
+{
+    recorder.setParameter("mode", chainMode == Socket_Chain::CHAIN_MODE_PIPELINE ? "pipeline" : "socketpair");
+    recorder.setParameter("layers", layers == LAYERS_TLS_OVER_AES ? "tls+aes" : "aes");
+    recorder.setParameter("keystream", keystreamMode == ChainProtocols::Socket_Chain_AES::KEYSTREAM_CTR ? "ctr" : "legacy");
+    recorder.setParameter("blockSize", static_cast<Json::UInt64>(blockSize));
+
+    std::string privateKey, certificate;
+    if (layers == LAYERS_TLS_OVER_AES && !createCertificate(privateKey, certificate))
+    {
+        recorder.fail("failed to create the TLS certificate");
+        return;
+    }
+
+    auto pair = Socket_Stream::GetSocketPair();
+    if (!pair.first || !pair.second)
+    {
+        recorder.fail("socketpair failed");
+        return;
+    }
+
+    // Both handshakes need each other:
+    ChainEnd client, server;
+    bool serverStarted = false;
+    std::thread serverThread([&]() { serverStarted = startChainEnd(server, pair.second, chainMode, layers, keystreamMode, true, privateKey, certificate); });
+    bool clientStarted = startChainEnd(client, pair.first, chainMode, layers, keystreamMode, false, privateKey, certificate);
+    serverThread.join();
+
+    if (!clientStarted || !serverStarted)
+    {
+        stopChainEnd(client);
+        stopChainEnd(server);
+        recorder.fail("chain initialization failed");
+        return;
+    }
+
+    std::thread receiver([&]() {
+        std::unique_ptr<char[]> buffer(new char[blockSize]);
+        while (server.chain->partialRead(buffer.get(), blockSize) > 0)
+        {
+        }
+    });
+
+    std::string block(blockSize, 'x');
+    recorder.measure([&]() { return client.chain->writeFull(block.data(), block.size()); }, 1, blockSize);
+
+    stopChainEnd(client);
+    receiver.join();
+    stopChainEnd(server);
+}
+
+}
+
+static void socketPairTLSOverAES(Recorder & recorder)
+{
+    chainThroughput(recorder, Socket_Chain::CHAIN_MODE_SOCKETPAIR, LAYERS_TLS_OVER_AES, ChainProtocols::Socket_Chain_AES::KEYSTREAM_LEGACY);
+}
+
+static void pipelineTLSOverAES(Recorder & recorder)
+{
+    chainThroughput(recorder, Socket_Chain::CHAIN_MODE_PIPELINE, LAYERS_TLS_OVER_AES, ChainProtocols::Socket_Chain_AES::KEYSTREAM_LEGACY);
+}
+
+static void pipelineAESLegacy(Recorder & recorder)
+{
+    chainThroughput(recorder, Socket_Chain::CHAIN_MODE_PIPELINE, LAYERS_AES, ChainProtocols::Socket_Chain_AES::KEYSTREAM_LEGACY);
+}
+
+static void pipelineAESCTR(Recorder & recorder)
+{
+    chainThroughput(recorder, Socket_Chain::CHAIN_MODE_PIPELINE, LAYERS_AES, ChainProtocols::Socket_Chain_AES::KEYSTREAM_CTR);
+}
+
+MANTIDS_BENCHMARK("chain/socketpair_tls_over_aes_64k", socketPairTLSOverAES)
+MANTIDS_BENCHMARK("chain/pipeline_tls_over_aes_64k", pipelineTLSOverAES)
+MANTIDS_BENCHMARK("chain/pipeline_aes_legacy_64k", pipelineAESLegacy)
+MANTIDS_BENCHMARK("chain/pipeline_aes_ctr_64k", pipelineAESCTR)
@@ -0,0 +1,291 @@
+#include "benchmark.h"
+
+#include <Mantids30/DataFormat_JWT/jwt.h>
+#include <Mantids30/Net_Sockets/socket_tcp.h>
+#include <Mantids30/Protocol_FastRPC3/fastrpc3.h>
+
+#include <list>
+#include <thread>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Network;
+using namespace Mantids30::Network::Protocols::FastRPC;
+
+namespace {
+
+json echo(void *, std::shared_ptr<Sessions::Session>, const json & parameters)
+{
+    return parameters;
+}
+
+json notify(void * context, std::shared_ptr<Sessions::Session>, const json &)
+{
+    (*static_cast<std::atomic<uint64_t> *>(context))++;
+    return json();
+}
+
+}
+
+static void fastRPC3Loopback(Recorder & recorder, const size_t & payloadSize)
+{
+    const uint32_t clients = recorder.getOptions().clientThreads;
+
+    auto listener = std::make_shared<Sockets::Socket_TCP>();
+    if (!listener->listenOn(0, "127.0.0.1"))
+    {
+        recorder.skip("unable to listen on the loopback interface");
+        return;
+    }
+    uint16_t port = listener->getPort();
+
+    auto jwt = std::make_shared<DataFormat::JWT>(DataFormat::JWT::HS256);
+    jwt->setSharedSecret("benchmark shared secret with enough entropy");
+
+    FastRPC3 server(jwt, std::max(4U, std::thread::hardware_concurrency()), 64);
+    FastRPC3 client(4, 64);
+
+    API::Monolith::MethodsHandler::MethodDefinition echoDef;
+    echoDef.method = {&echo, nullptr};
+    echoDef.methodName = "echo";
+    echoDef.isActiveSessionRequired = false;
+    echoDef.doUsageUpdateLastSessionActivity = false;
+    server.config.methodHandlers->addMethod(echoDef);
+
+    // One connection (the RPC calls are multiplexed over it):
+    std::thread serverThread([&]() {
+        std::shared_ptr<Sockets::Socket_Stream> stream = listener->acceptConnection();
+        if (stream)
+            server.handleClientConnection(stream);
+    });
+
+    auto clientStream = std::make_shared<Sockets::Socket_TCP>();
+    if (!clientStream->connectTo("127.0.0.1", port))
+    {
+        listener->shutdownSocket();
+        serverThread.join();
+        recorder.skip("unable to connect to the loopback interface");
+        return;
+    }
+    std::thread clientThread([&]() { client.handleServerConnection(clientStream); });
+
+    for (int i = 0; i < 500 && !client.doesConnectionExist("SERVER"); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // Methods are only executed within a session (shared by every call of this connection):
+    DataFormat::JWT::Token token;
+    token.setSubject("benchmark");
+    token.setDomain("localhost");
+    token.setExpirationTime(time(nullptr) + 3600);
+    json loginError;
+    client.remote("SERVER").loginViaJWTToken(jwt->signFromToken(token), &loginError);
+    const bool loggedIn = JSON_ASBOOL(loginError, "succeed", false);
+
+    json payload;
+    payload["data"] = std::string(payloadSize, 'x');
+
+    recorder.setParameter("clients", clients);
+    recorder.setParameter("payloadSize", static_cast<Json::UInt64>(payloadSize));
+
+    using Clock = std::chrono::steady_clock;
+    std::atomic<bool> measuring{false}, running{true};
+    std::atomic<uint64_t> errors{0};
+    std::vector<std::vector<uint64_t>> samples(clients);
+    std::vector<std::thread> threads;
+
+    for (uint32_t c = 0; loggedIn && c < clients; c++)
+    {
+        threads.emplace_back([&, c]() {
+            samples[c].reserve(1 << 18);
+            while (running)
+            {
+                json error;
+                auto start = Clock::now();
+                json answer = client.remote("SERVER").executeTask("echo", payload, &error, false);
+                uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+                if (!JSON_ASBOOL(error, "succeed", false))
+                {
+                    errors++;
+                    if (!client.doesConnectionExist("SERVER"))
+                        return;
+                    continue;
+                }
+                if (measuring)
+                    samples[c].push_back(elapsed);
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(recorder.getOptions().warmUpMS));
+    recorder.begin();
+    measuring = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(recorder.getOptions().durationMS));
+    measuring = false;
+    recorder.finish(payloadSize);
+    running = false;
+
+    for (auto & thread : threads)
+        thread.join();
+    for (const auto & clientSamples : samples)
+        recorder.addSamples(clientSamples);
+
+    // Failed calls (eg. timeouts) are reported, but they are not part of the latency samples:
+    recorder.setParameter("errors", static_cast<Json::UInt64>(errors));
+
+    clientStream->shutdownSocket();
+    clientThread.join();
+    serverThread.join();
+    listener->shutdownSocket();
+
+    size_t measured = 0;
+    for (const auto & clientSamples : samples)
+        measured += clientSamples.size();
+    if (!loggedIn)
+        recorder.fail("login failed: " + JSON_ASSTRING(loginError, "errorMessage", ""));
+    else if (!measured)
+        recorder.fail("no remote call succeeded");
+}
+
+static void fastRPC3Small(Recorder & recorder)
+{
+    fastRPC3Loopback(recorder, 64);
+}
+
+static void fastRPC3Large(Recorder & recorder)
+{
+    fastRPC3Loopback(recorder, 64 * 1024);
+}
+
+// One notification to every peer logged in with a role, until all of them received it:
+static void fastRPC3Fanout(Recorder & recorder, const bool & usePush)
+{
+    const size_t peers = 32;
+
+    auto listener = std::make_shared<Sockets::Socket_TCP>();
+    if (!listener->listenOn(0, "127.0.0.1", 0, static_cast<int32_t>(peers)))
+    {
+        recorder.skip("unable to listen on the loopback interface");
+        return;
+    }
+    uint16_t port = listener->getPort();
+
+    auto jwt = std::make_shared<DataFormat::JWT>(DataFormat::JWT::HS256);
+    jwt->setSharedSecret("benchmark shared secret with enough entropy");
+
+    FastRPC3 server(jwt, 4, 64);
+
+    std::list<std::thread> serverThreads;
+    std::thread acceptorThread([&]() {
+        for (size_t i = 0; i < peers; i++)
+        {
+            std::shared_ptr<Sockets::Socket_Stream> stream = listener->acceptConnection();
+            if (!stream)
+                return;
+            stream->deriveConnectionName();
+            serverThreads.emplace_back([&server, stream]() { server.handleClientConnection(stream); });
+        }
+    });
+
+    std::atomic<uint64_t> received{0};
+    API::Monolith::MethodsHandler::MethodDefinition notifyDef;
+    notifyDef.method = {&notify, &received};
+    notifyDef.methodName = "notify";
+    notifyDef.isActiveSessionRequired = false;
+    notifyDef.doUsageUpdateLastSessionActivity = false;
+
+    DataFormat::JWT::Token token;
+    token.setSubject("benchmark");
+    token.setDomain("localhost");
+    token.addRole("operator");
+    token.setExpirationTime(time(nullptr) + 3600);
+    const std::string signedToken = jwt->signFromToken(token);
+
+    std::list<std::unique_ptr<FastRPC3>> clients;
+    std::list<std::shared_ptr<Sockets::Socket_TCP>> clientStreams;
+    std::list<std::thread> clientThreads;
+    for (size_t i = 0; i < peers; i++)
+    {
+        clients.push_back(std::make_unique<FastRPC3>(jwt, 1, 64));
+        FastRPC3 *client = clients.back().get();
+        client->config.methodHandlers->addMethod(notifyDef);
+
+        auto clientStream = std::make_shared<Sockets::Socket_TCP>();
+        if (!clientStream->connectTo("127.0.0.1", port))
+            break;
+        clientStreams.push_back(clientStream);
+        clientThreads.emplace_back([client, clientStream]() { client->handleServerConnection(clientStream); });
+
+        for (int t = 0; t < 500 && !client->doesConnectionExist("SERVER"); t++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        client->remote("SERVER").loginViaJWTToken(signedToken);
+    }
+
+    for (int t = 0; t < 500 && server.listConnectionIdsByRole("operator", "localhost").size() != peers; t++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    bool ready = server.listConnectionIdsByRole("operator", "localhost").size() == peers;
+
+    // The notifications are also executed within a session (in the other direction):
+    for (const auto & connectionId : server.listActiveConnectionIds())
+    {
+        json loginError;
+        server.remote(connectionId).loginViaJWTToken(signedToken, &loginError);
+        ready = ready && JSON_ASBOOL(loginError, "succeed", false);
+    }
+
+    json payload;
+    payload["event"] = "updated";
+    payload["data"] = std::string(256, 'x');
+
+    recorder.setParameter("peers", static_cast<Json::UInt64>(peers));
+    recorder.setParameter("mode", usePush ? "pushToRole" : "executeTask");
+
+    uint64_t expected = 0;
+    if (ready)
+    {
+        recorder.measure([&]() {
+            if (usePush)
+                server.pushToRole("operator", "localhost", "notify", payload);
+            else
+            {
+                for (const auto & connectionId : server.listConnectionIdsByRole("operator", "localhost"))
+                    server.remote(connectionId).executeTask("notify", payload, nullptr, false);
+            }
+            expected += peers;
+            for (int t = 0; received < expected; t++)
+            {
+                if (t > 5000000)
+                    return false;
+                std::this_thread::yield();
+            }
+            return true;
+        });
+    }
+
+    for (auto & clientStream : clientStreams)
+        clientStream->shutdownSocket();
+    for (auto & thread : clientThreads)
+        thread.join();
+    acceptorThread.join();
+    for (auto & thread : serverThreads)
+        thread.join();
+    listener->shutdownSocket();
+
+    if (!ready)
+        recorder.fail("the peers were not indexed by role");
+}
+
+static void fastRPC3PushFanout(Recorder & recorder)
+{
+    fastRPC3Fanout(recorder, true);
+}
+
+static void fastRPC3ExecuteFanout(Recorder & recorder)
+{
+    fastRPC3Fanout(recorder, false);
+}
+
+MANTIDS_BENCHMARK("fastrpc3/loopback_echo_64", fastRPC3Small)
+MANTIDS_BENCHMARK("fastrpc3/loopback_echo_64k", fastRPC3Large)
+MANTIDS_BENCHMARK("fastrpc3/fanout_push_32", fastRPC3PushFanout)
+MANTIDS_BENCHMARK("fastrpc3/fanout_execute_32", fastRPC3ExecuteFanout)
@@ -0,0 +1,170 @@
+#include "benchmark.h"
+
+#include <Mantids30/Net_Sockets/socket_stream_dummy.h>
+#include <Mantids30/Net_Sockets/socket_tcp.h>
+#include <Mantids30/Protocol_HTTP/httpv1_server.h>
+#include <Mantids30/Server_RESTfulWebAPI/engine.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Network;
+
+static const std::string httpRequest =
+    "GET /api/v1/ping?item=10&filter=active HTTP/1.1\r\n"
+    "Host: 127.0.0.1\r\n"
+    "User-Agent: Mantids30-benchmarks\r\n"
+    "Accept: application/json\r\n"
+    "Accept-Language: en-US,en;q=0.5\r\n"
+    "Cookie: theme=dark; lang=en\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+static void httpv1ServerParse(Recorder & recorder)
+{
+    recorder.setParameter("requestSize", static_cast<Json::UInt64>(httpRequest.size()));
+    recorder.measure([&]() {
+        // The dummy socket reads from its "sender" container and writes into the "receiver" one.
+        auto stream = std::make_shared<Sockets::Socket_Stream_Dummy>();
+        if (!stream->getSender()->append(httpRequest.data(), httpRequest.size()))
+            return false;
+
+        Protocols::HTTP::HTTPv1_Server server(stream);
+        Memory::Streams::Parser::ErrorMSG err;
+        server.parseObject(&err);
+        return err == Memory::Streams::Parser::PARSING_SUCCEED && stream->getReceiver()->size() > 0;
+    }, 1, httpRequest.size());
+}
+
+namespace {
+
+void ping(void *, API::APIReturn &response, const API::RESTful::RequestParameters &, Sessions::ClientDetails &)
+{
+    json body;
+    body["pong"] = true;
+    response = body;
+}
+
+// Sends one request (one connection, as the server closes it) and reads the response until the server closes:
+bool loopbackRequest(const uint16_t & port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return false;
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    bool r = connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0
+             && send(fd, httpRequest.data(), httpRequest.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(httpRequest.size());
+
+    char response[4096];
+    size_t responseSize = 0;
+    while (r)
+    {
+        ssize_t n = recv(fd, response + responseSize, sizeof(response) - responseSize, 0);
+        if (n <= 0)
+            break;
+        responseSize += static_cast<size_t>(n);
+        if (responseSize == sizeof(response))
+            responseSize = 16; // (only the status line is checked)
+    }
+    close(fd);
+
+    return r && responseSize > 12 && !memcmp(response, "HTTP/1.1 200", 12);
+}
+
+}
+
+static void restfulLoopback(Recorder & recorder)
+{
+    auto listener = std::make_shared<Sockets::Socket_TCP>();
+    if (!listener->listenOn(0, "127.0.0.1", 0, 1024))
+    {
+        recorder.skip("unable to listen on the loopback interface");
+        return;
+    }
+    uint16_t port = listener->getPort();
+
+    auto engine = std::make_shared<Servers::RESTful::Engine>();
+    auto jwt = std::make_shared<DataFormat::JWT>(DataFormat::JWT::HS256);
+    jwt->setSharedSecret("benchmark shared secret with enough entropy");
+    engine->config.jwtSigner = jwt;
+    engine->config.jwtValidator = jwt;
+
+    API::RESTful::RESTfulAPIDefinition pingDef;
+    pingDef.method = &ping;
+    pingDef.security.requireJWTHeaderAuthentication = false;
+    pingDef.security.requireJWTCookieAuthentication = false;
+    auto handler = std::make_shared<API::RESTful::MethodsHandler>();
+    handler->addResource(API::RESTful::MethodsHandler::GET, "ping", pingDef);
+    engine->methodsHandler[1] = handler;
+
+    const uint32_t clients = recorder.getOptions().clientThreads;
+    engine->setAcceptPoolThreaded(listener, std::max(4U, std::thread::hardware_concurrency()), 1000);
+    engine->startInBackground();
+
+    recorder.setParameter("clients", clients);
+    recorder.setParameter("keepAlive", false);
+
+    if (!loopbackRequest(port))
+    {
+        recorder.fail("the RESTful server did not answer the ping resource");
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    std::atomic<bool> measuring{false}, running{true}, failed{false};
+    std::vector<std::vector<uint64_t>> samples(clients);
+    std::vector<std::thread> threads;
+
+    for (uint32_t c = 0; c < clients; c++)
+    {
+        threads.emplace_back([&, c]() {
+            samples[c].reserve(1 << 18);
+            while (running)
+            {
+                auto start = Clock::now();
+                if (!loopbackRequest(port))
+                {
+                    failed = true;
+                    return;
+                }
+                if (measuring)
+                    samples[c].push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(recorder.getOptions().warmUpMS));
+    recorder.begin();
+    measuring = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(recorder.getOptions().durationMS));
+    measuring = false;
+    recorder.finish();
+    running = false;
+
+    for (auto & thread : threads)
+        thread.join();
+    for (const auto & clientSamples : samples)
+        recorder.addSamples(clientSamples);
+
+    if (failed)
+        recorder.fail("a client request failed");
+}
+
+MANTIDS_BENCHMARK("http/httpv1_server_parse", httpv1ServerParse)
+MANTIDS_BENCHMARK("http/restful_loopback_get", restfulLoopback)
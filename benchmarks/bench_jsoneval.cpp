@@ -0,0 +1,55 @@
+#include "benchmark.h"
+
+#include <Mantids30/Scripts_JSONExprEval/jsoneval.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Scripts::Expressions;
+
+static const char * rule = "IS_EQUAL($.user.name,\"admin\") && STARTS_WITH($.request.path,\"/api/\")"
+                           " && (CONTAINS($.user.roles,\"operator\") || IS_EQUAL($.user.domain,\"localhost\"))";
+
+static json createDocument()
+{
+    json values;
+    values["user"]["name"] = "admin";
+    values["user"]["domain"] = "example.com";
+    values["user"]["roles"].append("viewer");
+    values["user"]["roles"].append("operator");
+    values["request"]["path"] = "/api/v1/users";
+    values["request"]["method"] = "GET";
+    return values;
+}
+
+static void evaluateBytecode(Recorder & recorder)
+{
+    JSONEval expression;
+    if (!expression.compile(rule))
+    {
+        recorder.fail("compile failed: " + expression.getLastCompilerError());
+        return;
+    }
+    json values = createDocument();
+
+    recorder.measure([&]() {
+        return expression.evaluate(values);
+    }, 16);
+}
+
+static void evaluateTree(Recorder & recorder)
+{
+    JSONEval expression;
+    if (!expression.compile(rule))
+    {
+        recorder.fail("compile failed: " + expression.getLastCompilerError());
+        return;
+    }
+    json values = createDocument();
+
+    recorder.measure([&]() {
+        return expression.evaluateTree(values);
+    }, 16);
+}
+
+MANTIDS_BENCHMARK("jsoneval/evaluate_bytecode", evaluateBytecode)
+MANTIDS_BENCHMARK("jsoneval/evaluate_tree", evaluateTree)
@@ -0,0 +1,135 @@
+#include "benchmark.h"
+
+#include <Mantids30/DataFormat_JWT/jwt.h>
+#include <Mantids30/Helpers/encoders.h>
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+
+static Json::Value createPayload()
+{
+    Json::Value payload;
+    payload["sub"] = "admin";
+    payload["iss"] = "benchmarks";
+    payload["domain"] = "localhost";
+    payload["exp"] = static_cast<Json::Int64>(time(nullptr) + 3600);
+    payload["iat"] = static_cast<Json::Int64>(time(nullptr));
+    payload["permissions"]["APP"].append("READ");
+    payload["permissions"]["APP"].append("WRITE");
+    payload["roles"].append("operator");
+    return payload;
+}
+
+static std::string bioToString(BIO * bio)
+{
+    char * data = nullptr;
+    long len = BIO_get_mem_data(bio, &data);
+    return std::string(data, static_cast<size_t>(len));
+}
+
+// Generates a RSA-2048 key pair (PEM) for the RS256 benchmarks:
+static bool createRSAKeyPair(std::string & privateKey, std::string & publicKey)
+{
+    EVP_PKEY * key = EVP_RSA_gen(2048);
+    if (!key)
+        return false;
+
+    BIO * privateBio = BIO_new(BIO_s_mem());
+    BIO * publicBio = BIO_new(BIO_s_mem());
+    bool r = PEM_write_bio_PrivateKey(privateBio, key, nullptr, nullptr, 0, nullptr, nullptr) == 1
+             && PEM_write_bio_PUBKEY(publicBio, key) == 1;
+    if (r)
+    {
+        privateKey = bioToString(privateBio);
+        publicKey = bioToString(publicBio);
+    }
+
+    BIO_free(privateBio);
+    BIO_free(publicBio);
+    EVP_PKEY_free(key);
+    return r;
+}
+
+static void hs256Sign(Recorder & recorder)
+{
+    DataFormat::JWT jwt(DataFormat::JWT::HS256);
+    jwt.setSharedSecret("benchmark shared secret with enough entropy");
+    Json::Value payload = createPayload();
+
+    recorder.measure([&]() {
+        std::string token = jwt.sign(payload);
+        return !token.empty();
+    });
+}
+
+static void hs256Verify(Recorder & recorder)
+{
+    DataFormat::JWT jwt(DataFormat::JWT::HS256);
+    jwt.setSharedSecret("benchmark shared secret with enough entropy");
+    std::string token = jwt.sign(createPayload());
+
+    recorder.setParameter("tokenSize", static_cast<Json::UInt64>(token.size()));
+    recorder.measure([&]() {
+        DataFormat::JWT::Token decoded;
+        return jwt.verify(token, &decoded);
+    });
+}
+
+static void rs256Verify(Recorder & recorder)
+{
+    std::string privateKey, publicKey;
+    if (!createRSAKeyPair(privateKey, publicKey))
+    {
+        recorder.fail("RSA key generation failed");
+        return;
+    }
+
+    DataFormat::JWT signer(DataFormat::JWT::RS256);
+    signer.setPrivateSecret(privateKey);
+    DataFormat::JWT validator(DataFormat::JWT::RS256);
+    validator.setPublicSecret(publicKey);
+
+    std::string token = signer.sign(createPayload());
+
+    recorder.setParameter("tokenSize", static_cast<Json::UInt64>(token.size()));
+    recorder.measure([&]() {
+        DataFormat::JWT::Token decoded;
+        return validator.verify(token, &decoded);
+    });
+}
+
+static void base64Encode(Recorder & recorder)
+{
+    std::string input(4096, '\0');
+    for (size_t i = 0; i < input.size(); i++)
+        input[i] = static_cast<char>(i * 31);
+    std::string output(Helpers::Encoders::getBase64EncodedLength(input.size()), '\0');
+
+    recorder.measure([&]() {
+        return Helpers::Encoders::encodeToBase64Buffer(reinterpret_cast<const unsigned char *>(input.data()), input.size(), output.data()) == output.size();
+    }, 16, input.size());
+}
+
+static void base64Decode(Recorder & recorder)
+{
+    std::string input(4096, '\0');
+    for (size_t i = 0; i < input.size(); i++)
+        input[i] = static_cast<char>(i * 31);
+    std::string encoded = Helpers::Encoders::encodeToBase64(input);
+    std::vector<unsigned char> output(Helpers::Encoders::getBase64DecodedMaxLength(encoded.size()));
+
+    recorder.measure([&]() {
+        size_t outLength = 0;
+        return Helpers::Encoders::decodeFromBase64Buffer(encoded.data(), encoded.size(), output.data(), outLength) && outLength == input.size();
+    }, 16, encoded.size());
+}
+
+MANTIDS_BENCHMARK("jwt/hs256_sign", hs256Sign)
+MANTIDS_BENCHMARK("jwt/hs256_verify", hs256Verify)
+MANTIDS_BENCHMARK("jwt/rs256_verify", rs256Verify)
+MANTIDS_BENCHMARK("jwt/base64_encode_4k", base64Encode)
+MANTIDS_BENCHMARK("jwt/base64_decode_4k", base64Decode)
@@ -0,0 +1,122 @@
+#include "benchmark.h"
+
+#include <Mantids30/Memory/b_chunks.h>
+#include <Mantids30/Memory/b_mem.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Memory::Containers;
+
+static const size_t haystackSize = 64 * 1024;
+static const char needle[] = "\r\n--boundary\r\n";
+
+// Haystack made of printable noise with the needle at the end (worst case for the search):
+static std::string createHaystack()
+{
+    std::string r(haystackSize, 'a');
+    for (size_t i = 0; i < r.size(); i++)
+        r[i] = static_cast<char>('a' + (i * 7 + i / 13) % 26);
+    r.replace(r.size() - (sizeof(needle) - 1), sizeof(needle) - 1, needle);
+    return r;
+}
+
+static void chunksAppend(Recorder & recorder)
+{
+    std::string piece(4096, 'x');
+    B_Chunks chunks;
+    size_t appended = 0;
+
+    recorder.setParameter("appendSize", static_cast<Json::UInt64>(piece.size()));
+    recorder.measure([&]() {
+        if (!chunks.append(piece.data(), piece.size()))
+            return false;
+        // Restart every 1MB (the clear is part of the measure):
+        if (++appended == 256)
+        {
+            chunks.clear();
+            appended = 0;
+        }
+        return true;
+    }, 64, piece.size());
+}
+
+static void chunksFind(Recorder & recorder)
+{
+    std::string haystack = createHaystack();
+    B_Chunks chunks;
+    // Append in network sized pieces, so the needle search crosses chunk boundaries:
+    for (size_t offset = 0; offset < haystack.size(); offset += 1460)
+        chunks.append(haystack.data() + offset, std::min<size_t>(1460, haystack.size() - offset));
+
+    recorder.setParameter("haystackSize", static_cast<Json::UInt64>(haystack.size()));
+    recorder.measure([&]() {
+        auto pos = chunks.find(needle, sizeof(needle) - 1);
+        return pos.has_value();
+    }, 1, haystack.size());
+}
+
+static void chunksFindCaseInsensitive(Recorder & recorder)
+{
+    std::string haystack = createHaystack();
+    B_Chunks chunks;
+    for (size_t offset = 0; offset < haystack.size(); offset += 1460)
+        chunks.append(haystack.data() + offset, std::min<size_t>(1460, haystack.size() - offset));
+
+    recorder.setParameter("haystackSize", static_cast<Json::UInt64>(haystack.size()));
+    recorder.measure([&]() {
+        auto pos = chunks.find("\r\n--BOUNDARY\r\n", sizeof(needle) - 1, false);
+        return pos.has_value();
+    }, 1, haystack.size());
+}
+
+static void chunksFindChar(Recorder & recorder)
+{
+    std::string haystack = createHaystack();
+    B_Chunks chunks;
+    for (size_t offset = 0; offset < haystack.size(); offset += 1460)
+        chunks.append(haystack.data() + offset, std::min<size_t>(1460, haystack.size() - offset));
+
+    recorder.setParameter("haystackSize", static_cast<Json::UInt64>(haystack.size()));
+    recorder.measure([&]() {
+        auto pos = chunks.findChar('\r', 0, haystack.size());
+        return pos.has_value();
+    }, 1, haystack.size());
+}
+
+static void memFind(Recorder & recorder)
+{
+    std::string haystack = createHaystack();
+    B_MEM mem(haystack.data(), static_cast<uint32_t>(haystack.size()));
+
+    recorder.setParameter("haystackSize", static_cast<Json::UInt64>(haystack.size()));
+    recorder.measure([&]() {
+        auto pos = mem.find(needle, sizeof(needle) - 1);
+        return pos.has_value();
+    }, 1, haystack.size());
+}
+
+static void chunksDisplace(Recorder & recorder)
+{
+    std::string piece(1460, 'x');
+    B_Chunks chunks;
+
+    // Producer/consumer pattern of the parsers: append a packet, consume it in small pieces.
+    recorder.setParameter("appendSize", static_cast<Json::UInt64>(piece.size()));
+    recorder.measure([&]() {
+        if (!chunks.append(piece.data(), piece.size()))
+            return false;
+        while (chunks.size() > 0)
+        {
+            if (!chunks.displace(std::min<size_t>(100, chunks.size())))
+                return false;
+        }
+        return true;
+    }, 16, piece.size());
+}
+
+MANTIDS_BENCHMARK("memory/b_chunks_append_4k", chunksAppend)
+MANTIDS_BENCHMARK("memory/b_chunks_displace_1460", chunksDisplace)
+MANTIDS_BENCHMARK("memory/b_chunks_find_64k", chunksFind)
+MANTIDS_BENCHMARK("memory/b_chunks_find_nocase_64k", chunksFindCaseInsensitive)
+MANTIDS_BENCHMARK("memory/b_chunks_findchar_64k", chunksFindChar)
+MANTIDS_BENCHMARK("memory/b_base_find_mem_64k", memFind)
@@ -0,0 +1,70 @@
+#include "benchmark.h"
+
+#include <Mantids30/Protocol_MIME/mime_sub_header.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Network::Protocols::MIME;
+
+static const std::string headerBlock =
+    "Host: www.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:128.0) Gecko/20100101 Firefox/128.0\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Language: en-US,en;q=0.5\r\n"
+    "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+    "Content-Type: multipart/form-data; boundary=\"----WebKitFormBoundary7MA4YWxkTrZu0gW\"\r\n"
+    "Content-Disposition: form-data; name=\"file\"; filename=\"report.pdf\"\r\n"
+    "Cookie: session=7a1b9c0f; theme=dark; lang=en\r\n"
+    "Connection: keep-alive\r\n"
+    "Cache-Control: no-cache\r\n"
+    "\r\n";
+
+static bool parseHeaderBlock(MIME_Sub_Header & header)
+{
+    const char * data = headerBlock.data();
+    size_t left = headerBlock.size();
+
+    while (left && header.getParseStatus() == Memory::Streams::SubParser::PARSE_GET_MORE_DATA)
+    {
+        std::optional<size_t> used = header.writeIntoParser(data, left);
+        if (!used || *used == 0)
+            return false;
+        data += *used;
+        left -= *used;
+    }
+    return header.getParseStatus() == Memory::Streams::SubParser::PARSE_GOTO_NEXT_SUBPARSER;
+}
+
+static void subHeaderParse(Recorder & recorder)
+{
+    recorder.setParameter("headers", 10);
+    recorder.setParameter("blockSize", static_cast<Json::UInt64>(headerBlock.size()));
+    recorder.measure([&]() {
+        MIME_Sub_Header header;
+        if (!parseHeaderBlock(header))
+            return false;
+        doNotOptimize(header.getOptionsSize());
+        return true;
+    }, 1, headerBlock.size());
+}
+
+static void subHeaderLookup(Recorder & recorder)
+{
+    MIME_Sub_Header header;
+    if (!parseHeaderBlock(header))
+    {
+        recorder.fail("header block not parsed");
+        return;
+    }
+
+    recorder.measure([&]() {
+        auto contentType = header.getOptionByName("content-type");
+        if (!contentType)
+            return false;
+        doNotOptimize(contentType->getSubVar("boundary"));
+        return true;
+    }, 16);
+}
+
+MANTIDS_BENCHMARK("mime/sub_header_parse_10", subHeaderParse)
+MANTIDS_BENCHMARK("mime/sub_header_lookup", subHeaderLookup)
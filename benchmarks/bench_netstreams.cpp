@@ -0,0 +1,100 @@
+#include "benchmark.h"
+
+#include <Mantids30/Net_Sockets/streams_bufferedreader.h>
+
+#include <string.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Network;
+
+namespace {
+
+// Serves a memory block in TCP segment sized reads:
+class MemoryStream : public Sockets::Socket_Stream
+{
+public:
+    MemoryStream(const std::string & data)
+        : m_data(data)
+    {
+    }
+    ssize_t partialRead(void *data, const size_t &datalen) override
+    {
+        size_t len = std::min(std::min(datalen, static_cast<size_t>(1460)), m_data.size() - m_offset);
+        memcpy(data, m_data.data() + m_offset, len);
+        m_offset += len;
+        return static_cast<ssize_t>(len);
+    }
+
+private:
+    const std::string & m_data;
+    size_t m_offset = 0;
+};
+
+std::string makeLines(const size_t & lineCount, const size_t & lineSize)
+{
+    std::string r;
+    for (size_t i = 0; i < lineCount; i++)
+    {
+        r.append(lineSize - 2, static_cast<char>('a' + (i % 26)));
+        r.append("\r\n");
+    }
+    return r;
+}
+
+const std::string shortLines = makeLines(512, 80);
+const std::string longLines = makeLines(4, 16384);
+
+}
+
+static void readLineLF(Recorder & recorder)
+{
+    recorder.setParameter("lines", 512);
+    recorder.setParameter("lineSize", 80);
+    recorder.measure([&]() {
+        Sockets::NetStreams::BufferedReader reader(std::make_shared<MemoryStream>(shortLines), 8192);
+        std::string line;
+        size_t count = 0;
+        while (count < 512 && reader.readLineLF(&line) == Sockets::NetStreams::BufferedReader::E_STREAMBUFFER_READ_OK)
+            count++;
+        doNotOptimize(line);
+        return count == 512;
+    }, 1, shortLines.size());
+}
+
+static void readLines(Recorder & recorder)
+{
+    recorder.setParameter("lines", 512);
+    recorder.setParameter("lineSize", 80);
+    std::vector<std::string_view> lines;
+    recorder.measure([&]() {
+        Sockets::NetStreams::BufferedReader reader(std::make_shared<MemoryStream>(shortLines), 8192);
+        size_t count = 0;
+        lines.clear();
+        while (count < 512 && reader.readLines(&lines) == Sockets::NetStreams::BufferedReader::E_STREAMBUFFER_READ_OK)
+        {
+            count += lines.size();
+            lines.clear();
+        }
+        return count == 512;
+    }, 1, shortLines.size());
+}
+
+static void readLongLineLF(Recorder & recorder)
+{
+    recorder.setParameter("lines", 4);
+    recorder.setParameter("lineSize", 16384);
+    recorder.measure([&]() {
+        Sockets::NetStreams::BufferedReader reader(std::make_shared<MemoryStream>(longLines), 65536);
+        std::string line;
+        size_t count = 0;
+        while (count < 4 && reader.readLineLF(&line) == Sockets::NetStreams::BufferedReader::E_STREAMBUFFER_READ_OK)
+            count++;
+        doNotOptimize(line);
+        return count == 4;
+    }, 1, longLines.size());
+}
+
+MANTIDS_BENCHMARK("netstreams/read_line_lf_80", readLineLF)
+MANTIDS_BENCHMARK("netstreams/read_lines_80", readLines)
+MANTIDS_BENCHMARK("netstreams/read_line_lf_16k", readLongLineLF)
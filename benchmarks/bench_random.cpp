@@ -0,0 +1,52 @@
+#include "benchmark.h"
+
+#include <Mantids30/Helpers/random.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+
+// Session ID (WebSessionsManager::createSession):
+static void sessionId(Recorder & recorder)
+{
+    recorder.setParameter("length", 25);
+    recorder.measure([&]() {
+        std::string sessionId = Helpers::Random::createRandomString(12) + ":" + Helpers::Random::createRandomString(12);
+        doNotOptimize(sessionId);
+        return sessionId.size() == 25;
+    }, 1, 24);
+}
+
+static void randomString64(Recorder & recorder)
+{
+    recorder.setParameter("length", 64);
+    recorder.measure([&]() {
+        std::string r = Helpers::Random::createRandomString(64);
+        doNotOptimize(r);
+        return r.size() == 64;
+    }, 1, 64);
+}
+
+static void randomHexString8(Recorder & recorder)
+{
+    recorder.setParameter("bytes", 8);
+    recorder.measure([&]() {
+        std::string r = Helpers::Random::createRandomHexString(8);
+        doNotOptimize(r);
+        return r.size() == 16;
+    }, 1, 8);
+}
+
+static void salt128(Recorder & recorder)
+{
+    unsigned char salt[16];
+    recorder.measure([&]() {
+        Helpers::Random::createRandomSalt128(salt);
+        doNotOptimize(salt);
+        return true;
+    }, 1, sizeof(salt));
+}
+
+MANTIDS_BENCHMARK("random/session_id", sessionId)
+MANTIDS_BENCHMARK("random/string_64", randomString64)
+MANTIDS_BENCHMARK("random/hex_string_8", randomHexString8)
+MANTIDS_BENCHMARK("random/salt_128", salt128)
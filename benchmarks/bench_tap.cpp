@@ -0,0 +1,230 @@
+#include "benchmark.h"
+
+#include <Mantids30/Net_Interfaces/virtualnetworkinterface.h>
+#include <Mantids30/Net_Sockets/socket_udp.h>
+
+#include <atomic>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <net/if_arp.h>
+#include <netinet/if_ether.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Network;
+
+namespace {
+
+const size_t payloadSize = 64;
+const size_t batchSize = 32;
+
+// Local address of the TAP and a static neighbor behind it (the datagrams to it go out through the TAP):
+const char * tapAddress = "10.213.0.1";
+const char * neighborAddress = "10.213.0.2";
+const unsigned char neighborMAC[ETH_ALEN] = {0x02, 0x00, 0x00, 0xd5, 0x00, 0x02};
+
+// Creates a TAP interface (requires CAP_NET_ADMIN), removed when destroyed:
+class TAPInterface
+{
+public:
+    bool start(std::string * error)
+    {
+        in_addr address, netmask;
+        inet_pton(AF_INET, tapAddress, &address);
+        inet_pton(AF_INET, "255.255.255.0", &netmask);
+        m_netcfg.setIPv4Address(address, netmask);
+
+        if (!m_tap.start(&m_netcfg, "mbench"))
+        {
+            *error = "TAP interface not available: " + m_tap.getLastError();
+            return false;
+        }
+
+        // Static neighbor, so the kernel sends the datagrams without ARP resolution:
+        struct arpreq request;
+        memset(&request, 0, sizeof(request));
+        struct sockaddr_in * protocolAddress = reinterpret_cast<struct sockaddr_in *>(&request.arp_pa);
+        protocolAddress->sin_family = AF_INET;
+        inet_pton(AF_INET, neighborAddress, &protocolAddress->sin_addr);
+        request.arp_ha.sa_family = ARPHRD_ETHER;
+        memcpy(request.arp_ha.sa_data, neighborMAC, ETH_ALEN);
+        request.arp_flags = ATF_COM | ATF_PERM;
+        strncpy(request.arp_dev, m_tap.getInterfaceRealName().c_str(), sizeof(request.arp_dev) - 1);
+
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        bool neighborAdded = fd >= 0 && ioctl(fd, SIOCSARP, &request) == 0;
+        if (fd >= 0)
+            close(fd);
+        if (!neighborAdded)
+        {
+            *error = "failed to add the static neighbor";
+            return false;
+        }
+
+        m_queue = m_tap.getQueue(0);
+        return m_queue != nullptr;
+    }
+
+    Interfaces::PacketQueue * getQueue() { return m_queue.get(); }
+    ethhdr getEthernetAddress() { return m_netcfg.getEthernetAddress(); }
+
+private:
+    Interfaces::NetworkInterfaceConfiguration m_netcfg;
+    Interfaces::VirtualNetworkInterface m_tap;
+    std::shared_ptr<Interfaces::PacketQueue> m_queue;
+};
+
+// Sends UDP datagrams to the neighbor (received from the TAP) until stopped:
+class Flooder
+{
+public:
+    Flooder()
+    {
+        m_thread = std::thread([this]() {
+            Sockets::Socket_UDP sender;
+            if (!sender.connectFrom(nullptr, neighborAddress, 9))
+                return;
+            Sockets::DatagramBatch batch(batchSize, payloadSize);
+            for (size_t i = 0; i < batchSize; i++)
+                batch[i].length = payloadSize;
+            batch.setSize(batchSize);
+            // Errors (eg. ENOBUFS when the TAP queue is full) are ignored, the reader catches up meanwhile:
+            while (!m_stop)
+                sender.writeBatch(batch);
+        });
+    }
+    ~Flooder()
+    {
+        m_stop = true;
+        m_thread.join();
+    }
+
+private:
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
+
+// Ethernet frame for the TAP address with a local experimental ethertype (discarded by the stack):
+void fillFrame(unsigned char * frame, const size_t & length, const ethhdr & tapAddress)
+{
+    memset(frame, 0, length);
+    struct ethhdr * header = reinterpret_cast<struct ethhdr *>(frame);
+    memcpy(header->h_dest, tapAddress.h_dest, ETH_ALEN);
+    memcpy(header->h_source, neighborMAC, ETH_ALEN);
+    header->h_proto = htons(0x88b5);
+}
+
+}
+
+static void tapReadSingle(Recorder & recorder)
+{
+    TAPInterface tap;
+    std::string error;
+    if (!tap.start(&error))
+    {
+        recorder.skip(error);
+        return;
+    }
+
+    recorder.setParameter("payloadSize", static_cast<Json::UInt64>(payloadSize));
+    Flooder flooder;
+    unsigned char frame[2048];
+    recorder.measure([&]() { return tap.getQueue()->readPacket(frame, sizeof(frame)) > 0; }, batchSize);
+}
+
+static void tapReadBatch(Recorder & recorder)
+{
+    TAPInterface tap;
+    std::string error;
+    if (!tap.start(&error))
+    {
+        recorder.skip(error);
+        return;
+    }
+
+    recorder.setParameter("payloadSize", static_cast<Json::UInt64>(payloadSize));
+    recorder.setParameter("batchSize", static_cast<Json::UInt64>(batchSize));
+
+    Flooder flooder;
+    Interfaces::PacketBatch batch(batchSize);
+
+    recorder.begin();
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(recorder.getOptions().durationMS);
+    for (auto now = std::chrono::steady_clock::now(); now < end;)
+    {
+        int received = tap.getQueue()->readBatch(batch, 1000);
+        if (received <= 0)
+        {
+            recorder.fail("readBatch failed");
+            return;
+        }
+        auto after = std::chrono::steady_clock::now();
+        recorder.addSample(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - now).count()), received);
+        now = after;
+    }
+    recorder.finish();
+}
+
+static void tapWriteSingle(Recorder & recorder)
+{
+    TAPInterface tap;
+    std::string error;
+    if (!tap.start(&error))
+    {
+        recorder.skip(error);
+        return;
+    }
+
+    recorder.setParameter("frameSize", 60);
+    unsigned char frame[60];
+    fillFrame(frame, sizeof(frame), tap.getEthernetAddress());
+    recorder.measure([&]() { return tap.getQueue()->writePacket(frame, sizeof(frame)) == static_cast<ssize_t>(sizeof(frame)); }, batchSize, sizeof(frame));
+}
+
+static void tapWriteBatch(Recorder & recorder)
+{
+    TAPInterface tap;
+    std::string error;
+    if (!tap.start(&error))
+    {
+        recorder.skip(error);
+        return;
+    }
+
+    recorder.setParameter("frameSize", 60);
+    recorder.setParameter("batchSize", static_cast<Json::UInt64>(batchSize));
+
+    ethhdr tapAddress = tap.getEthernetAddress();
+    Interfaces::PacketBatch batch(batchSize);
+    for (size_t i = 0; i < batchSize; i++)
+    {
+        batch[i].length = 60;
+        fillFrame(batch[i].data, batch[i].length, tapAddress);
+    }
+    batch.setSize(batchSize);
+
+    recorder.begin();
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(recorder.getOptions().durationMS);
+    for (auto now = std::chrono::steady_clock::now(); now < end;)
+    {
+        int sent = tap.getQueue()->writeBatch(batch);
+        if (sent <= 0)
+        {
+            recorder.fail("writeBatch failed");
+            return;
+        }
+        auto after = std::chrono::steady_clock::now();
+        recorder.addSample(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - now).count()), sent);
+        now = after;
+    }
+    recorder.finish(60);
+}
+
+MANTIDS_BENCHMARK("tap/read_single_udp64", tapReadSingle)
+MANTIDS_BENCHMARK("tap/read_batch_udp64", tapReadBatch)
+MANTIDS_BENCHMARK("tap/write_single_60", tapWriteSingle)
+MANTIDS_BENCHMARK("tap/write_batch_60", tapWriteBatch)
@@ -0,0 +1,103 @@
+#include "benchmark.h"
+
+#include <Mantids30/Threads/threadpool.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+
+namespace {
+
+struct Completion
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint64_t done = 0;
+};
+
+void completeTask(std::shared_ptr<void> data)
+{
+    Completion * completion = static_cast<Completion *>(data.get());
+    {
+        std::lock_guard<std::mutex> lock(completion->mutex);
+        completion->done++;
+    }
+    completion->condition.notify_all();
+}
+
+}
+
+static void threadPoolRoundTrip(Recorder & recorder)
+{
+    Threads::Pool::ThreadPool pool(4, 64);
+    pool.start();
+
+    auto completion = std::make_shared<Completion>();
+    uint64_t expected = 0;
+
+    recorder.setParameter("threads", 4);
+    recorder.measure([&]() {
+        if (!pool.pushTask(&completeTask, completion))
+            return false;
+        expected++;
+        std::unique_lock<std::mutex> lock(completion->mutex);
+        completion->condition.wait(lock, [&]() { return completion->done == expected; });
+        return true;
+    });
+
+    pool.stop();
+}
+
+static void threadPoolThroughput(Recorder & recorder)
+{
+    const uint32_t threads = std::max(2U, std::thread::hardware_concurrency());
+    const uint64_t burst = 1000;
+
+    Threads::Pool::ThreadPool pool(threads, 256);
+    pool.start();
+
+    auto completion = std::make_shared<Completion>();
+    uint64_t expected = 0;
+
+    recorder.setParameter("threads", threads);
+    recorder.setParameter("burst", static_cast<Json::UInt64>(burst));
+    auto runBurst = [&]() {
+        // Full priority: the tasks are spread over every queue.
+        for (uint64_t i = 0; i < burst; i++)
+        {
+            if (!pool.pushTask(&completeTask, completion, static_cast<uint32_t>(-1), 1.0))
+                return false;
+        }
+        expected += burst;
+        std::unique_lock<std::mutex> lock(completion->mutex);
+        completion->condition.wait(lock, [&]() { return completion->done == expected; });
+        return true;
+    };
+
+    // Every task is an operation (latency is the mean per task of each burst):
+    using Clock = std::chrono::steady_clock;
+    for (auto end = Clock::now() + std::chrono::milliseconds(recorder.getOptions().warmUpMS); Clock::now() < end;)
+        runBurst();
+
+    recorder.begin();
+    for (auto end = Clock::now() + std::chrono::milliseconds(recorder.getOptions().durationMS); Clock::now() < end;)
+    {
+        auto start = Clock::now();
+        if (!runBurst())
+        {
+            recorder.fail("pushTask failed");
+            break;
+        }
+        recorder.addSample(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()), burst);
+    }
+    recorder.finish();
+
+    pool.stop();
+}
+
+MANTIDS_BENCHMARK("threads/threadpool_roundtrip", threadPoolRoundTrip)
+MANTIDS_BENCHMARK("threads/threadpool_burst_1000", threadPoolThroughput)
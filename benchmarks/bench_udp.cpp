@@ -0,0 +1,165 @@
+#include "benchmark.h"
+
+#include <Mantids30/Net_Sockets/socket_udp.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace Mantids30;
+using namespace Mantids30::Benchmarks;
+using namespace Mantids30::Network::Sockets;
+
+namespace {
+
+const size_t datagramSize = 64;
+const size_t batchSize = 32;
+
+bool openLoopback(Socket_UDP & receiver, Socket_UDP & sender)
+{
+    if (!receiver.listenOn(0, "127.0.0.1") || !receiver.getPort())
+        return false;
+    // Never blocks forever if the sender stops:
+    receiver.setReadTimeout(1);
+    return sender.connectFrom(nullptr, "127.0.0.1", receiver.getPort());
+}
+
+// Keeps the receiver busy with batches of datagrams until stopped:
+class Flooder
+{
+public:
+    Flooder(Socket_UDP & sender)
+        : m_sender(sender)
+    {
+        m_thread = std::thread([this]() {
+            DatagramBatch batch(batchSize, datagramSize);
+            for (size_t i = 0; i < batchSize; i++)
+                batch[i].length = datagramSize;
+            batch.setSize(batchSize);
+            while (!m_stop && m_sender.writeBatch(batch) >= 0)
+            {
+            }
+        });
+    }
+    ~Flooder()
+    {
+        m_stop = true;
+        m_thread.join();
+    }
+
+private:
+    Socket_UDP & m_sender;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
+
+}
+
+static void udpSendSingle(Recorder & recorder)
+{
+    Socket_UDP receiver, sender;
+    if (!openLoopback(receiver, sender))
+    {
+        recorder.fail("loopback UDP sockets failed");
+        return;
+    }
+
+    recorder.setParameter("datagramSize", static_cast<Json::UInt64>(datagramSize));
+    char datagram[datagramSize] = {0};
+    // Nobody reads: the loopback drops the datagrams when the receive buffer is full.
+    recorder.measure([&]() { return sender.writeBlock(datagram, sizeof(datagram)); }, batchSize, datagramSize);
+}
+
+static void udpSendBatch(Recorder & recorder)
+{
+    Socket_UDP receiver, sender;
+    if (!openLoopback(receiver, sender))
+    {
+        recorder.fail("loopback UDP sockets failed");
+        return;
+    }
+
+    recorder.setParameter("datagramSize", static_cast<Json::UInt64>(datagramSize));
+    recorder.setParameter("batchSize", static_cast<Json::UInt64>(batchSize));
+
+    DatagramBatch batch(batchSize, datagramSize);
+    for (size_t i = 0; i < batchSize; i++)
+        batch[i].length = datagramSize;
+    batch.setSize(batchSize);
+
+    recorder.begin();
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(recorder.getOptions().durationMS);
+    for (auto now = std::chrono::steady_clock::now(); now < end;)
+    {
+        int sent = sender.writeBatch(batch);
+        if (sent <= 0)
+        {
+            recorder.fail("writeBatch failed");
+            return;
+        }
+        auto after = std::chrono::steady_clock::now();
+        recorder.addSample(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - now).count()), sent);
+        now = after;
+    }
+    recorder.finish(datagramSize);
+}
+
+static void udpReceiveSingle(Recorder & recorder)
+{
+    Socket_UDP receiver, sender;
+    if (!openLoopback(receiver, sender))
+    {
+        recorder.fail("loopback UDP sockets failed");
+        return;
+    }
+
+    recorder.setParameter("datagramSize", static_cast<Json::UInt64>(datagramSize));
+    Flooder flooder(sender);
+    recorder.measure([&]() { return receiver.readBlock()->dataLength == static_cast<int>(datagramSize); }, batchSize, datagramSize);
+}
+
+static void udpReceiveBatch(Recorder & recorder)
+{
+    Socket_UDP receiver, sender;
+    if (!openLoopback(receiver, sender))
+    {
+        recorder.fail("loopback UDP sockets failed");
+        return;
+    }
+
+    recorder.setParameter("datagramSize", static_cast<Json::UInt64>(datagramSize));
+    recorder.setParameter("batchSize", static_cast<Json::UInt64>(batchSize));
+
+    Flooder flooder(sender);
+    DatagramBatch batch(batchSize, 2048);
+
+    // Warm up:
+    for (int i = 0; i < 1000; i++)
+    {
+        if (receiver.readBatch(batch) <= 0)
+        {
+            recorder.fail("readBatch failed during the warm up");
+            return;
+        }
+    }
+
+    recorder.begin();
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(recorder.getOptions().durationMS);
+    for (auto now = std::chrono::steady_clock::now(); now < end;)
+    {
+        int received = receiver.readBatch(batch);
+        if (received <= 0)
+        {
+            recorder.fail("readBatch failed");
+            return;
+        }
+        auto after = std::chrono::steady_clock::now();
+        recorder.addSample(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - now).count()), received);
+        now = after;
+    }
+    recorder.finish(datagramSize);
+}
+
+MANTIDS_BENCHMARK("udp/loopback_send_single_64", udpSendSingle)
+MANTIDS_BENCHMARK("udp/loopback_send_batch_64", udpSendBatch)
+MANTIDS_BENCHMARK("udp/loopback_receive_single_64", udpReceiveSingle)
+MANTIDS_BENCHMARK("udp/loopback_receive_batch_64", udpReceiveBatch)
@@ -0,0 +1,179 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdio.h>
+
+using namespace Mantids30::Benchmarks;
+
+static std::atomic<uint64_t> allocationCount{0};
+
+// Replaced global allocation functions (every other form of new ends up here):
+void * operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void * p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void * operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void * p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void * p, size_t) noexcept
+{
+    free(p);
+}
+
+uint64_t Mantids30::Benchmarks::getAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+Recorder::Recorder(const Options &options) : m_options(options)
+{
+    m_parameters = Json::objectValue;
+}
+
+void Recorder::begin()
+{
+    m_samplesNS.clear();
+    m_samplesNS.reserve(1 << 20);
+    m_operations = 0;
+    m_allocationsStart = getAllocationCount();
+    m_startTime = std::chrono::steady_clock::now();
+}
+
+void Recorder::addSample(const uint64_t &elapsedNS, const uint64_t &ops)
+{
+    m_samplesNS.push_back(ops ? elapsedNS / ops : elapsedNS);
+    m_operations += ops;
+}
+
+void Recorder::addSamples(const std::vector<uint64_t> &samplesNS)
+{
+    m_samplesNS.insert(m_samplesNS.end(), samplesNS.begin(), samplesNS.end());
+    m_operations += samplesNS.size();
+}
+
+void Recorder::finish(const uint64_t &bytesPerOp)
+{
+    m_elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+    m_allocations = getAllocationCount() - m_allocationsStart;
+    m_bytesPerOp = bytesPerOp;
+}
+
+void Recorder::fail(const std::string &reason)
+{
+    m_status = "failed";
+    m_reason = reason;
+}
+
+void Recorder::skip(const std::string &reason)
+{
+    m_status = "skipped";
+    m_reason = reason;
+}
+
+void Recorder::setParameter(const std::string &name, const json &value)
+{
+    m_parameters[name] = value;
+}
+
+const Options &Recorder::getOptions() const
+{
+    return m_options;
+}
+
+static uint64_t percentile(const std::vector<uint64_t> &sorted, const double &p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t rank = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+json Recorder::toJSON() const
+{
+    json r;
+    r["name"] = name;
+    r["status"] = m_status;
+    if (!m_reason.empty())
+        r["reason"] = m_reason;
+    r["parameters"] = m_parameters;
+
+    if (m_status != "ok")
+        return r;
+
+    std::vector<uint64_t> sorted = m_samplesNS;
+    std::sort(sorted.begin(), sorted.end());
+
+    double opsPerSecond = m_elapsedSeconds > 0 ? static_cast<double>(m_operations) / m_elapsedSeconds : 0;
+
+    r["operations"] = static_cast<Json::UInt64>(m_operations);
+    r["seconds"] = m_elapsedSeconds;
+    r["throughput"]["opsPerSecond"] = opsPerSecond;
+    if (m_bytesPerOp)
+        r["throughput"]["bytesPerSecond"] = opsPerSecond * static_cast<double>(m_bytesPerOp);
+
+    r["latencyNS"]["samples"] = static_cast<Json::UInt64>(sorted.size());
+    r["latencyNS"]["min"] = static_cast<Json::UInt64>(sorted.empty() ? 0 : sorted.front());
+    r["latencyNS"]["p50"] = static_cast<Json::UInt64>(percentile(sorted, 0.50));
+    r["latencyNS"]["p99"] = static_cast<Json::UInt64>(percentile(sorted, 0.99));
+    r["latencyNS"]["p999"] = static_cast<Json::UInt64>(percentile(sorted, 0.999));
+    r["latencyNS"]["max"] = static_cast<Json::UInt64>(sorted.empty() ? 0 : sorted.back());
+
+    r["allocationsPerOp"] = m_operations ? static_cast<double>(m_allocations) / static_cast<double>(m_operations) : 0.0;
+    return r;
+}
+
+std::string Recorder::toText() const
+{
+    char line[512];
+    if (m_status != "ok")
+    {
+        snprintf(line, sizeof(line), "%-40s %s (%s)", name.c_str(), m_status.c_str(), m_reason.c_str());
+        return line;
+    }
+
+    json r = toJSON();
+    snprintf(line, sizeof(line), "%-40s %14.0f ops/s  p50 %9llu ns  p99 %9llu ns  p999 %9llu ns  %8.2f allocs/op",
+             name.c_str(),
+             r["throughput"]["opsPerSecond"].asDouble(),
+             static_cast<unsigned long long>(r["latencyNS"]["p50"].asUInt64()),
+             static_cast<unsigned long long>(r["latencyNS"]["p99"].asUInt64()),
+             static_cast<unsigned long long>(r["latencyNS"]["p999"].asUInt64()),
+             r["allocationsPerOp"].asDouble());
+    return line;
+}
+
+bool Registry::add(const std::string &name, Function function)
+{
+    getEntries().push_back({name, function});
+    return true;
+}
+
+std::vector<Registry::Entry> &Registry::getEntries()
+{
+    static std::vector<Entry> entries;
+    return entries;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <Mantids30/Helpers/json.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Mantids30 { namespace Benchmarks {
+
+/**
+ * @brief The Options struct holds the command line options shared by every benchmark.
+ */
+struct Options
+{
+    /**
+     * @brief durationMS Measured time per benchmark (after the warm up).
+     */
+    uint32_t durationMS = 1000;
+    /**
+     * @brief warmUpMS Unmeasured time per benchmark.
+     */
+    uint32_t warmUpMS = 200;
+    /**
+     * @brief clientThreads Number of concurrent clients used by the load generators.
+     */
+    uint32_t clientThreads = 8;
+};
+
+/**
+ * @brief The Recorder class collects the results of a single benchmark.
+ *
+ * Latencies are kept as samples in nanoseconds per operation. When an operation is too short to be timed alone, it is
+ * run in batches and the sample is the batch mean. Allocations are counted process-wide (every thread) through the
+ * replaced global operator new.
+ */
+class Recorder
+{
+public:
+    Recorder(const Options & options);
+
+    /**
+     * @brief measure Run the operation over and over during the warm up and the measured time.
+     * @param op operation to be measured, returns false to abort (the benchmark is then reported as failed).
+     * @param batchSize number of operations timed together.
+     * @param bytesPerOp bytes processed by each operation (0: no bandwidth is reported).
+     */
+    template<typename F>
+    void measure(F && op, const size_t & batchSize = 1, const uint64_t & bytesPerOp = 0)
+    {
+        using Clock = std::chrono::steady_clock;
+        auto warmUpEnd = Clock::now() + std::chrono::milliseconds(m_options.warmUpMS);
+        while (Clock::now() < warmUpEnd)
+        {
+            for (size_t i = 0; i < batchSize; i++)
+            {
+                if (!op())
+                {
+                    fail("operation failed during the warm up");
+                    return;
+                }
+            }
+        }
+
+        begin();
+        auto end = m_startTime + std::chrono::milliseconds(m_options.durationMS);
+        for (Clock::time_point now = m_startTime; now < end;)
+        {
+            for (size_t i = 0; i < batchSize; i++)
+            {
+                if (!op())
+                {
+                    fail("operation failed");
+                    return;
+                }
+            }
+            Clock::time_point after = Clock::now();
+            addSample(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - now).count()), batchSize);
+            now = after;
+        }
+        finish(bytesPerOp);
+    }
+
+    /**
+     * @brief begin Start the measured interval (for benchmarks that add their own samples).
+     */
+    void begin();
+    /**
+     * @brief addSample Add a latency sample.
+     * @param elapsedNS elapsed time in nanoseconds.
+     * @param ops operations done in this time.
+     */
+    void addSample(const uint64_t & elapsedNS, const uint64_t & ops = 1);
+    /**
+     * @brief addSamples Add samples collected by another thread (one operation per sample).
+     */
+    void addSamples(const std::vector<uint64_t> & samplesNS);
+    /**
+     * @brief finish End the measured interval.
+     * @param bytesPerOp bytes processed by each operation (0: no bandwidth is reported).
+     */
+    void finish(const uint64_t & bytesPerOp = 0);
+    /**
+     * @brief fail Report the benchmark as failed.
+     */
+    void fail(const std::string & reason);
+    /**
+     * @brief skip Report the benchmark as skipped (eg. missing privileges).
+     */
+    void skip(const std::string & reason);
+    /**
+     * @brief setParameter Describe a benchmark parameter (payload size, threads, etc).
+     */
+    void setParameter(const std::string & name, const json & value);
+
+    const Options & getOptions() const;
+
+    /**
+     * @brief toJSON Get the machine readable result.
+     */
+    json toJSON() const;
+    /**
+     * @brief toText Get the human readable one line summary.
+     */
+    std::string toText() const;
+
+    std::string name;
+
+private:
+    Options m_options;
+
+    std::chrono::steady_clock::time_point m_startTime;
+    double m_elapsedSeconds = 0;
+    uint64_t m_allocationsStart = 0, m_allocations = 0;
+    uint64_t m_operations = 0, m_bytesPerOp = 0;
+
+    std::vector<uint64_t> m_samplesNS;
+    json m_parameters;
+    std::string m_status = "ok", m_reason;
+};
+
+/**
+ * @brief The Registry class keeps every benchmark linked into the executable.
+ */
+class Registry
+{
+public:
+    typedef void (*Function)(Recorder & recorder);
+
+    struct Entry
+    {
+        std::string name;
+        Function function;
+    };
+
+    /**
+     * @brief add Register a benchmark (called from the static initializers of each benchmark file).
+     */
+    static bool add(const std::string & name, Function function);
+    static std::vector<Entry> & getEntries();
+};
+
+/**
+ * @brief getAllocationCount Get the number of allocations done by the process.
+ */
+uint64_t getAllocationCount();
+
+/**
+ * @brief doNotOptimize Keep the compiler from discarding a result.
+ */
+template<typename T>
+inline void doNotOptimize(const T & value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}}
+
+#define MANTIDS_BENCHMARK(NAME, FUNCTION) \
+    static bool FUNCTION##_registered = Mantids30::Benchmarks::Registry::add(NAME, &FUNCTION);
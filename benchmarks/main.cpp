@@ -0,0 +1,126 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+using namespace Mantids30::Benchmarks;
+
+static void printUsage(const char * programName)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --list               list the benchmarks and exit\n"
+            "  --filter <text>      run only the benchmarks containing this text (can be repeated)\n"
+            "  --output <file>      write the JSON report into this file (default: stdout)\n"
+            "  --duration <ms>      measured time per benchmark (default: 1000)\n"
+            "  --warmup <ms>        warm up time per benchmark (default: 200)\n"
+            "  --clients <n>        concurrent clients for the load generators (default: 8)\n"
+            "  --quick              short run (200ms measured, 50ms warm up)\n",
+            programName);
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    std::vector<std::string> filters;
+    std::string outputFile;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--list")
+            listOnly = true;
+        else if (arg == "--quick")
+        {
+            options.durationMS = 200;
+            options.warmUpMS = 50;
+        }
+        else if (arg == "--filter" && hasValue)
+            filters.push_back(argv[++i]);
+        else if (arg == "--output" && hasValue)
+            outputFile = argv[++i];
+        else if (arg == "--duration" && hasValue)
+            options.durationMS = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--warmup" && hasValue)
+            options.warmUpMS = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--clients" && hasValue)
+            options.clientThreads = static_cast<uint32_t>(std::max(1UL, strtoul(argv[++i], nullptr, 10)));
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    json report;
+    char hostName[256] = "";
+    gethostname(hostName, sizeof(hostName) - 1);
+
+    report["library"] = "libMantids30";
+    report["version"] = MANTIDS30_VERSION;
+    report["timestamp"] = static_cast<Json::Int64>(time(nullptr));
+    report["host"]["name"] = hostName;
+    report["host"]["cpus"] = std::thread::hardware_concurrency();
+    report["options"]["durationMS"] = options.durationMS;
+    report["options"]["warmUpMS"] = options.warmUpMS;
+    report["options"]["clientThreads"] = options.clientThreads;
+    report["benchmarks"] = Json::arrayValue;
+
+    bool failed = false;
+
+    for (const Registry::Entry & entry : Registry::getEntries())
+    {
+        if (!filters.empty())
+        {
+            bool matched = false;
+            for (const std::string & filter : filters)
+                matched = matched || entry.name.find(filter) != std::string::npos;
+            if (!matched)
+                continue;
+        }
+
+        if (listOnly)
+        {
+            std::cout << entry.name << std::endl;
+            continue;
+        }
+
+        Recorder recorder(options);
+        recorder.name = entry.name;
+        entry.function(recorder);
+
+        // Progress goes to stderr, the report to stdout (or the output file):
+        std::cerr << recorder.toText() << std::endl;
+
+        json result = recorder.toJSON();
+        failed = failed || result["status"].asString() == "failed";
+        report["benchmarks"].append(result);
+    }
+
+    if (listOnly)
+        return 0;
+
+    std::string reportText = report.toStyledString();
+    if (outputFile.empty())
+        std::cout << reportText;
+    else
+    {
+        std::ofstream out(outputFile);
+        out << reportText;
+        if (!out.good())
+        {
+            std::cerr << "Failed to write the report into " << outputFile << std::endl;
+            return 2;
+        }
+    }
+
+    return failed ? 3 : 0;
+}
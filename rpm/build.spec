@@ -25,7 +25,7 @@ Group:          Development/Libraries
 %if 0%{?fedora} >= 33
 %define debug_package %{nil}
 %endif
-BuildRequires:  %{cmake} jsoncpp-devel boost-devel boost-static sqlite-devel postgresql-devel gcc-c++
+BuildRequires:  %{cmake} jsoncpp-devel boost-devel boost-static sqlite-devel postgresql-devel zlib-devel gcc-c++
 %if 0%{?rhel} == 6
 BuildRequires:  mysql-devel
 %else
@@ -36,7 +36,7 @@ BuildRequires:  openssl11-devel
 %else
 BuildRequires:  openssl-devel
 %endif
-Requires: jsoncpp boost-regex boost-thread
+Requires: jsoncpp boost-regex boost-thread zlib
 %if 0%{?rhel} == 7
 Requires:       openssl11
 %else
@@ -0,0 +1,94 @@
+#include "test.h"
+
+#include <iostream>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Mantids30::Tests;
+
+static void printUsage(const char * programName)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --list               list the test cases and exit\n"
+            "  --filter <text>      run only the test cases containing this text (can be repeated)\n",
+            programName);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> filters;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--list")
+            listOnly = true;
+        else if (arg == "--filter" && i + 1 < argc)
+            filters.push_back(argv[++i]);
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Closed peers are reported by the write calls:
+    signal(SIGPIPE, SIG_IGN);
+
+    size_t passed = 0, failed = 0, skipped = 0;
+
+    for (const Registry::Entry & entry : Registry::getEntries())
+    {
+        if (!filters.empty())
+        {
+            bool matched = false;
+            for (const std::string & filter : filters)
+                matched = matched || entry.name.find(filter) != std::string::npos;
+            if (!matched)
+                continue;
+        }
+
+        if (listOnly)
+        {
+            std::cout << entry.name << std::endl;
+            continue;
+        }
+
+        Context context;
+        context.name = entry.name;
+        entry.function(context);
+
+        for (const std::string & directory : context.tempDirectories)
+        {
+            std::string command = "rm -rf '" + directory + "'";
+            if (system(command.c_str())) {}
+        }
+
+        if (!context.failures.empty())
+        {
+            failed++;
+            std::cout << "FAIL " << entry.name << std::endl;
+            for (const std::string & failure : context.failures)
+                std::cout << "     " << failure << std::endl;
+        }
+        else if (!context.skipReason.empty())
+        {
+            skipped++;
+            std::cout << "SKIP " << entry.name << " (" << context.skipReason << ")" << std::endl;
+        }
+        else
+        {
+            passed++;
+            std::cout << "PASS " << entry.name << std::endl;
+        }
+    }
+
+    if (listOnly)
+        return 0;
+
+    std::cout << passed << " passed, " << failed << " failed, " << skipped << " skipped" << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,43 @@
+#include "test.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace Mantids30::Tests;
+
+bool Context::check(bool result, const char *expression, const char *file, int line)
+{
+    if (!result)
+    {
+        std::ostringstream failure;
+        failure << file << ":" << line << ": CHECK(" << expression << ") failed";
+        failures.push_back(failure.str());
+    }
+    return result;
+}
+
+void Context::skip(const std::string &reason)
+{
+    skipReason = reason;
+}
+
+std::string Context::getTempDirectory()
+{
+    char path[] = "/tmp/mantids30_test_XXXXXX";
+    if (!mkdtemp(path))
+        return "";
+    tempDirectories.push_back(path);
+    return path;
+}
+
+bool Registry::add(const std::string &name, Function function)
+{
+    getEntries().push_back({name, function});
+    return true;
+}
+
+std::vector<Registry::Entry> &Registry::getEntries()
+{
+    static std::vector<Entry> entries;
+    return entries;
+}
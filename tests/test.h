@@ -0,0 +1,64 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Mantids30 { namespace Tests {
+
+/**
+ * @brief The Context class collects the failed checks of a single test case.
+ */
+class Context
+{
+public:
+    /**
+     * @brief check Record the result of a check.
+     * @return the check result.
+     */
+    bool check(bool result, const char * expression, const char * file, int line);
+    /**
+     * @brief skip Report the test case as skipped (eg. missing privileges).
+     */
+    void skip(const std::string & reason);
+    /**
+     * @brief getTempDirectory Get an empty directory removed after the test case.
+     */
+    std::string getTempDirectory();
+
+    std::string name;
+    std::vector<std::string> failures;
+    std::string skipReason;
+    std::vector<std::string> tempDirectories;
+};
+
+/**
+ * @brief The Registry class keeps every test case linked into the executable.
+ */
+class Registry
+{
+public:
+    typedef void (*Function)(Context & context);
+
+    struct Entry
+    {
+        std::string name;
+        Function function;
+    };
+
+    /**
+     * @brief add Register a test case (called from the static initializers of each test file).
+     */
+    static bool add(const std::string & name, Function function);
+    static std::vector<Entry> & getEntries();
+};
+
+}}
+
+#define MANTIDS_TEST(NAME, FUNCTION) \
+    static bool FUNCTION##_registered = Mantids30::Tests::Registry::add(NAME, &FUNCTION);
+
+// Records the failure and keeps going:
+#define CHECK(EXPR) context.check(static_cast<bool>(EXPR), #EXPR, __FILE__, __LINE__)
+// Records the failure and ends the test case:
+#define REQUIRE(EXPR) do { if (!CHECK(EXPR)) return; } while (0)
@@ -0,0 +1,268 @@
+#include "test.h"
+
+#include <Mantids30/Memory/streamablestring.h>
+#include <Mantids30/Net_Sockets/socket_tcp.h>
+#include <Mantids30/Server_WebCore/apiproxy.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Sockets;
+using namespace Mantids30::Network::Servers::Web;
+using namespace Mantids30::Network::Protocols;
+
+// Keep-alive HTTP/1.1 upstream that answers "<method> <uri>" (optionally dropping the second request of every
+// connection without answering it, as a server closing an idle connection at the same time it is reused, or answering
+// with a chunked body):
+class Upstream
+{
+public:
+    Upstream(bool dropSecondRequest = false, bool chunked = false)
+        : m_dropSecondRequest(dropSecondRequest)
+        , m_chunked(chunked)
+    {
+        m_ok = m_listener.listenOn(0, "127.0.0.1") && m_listener.getPort();
+        if (m_ok)
+            m_acceptor = std::thread([this]() { acceptConnections(); });
+    }
+    ~Upstream()
+    {
+        if (m_ok)
+        {
+            m_listener.stopAccepting();
+            m_acceptor.join();
+        }
+        for (auto &connection : m_connections)
+            connection.join();
+    }
+
+    bool isListening() const { return m_ok; }
+    uint16_t getPort() { return m_listener.getPort(); }
+    int getConnectionCount() { return m_connectionCount; }
+    int getRequestCount() { return m_requestCount; }
+
+private:
+    void acceptConnections()
+    {
+        for (;;)
+        {
+            std::shared_ptr<Socket_Stream> client = m_listener.acceptConnection();
+            if (!client)
+                return;
+            m_connectionCount++;
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_connections.emplace_back([this, client]() { serve(client); });
+        }
+    }
+
+    void serve(std::shared_ptr<Socket_Stream> client)
+    {
+        std::string received;
+        char buffer[4096];
+        for (int requests = 0;;)
+        {
+            size_t end;
+            while ((end = received.find("\r\n\r\n")) == std::string::npos)
+            {
+                ssize_t r = client->partialRead(buffer, sizeof(buffer));
+                if (r <= 0)
+                    return;
+                received.append(buffer, static_cast<size_t>(r));
+            }
+            std::string requestLine = received.substr(0, received.find("\r\n"));
+            received.erase(0, end + 4);
+            m_requestCount++;
+
+            if (++requests == 2 && m_dropSecondRequest)
+            {
+                client->shutdownSocket();
+                return;
+            }
+
+            std::string body = requestLine.substr(0, requestLine.rfind(' '));
+            std::string answer = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: keep-alive\r\n";
+            if (m_chunked)
+            {
+                // The body comes after the headers (so its size is still unknown when they are received):
+                answer += "Transfer-Encoding: chunked\r\n\r\n";
+                if (!client->writeFull(answer.data(), answer.size()))
+                    return;
+                usleep(50000);
+                answer = toHex(body.size()) + "\r\n" + body + "\r\n0\r\n\r\n";
+            }
+            else
+                answer += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            if (!client->writeFull(answer.data(), answer.size()))
+                return;
+        }
+    }
+
+    static std::string toHex(size_t value)
+    {
+        char hex[32];
+        snprintf(hex, sizeof(hex), "%zx", value);
+        return hex;
+    }
+
+    Socket_TCP m_listener;
+    bool m_ok = false;
+    bool m_dropSecondRequest, m_chunked;
+    std::thread m_acceptor;
+    std::mutex m_mutex;
+    std::list<std::thread> m_connections;
+    std::atomic<int> m_connectionCount{0}, m_requestCount{0};
+};
+
+static std::shared_ptr<ApiProxyParameters> createParameters(Upstream &upstream)
+{
+    auto params = std::make_shared<ApiProxyParameters>();
+    params->useTLS = false;
+    params->remoteHost = "127.0.0.1";
+    params->remotePort = upstream.getPort();
+    params->upstreamPool = std::make_shared<UpstreamPool>();
+    return params;
+}
+
+// Proxies one request, giving back the status code and the streamed body (and how it's sent to the client):
+static HTTP::Status::Codes proxy(std::shared_ptr<ApiProxyParameters> params, const std::string &method, const std::string &internalPath, std::string *body,
+                                 HTTP::Content::eTransmitionMode *transmitionMode = nullptr, uint16_t clientMinorVersion = 1)
+{
+    HTTP::HTTPv1_Base::Request request;
+    request.requestLine.setRequestMethod(method);
+    request.requestLine.setRequestURI("/proxy" + internalPath);
+    request.requestLine.getHTTPVersion()->setMajor(1);
+    request.requestLine.getHTTPVersion()->setMinor(clientMinorVersion);
+
+    HTTP::HTTPv1_Base::Response response;
+    HTTP::Status::Codes code = ApiProxy(internalPath, &request, &response, params);
+    if (transmitionMode)
+        *transmitionMode = response.content.getTransmitionMode();
+
+    Mantids30::Memory::Streams::StreamableString output;
+    if (response.content.getStreamableObj())
+        response.content.getStreamableObj()->streamTo(&output);
+    *body = output.getValue();
+    return code;
+}
+
+static void testKeepAlive(Context &context)
+{
+    Upstream upstream;
+    REQUIRE(upstream.isListening());
+    auto params = createParameters(upstream);
+
+    std::string body;
+    CHECK(proxy(params, "GET", "/first", &body) == HTTP::Status::S_200_OK);
+    CHECK(body == "GET /first");
+    CHECK(proxy(params, "GET", "/second", &body) == HTTP::Status::S_200_OK);
+    CHECK(body == "GET /second");
+
+    // Both requests over the same upstream connection:
+    CHECK(upstream.getConnectionCount() == 1);
+    CHECK(params->upstreamPool->getIdleCount() == 1);
+    params->upstreamPool->closeIdle();
+}
+
+static void testRetryOnlyIdempotentMethods(Context &context)
+{
+    std::string body;
+
+    for (const char *method : {"GET", "PUT", "DELETE"})
+    {
+        Upstream upstream(true);
+        REQUIRE(upstream.isListening());
+        auto params = createParameters(upstream);
+
+        CHECK(proxy(params, "GET", "/warm", &body) == HTTP::Status::S_200_OK);
+        // The reused connection drops it, then it's sent again over a new one:
+        CHECK(proxy(params, method, "/retried", &body) == HTTP::Status::S_200_OK);
+        CHECK(body == std::string(method) + " /retried");
+        CHECK(upstream.getConnectionCount() == 2);
+        params->upstreamPool->closeIdle();
+    }
+
+    for (const char *method : {"POST", "PATCH", "LOCK"})
+    {
+        Upstream upstream(true);
+        REQUIRE(upstream.isListening());
+        auto params = createParameters(upstream);
+
+        CHECK(proxy(params, "GET", "/warm", &body) == HTTP::Status::S_200_OK);
+        // It may have been processed, never sent twice:
+        CHECK(proxy(params, method, "/not_retried", &body) == HTTP::Status::S_502_BAD_GATEWAY);
+        CHECK(upstream.getConnectionCount() == 1);
+        CHECK(upstream.getRequestCount() == 2);
+        params->upstreamPool->closeIdle();
+    }
+}
+
+static void testChunkedUpstreamResponse(Context &context)
+{
+    Upstream upstream(false, true);
+    REQUIRE(upstream.isListening());
+    auto params = createParameters(upstream);
+
+    // Unknown size: chunked to HTTP/1.1 clients (keeping their connection), and until closing for HTTP/1.0 clients.
+    std::string body;
+    HTTP::Content::eTransmitionMode transmitionMode;
+    CHECK(proxy(params, "GET", "/chunked", &body, &transmitionMode) == HTTP::Status::S_200_OK);
+    CHECK(body == "GET /chunked");
+    CHECK(transmitionMode == HTTP::Content::TRANSMIT_MODE_CHUNKS);
+
+    CHECK(proxy(params, "GET", "/chunked10", &body, &transmitionMode, 0) == HTTP::Status::S_200_OK);
+    CHECK(body == "GET /chunked10");
+    CHECK(transmitionMode == HTTP::Content::TRANSMIT_MODE_CONNECTION_CLOSE);
+
+    // With a known size:
+    Upstream sized;
+    REQUIRE(sized.isListening());
+    auto sizedParams = createParameters(sized);
+    CHECK(proxy(sizedParams, "GET", "/sized", &body, &transmitionMode) == HTTP::Status::S_200_OK);
+    CHECK(transmitionMode == HTTP::Content::TRANSMIT_MODE_CONTENT_LENGTH);
+
+    params->upstreamPool->closeIdle();
+    sizedParams->upstreamPool->closeIdle();
+}
+
+static void testUnusedHostsAreForgotten(Context &context)
+{
+    Upstream first, second;
+    REQUIRE(first.isListening() && second.isListening());
+
+    auto firstParams = createParameters(first);
+    auto secondParams = createParameters(second);
+    firstParams->idleTimeoutSeconds = secondParams->idleTimeoutSeconds = 0;
+    secondParams->upstreamPool = firstParams->upstreamPool;
+    auto pool = firstParams->upstreamPool;
+
+    std::string body;
+    CHECK(proxy(firstParams, "GET", "/", &body) == HTTP::Status::S_200_OK);
+    CHECK(pool->getHostCount() == 1);
+
+    // Still has an idle connection:
+    CHECK(proxy(secondParams, "GET", "/", &body) == HTTP::Status::S_200_OK);
+    CHECK(pool->getHostCount() == 2);
+
+    pool->closeIdle();
+    CHECK(proxy(secondParams, "GET", "/", &body) == HTTP::Status::S_200_OK);
+    CHECK(pool->getHostCount() == 2);
+
+    // Without connections, the first one is forgotten when another destination is added:
+    pool->closeIdle();
+    auto thirdParams = createParameters(first);
+    thirdParams->remoteHost = "localhost";
+    thirdParams->upstreamPool = pool;
+    CHECK(proxy(thirdParams, "GET", "/", &body) == HTTP::Status::S_200_OK);
+    CHECK(pool->getHostCount() == 1);
+    pool->closeIdle();
+}
+
+MANTIDS_TEST("apiproxy.keep_alive", testKeepAlive)
+MANTIDS_TEST("apiproxy.retry_only_idempotent_methods", testRetryOnlyIdempotentMethods)
+MANTIDS_TEST("apiproxy.chunked_upstream_response", testChunkedUpstreamResponse)
+MANTIDS_TEST("apiproxy.unused_hosts_are_forgotten", testUnusedHostsAreForgotten)
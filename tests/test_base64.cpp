@@ -0,0 +1,185 @@
+#include "test.h"
+
+#include <Mantids30/Helpers/encoders.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Helpers;
+
+// Sizes around the SIMD block boundaries (12/24 bytes in, 16/32 chars out) and the tails:
+static std::vector<size_t> testSizes()
+{
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i <= 200; i++)
+        sizes.push_back(i);
+    for (size_t i : {1023, 1024, 1025, 4095, 4096, 4097, 65537})
+        sizes.push_back(i);
+    return sizes;
+}
+
+static std::string encode(Encoders::BASE64_IMPLEMENTATION implementation, const std::string &data, bool url)
+{
+    Encoders::setBase64Implementation(implementation);
+    std::string out(Encoders::getBase64EncodedLength(data.size(), url), '\0');
+    out.resize(Encoders::encodeToBase64Buffer(reinterpret_cast<const unsigned char *>(data.data()), data.size(), &out[0], url));
+    return out;
+}
+
+static bool decode(Encoders::BASE64_IMPLEMENTATION implementation, const std::string &input, std::string &output, bool url)
+{
+    Encoders::setBase64Implementation(implementation);
+    output.assign(Encoders::getBase64DecodedMaxLength(input.size()), '\0');
+    size_t outLength = 0;
+    bool r = Encoders::decodeFromBase64Buffer(input.data(), input.size(), reinterpret_cast<unsigned char *>(&output[0]), outLength, url);
+    output.resize(r ? outLength : 0);
+    return r;
+}
+
+static std::string randomData(std::mt19937 &rng, size_t size)
+{
+    std::string data(size, '\0');
+    for (auto &c : data)
+        c = static_cast<char>(rng() & 0xFF);
+    return data;
+}
+
+static void testScalarReference(Context &context)
+{
+    REQUIRE(Encoders::setBase64Implementation(Encoders::BASE64_SCALAR));
+
+    // RFC 4648 test vectors:
+    const std::pair<std::string, std::string> vectors[] = {{"", ""},
+                                                           {"f", "Zg=="},
+                                                           {"fo", "Zm8="},
+                                                           {"foo", "Zm9v"},
+                                                           {"foob", "Zm9vYg=="},
+                                                           {"fooba", "Zm9vYmE="},
+                                                           {"foobar", "Zm9vYmFy"}};
+    for (const auto &vector : vectors)
+    {
+        CHECK(Encoders::encodeToBase64(vector.first) == vector.second);
+        CHECK(Encoders::decodeFromBase64(vector.second) == vector.first);
+    }
+
+    CHECK(Encoders::encodeToBase64(std::string("\xfb\xff\xbf", 3)) == "+/+/");
+    CHECK(Encoders::encodeToBase64(std::string("\xfb\xff\xbf", 3), true) == "-_-_");
+    CHECK(Encoders::encodeToBase64("f", true) == "Zg");
+
+    Encoders::setBase64Implementation(Encoders::BASE64_AUTO);
+}
+
+static void testRoundTrip(Context &context)
+{
+    std::mt19937 rng(1234);
+    const Encoders::BASE64_IMPLEMENTATION implementations[] = {Encoders::BASE64_SCALAR, Encoders::BASE64_SSSE3, Encoders::BASE64_AVX2};
+
+    for (auto implementation : implementations)
+    {
+        if (!Encoders::setBase64Implementation(implementation))
+            continue;
+
+        size_t failures = 0;
+        for (size_t size : testSizes())
+        {
+            std::string data = randomData(rng, size), decoded;
+            for (bool url : {false, true})
+            {
+                std::string encoded = encode(implementation, data, url);
+                // Same output as the scalar reference:
+                if (encoded != encode(Encoders::BASE64_SCALAR, data, url))
+                    failures++;
+                if (!decode(implementation, encoded, decoded, url) || decoded != data)
+                    failures++;
+            }
+        }
+        CHECK(failures == 0);
+    }
+
+    Encoders::setBase64Implementation(Encoders::BASE64_AUTO);
+}
+
+static void testPadding(Context &context)
+{
+    std::mt19937 rng(5678);
+    const Encoders::BASE64_IMPLEMENTATION implementations[] = {Encoders::BASE64_SCALAR, Encoders::BASE64_SSSE3, Encoders::BASE64_AVX2};
+
+    for (auto implementation : implementations)
+    {
+        if (!Encoders::setBase64Implementation(implementation))
+            continue;
+
+        size_t failures = 0;
+        for (size_t size : testSizes())
+        {
+            std::string data = randomData(rng, size), decoded;
+            static const size_t paddingBySize[] = {0, 2, 1};
+            size_t padding = paddingBySize[size % 3];
+
+            std::string encoded = encode(implementation, data, false);
+            if (encoded.size() != Encoders::getBase64EncodedLength(size) || encoded.size() % 4 != 0)
+                failures++;
+            if (encoded.size() - encoded.find_last_not_of('=') - 1 != padding && size != 0)
+                failures++;
+
+            // The url alphabet is not padded:
+            std::string urlEncoded = encode(implementation, data, true);
+            if (urlEncoded.size() != Encoders::getBase64EncodedLength(size, true) || urlEncoded.find('=') != std::string::npos)
+                failures++;
+
+            // The padding is optional when decoding:
+            std::string unpadded = encoded.substr(0, encoded.size() - padding);
+            if (!decode(implementation, unpadded, decoded, false) || decoded != data)
+                failures++;
+        }
+        CHECK(failures == 0);
+    }
+
+    Encoders::setBase64Implementation(Encoders::BASE64_AUTO);
+}
+
+static void testInvalidInput(Context &context)
+{
+    std::mt19937 rng(9012);
+    const Encoders::BASE64_IMPLEMENTATION implementations[] = {Encoders::BASE64_SCALAR, Encoders::BASE64_SSSE3, Encoders::BASE64_AVX2};
+
+    for (auto implementation : implementations)
+    {
+        if (!Encoders::setBase64Implementation(implementation))
+            continue;
+
+        std::string decoded;
+        // A single char in the last quantum can't encode a byte:
+        CHECK(!decode(implementation, "Zm9vY", decoded, false));
+        // More than two padding chars, or padding in the middle:
+        CHECK(!decode(implementation, "Zg==Zg==", decoded, false));
+        CHECK(!decode(implementation, "Z===", decoded, false));
+        // Chars from the other alphabet:
+        CHECK(!decode(implementation, "+/+/", decoded, true));
+        CHECK(!decode(implementation, "-_-_", decoded, false));
+
+        // Bad chars at every position, inside the SIMD blocks and in the scalar tail:
+        std::string encoded = encode(implementation, randomData(rng, 300), false);
+        size_t failures = 0;
+        for (size_t pos = 0; pos < encoded.size(); pos++)
+        {
+            for (char bad : {'\n', ' ', '*', '\0', '\x80', '\xff'})
+            {
+                std::string corrupted = encoded;
+                corrupted[pos] = bad;
+                if (decode(implementation, corrupted, decoded, false))
+                    failures++;
+            }
+        }
+        CHECK(failures == 0);
+    }
+
+    Encoders::setBase64Implementation(Encoders::BASE64_AUTO);
+}
+
+MANTIDS_TEST("base64.scalar_reference", testScalarReference)
+MANTIDS_TEST("base64.round_trip", testRoundTrip)
+MANTIDS_TEST("base64.padding", testPadding)
+MANTIDS_TEST("base64.invalid_input", testInvalidInput)
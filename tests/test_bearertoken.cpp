@@ -0,0 +1,33 @@
+#include "test.h"
+
+#include <Mantids30/Server_WebCore/bearertoken.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Servers::Web;
+using namespace Mantids30::Network::Protocols;
+
+static HTTP::Status::Codes check(const std::string &bearerToken, const std::string &authorization)
+{
+    HTTP::HTTPv1_Base::Request request;
+    if (!authorization.empty())
+        request.headers.add("Authorization", authorization);
+    return checkBearerToken(&request, bearerToken);
+}
+
+static void testBearerToken(Context &context)
+{
+    // Never served without an expected token:
+    CHECK(check("", "") == HTTP::Status::S_403_FORBIDDEN);
+    CHECK(check("", "Bearer ") == HTTP::Status::S_403_FORBIDDEN);
+
+    CHECK(check("secret", "") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(check("secret", "Bearer other") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(check("secret", "Bearer secreT") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(check("secret", "Bearer secret2") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(check("secret", "Bearer secre") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(check("secret", "Basic secret") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(check("secret", "secret") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(check("secret", "Bearer secret") == HTTP::Status::S_200_OK);
+}
+
+MANTIDS_TEST("bearertoken.check", testBearerToken)
@@ -0,0 +1,219 @@
+#include "test.h"
+
+#include <Mantids30/Net_Sockets/socket_tcp.h>
+#include <Mantids30/Net_Sockets/streams_bridge.h>
+
+#include <chrono>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Sockets;
+using namespace Mantids30::Network::Sockets::NetStreams;
+
+enum BridgeMode
+{
+    BRIDGE_THREADED,
+    BRIDGE_SPLICE,
+    // Splice requested, but a peer is not a raw stream, so it falls back to the threaded mode:
+    BRIDGE_SPLICE_FALLBACK
+};
+
+static bool connectLoopback(std::shared_ptr<Socket_Stream> &client, std::shared_ptr<Socket_Stream> &server)
+{
+    Socket_TCP listener;
+    if (!listener.listenOn(0, "127.0.0.1") || !listener.getPort())
+        return false;
+    auto tcpClient = std::make_shared<Socket_TCP>();
+    if (!tcpClient->connectFrom(nullptr, "127.0.0.1", listener.getPort()))
+        return false;
+    client = tcpClient;
+    server = listener.acceptConnection();
+    return server != nullptr;
+}
+
+// client <-> [peer 0 | bridge | peer 1] <-> server, processed in its own thread:
+class BridgedConnection
+{
+public:
+    BridgedConnection(BridgeMode mode, unsigned int readTimeout = 0, size_t pipeSize = 0)
+        : m_mode(mode)
+    {
+        std::shared_ptr<Socket_Stream> peers[2];
+        if (!connectLoopback(client, peers[0]))
+            return;
+        if (mode == BRIDGE_SPLICE_FALLBACK)
+        {
+            auto pair = Socket_Stream::GetSocketPair();
+            peers[1] = pair.first;
+            server = pair.second;
+        }
+        else if (!connectLoopback(peers[1], server))
+            return;
+        if (!peers[1] || !server)
+            return;
+
+        for (auto &peer : peers)
+            peer->setReadTimeout(readTimeout);
+        m_bridge.setPeer(SIDE_BACKWARD, peers[0]);
+        m_bridge.setPeer(SIDE_FORWARD, peers[1]);
+
+        if (mode != BRIDGE_THREADED)
+        {
+            m_bridge.setUseSplice(true);
+            auto reactor = std::make_shared<Bridge_SpliceReactor>();
+            if (pipeSize)
+                reactor->setPipeSize(pipeSize);
+            m_bridge.setSpliceReactor(reactor);
+        }
+
+        m_started = true;
+        m_thread = std::thread([this]() { m_result = m_bridge.process(); });
+    }
+    ~BridgedConnection()
+    {
+        if (m_started)
+        {
+            client->shutdownSocket();
+            server->shutdownSocket();
+            m_thread.join();
+        }
+    }
+
+    bool isStarted() const { return m_started; }
+    // Splice only when requested and both peers are raw streams:
+    bool hasExpectedMode() { return m_bridge.isUsingSplice() == (m_mode == BRIDGE_SPLICE); }
+
+    int join()
+    {
+        m_thread.join();
+        m_started = false;
+        return m_result;
+    }
+
+    Bridge &getBridge() { return m_bridge; }
+
+    std::shared_ptr<Socket_Stream> client, server;
+
+private:
+    BridgeMode m_mode;
+    Bridge m_bridge;
+    bool m_started = false;
+    std::thread m_thread;
+    int m_result = -1;
+};
+
+static std::string createPayload(size_t size)
+{
+    std::string payload(size, 0);
+    for (size_t i = 0; i < size; i++)
+        payload[i] = static_cast<char>(i % 251);
+    return payload;
+}
+
+static std::string readUntilEOF(std::shared_ptr<Socket_Stream> socket)
+{
+    std::string received;
+    char buffer[65536];
+    ssize_t r;
+    while ((r = socket->partialRead(buffer, sizeof(buffer))) > 0)
+        received.append(buffer, static_cast<size_t>(r));
+    return received;
+}
+
+static void transferAndEOF(Context &context, BridgeMode mode)
+{
+    BridgedConnection connection(mode);
+    REQUIRE(connection.isStarted());
+
+    std::string payload = createPayload(4 * 1024 * 1024);
+    std::thread writer([&]() {
+        connection.client->writeFull(payload.data(), payload.size());
+        // The client closes: the bridge delivers everything and then closes the server side.
+        connection.client->shutdownSocket();
+    });
+    std::string received = readUntilEOF(connection.server);
+    writer.join();
+
+    CHECK(received == payload);
+    // Any of them may be reported (both readers end):
+    CHECK(connection.join() != -1);
+    CHECK(connection.hasExpectedMode());
+    CHECK(connection.getBridge().getSentBytes() == payload.size());
+    CHECK(connection.getBridge().getRecvBytes() == 0);
+}
+
+static void idleTimeout(Context &context, BridgeMode mode)
+{
+    auto start = std::chrono::steady_clock::now();
+    BridgedConnection connection(mode, 1);
+    REQUIRE(connection.isStarted());
+
+    // Nothing is sent: both ends are closed after the read timeout.
+    CHECK(readUntilEOF(connection.server).empty());
+    CHECK(readUntilEOF(connection.client).empty());
+    connection.join();
+    CHECK(connection.hasExpectedMode());
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    CHECK(elapsed >= 900);
+    CHECK(elapsed < 5000);
+}
+
+static void partialTransfers(Context &context, BridgeMode mode)
+{
+    // Small pipes and a slow reader: the writes to the server side are partial (and wait for room).
+    BridgedConnection connection(mode, 0, 4096);
+    REQUIRE(connection.isStarted());
+
+    // Both directions at the same time (the client ends after getting the whole answer, as ending a direction
+    // finishes the bridge):
+    std::string payload = createPayload(512 * 1024), answer = createPayload(3000), answerReceived;
+    std::thread client([&]() {
+        connection.client->writeFull(payload.data(), payload.size());
+        char buffer[1000];
+        ssize_t r;
+        while (answerReceived.size() < answer.size() && (r = connection.client->partialRead(buffer, sizeof(buffer))) > 0)
+            answerReceived.append(buffer, static_cast<size_t>(r));
+        connection.client->shutdownSocket();
+    });
+    CHECK(connection.server->writeFull(answer.data(), answer.size()));
+
+    std::string received;
+    char buffer[1000];
+    ssize_t r;
+    while ((r = connection.server->partialRead(buffer, sizeof(buffer))) > 0)
+    {
+        received.append(buffer, static_cast<size_t>(r));
+        usleep(200);
+    }
+    client.join();
+
+    CHECK(received == payload);
+    CHECK(answerReceived == answer);
+    CHECK(connection.join() != -1);
+    CHECK(connection.hasExpectedMode());
+    CHECK(connection.getBridge().getSentBytes() == payload.size());
+    CHECK(connection.getBridge().getRecvBytes() == answer.size());
+}
+
+static void testTransferAndEOFThreaded(Context &context) { transferAndEOF(context, BRIDGE_THREADED); }
+static void testTransferAndEOFSplice(Context &context) { transferAndEOF(context, BRIDGE_SPLICE); }
+static void testTransferAndEOFSpliceFallback(Context &context) { transferAndEOF(context, BRIDGE_SPLICE_FALLBACK); }
+static void testIdleTimeoutThreaded(Context &context) { idleTimeout(context, BRIDGE_THREADED); }
+static void testIdleTimeoutSplice(Context &context) { idleTimeout(context, BRIDGE_SPLICE); }
+static void testIdleTimeoutSpliceFallback(Context &context) { idleTimeout(context, BRIDGE_SPLICE_FALLBACK); }
+static void testPartialTransfersThreaded(Context &context) { partialTransfers(context, BRIDGE_THREADED); }
+static void testPartialTransfersSplice(Context &context) { partialTransfers(context, BRIDGE_SPLICE); }
+static void testPartialTransfersSpliceFallback(Context &context) { partialTransfers(context, BRIDGE_SPLICE_FALLBACK); }
+
+MANTIDS_TEST("bridge.transfer_and_eof_threaded", testTransferAndEOFThreaded)
+MANTIDS_TEST("bridge.transfer_and_eof_splice", testTransferAndEOFSplice)
+MANTIDS_TEST("bridge.transfer_and_eof_splice_fallback", testTransferAndEOFSpliceFallback)
+MANTIDS_TEST("bridge.idle_timeout_threaded", testIdleTimeoutThreaded)
+MANTIDS_TEST("bridge.idle_timeout_splice", testIdleTimeoutSplice)
+MANTIDS_TEST("bridge.idle_timeout_splice_fallback", testIdleTimeoutSpliceFallback)
+MANTIDS_TEST("bridge.partial_transfers_threaded", testPartialTransfersThreaded)
+MANTIDS_TEST("bridge.partial_transfers_splice", testPartialTransfersSplice)
+MANTIDS_TEST("bridge.partial_transfers_splice_fallback", testPartialTransfersSpliceFallback)
@@ -0,0 +1,150 @@
+#include "test.h"
+
+#include <Mantids30/Net_Sockets/streams_bufferedreader.h>
+
+#include <deque>
+#include <string.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Sockets;
+using namespace Mantids30::Network::Sockets::NetStreams;
+
+// Serves each chunk in its own read (or in several reads if the reader has less room), then EOF:
+class ChunkStream : public Socket_Stream
+{
+public:
+    ChunkStream(std::initializer_list<std::string> chunks)
+        : m_chunks(chunks)
+    {
+    }
+    ssize_t partialRead(void *data, const size_t &datalen) override
+    {
+        if (m_chunks.empty())
+            return 0;
+        size_t len = std::min(datalen, m_chunks.front().size());
+        memcpy(data, m_chunks.front().data(), len);
+        m_chunks.front().erase(0, len);
+        if (m_chunks.front().empty())
+            m_chunks.pop_front();
+        return static_cast<ssize_t>(len);
+    }
+
+private:
+    std::deque<std::string> m_chunks;
+};
+
+static void testCompaction(Context &context)
+{
+    // The second line reaches the buffer end and must be moved to the front to be completed:
+    BufferedReader reader(std::make_shared<ChunkStream>(std::initializer_list<std::string>{"0123456789\nabcd", "efgh\nijklmnopqrstuvwxyz"}), 16);
+    REQUIRE(reader.getBufferOK());
+
+    std::string_view line;
+    REQUIRE(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(line == "0123456789");
+    REQUIRE(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(line == "abcdefgh");
+
+    // A line longer than the buffer can't be compacted:
+    CHECK(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_FULL);
+}
+
+static void testCRLFSplitAcrossReads(Context &context)
+{
+    BufferedReader reader(std::make_shared<ChunkStream>(std::initializer_list<std::string>{"one\r", "\ntwo\r\n", "three\n", "four\r", "five\r\n\r\n"}), 1024);
+
+    std::string_view line;
+    REQUIRE(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(line == "one");
+    // The LF received in the next read completes the CRLF, it is not an empty line:
+    REQUIRE(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(line == "two");
+    REQUIRE(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(line == "three");
+    // A CR followed by something else is a line terminator on its own:
+    REQUIRE(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(line == "four");
+    REQUIRE(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(line == "five");
+    REQUIRE(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(line.empty());
+
+    CHECK(reader.readLine(&line) == BufferedReader::E_STREAMBUFFER_READ_DISCONNECTED);
+}
+
+static void testReadLines(Context &context)
+{
+    BufferedReader reader(std::make_shared<ChunkStream>(std::initializer_list<std::string>{"a\nb\r\nc\rd", "\n"}), 1024);
+
+    // Every complete line in the buffer, the incomplete one waits for the next read:
+    std::vector<std::string_view> lines;
+    REQUIRE(reader.readLines(&lines) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(std::vector<std::string>(lines.begin(), lines.end()) == std::vector<std::string>({"a", "b", "c"}));
+
+    lines.clear();
+    REQUIRE(reader.readLines(&lines) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(std::vector<std::string>(lines.begin(), lines.end()) == std::vector<std::string>({"d"}));
+
+    lines.clear();
+    CHECK(reader.readLines(&lines) == BufferedReader::E_STREAMBUFFER_READ_DISCONNECTED);
+    CHECK(lines.empty());
+
+    // Limited number of lines per call, the rest remain buffered:
+    BufferedReader limited(std::make_shared<ChunkStream>(std::initializer_list<std::string>{"a\nb\nc\n"}), 1024);
+    REQUIRE(limited.readLines(&lines, 2) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(std::vector<std::string>(lines.begin(), lines.end()) == std::vector<std::string>({"a", "b"}));
+    lines.clear();
+    REQUIRE(limited.readLines(&lines, 2) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(std::vector<std::string>(lines.begin(), lines.end()) == std::vector<std::string>({"c"}));
+}
+
+static void testNoTrailingNUL(Context &context)
+{
+    BufferedReader reader(std::make_shared<ChunkStream>(std::initializer_list<std::string>{"hello\nwor", "ld\rraw\n"}), 1024);
+
+    // The std::string overloads return the data without the delimiter (and without the former NUL):
+    std::string str;
+    REQUIRE(reader.readLineLF(&str) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(str == "hello");
+    CHECK(str.size() == 5);
+    REQUIRE(reader.readLineCR(&str) == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(str == "world");
+
+    // The raw buffer overload still replaces the delimiter with a NUL:
+    char data[16];
+    size_t len = sizeof(data);
+    REQUIRE(reader.bufferedReadUntil(data, &len, '\n') == BufferedReader::E_STREAMBUFFER_READ_OK);
+    CHECK(len == 4);
+    CHECK(memcmp(data, "raw\0", 4) == 0);
+
+    CHECK(reader.readLineLF(&str) == BufferedReader::E_STREAMBUFFER_READ_DISCONNECTED);
+}
+
+static void testFindLineDelimiter(Context &context)
+{
+    // Every position, inside and after the SIMD blocks:
+    size_t failures = 0;
+    for (size_t len = 1; len <= 100; len++)
+    {
+        for (size_t pos = 0; pos < len; pos++)
+        {
+            for (char delimiter : {'\r', '\n'})
+            {
+                std::string data(len, 'x');
+                data[pos] = delimiter;
+                if (BufferedReader::findLineDelimiter(data.data(), len) != data.data() + pos)
+                    failures++;
+            }
+        }
+        std::string data(len, 'x');
+        if (BufferedReader::findLineDelimiter(data.data(), len) != nullptr)
+            failures++;
+    }
+    CHECK(failures == 0);
+}
+
+MANTIDS_TEST("bufferedreader.compaction", testCompaction)
+MANTIDS_TEST("bufferedreader.crlf_split_across_reads", testCRLFSplitAcrossReads)
+MANTIDS_TEST("bufferedreader.read_lines", testReadLines)
+MANTIDS_TEST("bufferedreader.no_trailing_nul", testNoTrailingNUL)
+MANTIDS_TEST("bufferedreader.find_line_delimiter", testFindLineDelimiter)
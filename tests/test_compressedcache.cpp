@@ -0,0 +1,85 @@
+#include "test.h"
+
+#include <Mantids30/Protocol_HTTP/common_compressedcache.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Protocols::HTTP;
+using namespace Mantids30::Memory::Streams::Encoders;
+using namespace Mantids30::Memory::Containers;
+
+// Pseudo-random bytes (does not compress):
+static std::string randomBytes(size_t size, uint32_t seed)
+{
+    std::string r(size, 0);
+    for (auto &c : r)
+    {
+        seed = seed * 1103515245 + 12345;
+        c = static_cast<char>(seed >> 16);
+    }
+    return r;
+}
+
+static void testIncompressibleEntriesAreBounded(Context &context)
+{
+    if (!Compression::isAvailable(Compression::ALGORITHM_GZIP))
+        return context.skip("gzip is not available");
+
+    CompressedContentCache cache;
+    cache.setMaxEntries(100);
+
+    std::string data = randomBytes(4096, 1);
+    B_MEM content(data.data(), data.size());
+    for (int i = 0; i < 1000; i++)
+        CHECK(cache.get("/file" + std::to_string(i), Compression::ALGORITHM_GZIP, &content) == nullptr);
+
+    // Kept without data, but still counted and charged:
+    CHECK(cache.getEntryCount() == 100);
+    CHECK(cache.getTotalSize() > 0);
+    CHECK(!cache.isCompressible("/file999", Compression::ALGORITHM_GZIP));
+    // The oldest ones were discarded (unknown again):
+    CHECK(cache.isCompressible("/file0", Compression::ALGORITHM_GZIP));
+
+    // The byte budget also bounds them:
+    CompressedContentCache smallCache;
+    smallCache.setMaxTotalSize(16 * 1024);
+    for (int i = 0; i < 1000; i++)
+        smallCache.get("/file" + std::to_string(i), Compression::ALGORITHM_GZIP, &content);
+    CHECK(smallCache.getTotalSize() <= 16 * 1024);
+    CHECK(smallCache.getEntryCount() > 0 && smallCache.getEntryCount() < 1000);
+
+    smallCache.clear();
+    CHECK(smallCache.getEntryCount() == 0 && smallCache.getTotalSize() == 0);
+}
+
+static void testCompressedVariants(Context &context)
+{
+    if (!Compression::isAvailable(Compression::ALGORITHM_GZIP))
+        return context.skip("gzip is not available");
+
+    CompressedContentCache cache;
+    std::string data(64 * 1024, 'a');
+    B_MEM content(data.data(), data.size());
+
+    auto variant = cache.get("/index.html", Compression::ALGORITHM_GZIP, &content);
+    REQUIRE(variant != nullptr);
+    CHECK(variant->size() < data.size());
+    CHECK(cache.getEntryCount() == 1);
+    CHECK(cache.getTotalSize() > variant->size());
+
+    // Cached (the content is not used again):
+    auto again = cache.get("/index.html", Compression::ALGORITHM_GZIP, nullptr);
+    CHECK(again == nullptr);
+    B_MEM empty;
+    again = cache.get("/index.html", Compression::ALGORITHM_GZIP, &empty);
+    REQUIRE(again != nullptr);
+    CHECK(again->size() == variant->size());
+
+    // A budget below the per-entry overhead keeps nothing:
+    cache.setMaxTotalSize(64);
+    cache.get("/other.html", Compression::ALGORITHM_GZIP, &content);
+    CHECK(cache.getEntryCount() == 0);
+    CHECK(cache.getTotalSize() == 0);
+}
+
+MANTIDS_TEST("compressedcache.incompressible_entries_are_bounded", testIncompressibleEntriesAreBounded)
+MANTIDS_TEST("compressedcache.compressed_variants", testCompressedVariants)
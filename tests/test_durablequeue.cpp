@@ -0,0 +1,266 @@
+#include "test.h"
+
+#include <Mantids30/Protocol_FastRPC3/durablequeue.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Protocols::FastRPC;
+
+// On-disk layout (see durablequeue.cpp): 24 bytes header (magic, length, expiration, crc, consumed), 8-byte aligned records.
+static const size_t RECORD_HEADER_SIZE = 24;
+static const size_t RECORD_CRC_OFFSET = 16;
+
+static size_t getRecordSize(const size_t &length)
+{
+    return (RECORD_HEADER_SIZE + length + 7) & ~static_cast<size_t>(7);
+}
+
+static uint64_t getCurrentTimeMS()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// Every file in the (single) peer directory, sorted:
+static std::vector<std::string> listSegments(const std::string &directory)
+{
+    std::vector<std::string> r;
+    if (DIR *dir = opendir(directory.c_str()))
+    {
+        while (struct dirent *entry = readdir(dir))
+        {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..")
+                continue;
+            std::string peerDirectory = directory + "/" + name;
+            if (DIR *segmentsDir = opendir(peerDirectory.c_str()))
+            {
+                while (struct dirent *segment = readdir(segmentsDir))
+                {
+                    if (segment->d_name[0] != '.')
+                        r.push_back(peerDirectory + "/" + segment->d_name);
+                }
+                closedir(segmentsDir);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(r.begin(), r.end());
+    return r;
+}
+
+static bool flipByte(const std::string &path, const size_t &offset)
+{
+    FILE *fp = fopen(path.c_str(), "r+b");
+    if (!fp)
+        return false;
+    bool r = fseek(fp, static_cast<long>(offset), SEEK_SET) == 0;
+    int c = r ? fgetc(fp) : EOF;
+    r = r && c != EOF && fseek(fp, static_cast<long>(offset), SEEK_SET) == 0 && fputc(c ^ 0xFF, fp) != EOF;
+    fclose(fp);
+    return r;
+}
+
+// Drains the peer, returning the messages in order:
+static std::vector<std::string> drain(DurableQueue &queue, const std::string &peerKey, size_t max = SIZE_MAX)
+{
+    std::vector<std::string> r;
+    DurableQueue::Message message;
+    while (r.size() < max && queue.front(peerKey, &message))
+    {
+        r.push_back(message.data);
+        queue.consume(peerKey, message);
+    }
+    return r;
+}
+
+static void testReopenKeepsOrder(Context &context)
+{
+    std::string directory = context.getTempDirectory();
+    REQUIRE(!directory.empty());
+
+    {
+        DurableQueue queue;
+        REQUIRE(queue.open(directory));
+        for (int i = 0; i < 100; i++)
+            REQUIRE(queue.append("peer", "message " + std::to_string(i), 0, i == 99));
+        CHECK(queue.hasPending("peer"));
+        CHECK(queue.listPendingPeers() == std::set<std::string>{"peer"});
+    }
+    {
+        DurableQueue queue;
+        REQUIRE(queue.open(directory));
+        auto messages = drain(queue, "peer", 40);
+        REQUIRE(messages.size() == 40);
+        CHECK(messages.front() == "message 0" && messages.back() == "message 39");
+        queue.commit();
+    }
+    {
+        // Consumed messages are not delivered again:
+        DurableQueue queue;
+        REQUIRE(queue.open(directory));
+        auto messages = drain(queue, "peer");
+        REQUIRE(messages.size() == 60);
+        CHECK(messages.front() == "message 40" && messages.back() == "message 99");
+        CHECK(!queue.hasPending("peer"));
+    }
+}
+
+static void testCorruptedRecordEndsRecovery(Context &context)
+{
+    std::string directory = context.getTempDirectory();
+    REQUIRE(!directory.empty());
+
+    {
+        DurableQueue queue;
+        REQUIRE(queue.open(directory));
+        REQUIRE(queue.append("peer", "first", 0));
+        REQUIRE(queue.append("peer", "second", 0));
+        REQUIRE(queue.append("peer", "third", 0, true));
+    }
+
+    auto segments = listSegments(directory);
+    REQUIRE(segments.size() == 1);
+    // Bad CRC in the second record: the third one (valid) must not be recovered either.
+    REQUIRE(flipByte(segments[0], getRecordSize(5) + RECORD_CRC_OFFSET));
+
+    {
+        DurableQueue queue;
+        REQUIRE(queue.open(directory));
+        CHECK(drain(queue, "peer", 1) == std::vector<std::string>{"first"});
+        REQUIRE(queue.append("peer", "fourth", 0, true));
+    }
+    {
+        // The torn tail was wiped: the new record follows the last valid one, nothing else comes back.
+        DurableQueue queue;
+        REQUIRE(queue.open(directory));
+        CHECK(drain(queue, "peer") == std::vector<std::string>{"fourth"});
+    }
+}
+
+static void testTornPayloadEndsRecovery(Context &context)
+{
+    std::string directory = context.getTempDirectory();
+    REQUIRE(!directory.empty());
+
+    {
+        DurableQueue queue;
+        REQUIRE(queue.open(directory));
+        REQUIRE(queue.append("peer", "first", 0));
+        REQUIRE(queue.append("peer", "second", 0, true));
+    }
+
+    auto segments = listSegments(directory);
+    REQUIRE(segments.size() == 1);
+    // Half written payload of the last record:
+    REQUIRE(flipByte(segments[0], getRecordSize(5) + RECORD_HEADER_SIZE + 3));
+
+    DurableQueue queue;
+    REQUIRE(queue.open(directory));
+    CHECK(drain(queue, "peer") == std::vector<std::string>{"first"});
+}
+
+static void testInterruptedSegmentCreation(Context &context)
+{
+    std::string directory = context.getTempDirectory();
+    REQUIRE(!directory.empty());
+
+    {
+        DurableQueue queue;
+        REQUIRE(queue.open(directory));
+        REQUIRE(queue.append("peer", "first", 0, true));
+    }
+
+    auto segments = listSegments(directory);
+    REQUIRE(segments.size() == 1);
+
+    // Crash between the creation and the space reservation of the next segment (empty file):
+    unsigned long long id = 0;
+    std::string peerDirectory = segments[0].substr(0, segments[0].rfind('/'));
+    REQUIRE(sscanf(segments[0].c_str() + peerDirectory.size() + 1, "%16llx", &id) == 1);
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.seg", id + 1);
+    int fd = ::open((peerDirectory + name).c_str(), O_CREAT | O_WRONLY, 0600);
+    REQUIRE(fd != -1);
+    close(fd);
+
+    DurableQueue::Config config;
+    config.segmentSize = 4096;
+    {
+        DurableQueue queue(config);
+        REQUIRE(queue.open(directory));
+        // Fill the current segment, so the next append needs a new segment file:
+        for (int i = 0; i < 200; i++)
+            REQUIRE(queue.append("peer", std::string(64, 'x'), 0));
+        queue.commit();
+    }
+
+    // The empty file was removed and not reused:
+    struct stat st;
+    CHECK(stat((peerDirectory + name).c_str(), &st) != 0);
+
+    DurableQueue queue(config);
+    REQUIRE(queue.open(directory));
+    auto messages = drain(queue, "peer");
+    REQUIRE(messages.size() == 201);
+    CHECK(messages.front() == "first");
+}
+
+static void testExpiredMessagesAreDiscarded(Context &context)
+{
+    std::string directory = context.getTempDirectory();
+    REQUIRE(!directory.empty());
+
+    uint64_t now = getCurrentTimeMS();
+    DurableQueue queue;
+    REQUIRE(queue.open(directory));
+    REQUIRE(queue.append("peer", "expired", now - 1));
+    REQUIRE(queue.append("peer", "never", 0));
+    REQUIRE(queue.append("peer", "later", now + 60000));
+    REQUIRE(queue.append("peer", "expired too", now - 1000));
+
+    CHECK(drain(queue, "peer") == (std::vector<std::string>{"never", "later"}));
+    CHECK(!queue.hasPending("peer"));
+}
+
+static void testPeerSizeCap(Context &context)
+{
+    std::string directory = context.getTempDirectory();
+    REQUIRE(!directory.empty());
+
+    DurableQueue::Config config;
+    config.segmentSize = 4096;
+    config.maxBytesPerPeer = 8192;
+
+    DurableQueue queue(config);
+    REQUIRE(queue.open(directory));
+
+    std::string payload(100, 'x');
+    size_t accepted = 0;
+    while (accepted < 1000 && queue.append("peer", payload, 0))
+        accepted++;
+
+    // Two segments of 4096 bytes (128 bytes per record):
+    CHECK(accepted == 2 * (4096 / getRecordSize(payload.size())));
+    // Other peers have their own cap:
+    CHECK(queue.append("other", payload, 0));
+
+    // Consumed segments are released, so the peer accepts messages again:
+    CHECK(drain(queue, "peer").size() == accepted);
+    CHECK(queue.append("peer", payload, 0));
+}
+
+MANTIDS_TEST("durablequeue.reopen_keeps_order", testReopenKeepsOrder)
+MANTIDS_TEST("durablequeue.corrupted_record_ends_recovery", testCorruptedRecordEndsRecovery)
+MANTIDS_TEST("durablequeue.torn_payload_ends_recovery", testTornPayloadEndsRecovery)
+MANTIDS_TEST("durablequeue.interrupted_segment_creation", testInterruptedSegmentCreation)
+MANTIDS_TEST("durablequeue.expired_messages_are_discarded", testExpiredMessagesAreDiscarded)
+MANTIDS_TEST("durablequeue.peer_size_cap", testPeerSizeCap)
@@ -0,0 +1,164 @@
+#include "test.h"
+
+#include <Mantids30/Protocol_FastRPC3/fastrpc3.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Sockets;
+using namespace Mantids30::Network::Protocols::FastRPC;
+
+// A FastRPC3 connection handled in its own thread, the test acts as the remote peer:
+class PeerConnection
+{
+public:
+    PeerConnection(FastRPC3 &rpc, const std::string &connectionId)
+    {
+        auto pair = Socket_Stream::GetSocketPair();
+        local = pair.first;
+        remote = pair.second;
+        local->setConnectionName(connectionId);
+        thread = std::thread([this, &rpc]() { rpc.handleConnection(local, false); });
+
+        for (int i = 0; i < 500 && !rpc.doesConnectionExist(connectionId); i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ~PeerConnection()
+    {
+        remote->shutdownSocket();
+        if (thread.joinable())
+            thread.join();
+    }
+
+    // Read one execution request ('Q' frame) from the FastRPC3 side:
+    bool readRequest(uint64_t &requestId, uint8_t &flags, std::string &methodName, json &payload)
+    {
+        bool readOK;
+        if (remote->readU<uint8_t>(&readOK) != 'Q' || !readOK)
+            return false;
+        requestId = remote->readU<uint64_t>(&readOK);
+        if (!readOK)
+            return false;
+        flags = remote->readU<uint8_t>(&readOK);
+        if (!readOK)
+            return false;
+        methodName = remote->readStringEx<uint8_t>(&readOK);
+        if (!readOK)
+            return false;
+        std::string output = remote->readStringEx<uint32_t>(&readOK, 10 * 1024 * 1024);
+        if (!readOK)
+            return false;
+        return Mantids30::Helpers::JSONReader2().parse(output, payload);
+    }
+
+    std::shared_ptr<Socket_Stream> local, remote;
+    std::thread thread;
+};
+
+static void testConnectionIndex(Context &context)
+{
+    FastRPC3::ConnectionIndex index;
+    index.add("c1", "alice", "example.com", {"admin", "users"});
+    index.add("c2", "bob", "example.com", {"users"});
+    index.add("c3", "alice", "other.com", {"admin"});
+
+    CHECK(index.getByUser("alice", "example.com") == std::set<std::string>({"c1"}));
+    CHECK(index.getByDomain("example.com") == std::set<std::string>({"c1", "c2"}));
+    CHECK(index.getByRole("users", "example.com") == std::set<std::string>({"c1", "c2"}));
+    CHECK(index.getByRole("admin", "example.com") == std::set<std::string>({"c1"}));
+    CHECK(index.getByRole("admin", "other.com") == std::set<std::string>({"c3"}));
+    CHECK(index.getByUser("nobody", "example.com").empty());
+
+    // The NUL separator keeps the user and domain apart:
+    CHECK(index.getByUser(std::string("example.com") + '\0' + "alice", "").empty());
+
+    // A new login replaces the previous one:
+    index.add("c1", "carol", "example.com", {"users"});
+    CHECK(index.getByUser("alice", "example.com").empty());
+    CHECK(index.getByUser("carol", "example.com") == std::set<std::string>({"c1"}));
+    CHECK(index.getByRole("admin", "example.com").empty());
+
+    index.remove("c1");
+    index.remove("c1");
+    CHECK(index.getByDomain("example.com") == std::set<std::string>({"c2"}));
+    CHECK(index.getByRole("users", "example.com") == std::set<std::string>({"c2"}));
+}
+
+static void testPushDelivery(Context &context)
+{
+    FastRPC3 rpc(2, 2);
+    PeerConnection peer1(rpc, "peer1"), peer2(rpc, "peer2");
+    REQUIRE(rpc.doesConnectionExist("peer1") && rpc.doesConnectionExist("peer2"));
+
+    json payload;
+    payload["message"] = "hello";
+    CHECK(rpc.pushToAll("notify", payload) == 2);
+    CHECK(rpc.pushToConnections({"peer2", "missing"}, "second", payload) == 1);
+    // Not logged in:
+    CHECK(rpc.pushToUser("alice", "example.com", "notify", payload) == 0);
+    // Reserved methods:
+    CHECK(rpc.pushToAll("SESSION.LOGOUT", payload) == 0);
+
+    uint64_t requestId1, requestId2;
+    uint8_t flags;
+    std::string methodName;
+    json received;
+    REQUIRE(peer1.readRequest(requestId1, flags, methodName, received));
+    CHECK(methodName == "notify");
+    CHECK(flags & FastRPC3::EXEC_FLAG_PUSH);
+    CHECK(received["message"].asString() == "hello");
+
+    REQUIRE(peer2.readRequest(requestId2, flags, methodName, received));
+    CHECK(methodName == "notify");
+    CHECK(requestId1 == requestId2);
+    CHECK(requestId1 & 0x8000000000000000ULL);
+
+    // Queued pushes keep their order:
+    REQUIRE(peer2.readRequest(requestId2, flags, methodName, received));
+    CHECK(methodName == "second");
+    CHECK(requestId2 != requestId1);
+}
+
+static void testSlowPeerIsDropped(Context &context)
+{
+    FastRPC3 rpc(2, 2);
+    // A single writer, so a stalled peer would delay everybody else:
+    rpc.config.pushWriterThreads = 1;
+    rpc.config.pushWriteTimeoutInSeconds = 1;
+
+    PeerConnection slow(rpc, "slow"), fast(rpc, "fast");
+    REQUIRE(rpc.doesConnectionExist("slow") && rpc.doesConnectionExist("fast"));
+
+    // Far more than the socket buffers, and the slow peer never reads:
+    json payload;
+    payload["data"] = std::string(1024 * 1024, 'x');
+    for (int i = 0; i < 4; i++)
+        CHECK(rpc.pushToConnections({"slow"}, "bulk", payload));
+
+    auto start = std::chrono::steady_clock::now();
+    json small;
+    small["message"] = "hello";
+    CHECK(rpc.pushToConnections({"fast"}, "notify", small) == 1);
+
+    uint64_t requestId;
+    uint8_t flags;
+    std::string methodName;
+    json received;
+    REQUIRE(fast.readRequest(requestId, flags, methodName, received));
+    CHECK(methodName == "notify");
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    // Bounded by the push write timeout, not by the 40s connection write timeout:
+    CHECK(elapsed < 5000);
+
+    // The slow peer was disconnected:
+    for (int i = 0; i < 500 && rpc.doesConnectionExist("slow"); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(!rpc.doesConnectionExist("slow"));
+    CHECK(rpc.doesConnectionExist("fast"));
+}
+
+MANTIDS_TEST("fastrpc3push.connection_index", testConnectionIndex)
+MANTIDS_TEST("fastrpc3push.push_delivery", testPushDelivery)
+MANTIDS_TEST("fastrpc3push.slow_peer_is_dropped", testSlowPeerIsDropped)
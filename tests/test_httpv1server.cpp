@@ -0,0 +1,28 @@
+#include "test.h"
+
+#include <Mantids30/Protocol_HTTP/httpv1_server.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Memory::Containers;
+using namespace Mantids30::Network::Protocols::HTTP;
+
+static void testStaticContentCacheKey(Context &context)
+{
+    static const char content[] = "content";
+
+    auto element = std::make_shared<B_MEM>(content, sizeof(content) - 1);
+    std::string key = HTTPv1_Server::getStaticContentCacheKey("/index.html", element);
+    CHECK(HTTPv1_Server::getStaticContentCacheKey("/index.html", element) == key);
+    CHECK(HTTPv1_Server::getStaticContentCacheKey("/other.html", element) != key);
+
+    // Replaced elements (which may be allocated where the old ones were) never take the old variants:
+    for (int i = 0; i < 16; i++)
+    {
+        element = std::make_shared<B_MEM>(content, sizeof(content) - 1);
+        std::string newKey = HTTPv1_Server::getStaticContentCacheKey("/index.html", element);
+        CHECK(newKey != key);
+        key = newKey;
+    }
+}
+
+MANTIDS_TEST("httpv1server.static_content_cache_key", testStaticContentCacheKey)
@@ -0,0 +1,27 @@
+#include "test.h"
+
+#include <Mantids30/Scripts_JSONExprEval/jsoneval.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Scripts::Expressions;
+
+static void testInvalidRegexIsNotCompiled(Context &context)
+{
+    json values;
+    values["name"] = "admin";
+
+    // Constructor and compile() report the error instead of throwing:
+    JSONEval constructed("REGEX_MATCH($.name,\"adm(in\")");
+    CHECK(!constructed.isCompiled());
+
+    JSONEval expression;
+    CHECK(!expression.compile("IS_EQUAL($.name,\"admin\") && REGEX_MATCH($.name,\"[a-\")"));
+    CHECK(expression.getLastCompilerError() == "Invalid Regular Expression");
+    CHECK(!expression.evaluate(values));
+
+    JSONEval valid;
+    CHECK(valid.compile("IS_EQUAL($.name,\"admin\") && REGEX_MATCH($.name,\"^ad.*\")"));
+    CHECK(valid.evaluate(values));
+}
+
+MANTIDS_TEST("jsoneval.invalid_regex_is_not_compiled", testInvalidRegexIsNotCompiled)
@@ -0,0 +1,52 @@
+#include "test.h"
+
+#include <Mantids30/Memory/streamablestring.h>
+#include <Mantids30/Protocol_MIME/mime_sub_content.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Memory::Streams;
+using namespace Mantids30::Network::Protocols::MIME;
+
+// Part content parsed in a buffered mode (parse() instead of parseStream()):
+class BufferedContent : public MIME_Sub_Content
+{
+public:
+    BufferedContent() { setParseMode(SubParser::PARSE_MODE_CONNECTION_END); }
+};
+
+static std::string getContent(MIME_Sub_Content &content)
+{
+    StreamableString output;
+    content.getContentContainer()->streamTo(&output);
+    return output.getValue();
+}
+
+static void testBufferedParse(Context &context)
+{
+    BufferedContent content;
+    content.setBoundary("b0undary");
+
+    std::string data = "first line\r\n--b0und\r\nsecond line\r\n--b0undary";
+    REQUIRE(content.writeIntoParser(data.data(), data.size()) == data.size());
+    REQUIRE(content.writeIntoParser(nullptr, 0) == 0u);
+
+    CHECK(content.getParseStatus() == SubParser::PARSE_GOTO_NEXT_SUBPARSER);
+    CHECK(getContent(content) == "first line\r\n--b0und\r\nsecond line");
+}
+
+static void testBufferedParseWithoutBoundary(Context &context)
+{
+    BufferedContent content;
+    content.setBoundary("b0undary");
+
+    std::string data = "incomplete\r\n--b0und";
+    REQUIRE(content.writeIntoParser(data.data(), data.size()) == data.size());
+    REQUIRE(content.writeIntoParser(nullptr, 0) == 0u);
+
+    // The partial delimiter is held until more data comes:
+    CHECK(content.getParseStatus() == SubParser::PARSE_GET_MORE_DATA);
+    CHECK(getContent(content) == "incomplete");
+}
+
+MANTIDS_TEST("mimecontent.buffered_parse", testBufferedParse)
+MANTIDS_TEST("mimecontent.buffered_parse_without_boundary", testBufferedParseWithoutBoundary)
@@ -0,0 +1,172 @@
+#include "test.h"
+
+#include <Mantids30/Net_Interfaces/packetqueue.h>
+
+#include <string.h>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Interfaces;
+
+// A SOCK_SEQPACKET socketpair keeps the packet boundaries, like a TAP queue:
+struct PacketPair
+{
+    PacketPair() { ok = socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0; }
+    ~PacketPair()
+    {
+        if (ok)
+        {
+            close(fds[0]);
+            close(fds[1]);
+        }
+    }
+
+    int fds[2];
+    bool ok;
+};
+
+static void fillPacket(PacketBatch::Packet &packet, const size_t &i)
+{
+    packet.length = 60 + i * 37;
+    memset(packet.data, static_cast<int>('a' + i), packet.length);
+}
+
+static void testBatchRoundTrip(Context &context)
+{
+    PacketPair pair;
+    REQUIRE(pair.ok);
+
+    PacketQueue writer(pair.fds[0]), reader(pair.fds[1]);
+    PacketBatch out(16), in(32);
+
+    out.setSize(10);
+    for (size_t i = 0; i < out.size(); i++)
+        fillPacket(out[i], i);
+    REQUIRE(writer.writeBatch(out) == 10);
+
+    // Every queued packet comes in the same call:
+    REQUIRE(reader.readBatch(in, 1000) == 10);
+    REQUIRE(in.size() == 10);
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        CHECK(in[i].length == out[i].length);
+        CHECK(memcmp(in[i].data, out[i].data, out[i].length) == 0);
+    }
+
+    // Empty queue:
+    CHECK(reader.readBatch(in, 10) == 0);
+    CHECK(in.size() == 0);
+}
+
+static void testVnetHeaderRoundTrip(Context &context)
+{
+    PacketPair pair;
+    REQUIRE(pair.ok);
+
+    PacketQueue writer(pair.fds[0], false, true), reader(pair.fds[1], false, true);
+    CHECK(writer.hasVnetHeader() && reader.hasVnetHeader());
+
+    VNetHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.flags = VNetHeader::F_NEEDS_CSUM;
+    hdr.gsoType = VNetHeader::GSO_TCPV4;
+    hdr.hdrLen = 54;
+    hdr.gsoSize = 1448;
+    hdr.csumStart = 34;
+    hdr.csumOffset = 16;
+
+    std::string packet(3000, 'p');
+    REQUIRE(writer.writePacket(packet.data(), packet.size(), &hdr) == static_cast<ssize_t>(packet.size()));
+    REQUIRE(writer.writePacket("plain", 5) == 5);
+
+    PacketBatch in(4, 65550);
+    REQUIRE(reader.readBatch(in, 1000) == 2);
+    CHECK(in[0].length == packet.size());
+    CHECK(memcmp(in[0].data, packet.data(), packet.size()) == 0);
+    CHECK(in[0].vnetHeader.gsoType == VNetHeader::GSO_TCPV4 && in[0].vnetHeader.gsoSize == 1448);
+    CHECK(in[0].vnetHeader.csumStart == 34 && in[0].vnetHeader.csumOffset == 16);
+    // Written without offloads:
+    CHECK(in[1].length == 5 && in[1].vnetHeader.flags == 0 && in[1].vnetHeader.gsoType == VNetHeader::GSO_NONE);
+}
+
+static void testDescriptorFlagsAreKept(Context &context)
+{
+    PacketPair pair;
+    REQUIRE(pair.ok);
+
+    int flags = fcntl(pair.fds[1], F_GETFL, 0);
+    REQUIRE(flags >= 0 && !(flags & O_NONBLOCK));
+
+    {
+        PacketQueue reader(pair.fds[1]);
+        PacketBatch in(4);
+        CHECK(reader.readBatch(in, 10) == 0);
+    }
+
+    // Shared with the owner of the descriptor, so it's still in blocking mode:
+    CHECK(fcntl(pair.fds[1], F_GETFL, 0) == flags);
+}
+
+static void testBlockingDescriptor(Context &context)
+{
+    // A blocking descriptor that is not a socket (as the first queue of a TAP interface):
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    {
+        PacketQueue reader(fds[0]);
+        PacketBatch in(4);
+
+        CHECK(reader.readBatch(in, 10) == 0);
+        REQUIRE(write(fds[1], "packet", 6) == 6);
+        // Takes what is queued without blocking in the second read:
+        CHECK(reader.readBatch(in, 1000) == 1);
+        CHECK(in[0].length == 6 && memcmp(in[0].data, "packet", 6) == 0);
+        CHECK(reader.readBatch(in, 10) == 0);
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void testStopWakesUpReaders(Context &context)
+{
+    PacketPair pair;
+    REQUIRE(pair.ok);
+
+    PacketQueue reader(pair.fds[1]);
+    int batchResult = 0;
+    ssize_t packetResult = 0;
+
+    std::thread batchThread([&] {
+        PacketBatch in(4);
+        batchResult = reader.readBatch(in, -1);
+    });
+    std::thread packetThread([&] {
+        char packet[64];
+        packetResult = reader.readPacket(packet, sizeof(packet));
+    });
+
+    usleep(50000);
+    reader.stop();
+    batchThread.join();
+    packetThread.join();
+
+    CHECK(batchResult == -1);
+    CHECK(packetResult == -1);
+
+    // Next calls fail too:
+    PacketBatch in(4);
+    CHECK(reader.readBatch(in, 0) == -1);
+    CHECK(reader.writePacket("x", 1) == -1);
+}
+
+MANTIDS_TEST("packetqueue.batch_round_trip", testBatchRoundTrip)
+MANTIDS_TEST("packetqueue.vnet_header_round_trip", testVnetHeaderRoundTrip)
+MANTIDS_TEST("packetqueue.descriptor_flags_are_kept", testDescriptorFlagsAreKept)
+MANTIDS_TEST("packetqueue.blocking_descriptor", testBlockingDescriptor)
+MANTIDS_TEST("packetqueue.stop_wakes_up_readers", testStopWakesUpReaders)
@@ -0,0 +1,276 @@
+#include "test.h"
+
+#include <Mantids30/DB_PostgreSQL/pgsql_binarycodec.h>
+#include <Mantids30/Memory/a_allvars.h>
+
+#include <string.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Database;
+using namespace Mantids30::Memory;
+
+// Network-order builders for the binary payloads:
+static void be16(std::string &out, uint16_t value)
+{
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value & 0xFF);
+}
+
+static void be32(std::string &out, uint32_t value)
+{
+    be16(out, static_cast<uint16_t>(value >> 16));
+    be16(out, static_cast<uint16_t>(value & 0xFFFF));
+}
+
+static void be64(std::string &out, uint64_t value)
+{
+    be32(out, static_cast<uint32_t>(value >> 32));
+    be32(out, static_cast<uint32_t>(value & 0xFFFFFFFF));
+}
+
+// ndigits, weight, sign, dscale and the base-10000 digits:
+static std::string numeric(int16_t weight, uint16_t sign, int16_t dscale, const std::vector<int16_t> &digits)
+{
+    std::string out;
+    be16(out, static_cast<uint16_t>(digits.size()));
+    be16(out, static_cast<uint16_t>(weight));
+    be16(out, sign);
+    be16(out, static_cast<uint16_t>(dscale));
+    for (int16_t digit : digits)
+        be16(out, static_cast<uint16_t>(digit));
+    return out;
+}
+
+// One-dimensional array (NULL elements as nullptr):
+static std::string array1(Oid elementType, const std::vector<const std::string *> &elements)
+{
+    std::string out;
+    bool hasNull = false;
+    for (auto *element : elements)
+        hasNull |= (element == nullptr);
+    be32(out, 1);
+    be32(out, hasNull ? 1 : 0);
+    be32(out, elementType);
+    be32(out, static_cast<uint32_t>(elements.size()));
+    be32(out, 1);
+    for (auto *element : elements)
+    {
+        if (!element)
+        {
+            be32(out, 0xFFFFFFFF);
+            continue;
+        }
+        be32(out, static_cast<uint32_t>(element->size()));
+        out += *element;
+    }
+    return out;
+}
+
+static void testIntegers(Context &context)
+{
+    // Encoded parameters are decoded back to the same value:
+    std::string encoded;
+    Oid oid = 0;
+    REQUIRE(PostgreSQL_BinaryCodec::encodeParam(std::make_shared<Abstract::INT32>(-5), encoded, oid));
+    CHECK(oid == PostgreSQL_BinaryCodec::OID_INT4);
+    REQUIRE(encoded.size() == 4);
+    Abstract::INT32 i32;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&i32, oid, encoded.data(), encoded.size()));
+    CHECK(i32.getValue() == -5);
+
+    encoded.clear();
+    REQUIRE(PostgreSQL_BinaryCodec::encodeParam(std::make_shared<Abstract::INT64>(-1234567890123LL), encoded, oid));
+    CHECK(oid == PostgreSQL_BinaryCodec::OID_INT8);
+    Abstract::INT64 i64;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&i64, oid, encoded.data(), encoded.size()));
+    CHECK(i64.getValue() == -1234567890123LL);
+    CHECK(PostgreSQL_BinaryCodec::toText(oid, encoded.data(), encoded.size()) == "-1234567890123");
+
+    // Widened into a larger variable:
+    std::string int2;
+    be16(int2, static_cast<uint16_t>(-300));
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&i64, PostgreSQL_BinaryCodec::OID_INT2, int2.data(), int2.size()));
+    CHECK(i64.getValue() == -300);
+
+    // The payload size has to match the type:
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_INT4, int2.data(), int2.size()).empty());
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_INT2, int2.data(), int2.size()) == "-300");
+
+    // Bool:
+    Abstract::BOOL b;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&b, PostgreSQL_BinaryCodec::OID_BOOL, "\x01", 1));
+    CHECK(b.getValue());
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_BOOL, "\x00", 1) == "f");
+}
+
+static void testFloatingPoint(Context &context)
+{
+    std::string encoded;
+    Oid oid = 0;
+    REQUIRE(PostgreSQL_BinaryCodec::encodeParam(std::make_shared<Abstract::DOUBLE>(3.25), encoded, oid));
+    CHECK(oid == PostgreSQL_BinaryCodec::OID_FLOAT8);
+    Abstract::DOUBLE d;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&d, oid, encoded.data(), encoded.size()));
+    CHECK(d.getValue() == 3.25);
+
+    float f = 1.5f;
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    std::string float4;
+    be32(float4, bits);
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&d, PostgreSQL_BinaryCodec::OID_FLOAT4, float4.data(), float4.size()));
+    CHECK(d.getValue() == 1.5);
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_FLOAT4, float4.data(), float4.size()) == "1.5");
+}
+
+static void testTimestamps(Context &context)
+{
+    Abstract::DATETIME dt;
+
+    // Microseconds since 2000-01-01 00:00:00 UTC:
+    std::string ts;
+    be64(ts, 1000000);
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&dt, PostgreSQL_BinaryCodec::OID_TIMESTAMPTZ, ts.data(), ts.size()));
+    CHECK(dt.getValue() == 946684801);
+
+    // Rounded down before the epoch:
+    ts.clear();
+    be64(ts, static_cast<uint64_t>(-1));
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&dt, PostgreSQL_BinaryCodec::OID_TIMESTAMP, ts.data(), ts.size()));
+    CHECK(dt.getValue() == 946684799);
+
+    // Days since 2000-01-01:
+    std::string date;
+    be32(date, 1);
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&dt, PostgreSQL_BinaryCodec::OID_DATE, date.data(), date.size()));
+    CHECK(dt.getValue() == 946771200);
+}
+
+static void testNumeric(Context &context)
+{
+    std::string value = numeric(1, 0, 2, {1, 2345, 6700});
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_NUMERIC, value.data(), value.size()) == "12345.67");
+
+    value = numeric(-1, 0x4000, 1, {5000});
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_NUMERIC, value.data(), value.size()) == "-0.5");
+
+    value = numeric(0, 0xC000, 0, {});
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_NUMERIC, value.data(), value.size()) == "NaN");
+
+    // Integer variables go through the text representation:
+    value = numeric(0, 0, 0, {42});
+    Abstract::UINT64 u64;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&u64, PostgreSQL_BinaryCodec::OID_NUMERIC, value.data(), value.size()));
+    CHECK(u64.getValue() == 42);
+
+    // Truncated digits:
+    value = numeric(1, 0, 0, {1, 2});
+    value.resize(value.size() - 1);
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_NUMERIC, value.data(), value.size()).empty());
+}
+
+static void testArrays(Context &context)
+{
+    std::string one, three;
+    be32(one, 1);
+    be32(three, 3);
+    std::string ints = array1(PostgreSQL_BinaryCodec::OID_INT4, {&one, nullptr, &three});
+    CHECK(PostgreSQL_BinaryCodec::isArrayOID(1007));
+    CHECK(PostgreSQL_BinaryCodec::toText(1007, ints.data(), ints.size()) == "{1,NULL,3}");
+
+    std::list<std::string> values;
+    CHECK(PostgreSQL_BinaryCodec::decodeArray(ints.data(), ints.size(), values));
+    CHECK(values == std::list<std::string>({"1", "", "3"}));
+
+    // Quoted as array_out does:
+    std::string spaced = "a b", quoted = "x\"y", null = "null";
+    std::string texts = array1(PostgreSQL_BinaryCodec::OID_TEXT, {&spaced, &quoted, &null});
+    CHECK(PostgreSQL_BinaryCodec::toText(1009, texts.data(), texts.size()) == "{\"a b\",\"x\\\"y\",\"null\"}");
+
+    Abstract::STRINGLIST list;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&list, 1009, texts.data(), texts.size()));
+    CHECK(list.getValue() == std::list<std::string>({"a b", "x\"y", "null"}));
+
+    // Malformed (truncated element):
+    values.clear();
+    CHECK(!PostgreSQL_BinaryCodec::decodeArray(ints.data(), ints.size() - 2, values));
+    CHECK(PostgreSQL_BinaryCodec::toText(1007, ints.data(), ints.size() - 2).empty());
+}
+
+static void testAddressesAndBytes(Context &context)
+{
+    const char inet4[] = {2, 32, 0, 4, (char) 192, (char) 168, 1, 1};
+    Abstract::IPV4 ipv4;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&ipv4, PostgreSQL_BinaryCodec::OID_INET, inet4, sizeof(inet4)));
+    CHECK(ipv4.toString() == "192.168.1.1");
+
+    // Wrong address family for the variable:
+    Abstract::IPV6 ipv6;
+    CHECK(!PostgreSQL_BinaryCodec::decodeInto(&ipv6, PostgreSQL_BinaryCodec::OID_INET, inet4, sizeof(inet4)));
+
+    const char mac[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55};
+    Abstract::MACADDR macaddr;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&macaddr, PostgreSQL_BinaryCodec::OID_MACADDR, mac, sizeof(mac)));
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_MACADDR, mac, sizeof(mac)) == macaddr.toString());
+
+    // bytea keeps the raw bytes, and its text is the hex format:
+    const char bytes[] = {0x00, (char) 0xFF, 0x10};
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_BYTEA, bytes, sizeof(bytes)) == "\\x00ff10");
+    Abstract::BINARY binary;
+    CHECK(PostgreSQL_BinaryCodec::decodeInto(&binary, PostgreSQL_BinaryCodec::OID_BYTEA, bytes, sizeof(bytes)));
+    CHECK(binary.toString() == std::string(bytes, sizeof(bytes)));
+
+    // jsonb = version byte + text:
+    CHECK(PostgreSQL_BinaryCodec::toText(PostgreSQL_BinaryCodec::OID_JSONB, "\x01{}", 3) == "{}");
+}
+
+static void testRowBuffer(Context &context)
+{
+    Abstract::RowBuffer buffer({Abstract::Var::TYPE_INT32, Abstract::Var::TYPE_STRING, Abstract::Var::TYPE_INT64, Abstract::Var::TYPE_DOUBLE});
+
+    std::string int4, numeric42 = numeric(0, 0, 0, {42}), float8;
+    be32(int4, static_cast<uint32_t>(-9));
+    double d = 0.25;
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    be64(float8, bits);
+
+    CHECK(PostgreSQL_BinaryCodec::appendTo(buffer.getColumn(0), PostgreSQL_BinaryCodec::OID_INT4, int4.data(), int4.size()));
+    CHECK(PostgreSQL_BinaryCodec::appendTo(buffer.getColumn(1), PostgreSQL_BinaryCodec::OID_VARCHAR, "hello", 5));
+    // Mismatched types go through the text representation:
+    CHECK(PostgreSQL_BinaryCodec::appendTo(buffer.getColumn(2), PostgreSQL_BinaryCodec::OID_NUMERIC, numeric42.data(), numeric42.size()));
+    CHECK(PostgreSQL_BinaryCodec::appendTo(buffer.getColumn(3), PostgreSQL_BinaryCodec::OID_FLOAT8, float8.data(), float8.size()));
+    buffer.commitRow();
+
+    REQUIRE(buffer.getRowCount() == 1);
+    CHECK(buffer.getColumn(0).get<int32_t>(0) == -9);
+    CHECK(buffer.getColumn(1).getString(0) == "hello");
+    CHECK(buffer.getColumn(2).get<int64_t>(0) == 42);
+    CHECK(buffer.getColumn(3).get<double>(0) == 0.25);
+}
+
+static void testCanDecode(Context &context)
+{
+    CHECK(PostgreSQL_BinaryCodec::canDecode(PostgreSQL_BinaryCodec::OID_INT4));
+    CHECK(PostgreSQL_BinaryCodec::canDecode(PostgreSQL_BinaryCodec::OID_NUMERIC));
+    CHECK(PostgreSQL_BinaryCodec::canDecode(1007));
+    // interval, money (their binary format is not their text):
+    CHECK(!PostgreSQL_BinaryCodec::canDecode(1186));
+    CHECK(!PostgreSQL_BinaryCodec::canDecode(790));
+
+    // Types without a binary encoder are sent as text:
+    std::string encoded;
+    Oid oid = 0;
+    CHECK(!PostgreSQL_BinaryCodec::encodeParam(std::make_shared<Abstract::STRING>("x"), encoded, oid));
+    CHECK(!PostgreSQL_BinaryCodec::encodeParam(std::make_shared<Abstract::UINT64>(1), encoded, oid));
+    CHECK(encoded.empty() && oid == 0);
+}
+
+MANTIDS_TEST("pgsqlbinarycodec.integers", testIntegers)
+MANTIDS_TEST("pgsqlbinarycodec.floating_point", testFloatingPoint)
+MANTIDS_TEST("pgsqlbinarycodec.timestamps", testTimestamps)
+MANTIDS_TEST("pgsqlbinarycodec.numeric", testNumeric)
+MANTIDS_TEST("pgsqlbinarycodec.arrays", testArrays)
+MANTIDS_TEST("pgsqlbinarycodec.addresses_and_bytes", testAddressesAndBytes)
+MANTIDS_TEST("pgsqlbinarycodec.row_buffer", testRowBuffer)
+MANTIDS_TEST("pgsqlbinarycodec.can_decode", testCanDecode)
@@ -0,0 +1,32 @@
+#include "test.h"
+
+#include <Mantids30/Server_WebCore/prometheusmetrics.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Servers::Web;
+using namespace Mantids30::Network::Protocols;
+
+static HTTP::Status::Codes requestMetrics(std::shared_ptr<PrometheusMetricsParameters> parameters, const std::string &authorization, const std::string &method = "GET")
+{
+    HTTP::HTTPv1_Base::Request request;
+    HTTP::HTTPv1_Base::Response response;
+    request.requestLine.setRequestMethod(method);
+    if (!authorization.empty())
+        request.headers.add("Authorization", authorization);
+    return PrometheusMetrics("/", &request, &response, parameters);
+}
+
+static void testBearerTokenRequired(Context &context)
+{
+    // The token check itself is covered in test_bearertoken.cpp:
+    CHECK(requestMetrics(nullptr, "") == HTTP::Status::S_403_FORBIDDEN);
+
+    auto parameters = std::make_shared<PrometheusMetricsParameters>();
+    parameters->bearerToken = "secret";
+    CHECK(requestMetrics(parameters, "Bearer other") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(requestMetrics(parameters, "Bearer secret") == HTTP::Status::S_200_OK);
+
+    CHECK(requestMetrics(parameters, "Bearer secret", "POST") == HTTP::Status::S_405_METHOD_NOT_ALLOWED);
+}
+
+MANTIDS_TEST("prometheusmetrics.bearer_token_required", testBearerTokenRequired)
@@ -0,0 +1,98 @@
+#include "test.h"
+
+#include <Mantids30/Sessions/sessionstore_journal.h>
+
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Sessions;
+
+static StoredSession createStoredSession(const std::string &sessionID)
+{
+    StoredSession session;
+    session.sessionID = sessionID;
+    session.tokenPayload = "{\"sub\":\"user_" + sessionID + "\"}";
+    session.firstActivity = session.lastActivity = time(nullptr);
+    return session;
+}
+
+static off_t getFileSize(const std::string &fileName)
+{
+    struct stat st;
+    return stat(fileName.c_str(), &st) == 0 ? st.st_size : -1;
+}
+
+// Files bigger than the limit can't be written (EFBIG instead of SIGXFSZ) while it exists:
+class FileSizeLimit
+{
+public:
+    FileSizeLimit(rlim_t limit)
+    {
+        m_previousHandler = signal(SIGXFSZ, SIG_IGN);
+        getrlimit(RLIMIT_FSIZE, &m_previousLimit);
+        struct rlimit newLimit = m_previousLimit;
+        newLimit.rlim_cur = limit;
+        setrlimit(RLIMIT_FSIZE, &newLimit);
+    }
+    ~FileSizeLimit()
+    {
+        setrlimit(RLIMIT_FSIZE, &m_previousLimit);
+        signal(SIGXFSZ, m_previousHandler);
+    }
+
+private:
+    struct rlimit m_previousLimit;
+    sighandler_t m_previousHandler;
+};
+
+static void testFailedWritesAreKept(Context &context)
+{
+    std::string directory = context.getTempDirectory();
+    REQUIRE(!directory.empty());
+    std::string prefix = directory + "/sessions";
+
+    {
+        SessionStore_Journal store;
+        store.setFlushInterval(600000);
+        store.setCompactionThreshold(4);
+        REQUIRE(store.open(prefix));
+
+        std::string journal = prefix + ".journal.1";
+        REQUIRE(store.put(createStoredSession("first")));
+        REQUIRE(store.flush());
+        off_t journalSize = getFileSize(journal);
+        REQUIRE(journalSize > 0);
+
+        REQUIRE(store.put(createStoredSession("second")));
+        REQUIRE(store.touch("first", time(nullptr) + 10));
+        {
+            // Only a piece of the batch fits:
+            FileSizeLimit limit(static_cast<rlim_t>(journalSize) + 10);
+            CHECK(!store.flush());
+            CHECK(!store.flush());
+        }
+        // The torn piece was dropped:
+        CHECK(getFileSize(journal) == journalSize);
+
+        // Written now (the failed attempts were not counted, so there is no compaction yet):
+        CHECK(store.flush());
+        CHECK(getFileSize(journal) > journalSize);
+        CHECK(getFileSize(prefix + ".journal.2") == -1);
+        store.close();
+    }
+
+    // Everything is replayed:
+    SessionStore_Journal reloaded;
+    reloaded.setFlushInterval(600000);
+    REQUIRE(reloaded.open(prefix));
+    StoredSession session;
+    CHECK(reloaded.get("first", session));
+    CHECK(session.lastActivity > session.firstActivity);
+    CHECK(reloaded.get("second", session));
+    reloaded.close();
+}
+
+MANTIDS_TEST("sessionstorejournal.failed_writes_are_kept", testFailedWritesAreKept)
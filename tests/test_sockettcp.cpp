@@ -0,0 +1,52 @@
+#include "test.h"
+
+#include <Mantids30/Net_Sockets/socket_tcp.h>
+
+#include <thread>
+
+#include <fcntl.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Sockets;
+
+static bool isNonBlocking(Socket_TCP &socket)
+{
+    return (fcntl(socket.getSocketFD(), F_GETFL, 0) & O_NONBLOCK) != 0;
+}
+
+static void testBlockingAcceptByDefault(Context &context)
+{
+    Socket_TCP listener;
+    REQUIRE(listener.listenOn(0, "127.0.0.1") && listener.getPort());
+    CHECK(!isNonBlocking(listener));
+
+    // Interrupted by shutting down the socket:
+    std::shared_ptr<Socket_Stream> accepted;
+    std::thread acceptor([&]() { accepted = listener.acceptConnection(); });
+    usleep(50000);
+    listener.stopAccepting();
+    acceptor.join();
+    CHECK(accepted == nullptr);
+}
+
+static void testInterruptibleAccept(Context &context)
+{
+    Socket_TCP listener;
+    REQUIRE(listener.listenOn(0, "127.0.0.1") && listener.getPort());
+    REQUIRE(listener.enableInterruptibleAccept());
+    CHECK(isNonBlocking(listener));
+
+    std::shared_ptr<Socket_Stream> accepted;
+    std::thread acceptor([&]() { accepted = listener.acceptConnection(); });
+    usleep(50000);
+    listener.stopAccepting();
+    acceptor.join();
+    CHECK(accepted == nullptr);
+
+    // Not shut down (still listening for the processes sharing it):
+    Socket_TCP client;
+    CHECK(client.connectFrom(nullptr, "127.0.0.1", listener.getPort()));
+}
+
+MANTIDS_TEST("sockettcp.blocking_accept_by_default", testBlockingAcceptByDefault)
+MANTIDS_TEST("sockettcp.interruptible_accept", testInterruptibleAccept)
@@ -0,0 +1,33 @@
+#include "test.h"
+
+#include <Mantids30/Net_Sockets/socket_udp.h>
+
+#include <string.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Sockets;
+
+static void testReadBatchFlagsTruncated(Context &context)
+{
+    Socket_UDP receiver, sender;
+    REQUIRE(receiver.listenOn(0, "127.0.0.1") && receiver.getPort());
+    receiver.setReadTimeout(1);
+    REQUIRE(sender.connectFrom(nullptr, "127.0.0.1", receiver.getPort()));
+
+    std::string shortDatagram(100, 's'), longDatagram(3000, 'l');
+    REQUIRE(sender.writeBlock(shortDatagram.data(), shortDatagram.size()));
+    REQUIRE(sender.writeBlock(longDatagram.data(), longDatagram.size()));
+    REQUIRE(sender.writeBlock(shortDatagram.data(), shortDatagram.size()));
+
+    DatagramBatch batch(8, 1024);
+    REQUIRE(receiver.readBatch(batch) == 3);
+
+    CHECK(batch[0].length == shortDatagram.size() && !batch[0].truncated);
+    // Cut to the buffer size:
+    CHECK(batch[1].truncated);
+    CHECK(batch[1].length == batch.getBufferSize());
+    CHECK(memcmp(batch[1].data, longDatagram.data(), batch.getBufferSize()) == 0);
+    CHECK(batch[2].length == shortDatagram.size() && !batch[2].truncated);
+}
+
+MANTIDS_TEST("socketudp.read_batch_flags_truncated", testReadBatchFlagsTruncated)
@@ -0,0 +1,35 @@
+#include "test.h"
+
+#include <Mantids30/Server_WebCore/tracedump.h>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Network::Servers::Web;
+using namespace Mantids30::Network::Protocols;
+
+static HTTP::Status::Codes requestDump(std::shared_ptr<TraceDumpParameters> parameters, const std::string &authorization, const std::string &path = "/",
+                                       const std::string &method = "GET")
+{
+    HTTP::HTTPv1_Base::Request request;
+    HTTP::HTTPv1_Base::Response response;
+    request.requestLine.setRequestMethod(method);
+    if (!authorization.empty())
+        request.headers.add("Authorization", authorization);
+    return TraceDump(path, &request, &response, parameters);
+}
+
+static void testBearerTokenRequired(Context &context)
+{
+    // The token check itself is covered in test_bearertoken.cpp:
+    CHECK(requestDump(nullptr, "") == HTTP::Status::S_403_FORBIDDEN);
+
+    auto parameters = std::make_shared<TraceDumpParameters>();
+    parameters->bearerToken = "secret";
+    CHECK(requestDump(parameters, "Bearer other") == HTTP::Status::S_401_UNAUTHORIZED);
+    CHECK(requestDump(parameters, "Bearer secret") == HTTP::Status::S_200_OK);
+
+    CHECK(requestDump(parameters, "Bearer secret", "/", "POST") == HTTP::Status::S_405_METHOD_NOT_ALLOWED);
+    // Not a trace id:
+    CHECK(requestDump(parameters, "Bearer secret", "/not-a-trace-id") == HTTP::Status::S_404_NOT_FOUND);
+}
+
+MANTIDS_TEST("tracedump.bearer_token_required", testBearerTokenRequired)
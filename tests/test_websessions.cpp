@@ -0,0 +1,97 @@
+#include "test.h"
+
+#include <Mantids30/Server_MonolithWebAPI/sessionsmanager.h>
+#include <Mantids30/Sessions/sessionstore_journal.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Mantids30::Tests;
+using namespace Mantids30::Sessions;
+using namespace Mantids30::Network::Servers::WebMonolith;
+
+// Sessions created by another process, kept in the store:
+static std::shared_ptr<SessionStore_Journal> createStore(Context &context, const std::vector<std::string> &sessionIDs)
+{
+    std::string directory = context.getTempDirectory();
+    if (directory.empty())
+        return nullptr;
+    auto store = std::make_shared<SessionStore_Journal>();
+    if (!store->open(directory + "/sessions"))
+        return nullptr;
+    for (const auto &sessionID : sessionIDs)
+    {
+        StoredSession session;
+        session.sessionID = sessionID;
+        session.tokenPayload = "{\"sub\":\"alice\"}";
+        session.firstActivity = session.lastActivity = time(nullptr);
+        store->put(session);
+    }
+    return store;
+}
+
+static void testRestoreRespectsMaxSessionsPerUser(Context &context)
+{
+    auto store = createStore(context, {"session00001:aaaaaaaaaaaa", "session00002:aaaaaaaaaaaa", "session00003:aaaaaaaaaaaa"});
+    REQUIRE(store);
+
+    WebSessionsManager manager;
+    manager.startGarbageCollector(WebSessionsManager::threadGC, &manager, "GC:WebSessions");
+    manager.setSessionStore(store);
+    manager.setMaxSessionsPerUser(2);
+
+    uint64_t maxAge;
+    CHECK(manager.openSession("session00001:aaaaaaaaaaaa", &maxAge) != nullptr);
+    CHECK(manager.openSession("session00002:aaaaaaaaaaaa", &maxAge) != nullptr);
+    CHECK(manager.openSession("session00003:aaaaaaaaaaaa", &maxAge) == nullptr);
+    CHECK(manager.getUserSessionsCount("alice") == 2);
+
+    // Already restored ones are still available:
+    CHECK(manager.openSession("session00001:aaaaaaaaaaaa", &maxAge) != nullptr);
+    manager.releaseSession("session00001:aaaaaaaaaaaa");
+    manager.releaseSession("session00001:aaaaaaaaaaaa");
+    manager.releaseSession("session00002:aaaaaaaaaaaa");
+    store->close();
+}
+
+static void testConcurrentRestore(Context &context)
+{
+    const std::string sessionID = "session00001:aaaaaaaaaaaa";
+    auto store = createStore(context, {sessionID});
+    REQUIRE(store);
+
+    for (int round = 0; round < 20; round++)
+    {
+        WebSessionsManager manager;
+        manager.startGarbageCollector(WebSessionsManager::threadGC, &manager, "GC:WebSessions");
+        manager.setSessionStore(store);
+
+        // Every request restoring the same session at once gets it:
+        std::atomic<int> ready{0}, opened{0};
+        std::vector<std::thread> requests;
+        for (int i = 0; i < 8; i++)
+        {
+            requests.emplace_back([&]() {
+                ready++;
+                while (ready < 8)
+                    std::this_thread::yield();
+                uint64_t maxAge;
+                if (manager.openSession(sessionID, &maxAge))
+                {
+                    opened++;
+                    manager.releaseSession(sessionID);
+                }
+            });
+        }
+        for (auto &request : requests)
+            request.join();
+
+        CHECK(opened == 8);
+        CHECK(manager.getUserSessionsCount("alice") == 1);
+    }
+    store->close();
+}
+
+MANTIDS_TEST("websessions.restore_respects_max_sessions_per_user", testRestoreRespectsMaxSessionsPerUser)
+MANTIDS_TEST("websessions.concurrent_restore", testConcurrentRestore)